@@ -12,6 +12,7 @@
 #include <cstring>
 #include <cassert>
 #include <new>
+#include <vector>
 
 
 #ifndef ELOG
@@ -35,315 +36,265 @@ void SafeDeleteArray( T*& ptr )
 }
 
 //-----------------------------------------------------------------------------
-//! @brief      8Bitインデックスカラー形式を解析します.
-//!
-//! @param[in]      pColorMap       カラーマップです.
+//! @brief      ファイルの現在位置から終端までを一括で読み込みします.
 //-----------------------------------------------------------------------------
-void Parse8Bits( FILE* pFile, uint32_t size, uint8_t* pColorMap, uint8_t* pPixels )
+bool ReadToEnd( FILE* pFile, std::vector<uint8_t>& buffer )
 {
-    uint8_t color = 0;
-    for( uint32_t i=0; i<size; ++i )
-    {
-        color = (uint8_t)fgetc( pFile );
-        pPixels[ i * 3 + 2 ] = pColorMap[ color * 3 + 0 ];
-        pPixels[ i * 3 + 1 ] = pColorMap[ color * 3 + 1 ];
-        pPixels[ i * 3 + 0 ] = pColorMap[ color * 3 + 2 ];
-    }
-}
+    auto curr = ftell( pFile );
+    if ( curr < 0 )
+    { return false; }
 
-//-----------------------------------------------------------------------------
-//! @brief      16Bitフルカラー形式を解析します.
-//-----------------------------------------------------------------------------
-void Parse16Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    for( uint32_t i=0; i<size; ++i )
-    {
-        uint16_t color = fgetc( pFile ) + ( fgetc( pFile ) << 8 );
-        pPixels[ i * 3 + 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-        pPixels[ i * 3 + 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-        pPixels[ i * 3 + 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-    }
+    fseek( pFile, 0, SEEK_END );
+    auto end = ftell( pFile );
+    fseek( pFile, curr, SEEK_SET );
+
+    if ( end < curr )
+    { return false; }
+
+    buffer.resize( size_t( end - curr ) );
+    if ( buffer.empty() )
+    { return true; }
+
+    return fread( buffer.data(), sizeof(uint8_t), buffer.size(), pFile ) == buffer.size();
 }
 
 //-----------------------------------------------------------------------------
-//! @brief      24Bitフルカラー形式を解析します.
+//! @brief      インデックスカラーをRGBに変換します.
 //-----------------------------------------------------------------------------
-void Parse24Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
+void ConvertIndexToRGB( const uint8_t* pSrc, uint32_t count, const uint8_t* pColorMap, uint8_t* pDst )
 {
-    for( uint32_t i=0; i<size; ++i )
+    for( uint32_t i=0; i<count; ++i )
     {
-        pPixels[ i * 4 + 2 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 1 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 3 ] = 255;
+        auto color = pSrc[ i ] * 3;
+        pDst[ i * 3 + 0 ] = pColorMap[ color + 2 ];
+        pDst[ i * 3 + 1 ] = pColorMap[ color + 1 ];
+        pDst[ i * 3 + 2 ] = pColorMap[ color + 0 ];
     }
 }
 
 //-----------------------------------------------------------------------------
-//! @brief      32Bitフルカラー形式を解析します.
+//! @brief      X1R5G5B5をRGBに変換します.
 //-----------------------------------------------------------------------------
-void Parse32Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
+void ConvertX1R5G5B5ToRGB( const uint8_t* pSrc, uint32_t count, uint8_t* pDst )
 {
-    for( uint32_t i=0; i<size; ++i )
+    for( uint32_t i=0; i<count; ++i )
     {
-        pPixels[ i * 4 + 2 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 1 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 3 ] = (uint8_t)fgetc( pFile );
+        uint16_t color = uint16_t( pSrc[ i * 2 + 0 ] | ( pSrc[ i * 2 + 1 ] << 8 ) );
+        pDst[ i * 3 + 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
+        pDst[ i * 3 + 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
+        pDst[ i * 3 + 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
     }
 }
 
 //-----------------------------------------------------------------------------
-//! @brief     8Bitグレースケール形式を解析します.
+//! @brief      BGRをRGBに変換します.
 //-----------------------------------------------------------------------------
-void Parse8BitsGrayScale( FILE* pFile, uint32_t size, uint8_t* pPixels )
+void ConvertBGRToRGB( const uint8_t* pSrc, uint32_t count, uint8_t* pDst )
 {
-    for( uint32_t i=0; i<size; ++i )
+    for( uint32_t i=0; i<count; ++i )
     {
-        pPixels[ i ] = (uint8_t)fgetc( pFile );
+        pDst[ i * 3 + 0 ] = pSrc[ i * 3 + 2 ];
+        pDst[ i * 3 + 1 ] = pSrc[ i * 3 + 1 ];
+        pDst[ i * 3 + 2 ] = pSrc[ i * 3 + 0 ];
     }
 }
 
 //-----------------------------------------------------------------------------
-//! @brief      16Bitグレースケール形式を解析します.
+//! @brief      BGRAをRGBAに変換します.
+//!
+//! @note       ループ内を32bit演算のみにしてコンパイラのSIMD化を効かせます.
 //-----------------------------------------------------------------------------
-void Parse16BitsGrayScale( FILE* pFile, uint32_t size, uint8_t* pPixels )
+void ConvertBGRAToRGBA( const uint8_t* pSrc, uint32_t count, uint8_t* pDst )
 {
-    for( uint32_t i=0; i<size; ++i )
+    for( uint32_t i=0; i<count; ++i )
     {
-        pPixels[ i * 2 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 2 + 1 ] = (uint8_t)fgetc( pFile );
+        uint32_t color;
+        memcpy( &color, pSrc + i * 4, sizeof(color) );
+        color = ( color & 0xFF00FF00 ) | ( ( color >> 16 ) & 0xFF ) | ( ( color & 0xFF ) << 16 );
+        memcpy( pDst + i * 4, &color, sizeof(color) );
     }
 }
 
 //-----------------------------------------------------------------------------
-//! @brief      8BitRLE圧縮インデックスカラー形式を解析します.
+//! @brief      RLE圧縮データを展開します.
 //!
-//! @param[in]  pColorMap       カラーマップです.
-//-----------------------------------------------------------------------------
-void Parse8BitsRLE( FILE* pFile, uint8_t* pColorMap, uint32_t size, uint8_t* pPixels )
+//! @param[in]      pSrc        圧縮データです.
+//! @param[in]      srcSize     圧縮データのサイズです.
+//! @param[in]      pixelCount  展開するピクセル数です.
+//! @param[out]     pDst        展開先です.
+//! @param[in]      convert     連続するピクセルを変換する関数です.
+//! @retval true    展開に成功.
+//! @retval false   データが不足しています.
+//-----------------------------------------------------------------------------
+template<uint32_t SrcStride, uint32_t DstStride, typename Converter>
+bool DecodeRLE( const uint8_t* pSrc, size_t srcSize, uint32_t pixelCount, uint8_t* pDst, Converter convert )
 {
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixels;
+    auto pEnd = pSrc + srcSize;
+    uint32_t  idx  = 0;
 
-    while( ptr < pPixels + size )   // size = width * height * 3.
+    while( idx < pixelCount )
     {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+        if ( pSrc >= pEnd )
+        { return false; }
+
+        auto header = *pSrc++;
+        auto count  = 1u + ( header & 0x7F );
+        if ( count > pixelCount - idx )
+        { count = pixelCount - idx; }
+
+        auto ptr = pDst + idx * DstStride;
 
         if ( header & 0x80 )
         {
-            color = (uint8_t)fgetc( pFile );
+            if ( size_t( pEnd - pSrc ) < SrcStride )
+            { return false; }
 
-            for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            {
-                ptr[ 0 ] = pColorMap[ color * 3 + 2 ];
-                ptr[ 1 ] = pColorMap[ color * 3 + 1 ];
-                ptr[ 2 ] = pColorMap[ color * 3 + 0 ];
-            }
+            // 1ピクセル分だけ変換して複製する.
+            convert( pSrc, 1, ptr );
+            for( uint32_t i=1; i<count; ++i )
+            { memcpy( ptr + i * DstStride, ptr, DstStride ); }
+
+            pSrc += SrcStride;
         }
         else
         {
-            for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            {
-                color = (uint8_t)fgetc( pFile );
+            if ( size_t( pEnd - pSrc ) < size_t( count ) * SrcStride )
+            { return false; }
 
-                ptr[ 0 ] = pColorMap[ color * 3 + 2 ];
-                ptr[ 1 ] = pColorMap[ color * 3 + 1 ];
-                ptr[ 2 ] = pColorMap[ color * 3 + 0 ];
-            }
+            // 非圧縮パケットはまとめて変換する.
+            convert( pSrc, count, ptr );
+
+            pSrc += count * SrcStride;
         }
+
+        idx += count;
     }
+
+    return true;
 }
 
 //-----------------------------------------------------------------------------
-//! @brief      16BitRLE圧縮フルカラー形式を解析します.
+//! @brief      無変換でコピーします.
 //-----------------------------------------------------------------------------
-void Parse16BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    uint32_t count  = 0;
-    uint16_t color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 3.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            color = fgetc( pFile ) + ( fgetc( pFile ) << 8 ); 
+template<uint32_t Stride>
+void CopyPixels( const uint8_t* pSrc, uint32_t count, uint8_t* pDst )
+{ memcpy( pDst, pSrc, count * Stride ); }
 
-            for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            {
-                ptr[ 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-                ptr[ 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-                ptr[ 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-            }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            {
-                color = fgetc( pFile ) + ( fgetc( pFile ) << 8 );
+//-----------------------------------------------------------------------------
+//! @brief      8Bitインデックスカラー形式を解析します.
+//!
+//! @param[in]      pColorMap       カラーマップです.
+//-----------------------------------------------------------------------------
+bool Parse8Bits( const uint8_t* pSrc, size_t srcSize, uint32_t size, const uint8_t* pColorMap, uint8_t* pPixels )
+{
+    if ( srcSize < size )
+    { return false; }
 
-                ptr[ 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-                ptr[ 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-                ptr[ 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-            }
-        }
-    }
+    ConvertIndexToRGB( pSrc, size, pColorMap, pPixels );
+    return true;
 }
 
 //-----------------------------------------------------------------------------
-//! @brief      24BitRLE圧縮フルカラー形式を解析します.
+//! @brief      16Bitフルカラー形式を解析します.
 //-----------------------------------------------------------------------------
-void Parse24BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
+bool Parse16Bits( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
 {
-    uint32_t count    = 0;
-    uint8_t  color[3] = { 0, 0, 0 };
-    uint8_t  header   = 0;
-    uint8_t* ptr      = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 3.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+    if ( srcSize < size_t( size ) * 2 )
+    { return false; }
 
-        if ( header & 0x80 )
-        {
-            fread( color, sizeof(uint8_t), 3, pFile );
-
-            for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            {
-                ptr[ 0 ] = color[ 2 ];
-                ptr[ 1 ] = color[ 1 ];
-                ptr[ 2 ] = color[ 0 ];
-            }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            {
-                ptr[ 2 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-            }
-        }
-    }
+    ConvertX1R5G5B5ToRGB( pSrc, size, pPixels );
+    return true;
 }
 
 //-----------------------------------------------------------------------------
-//! @brief      32BitRLE圧縮フルカラー形式を解析します.
+//! @brief      24Bitフルカラー形式を解析します.
 //-----------------------------------------------------------------------------
-void Parse32BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
+bool Parse24Bits( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
 {
-    uint32_t count    = 0;
-    uint8_t  color[4] = { 0, 0, 0, 0 };
-    uint8_t  header   = 0;
-    uint8_t* ptr      = pPixels;
+    if ( srcSize < size_t( size ) * 3 )
+    { return false; }
 
-    while( ptr < pPixels + size )   // size = width * height * 4.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+    ConvertBGRToRGB( pSrc, size, pPixels );
+    return true;
+}
 
-        if ( header & 0x80 )
-        {
-            fread( color, sizeof(uint8_t), 4, pFile );
+//-----------------------------------------------------------------------------
+//! @brief      32Bitフルカラー形式を解析します.
+//-----------------------------------------------------------------------------
+bool Parse32Bits( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{
+    if ( srcSize < size_t( size ) * 4 )
+    { return false; }
 
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = color[ 2 ];
-                ptr[ 1 ] = color[ 1 ];
-                ptr[ 2 ] = color[ 0 ];
-                ptr[ 3 ] = color[ 3 ];
-            }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 2 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 3 ] = (uint8_t)fgetc( pFile );
-            }
-        }
-    }
+    ConvertBGRAToRGBA( pSrc, size, pPixels );
+    return true;
 }
 
 //-----------------------------------------------------------------------------
-//! @brief      8BitRLE圧縮グレースケール形式を解析します.
+//! @brief     8Bitグレースケール形式を解析します.
 //-----------------------------------------------------------------------------
-void Parse8BitsGrayScaleRLE( FILE* pFile, uint32_t size, uint8_t* pPixles )
+bool Parse8BitsGrayScale( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
 {
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixles;
+    if ( srcSize < size )
+    { return false; }
 
-    while( ptr < pPixles + size ) // size = width * height
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+    CopyPixels<1>( pSrc, size, pPixels );
+    return true;
+}
 
-        if ( header & 0x80 )
-        {
-            color = (uint8_t)fgetc( pFile );
+//-----------------------------------------------------------------------------
+//! @brief      16Bitグレースケール形式を解析します.
+//-----------------------------------------------------------------------------
+bool Parse16BitsGrayScale( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{
+    if ( srcSize < size_t( size ) * 2 )
+    { return false; }
 
-            for( uint32_t i=0; i<count; ++i, ptr++ )
-            { (*ptr) = color; }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr++ )
-            { (*ptr) = (uint8_t)fgetc( pFile ); }
-        }
-    }
+    CopyPixels<2>( pSrc, size, pPixels );
+    return true;
 }
 
 //-----------------------------------------------------------------------------
-//! @brief      16BitRLE圧縮グレースケール形式を解析します.
+//! @brief      8BitRLE圧縮インデックスカラー形式を解析します.
+//!
+//! @param[in]  pColorMap       カラーマップです.
 //-----------------------------------------------------------------------------
-void Parse16BitsGrayScaleRLE( FILE* pFile, uint32_t size, uint8_t* pPixles )
+bool Parse8BitsRLE( const uint8_t* pSrc, size_t srcSize, const uint8_t* pColorMap, uint32_t size, uint8_t* pPixels )
 {
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  alpha  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixles;
+    return DecodeRLE<1, 3>( pSrc, srcSize, size, pPixels,
+        [pColorMap]( const uint8_t* pIn, uint32_t count, uint8_t* pOut )
+        { ConvertIndexToRGB( pIn, count, pColorMap, pOut ); } );
+}
 
-    while( ptr < pPixles + size ) // size = width * height * 2
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+//-----------------------------------------------------------------------------
+//! @brief      16BitRLE圧縮フルカラー形式を解析します.
+//-----------------------------------------------------------------------------
+bool Parse16BitsRLE( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{ return DecodeRLE<2, 3>( pSrc, srcSize, size, pPixels, ConvertX1R5G5B5ToRGB ); }
 
-        if ( header & 0x80 )
-        {
-            color = (uint8_t)fgetc( pFile );
-            alpha = (uint8_t)fgetc( pFile );
+//-----------------------------------------------------------------------------
+//! @brief      24BitRLE圧縮フルカラー形式を解析します.
+//-----------------------------------------------------------------------------
+bool Parse24BitsRLE( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{ return DecodeRLE<3, 3>( pSrc, srcSize, size, pPixels, ConvertBGRToRGB ); }
 
-            for( uint32_t i=0; i<count; ++i, ptr+=2 )
-            {
-                ptr[ 0 ] = color;
-                ptr[ 1 ] = alpha;
-            }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr+=2 )
-            {
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-            }
-        }
-    }
-}
+//-----------------------------------------------------------------------------
+//! @brief      32BitRLE圧縮フルカラー形式を解析します.
+//-----------------------------------------------------------------------------
+bool Parse32BitsRLE( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{ return DecodeRLE<4, 4>( pSrc, srcSize, size, pPixels, ConvertBGRAToRGBA ); }
+
+//-----------------------------------------------------------------------------
+//! @brief      8BitRLE圧縮グレースケール形式を解析します.
+//-----------------------------------------------------------------------------
+bool Parse8BitsGrayScaleRLE( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{ return DecodeRLE<1, 1>( pSrc, srcSize, size, pPixels, CopyPixels<1> ); }
 
+//-----------------------------------------------------------------------------
+//! @brief      16BitRLE圧縮グレースケール形式を解析します.
+//-----------------------------------------------------------------------------
+bool Parse16BitsGrayScaleRLE( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{ return DecodeRLE<2, 2>( pSrc, srcSize, size, pPixels, CopyPixels<2> ); }
 
 } // namespace /* anonymous */
 
@@ -516,12 +467,31 @@ bool ResTGA::Load( const wchar_t* filename )
     m_BitPerPixel = bytePerPixel * 8;
     m_Format      = static_cast<TGA_FORMAT_TYPE>( header.Format );
 
+    // ピクセルデータをがばっと読み込む.
+    std::vector<uint8_t> buffer;
+    if ( !ReadToEnd( pFile, buffer ) )
+    {
+        ELOG( "Error : File Read Failed." );
+        SafeDeleteArray( pColorMap );
+        SafeDeleteArray( m_pPixels );
+        fclose( pFile );
+        return false;
+    }
+
+    // ファイルを閉じる.
+    fclose( pFile );
+
+    auto pSrc    = buffer.data();
+    auto srcSize = buffer.size();
+    auto count   = m_Width * m_Height;
+    auto ret     = false;
+
     // フォーマットに合わせてピクセルデータを解析する.
     switch( header.Format )
     {
     // パレット.
     case TGA_FORMAT_INDEXCOLOR:
-        { Parse8Bits( pFile, m_Width * m_Height, pColorMap, m_pPixels ); }
+        { ret = Parse8Bits( pSrc, srcSize, count, pColorMap, m_pPixels ); }
         break;
 
     // フルカラー.
@@ -530,15 +500,15 @@ bool ResTGA::Load( const wchar_t* filename )
             switch( header.BitPerPixel )
             {
             case 16:
-                { Parse16Bits( pFile, m_Width * m_Height, m_pPixels ); }
+                { ret = Parse16Bits( pSrc, srcSize, count, m_pPixels ); }
                 break;
 
             case 24:
-                { Parse24Bits( pFile, m_Width * m_Height, m_pPixels ); }
+                { ret = Parse24Bits( pSrc, srcSize, count, m_pPixels ); }
                 break;
 
             case 32:
-                { Parse32Bits( pFile, m_Width * m_Height, m_pPixels ); }
+                { ret = Parse32Bits( pSrc, srcSize, count, m_pPixels ); }
                 break;
             }
         }
@@ -548,15 +518,15 @@ bool ResTGA::Load( const wchar_t* filename )
     case TGA_FORMAT_GRAYSCALE:
         {
             if ( header.BitPerPixel == 8 )
-            { Parse8BitsGrayScale( pFile, m_Width * m_Height, m_pPixels ); }
+            { ret = Parse8BitsGrayScale( pSrc, srcSize, count, m_pPixels ); }
             else
-            { Parse16BitsGrayScale( pFile, m_Width * m_Height, m_pPixels ); }
+            { ret = Parse16BitsGrayScale( pSrc, srcSize, count, m_pPixels ); }
         }
         break;
 
     // パレットRLE圧縮.
     case TGA_FORMAT_RLE_INDEXCOLOR:
-        { Parse8BitsRLE( pFile, pColorMap, m_Width * m_Height * 3, m_pPixels ); }
+        { ret = Parse8BitsRLE( pSrc, srcSize, pColorMap, count, m_pPixels ); }
         break;
 
     // フルカラーRLE圧縮.
@@ -565,15 +535,15 @@ bool ResTGA::Load( const wchar_t* filename )
             switch( header.BitPerPixel )
             {
             case 16:
-                { Parse16BitsRLE( pFile, m_Width * m_Height * 3, m_pPixels ); }
+                { ret = Parse16BitsRLE( pSrc, srcSize, count, m_pPixels ); }
                 break;
 
             case 24:
-                { Parse24BitsRLE( pFile, m_Width * m_Height * 3, m_pPixels ); }
+                { ret = Parse24BitsRLE( pSrc, srcSize, count, m_pPixels ); }
                 break;
 
             case 32:
-                { Parse32BitsRLE( pFile, m_Width * m_Height * 4, m_pPixels ); }
+                { ret = Parse32BitsRLE( pSrc, srcSize, count, m_pPixels ); }
                 break;
             }
         }
@@ -583,9 +553,9 @@ bool ResTGA::Load( const wchar_t* filename )
     case TGA_FORMAT_RLE_GRAYSCALE:
         {
             if ( header.BitPerPixel == 8 )
-            { Parse8BitsGrayScaleRLE( pFile, m_Width * m_Height, m_pPixels ); }
+            { ret = Parse8BitsGrayScaleRLE( pSrc, srcSize, count, m_pPixels ); }
             else
-            { Parse16BitsGrayScaleRLE( pFile, m_Width * m_Height * 2, m_pPixels ); }
+            { ret = Parse16BitsGrayScaleRLE( pSrc, srcSize, count, m_pPixels ); }
         }
         break;
     }
@@ -593,8 +563,13 @@ bool ResTGA::Load( const wchar_t* filename )
     // 不要なメモリを解放.
     SafeDeleteArray( pColorMap );
 
-    // ファイルを閉じる.
-    fclose( pFile );
+    // ピクセルデータが不足している場合.
+    if ( !ret )
+    {
+        ELOG( "Error : Invalid Pixel Data." );
+        Release();
+        return false;
+    }
 
     // 正常終了.
     return true;
@@ -0,0 +1,36 @@
+﻿//-----------------------------------------------------------------------------
+// File : Compat.h
+// Desc : Compatibility Helpers For Non-Windows Build.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cerrno>
+
+
+#ifndef _WIN32
+
+//-----------------------------------------------------------------------------
+//! @brief      ファイルを開きます.
+//!
+//! @note       MSVC の fopen_s() 相当です.
+//-----------------------------------------------------------------------------
+inline int fopen_s(FILE** ppFile, const char* path, const char* mode)
+{
+    if (ppFile == nullptr)
+    { return EINVAL; }
+
+    *ppFile = fopen(path, mode);
+    return (*ppFile != nullptr) ? 0 : errno;
+}
+
+// 数値の書式だけで使うので, バッファサイズの引数は不要.
+#ifndef sscanf_s
+#define sscanf_s    sscanf
+#endif//sscanf_s
+
+#endif//_WIN32
@@ -0,0 +1,152 @@
+﻿//-----------------------------------------------------------------------------
+// File : CubeMapUtil.h
+// Desc : Cube Map Utility.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <FloatImage.h>
+#include <SimdVec4.h>
+
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr uint32_t CUBE_VIEW_MAX_MIP_LEVELS = 16;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// CubeView structure
+///////////////////////////////////////////////////////////////////////////////
+struct CubeView
+{
+    const float*    pPixels[6][CUBE_VIEW_MAX_MIP_LEVELS];  //!< 面・ミップ毎の先頭ポインタ.
+    uint32_t        Size[CUBE_VIEW_MAX_MIP_LEVELS];        //!< ミップ毎のサイズ.
+    uint32_t        MipLevels;                  //!< ミップレベル数.
+};
+
+//-----------------------------------------------------------------------------
+//      サブリソースの先頭ポインタを1度だけ求めておきます.
+//-----------------------------------------------------------------------------
+inline void MakeCubeView(const FloatImage& cubeMap, CubeView& view)
+{
+    view.MipLevels = std::min(cubeMap.MipLevels, CUBE_VIEW_MAX_MIP_LEVELS);
+    for(auto m=0u; m<view.MipLevels; ++m)
+    {
+        view.Size[m] = cubeMap.GetMipWidth(m);
+        for(auto f=0u; f<6; ++f)
+        { view.pPixels[f][m] = cubeMap.GetPixels(f, m); }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップのテクスチャ座標からフェッチ方向を求めます.
+//-----------------------------------------------------------------------------
+inline void CalcCubeDirection(float u, float v, uint32_t face, float dir[3])
+{
+    auto x = u * 2.0f - 1.0f;
+    auto y = v * 2.0f - 1.0f;
+
+    switch(face)
+    {
+    case 0 : { dir[0] =  1.0f; dir[1] =     y; dir[2] =    -x; } break;
+    case 1 : { dir[0] = -1.0f; dir[1] =     y; dir[2] =     x; } break;
+    case 2 : { dir[0] =     x; dir[1] =  1.0f; dir[2] =    -y; } break;
+    case 3 : { dir[0] =     x; dir[1] = -1.0f; dir[2] =     y; } break;
+    case 4 : { dir[0] =     x; dir[1] =     y; dir[2] =  1.0f; } break;
+    default: { dir[0] =    -x; dir[1] =     y; dir[2] = -1.0f; } break;
+    }
+
+    auto invLen = 1.0f / sqrtf(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+    dir[0] *= invLen;
+    dir[1] *= invLen;
+    dir[2] *= invLen;
+}
+
+//-----------------------------------------------------------------------------
+//      方向ベクトルから面番号とテクスチャ座標を求めます.
+//-----------------------------------------------------------------------------
+inline uint32_t CalcCubeCoord(const float dir[3], float& u, float& v)
+{
+    auto ax = fabsf(dir[0]);
+    auto ay = fabsf(dir[1]);
+    auto az = fabsf(dir[2]);
+
+    uint32_t face;
+    float sc, tc, ma;
+    if (ax >= ay && ax >= az)
+    {
+        face = (dir[0] >= 0.0f) ? 0 : 1;
+        sc   = (dir[0] >= 0.0f) ? -dir[2] : dir[2];
+        tc   = -dir[1];
+        ma   = ax;
+    }
+    else if (ay >= az)
+    {
+        face = (dir[1] >= 0.0f) ? 2 : 3;
+        sc   = dir[0];
+        tc   = (dir[1] >= 0.0f) ? dir[2] : -dir[2];
+        ma   = ay;
+    }
+    else
+    {
+        face = (dir[2] >= 0.0f) ? 4 : 5;
+        sc   = (dir[2] >= 0.0f) ? dir[0] : -dir[0];
+        tc   = -dir[1];
+        ma   = az;
+    }
+
+    auto invMa = 0.5f / std::max(ma, 1e-20f);
+    u = sc * invMa + 0.5f;
+    v = tc * invMa + 0.5f;
+    return face;
+}
+
+//-----------------------------------------------------------------------------
+//      面内でバイリニア補間します.
+//-----------------------------------------------------------------------------
+inline Vec4 SampleBilinear(const float* pPixels, uint32_t size, float u, float v)
+{
+    auto maxCoord = float(size - 1);
+    auto fx = std::min(std::max(u * float(size) - 0.5f, 0.0f), maxCoord);
+    auto fy = std::min(std::max(v * float(size) - 0.5f, 0.0f), maxCoord);
+
+    auto x0 = uint32_t(fx);
+    auto y0 = uint32_t(fy);
+    auto x1 = std::min(x0 + 1, size - 1);
+    auto y1 = std::min(y0 + 1, size - 1);
+    auto tx = fx - float(x0);
+    auto ty = fy - float(y0);
+
+    auto row0 = pPixels + size_t(y0) * size * 4;
+    auto row1 = pPixels + size_t(y1) * size * 4;
+
+    auto c0 = VecLerp(VecLoad(row0 + x0 * 4), VecLoad(row0 + x1 * 4), tx);
+    auto c1 = VecLerp(VecLoad(row1 + x0 * 4), VecLoad(row1 + x1 * 4), tx);
+    return VecLerp(c0, c1, ty);
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップを三線形補間サンプリングします.
+//-----------------------------------------------------------------------------
+inline Vec4 SampleCube(const CubeView& view, const float dir[3], float mipLevel)
+{
+    float u, v;
+    auto face = CalcCubeCoord(dir, u, v);
+
+    auto level = std::min(std::max(mipLevel, 0.0f), float(view.MipLevels - 1));
+    auto m0 = uint32_t(level);
+    auto m1 = std::min(m0 + 1, view.MipLevels - 1);
+    auto t  = level - float(m0);
+
+    auto c0 = SampleBilinear(view.pPixels[face][m0], view.Size[m0], u, v);
+    if (t <= 0.0f || m0 == m1)
+    { return c0; }
+
+    auto c1 = SampleBilinear(view.pPixels[face][m1], view.Size[m1], u, v);
+    return VecLerp(c0, c1, t);
+}
@@ -0,0 +1,69 @@
+﻿//-----------------------------------------------------------------------------
+// File : EnvMapConverter.h
+// Desc : Environment Map Layout Converter on CPU.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <FloatImage.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ENVMAP_LAYOUT enum
+///////////////////////////////////////////////////////////////////////////////
+enum ENVMAP_LAYOUT : uint32_t
+{
+    ENVMAP_LAYOUT_EQUIRECT = 0,     //!< 正距円筒図法(SphereMapConverter の入力と同じ).
+    ENVMAP_LAYOUT_SPHERE,           //!< スフィアマップ(ミラーボール, +Z方向から見た像).
+    ENVMAP_LAYOUT_CUBE,             //!< キューブマップ.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ENVMAP_FILTER enum
+///////////////////////////////////////////////////////////////////////////////
+enum ENVMAP_FILTER : uint32_t
+{
+    ENVMAP_FILTER_BILINEAR = 0,     //!< バイリニア補間.
+    ENVMAP_FILTER_BICUBIC,          //!< Catmull-Rom による双三次補間.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// EnvMapConvertDesc structure
+///////////////////////////////////////////////////////////////////////////////
+struct EnvMapConvertDesc
+{
+    ENVMAP_LAYOUT   SrcLayout   = ENVMAP_LAYOUT_EQUIRECT;   //!< 入力のレイアウト.
+    ENVMAP_LAYOUT   DstLayout   = ENVMAP_LAYOUT_CUBE;       //!< 出力のレイアウト.
+    uint32_t        Width       = 0;                        //!< 出力の横幅(0の場合は入力から決定).
+    uint32_t        Height      = 0;                        //!< 出力の縦幅(0の場合は入力から決定).
+    ENVMAP_FILTER   Filter      = ENVMAP_FILTER_BILINEAR;   //!< 入力のサンプリングフィルタ.
+    uint32_t        SuperSample = 0;                        //!< 1軸当たりのスーパーサンプル数(0の場合はテクセル密度比から決定).
+    MIPMAP_FILTER   MipFilter   = MIPMAP_FILTER_BOX;        //!< ミップマップ生成フィルタ.
+    uint32_t        MipLevels   = 1;                        //!< 出力のミップレベル数(0の場合はフルミップチェイン).
+    uint32_t        ThreadCount = 0;                        //!< ワーカースレッド数(0の場合はハードウェアスレッド数).
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      入力の横幅からキューブマップのサイズを求めます.
+//!
+//! @param[in]      srcWidth    正距円筒図法の画像の横幅です.
+//! @return     SphereMapConverter と同じく, 横幅の 1/4 以上となる最小の2のべき乗を返却します.
+//-----------------------------------------------------------------------------
+uint32_t CalcCubeMapSize(uint32_t srcWidth);
+
+//-----------------------------------------------------------------------------
+//! @brief      環境マップのレイアウトを変換します.
+//!
+//! @param[in]      src         入力画像です. ミップレベル0のみを参照します.
+//! @param[in]      desc        変換設定です.
+//! @param[out]     dst         出力画像の格納先です.
+//! @retval true    変換に成功.
+//! @retval false   変換に失敗.
+//! @note       出力を 32x32 テクセルのタイルに分割して並列処理します.
+//!             スフィアマップの円の外側は0で埋めます.
+//-----------------------------------------------------------------------------
+bool ConvertEnvMap(const FloatImage& src, const EnvMapConvertDesc& desc, FloatImage& dst);
@@ -0,0 +1,145 @@
+﻿//-----------------------------------------------------------------------------
+// File : FloatImage.h
+// Desc : Floating Point Image.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FLOAT_IMAGE_FORMAT enum
+///////////////////////////////////////////////////////////////////////////////
+enum FLOAT_IMAGE_FORMAT : uint32_t
+{
+    FLOAT_IMAGE_FORMAT_RGBA32 = 0,  //!< DXGI_FORMAT_R32G32B32A32_FLOAT
+    FLOAT_IMAGE_FORMAT_RGBA16,      //!< DXGI_FORMAT_R16G16B16A16_FLOAT
+    FLOAT_IMAGE_FORMAT_RG32,        //!< DXGI_FORMAT_R32G32_FLOAT (BA成分は破棄).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// MIPMAP_FILTER enum
+///////////////////////////////////////////////////////////////////////////////
+enum MIPMAP_FILTER : uint32_t
+{
+    MIPMAP_FILTER_BOX = 0,          //!< 2x2 ボックスフィルタ.
+    MIPMAP_FILTER_KAISER,           //!< カイザー窓付き sinc フィルタ(分離可能).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FloatImage structure
+///////////////////////////////////////////////////////////////////////////////
+struct FloatImage
+{
+    uint32_t            Width       = 0;        //!< 横幅.
+    uint32_t            Height      = 0;        //!< 縦幅.
+    uint32_t            ArraySize   = 0;        //!< 配列数(キューブマップの場合は6の倍数).
+    uint32_t            MipLevels   = 0;        //!< ミップレベル数.
+    bool                IsCube      = false;    //!< キューブマップかどうか?
+    std::vector<float>  Pixels;                 //!< RGBA32F. 配列 → ミップの順(DDSと同じ)に格納.
+
+    //-------------------------------------------------------------------------
+    //! @brief      メモリを確保します. 値は0で初期化されます.
+    //-------------------------------------------------------------------------
+    void Init(uint32_t width, uint32_t height, uint32_t arraySize, uint32_t mipLevels, bool isCube);
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定ミップレベルの横幅を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetMipWidth(uint32_t mip) const
+    { return (Width >> mip) > 0 ? (Width >> mip) : 1; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定ミップレベルの縦幅を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetMipHeight(uint32_t mip) const
+    { return (Height >> mip) > 0 ? (Height >> mip) : 1; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      サブリソースの先頭位置を取得します.
+    //!
+    //! @param[in]      index       配列番号(キューブマップの場合は面番号)です.
+    //! @param[in]      mip         ミップレベルです.
+    //! @return     Pixels 内の要素位置を返却します.
+    //-------------------------------------------------------------------------
+    size_t GetOffset(uint32_t index, uint32_t mip) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      サブリソースの先頭ポインタを取得します.
+    //-------------------------------------------------------------------------
+    float* GetPixels(uint32_t index, uint32_t mip)
+    { return Pixels.data() + GetOffset(index, mip); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      サブリソースの先頭ポインタを取得します.
+    //-------------------------------------------------------------------------
+    const float* GetPixels(uint32_t index, uint32_t mip) const
+    { return Pixels.data() + GetOffset(index, mip); }
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      フルミップチェインのレベル数を求めます.
+//-----------------------------------------------------------------------------
+uint32_t CalcMipLevels(uint32_t width, uint32_t height);
+
+//-----------------------------------------------------------------------------
+//! @brief      ミップマップを生成します.
+//!
+//! @param[in,out]  image           ミップレベル0を設定済みの画像です.
+//! @param[in]      mipLevels       生成するミップレベル数です. 0の場合はフルミップチェインを生成します.
+//! @param[in]      threadCount     ワーカースレッド数です. 0の場合はハードウェアスレッド数を使います.
+//! @param[in]      filter          ダウンサンプルフィルタです.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//! @note       配列要素(キューブマップの面)毎に独立して処理し, 端はクランプします.
+//!             カイザーフィルタのリンギングで生じた負の値は0にクランプします.
+//-----------------------------------------------------------------------------
+bool GenerateMipmaps
+(
+    FloatImage&     image,
+    uint32_t        mipLevels   = 0,
+    uint32_t        threadCount = 0,
+    MIPMAP_FILTER   filter      = MIPMAP_FILTER_BOX
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      DDSファイルを読み込みます.
+//!
+//! @param[in]      path        ファイルパスです.
+//! @param[out]     image       画像の格納先です.
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
+//! @note       RGBA32F, RGBA16F, RG32F の2Dテクスチャ(配列・キューブマップ含む)に対応します.
+//-----------------------------------------------------------------------------
+bool LoadDDS(const char* path, FloatImage& image);
+
+//-----------------------------------------------------------------------------
+//! @brief      Radiance HDR(.hdr)ファイルを読み込みます.
+//!
+//! @param[in]      path            ファイルパスです.
+//! @param[out]     image           画像の格納先です(ミップレベル1の2Dテクスチャ, A成分は1).
+//! @param[in]      threadCount     ワーカースレッド数です. 0の場合はハードウェアスレッド数を使います.
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
+//! @note       32-bit_rle_rgbe の新旧両方のランレングス形式と, "-Y h +X w", "+Y h +X w" のスキャンラインに対応します.
+//!             1行目が画像の上端になるように格納します. EXPOSURE, GAMMA は適用しません.
+//-----------------------------------------------------------------------------
+bool LoadHDR(const char* path, FloatImage& image, uint32_t threadCount = 0);
+
+//-----------------------------------------------------------------------------
+//! @brief      DDSファイルに保存します.
+//!
+//! @param[in]      path        ファイルパスです.
+//! @param[in]      image       保存する画像です.
+//! @param[in]      format      出力フォーマットです.
+//! @retval true    保存に成功.
+//! @retval false   保存に失敗.
+//! @note       DX10 拡張ヘッダ付きで出力します.
+//-----------------------------------------------------------------------------
+bool SaveDDS(const char* path, const FloatImage& image, FLOAT_IMAGE_FORMAT format);
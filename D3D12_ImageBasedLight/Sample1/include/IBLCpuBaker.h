@@ -0,0 +1,111 @@
+﻿//-----------------------------------------------------------------------------
+// File : IBLCpuBaker.h
+// Desc : Bake IBL on CPU.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <FloatImage.h>
+
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr uint32_t IBL_DFG_TEXTURE_SIZE     = 512;      // IBLBaker::DFGTextureSize と同じ.
+constexpr uint32_t IBL_LD_TEXTURE_SIZE      = 256;      // IBLBaker::LDTextureSize と同じ.
+constexpr uint32_t IBL_LD_MIP_COUNT         = 8;        // IBLBaker::MipCount と同じ.
+constexpr uint32_t IBL_DFG_SAMPLE_COUNT     = 1024;     // IntegrateDFG_PS.hlsl のサンプル数.
+constexpr uint32_t IBL_LD_SAMPLE_COUNT      = 128;      // BakeUtil.hlsli の SampleCount.
+
+
+///////////////////////////////////////////////////////////////////////////////
+// IBLDiffuseSH structure
+///////////////////////////////////////////////////////////////////////////////
+struct IBLDiffuseSH
+{
+    float   Coeffs[9][3];   //!< 放射輝度を射影した2次までの球面調和関数係数(RGB).
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      DFG項を積分します.
+//!
+//! @param[in]      size            テクスチャサイズです.
+//! @param[out]     result          結果の格納先です(RG成分に格納).
+//! @param[in]      threadCount     ワーカースレッド数です. 0の場合はハードウェアスレッド数を使います.
+//! @retval true    積分に成功.
+//! @retval false   積分に失敗.
+//! @note       IntegrateDFG_PS.hlsl と同じ式で, 横方向が NdotV, 縦方向が上から 1 → 0 の線形ラフネスです.
+//-----------------------------------------------------------------------------
+bool IntegrateDFG_CPU(uint32_t size, FloatImage& result, uint32_t threadCount = 0);
+
+//-----------------------------------------------------------------------------
+//! @brief      キューブマップを球面調和関数に射影します.
+//!
+//! @param[in]      cubeMap         入力キューブマップです.
+//! @param[out]     sh              射影結果の格納先です.
+//! @param[in]      threadCount     ワーカースレッド数です. 0の場合はハードウェアスレッド数を使います.
+//! @retval true    射影に成功.
+//! @retval false   射影に失敗.
+//! @note       低周波成分しか残らないので, 128x128 以下のミップレベルがあればそれを使います.
+//-----------------------------------------------------------------------------
+bool ProjectDiffuseSH(const FloatImage& cubeMap, IBLDiffuseSH& sh, uint32_t threadCount = 0);
+
+//-----------------------------------------------------------------------------
+//! @brief      球面調和関数から Diffuse LD 項を求めます.
+//!
+//! @param[in]      sh          ProjectDiffuseSH() の結果です.
+//! @param[in]      dir         正規化済みの方向ベクトルです.
+//! @param[out]     result      結果(RGB)の格納先です.
+//! @note       放射照度を π で割った値(= IntegrateDiffuseLD_PS.hlsl の出力)を返却します.
+//-----------------------------------------------------------------------------
+void EvaluateDiffuseSH(const IBLDiffuseSH& sh, const float dir[3], float result[3]);
+
+//-----------------------------------------------------------------------------
+//! @brief      球面調和関数から Diffuse LD 項のキューブマップを生成します.
+//!
+//! @param[in]      sh              ProjectDiffuseSH() の結果です.
+//! @param[in]      size            キューブマップのサイズです.
+//! @param[out]     result          結果の格納先です.
+//! @param[in]      threadCount     ワーカースレッド数です. 0の場合はハードウェアスレッド数を使います.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//-----------------------------------------------------------------------------
+bool IntegrateDiffuseLD_CPU(const IBLDiffuseSH& sh, uint32_t size, FloatImage& result, uint32_t threadCount = 0);
+
+//-----------------------------------------------------------------------------
+//! @brief      Specular LD 項を積分します.
+//!
+//! @param[in]      cubeMap         入力キューブマップです. ミップマップが無い場合は内部で生成します.
+//! @param[in]      size            出力キューブマップのサイズです.
+//! @param[in]      mipCount        出力キューブマップのミップレベル数です.
+//! @param[out]     result          結果の格納先です.
+//! @param[in]      threadCount     ワーカースレッド数です. 0の場合はハードウェアスレッド数を使います.
+//! @retval true    積分に成功.
+//! @retval false   積分に失敗.
+//! @note       IntegrateSpecularLD_PS.hlsl と同じく, ミップレベル m のラフネスを (m / (mipCount - 1))^2 とし,
+//!             GGX 重点サンプリングとミップマップフィルタ重点サンプリングで積分します.
+//!             サンプル方向は法線空間で1度だけ求めておき, テクセル毎には回転と三線形補間のみを行います.
+//-----------------------------------------------------------------------------
+bool IntegrateSpecularLD_CPU
+(
+    const FloatImage&   cubeMap,
+    uint32_t            size,
+    uint32_t            mipCount,
+    FloatImage&         result,
+    uint32_t            threadCount = 0
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      キューブマップを方向ベクトルで三線形補間サンプリングします.
+//!
+//! @param[in]      cubeMap     入力キューブマップです.
+//! @param[in]      dir         方向ベクトルです(正規化不要).
+//! @param[in]      mipLevel    ミップレベルです.
+//! @param[out]     result      結果(RGBA)の格納先です.
+//! @note       面の境界はクランプします(面をまたいだフィルタリングは行いません).
+//-----------------------------------------------------------------------------
+void SampleCubeLevel(const FloatImage& cubeMap, const float dir[3], float mipLevel, float result[4]);
@@ -0,0 +1,63 @@
+﻿//-----------------------------------------------------------------------------
+// File : ParallelFor.h
+// Desc : Simple Parallel Loop.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+//! @brief      [0, count) の範囲を複数スレッドで処理します.
+//!
+//! @param[in]      count           処理数です.
+//! @param[in]      threadCount     ワーカースレッド数です. 0の場合はハードウェアスレッド数を使います.
+//! @param[in]      func            void(uint32_t index) 形式の処理です.
+//! @note       インデックスは1つずつ取り出すので，処理時間にばらつきがあっても偏りません.
+//!             呼び出し元スレッドもワーカーとして動作します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+inline void ParallelFor(uint32_t count, uint32_t threadCount, Func func)
+{
+    if (threadCount == 0)
+    { threadCount = std::max(std::thread::hardware_concurrency(), 1u); }
+    threadCount = std::min(threadCount, count);
+
+    if (threadCount <= 1)
+    {
+        for(auto i=0u; i<count; ++i)
+        { func(i); }
+        return;
+    }
+
+    std::atomic<uint32_t> next(0);
+    auto worker = [&]()
+    {
+        for(;;)
+        {
+            auto i = next.fetch_add(1);
+            if (i >= count)
+                break;
+
+            func(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for(auto i=1u; i<threadCount; ++i)
+    { threads.emplace_back(worker); }
+
+    worker();
+
+    for(auto& thread : threads)
+    { thread.join(); }
+}
@@ -0,0 +1,85 @@
+﻿//-----------------------------------------------------------------------------
+// File : SimdVec4.h
+// Desc : 4 Component SIMD Vector.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define SIMD_VEC4_USE_SSE2    (1)
+#include <emmintrin.h>
+#else
+#define SIMD_VEC4_USE_SSE2    (0)
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Vec4 structure
+///////////////////////////////////////////////////////////////////////////////
+struct Vec4
+{
+#if SIMD_VEC4_USE_SSE2
+    __m128  V;
+#else
+    float   V[4];
+#endif
+};
+
+#if SIMD_VEC4_USE_SSE2
+inline Vec4 VecZero()                               { return { _mm_setzero_ps() }; }
+inline Vec4 VecSplat(float s)                       { return { _mm_set1_ps(s) }; }
+inline Vec4 VecLoad(const float* p)                 { return { _mm_loadu_ps(p) }; }
+inline void VecStore(float* p, Vec4 a)              { _mm_storeu_ps(p, a.V); }
+inline Vec4 VecAdd(Vec4 a, Vec4 b)                  { return { _mm_add_ps(a.V, b.V) }; }
+inline Vec4 VecSub(Vec4 a, Vec4 b)                  { return { _mm_sub_ps(a.V, b.V) }; }
+inline Vec4 VecMul(Vec4 a, Vec4 b)                  { return { _mm_mul_ps(a.V, b.V) }; }
+inline Vec4 VecDiv(Vec4 a, Vec4 b)                  { return { _mm_div_ps(a.V, b.V) }; }
+inline Vec4 VecMax(Vec4 a, Vec4 b)                  { return { _mm_max_ps(a.V, b.V) }; }
+inline Vec4 VecMin(Vec4 a, Vec4 b)                  { return { _mm_min_ps(a.V, b.V) }; }
+inline Vec4 VecSqrt(Vec4 a)                         { return { _mm_sqrt_ps(a.V) }; }
+inline Vec4 VecMaskGreater(Vec4 a, Vec4 b, Vec4 c)  { return { _mm_and_ps(_mm_cmpgt_ps(a.V, b.V), c.V) }; }
+inline float VecHorizontalAdd(Vec4 a)
+{
+    auto t = _mm_add_ps(a.V, _mm_movehl_ps(a.V, a.V));
+    t = _mm_add_ss(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(t);
+}
+#else
+template<typename Op>
+inline Vec4 VecOp(Vec4 a, Vec4 b, Op op)
+{ return { { op(a.V[0], b.V[0]), op(a.V[1], b.V[1]), op(a.V[2], b.V[2]), op(a.V[3], b.V[3]) } }; }
+
+inline Vec4 VecZero()                               { return { { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+inline Vec4 VecSplat(float s)                       { return { { s, s, s, s } }; }
+inline Vec4 VecLoad(const float* p)                 { return { { p[0], p[1], p[2], p[3] } }; }
+inline void VecStore(float* p, Vec4 a)              { for(auto i=0; i<4; ++i) { p[i] = a.V[i]; } }
+inline Vec4 VecAdd(Vec4 a, Vec4 b)                  { return VecOp(a, b, [](float x, float y) { return x + y; }); }
+inline Vec4 VecSub(Vec4 a, Vec4 b)                  { return VecOp(a, b, [](float x, float y) { return x - y; }); }
+inline Vec4 VecMul(Vec4 a, Vec4 b)                  { return VecOp(a, b, [](float x, float y) { return x * y; }); }
+inline Vec4 VecDiv(Vec4 a, Vec4 b)                  { return VecOp(a, b, [](float x, float y) { return x / y; }); }
+inline Vec4 VecMax(Vec4 a, Vec4 b)                  { return VecOp(a, b, [](float x, float y) { return std::max(x, y); }); }
+inline Vec4 VecMin(Vec4 a, Vec4 b)                  { return VecOp(a, b, [](float x, float y) { return std::min(x, y); }); }
+inline Vec4 VecSqrt(Vec4 a)                         { return { { sqrtf(a.V[0]), sqrtf(a.V[1]), sqrtf(a.V[2]), sqrtf(a.V[3]) } }; }
+inline Vec4 VecMaskGreater(Vec4 a, Vec4 b, Vec4 c)
+{
+    return { {
+        (a.V[0] > b.V[0]) ? c.V[0] : 0.0f,
+        (a.V[1] > b.V[1]) ? c.V[1] : 0.0f,
+        (a.V[2] > b.V[2]) ? c.V[2] : 0.0f,
+        (a.V[3] > b.V[3]) ? c.V[3] : 0.0f } };
+}
+inline float VecHorizontalAdd(Vec4 a)
+{ return (a.V[0] + a.V[1]) + (a.V[2] + a.V[3]); }
+#endif
+
+//-----------------------------------------------------------------------------
+//      a + (b - a) * t を求めます.
+//-----------------------------------------------------------------------------
+inline Vec4 VecLerp(Vec4 a, Vec4 b, float t)
+{ return VecAdd(a, VecMul(VecSub(b, a), VecSplat(t))); }
@@ -0,0 +1,392 @@
+﻿//-----------------------------------------------------------------------------
+// File : EnvMapConverter.cpp
+// Desc : Environment Map Layout Converter on CPU.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <EnvMapConverter.h>
+#include <ParallelFor.h>
+#include <SimdVec4.h>
+#include <CubeMapUtil.h>
+#include <cmath>
+#include <algorithm>
+#include <Logger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr float     kPi             = 3.14159265358979323f;
+constexpr uint32_t  kTileSize       = 32;
+constexpr uint32_t  kMaxSuperSample = 4;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SourceView structure
+///////////////////////////////////////////////////////////////////////////////
+struct SourceView
+{
+    ENVMAP_LAYOUT   Layout;         //!< レイアウト.
+    ENVMAP_FILTER   Filter;         //!< サンプリングフィルタ.
+    const float*    pPixels[6];     //!< 面毎のミップレベル0の先頭ポインタ.
+    uint32_t        Width;          //!< 横幅.
+    uint32_t        Height;         //!< 縦幅.
+};
+
+//-----------------------------------------------------------------------------
+//      テクセルを取得します. 横方向はラップ, 縦方向はクランプします.
+//-----------------------------------------------------------------------------
+inline Vec4 FetchTexel(const float* pPixels, uint32_t w, uint32_t h, int32_t x, int32_t y, bool wrapX)
+{
+    if (wrapX)
+    {
+        x %= int32_t(w);
+        if (x < 0)
+        { x += int32_t(w); }
+    }
+    else
+    { x = std::min(std::max(x, 0), int32_t(w) - 1); }
+    y = std::min(std::max(y, 0), int32_t(h) - 1);
+
+    return VecLoad(pPixels + (size_t(y) * w + x) * 4);
+}
+
+//-----------------------------------------------------------------------------
+//      バイリニア補間でサンプリングします.
+//-----------------------------------------------------------------------------
+inline Vec4 SampleBilinear2D(const float* pPixels, uint32_t w, uint32_t h, float u, float v, bool wrapX)
+{
+    auto fx = u * float(w) - 0.5f;
+    auto fy = v * float(h) - 0.5f;
+    auto x0 = int32_t(floorf(fx));
+    auto y0 = int32_t(floorf(fy));
+    auto tx = fx - float(x0);
+    auto ty = fy - float(y0);
+
+    auto c0 = VecLerp(
+        FetchTexel(pPixels, w, h, x0 + 0, y0, wrapX),
+        FetchTexel(pPixels, w, h, x0 + 1, y0, wrapX), tx);
+    auto c1 = VecLerp(
+        FetchTexel(pPixels, w, h, x0 + 0, y0 + 1, wrapX),
+        FetchTexel(pPixels, w, h, x0 + 1, y0 + 1, wrapX), tx);
+    return VecLerp(c0, c1, ty);
+}
+
+//-----------------------------------------------------------------------------
+//      Catmull-Rom スプラインの重みを求めます.
+//-----------------------------------------------------------------------------
+inline void CatmullRomWeights(float t, float w[4])
+{
+    auto t2 = t * t;
+    auto t3 = t2 * t;
+    w[0] = -0.5f * t3 +        t2 - 0.5f * t;
+    w[1] =  1.5f * t3 - 2.5f * t2 + 1.0f;
+    w[2] = -1.5f * t3 + 2.0f * t2 + 0.5f * t;
+    w[3] =  0.5f * t3 - 0.5f * t2;
+}
+
+//-----------------------------------------------------------------------------
+//      双三次補間でサンプリングします.
+//-----------------------------------------------------------------------------
+inline Vec4 SampleBicubic2D(const float* pPixels, uint32_t w, uint32_t h, float u, float v, bool wrapX)
+{
+    auto fx = u * float(w) - 0.5f;
+    auto fy = v * float(h) - 0.5f;
+    auto x0 = int32_t(floorf(fx));
+    auto y0 = int32_t(floorf(fy));
+
+    float wx[4], wy[4];
+    CatmullRomWeights(fx - float(x0), wx);
+    CatmullRomWeights(fy - float(y0), wy);
+
+    auto result = VecZero();
+    for(auto j=0; j<4; ++j)
+    {
+        auto row = VecZero();
+        for(auto i=0; i<4; ++i)
+        {
+            auto texel = FetchTexel(pPixels, w, h, x0 + i - 1, y0 + j - 1, wrapX);
+            row = VecAdd(row, VecMul(texel, VecSplat(wx[i])));
+        }
+        result = VecAdd(result, VecMul(row, VecSplat(wy[j])));
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャ座標から方向ベクトルを求めます.
+//-----------------------------------------------------------------------------
+inline bool CalcLayoutDirection(ENVMAP_LAYOUT layout, uint32_t face, float u, float v, float dir[3])
+{
+    switch(layout)
+    {
+    case ENVMAP_LAYOUT_EQUIRECT:
+        {
+            // SphereToCubePS.hlsl の逆変換. (x, y, -z) を経度・緯度に写像している.
+            auto phi   = u * 2.0f * kPi;
+            auto theta = (0.5f - v) * kPi;
+            auto c     = cosf(theta);
+            dir[0] =  c * sinf(phi);
+            dir[1] =  sinf(theta);
+            dir[2] = -c * cosf(phi);
+        }
+        return true;
+
+    case ENVMAP_LAYOUT_SPHERE:
+        {
+            auto x  = u * 2.0f - 1.0f;
+            auto y  = 1.0f - v * 2.0f;
+            auto r2 = x * x + y * y;
+            if (r2 > 1.0f)
+            { return false; }
+
+            // 法線 n で視線 (0, 0, -1) を反射した方向.
+            auto nz = sqrtf(1.0f - r2);
+            dir[0] = 2.0f * nz * x;
+            dir[1] = 2.0f * nz * y;
+            dir[2] = 2.0f * nz * nz - 1.0f;
+        }
+        return true;
+
+    default:
+        {
+            // キューブマップは上端が v = 1.
+            CalcCubeDirection(u, 1.0f - v, face, dir);
+        }
+        return true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      方向ベクトルからテクスチャ座標を求めます.
+//-----------------------------------------------------------------------------
+inline uint32_t CalcLayoutCoord(ENVMAP_LAYOUT layout, const float dir[3], float& u, float& v)
+{
+    switch(layout)
+    {
+    case ENVMAP_LAYOUT_EQUIRECT:
+        {
+            auto len = sqrtf(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+            auto y   = std::min(std::max(dir[1] / std::max(len, 1e-20f), -1.0f), 1.0f);
+
+            u = atan2f(dir[0], -dir[2]) / (2.0f * kPi);
+            if (u < 0.0f)
+            { u += 1.0f; }
+            v = 0.5f - asinf(y) / kPi;
+        }
+        return 0;
+
+    case ENVMAP_LAYOUT_SPHERE:
+        {
+            // 反射方向と視点方向 (0, 0, 1) の中間が法線になる.
+            auto len = sqrtf(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+            auto hx  = dir[0] / std::max(len, 1e-20f);
+            auto hy  = dir[1] / std::max(len, 1e-20f);
+            auto hz  = dir[2] / std::max(len, 1e-20f) + 1.0f;
+            auto hl  = sqrtf(hx * hx + hy * hy + hz * hz);
+            if (hl < 1e-6f)
+            {
+                // 真後ろは円周上のどこでも良い.
+                u = 1.0f;
+                v = 0.5f;
+                return 0;
+            }
+
+            u = 0.5f + 0.5f * hx / hl;
+            v = 0.5f - 0.5f * hy / hl;
+        }
+        return 0;
+
+    default:
+        return CalcCubeCoord(dir, u, v);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      入力を方向ベクトルでサンプリングします.
+//-----------------------------------------------------------------------------
+inline Vec4 SampleSource(const SourceView& view, const float dir[3])
+{
+    float u, v;
+    auto face   = CalcLayoutCoord(view.Layout, dir, u, v);
+    auto wrapX  = (view.Layout == ENVMAP_LAYOUT_EQUIRECT);
+    auto pPixels = view.pPixels[face];
+
+    if (view.Filter == ENVMAP_FILTER_BICUBIC)
+    { return SampleBicubic2D(pPixels, view.Width, view.Height, u, v, wrapX); }
+
+    if (view.Layout == ENVMAP_LAYOUT_CUBE)
+    { return SampleBilinear(pPixels, view.Width, u, v); }
+
+    return SampleBilinear2D(pPixels, view.Width, view.Height, u, v, wrapX);
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップ換算のサイズを求めます.
+//-----------------------------------------------------------------------------
+uint32_t CalcEquivalentCubeSize(ENVMAP_LAYOUT layout, uint32_t width)
+{
+    switch(layout)
+    {
+    case ENVMAP_LAYOUT_EQUIRECT:    return CalcCubeMapSize(width);
+    case ENVMAP_LAYOUT_SPHERE:      return CalcCubeMapSize(width * 2);
+    default:                        return width;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      単位立体角当たりの平均テクセル数を求めます.
+//-----------------------------------------------------------------------------
+float CalcTexelDensity(ENVMAP_LAYOUT layout, uint32_t width, uint32_t height)
+{
+    auto count = float(width) * float(height);
+    switch(layout)
+    {
+    case ENVMAP_LAYOUT_EQUIRECT:    return count / (4.0f * kPi);
+    case ENVMAP_LAYOUT_SPHERE:      return count * 0.25f / 4.0f;    // 円の面積 π r^2 を 4π で割る.
+    default:                        return count * 6.0f / (4.0f * kPi);
+    }
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      入力の横幅からキューブマップのサイズを求めます.
+//-----------------------------------------------------------------------------
+uint32_t CalcCubeMapSize(uint32_t srcWidth)
+{
+    auto target = std::max(srcWidth / 4, 1u);
+    auto size   = 1u;
+    while (size < target)
+    { size <<= 1; }
+    return size;
+}
+
+//-----------------------------------------------------------------------------
+//      環境マップのレイアウトを変換します.
+//-----------------------------------------------------------------------------
+bool ConvertEnvMap(const FloatImage& src, const EnvMapConvertDesc& desc, FloatImage& dst)
+{
+    if (src.Width == 0 || src.Height == 0 || src.Pixels.empty())
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    if (desc.SrcLayout == ENVMAP_LAYOUT_CUBE && (!src.IsCube || src.ArraySize < 6 || src.Width != src.Height))
+    {
+        ELOG("Error : Input Is Not Cube Map.");
+        return false;
+    }
+
+    // 出力サイズを決定.
+    auto width  = desc.Width;
+    auto height = desc.Height;
+    if (width == 0)
+    {
+        auto size = CalcEquivalentCubeSize(desc.SrcLayout, src.Width);
+        switch(desc.DstLayout)
+        {
+        case ENVMAP_LAYOUT_EQUIRECT:    width = size * 4; break;
+        case ENVMAP_LAYOUT_SPHERE:      width = size * 2; break;
+        default:                        width = size;     break;
+        }
+    }
+    if (height == 0)
+    { height = (desc.DstLayout == ENVMAP_LAYOUT_EQUIRECT) ? std::max(width / 2, 1u) : width; }
+
+    if (desc.DstLayout == ENVMAP_LAYOUT_CUBE && width != height)
+    {
+        ELOG("Error : Cube Map Size Must Be Square. width = %u, height = %u", width, height);
+        return false;
+    }
+
+    // スーパーサンプル数を決定. 入力の方が細かい分だけ1テクセル内で複数回サンプルする.
+    auto superSample = desc.SuperSample;
+    if (superSample == 0)
+    {
+        auto ratio = sqrtf(
+            CalcTexelDensity(desc.SrcLayout, src.Width, src.Height) /
+            CalcTexelDensity(desc.DstLayout, width, height));
+        superSample = uint32_t(std::lround(ratio));
+    }
+    superSample = std::min(std::max(superSample, 1u), kMaxSuperSample);
+
+    SourceView view = {};
+    view.Layout = desc.SrcLayout;
+    view.Filter = desc.Filter;
+    view.Width  = src.Width;
+    view.Height = src.Height;
+    for(auto f=0u; f<6; ++f)
+    { view.pPixels[f] = src.GetPixels((desc.SrcLayout == ENVMAP_LAYOUT_CUBE) ? f : 0, 0); }
+
+    auto isCube    = (desc.DstLayout == ENVMAP_LAYOUT_CUBE);
+    auto faceCount = isCube ? 6u : 1u;
+    dst.Init(width, height, faceCount, 1, isCube);
+
+    auto tileX     = (width  + kTileSize - 1) / kTileSize;
+    auto tileY     = (height + kTileSize - 1) / kTileSize;
+    auto tileCount = tileX * tileY;
+    auto invSS     = 1.0f / float(superSample);
+
+    // タイル単位で分割する.
+    ParallelFor(faceCount * tileCount, desc.ThreadCount, [&](uint32_t index)
+    {
+        auto face = index / tileCount;
+        auto tile = index % tileCount;
+        auto x0   = (tile % tileX) * kTileSize;
+        auto y0   = (tile / tileX) * kTileSize;
+        auto x1   = std::min(x0 + kTileSize, width);
+        auto y1   = std::min(y0 + kTileSize, height);
+
+        auto pDst = dst.GetPixels(face, 0);
+
+        for(auto y=y0; y<y1; ++y)
+        {
+            for(auto x=x0; x<x1; ++x)
+            {
+                auto sum   = VecZero();
+                auto count = 0u;
+                for(auto sy=0u; sy<superSample; ++sy)
+                {
+                    for(auto sx=0u; sx<superSample; ++sx)
+                    {
+                        auto u = (float(x) + (float(sx) + 0.5f) * invSS) / float(width);
+                        auto v = (float(y) + (float(sy) + 0.5f) * invSS) / float(height);
+
+                        float dir[3];
+                        if (!CalcLayoutDirection(desc.DstLayout, face, u, v, dir))
+                        { continue; }
+
+                        sum = VecAdd(sum, SampleSource(view, dir));
+                        count++;
+                    }
+                }
+
+                // 双三次補間のオーバーシュートによる負の値を除去.
+                auto result = (count > 0)
+                    ? VecMax(VecMul(sum, VecSplat(1.0f / float(count))), VecZero())
+                    : VecZero();
+                VecStore(pDst + (size_t(y) * width + x) * 4, result);
+            }
+        }
+    });
+
+    if (desc.MipLevels != 1)
+    {
+        if (!GenerateMipmaps(dst, desc.MipLevels, desc.ThreadCount, desc.MipFilter))
+        {
+            ELOG("Error : GenerateMipmaps() Failed.");
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,978 @@
+﻿//-----------------------------------------------------------------------------
+// File : FloatImage.cpp
+// Desc : Floating Point Image.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <FloatImage.h>
+#include <ParallelFor.h>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <Logger.h>
+#include <Compat.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr uint32_t  kDDSMagic                   = 0x20534444;   // "DDS "
+constexpr uint32_t  kFourCC_DX10                = 0x30315844;   // "DX10"
+constexpr uint32_t  kD3DFMT_G32R32F             = 115;
+constexpr uint32_t  kD3DFMT_A16B16G16R16F       = 113;
+constexpr uint32_t  kD3DFMT_A32B32G32R32F       = 116;
+constexpr uint32_t  kDXGI_R32G32B32A32_FLOAT    = 2;
+constexpr uint32_t  kDXGI_R16G16B16A16_FLOAT    = 10;
+constexpr uint32_t  kDXGI_R32G32_FLOAT          = 16;
+constexpr uint32_t  kDDSD_CAPS                  = 0x1;
+constexpr uint32_t  kDDSD_HEIGHT                = 0x2;
+constexpr uint32_t  kDDSD_WIDTH                 = 0x4;
+constexpr uint32_t  kDDSD_PITCH                 = 0x8;
+constexpr uint32_t  kDDSD_PIXELFORMAT           = 0x1000;
+constexpr uint32_t  kDDSD_MIPMAPCOUNT           = 0x20000;
+constexpr uint32_t  kDDPF_FOURCC                = 0x4;
+constexpr uint32_t  kDDSCAPS_COMPLEX            = 0x8;
+constexpr uint32_t  kDDSCAPS_TEXTURE            = 0x1000;
+constexpr uint32_t  kDDSCAPS_MIPMAP             = 0x400000;
+constexpr uint32_t  kDDSCAPS2_CUBEMAP           = 0x200;
+constexpr uint32_t  kDDSCAPS2_CUBEMAP_ALLFACES  = 0xFC00;
+constexpr uint32_t  kDDSCAPS2_VOLUME            = 0x200000;
+constexpr uint32_t  kResourceDimensionTex2D     = 3;
+constexpr uint32_t  kResourceMiscTextureCube    = 0x4;
+constexpr float     kKaiserWidth                = 3.0f;         // フィルタ半径(出力テクセル単位).
+constexpr float     kKaiserAlpha                = 4.0f;
+constexpr float     kPi                         = 3.14159265358979323f;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// DDSPixelFormat structure
+///////////////////////////////////////////////////////////////////////////////
+struct DDSPixelFormat
+{
+    uint32_t    Size;
+    uint32_t    Flags;
+    uint32_t    FourCC;
+    uint32_t    RGBBitCount;
+    uint32_t    RBitMask;
+    uint32_t    GBitMask;
+    uint32_t    BBitMask;
+    uint32_t    ABitMask;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// DDSHeader structure
+///////////////////////////////////////////////////////////////////////////////
+struct DDSHeader
+{
+    uint32_t        Size;
+    uint32_t        Flags;
+    uint32_t        Height;
+    uint32_t        Width;
+    uint32_t        PitchOrLinearSize;
+    uint32_t        Depth;
+    uint32_t        MipMapCount;
+    uint32_t        Reserved1[11];
+    DDSPixelFormat  PixelFormat;
+    uint32_t        Caps;
+    uint32_t        Caps2;
+    uint32_t        Caps3;
+    uint32_t        Caps4;
+    uint32_t        Reserved2;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// DDSHeaderDXT10 structure
+///////////////////////////////////////////////////////////////////////////////
+struct DDSHeaderDXT10
+{
+    uint32_t    DXGIFormat;
+    uint32_t    ResourceDimension;
+    uint32_t    MiscFlag;
+    uint32_t    ArraySize;
+    uint32_t    MiscFlags2;
+};
+
+static_assert(sizeof(DDSHeader)      == 124, "Invalid DDSHeader size.");
+static_assert(sizeof(DDSHeaderDXT10) == 20,  "Invalid DDSHeaderDXT10 size.");
+
+//-----------------------------------------------------------------------------
+//      半精度浮動小数を単精度に変換します.
+//-----------------------------------------------------------------------------
+float HalfToFloat(uint16_t value)
+{
+    auto sign = uint32_t(value & 0x8000) << 16;
+    auto exp  = uint32_t(value >> 10) & 0x1f;
+    auto mant = uint32_t(value & 0x3ff);
+
+    uint32_t bits;
+    if (exp == 0)
+    {
+        if (mant == 0)
+        { bits = sign; }
+        else
+        {
+            // 非正規化数を正規化する.
+            exp = 127 - 15 + 1;
+            while ((mant & 0x400) == 0)
+            {
+                mant <<= 1;
+                exp--;
+            }
+            mant &= 0x3ff;
+            bits = sign | (exp << 23) | (mant << 13);
+        }
+    }
+    else if (exp == 0x1f)
+    { bits = sign | 0x7f800000 | (mant << 13); }
+    else
+    { bits = sign | ((exp + 127 - 15) << 23) | (mant << 13); }
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      単精度浮動小数を半精度に変換します(最近接偶数丸め).
+//-----------------------------------------------------------------------------
+uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    auto sign = uint16_t((bits >> 16) & 0x8000);
+    auto exp  = int32_t((bits >> 23) & 0xff);
+    auto mant = bits & 0x7fffff;
+
+    if (exp == 0xff)
+    { return uint16_t(sign | 0x7c00 | (mant ? 0x200 : 0)); }
+
+    exp = exp - 127 + 15;
+    if (exp >= 0x1f)
+    { return uint16_t(sign | 0x7c00); }
+
+    if (exp <= 0)
+    {
+        // 非正規化数または0.
+        if (exp < -10)
+        { return sign; }
+
+        mant |= 0x800000;
+        auto shift = uint32_t(14 - exp);
+        auto half  = mant >> shift;
+        auto rest  = mant & ((1u << shift) - 1);
+        auto mid   = 1u << (shift - 1);
+        if (rest > mid || (rest == mid && (half & 1)))
+        { half++; }
+        return uint16_t(sign | half);
+    }
+
+    auto half = uint32_t(exp << 10) | (mant >> 13);
+    auto rest = mant & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+    { half++; }     // 繰り上がりで指数が増えても正しい値になる.
+
+    return uint16_t(sign | half);
+}
+
+//-----------------------------------------------------------------------------
+//      1ピクセル当たりの成分数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetComponentCount(FLOAT_IMAGE_FORMAT format)
+{ return (format == FLOAT_IMAGE_FORMAT_RG32) ? 2 : 4; }
+
+//-----------------------------------------------------------------------------
+//      1成分当たりのバイト数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetComponentSize(FLOAT_IMAGE_FORMAT format)
+{ return (format == FLOAT_IMAGE_FORMAT_RGBA16) ? 2 : 4; }
+
+///////////////////////////////////////////////////////////////////////////////
+// FilterTap structure
+///////////////////////////////////////////////////////////////////////////////
+struct FilterTap
+{
+    uint32_t    Index;      //!< 入力テクセル番号(クランプ済み).
+    float       Weight;     //!< 正規化済みの重み.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FilterSpan structure
+///////////////////////////////////////////////////////////////////////////////
+struct FilterSpan
+{
+    uint32_t    Offset;     //!< タップ配列内の先頭位置.
+    uint32_t    Count;      //!< タップ数.
+};
+
+//-----------------------------------------------------------------------------
+//      第1種変形ベッセル関数(0次)を求めます.
+//-----------------------------------------------------------------------------
+double BesselI0(double x)
+{
+    auto sum  = 1.0;
+    auto term = 1.0;
+    auto half = x * 0.5;
+    for(auto k=1; k<64; ++k)
+    {
+        term *= (half / k) * (half / k);
+        sum  += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+    return sum;
+}
+
+//-----------------------------------------------------------------------------
+//      カイザー窓付き sinc 関数を評価します.
+//-----------------------------------------------------------------------------
+float KaiserSinc(float t)
+{
+    auto at = fabsf(t);
+    if (at >= kKaiserWidth)
+    { return 0.0f; }
+
+    auto sinc = (at < 1e-6f) ? 1.0f : sinf(kPi * t) / (kPi * t);
+    auto r    = t / kKaiserWidth;
+    auto w    = BesselI0(kKaiserAlpha * sqrt(1.0 - r * r)) / BesselI0(kKaiserAlpha);
+    return sinc * float(w);
+}
+
+//-----------------------------------------------------------------------------
+//      1次元のカイザーフィルタのタップを構築します.
+//-----------------------------------------------------------------------------
+void BuildKaiserTaps
+(
+    uint32_t                    srcSize,
+    uint32_t                    dstSize,
+    std::vector<FilterSpan>&    spans,
+    std::vector<FilterTap>&     taps
+)
+{
+    auto scale  = float(srcSize) / float(dstSize);
+    auto radius = kKaiserWidth * scale;
+
+    spans.resize(dstSize);
+    taps.clear();
+
+    for(auto x=0u; x<dstSize; ++x)
+    {
+        auto center = (float(x) + 0.5f) * scale;
+        auto begin  = int32_t(floorf(center - radius));
+        auto end    = int32_t(ceilf (center + radius));
+
+        auto offset = uint32_t(taps.size());
+        auto sum    = 0.0f;
+        for(auto i=begin; i<=end; ++i)
+        {
+            auto w = KaiserSinc((float(i) + 0.5f - center) / scale);
+            if (w == 0.0f)
+            { continue; }
+
+            // 端はクランプ.
+            auto index = uint32_t(std::min(std::max(i, 0), int32_t(srcSize) - 1));
+            taps.push_back({ index, w });
+            sum += w;
+        }
+
+        auto invSum = (sum != 0.0f) ? 1.0f / sum : 0.0f;
+        for(auto i=offset; i<taps.size(); ++i)
+        { taps[i].Weight *= invSum; }
+
+        spans[x].Offset = offset;
+        spans[x].Count  = uint32_t(taps.size()) - offset;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      2x2 ボックスフィルタで1段縮小します.
+//-----------------------------------------------------------------------------
+void DownsampleBox(FloatImage& image, uint32_t m, uint32_t threadCount)
+{
+    auto srcW = image.GetMipWidth (m - 1);
+    auto srcH = image.GetMipHeight(m - 1);
+    auto dstW = image.GetMipWidth (m);
+    auto dstH = image.GetMipHeight(m);
+
+    // 配列と行をまとめて分割する.
+    ParallelFor(image.ArraySize * dstH, threadCount, [&](uint32_t index)
+    {
+        auto i = index / dstH;
+        auto y = index % dstH;
+
+        auto pSrc = image.GetPixels(i, m - 1);
+        auto pDst = image.GetPixels(i, m) + size_t(y) * dstW * 4;
+
+        auto y0 = std::min(y * 2 + 0, srcH - 1);
+        auto y1 = std::min(y * 2 + 1, srcH - 1);
+        auto row0 = pSrc + size_t(y0) * srcW * 4;
+        auto row1 = pSrc + size_t(y1) * srcW * 4;
+
+        for(auto x=0u; x<dstW; ++x)
+        {
+            auto x0 = std::min(x * 2 + 0, srcW - 1) * 4;
+            auto x1 = std::min(x * 2 + 1, srcW - 1) * 4;
+            for(auto c=0; c<4; ++c)
+            {
+                pDst[x * 4 + c] = 0.25f * (
+                    row0[x0 + c] + row0[x1 + c] +
+                    row1[x0 + c] + row1[x1 + c]);
+            }
+        }
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      カイザーフィルタで1段縮小します.
+//-----------------------------------------------------------------------------
+void DownsampleKaiser(FloatImage& image, uint32_t m, uint32_t threadCount)
+{
+    auto srcW = image.GetMipWidth (m - 1);
+    auto srcH = image.GetMipHeight(m - 1);
+    auto dstW = image.GetMipWidth (m);
+    auto dstH = image.GetMipHeight(m);
+
+    std::vector<FilterSpan> spansX, spansY;
+    std::vector<FilterTap>  tapsX,  tapsY;
+    BuildKaiserTaps(srcW, dstW, spansX, tapsX);
+    BuildKaiserTaps(srcH, dstH, spansY, tapsY);
+
+    // 横方向 : srcW x srcH → dstW x srcH.
+    std::vector<float> temp(size_t(image.ArraySize) * srcH * dstW * 4);
+    ParallelFor(image.ArraySize * srcH, threadCount, [&](uint32_t index)
+    {
+        auto i = index / srcH;
+        auto y = index % srcH;
+
+        auto pSrc = image.GetPixels(i, m - 1) + size_t(y) * srcW * 4;
+        auto pDst = temp.data() + size_t(index) * dstW * 4;
+
+        for(auto x=0u; x<dstW; ++x)
+        {
+            float sum[4] = {};
+            auto& span = spansX[x];
+            for(auto t=0u; t<span.Count; ++t)
+            {
+                auto& tap = tapsX[span.Offset + t];
+                auto  pix = pSrc + tap.Index * 4;
+                for(auto c=0; c<4; ++c)
+                { sum[c] += pix[c] * tap.Weight; }
+            }
+
+            for(auto c=0; c<4; ++c)
+            { pDst[x * 4 + c] = sum[c]; }
+        }
+    });
+
+    // 縦方向 : dstW x srcH → dstW x dstH.
+    auto rowSize = size_t(dstW) * 4;
+    ParallelFor(image.ArraySize * dstH, threadCount, [&](uint32_t index)
+    {
+        auto i = index / dstH;
+        auto y = index % dstH;
+
+        auto pDst = image.GetPixels(i, m) + size_t(y) * rowSize;
+        memset(pDst, 0, rowSize * sizeof(float));
+
+        // 行単位で積和して連続アクセスにする.
+        auto& span = spansY[y];
+        for(auto t=0u; t<span.Count; ++t)
+        {
+            auto& tap  = tapsY[span.Offset + t];
+            auto  pSrc = temp.data() + (size_t(i) * srcH + tap.Index) * rowSize;
+            for(auto k=0u; k<rowSize; ++k)
+            { pDst[k] += pSrc[k] * tap.Weight; }
+        }
+
+        // リンギングによる負の値を除去.
+        for(auto k=0u; k<rowSize; ++k)
+        { pDst[k] = std::max(pDst[k], 0.0f); }
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      RGBE形式のスキャンラインをデコードします.
+//-----------------------------------------------------------------------------
+bool DecodeScanlineRGBE(const uint8_t*& pCur, const uint8_t* pEnd, uint8_t* pLine, uint32_t width)
+{
+    // 新形式のランレングス : 2, 2, 幅(上位), 幅(下位) に続いて成分毎のラン.
+    if (width >= 8 && width <= 0x7fff && pEnd - pCur >= 4
+     && pCur[0] == 2 && pCur[1] == 2 && (pCur[2] & 0x80) == 0)
+    {
+        if (((uint32_t(pCur[2]) << 8) | pCur[3]) != width)
+        { return false; }
+        pCur += 4;
+
+        for(auto c=0; c<4; ++c)
+        {
+            for(auto x=0u; x<width; )
+            {
+                if (pCur >= pEnd)
+                { return false; }
+
+                auto code = uint32_t(*pCur++);
+                if (code > 128)
+                {
+                    code &= 127;
+                    if (pCur >= pEnd || x + code > width)
+                    { return false; }
+
+                    auto val = *pCur++;
+                    for(auto k=0u; k<code; ++k, ++x)
+                    { pLine[x * 4 + c] = val; }
+                }
+                else
+                {
+                    if (code == 0 || x + code > width || size_t(pEnd - pCur) < code)
+                    { return false; }
+
+                    for(auto k=0u; k<code; ++k, ++x)
+                    { pLine[x * 4 + c] = *pCur++; }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // 旧形式 : (1, 1, 1, n) で直前のピクセルを繰り返す.
+    auto shift = 0u;
+    for(auto x=0u; x<width; )
+    {
+        if (pEnd - pCur < 4)
+        { return false; }
+
+        if (pCur[0] == 1 && pCur[1] == 1 && pCur[2] == 1)
+        {
+            if (x == 0 || shift >= 32)
+            { return false; }
+
+            auto count = std::min(uint32_t(pCur[3]) << shift, width - x);
+            for(auto k=0u; k<count; ++k, ++x)
+            { memcpy(pLine + x * 4, pLine + (x - 1) * 4, 4); }
+
+            shift += 8;
+        }
+        else
+        {
+            memcpy(pLine + x * 4, pCur, 4);
+            x++;
+            shift = 0;
+        }
+        pCur += 4;
+    }
+
+    return true;
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FloatImage structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      メモリを確保します.
+//-----------------------------------------------------------------------------
+void FloatImage::Init
+(
+    uint32_t    width,
+    uint32_t    height,
+    uint32_t    arraySize,
+    uint32_t    mipLevels,
+    bool        isCube
+)
+{
+    Width       = width;
+    Height      = height;
+    ArraySize   = arraySize;
+    MipLevels   = mipLevels;
+    IsCube      = isCube;
+
+    Pixels.clear();
+    Pixels.resize(GetOffset(arraySize, 0), 0.0f);
+}
+
+//-----------------------------------------------------------------------------
+//      サブリソースの先頭位置を取得します.
+//-----------------------------------------------------------------------------
+size_t FloatImage::GetOffset(uint32_t index, uint32_t mip) const
+{
+    size_t sliceSize = 0;
+    for(auto m=0u; m<MipLevels; ++m)
+    { sliceSize += size_t(GetMipWidth(m)) * GetMipHeight(m) * 4; }
+
+    auto offset = sliceSize * index;
+    for(auto m=0u; m<mip; ++m)
+    { offset += size_t(GetMipWidth(m)) * GetMipHeight(m) * 4; }
+
+    return offset;
+}
+
+//-----------------------------------------------------------------------------
+//      フルミップチェインのレベル数を求めます.
+//-----------------------------------------------------------------------------
+uint32_t CalcMipLevels(uint32_t width, uint32_t height)
+{
+    auto size  = std::max(width, height);
+    auto count = 1u;
+    while (size > 1)
+    {
+        size >>= 1;
+        count++;
+    }
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+//      ミップマップを生成します.
+//-----------------------------------------------------------------------------
+bool GenerateMipmaps
+(
+    FloatImage&     image,
+    uint32_t        mipLevels,
+    uint32_t        threadCount,
+    MIPMAP_FILTER   filter
+)
+{
+    if (image.Width == 0 || image.Height == 0 || image.ArraySize == 0 || image.Pixels.empty())
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto maxLevels = CalcMipLevels(image.Width, image.Height);
+    if (mipLevels == 0 || mipLevels > maxLevels)
+    { mipLevels = maxLevels; }
+
+    // ミップレベル0だけ残して作り直す.
+    FloatImage result;
+    result.Init(image.Width, image.Height, image.ArraySize, mipLevels, image.IsCube);
+
+    auto baseSize = size_t(image.Width) * image.Height * 4;
+    for(auto i=0u; i<image.ArraySize; ++i)
+    { memcpy(result.GetPixels(i, 0), image.GetPixels(i, 0), baseSize * sizeof(float)); }
+
+    for(auto m=1u; m<mipLevels; ++m)
+    {
+        if (filter == MIPMAP_FILTER_KAISER)
+        { DownsampleKaiser(result, m, threadCount); }
+        else
+        { DownsampleBox(result, m, threadCount); }
+    }
+
+    image = std::move(result);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      DDSファイルを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadDDS(const char* path, FloatImage& image)
+{
+    FILE* pFile = nullptr;
+    auto err = fopen_s(&pFile, path, "rb");
+    if (err != 0 || pFile == nullptr)
+    {
+        ELOG("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    uint32_t  magic  = 0;
+    DDSHeader header = {};
+    if (fread(&magic, sizeof(magic), 1, pFile) != 1
+     || fread(&header, sizeof(header), 1, pFile) != 1
+     || magic != kDDSMagic
+     || header.Size != sizeof(DDSHeader))
+    {
+        ELOG("Error : Invalid DDS File. path = %s", path);
+        fclose(pFile);
+        return false;
+    }
+
+    auto format    = FLOAT_IMAGE_FORMAT_RGBA32;
+    auto arraySize = 1u;
+    auto isCube    = false;
+
+    if ((header.PixelFormat.Flags & kDDPF_FOURCC) == 0)
+    {
+        ELOG("Error : Unsupported DDS Format. path = %s", path);
+        fclose(pFile);
+        return false;
+    }
+
+    if (header.PixelFormat.FourCC == kFourCC_DX10)
+    {
+        DDSHeaderDXT10 ext = {};
+        if (fread(&ext, sizeof(ext), 1, pFile) != 1)
+        {
+            ELOG("Error : Invalid DDS File. path = %s", path);
+            fclose(pFile);
+            return false;
+        }
+
+        if (ext.ResourceDimension != kResourceDimensionTex2D)
+        {
+            ELOG("Error : Unsupported Resource Dimension. path = %s, dimension = %u", path, ext.ResourceDimension);
+            fclose(pFile);
+            return false;
+        }
+
+        switch(ext.DXGIFormat)
+        {
+        case kDXGI_R32G32B32A32_FLOAT: { format = FLOAT_IMAGE_FORMAT_RGBA32; } break;
+        case kDXGI_R16G16B16A16_FLOAT: { format = FLOAT_IMAGE_FORMAT_RGBA16; } break;
+        case kDXGI_R32G32_FLOAT:       { format = FLOAT_IMAGE_FORMAT_RG32; } break;
+        default:
+            {
+                ELOG("Error : Unsupported DXGI Format. path = %s, format = %u", path, ext.DXGIFormat);
+                fclose(pFile);
+                return false;
+            }
+        }
+
+        isCube    = (ext.MiscFlag & kResourceMiscTextureCube) != 0;
+        arraySize = std::max(ext.ArraySize, 1u) * (isCube ? 6 : 1);
+    }
+    else
+    {
+        switch(header.PixelFormat.FourCC)
+        {
+        case kD3DFMT_A32B32G32R32F: { format = FLOAT_IMAGE_FORMAT_RGBA32; } break;
+        case kD3DFMT_A16B16G16R16F: { format = FLOAT_IMAGE_FORMAT_RGBA16; } break;
+        case kD3DFMT_G32R32F:       { format = FLOAT_IMAGE_FORMAT_RG32; } break;
+        default:
+            {
+                ELOG("Error : Unsupported FourCC. path = %s, fourCC = 0x%x", path, header.PixelFormat.FourCC);
+                fclose(pFile);
+                return false;
+            }
+        }
+
+        if (header.Caps2 & kDDSCAPS2_VOLUME)
+        {
+            ELOG("Error : Volume Texture Not Supported. path = %s", path);
+            fclose(pFile);
+            return false;
+        }
+
+        if (header.Caps2 & kDDSCAPS2_CUBEMAP)
+        {
+            if ((header.Caps2 & kDDSCAPS2_CUBEMAP_ALLFACES) != kDDSCAPS2_CUBEMAP_ALLFACES)
+            {
+                ELOG("Error : Partial Cube Map Not Supported. path = %s", path);
+                fclose(pFile);
+                return false;
+            }
+
+            isCube    = true;
+            arraySize = 6;
+        }
+    }
+
+    auto mipLevels = (header.Flags & kDDSD_MIPMAPCOUNT) ? std::max(header.MipMapCount, 1u) : 1u;
+    if (header.Width == 0 || header.Height == 0 || mipLevels > CalcMipLevels(header.Width, header.Height))
+    {
+        ELOG("Error : Invalid DDS Size. path = %s, width = %u, height = %u, mip = %u",
+            path, header.Width, header.Height, mipLevels);
+        fclose(pFile);
+        return false;
+    }
+
+    image.Init(header.Width, header.Height, arraySize, mipLevels, isCube);
+
+    auto components = GetComponentCount(format);
+    auto compSize   = GetComponentSize(format);
+
+    std::vector<uint8_t> buffer;
+    for(auto i=0u; i<arraySize; ++i)
+    {
+        for(auto m=0u; m<mipLevels; ++m)
+        {
+            auto count = size_t(image.GetMipWidth(m)) * image.GetMipHeight(m);
+            buffer.resize(count * components * compSize);
+
+            if (fread(buffer.data(), 1, buffer.size(), pFile) != buffer.size())
+            {
+                ELOG("Error : Unexpected End Of File. path = %s", path);
+                fclose(pFile);
+                return false;
+            }
+
+            auto pDst = image.GetPixels(i, m);
+            if (format == FLOAT_IMAGE_FORMAT_RGBA32)
+            { memcpy(pDst, buffer.data(), buffer.size()); }
+            else if (format == FLOAT_IMAGE_FORMAT_RGBA16)
+            {
+                auto pSrc = reinterpret_cast<const uint16_t*>(buffer.data());
+                for(size_t j=0; j<count * 4; ++j)
+                { pDst[j] = HalfToFloat(pSrc[j]); }
+            }
+            else
+            {
+                auto pSrc = reinterpret_cast<const float*>(buffer.data());
+                for(size_t j=0; j<count; ++j)
+                {
+                    pDst[j * 4 + 0] = pSrc[j * 2 + 0];
+                    pDst[j * 4 + 1] = pSrc[j * 2 + 1];
+                    pDst[j * 4 + 2] = 0.0f;
+                    pDst[j * 4 + 3] = 1.0f;
+                }
+            }
+        }
+    }
+
+    fclose(pFile);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      Radiance HDRファイルを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadHDR(const char* path, FloatImage& image, uint32_t threadCount)
+{
+    FILE* pFile = nullptr;
+    auto err = fopen_s(&pFile, path, "rb");
+    if (err != 0 || pFile == nullptr)
+    {
+        ELOG("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    // 1回でまとめて読み込んでおく.
+    std::vector<uint8_t> buffer;
+    fseek(pFile, 0, SEEK_END);
+    auto fileSize = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    if (fileSize > 0)
+    {
+        buffer.resize(size_t(fileSize));
+        if (fread(buffer.data(), 1, buffer.size(), pFile) != buffer.size())
+        { buffer.clear(); }
+    }
+    fclose(pFile);
+
+    if (buffer.empty())
+    {
+        ELOG("Error : File Read Failed. path = %s", path);
+        return false;
+    }
+
+    const uint8_t* pCur = buffer.data();
+    const uint8_t* pEnd = buffer.data() + buffer.size();
+
+    auto readLine = [&](std::string& line)
+    {
+        line.clear();
+        while (pCur < pEnd && *pCur != '\n')
+        { line.push_back(char(*pCur++)); }
+
+        if (pCur >= pEnd)
+        { return false; }
+
+        pCur++;
+        if (!line.empty() && line.back() == '\r')
+        { line.pop_back(); }
+        return true;
+    };
+
+    // マジックをチェック.
+    std::string line;
+    if (!readLine(line) || (line != "#?RADIANCE" && line != "#?RGBE"))
+    {
+        ELOG("Error : Invalid File. path = %s", path);
+        return false;
+    }
+
+    // 空行までがヘッダ.
+    for(;;)
+    {
+        if (!readLine(line))
+        {
+            ELOG("Error : Unexpected End Of File. path = %s", path);
+            return false;
+        }
+
+        if (line.empty())
+            break;
+
+        if (line.compare(0, 7, "FORMAT=") == 0 && line != "FORMAT=32-bit_rle_rgbe")
+        {
+            ELOG("Error : Unsupported Format. %s", line.c_str());
+            return false;
+        }
+    }
+
+    // 解像度文字列.
+    if (!readLine(line))
+    {
+        ELOG("Error : Unexpected End Of File. path = %s", path);
+        return false;
+    }
+
+    auto sigY = line.empty() ? '\0' : line[0];
+    int  h = 0;
+    int  w = 0;
+    if (line.size() < 2 || (sigY != '-' && sigY != '+') || line[1] != 'Y'
+     || sscanf_s(line.c_str() + 2, " %d +X %d", &h, &w) != 2 || w <= 0 || h <= 0)
+    {
+        ELOG("Error : Unsupported Scanline Format. %s", line.c_str());
+        return false;
+    }
+
+    auto width  = uint32_t(w);
+    auto height = uint32_t(h);
+
+    // スキャンラインは前の行に依存するので逐次デコード.
+    std::vector<uint8_t> rgbe(size_t(width) * height * 4);
+    for(auto i=0u; i<height; ++i)
+    {
+        // "-Y" は上から, "+Y" は下から格納されている.
+        auto y = (sigY == '-') ? i : height - 1 - i;
+        if (!DecodeScanlineRGBE(pCur, pEnd, rgbe.data() + size_t(y) * width * 4, width))
+        {
+            ELOG("Error : Scanline Decode Failed. path = %s, line = %u", path, i);
+            return false;
+        }
+    }
+
+    image.Init(width, height, 1, 1, false);
+
+    // 浮動小数への変換は行単位で並列化.
+    ParallelFor(height, threadCount, [&](uint32_t y)
+    {
+        auto pSrc = rgbe.data() + size_t(y) * width * 4;
+        auto pDst = image.GetPixels(0, 0) + size_t(y) * width * 4;
+        for(auto x=0u; x<width; ++x)
+        {
+            auto e = pSrc[x * 4 + 3];
+            auto f = (e != 0) ? ldexpf(1.0f, int32_t(e) - (128 + 8)) : 0.0f;
+            pDst[x * 4 + 0] = float(pSrc[x * 4 + 0]) * f;
+            pDst[x * 4 + 1] = float(pSrc[x * 4 + 1]) * f;
+            pDst[x * 4 + 2] = float(pSrc[x * 4 + 2]) * f;
+            pDst[x * 4 + 3] = 1.0f;
+        }
+    });
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      DDSファイルに保存します.
+//-----------------------------------------------------------------------------
+bool SaveDDS(const char* path, const FloatImage& image, FLOAT_IMAGE_FORMAT format)
+{
+    if (image.Width == 0 || image.Height == 0 || image.ArraySize == 0 || image.MipLevels == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    if (image.IsCube && (image.ArraySize % 6) != 0)
+    {
+        ELOG("Error : Invalid Cube Map Array Size. arraySize = %u", image.ArraySize);
+        return false;
+    }
+
+    auto components = GetComponentCount(format);
+    auto compSize   = GetComponentSize(format);
+
+    DDSHeader header = {};
+    header.Size                 = sizeof(DDSHeader);
+    header.Flags                = kDDSD_CAPS | kDDSD_HEIGHT | kDDSD_WIDTH | kDDSD_PITCH | kDDSD_PIXELFORMAT | kDDSD_MIPMAPCOUNT;
+    header.Height               = image.Height;
+    header.Width                = image.Width;
+    header.PitchOrLinearSize    = image.Width * components * compSize;
+    header.MipMapCount          = image.MipLevels;
+    header.PixelFormat.Size     = sizeof(DDSPixelFormat);
+    header.PixelFormat.Flags    = kDDPF_FOURCC;
+    header.PixelFormat.FourCC   = kFourCC_DX10;
+    header.Caps                 = kDDSCAPS_TEXTURE;
+
+    if (image.MipLevels > 1)
+    { header.Caps |= kDDSCAPS_COMPLEX | kDDSCAPS_MIPMAP; }
+
+    if (image.IsCube)
+    {
+        header.Caps  |= kDDSCAPS_COMPLEX;
+        header.Caps2 |= kDDSCAPS2_CUBEMAP | kDDSCAPS2_CUBEMAP_ALLFACES;
+    }
+
+    DDSHeaderDXT10 ext = {};
+    ext.ResourceDimension   = kResourceDimensionTex2D;
+    ext.MiscFlag            = image.IsCube ? kResourceMiscTextureCube : 0;
+    ext.ArraySize           = image.IsCube ? image.ArraySize / 6 : image.ArraySize;
+
+    switch(format)
+    {
+    case FLOAT_IMAGE_FORMAT_RGBA32: { ext.DXGIFormat = kDXGI_R32G32B32A32_FLOAT; } break;
+    case FLOAT_IMAGE_FORMAT_RGBA16: { ext.DXGIFormat = kDXGI_R16G16B16A16_FLOAT; } break;
+    case FLOAT_IMAGE_FORMAT_RG32:   { ext.DXGIFormat = kDXGI_R32G32_FLOAT; } break;
+    default:
+        {
+            ELOG("Error : Invalid Format. format = %u", format);
+            return false;
+        }
+    }
+
+    FILE* pFile = nullptr;
+    auto err = fopen_s(&pFile, path, "wb");
+    if (err != 0 || pFile == nullptr)
+    {
+        ELOG("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    fwrite(&kDDSMagic, sizeof(kDDSMagic), 1, pFile);
+    fwrite(&header, sizeof(header), 1, pFile);
+    fwrite(&ext, sizeof(ext), 1, pFile);
+
+    std::vector<uint8_t> buffer;
+    for(auto i=0u; i<image.ArraySize; ++i)
+    {
+        for(auto m=0u; m<image.MipLevels; ++m)
+        {
+            auto count = size_t(image.GetMipWidth(m)) * image.GetMipHeight(m);
+            auto pSrc  = image.GetPixels(i, m);
+            buffer.resize(count * components * compSize);
+
+            if (format == FLOAT_IMAGE_FORMAT_RGBA32)
+            { memcpy(buffer.data(), pSrc, buffer.size()); }
+            else if (format == FLOAT_IMAGE_FORMAT_RGBA16)
+            {
+                auto pDst = reinterpret_cast<uint16_t*>(buffer.data());
+                for(size_t j=0; j<count * 4; ++j)
+                { pDst[j] = FloatToHalf(pSrc[j]); }
+            }
+            else
+            {
+                auto pDst = reinterpret_cast<float*>(buffer.data());
+                for(size_t j=0; j<count; ++j)
+                {
+                    pDst[j * 2 + 0] = pSrc[j * 4 + 0];
+                    pDst[j * 2 + 1] = pSrc[j * 4 + 1];
+                }
+            }
+
+            fwrite(buffer.data(), 1, buffer.size(), pFile);
+        }
+    }
+
+    auto failed = (ferror(pFile) != 0);
+    fclose(pFile);
+
+    if (failed)
+    {
+        ELOG("Error : File Write Failed. path = %s", path);
+        return false;
+    }
+
+    return true;
+}
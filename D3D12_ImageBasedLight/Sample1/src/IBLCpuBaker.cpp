@@ -0,0 +1,582 @@
+﻿//-----------------------------------------------------------------------------
+// File : IBLCpuBaker.cpp
+// Desc : Bake IBL on CPU.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <IBLCpuBaker.h>
+#include <ParallelFor.h>
+#include <SimdVec4.h>
+#include <CubeMapUtil.h>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <Logger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr float     kPi                 = 3.14159265358979323f;
+constexpr uint32_t  kSHProjectionSize   = 128;
+
+
+//-----------------------------------------------------------------------------
+//      Hammersley点群をサンプルします.
+//-----------------------------------------------------------------------------
+inline void Hammersley(uint32_t i, uint32_t count, float& u, float& v)
+{
+    // BakeUtil.hlsli と同じく reversebits() の結果を [0, 1) に写像する.
+    auto bits = i;
+    bits = (bits << 16) | (bits >> 16);
+    bits = ((bits & 0x55555555u) << 1) | ((bits & 0xAAAAAAAAu) >> 1);
+    bits = ((bits & 0x33333333u) << 2) | ((bits & 0xCCCCCCCCu) >> 2);
+    bits = ((bits & 0x0F0F0F0Fu) << 4) | ((bits & 0xF0F0F0F0u) >> 4);
+    bits = ((bits & 0x00FF00FFu) << 8) | ((bits & 0xFF00FF00u) >> 8);
+
+    u = float(i) / float(count);
+    v = float(bits) * 2.3283064365386963e-10f;
+}
+
+
+//-----------------------------------------------------------------------------
+//      出力テクセルの方向を求めます.
+//-----------------------------------------------------------------------------
+inline void CalcTexelDirection(uint32_t x, uint32_t y, uint32_t size, uint32_t face, float dir[3])
+{
+    // QuadVS.hlsl のテクスチャ座標は上端が v = 1 になる.
+    auto u = (float(x) + 0.5f) / float(size);
+    auto v = 1.0f - (float(y) + 0.5f) / float(size);
+    CalcCubeDirection(u, v, face, dir);
+}
+
+//-----------------------------------------------------------------------------
+//      正規直交基底を求めます.
+//-----------------------------------------------------------------------------
+inline void TangentSpace(const float N[3], float T[3], float B[3])
+{
+    // Tom Duff, James Burgess, Per Christensen, Christophe Hery, Andrew Kensler, Max Liani, and Ryusuke Villemin
+    // "Building an Orthonormal Bais, Revisited",
+    // Journal of Computer Graphics Techniques Vol.6, No.1, 2017.
+    // Listing 3.参照.
+    auto s = (N[2] >= 0.0f) ? 1.0f : -1.0f;
+    auto a = -1.0f / (s + N[2]);
+    auto b = N[0] * N[1] * a;
+    T[0] = 1.0f + s * N[0] * N[0] * a;
+    T[1] = s * b;
+    T[2] = -s * N[0];
+    B[0] = b;
+    B[1] = s + N[1] * N[1] * a;
+    B[2] = -N[1];
+}
+
+
+//-----------------------------------------------------------------------------
+//      GGXによる法線分布関数です.
+//-----------------------------------------------------------------------------
+inline float D_GGX(float a, float NH)
+{
+    // BRDF.hlsli と同じ式.
+    auto a2  = a * a;
+    auto NH2 = NH * NH;
+    auto f   = (NH2 * ((a2 - 1) * NH + 1));
+    return a2 / (kPi * f * f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SpecularSample structure
+///////////////////////////////////////////////////////////////////////////////
+struct SpecularSample
+{
+    float   L[3];       //!< 法線空間でのライトベクトル(V = N).
+    float   Weight;     //!< NdotL.
+    float   MipLevel;   //!< 入力キューブマップのミップレベル.
+};
+
+//-----------------------------------------------------------------------------
+//      Specular LD 項のサンプル方向を求めます.
+//-----------------------------------------------------------------------------
+float BuildSpecularSamples
+(
+    float                           a,
+    float                           width,
+    float                           mipCount,
+    std::vector<SpecularSample>&    samples
+)
+{
+    samples.clear();
+    samples.reserve(IBL_LD_SAMPLE_COUNT);
+
+    auto omegaP = (4.0f * kPi) / (6.0f * width * width);
+    auto bias   = 1.0f;
+    auto accWeight = 0.0f;
+
+    for(auto i=0u; i<IBL_LD_SAMPLE_COUNT; ++i)
+    {
+        float u0, u1;
+        Hammersley(i, IBL_LD_SAMPLE_COUNT, u0, u1);
+
+        // 法線空間でGGXに基づく重点サンプリング.
+        auto phi      = 2.0f * kPi * u0;
+        auto cosTheta = sqrtf((1.0f - u1) / std::max(u1 * (a * a - 1.0f) + 1.0f, 1e-8f));
+        auto sinTheta = sqrtf(std::max(1.0f - cosTheta * cosTheta, 0.0f));
+
+        float H[3] = { sinTheta * cosf(phi), sinTheta * sinf(phi), cosTheta };
+
+        // V = N = (0, 0, 1) なので L = 2 * H.z * H - N.
+        SpecularSample sample;
+        sample.L[0] = 2.0f * H[2] * H[0];
+        sample.L[1] = 2.0f * H[2] * H[1];
+        sample.L[2] = 2.0f * H[2] * H[2] - 1.0f;
+
+        auto NdotL = std::min(std::max(sample.L[2], 0.0f), 1.0f);
+        if (NdotL <= 0.0f)
+            continue;
+
+        // IntegrateSpecularLD_PS.hlsl と同じ式でミップレベルを選ぶ(GPU版と結果を揃えるため).
+        auto pdf    = D_GGX(NdotL, a) * NdotL;
+        auto omegaS = 1.0f / std::max(float(IBL_LD_SAMPLE_COUNT) * pdf, 1e-8f);
+        auto l      = 0.5f * (log2f(omegaS) - log2f(omegaP)) + bias;
+
+        sample.Weight   = NdotL;
+        sample.MipLevel = std::min(std::max(l, 0.0f), mipCount);
+
+        accWeight += NdotL;
+        samples.push_back(sample);
+    }
+
+    return accWeight;
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップのテクセルが占める立体角を求めます.
+//-----------------------------------------------------------------------------
+inline double CalcTexelSolidAngle(uint32_t x, uint32_t y, uint32_t size)
+{
+    auto areaElement = [](double s, double t)
+    { return atan2(s * t, sqrt(s * s + t * t + 1.0)); };
+
+    auto inv = 2.0 / double(size);
+    auto x0 = double(x) * inv - 1.0;
+    auto y0 = double(y) * inv - 1.0;
+    auto x1 = x0 + inv;
+    auto y1 = y0 + inv;
+
+    return areaElement(x0, y0) - areaElement(x0, y1) - areaElement(x1, y0) + areaElement(x1, y1);
+}
+
+//-----------------------------------------------------------------------------
+//      2次までの球面調和関数の基底を求めます.
+//-----------------------------------------------------------------------------
+inline void EvalSHBasis(const float dir[3], float basis[9])
+{
+    auto x = dir[0];
+    auto y = dir[1];
+    auto z = dir[2];
+
+    basis[0] = 0.282095f;
+    basis[1] = 0.488603f * y;
+    basis[2] = 0.488603f * z;
+    basis[3] = 0.488603f * x;
+    basis[4] = 1.092548f * x * y;
+    basis[5] = 1.092548f * y * z;
+    basis[6] = 0.315392f * (3.0f * z * z - 1.0f);
+    basis[7] = 1.092548f * x * z;
+    basis[8] = 0.546274f * (x * x - y * y);
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップのサイズをチェックします.
+//-----------------------------------------------------------------------------
+bool CheckCubeMap(const FloatImage& cubeMap)
+{
+    if (!cubeMap.IsCube || cubeMap.ArraySize < 6 || cubeMap.Width == 0 || cubeMap.Width != cubeMap.Height)
+    {
+        ELOG("Error : Invalid Cube Map. width = %u, height = %u, arraySize = %u",
+            cubeMap.Width, cubeMap.Height, cubeMap.ArraySize);
+        return false;
+    }
+
+    if (cubeMap.Pixels.size() < cubeMap.GetOffset(6, 0))
+    {
+        ELOG("Error : Cube Map Pixels Not Enough.");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      DFG項を積分します.
+//-----------------------------------------------------------------------------
+bool IntegrateDFG_CPU(uint32_t size, FloatImage& result, uint32_t threadCount)
+{
+    if (size == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    result.Init(size, size, 1, 1, false);
+
+    // ラフネスに依存しない部分は先に求めておく.
+    // IntegrateDFG_PS.hlsl は Hammersley(i, SampleCount) を 1024 回呼ぶので, 横方向は 128 で割る.
+    std::vector<float> cosPhi(IBL_DFG_SAMPLE_COUNT);
+    std::vector<float> hammersleyV(IBL_DFG_SAMPLE_COUNT);
+    for(auto i=0u; i<IBL_DFG_SAMPLE_COUNT; ++i)
+    {
+        float u0, u1;
+        Hammersley(i, IBL_LD_SAMPLE_COUNT, u0, u1);
+        cosPhi[i]      = cosf(2.0f * kPi * u0);
+        hammersleyV[i] = u1;
+    }
+
+    const auto invCount = 1.0f / float(IBL_DFG_SAMPLE_COUNT);
+
+    ParallelFor(size, threadCount, [&](uint32_t y)
+    {
+        auto roughness = 1.0f - (float(y) + 0.5f) / float(size);
+        auto a         = roughness * roughness;
+
+        // 行毎にハーフベクトルを求める. V は XZ 平面上にあるので H.y は使わない.
+        std::vector<float> Hx(IBL_DFG_SAMPLE_COUNT);
+        std::vector<float> Hz(IBL_DFG_SAMPLE_COUNT);
+        for(auto i=0u; i<IBL_DFG_SAMPLE_COUNT; ++i)
+        {
+            auto u1       = hammersleyV[i];
+            auto cosTheta = sqrtf((1.0f - u1) / std::max(u1 * (a * a - 1.0f) + 1.0f, 1e-8f));
+            auto sinTheta = sqrtf(std::max(1.0f - cosTheta * cosTheta, 0.0f));
+            Hx[i] = sinTheta * cosPhi[i];
+            Hz[i] = cosTheta;
+        }
+
+        // IntegrateDFG_PS.hlsl は G2_Smith() に線形ラフネスを渡しているので, それに合わせる.
+        auto a2 = roughness * roughness;
+
+        auto pDst = result.GetPixels(0, 0) + size_t(y) * size * 4;
+        for(auto x=0u; x<size; ++x)
+        {
+            auto NdotV = (float(x) + 0.5f) / float(size);
+            auto Vx    = sqrtf(1.0f - NdotV * NdotV);
+            auto NV2   = NdotV * NdotV;
+
+            auto lambdaL = (-1.0f + sqrtf(a2 * (1.0f - NV2) / std::max(NV2, 1e-8f) + 1.0f)) * 0.5f;
+
+            auto vNdotV    = VecSplat(NdotV);
+            auto vVx       = VecSplat(Vx);
+            auto vA2       = VecSplat(a2);
+            auto vLambdaL  = VecSplat(1.0f + lambdaL);
+            auto vZero     = VecZero();
+            auto vOne      = VecSplat(1.0f);
+            auto vHalf     = VecSplat(0.5f);
+            auto vEpsilon  = VecSplat(1e-8f);
+            auto accX      = VecZero();
+            auto accY      = VecZero();
+
+            // 4サンプルずつまとめて処理し, NdotL <= 0 のサンプルはマスクで除外する.
+            for(auto i=0u; i<IBL_DFG_SAMPLE_COUNT; i+=4)
+            {
+                auto hx = VecLoad(&Hx[i]);
+                auto hz = VecLoad(&Hz[i]);
+
+                auto VdotH = VecAdd(VecMul(vVx, hx), VecMul(vNdotV, hz));
+                auto NdotL = VecSub(VecMul(VecMul(VecSplat(2.0f), VdotH), hz), vNdotV);
+                auto NdotH  = VecMin(VecMax(hz, vZero), vOne);
+                auto VdotHs = VecMin(VecMax(VdotH, vZero), vOne);
+
+                auto NL2 = VecMul(NdotL, NdotL);
+                auto lambdaV = VecMul(VecSub(VecSqrt(VecAdd(VecDiv(VecMul(vA2, VecSub(vOne, NL2)), VecMax(NL2, vEpsilon)), vOne)), vOne), vHalf);
+
+                auto G    = VecDiv(vOne, VecMax(VecAdd(vLambdaL, lambdaV), vEpsilon));
+                auto GVis = VecDiv(VecMul(G, VdotHs), VecMax(VecMul(vNdotV, NdotH), vEpsilon));
+
+                auto t  = VecSub(vOne, VdotHs);
+                auto t2 = VecMul(t, t);
+                auto Fc = VecMul(VecMul(t2, t2), t);
+
+                GVis = VecMaskGreater(NdotL, vZero, GVis);
+                accX = VecAdd(accX, VecMul(VecSub(vOne, Fc), GVis));
+                accY = VecAdd(accY, VecMul(Fc, GVis));
+            }
+
+            pDst[x * 4 + 0] = VecHorizontalAdd(accX) * invCount;
+            pDst[x * 4 + 1] = VecHorizontalAdd(accY) * invCount;
+            pDst[x * 4 + 2] = 0.0f;
+            pDst[x * 4 + 3] = 1.0f;
+        }
+    });
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップを球面調和関数に射影します.
+//-----------------------------------------------------------------------------
+bool ProjectDiffuseSH(const FloatImage& cubeMap, IBLDiffuseSH& sh, uint32_t threadCount)
+{
+    if (!CheckCubeMap(cubeMap))
+    { return false; }
+
+    // 低周波成分しか使わないので小さいミップレベルで十分.
+    auto mip = cubeMap.MipLevels - 1;
+    for(auto m=0u; m<cubeMap.MipLevels; ++m)
+    {
+        if (cubeMap.GetMipWidth(m) <= kSHProjectionSize)
+        {
+            mip = m;
+            break;
+        }
+    }
+
+    auto size = cubeMap.GetMipWidth(mip);
+
+    // 行毎の部分和を最後に順番に足すので, スレッド数によらず同じ結果になる.
+    struct PartialSum
+    {
+        double Coeffs[9][3];
+        double Weight;
+    };
+    std::vector<PartialSum> partials(size_t(6) * size);
+
+    ParallelFor(6 * size, threadCount, [&](uint32_t index)
+    {
+        auto face = index / size;
+        auto y    = index % size;
+        auto pSrc = cubeMap.GetPixels(face, mip) + size_t(y) * size * 4;
+
+        auto& partial = partials[index];
+        memset(&partial, 0, sizeof(partial));
+
+        for(auto x=0u; x<size; ++x)
+        {
+            // テクスチャ座標は上端が v = 1 なので行を反転して方向を求める.
+            float dir[3];
+            CalcTexelDirection(x, y, size, face, dir);
+
+            float basis[9];
+            EvalSHBasis(dir, basis);
+
+            auto w = CalcTexelSolidAngle(x, y, size);
+            for(auto i=0; i<9; ++i)
+            {
+                auto wb = w * basis[i];
+                partial.Coeffs[i][0] += wb * pSrc[x * 4 + 0];
+                partial.Coeffs[i][1] += wb * pSrc[x * 4 + 1];
+                partial.Coeffs[i][2] += wb * pSrc[x * 4 + 2];
+            }
+            partial.Weight += w;
+        }
+    });
+
+    double total[9][3] = {};
+    double weight = 0.0;
+    for(const auto& partial : partials)
+    {
+        for(auto i=0; i<9; ++i)
+        {
+            total[i][0] += partial.Coeffs[i][0];
+            total[i][1] += partial.Coeffs[i][1];
+            total[i][2] += partial.Coeffs[i][2];
+        }
+        weight += partial.Weight;
+    }
+
+    // 立体角の合計が 4π になるように補正.
+    auto scale = (weight > 0.0) ? (4.0 * double(kPi) / weight) : 0.0;
+    for(auto i=0; i<9; ++i)
+    {
+        sh.Coeffs[i][0] = float(total[i][0] * scale);
+        sh.Coeffs[i][1] = float(total[i][1] * scale);
+        sh.Coeffs[i][2] = float(total[i][2] * scale);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      球面調和関数から Diffuse LD 項を求めます.
+//-----------------------------------------------------------------------------
+void EvaluateDiffuseSH(const IBLDiffuseSH& sh, const float dir[3], float result[3])
+{
+    // Ravi Ramamoorthi, Pat Hanrahan, "An Efficient Representation for Irradiance Environment Maps", SIGGRAPH 2001.
+    // 放射照度の畳み込み係数 (π, 2π/3, π/4) を π で割ったもの.
+    static const float kBandScale[9] = {
+        1.0f,
+        2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f,
+        0.25f, 0.25f, 0.25f, 0.25f, 0.25f
+    };
+
+    float basis[9];
+    EvalSHBasis(dir, basis);
+
+    result[0] = result[1] = result[2] = 0.0f;
+    for(auto i=0; i<9; ++i)
+    {
+        auto w = kBandScale[i] * basis[i];
+        result[0] += w * sh.Coeffs[i][0];
+        result[1] += w * sh.Coeffs[i][1];
+        result[2] += w * sh.Coeffs[i][2];
+    }
+
+    // 2次で打ち切ると負になることがあるのでクランプ.
+    result[0] = std::max(result[0], 0.0f);
+    result[1] = std::max(result[1], 0.0f);
+    result[2] = std::max(result[2], 0.0f);
+}
+
+//-----------------------------------------------------------------------------
+//      球面調和関数から Diffuse LD 項のキューブマップを生成します.
+//-----------------------------------------------------------------------------
+bool IntegrateDiffuseLD_CPU(const IBLDiffuseSH& sh, uint32_t size, FloatImage& result, uint32_t threadCount)
+{
+    if (size == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    result.Init(size, size, 6, 1, true);
+
+    ParallelFor(6 * size, threadCount, [&](uint32_t index)
+    {
+        auto face = index / size;
+        auto y    = index % size;
+        auto pDst = result.GetPixels(face, 0) + size_t(y) * size * 4;
+
+        for(auto x=0u; x<size; ++x)
+        {
+            float dir[3];
+            CalcTexelDirection(x, y, size, face, dir);
+            EvaluateDiffuseSH(sh, dir, &pDst[x * 4]);
+            pDst[x * 4 + 3] = 1.0f;
+        }
+    });
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      Specular LD 項を積分します.
+//-----------------------------------------------------------------------------
+bool IntegrateSpecularLD_CPU
+(
+    const FloatImage&   cubeMap,
+    uint32_t            size,
+    uint32_t            mipCount,
+    FloatImage&         result,
+    uint32_t            threadCount
+)
+{
+    if (!CheckCubeMap(cubeMap))
+    { return false; }
+
+    if (size == 0 || mipCount == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    // ミップマップフィルタ重点サンプリングにはミップチェインが必要.
+    const FloatImage* pSrc = &cubeMap;
+    FloatImage mipmapped;
+    if (cubeMap.MipLevels < CalcMipLevels(cubeMap.Width, cubeMap.Height))
+    {
+        mipmapped.Init(cubeMap.Width, cubeMap.Height, 6, 1, true);
+        for(auto f=0u; f<6; ++f)
+        {
+            auto count = size_t(cubeMap.Width) * cubeMap.Height * 4;
+            std::copy_n(cubeMap.GetPixels(f, 0), count, mipmapped.GetPixels(f, 0));
+        }
+
+        if (!GenerateMipmaps(mipmapped, 0, threadCount))
+        {
+            ELOG("Error : GenerateMipmaps() Failed.");
+            return false;
+        }
+
+        pSrc = &mipmapped;
+    }
+
+    CubeView view;
+    MakeCubeView(*pSrc, view);
+
+    mipCount = std::min(mipCount, CalcMipLevels(size, size));
+    result.Init(size, size, 6, mipCount, true);
+
+    const auto roughnessStep = (mipCount > 1) ? 1.0f / float(mipCount - 1) : 0.0f;
+
+    std::vector<SpecularSample> samples;
+    for(auto m=0u; m<mipCount; ++m)
+    {
+        auto roughness = roughnessStep * float(m);
+        auto a         = roughness * roughness;
+        auto mipSize   = result.GetMipWidth(m);
+
+        // サンプル方向は法線に依らないので, ミップ毎に1度だけ求める.
+        auto accWeight = 0.0f;
+        if (a > 0.0f)
+        { accWeight = BuildSpecularSamples(a, float(pSrc->Width), float(view.MipLevels - 1), samples); }
+
+        auto invWeight = (accWeight > 0.0f) ? 1.0f / accWeight : 0.0f;
+
+        ParallelFor(6 * mipSize, threadCount, [&](uint32_t index)
+        {
+            auto face = index / mipSize;
+            auto y    = index % mipSize;
+            auto pDst = result.GetPixels(face, m) + size_t(y) * mipSize * 4;
+
+            for(auto x=0u; x<mipSize; ++x)
+            {
+                float N[3];
+                CalcTexelDirection(x, y, mipSize, face, N);
+
+                // ラフネス0は鏡面反射なのでそのままフェッチする.
+                if (a == 0.0f)
+                {
+                    VecStore(&pDst[x * 4], SampleCube(view, N, 0.0f));
+                    pDst[x * 4 + 3] = 1.0f;
+                    continue;
+                }
+
+                float T[3], B[3];
+                TangentSpace(N, T, B);
+
+                auto acc = VecZero();
+                for(const auto& sample : samples)
+                {
+                    float L[3] = {
+                        T[0] * sample.L[0] + B[0] * sample.L[1] + N[0] * sample.L[2],
+                        T[1] * sample.L[0] + B[1] * sample.L[1] + N[1] * sample.L[2],
+                        T[2] * sample.L[0] + B[2] * sample.L[1] + N[2] * sample.L[2],
+                    };
+
+                    auto color = SampleCube(view, L, sample.MipLevel);
+                    acc = VecAdd(acc, VecMul(color, VecSplat(sample.Weight)));
+                }
+
+                VecStore(&pDst[x * 4], VecMul(acc, VecSplat(invWeight)));
+                pDst[x * 4 + 3] = 1.0f;
+            }
+        });
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップを方向ベクトルで三線形補間サンプリングします.
+//-----------------------------------------------------------------------------
+void SampleCubeLevel(const FloatImage& cubeMap, const float dir[3], float mipLevel, float result[4])
+{
+    CubeView view;
+    MakeCubeView(cubeMap, view);
+    VecStore(result, SampleCube(view, dir, mipLevel));
+}
@@ -0,0 +1,384 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchEnvMap.cpp
+// Desc : Environment Map Converter Benchmarks.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <FloatImage.h>
+#include <EnvMapConverter.h>
+#include <Logger.h>
+#include <Compat.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const float kPi = 3.14159265358979f;
+
+///////////////////////////////////////////////////////////////////////////////
+// BenchContext structure
+///////////////////////////////////////////////////////////////////////////////
+struct BenchContext
+{
+    uint32_t    Samples = 5;        //!< サンプル数.
+    bool        Quick   = false;    //!< 短縮実行.
+    int         Result  = 0;        //!< 終了コード.
+};
+
+//-----------------------------------------------------------------------------
+//      処理時間の中央値をミリ秒で計測します.
+//-----------------------------------------------------------------------------
+double MeasureMs(uint32_t samples, const std::function<bool()>& func)
+{
+    // 1回目はページを温めるだけ.
+    if (!func())
+    { return -1.0; }
+
+    std::vector<double> times(samples);
+    for(auto& time : times)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+//-----------------------------------------------------------------------------
+//      計測結果を表示します.
+//-----------------------------------------------------------------------------
+void Report(BenchContext& context, const char* name, double texels, const std::function<bool()>& func)
+{
+    auto ms = MeasureMs(context.Samples, func);
+    if (ms < 0.0)
+    {
+        ELOG("Error : %s Failed.", name);
+        context.Result = 1;
+        return;
+    }
+
+    printf("%-44s %10.3f ms %10.2f Mtexels/s\n", name, ms, texels / (ms * 1000.0));
+    fflush(stdout);
+}
+
+//-----------------------------------------------------------------------------
+//      検証に失敗したら終了コードを設定します.
+//-----------------------------------------------------------------------------
+void Check(BenchContext& context, bool condition, const char* message)
+{
+    if (condition)
+    { return; }
+
+    ELOG("Error : %s", message);
+    context.Result = 1;
+}
+
+//-----------------------------------------------------------------------------
+//      方向から空の輝度を求めます.
+//-----------------------------------------------------------------------------
+void EvaluateSky(const float dir[3], float result[3])
+{
+    // 地平線のグラデーションと太陽の滑らかなローブ.
+    auto horizon = 1.0f - fabsf(dir[1]);
+    auto sun     = std::max(0.0f, dir[0] * 0.5f + dir[1] * 0.6f + dir[2] * 0.62f);
+    sun = powf(sun, 16.0f) * 20.0f;
+
+    result[0] = 0.2f + 0.8f * horizon + sun;
+    result[1] = 0.3f + 0.6f * horizon + sun * 0.9f;
+    result[2] = 0.8f + 0.2f * horizon + sun * 0.7f;
+}
+
+//-----------------------------------------------------------------------------
+//      正距円筒図法の空画像を生成します.
+//-----------------------------------------------------------------------------
+void CreateEquirect(uint32_t width, uint32_t height, FloatImage& image)
+{
+    image.Init(width, height, 1, 1, false);
+
+    auto pixels = image.GetPixels(0, 0);
+    for(auto y=0u; y<height; ++y)
+    {
+        auto theta = (float(y) + 0.5f) / float(height) * kPi;
+        for(auto x=0u; x<width; ++x)
+        {
+            auto phi = (float(x) + 0.5f) / float(width) * 2.0f * kPi;
+            float dir[3] = {
+                sinf(theta) * cosf(phi),
+                cosf(theta),
+                sinf(theta) * sinf(phi)
+            };
+
+            auto dst = pixels + (size_t(y) * width + x) * 4;
+            EvaluateSky(dir, dst);
+            dst[3] = 1.0f;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      RGBE に変換します.
+//-----------------------------------------------------------------------------
+void EncodeRGBE(const float* rgb, uint8_t rgbe[4])
+{
+    auto v = std::max(rgb[0], std::max(rgb[1], rgb[2]));
+    if (v < 1e-32f)
+    {
+        rgbe[0] = rgbe[1] = rgbe[2] = rgbe[3] = 0;
+        return;
+    }
+
+    int e = 0;
+    auto scale = frexpf(v, &e) * 256.0f / v;
+    rgbe[0] = uint8_t(rgb[0] * scale);
+    rgbe[1] = uint8_t(rgb[1] * scale);
+    rgbe[2] = uint8_t(rgb[2] * scale);
+    rgbe[3] = uint8_t(e + 128);
+}
+
+//-----------------------------------------------------------------------------
+//      1チャンネル分のスキャンラインをランレングス圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeRun(const uint8_t* data, uint32_t count, std::vector<uint8_t>& output)
+{
+    uint32_t i = 0;
+    while(i < count)
+    {
+        // 4個以上続く値は連長で書き出す.
+        auto run = 1u;
+        while(i + run < count && run < 127 && data[i + run] == data[i])
+        { run++; }
+
+        if (run >= 4)
+        {
+            output.push_back(uint8_t(128 + run));
+            output.push_back(data[i]);
+            i += run;
+            continue;
+        }
+
+        // 次の連長の手前までをそのまま書き出す.
+        auto start = i;
+        auto literal = 0u;
+        while(i < count && literal < 128)
+        {
+            if (i + 3 < count && data[i] == data[i + 1] && data[i] == data[i + 2] && data[i] == data[i + 3])
+            { break; }
+            i++;
+            literal++;
+        }
+
+        output.push_back(uint8_t(literal));
+        output.insert(output.end(), data + start, data + start + literal);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      新形式のランレングス圧縮で Radiance HDR ファイルを書き出します.
+//-----------------------------------------------------------------------------
+bool WriteHDR(const char* path, const FloatImage& image)
+{
+    FILE* pFile = nullptr;
+    if (fopen_s(&pFile, path, "wb") != 0)
+    {
+        ELOG("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    fprintf(pFile, "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y %u +X %u\n", image.Height, image.Width);
+
+    auto pixels = image.GetPixels(0, 0);
+    std::vector<uint8_t> channels(size_t(image.Width) * 4);
+    std::vector<uint8_t> line;
+    for(auto y=0u; y<image.Height; ++y)
+    {
+        for(auto x=0u; x<image.Width; ++x)
+        {
+            uint8_t rgbe[4];
+            EncodeRGBE(pixels + (size_t(y) * image.Width + x) * 4, rgbe);
+            for(auto c=0; c<4; ++c)
+            { channels[c * image.Width + x] = rgbe[c]; }
+        }
+
+        line.clear();
+        line.push_back(2);
+        line.push_back(2);
+        line.push_back(uint8_t(image.Width >> 8));
+        line.push_back(uint8_t(image.Width & 0xff));
+        for(auto c=0; c<4; ++c)
+        { EncodeRun(&channels[c * image.Width], image.Width, line); }
+
+        fwrite(line.data(), 1, line.size(), pFile);
+    }
+
+    fclose(pFile);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      2つの画像の相対RMS誤差を求めます.
+//-----------------------------------------------------------------------------
+double CalcRelativeRms(const FloatImage& lhs, const FloatImage& rhs)
+{
+    if (lhs.Width != rhs.Width || lhs.Height != rhs.Height)
+    { return 1.0; }
+
+    auto a = lhs.GetPixels(0, 0);
+    auto b = rhs.GetPixels(0, 0);
+
+    double error = 0.0;
+    double power = 0.0;
+    for(size_t i=0; i<size_t(lhs.Width) * lhs.Height * 4; ++i)
+    {
+        if ((i & 3) == 3)
+        { continue; }
+
+        auto d = double(a[i]) - double(b[i]);
+        error += d * d;
+        power += double(b[i]) * double(b[i]);
+    }
+
+    return (power > 0.0) ? sqrt(error / power) : 0.0;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    BenchContext context;
+    for(auto i=1; i<argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+        { context.Quick = true; context.Samples = 1; }
+        else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+        { context.Samples = std::max(1, atoi(argv[++i])); }
+        else
+        {
+            printf("Usage : %s [--quick] [--samples <count>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // 計測値よりも走り切ることを優先する短縮実行では小さな画像を使う.
+    const uint32_t width  = context.Quick ? 256 : 4096;
+    const uint32_t height = width / 2;
+
+    FloatImage equirect;
+    CreateEquirect(width, height, equirect);
+
+    printf("input : %u x %u (equirect)\n", width, height);
+
+    // RGBE の読み込み.
+    {
+        const char* kPath = "bench_envmap.hdr";
+        Check(context, WriteHDR(kPath, equirect), "WriteHDR() Failed.");
+
+        FloatImage loaded;
+        auto texels = double(width) * height;
+        Report(context, "LoadHDR(Threads=1)", texels, [&]() { return LoadHDR(kPath, loaded, 1); });
+        Report(context, "LoadHDR(Threads=All)", texels, [&]() { return LoadHDR(kPath, loaded, 0); });
+
+        // RGBE の仮数は8ビットなので, 1/128 程度の誤差に収まる.
+        Check(context, CalcRelativeRms(loaded, equirect) < 1.0 / 128.0, "LoadHDR() Result Mismatch.");
+        remove(kPath);
+    }
+
+    // レイアウト変換.
+    struct Case
+    {
+        const char*     Name;
+        ENVMAP_LAYOUT   Src;
+        ENVMAP_LAYOUT   Dst;
+        ENVMAP_FILTER   Filter;
+        uint32_t        ThreadCount;
+    };
+    const Case kCases[] = {
+        { "Equirect->Cube(Bilinear,Threads=1)",     ENVMAP_LAYOUT_EQUIRECT, ENVMAP_LAYOUT_CUBE,   ENVMAP_FILTER_BILINEAR, 1 },
+        { "Equirect->Cube(Bilinear,Threads=All)",   ENVMAP_LAYOUT_EQUIRECT, ENVMAP_LAYOUT_CUBE,   ENVMAP_FILTER_BILINEAR, 0 },
+        { "Equirect->Cube(Bicubic,Threads=All)",    ENVMAP_LAYOUT_EQUIRECT, ENVMAP_LAYOUT_CUBE,   ENVMAP_FILTER_BICUBIC,  0 },
+        { "Equirect->Sphere(Bilinear,Threads=All)", ENVMAP_LAYOUT_EQUIRECT, ENVMAP_LAYOUT_SPHERE, ENVMAP_FILTER_BILINEAR, 0 },
+    };
+
+    FloatImage cube;
+    for(const auto& item : kCases)
+    {
+        EnvMapConvertDesc desc;
+        desc.SrcLayout   = item.Src;
+        desc.DstLayout   = item.Dst;
+        desc.Filter      = item.Filter;
+        desc.ThreadCount = item.ThreadCount;
+
+        // 出力サイズを求めるために一度変換しておく.
+        FloatImage dst;
+        if (!ConvertEnvMap(equirect, desc, dst))
+        {
+            Check(context, false, "ConvertEnvMap() Failed.");
+            continue;
+        }
+
+        auto texels = double(dst.Width) * dst.Height * dst.ArraySize;
+
+        Report(context, item.Name, texels, [&]() { return ConvertEnvMap(equirect, desc, dst); });
+
+        if (item.Dst == ENVMAP_LAYOUT_CUBE && item.Filter == ENVMAP_FILTER_BILINEAR)
+        {
+            // スレッド数に依らず同じ結果になる.
+            if (!cube.Pixels.empty())
+            { Check(context, cube.Pixels == dst.Pixels, "ConvertEnvMap() Result Depends On Thread Count."); }
+            cube = dst;
+        }
+    }
+
+    // キューブマップから戻して, 元の画像と比べる.
+    {
+        EnvMapConvertDesc desc;
+        desc.SrcLayout = ENVMAP_LAYOUT_CUBE;
+        desc.DstLayout = ENVMAP_LAYOUT_EQUIRECT;
+        desc.Width     = width;
+        desc.Height    = height;
+
+        FloatImage dst;
+        Report(context, "Cube->Equirect(Bilinear,Threads=All)", double(width) * height,
+            [&]() { return ConvertEnvMap(cube, desc, dst); });
+
+        auto error = CalcRelativeRms(dst, equirect);
+        printf("    round trip relative rms : %.3e\n", error);
+        Check(context, error < 1e-2, "Round Trip Error Too Large.");
+    }
+
+    // ミップマップ生成.
+    {
+        auto texels = double(cube.Width) * cube.Height * cube.ArraySize;
+
+        FloatImage image;
+        Report(context, "Mipmap(Box,Threads=All)", texels, [&]()
+        {
+            image = cube;
+            return GenerateMipmaps(image, 0, 0, MIPMAP_FILTER_BOX);
+        });
+        Report(context, "Mipmap(Kaiser,Threads=All)", texels, [&]()
+        {
+            image = cube;
+            return GenerateMipmaps(image, 0, 0, MIPMAP_FILTER_KAISER);
+        });
+    }
+
+    return context.Result;
+}
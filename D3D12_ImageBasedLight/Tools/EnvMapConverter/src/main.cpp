@@ -0,0 +1,196 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Environment Map Converter Main Entry Point.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <FloatImage.h>
+#include <EnvMapConverter.h>
+#include <Logger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      使い方を表示します.
+//-----------------------------------------------------------------------------
+void PrintUsage()
+{
+    printf("Usage : EnvMapConverter [options] <input (.hdr/.dds)> <output (.dds)>\n");
+    printf("  -from <layout>    input layout  : equirect, sphere, cube (default: equirect, cube for cube map .dds)\n");
+    printf("  -to <layout>      output layout : equirect, sphere, cube (default: cube)\n");
+    printf("  -size <N>         output width (default: derived from input)\n");
+    printf("  -filter <name>    sampling filter : bilinear, bicubic (default: bilinear)\n");
+    printf("  -mip <N>          output mip levels (default: 1, 0: full chain)\n");
+    printf("  -mipfilter <name> mipmap filter : box, kaiser (default: box)\n");
+    printf("  -ss <N>           super samples per axis (default: 0 = auto, max 4)\n");
+    printf("  -f16              save as R16G16B16A16_FLOAT\n");
+    printf("  -j <N>            worker threads (default: hardware concurrency)\n");
+}
+
+//-----------------------------------------------------------------------------
+//      経過時間をミリ秒で取得します.
+//-----------------------------------------------------------------------------
+double GetElapsedMs(const std::chrono::steady_clock::time_point& start)
+{ return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); }
+
+//-----------------------------------------------------------------------------
+//      レイアウト名を解析します.
+//-----------------------------------------------------------------------------
+bool ParseLayout(const char* name, ENVMAP_LAYOUT& layout)
+{
+    if (strcmp(name, "equirect") == 0)
+    { layout = ENVMAP_LAYOUT_EQUIRECT; return true; }
+    if (strcmp(name, "sphere") == 0)
+    { layout = ENVMAP_LAYOUT_SPHERE; return true; }
+    if (strcmp(name, "cube") == 0)
+    { layout = ENVMAP_LAYOUT_CUBE; return true; }
+    return false;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    EnvMapConvertDesc desc;
+    auto format     = FLOAT_IMAGE_FORMAT_RGBA32;
+    auto hasFrom    = false;
+
+    std::vector<const char*> args;
+    for(auto i=1; i<argc; ++i)
+    {
+        auto valid = true;
+        if (strcmp(argv[i], "-from") == 0 && i + 1 < argc)
+        { valid = ParseLayout(argv[++i], desc.SrcLayout); hasFrom = true; }
+        else if (strcmp(argv[i], "-to") == 0 && i + 1 < argc)
+        { valid = ParseLayout(argv[++i], desc.DstLayout); }
+        else if (strcmp(argv[i], "-size") == 0 && i + 1 < argc)
+        { desc.Width = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (strcmp(argv[i], "-filter") == 0 && i + 1 < argc)
+        {
+            ++i;
+            if (strcmp(argv[i], "bilinear") == 0)
+            { desc.Filter = ENVMAP_FILTER_BILINEAR; }
+            else if (strcmp(argv[i], "bicubic") == 0)
+            { desc.Filter = ENVMAP_FILTER_BICUBIC; }
+            else
+            { valid = false; }
+        }
+        else if (strcmp(argv[i], "-mip") == 0 && i + 1 < argc)
+        { desc.MipLevels = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (strcmp(argv[i], "-mipfilter") == 0 && i + 1 < argc)
+        {
+            ++i;
+            if (strcmp(argv[i], "box") == 0)
+            { desc.MipFilter = MIPMAP_FILTER_BOX; }
+            else if (strcmp(argv[i], "kaiser") == 0)
+            { desc.MipFilter = MIPMAP_FILTER_KAISER; }
+            else
+            { valid = false; }
+        }
+        else if (strcmp(argv[i], "-ss") == 0 && i + 1 < argc)
+        { desc.SuperSample = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (strcmp(argv[i], "-f16") == 0)
+        { format = FLOAT_IMAGE_FORMAT_RGBA16; }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        { desc.ThreadCount = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (argv[i][0] == '-')
+        { valid = false; }
+        else
+        { args.push_back(argv[i]); }
+
+        if (!valid)
+        {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    if (args.size() != 2)
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    FloatImage src;
+    auto ext = std::filesystem::path(args[0]).extension().string();
+    if (ext == ".hdr" || ext == ".HDR")
+    {
+        if (!LoadHDR(args[0], src, desc.ThreadCount))
+        {
+            ELOG("Error : LoadHDR() Failed. path = %s", args[0]);
+            return -1;
+        }
+    }
+    else if (!LoadDDS(args[0], src))
+    {
+        ELOG("Error : LoadDDS() Failed. path = %s", args[0]);
+        return -1;
+    }
+
+    if (!hasFrom && src.IsCube)
+    { desc.SrcLayout = ENVMAP_LAYOUT_CUBE; }
+
+    auto loadTime = GetElapsedMs(start);
+
+    // ミップマップは後で計測する.
+    auto mipLevels = desc.MipLevels;
+    desc.MipLevels = 1;
+
+    start = std::chrono::steady_clock::now();
+
+    FloatImage dst;
+    if (!ConvertEnvMap(src, desc, dst))
+    {
+        ELOG("Error : ConvertEnvMap() Failed.");
+        return -1;
+    }
+
+    auto convertTime = GetElapsedMs(start);
+
+    auto mipTime = 0.0;
+    if (mipLevels != 1)
+    {
+        start = std::chrono::steady_clock::now();
+
+        if (!GenerateMipmaps(dst, mipLevels, desc.ThreadCount, desc.MipFilter))
+        {
+            ELOG("Error : GenerateMipmaps() Failed.");
+            return -1;
+        }
+
+        mipTime = GetElapsedMs(start);
+    }
+
+    if (!SaveDDS(args[1], dst, format))
+    {
+        ELOG("Error : SaveDDS() Failed. path = %s", args[1]);
+        return -1;
+    }
+
+    auto texels = double(dst.Width) * dst.Height * dst.ArraySize;
+
+    printf("input    : %u x %u x %u\n", src.Width, src.Height, src.ArraySize);
+    printf("output   : %u x %u x %u (mip %u)\n", dst.Width, dst.Height, dst.ArraySize, dst.MipLevels);
+    printf("load     : %.2f ms\n", loadTime);
+    printf("convert  : %.2f ms (%.2f Mtexels/s)\n", convertTime, texels / (convertTime * 1000.0));
+    printf("mipmap   : %.2f ms\n", mipTime);
+
+    return 0;
+}
@@ -0,0 +1,213 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : IBL CPU Baker Main Entry Point.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <FloatImage.h>
+#include <IBLCpuBaker.h>
+#include <Logger.h>
+#include <Compat.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      使い方を表示します.
+//-----------------------------------------------------------------------------
+void PrintUsage()
+{
+    printf("Usage : IBLCpuBaker [options] <input cube map (.dds)> <output dir>\n");
+    printf("  -size <N>     LD cube map size (default: %u)\n", IBL_LD_TEXTURE_SIZE);
+    printf("  -mip <N>      specular LD mip count (default: %u)\n", IBL_LD_MIP_COUNT);
+    printf("  -dfg <N>      DFG texture size (default: %u, 0: skip)\n", IBL_DFG_TEXTURE_SIZE);
+    printf("  -f16          save LD cube maps as R16G16B16A16_FLOAT\n");
+    printf("  -j <N>        worker threads (default: hardware concurrency)\n");
+}
+
+//-----------------------------------------------------------------------------
+//      経過時間をミリ秒で取得します.
+//-----------------------------------------------------------------------------
+double GetElapsedMs(const std::chrono::steady_clock::time_point& start)
+{ return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); }
+
+//-----------------------------------------------------------------------------
+//      球面調和関数の係数をテキストで保存します.
+//-----------------------------------------------------------------------------
+bool SaveSH(const char* path, const IBLDiffuseSH& sh)
+{
+    FILE* pFile = nullptr;
+    auto err = fopen_s(&pFile, path, "w");
+    if (err != 0 || pFile == nullptr)
+    {
+        ELOG("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    for(auto i=0; i<9; ++i)
+    { fprintf(pFile, "%.9g %.9g %.9g\n", sh.Coeffs[i][0], sh.Coeffs[i][1], sh.Coeffs[i][2]); }
+
+    fclose(pFile);
+    return true;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    auto ldSize      = IBL_LD_TEXTURE_SIZE;
+    auto mipCount    = IBL_LD_MIP_COUNT;
+    auto dfgSize     = IBL_DFG_TEXTURE_SIZE;
+    auto format      = FLOAT_IMAGE_FORMAT_RGBA32;
+    auto threadCount = 0u;
+
+    std::vector<const char*> args;
+    for(auto i=1; i<argc; ++i)
+    {
+        if (strcmp(argv[i], "-size") == 0 && i + 1 < argc)
+        { ldSize = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (strcmp(argv[i], "-mip") == 0 && i + 1 < argc)
+        { mipCount = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (strcmp(argv[i], "-dfg") == 0 && i + 1 < argc)
+        { dfgSize = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (strcmp(argv[i], "-f16") == 0)
+        { format = FLOAT_IMAGE_FORMAT_RGBA16; }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        { threadCount = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (argv[i][0] == '-')
+        {
+            PrintUsage();
+            return -1;
+        }
+        else
+        { args.push_back(argv[i]); }
+    }
+
+    if (args.size() != 2 || ldSize == 0 || mipCount == 0)
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    std::error_code err;
+    std::filesystem::create_directories(args[1], err);
+    if (err)
+    {
+        ELOG("Error : Directory Create Failed. path = %s", args[1]);
+        return -1;
+    }
+
+    auto outputPath = [&](const char* name)
+    { return (std::filesystem::path(args[1]) / name).string(); };
+
+    auto start = std::chrono::steady_clock::now();
+
+    FloatImage cubeMap;
+    if (!LoadDDS(args[0], cubeMap))
+    {
+        ELOG("Error : LoadDDS() Failed. path = %s", args[0]);
+        return -1;
+    }
+
+    if (!cubeMap.IsCube)
+    {
+        ELOG("Error : Input Is Not Cube Map. path = %s", args[0]);
+        return -1;
+    }
+
+    // ミップマップフィルタ重点サンプリング用にミップチェインを揃えておく.
+    if (cubeMap.MipLevels < CalcMipLevels(cubeMap.Width, cubeMap.Height))
+    {
+        if (!GenerateMipmaps(cubeMap, 0, threadCount))
+        {
+            ELOG("Error : GenerateMipmaps() Failed.");
+            return -1;
+        }
+    }
+
+    auto loadTime = GetElapsedMs(start);
+
+    // DFG項.
+    auto dfgTime = 0.0;
+    if (dfgSize > 0)
+    {
+        start = std::chrono::steady_clock::now();
+
+        FloatImage dfg;
+        if (!IntegrateDFG_CPU(dfgSize, dfg, threadCount))
+        {
+            ELOG("Error : IntegrateDFG_CPU() Failed.");
+            return -1;
+        }
+
+        dfgTime = GetElapsedMs(start);
+
+        if (!SaveDDS(outputPath("DFG.dds").c_str(), dfg, FLOAT_IMAGE_FORMAT_RG32))
+        {
+            ELOG("Error : SaveDDS() Failed.");
+            return -1;
+        }
+    }
+
+    // Diffuse LD項.
+    start = std::chrono::steady_clock::now();
+
+    IBLDiffuseSH sh = {};
+    FloatImage   diffuseLD;
+    if (!ProjectDiffuseSH(cubeMap, sh, threadCount)
+     || !IntegrateDiffuseLD_CPU(sh, ldSize, diffuseLD, threadCount))
+    {
+        ELOG("Error : Diffuse LD Integration Failed.");
+        return -1;
+    }
+
+    auto diffuseTime = GetElapsedMs(start);
+
+    if (!SaveDDS(outputPath("DiffuseLD.dds").c_str(), diffuseLD, format)
+     || !SaveSH(outputPath("DiffuseSH.txt").c_str(), sh))
+    {
+        ELOG("Error : Diffuse LD Save Failed.");
+        return -1;
+    }
+
+    // Specular LD項.
+    start = std::chrono::steady_clock::now();
+
+    FloatImage specularLD;
+    if (!IntegrateSpecularLD_CPU(cubeMap, ldSize, mipCount, specularLD, threadCount))
+    {
+        ELOG("Error : IntegrateSpecularLD_CPU() Failed.");
+        return -1;
+    }
+
+    auto specularTime = GetElapsedMs(start);
+
+    if (!SaveDDS(outputPath("SpecularLD.dds").c_str(), specularLD, format))
+    {
+        ELOG("Error : SaveDDS() Failed.");
+        return -1;
+    }
+
+    printf("input    : %u x %u x 6 (mip %u)\n", cubeMap.Width, cubeMap.Height, cubeMap.MipLevels);
+    printf("load     : %.2f ms\n", loadTime);
+    printf("dfg      : %.2f ms\n", dfgTime);
+    printf("diffuse  : %.2f ms\n", diffuseTime);
+    printf("specular : %.2f ms (%u x %u, mip %u)\n", specularTime, ldSize, ldSize, specularLD.MipLevels);
+    printf("output   : %s\n", args[1]);
+
+    return 0;
+}
@@ -0,0 +1,296 @@
+﻿//-----------------------------------------------------------------------------
+// File : IBLReference.cpp
+// Desc : Scalar Reference Port Of IBL Bake Shaders.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <algorithm>
+#include <IBLCpuBaker.h>
+#include "IBLReference.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const float     F_PI        = 3.1415926535897932384626433832795f;
+const uint32_t  SampleCount = 128;      // BakeUtil.hlsli と同じ.
+
+///////////////////////////////////////////////////////////////////////////////
+// float3 structure
+///////////////////////////////////////////////////////////////////////////////
+struct float3
+{
+    float x, y, z;
+};
+
+inline float3 operator + (const float3& a, const float3& b)
+{ return float3{ a.x + b.x, a.y + b.y, a.z + b.z }; }
+
+inline float3 operator - (const float3& a, const float3& b)
+{ return float3{ a.x - b.x, a.y - b.y, a.z - b.z }; }
+
+inline float3 operator * (const float3& a, float s)
+{ return float3{ a.x * s, a.y * s, a.z * s }; }
+
+inline float3 operator * (float s, const float3& a)
+{ return a * s; }
+
+inline float dot(const float3& a, const float3& b)
+{ return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+inline float3 normalize(const float3& a)
+{ return a * (1.0f / sqrtf(dot(a, a))); }
+
+inline float saturate(float x)
+{ return std::min(std::max(x, 0.0f), 1.0f); }
+
+//-----------------------------------------------------------------------------
+//      reversebits() 相当です.
+//-----------------------------------------------------------------------------
+uint32_t reversebits(uint32_t value)
+{
+    uint32_t result = 0;
+    for(auto i=0; i<32; ++i)
+    {
+        result = (result << 1) | (value & 1u);
+        value >>= 1;
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      Hammersley点群をサンプルします.
+//-----------------------------------------------------------------------------
+void Hammersley(uint32_t i, uint32_t N, float& u, float& v)
+{
+    u = float(i) / float(N);
+    v = float(reversebits(i)) * 2.3283064365386963e-10f;
+}
+
+//-----------------------------------------------------------------------------
+//      正規直交基底を求めます.
+//-----------------------------------------------------------------------------
+void TangentSpace(const float3& N, float3& T, float3& B)
+{
+    float s = (N.z >= 0.0f) ? 1.0f : -1.0f;
+    float a = -1.0f / (s + N.z);
+    float b = N.x * N.y * a;
+    T = float3{ 1.0f + s * N.x * N.x * a, s * b, -s * N.x };
+    B = float3{ b, s + N.y * N.y * a, -N.y };
+}
+
+//-----------------------------------------------------------------------------
+//      GGX BRDFの形状にもとづくサンプリングを行います.
+//-----------------------------------------------------------------------------
+float3 SampleGGX(float u0, float u1, float a, const float3& N)
+{
+    float phi = 2.0f * F_PI * u0;
+    float cosTheta = sqrtf( (1.0f - u1) / std::max(u1 * (a * a - 1.0f) + 1.0f, 1e-8f) );
+    float sinTheta = sqrtf( 1.0f - cosTheta * cosTheta );
+
+    float3 H;
+    H.x = sinTheta * cosf( phi );
+    H.y = sinTheta * sinf( phi );
+    H.z = cosTheta;
+
+    float3 T, B;
+    TangentSpace(N, T, B);
+
+    return normalize(T * H.x + B * H.y + N * H.z);
+}
+
+//-----------------------------------------------------------------------------
+//      GGXによる法線分布関数です(BRDF.hlsli).
+//-----------------------------------------------------------------------------
+float D_GGX(float a, float NH)
+{
+    float a2 = a * a;
+    float NH2 = NH * NH;
+    float f = (NH2 * ((a2 - 1) * NH + 1));
+    return a2 / (F_PI * f * f);
+}
+
+//-----------------------------------------------------------------------------
+//      Height Correlated Smithによる幾何減衰項です(BRDF.hlsli).
+//-----------------------------------------------------------------------------
+float G2_Smith(float NL, float NV, float a)
+{
+    float a2 = a * a;
+
+    float NL2 = NL * NL;
+    float NV2 = NV * NV;
+
+    float lambda_v = (-1.0f + sqrtf(a2 * (1.0f - NL2) / std::max(NL2, 1e-8f) + 1.0f)) * 0.5f;
+    float lambda_l = (-1.0f + sqrtf(a2 * (1.0f - NV2) / std::max(NV2, 1e-8f) + 1.0f)) * 0.5f;
+
+    return 1.0f / std::max(1.0f + lambda_v + lambda_l, 1e-8f);
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップをサンプリングします.
+//-----------------------------------------------------------------------------
+float3 SampleLevel(const FloatImage& cubeMap, const float3& L, float mipLevel)
+{
+    float dir[3] = { L.x, L.y, L.z };
+    float color[4];
+    SampleCubeLevel(cubeMap, dir, mipLevel, color);
+    return float3{ color[0], color[1], color[2] };
+}
+
+//-----------------------------------------------------------------------------
+//      スペキュラーのLD項を積分します.
+//-----------------------------------------------------------------------------
+float3 IntegrateSpecularCube
+(
+    const FloatImage&   cubeMap,
+    const float3&       V,
+    const float3&       N,
+    float               a,
+    float               width,
+    float               mipCount
+)
+{
+    float3 acc       = float3{ 0.0f, 0.0f, 0.0f };
+    float  accWeight = 0.0f;
+
+    float omegaP = (4.0f * F_PI) / (6.0f * width * width);
+    float bias   = 1.0f;
+
+    for(uint32_t i=0; i<SampleCount; ++i)
+    {
+        float u0, u1;
+        Hammersley(i, SampleCount, u0, u1);
+
+        float3 H = SampleGGX(u0, u1, a, N);
+        float3 L = normalize(2 * dot( V, H ) * H - V);
+
+        float NdotL = saturate(dot(N, L));
+        if (NdotL > 0)
+        {
+            // シェーダと同じく D_GGX() の引数は (NdotL, a) の順で渡す.
+            float pdf      = D_GGX(NdotL, a) * NdotL;
+            float omegaS   = 1.0f / std::max(SampleCount * pdf, 1e-8f);
+            float l        = 0.5f * (log2f(omegaS) - log2f(omegaP)) + bias;
+            float mipLevel = std::min(std::max(l, 0.0f), mipCount);
+
+            acc = acc + SampleLevel(cubeMap, L, mipLevel) * NdotL;
+            accWeight += NdotL;
+        }
+    }
+
+    if (accWeight == 0.0f)
+    { return acc; }
+
+    return acc * (1.0f / accWeight);
+}
+
+} // namespace
+
+
+namespace reference {
+
+//-----------------------------------------------------------------------------
+//      キューブマップのフェッチ方向を求めます.
+//-----------------------------------------------------------------------------
+void CalcDirection(float u, float v, int faceIndex, float dir[3])
+{
+    float3 d   = float3{ 0.0f, 0.0f, 0.0f };
+    float  x   = u * 2.0f - 1.0f;
+    float  y   = v * 2.0f - 1.0f;
+
+    switch(faceIndex)
+    {
+        case 0 : { d = float3{ 1.0f,   y,  -x   }; } break;
+        case 1 : { d = float3{-1.0f,   y,   x   }; } break;
+        case 2 : { d = float3{ x,   1.0f,  -y   }; } break;
+        case 3 : { d = float3{ x,  -1.0f,   y   }; } break;
+        case 4 : { d = float3{ x,      y,  1.0f }; } break;
+        case 5 : { d = float3{-x,      y, -1.0f }; } break;
+    }
+
+    d = normalize(d);
+    dir[0] = d.x;
+    dir[1] = d.y;
+    dir[2] = d.z;
+}
+
+//-----------------------------------------------------------------------------
+//      DFG項を積分します.
+//-----------------------------------------------------------------------------
+void IntegrateDFG(float NdotV, float roughness, float result[2])
+{
+    float3 N = float3{ 0.0f, 0.0f, 1.0f };
+    float3 V = float3{ sqrtf(1.0f - NdotV * NdotV), 0.0f, NdotV };
+    float  a = roughness * roughness;
+
+    float accX = 0.0f;
+    float accY = 0.0f;
+    const uint32_t count = 1024;
+
+    for(uint32_t i=0; i<count; ++i)
+    {
+        // シェーダと同じく Hammersley() には SampleCount を渡す.
+        float u0, u1;
+        Hammersley(i, SampleCount, u0, u1);
+
+        float3 H     = SampleGGX(u0, u1, a, N);
+        float3 L     = normalize(2 * dot( V, H ) * H - V);
+        float  NdotL = dot(N, L);
+
+        if (NdotL > 0.0f)
+        {
+            float NdotH = saturate(dot(N, H));
+            float VdotH = saturate(dot(V, H));
+
+            float G    = G2_Smith(NdotL, NdotV, roughness);
+            float GVis = G * VdotH / std::max(NdotV * NdotH, 1e-8f);
+            float Fc   = powf(1.0f - VdotH, 5.0f);
+
+            accX += (1 - Fc) * GVis;
+            accY += Fc * GVis;
+        }
+    }
+
+    result[0] = accX / float(count);
+    result[1] = accY / float(count);
+}
+
+//-----------------------------------------------------------------------------
+//      Specular LD 項を積分します.
+//-----------------------------------------------------------------------------
+void IntegrateSpecularLD
+(
+    const FloatImage&   cubeMap,
+    float               u,
+    float               v,
+    int                 faceIndex,
+    float               roughness,
+    float               result[3]
+)
+{
+    float d[3];
+    CalcDirection(u, v, faceIndex, d);
+
+    float3 dir    = float3{ d[0], d[1], d[2] };
+    float3 output = float3{ 0.0f, 0.0f, 0.0f };
+
+    if (roughness == 0.0f)
+    { output = SampleLevel(cubeMap, dir, 0.0f); }
+    else
+    {
+        // IBLBaker::Init() と同じく MipCount には最大ミップレベル(= ミップレベル数 - 1)を渡す.
+        output = IntegrateSpecularCube(cubeMap, dir, dir, roughness, float(cubeMap.Width), float(cubeMap.MipLevels - 1));
+    }
+
+    result[0] = output.x;
+    result[1] = output.y;
+    result[2] = output.z;
+}
+
+} // namespace reference
@@ -0,0 +1,55 @@
+﻿//-----------------------------------------------------------------------------
+// File : IBLReference.h
+// Desc : Scalar Reference Port Of IBL Bake Shaders.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <FloatImage.h>
+
+
+namespace reference {
+
+//-----------------------------------------------------------------------------
+//! @brief      BakeUtil.hlsli の CalcDirection() をそのまま移植したものです.
+//!
+//! @param[in]      u, v        QuadVS.hlsl のテクスチャ座標(上端が v = 1)です.
+//! @param[in]      faceIndex   キューブマップの面番号です.
+//! @param[out]     dir         正規化された方向ベクトルの格納先です.
+//-----------------------------------------------------------------------------
+void CalcDirection(float u, float v, int faceIndex, float dir[3]);
+
+//-----------------------------------------------------------------------------
+//! @brief      IntegrateDFG_PS.hlsl の IntegrateDFG_Only() をそのまま移植したものです.
+//!
+//! @param[in]      NdotV       法線と視線の内積です.
+//! @param[in]      roughness   線形ラフネスです.
+//! @param[out]     result      結果(RG)の格納先です.
+//-----------------------------------------------------------------------------
+void IntegrateDFG(float NdotV, float roughness, float result[2]);
+
+//-----------------------------------------------------------------------------
+//! @brief      IntegrateSpecularLD_PS.hlsl の main() をそのまま移植したものです.
+//!
+//! @param[in]      cubeMap     ミップチェイン付きの入力キューブマップです.
+//! @param[in]      u, v        出力テクセルのテクスチャ座標です.
+//! @param[in]      faceIndex   出力キューブマップの面番号です.
+//! @param[in]      roughness   ラフネス(= 線形ラフネス^2)です.
+//! @param[out]     result      結果(RGB)の格納先です.
+//! @note       テクスチャのフェッチだけは SampleCubeLevel() を使います.
+//-----------------------------------------------------------------------------
+void IntegrateSpecularLD
+(
+    const FloatImage&   cubeMap,
+    float               u,
+    float               v,
+    int                 faceIndex,
+    float               roughness,
+    float               result[3]
+);
+
+} // namespace reference
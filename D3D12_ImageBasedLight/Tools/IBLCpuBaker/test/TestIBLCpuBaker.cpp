@@ -0,0 +1,308 @@
+﻿//-----------------------------------------------------------------------------
+// File : TestIBLCpuBaker.cpp
+// Desc : Golden Tests For CPU IBL Baker.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <IBLCpuBaker.h>
+#include <Logger.h>
+#include "IBLReference.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+// DFG は NdotL = 0 付近のサンプルが丸め誤差で採否が入れ替わると, 1サンプル分(約 1/65536)ずれる.
+const double kDFGTolerance          = 1.6e-5;   // 絶対誤差.
+const double kSpecularLDTolerance   = 3.0e-3;   // 相対誤差.
+const double kDiffuseSHTolerance    = 3.6e-6;   // 絶対誤差.
+
+///////////////////////////////////////////////////////////////////////////////
+// TestContext structure
+///////////////////////////////////////////////////////////////////////////////
+struct TestContext
+{
+    int     Result = 0;     //!< 終了コード.
+};
+
+//-----------------------------------------------------------------------------
+//      検証に失敗したら終了コードを設定します.
+//-----------------------------------------------------------------------------
+void Check(TestContext& context, bool condition, const char* message)
+{
+    if (condition)
+    { return; }
+
+    ELOG("Error : %s", message);
+    context.Result = 1;
+}
+
+//-----------------------------------------------------------------------------
+//      テクセル中心のテクスチャ座標を求めます.
+//-----------------------------------------------------------------------------
+void CalcTexCoord(uint32_t x, uint32_t y, uint32_t size, float& u, float& v)
+{
+    // QuadVS.hlsl は上端を v = 1 として出力する.
+    u = (float(x) + 0.5f) / float(size);
+    v = 1.0f - (float(y) + 0.5f) / float(size);
+}
+
+//-----------------------------------------------------------------------------
+//      2次までの球面調和関数で表せる放射輝度を求めます.
+//-----------------------------------------------------------------------------
+void EvaluateBandLimited(const float d[3], float result[3], float band[3][3])
+{
+    const float x = d[0];
+    const float y = d[1];
+    const float z = d[2];
+
+    // 各バンドの成分を多項式で直接与える(2次の項はトレースが0なので純粋にバンド2).
+    const float kL1[3][3] = {
+        {  0.30f, -0.10f,  0.20f },
+        { -0.15f,  0.25f,  0.05f },
+        {  0.10f,  0.20f, -0.25f },
+    };
+    const float kL2[3][5] = {
+        {  0.20f, -0.10f,  0.05f,  0.15f, -0.08f },
+        { -0.05f,  0.12f, -0.10f,  0.06f,  0.10f },
+        {  0.08f,  0.04f,  0.18f, -0.12f,  0.05f },
+    };
+    const float kL0[3] = { 1.0f, 0.8f, 0.6f };
+
+    const float poly[5] = { x * y, y * z, x * z, x * x - y * y, 3.0f * z * z - 1.0f };
+
+    for(auto c=0; c<3; ++c)
+    {
+        band[c][0] = kL0[c];
+        band[c][1] = kL1[c][0] * x + kL1[c][1] * y + kL1[c][2] * z;
+        band[c][2] = 0.0f;
+        for(auto i=0; i<5; ++i)
+        { band[c][2] += kL2[c][i] * poly[i]; }
+
+        result[c] = band[c][0] + band[c][1] + band[c][2];
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      滑らかな空の輝度を求めます.
+//-----------------------------------------------------------------------------
+void EvaluateSky(const float d[3], float result[3])
+{
+    auto horizon = 1.0f - fabsf(d[1]);
+    auto sun     = std::max(0.0f, d[0] * 0.5f + d[1] * 0.6f + d[2] * 0.62f);
+    sun = powf(sun, 8.0f) * 4.0f;
+
+    result[0] = 0.2f + 0.8f * horizon + sun;
+    result[1] = 0.3f + 0.6f * horizon + sun * 0.9f;
+    result[2] = 0.5f + 0.4f * horizon + sun * 0.7f;
+}
+
+//-----------------------------------------------------------------------------
+//      関数からキューブマップを生成します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+void CreateCube(uint32_t size, FloatImage& image, Func func)
+{
+    image.Init(size, size, 6, 1, true);
+
+    for(auto f=0u; f<6; ++f)
+    {
+        auto pDst = image.GetPixels(f, 0);
+        for(auto y=0u; y<size; ++y)
+        {
+            for(auto x=0u; x<size; ++x)
+            {
+                float u, v, dir[3];
+                CalcTexCoord(x, y, size, u, v);
+                reference::CalcDirection(u, v, int(f), dir);
+
+                auto pTexel = pDst + (size_t(y) * size + x) * 4;
+                func(dir, pTexel);
+                pTexel[3] = 1.0f;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      DFG項をシェーダの移植と比較します.
+//-----------------------------------------------------------------------------
+void TestDFG(TestContext& context)
+{
+    const uint32_t size = 64;
+
+    FloatImage image;
+    if (!IntegrateDFG_CPU(size, image))
+    {
+        Check(context, false, "IntegrateDFG_CPU() Failed.");
+        return;
+    }
+
+    auto maxError = 0.0;
+    for(auto y=0u; y<size; ++y)
+    {
+        for(auto x=0u; x<size; ++x)
+        {
+            float u, v;
+            CalcTexCoord(x, y, size, u, v);
+
+            // IntegrateDFG_PS.hlsl は TexCoord.x を NdotV, TexCoord.y を線形ラフネスとして使う.
+            float expected[2];
+            reference::IntegrateDFG(u, v, expected);
+
+            auto pTexel = image.GetPixels(0, 0) + (size_t(y) * size + x) * 4;
+            for(auto c=0; c<2; ++c)
+            { maxError = std::max(maxError, fabs(double(pTexel[c]) - double(expected[c]))); }
+        }
+    }
+
+    printf("DFG          : max abs error = %.3e (tolerance %.1e)\n", maxError, kDFGTolerance);
+    Check(context, maxError <= kDFGTolerance, "IntegrateDFG_CPU() Result Mismatch.");
+}
+
+//-----------------------------------------------------------------------------
+//      Specular LD 項をシェーダの移植と比較します.
+//-----------------------------------------------------------------------------
+void TestSpecularLD(TestContext& context)
+{
+    const uint32_t srcSize  = 64;
+    const uint32_t dstSize  = 32;
+    const uint32_t mipCount = 6;
+
+    // ミップチェインを持たせておき, 両者が同じ入力をフェッチするようにする.
+    FloatImage cube;
+    CreateCube(srcSize, cube, [](const float dir[3], float* pTexel) { EvaluateSky(dir, pTexel); });
+    if (!GenerateMipmaps(cube))
+    {
+        Check(context, false, "GenerateMipmaps() Failed.");
+        return;
+    }
+
+    FloatImage result;
+    if (!IntegrateSpecularLD_CPU(cube, dstSize, mipCount, result))
+    {
+        Check(context, false, "IntegrateSpecularLD_CPU() Failed.");
+        return;
+    }
+    Check(context, result.MipLevels == mipCount, "IntegrateSpecularLD_CPU() Mip Count Mismatch.");
+
+    auto maxError = 0.0;
+    for(auto m=0u; m<result.MipLevels; ++m)
+    {
+        // IBLCpuBaker.h の通り, ミップレベル m の a は (m / (mipCount - 1))^2 とする.
+        auto roughness = float(m) / float(mipCount - 1);
+        auto a         = roughness * roughness;
+        auto size      = result.GetMipWidth(m);
+
+        for(auto f=0u; f<6; ++f)
+        {
+            for(auto y=0u; y<size; ++y)
+            {
+                for(auto x=0u; x<size; ++x)
+                {
+                    float u, v;
+                    CalcTexCoord(x, y, size, u, v);
+
+                    float expected[3];
+                    reference::IntegrateSpecularLD(cube, u, v, int(f), a, expected);
+
+                    auto pTexel = result.GetPixels(f, m) + (size_t(y) * size + x) * 4;
+                    for(auto c=0; c<3; ++c)
+                    {
+                        auto error = fabs(double(pTexel[c]) - double(expected[c])) / std::max(fabs(double(expected[c])), 1e-6);
+                        maxError = std::max(maxError, error);
+                    }
+                }
+            }
+        }
+    }
+
+    printf("SpecularLD   : max rel error = %.3e (tolerance %.1e)\n", maxError, kSpecularLDTolerance);
+    Check(context, maxError <= kSpecularLDTolerance, "IntegrateSpecularLD_CPU() Result Mismatch.");
+}
+
+//-----------------------------------------------------------------------------
+//      帯域制限された環境で球面調和関数による放射照度を解析解と比較します.
+//-----------------------------------------------------------------------------
+void TestDiffuseSH(TestContext& context)
+{
+    // ProjectDiffuseSH() が射影に使う最大サイズに合わせる.
+    const uint32_t size = 128;
+
+    FloatImage cube;
+    CreateCube(size, cube, [](const float dir[3], float* pTexel)
+    {
+        float band[3][3];
+        EvaluateBandLimited(dir, pTexel, band);
+    });
+
+    IBLDiffuseSH sh;
+    if (!ProjectDiffuseSH(cube, sh))
+    {
+        Check(context, false, "ProjectDiffuseSH() Failed.");
+        return;
+    }
+
+    // 放射照度 / π は各バンドに 1, 2/3, 1/4 を掛けたものになる.
+    const float kScale[3] = { 1.0f, 2.0f / 3.0f, 1.0f / 4.0f };
+
+    auto maxError = 0.0;
+    for(auto f=0; f<6; ++f)
+    {
+        for(auto y=0u; y<size; y+=3)
+        {
+            for(auto x=0u; x<size; x+=3)
+            {
+                float u, v, dir[3];
+                CalcTexCoord(x, y, size, u, v);
+                reference::CalcDirection(u, v, f, dir);
+
+                float radiance[3], band[3][3];
+                EvaluateBandLimited(dir, radiance, band);
+
+                float actual[3];
+                EvaluateDiffuseSH(sh, dir, actual);
+
+                for(auto c=0; c<3; ++c)
+                {
+                    auto expected = 0.0;
+                    for(auto l=0; l<3; ++l)
+                    { expected += double(kScale[l]) * double(band[c][l]); }
+
+                    maxError = std::max(maxError, fabs(double(actual[c]) - expected));
+                }
+            }
+        }
+    }
+
+    printf("DiffuseSH    : max abs error = %.3e (tolerance %.1e)\n", maxError, kDiffuseSHTolerance);
+    Check(context, maxError <= kDiffuseSHTolerance, "ProjectDiffuseSH() Result Mismatch.");
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+    TestContext context;
+
+    TestDFG(context);
+    TestSpecularLD(context);
+    TestDiffuseSH(context);
+
+    if (context.Result == 0)
+    { printf("All Tests Passed.\n"); }
+
+    return context.Result;
+}
@@ -0,0 +1,200 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchBlockCompression.cpp
+// Desc : Block Compression Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <random>
+#include <res/asdxBlockCompression.h>
+#include <fnd/asdxThreadPool.h>
+#include "asdxBench.h"
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// BenchFormat structure
+///////////////////////////////////////////////////////////////////////////////
+struct BenchFormat
+{
+    asdx::BC_FORMAT Format;         //!< フォーマット.
+    const char*     Name;           //!< 表示名.
+    uint32_t        ChannelCount;   //!< PSNRを計算するチャンネル数.
+    bool            Alpha;          //!< アルファ付きの画像で計測するかどうか.
+};
+
+//-----------------------------------------------------------------------------
+//      圧縮元のRGBA8画像を生成します.
+//-----------------------------------------------------------------------------
+std::vector<uint8_t> MakeImage(uint32_t width, uint32_t height, bool alpha)
+{
+    // グラデーション, 円, ノイズを重ねて, 平坦なブロックと急峻なブロックを混ぜる.
+    std::mt19937 rng(2468);
+    std::uniform_int_distribution<int> noise(-12, 12);
+
+    auto clamp = [](int value)
+    { return uint8_t(value < 0 ? 0 : (value > 255 ? 255 : value)); };
+
+    std::vector<uint8_t> image(width * height * 4);
+    for(auto y=0u; y<height; ++y)
+    {
+        for(auto x=0u; x<width; ++x)
+        {
+            auto dx = float(x) - float(width)  * 0.5f;
+            auto dy = float(y) - float(height) * 0.5f;
+            auto inside = (dx * dx + dy * dy) < float(width * width) * 0.1f;
+
+            auto r = int(x * 255 / width);
+            auto g = int(y * 255 / height);
+            auto b = inside ? 220 : 40;
+            auto a = alpha ? int(128.0f + 127.0f * sinf(float(x + y) * 0.05f)) : 255;
+
+            auto ptr = &image[(y * width + x) * 4];
+            ptr[0] = clamp(r + noise(rng));
+            ptr[1] = clamp(g + noise(rng));
+            ptr[2] = clamp(b + noise(rng));
+            ptr[3] = clamp(a);
+        }
+    }
+
+    return image;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      ブロック圧縮のベンチマークを実行します.
+//-----------------------------------------------------------------------------
+void BenchBlockCompression(asdx::bench::Runner& runner)
+{
+    const uint32_t kSize   = runner.IsQuick() ? 64 : 256;
+    const uint32_t kPixels = kSize * kSize;
+    const uint32_t kPitch  = kSize * 4;
+
+    // BC1 は半透明を持てず, アルファが 128 未満の画素は黒に潰れるので不透明な画像で測る.
+    auto opaque      = MakeImage(kSize, kSize, false);
+    auto translucent = MakeImage(kSize, kSize, true);
+    std::vector<uint8_t> decoded(opaque.size());
+
+    // 処理速度は画素数で割った ns/pixel で比較し, 画質は展開結果の PSNR で見る.
+    const BenchFormat kFormats[] = {
+        { asdx::BC_FORMAT_BC1,       "BC1",  3, false },
+        { asdx::BC_FORMAT_BC2,       "BC2",  4, true  },
+        { asdx::BC_FORMAT_BC3,       "BC3",  4, true  },
+        { asdx::BC_FORMAT_BC4_UNORM, "BC4",  1, false },
+        { asdx::BC_FORMAT_BC5_UNORM, "BC5",  2, false },
+    };
+
+    for(auto& item : kFormats)
+    {
+        auto& source = item.Alpha ? translucent : opaque;
+
+        auto blockPitch = (kSize / 4) * asdx::GetBCBlockSize(item.Format);
+        std::vector<uint8_t> blocks(blockPitch * (kSize / 4));
+
+        if (!asdx::EncodeBC(item.Format, kSize, kSize, source.data(), kPitch, blocks.data(), blockPitch))
+        {
+            fprintf(stderr, "Error : EncodeBC() Failed. format = %s\n", item.Name);
+            continue;
+        }
+
+        char name[64];
+        sprintf(name, "BlockCompression/Encode(%s)", item.Name);
+        runner.Run(name, kPixels, [&](uint64_t ops)
+        {
+            for(uint64_t n=0; n<ops; n+=kPixels)
+            {
+                asdx::EncodeBC(item.Format, kSize, kSize, source.data(), kPitch, blocks.data(), blockPitch);
+                asdx::bench::ClobberMemory();
+            }
+        });
+
+        sprintf(name, "BlockCompression/Decode(%s)", item.Name);
+        runner.Run(name, kPixels, [&](uint64_t ops)
+        {
+            for(uint64_t n=0; n<ops; n+=kPixels)
+            {
+                asdx::DecodeBC(item.Format, kSize, kSize, blocks.data(), blockPitch, decoded.data(), kPitch);
+                asdx::bench::ClobberMemory();
+            }
+        });
+
+        runner.SetMetric("psnr_db", asdx::CalcPSNR(
+            kSize, kSize, source.data(), kPitch, decoded.data(), kPitch, item.ChannelCount));
+    }
+
+    // BC6H/BC7 は圧縮器が無いので, 乱数で埋めたブロックの展開だけを測る.
+    // BC7 はモードビットが下位から決まるので, 乱数のブロックでも全モードが混ざる.
+    const BenchFormat kDecodeFormats[] = {
+        { asdx::BC_FORMAT_BC6H_UF16, "BC6H_UF16", 3, false },
+        { asdx::BC_FORMAT_BC6H_SF16, "BC6H_SF16", 3, false },
+        { asdx::BC_FORMAT_BC7,       "BC7",       4, true  },
+    };
+
+    for(auto& item : kDecodeFormats)
+    {
+        auto blockPitch = (kSize / 4) * asdx::GetBCBlockSize(item.Format);
+        std::vector<uint8_t> blocks(blockPitch * (kSize / 4));
+
+        std::mt19937 rng(1357);
+        for(auto& value : blocks)
+        { value = uint8_t(rng()); }
+
+        auto dstPitch = kSize * asdx::GetBCDecodedPixelSize(item.Format);
+        std::vector<uint8_t> pixels(dstPitch * kSize);
+
+        char name[64];
+        sprintf(name, "BlockCompression/Decode(%s)", item.Name);
+        runner.Run(name, kPixels, [&](uint64_t ops)
+        {
+            for(uint64_t n=0; n<ops; n+=kPixels)
+            {
+                asdx::DecodeBC(item.Format, kSize, kSize, blocks.data(), blockPitch, pixels.data(), dstPitch);
+                asdx::bench::ClobberMemory();
+            }
+        });
+    }
+
+    // スレッドプールに分割した場合.
+    asdx::IThreadPool* pThreadPool = nullptr;
+    if (!asdx::CreateThreadPool(4, &pThreadPool))
+    {
+        fprintf(stderr, "Error : CreateThreadPool() Failed.\n");
+        return;
+    }
+
+    {
+        auto blockPitch = (kSize / 4) * asdx::GetBCBlockSize(asdx::BC_FORMAT_BC1);
+        std::vector<uint8_t> blocks(blockPitch * (kSize / 4));
+
+        auto& source = opaque;
+
+        runner.Run("BlockCompression/Encode(BC1,Threads=4)", kPixels, [&](uint64_t ops)
+        {
+            for(uint64_t n=0; n<ops; n+=kPixels)
+            {
+                asdx::EncodeBC(asdx::BC_FORMAT_BC1, kSize, kSize, source.data(), kPitch, blocks.data(), blockPitch, pThreadPool);
+                asdx::bench::ClobberMemory();
+            }
+        });
+
+        runner.Run("BlockCompression/Decode(BC1,Threads=4)", kPixels, [&](uint64_t ops)
+        {
+            for(uint64_t n=0; n<ops; n+=kPixels)
+            {
+                asdx::DecodeBC(asdx::BC_FORMAT_BC1, kSize, kSize, blocks.data(), blockPitch, decoded.data(), kPitch, pThreadPool);
+                asdx::bench::ClobberMemory();
+            }
+        });
+
+        runner.SetMetric("psnr_db", asdx::CalcPSNR(
+            kSize, kSize, source.data(), kPitch, decoded.data(), kPitch, 3));
+    }
+
+    pThreadPool->Release();
+}
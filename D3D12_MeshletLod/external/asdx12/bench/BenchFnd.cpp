@@ -0,0 +1,426 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchFnd.cpp
+// Desc : Foundation Module Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <random>
+#include <fnd/asdxList.h>
+#include <fnd/asdxQueue.h>
+#include <fnd/asdxOffsetAllocator.h>
+#include <fnd/asdxIndexHeap.h>
+#include <fnd/asdxFrameHeap.h>
+#include <fnd/asdxChunkAllocator.h>
+#include <fnd/asdxHash.h>
+#include <fnd/asdxMath.h>
+#include "asdxBench.h"
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// ListItem structure
+///////////////////////////////////////////////////////////////////////////////
+struct ListItem : public asdx::List<ListItem>::Node
+{
+    uint32_t    Value = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// QueueItem structure
+///////////////////////////////////////////////////////////////////////////////
+struct QueueItem : public asdx::Queue<QueueItem>::Node
+{
+    uint32_t    Value = 0;
+};
+
+//-----------------------------------------------------------------------------
+//      確保サイズの列を生成します.
+//-----------------------------------------------------------------------------
+std::vector<uint32_t> MakeSizes(size_t count, uint32_t minSize, uint32_t maxSize)
+{
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<uint32_t> dist(minSize, maxSize);
+
+    std::vector<uint32_t> result(count);
+    for(auto& size : result)
+    { size = dist(rng); }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      解放順を生成します.
+//-----------------------------------------------------------------------------
+std::vector<uint32_t> MakeShuffledOrder(size_t count)
+{
+    std::vector<uint32_t> result(count);
+    for(size_t i=0; i<count; ++i)
+    { result[i] = uint32_t(i); }
+
+    std::mt19937 rng(67890);
+    std::shuffle(result.begin(), result.end(), rng);
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      リストのベンチマークです.
+//-----------------------------------------------------------------------------
+void BenchList(asdx::bench::Runner& runner)
+{
+    const size_t kCount = 4096;
+    std::vector<ListItem> items(kCount);
+    for(size_t i=0; i<kCount; ++i)
+    { items[i].Value = uint32_t(i); }
+
+    runner.Run("List/PushBack+PopFront", kCount * 256, [&](uint64_t ops)
+    {
+        asdx::List<ListItem> list;
+        for(uint64_t n=0; n<ops; n+=kCount)
+        {
+            for(auto& item : items)
+            { list.push_back(&item); }
+
+            while(!list.empty())
+            { list.erase(list.begin()); }
+        }
+        asdx::bench::ClobberMemory();
+    });
+
+    runner.Run("List/Iterate", kCount * 1024, [&](uint64_t ops)
+    {
+        asdx::List<ListItem> list;
+        for(auto& item : items)
+        { list.push_back(&item); }
+
+        uint64_t sum = 0;
+        for(uint64_t n=0; n<ops; n+=kCount)
+        {
+            for(auto& item : list)
+            { sum += item.Value; }
+        }
+        asdx::bench::DoNotOptimize(sum);
+
+        list.clear();
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      キューのベンチマークです.
+//-----------------------------------------------------------------------------
+void BenchQueue(asdx::bench::Runner& runner)
+{
+    const size_t kCount = 4096;
+    std::vector<QueueItem> items(kCount);
+
+    runner.Run("Queue/Push+Pop", kCount * 256, [&](uint64_t ops)
+    {
+        asdx::Queue<QueueItem> queue;
+        uint64_t sum = 0;
+        for(uint64_t n=0; n<ops; n+=kCount)
+        {
+            for(auto& item : items)
+            { queue.push(&item); }
+
+            while(auto item = queue.pop())
+            { sum += item->Value; }
+        }
+        asdx::bench::DoNotOptimize(sum);
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      オフセットアロケータのベンチマークです.
+//-----------------------------------------------------------------------------
+void BenchOffsetAllocator(asdx::bench::Runner& runner)
+{
+    const size_t kCount = 8192;
+    auto sizes = MakeSizes(kCount, 16, 4096);
+    auto order = MakeShuffledOrder(kCount);
+
+    asdx::OffsetAllocator allocator;
+    allocator.Init(64 * 1024 * 1024, 64 * 1024);
+
+    std::vector<asdx::OffsetHandle> handles(kCount);
+
+    runner.Run("OffsetAllocator/Alloc+Free", kCount * 64, [&](uint64_t ops)
+    {
+        for(uint64_t n=0; n<ops; n+=kCount)
+        {
+            for(size_t i=0; i<kCount; ++i)
+            { handles[i] = allocator.Alloc(sizes[i]); }
+
+            for(auto index : order)
+            { allocator.Free(handles[index]); }
+        }
+    });
+
+    runner.Run("OffsetAllocator/Alloc+Free(Align256)", kCount * 64, [&](uint64_t ops)
+    {
+        for(uint64_t n=0; n<ops; n+=kCount)
+        {
+            for(size_t i=0; i<kCount; ++i)
+            { handles[i] = allocator.Alloc(sizes[i], 256); }
+
+            for(auto index : order)
+            { allocator.Free(handles[index]); }
+        }
+    });
+
+    allocator.Term();
+}
+
+//-----------------------------------------------------------------------------
+//      インデックスヒープのベンチマークです.
+//-----------------------------------------------------------------------------
+void BenchIndexHeap(asdx::bench::Runner& runner)
+{
+    const size_t kCount = 1024;
+    auto counts = MakeSizes(kCount, 1, 64);
+    auto order  = MakeShuffledOrder(kCount);
+
+    asdx::IndexHeap heap;
+    heap.Init(1024 * 1024);
+
+    std::vector<asdx::IndexHandle> handles(kCount);
+
+    // 解放した領域は Compact() まで再利用されないので, 1周ごとに詰め直す.
+    runner.Run("IndexHeap/Alloc+Free+Compact", kCount * 16, [&](uint64_t ops)
+    {
+        for(uint64_t n=0; n<ops; n+=kCount)
+        {
+            for(size_t i=0; i<kCount; ++i)
+            { handles[i] = heap.Alloc(counts[i]); }
+
+            for(auto index : order)
+            { heap.Free(handles[index]); }
+
+            heap.Compact();
+        }
+    });
+
+    heap.Term();
+}
+
+//-----------------------------------------------------------------------------
+//      フレームヒープのベンチマークです.
+//-----------------------------------------------------------------------------
+void BenchFrameHeap(asdx::bench::Runner& runner)
+{
+    const size_t kCount = 8192;
+    auto sizes = MakeSizes(kCount, 16, 256);
+
+    asdx::FrameHeap heap;
+    heap.Init(4 * 1024 * 1024);
+
+    runner.Run("FrameHeap/Alloc+Reset", kCount * 256, [&](uint64_t ops)
+    {
+        for(uint64_t n=0; n<ops; n+=kCount)
+        {
+            for(auto size : sizes)
+            { asdx::bench::DoNotOptimize(heap.Alloc(size)); }
+
+            heap.Reset();
+        }
+    });
+
+    heap.Term();
+}
+
+//-----------------------------------------------------------------------------
+//      チャンクアロケータのベンチマークです.
+//-----------------------------------------------------------------------------
+void BenchChunkAllocator(asdx::bench::Runner& runner)
+{
+    const size_t kCount = 8192;
+    auto sizes = MakeSizes(kCount, 16, 256);
+
+    runner.Run("ChunkAllocator/Measure+Alloc", kCount * 64, [&](uint64_t ops)
+    {
+        for(uint64_t n=0; n<ops; n+=kCount)
+        {
+            asdx::ChunkAllocator allocator;
+            do
+            {
+                for(auto size : sizes)
+                { asdx::bench::DoNotOptimize(allocator.Alloc(size, 16)); }
+            }
+            while(allocator.AllocChunk());
+
+            allocator.FreeChunk();
+        }
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      ハッシュのベンチマークです.
+//-----------------------------------------------------------------------------
+void BenchHash(asdx::bench::Runner& runner)
+{
+    std::vector<uint8_t> buffer(4096);
+    for(size_t i=0; i<buffer.size(); ++i)
+    { buffer[i] = uint8_t(i * 31 + 7); }
+
+    const uint32_t kSizes[] = { 16, 256, 4096 };
+    for(auto size : kSizes)
+    {
+        char name[64];
+        sprintf(name, "Hash/CalcHash/%u", size);
+
+        runner.Run(name, (1024 * 1024 * 16) / size, [&](uint64_t ops)
+        {
+            uint32_t hash = 0;
+            for(uint64_t n=0; n<ops; ++n)
+            {
+                buffer[0] = uint8_t(n);
+                hash ^= asdx::CalcHash(buffer.data(), size);
+            }
+            asdx::bench::DoNotOptimize(hash);
+        });
+
+        sprintf(name, "Hash/CalcHash64/%u", size);
+
+        runner.Run(name, (1024 * 1024 * 16) / size, [&](uint64_t ops)
+        {
+            uint64_t hash = 0;
+            for(uint64_t n=0; n<ops; ++n)
+            {
+                buffer[0] = uint8_t(n);
+                hash ^= asdx::CalcHash64(buffer.data(), size);
+            }
+            asdx::bench::DoNotOptimize(hash);
+        });
+    }
+
+    const char* kNames[] = {
+        "Position",
+        "ColorMap",
+        "DepthTarget",
+        "ShadowMapCascade0",
+        "ScreenSpaceReflectionHistory",
+        "TemporalAntiAliasingResolveOutput",
+    };
+    const size_t kNameCount = sizeof(kNames) / sizeof(kNames[0]);
+
+    runner.Run("Hash/CalcHash/String", 1024 * 1024, [&](uint64_t ops)
+    {
+        uint32_t hash = 0;
+        for(uint64_t n=0; n<ops; ++n)
+        { hash ^= asdx::CalcHash(kNames[n % kNameCount]); }
+        asdx::bench::DoNotOptimize(hash);
+    });
+
+    runner.Run("Hash/CalcHash64/String", 1024 * 1024, [&](uint64_t ops)
+    {
+        uint64_t hash = 0;
+        for(uint64_t n=0; n<ops; ++n)
+        { hash ^= asdx::CalcHash64(kNames[n % kNameCount]); }
+        asdx::bench::DoNotOptimize(hash);
+    });
+
+    // 登録済みの文字列を引き直すコスト (ハッシュ計算 + テーブル検索 + 文字列比較).
+    auto& table = asdx::StringTable::Instance();
+    for(auto name : kNames)
+    { table.Intern(name); }
+
+    runner.Run("Hash/StringTable::Intern(Hit)", 1024 * 256, [&](uint64_t ops)
+    {
+        uint64_t hash = 0;
+        for(uint64_t n=0; n<ops; ++n)
+        { hash ^= table.Intern(kNames[n % kNameCount]).GetHash(); }
+        asdx::bench::DoNotOptimize(hash);
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      数学ルーチンのベンチマークです.
+//-----------------------------------------------------------------------------
+void BenchMath(asdx::bench::Runner& runner)
+{
+    const size_t kCount = 1024;
+
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    std::vector<asdx::Vector3>      vectors(kCount);
+    std::vector<asdx::Matrix>       matrices(kCount);
+    std::vector<asdx::Quaternion>   rotations(kCount);
+    for(size_t i=0; i<kCount; ++i)
+    {
+        vectors[i] = asdx::Vector3(dist(rng), dist(rng), dist(rng) + 2.0f);
+
+        auto axis = asdx::Vector3::Normalize(asdx::Vector3(dist(rng), dist(rng) + 2.0f, dist(rng)));
+        rotations[i] = asdx::Quaternion::CreateFromAxisAngle(axis, dist(rng) * asdx::F_PI);
+        matrices[i]  = asdx::Matrix::CreateFromAxisAngle(axis, dist(rng) * asdx::F_PI)
+                     * asdx::Matrix::CreateTranslation(vectors[i]);
+    }
+
+    runner.Run("Math/Matrix::Multiply", kCount * 256, [&](uint64_t ops)
+    {
+        auto result = asdx::Matrix::CreateIdentity();
+        for(uint64_t n=0; n<ops; ++n)
+        { result = asdx::Matrix::Multiply(matrices[n % kCount], matrices[(n + 1) % kCount]); }
+        asdx::bench::DoNotOptimize(result);
+    });
+
+    runner.Run("Math/Matrix::Invert", kCount * 256, [&](uint64_t ops)
+    {
+        auto result = asdx::Matrix::CreateIdentity();
+        for(uint64_t n=0; n<ops; ++n)
+        { result = asdx::Matrix::Invert(matrices[n % kCount]); }
+        asdx::bench::DoNotOptimize(result);
+    });
+
+    runner.Run("Math/Matrix::CreateLookAt", kCount * 256, [&](uint64_t ops)
+    {
+        auto result = asdx::Matrix::CreateIdentity();
+        for(uint64_t n=0; n<ops; ++n)
+        { result = asdx::Matrix::CreateLookAt(vectors[n % kCount], asdx::Vector3(0.0f, 0.0f, 0.0f), asdx::Vector3(0.0f, 1.0f, 0.0f)); }
+        asdx::bench::DoNotOptimize(result);
+    });
+
+    runner.Run("Math/Vector3::Normalize", kCount * 1024, [&](uint64_t ops)
+    {
+        asdx::Vector3 sum(0.0f, 0.0f, 0.0f);
+        for(uint64_t n=0; n<ops; ++n)
+        { sum += asdx::Vector3::Normalize(vectors[n % kCount]); }
+        asdx::bench::DoNotOptimize(sum);
+    });
+
+    runner.Run("Math/Vector3::Transform", kCount * 1024, [&](uint64_t ops)
+    {
+        asdx::Vector3 sum(0.0f, 0.0f, 0.0f);
+        for(uint64_t n=0; n<ops; ++n)
+        { sum += asdx::Vector3::Transform(vectors[n % kCount], matrices[(n >> 10) % kCount]); }
+        asdx::bench::DoNotOptimize(sum);
+    });
+
+    runner.Run("Math/Quaternion::Slerp", kCount * 256, [&](uint64_t ops)
+    {
+        asdx::Quaternion result(0.0f, 0.0f, 0.0f, 1.0f);
+        for(uint64_t n=0; n<ops; ++n)
+        { result = asdx::Quaternion::Slerp(rotations[n % kCount], rotations[(n + 1) % kCount], float(n & 0xff) / 255.0f); }
+        asdx::bench::DoNotOptimize(result);
+    });
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      基盤モジュールのベンチマークを実行します.
+//-----------------------------------------------------------------------------
+void BenchFnd(asdx::bench::Runner& runner)
+{
+    BenchList(runner);
+    BenchQueue(runner);
+    BenchOffsetAllocator(runner);
+    BenchIndexHeap(runner);
+    BenchFrameHeap(runner);
+    BenchChunkAllocator(runner);
+    BenchHash(runner);
+    BenchMath(runner);
+}
@@ -0,0 +1,162 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchLogger.cpp
+// Desc : Logger Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <thread>
+#include <fnd/asdxLogger.h>
+#include "asdxBench.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif//_WIN32
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      複数スレッドから同時にログを出力します.
+//-----------------------------------------------------------------------------
+void WriteFromThreads(uint32_t threadCount, uint64_t totalCount, asdx::LOG_LEVEL level)
+{
+    auto& logger = asdx::SystemLogger::Instance();
+    auto  count  = totalCount / threadCount;
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for(auto t=0u; t<threadCount; ++t)
+    {
+        threads.emplace_back([&logger, t, count, level]()
+        {
+            for(uint64_t i=0; i<count; ++i)
+            { logger.WriteA(level, "bench thread = %u, index = %llu, value = %f\n", t, static_cast<unsigned long long>(i), double(i) * 0.5); }
+        });
+    }
+
+    for(auto& thread : threads)
+    { thread.join(); }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// StdoutRedirect class
+///////////////////////////////////////////////////////////////////////////////
+class StdoutRedirect
+{
+public:
+    //-------------------------------------------------------------------------
+    //      標準出力をファイルに切り替えます.
+    //-------------------------------------------------------------------------
+    explicit StdoutRedirect(const char* path)
+    {
+        fflush(stdout);
+
+        m_pFile = fopen(path, "wb");
+        if (m_pFile == nullptr)
+        { return; }
+
+    #ifdef _WIN32
+        m_Saved = _dup(_fileno(stdout));
+        _dup2(_fileno(m_pFile), _fileno(stdout));
+    #else
+        m_Saved = dup(fileno(stdout));
+        dup2(fileno(m_pFile), fileno(stdout));
+    #endif//_WIN32
+    }
+
+    //-------------------------------------------------------------------------
+    //      標準出力を元に戻します.
+    //-------------------------------------------------------------------------
+    ~StdoutRedirect()
+    {
+        fflush(stdout);
+
+        if (m_Saved >= 0)
+        {
+        #ifdef _WIN32
+            _dup2(m_Saved, _fileno(stdout));
+            _close(m_Saved);
+        #else
+            dup2(m_Saved, fileno(stdout));
+            close(m_Saved);
+        #endif//_WIN32
+        }
+
+        if (m_pFile != nullptr)
+        { fclose(m_pFile); }
+    }
+
+private:
+    FILE*   m_pFile = nullptr;
+    int     m_Saved = -1;
+};
+
+// 非同期出力で書き込み側が何倍速くなるかを見るため, 同期出力と同じスレッド数で測る.
+const uint32_t kThreadCounts[] = { 1, 2, 4, 8, 16 };
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      ロガーのベンチマークを実行します.
+//-----------------------------------------------------------------------------
+void BenchLogger(asdx::bench::Runner& runner)
+{
+    auto& logger = asdx::SystemLogger::Instance();
+
+    // 同期出力は標準出力に書くので, 端末の速度を測らないよう計測中だけファイルへ切り替える.
+    // 切り替えのコストはメッセージ数に対して十分小さい.
+    const char* kTextPath = "asdx12_bench_log.txt";
+    for(auto threadCount : kThreadCounts)
+    {
+        char name[64];
+        sprintf(name, "Logger/Sync/Threads=%u", threadCount);
+
+        runner.Run(name, 64 * 1024, [&](uint64_t ops)
+        {
+            StdoutRedirect redirect(kTextPath);
+            WriteFromThreads(threadCount, ops, asdx::LOG_INFO);
+        });
+    }
+    remove(kTextPath);
+
+    // コンソールに出すと端末の速度を測ることになるので, バイナリログだけに書き出す.
+    const char* kLogPath = "asdx12_bench_log.bin";
+
+    asdx::AsyncLogDesc desc;
+    desc.EchoConsole   = false;
+    desc.BinaryLogPath = kLogPath;
+    if (!logger.StartAsync(desc))
+    {
+        fprintf(stderr, "Error : SystemLogger::StartAsync() Failed.\n");
+        return;
+    }
+
+    // 1操作 = 1メッセージ. 全スレッド合計の壁時計時間で割るので,
+    // スレッドを増やしても値が下がらない場合は書き込み側が競合している.
+    for(auto threadCount : kThreadCounts)
+    {
+        char name[64];
+        sprintf(name, "Logger/Async/Threads=%u", threadCount);
+
+        runner.Run(name, 64 * 1024, [&](uint64_t ops)
+        {
+            WriteFromThreads(threadCount, ops, asdx::LOG_INFO);
+            logger.Flush();
+        });
+    }
+
+    // フィルタで捨てられるログの呼び出しコスト.
+    logger.SetFilter(asdx::LOG_WARNING);
+    runner.Run("Logger/Filtered/Threads=4", 1024 * 1024, [&](uint64_t ops)
+    { WriteFromThreads(4, ops, asdx::LOG_VERBOSE); });
+    logger.SetFilter(asdx::LOG_VERBOSE);
+
+    logger.StopAsync();
+    remove(kLogPath);
+}
@@ -0,0 +1,78 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchProfiler.cpp
+// Desc : Profiler Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <thread>
+#include <fnd/asdxProfiler.h>
+#include "asdxBench.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      ゾーンを連続して記録します.
+//-----------------------------------------------------------------------------
+void RecordZones(uint64_t count)
+{
+    for(uint64_t i=0; i<count; ++i)
+    {
+        asdx::ProfileScope scope("BenchZone");
+        asdx::bench::ClobberMemory();
+    }
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      プロファイラのベンチマークを実行します.
+//-----------------------------------------------------------------------------
+void BenchProfiler(asdx::bench::Runner& runner)
+{
+    auto& profiler = asdx::Profiler::Instance();
+
+    // 計測していない時に埋め込んだゾーンが払うコスト.
+    runner.Run("Profiler/Zone(Idle)", 16 * 1024 * 1024, [&](uint64_t ops)
+    { RecordZones(ops); });
+
+    // 1サンプル毎に Start() し直して, 常にバッファに空きがある状態で測る.
+    // Start() と Stop() の分も含むが, ゾーン数に対しては十分小さい.
+    asdx::ProfileDesc desc;
+    desc.MaxEventCountPerThread = 1024 * 1024;
+
+    runner.Run("Profiler/Zone(Capturing)", 1024 * 1024, [&](uint64_t ops)
+    {
+        profiler.Start(desc);
+        RecordZones(ops);
+        profiler.Stop();
+    });
+
+    runner.Run("Profiler/Zone(Capturing,Threads=4)", 1024 * 1024, [&](uint64_t ops)
+    {
+        profiler.Start(desc);
+
+        std::vector<std::thread> threads;
+        for(auto t=0; t<4; ++t)
+        { threads.emplace_back([ops]() { RecordZones(ops / 4); }); }
+
+        for(auto& thread : threads)
+        { thread.join(); }
+
+        profiler.Stop();
+    });
+
+    // バッファが溢れた後は破棄数を数えるだけになる.
+    asdx::ProfileDesc small;
+    small.MaxEventCountPerThread = 1024;
+
+    profiler.Start(small);
+    RecordZones(small.MaxEventCountPerThread);
+    runner.Run("Profiler/Zone(Dropped)", 4 * 1024 * 1024, [&](uint64_t ops)
+    { RecordZones(ops); });
+    profiler.Stop();
+}
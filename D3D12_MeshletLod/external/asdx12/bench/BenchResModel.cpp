@@ -0,0 +1,321 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchResModel.cpp
+// Desc : Model Loader Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <res/asdxResModel.h>
+#include "asdxBench.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#endif//_WIN32
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const char* kObjPath = "asdx12_bench_model.obj";
+const char* kMtlPath = "asdx12_bench_model.mtl";
+const char* kBinPath = "asdx12_bench_model.amdl";
+
+///////////////////////////////////////////////////////////////////////////////
+// LoadStats structure
+///////////////////////////////////////////////////////////////////////////////
+struct LoadStats
+{
+    double      LoadMs;             //!< 1回の読み込み時間(ミリ秒).
+    double      PeakRSS;            //!< 読み込み中のメモリ使用量のピーク(MB).
+    double      DeltaRSS;           //!< 読み込み前からの増加量(MB).
+    bool        Success;            //!< 読み込みに成功したかどうか?
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ModelDesc structure
+///////////////////////////////////////////////////////////////////////////////
+struct ModelDesc
+{
+    uint32_t    ObjectCount;        //!< オブジェクト数.
+    uint32_t    MaterialCount;      //!< マテリアル数.
+    uint32_t    BandCount;          //!< 1オブジェクト内で usemtl を切り替える回数.
+    uint32_t    GridSize;           //!< 1オブジェクトの格子の分割数.
+};
+
+//-----------------------------------------------------------------------------
+//      ピークメモリ使用量の記録をリセットします.
+//-----------------------------------------------------------------------------
+void ResetPeakRSS()
+{
+#ifndef _WIN32
+    // Linux は clear_refs に 5 を書くと VmHWM が現在値に戻る.
+    auto pFile = fopen("/proc/self/clear_refs", "w");
+    if (pFile != nullptr)
+    {
+        fputs("5", pFile);
+        fclose(pFile);
+    }
+#endif//_WIN32
+}
+
+//-----------------------------------------------------------------------------
+//      メモリ使用量をMB単位で取得します.
+//
+//      peak が true ならピーク値, false なら現在値を返却します.
+//-----------------------------------------------------------------------------
+double GetRSS(bool peak)
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    { return 0.0; }
+
+    auto bytes = peak ? counters.PeakWorkingSetSize : counters.WorkingSetSize;
+    return double(bytes) / (1024.0 * 1024.0);
+#else
+    auto pFile = fopen("/proc/self/status", "r");
+    if (pFile == nullptr)
+    { return 0.0; }
+
+    auto key    = peak ? "VmHWM:" : "VmRSS:";
+    auto length = strlen(key);
+    auto result = 0.0;
+
+    char line[256];
+    while(fgets(line, sizeof(line), pFile) != nullptr)
+    {
+        if (strncmp(line, key, length) == 0)
+        {
+            result = atof(line + length) / 1024.0;
+            break;
+        }
+    }
+
+    fclose(pFile);
+    return result;
+#endif//_WIN32
+}
+
+//-----------------------------------------------------------------------------
+//      1回だけ読み込んで, 読み込み時間とメモリのピークを測ります.
+//-----------------------------------------------------------------------------
+template<typename Func>
+LoadStats MeasureLoad(Func func)
+{
+    LoadStats result = {};
+
+    auto rss = GetRSS(false);
+    ResetPeakRSS();
+
+    auto begin = std::chrono::steady_clock::now();
+    result.Success = func();
+    auto end   = std::chrono::steady_clock::now();
+
+    result.LoadMs   = std::chrono::duration<double, std::milli>(end - begin).count();
+    result.PeakRSS  = GetRSS(true);
+    result.DeltaRSS = result.PeakRSS - rss;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      計測値を設定します.
+//-----------------------------------------------------------------------------
+void SetMetrics(asdx::bench::Runner& runner, const LoadStats& stats, uint64_t fileSize)
+{
+    runner.SetMetric("file_mb",      double(fileSize) / (1024.0 * 1024.0));
+    runner.SetMetric("load_ms",      stats.LoadMs);
+    runner.SetMetric("peak_rss_mb",  stats.PeakRSS);
+    runner.SetMetric("rss_delta_mb", stats.DeltaRSS);
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルサイズを取得します.
+//-----------------------------------------------------------------------------
+uint64_t GetFileSize(const char* path)
+{
+    auto pFile = fopen(path, "rb");
+    if (pFile == nullptr)
+    { return 0; }
+
+    fseek(pFile, 0, SEEK_END);
+    auto size = uint64_t(ftell(pFile));
+    fclose(pFile);
+    return size;
+}
+
+//-----------------------------------------------------------------------------
+//      複数オブジェクト, 複数マテリアルの OBJ/MTL を書き出します.
+//-----------------------------------------------------------------------------
+bool WriteModel(const ModelDesc& desc, uint64_t& fileSize)
+{
+    auto pMtl = fopen(kMtlPath, "wb");
+    if (pMtl == nullptr)
+    {
+        fprintf(stderr, "Error : File Open Failed. path = %s\n", kMtlPath);
+        return false;
+    }
+
+    for(auto i=0u; i<desc.MaterialCount; ++i)
+    { fprintf(pMtl, "newmtl material%u\nKd 0.8 0.8 0.8\n\n", i); }
+    fclose(pMtl);
+
+    auto pFile = fopen(kObjPath, "wb");
+    if (pFile == nullptr)
+    {
+        fprintf(stderr, "Error : File Open Failed. path = %s\n", kObjPath);
+        return false;
+    }
+
+    fprintf(pFile, "mtllib %s\n", kMtlPath);
+
+    const auto lineCount   = desc.GridSize + 1;
+    const auto rowsPerBand = (desc.GridSize + desc.BandCount - 1) / desc.BandCount;
+
+    uint32_t base = 0;
+    for(auto i=0u; i<desc.ObjectCount; ++i)
+    {
+        fprintf(pFile, "o object%u\n", i);
+
+        // 波打った格子. 位置・テクスチャ座標・法線を同じ番号で並べる.
+        for(auto y=0u; y<lineCount; ++y)
+        {
+            for(auto x=0u; x<lineCount; ++x)
+            {
+                auto u = float(x) / float(desc.GridSize);
+                auto v = float(y) / float(desc.GridSize);
+                auto h = 0.1f * sinf(u * 12.0f + float(i)) * cosf(v * 9.0f);
+                fprintf(pFile, "v %.6f %.6f %.6f\n", u + float(i), h, v);
+                fprintf(pFile, "vt %.6f %.6f\n", u, v);
+                fprintf(pFile, "vn %.6f %.6f %.6f\n", 0.0f, 1.0f, 0.0f);
+            }
+        }
+
+        // 帯ごとにマテリアルを切り替え, 別のオブジェクトとも同じマテリアルを共有させる.
+        for(auto y=0u; y<desc.GridSize; ++y)
+        {
+            if (y % rowsPerBand == 0)
+            { fprintf(pFile, "usemtl material%u\n", (i + y / rowsPerBand) % desc.MaterialCount); }
+
+            for(auto x=0u; x<desc.GridSize; ++x)
+            {
+                auto i0 = base + y * lineCount + x + 1;
+                auto i1 = i0 + 1;
+                auto i2 = i1 + lineCount;
+                auto i3 = i0 + lineCount;
+                fprintf(pFile, "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n",
+                    i0, i0, i0, i1, i1, i1, i2, i2, i2, i3, i3, i3);
+            }
+        }
+
+        base += lineCount * lineCount;
+    }
+
+    fileSize = uint64_t(ftell(pFile));
+    fclose(pFile);
+    return true;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      モデルローダーのベンチマークを実行します.
+//-----------------------------------------------------------------------------
+void BenchResModel(asdx::bench::Runner& runner)
+{
+    // 8 オブジェクト x 4 マテリアルで約 100 万三角形.
+    ModelDesc desc = {};
+    desc.ObjectCount   = 8;
+    desc.MaterialCount = 4;
+    desc.BandCount     = 4;
+    desc.GridSize      = runner.IsQuick() ? 16 : 256;
+
+    uint64_t fileSize = 0;
+    if (!WriteModel(desc, fileSize))
+    { return; }
+
+    const uint64_t kTriangles = uint64_t(desc.ObjectCount) * desc.GridSize * desc.GridSize * 2;
+
+    // OBJ の解析.
+    asdx::ResModel model;
+    auto objStats = MeasureLoad([&]()
+    { return model.LoadFromFileA(kObjPath) && model.Meshes.size() == desc.MaterialCount; });
+
+    if (!objStats.Success)
+    {
+        fprintf(stderr, "Error : ResModel::LoadFromFileA() Failed. path = %s\n", kObjPath);
+        remove(kObjPath);
+        remove(kMtlPath);
+        return;
+    }
+
+    // 比較用に AMDL に変換しておく.
+    auto saved = model.SaveToFileA(kBinPath);
+    model.Dispose();
+
+    // 1操作 = 1三角形.
+    runner.Run("ResModel/OBJ", kTriangles, [&](uint64_t ops)
+    {
+        for(uint64_t n=0; n<ops; n+=kTriangles)
+        {
+            model.LoadFromFileA(kObjPath);
+            model.Dispose();
+        }
+    });
+    SetMetrics(runner, objStats, fileSize);
+
+    remove(kObjPath);
+    remove(kMtlPath);
+
+    if (!saved)
+    {
+        fprintf(stderr, "Error : ResModel::SaveToFileA() Failed. path = %s\n", kBinPath);
+        return;
+    }
+
+    auto binSize = GetFileSize(kBinPath);
+
+    // AMDL をマップして検証するだけ. 頂点データはファイルのまま参照する.
+    asdx::ResModelBinaryFile file;
+    auto mapStats = MeasureLoad([&]()
+    { return file.Open(kBinPath); });
+    file.Close();
+
+    runner.Run("ResModel/AMDL(Map)", kTriangles, [&](uint64_t ops)
+    {
+        for(uint64_t n=0; n<ops; n+=kTriangles)
+        {
+            file.Open(kBinPath);
+            asdx::bench::DoNotOptimize(file.GetModel());
+            file.Close();
+        }
+    });
+    SetMetrics(runner, mapStats, binSize);
+
+    // AMDL から ResModel にコピーする場合.
+    auto copyStats = MeasureLoad([&]()
+    { return model.LoadFromFileA(kBinPath); });
+    model.Dispose();
+
+    runner.Run("ResModel/AMDL(Copy)", kTriangles, [&](uint64_t ops)
+    {
+        for(uint64_t n=0; n<ops; n+=kTriangles)
+        {
+            model.LoadFromFileA(kBinPath);
+            model.Dispose();
+        }
+    });
+    SetMetrics(runner, copyStats, binSize);
+
+    remove(kBinPath);
+}
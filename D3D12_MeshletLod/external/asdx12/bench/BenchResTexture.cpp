@@ -0,0 +1,623 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchResTexture.cpp
+// Desc : Texture Loader Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <random>
+#include <res/asdxImageDecoder.h>
+#include "asdxBench.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t FORMAT_R32G32B32A32_FLOAT = 2;
+static const uint32_t FORMAT_R8G8B8A8_UNORM     = 28;
+
+///////////////////////////////////////////////////////////////////////////////
+// RGBE structure
+///////////////////////////////////////////////////////////////////////////////
+struct RGBE
+{
+    uint8_t v[4];   //!< R, G, B, 指数部.
+};
+
+//-----------------------------------------------------------------------------
+//      1枚のサーフェイスを持つテクスチャを設定します.
+//-----------------------------------------------------------------------------
+void SetSurface
+(
+    asdx::ResTexture&   texture,
+    uint32_t            width,
+    uint32_t            height,
+    uint32_t            format,
+    uint32_t            pixelSize,
+    uint8_t*            pPixels
+)
+{
+    auto surface = new asdx::SubResource();
+    surface->Width      = width;
+    surface->Height     = height;
+    surface->MipIndex   = 0;
+    surface->Pitch      = width * pixelSize;
+    surface->SlicePitch = width * height * pixelSize;
+    surface->pPixels    = pPixels;
+
+    texture.Dimension    = asdx::TEXTURE_DIMENSION_2D;
+    texture.Width        = width;
+    texture.Height       = height;
+    texture.Depth        = 1;
+    texture.Format       = format;
+    texture.MipMapCount  = 1;
+    texture.SurfaceCount = 1;
+    texture.pResources   = surface;
+}
+
+//-----------------------------------------------------------------------------
+//      1画素ずつ fgetc で TGA を読み込みます(以前の Parse24Bits などの読み方).
+//-----------------------------------------------------------------------------
+bool LoadTGAPerByte(FILE* pFile, asdx::ResTexture& texture)
+{
+    // フッターのマジックを確認.
+    char tag[18] = {};
+    fseek(pFile, -long(sizeof(tag)), SEEK_END);
+    if (fread(tag, sizeof(tag), 1, pFile) != 1 || strcmp(tag, "TRUEVISION-XFILE.") != 0)
+    { return false; }
+
+    uint8_t header[18] = {};
+    fseek(pFile, 0, SEEK_SET);
+    if (fread(header, sizeof(header), 1, pFile) != 1)
+    { return false; }
+
+    auto format = header[2];
+    auto width  = uint32_t(header[12] | (header[13] << 8));
+    auto height = uint32_t(header[14] | (header[15] << 8));
+    auto bpp    = header[16];
+
+    // フルカラーの 24/32bit だけを比較対象にする.
+    if ((format != 2 && format != 10) || (bpp != 24 && bpp != 32))
+    { return false; }
+
+    if (header[0] != 0)
+    { fseek(pFile, header[0], SEEK_CUR); }
+
+    auto size    = width * height * 4;
+    auto pPixels = new (std::nothrow) uint8_t [size];
+    if (pPixels == nullptr)
+    { return false; }
+
+    auto ptr = pPixels;
+    if (format == 2)
+    {
+        for(auto i=0u; i<width * height; ++i, ptr+=4)
+        {
+            ptr[2] = uint8_t(fgetc(pFile));
+            ptr[1] = uint8_t(fgetc(pFile));
+            ptr[0] = uint8_t(fgetc(pFile));
+            ptr[3] = (bpp == 32) ? uint8_t(fgetc(pFile)) : 255;
+        }
+    }
+    else
+    {
+        while(ptr < pPixels + size)
+        {
+            auto packet = uint8_t(fgetc(pFile));
+            auto count  = 1u + (packet & 0x7f);
+            if (ptr + count * 4 > pPixels + size)
+            { break; }
+
+            if (packet & 0x80)
+            {
+                uint8_t color[4] = { 0, 0, 0, 255 };
+                if (fread(color, 1, bpp / 8, pFile) != size_t(bpp / 8))
+                { break; }
+
+                for(auto i=0u; i<count; ++i, ptr+=4)
+                {
+                    ptr[0] = color[2];
+                    ptr[1] = color[1];
+                    ptr[2] = color[0];
+                    ptr[3] = color[3];
+                }
+            }
+            else
+            {
+                for(auto i=0u; i<count; ++i, ptr+=4)
+                {
+                    ptr[2] = uint8_t(fgetc(pFile));
+                    ptr[1] = uint8_t(fgetc(pFile));
+                    ptr[0] = uint8_t(fgetc(pFile));
+                    ptr[3] = (bpp == 32) ? uint8_t(fgetc(pFile)) : 255;
+                }
+            }
+        }
+    }
+
+    if (ptr != pPixels + size || ferror(pFile))
+    {
+        delete[] pPixels;
+        return false;
+    }
+
+    SetSurface(texture, width, height, FORMAT_R8G8B8A8_UNORM, 4, pPixels);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      旧形式のカラーを getc で読み取ります.
+//-----------------------------------------------------------------------------
+bool ReadOldColorsPerByte(FILE* pFile, RGBE* pLine, int32_t count)
+{
+    auto shift = 0;
+    while(0 < count)
+    {
+        for(auto c=0; c<4; ++c)
+        { pLine[0].v[c] = uint8_t(getc(pFile)); }
+
+        if (feof(pFile) || ferror(pFile))
+        { return false; }
+
+        if (pLine[0].v[0] == 1 && pLine[0].v[1] == 1 && pLine[0].v[2] == 1)
+        {
+            for(auto i=pLine[0].v[3] << shift; i > 0 && 0 < count; i--)
+            {
+                pLine[0] = pLine[-1];
+                pLine++;
+                count--;
+            }
+            shift += 8;
+        }
+        else
+        {
+            pLine++;
+            count--;
+            shift = 0;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      1ラインを getc で読み取ります(以前の ReadColor の読み方).
+//-----------------------------------------------------------------------------
+bool ReadColorPerByte(FILE* pFile, RGBE* pLine, int32_t count)
+{
+    if (count < 8 || 0x7fff < count)
+    { return ReadOldColorsPerByte(pFile, pLine, count); }
+
+    auto i = getc(pFile);
+    if (i == EOF)
+    { return false; }
+
+    if (i != 2)
+    {
+        ungetc(i, pFile);
+        return ReadOldColorsPerByte(pFile, pLine, count);
+    }
+
+    pLine[0].v[1] = uint8_t(getc(pFile));
+    pLine[0].v[2] = uint8_t(getc(pFile));
+
+    if ((i = getc(pFile)) == EOF)
+    { return false; }
+
+    if (pLine[0].v[1] != 2 || (pLine[0].v[2] & 128))
+    {
+        pLine[0].v[0] = 2;
+        pLine[0].v[3] = uint8_t(i);
+        return ReadOldColorsPerByte(pFile, pLine + 1, count - 1);
+    }
+
+    if ((pLine[0].v[2] << 8 | i) != count)
+    { return false; }
+
+    for(i=0; i<4; ++i)
+    {
+        for(auto j=0; j<count; )
+        {
+            auto code = getc(pFile);
+            if (code == EOF)
+            { return false; }
+
+            if (128 < code)
+            {
+                code &= 127;
+                if (j + code > count)
+                { return false; }
+
+                auto value = uint8_t(getc(pFile));
+                while(code--)
+                { pLine[j++].v[i] = value; }
+            }
+            else
+            {
+                if (code == 0 || j + code > count)
+                { return false; }
+
+                while(code--)
+                { pLine[j++].v[i] = uint8_t(getc(pFile)); }
+            }
+        }
+    }
+
+    return !feof(pFile);
+}
+
+//-----------------------------------------------------------------------------
+//      1画素ずつ getc で HDR を読み込みます(以前の ReadHdrData の読み方).
+//-----------------------------------------------------------------------------
+bool LoadHDRPerByte(FILE* pFile, asdx::ResTexture& texture)
+{
+    char buf[256];
+    if (fgets(buf, sizeof(buf), pFile) == nullptr || buf[0] != '#' || buf[1] != '?')
+    { return false; }
+
+    auto valid = false;
+    while(fgets(buf, sizeof(buf), pFile) != nullptr && buf[0] != '\n')
+    {
+        if (strcmp(buf, "FORMAT=32-bit_rle_rgbe\n") == 0)
+        { valid = true; }
+    }
+
+    int32_t width  = 0;
+    int32_t height = 0;
+    if (!valid || fgets(buf, sizeof(buf), pFile) == nullptr)
+    { return false; }
+
+    if (sscanf(buf, "-Y %d +X %d", &height, &width) != 2 || width <= 0 || height <= 0)
+    { return false; }
+
+    std::vector<RGBE> line(width);
+    auto pPixels = new (std::nothrow) float [size_t(width) * height * 4];
+    if (pPixels == nullptr)
+    { return false; }
+
+    for(auto y=0; y<height; ++y)
+    {
+        if (!ReadColorPerByte(pFile, line.data(), width))
+        {
+            delete[] pPixels;
+            return false;
+        }
+
+        // 以前と同じく ldexp で1画素ずつ変換する.
+        auto dst = pPixels + size_t(y) * width * 4;
+        for(auto x=0; x<width; ++x)
+        {
+            auto& rgbe = line[x];
+            auto  f    = (rgbe.v[3] != 0) ? ldexp(1.0, int(rgbe.v[3]) - (128 + 8)) : 0.0;
+            dst[x * 4 + 0] = float(rgbe.v[0] * f);
+            dst[x * 4 + 1] = float(rgbe.v[1] * f);
+            dst[x * 4 + 2] = float(rgbe.v[2] * f);
+            dst[x * 4 + 3] = 1.0f;
+        }
+    }
+
+    SetSurface(texture, uint32_t(width), uint32_t(height), FORMAT_R32G32B32A32_FLOAT,
+        sizeof(float) * 4, reinterpret_cast<uint8_t*>(pPixels));
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルを開いてテクスチャを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadFile(const char* path, bool (*loader)(FILE*, asdx::ResTexture&), asdx::ResTexture& texture)
+{
+    auto pFile = fopen(path, "rb");
+    if (pFile == nullptr)
+    { return false; }
+
+    auto ret = loader(pFile, texture);
+    fclose(pFile);
+
+    return ret;
+}
+
+//-----------------------------------------------------------------------------
+//      2つのテクスチャの画素が一致するかチェックします.
+//-----------------------------------------------------------------------------
+bool IsSameTexture(const asdx::ResTexture& lhs, const asdx::ResTexture& rhs)
+{
+    if (lhs.pResources == nullptr || rhs.pResources == nullptr)
+    { return false; }
+
+    auto& a = lhs.pResources[0];
+    auto& b = rhs.pResources[0];
+    return lhs.Format == rhs.Format
+        && a.Width      == b.Width
+        && a.Height     == b.Height
+        && a.SlicePitch == b.SlicePitch
+        && memcmp(a.pPixels, b.pPixels, a.SlicePitch) == 0;
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルに書き出します.
+//-----------------------------------------------------------------------------
+bool WriteFile(const char* path, const std::vector<uint8_t>& data)
+{
+    auto pFile = fopen(path, "wb");
+    if (pFile == nullptr)
+    {
+        fprintf(stderr, "Error : File Open Failed. path = %s\n", path);
+        return false;
+    }
+
+    auto size = fwrite(data.data(), 1, data.size(), pFile);
+    fclose(pFile);
+    return size == data.size();
+}
+
+//-----------------------------------------------------------------------------
+//      リトルエンディアンで16bit値を追加します.
+//-----------------------------------------------------------------------------
+void PushU16(std::vector<uint8_t>& data, uint32_t value)
+{
+    data.push_back(uint8_t(value & 0xff));
+    data.push_back(uint8_t((value >> 8) & 0xff));
+}
+
+//-----------------------------------------------------------------------------
+//      TGAファイルのデータを生成します.
+//-----------------------------------------------------------------------------
+std::vector<uint8_t> MakeTGA(uint32_t width, uint32_t height, uint32_t bytePerPixel, bool rle)
+{
+    // 横方向に同じ色が続く帯とノイズの帯を交互に並べて, RLE のランと生パケットを両方含める.
+    std::mt19937 rng(1357);
+    std::uniform_int_distribution<uint32_t> dist(0, 255);
+
+    std::vector<uint8_t> pixels(width * height * bytePerPixel);
+    for(auto y=0u; y<height; ++y)
+    {
+        for(auto x=0u; x<width; ++x)
+        {
+            auto flat = ((x / 32) & 1) == 0;
+            auto ptr  = &pixels[(y * width + x) * bytePerPixel];
+            for(auto c=0u; c<bytePerPixel; ++c)
+            { ptr[c] = flat ? uint8_t((y + c * 64) & 0xff) : uint8_t(dist(rng)); }
+        }
+    }
+
+    std::vector<uint8_t> data;
+    data.push_back(0);                      // IdFieldLength.
+    data.push_back(0);                      // HasColorMap.
+    data.push_back(rle ? 10 : 2);           // Format.
+    PushU16(data, 0);                       // ColorMapEntry.
+    PushU16(data, 0);                       // ColorMapLength.
+    data.push_back(0);                      // ColorMapEntrySize.
+    PushU16(data, 0);                       // OffsetX.
+    PushU16(data, 0);                       // OffsetY.
+    PushU16(data, width);                   // Width.
+    PushU16(data, height);                  // Height.
+    data.push_back(uint8_t(bytePerPixel * 8));
+    data.push_back(bytePerPixel == 4 ? 0x28 : 0x20);
+
+    if (!rle)
+    { data.insert(data.end(), pixels.begin(), pixels.end()); }
+    else
+    {
+        auto count = width * height;
+        auto same  = [&](uint32_t a, uint32_t b)
+        { return memcmp(&pixels[a * bytePerPixel], &pixels[b * bytePerPixel], bytePerPixel) == 0; };
+
+        uint32_t i = 0;
+        while(i < count)
+        {
+            // 1パケットは最大128画素.
+            uint32_t run = 1;
+            while(i + run < count && run < 128 && same(i, i + run))
+            { run++; }
+
+            if (run >= 2)
+            {
+                data.push_back(uint8_t(0x80 | (run - 1)));
+                data.insert(data.end(), &pixels[i * bytePerPixel], &pixels[i * bytePerPixel] + bytePerPixel);
+                i += run;
+                continue;
+            }
+
+            uint32_t raw = 1;
+            while(i + raw < count && raw < 128 && !(i + raw + 1 < count && same(i + raw, i + raw + 1)))
+            { raw++; }
+
+            data.push_back(uint8_t(raw - 1));
+            data.insert(data.end(), &pixels[i * bytePerPixel], &pixels[(i + raw) * bytePerPixel]);
+            i += raw;
+        }
+    }
+
+    // フッター.
+    for(auto i=0; i<8; ++i)
+    { data.push_back(0); }
+
+    const char kTag[18] = "TRUEVISION-XFILE.";
+    data.insert(data.end(), kTag, kTag + sizeof(kTag));
+
+    return data;
+}
+
+//-----------------------------------------------------------------------------
+//      HDRファイルのデータを生成します.
+//-----------------------------------------------------------------------------
+std::vector<uint8_t> MakeHDR(uint32_t width, uint32_t height)
+{
+    char header[256];
+    sprintf(header, "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\nEXPOSURE=1.0\n\n-Y %u +X %u\n", height, width);
+
+    std::vector<uint8_t> data(header, header + strlen(header));
+
+    // 空のような滑らかなグラデーションに, 太陽のような明るい点を足す.
+    std::vector<uint8_t> line(width * 4);
+    for(auto y=0u; y<height; ++y)
+    {
+        for(auto x=0u; x<width; ++x)
+        {
+            auto dx = float(x) - float(width)  * 0.7f;
+            auto dy = float(y) - float(height) * 0.3f;
+            auto sun = 50.0f * expf(-(dx * dx + dy * dy) * 0.002f);
+
+            float rgb[3] = {
+                0.2f + 0.6f * float(y) / float(height) + sun,
+                0.4f + 0.4f * float(y) / float(height) + sun,
+                0.9f + sun,
+            };
+
+            auto maxValue = std::max(rgb[0], std::max(rgb[1], rgb[2]));
+            int  exponent = 0;
+            auto scale    = frexpf(maxValue, &exponent) * 256.0f / maxValue;
+
+            auto ptr = &line[x * 4];
+            ptr[0] = uint8_t(rgb[0] * scale);
+            ptr[1] = uint8_t(rgb[1] * scale);
+            ptr[2] = uint8_t(rgb[2] * scale);
+            ptr[3] = uint8_t(exponent + 128);
+        }
+
+        // 新形式のランレングス. チャンネル毎に分けて書き出す.
+        data.push_back(2);
+        data.push_back(2);
+        data.push_back(uint8_t(width >> 8));
+        data.push_back(uint8_t(width & 0xff));
+
+        for(auto c=0u; c<4; ++c)
+        {
+            auto value = [&](uint32_t index)
+            { return line[index * 4 + c]; };
+
+            uint32_t i = 0;
+            while(i < width)
+            {
+                uint32_t run = 1;
+                while(i + run < width && run < 127 && value(i + run) == value(i))
+                { run++; }
+
+                if (run >= 3)
+                {
+                    data.push_back(uint8_t(128 + run));
+                    data.push_back(value(i));
+                    i += run;
+                    continue;
+                }
+
+                uint32_t raw = 1;
+                while(i + raw < width && raw < 128
+                   && !(i + raw + 2 < width && value(i + raw) == value(i + raw + 1) && value(i + raw) == value(i + raw + 2)))
+                { raw++; }
+
+                data.push_back(uint8_t(raw));
+                for(auto j=0u; j<raw; ++j)
+                { data.push_back(value(i + j)); }
+                i += raw;
+            }
+        }
+    }
+
+    return data;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      テクスチャローダーのベンチマークを実行します.
+//-----------------------------------------------------------------------------
+void BenchResTexture(asdx::bench::Runner& runner)
+{
+    typedef bool (*Loader)(FILE*, asdx::ResTexture&);
+
+    struct Item
+    {
+        const char* Name;
+        const char* Path;
+        uint32_t    Size;
+        Loader      Decoder;
+        Loader      Baseline;
+        std::vector<uint8_t> (*Make)(uint32_t size);
+    };
+
+    auto makeRGBA32    = [](uint32_t size) { return MakeTGA(size, size, 4, false); };
+    auto makeRGB24     = [](uint32_t size) { return MakeTGA(size, size, 3, false); };
+    auto makeRLERGBA32 = [](uint32_t size) { return MakeTGA(size, size, 4, true);  };
+    auto makeRLERGB24  = [](uint32_t size) { return MakeTGA(size, size, 3, true);  };
+    auto makeHDR       = [](uint32_t size) { return MakeHDR(size, size); };
+
+    // 8K は生成だけで 1GB 近く使うので, 短縮実行では小さくする.
+    const uint32_t kSize  = runner.IsQuick() ? 128 : 1024;
+    const uint32_t kLarge = runner.IsQuick() ? 256 : 8192;
+
+    auto tga = &asdx::CreateResTextureFromTGAFile;
+    auto hdr = &asdx::CreateResTextureFromHDRFile;
+
+    // ファイルはページキャッシュに載った状態で読むので, 主に展開処理の速度になる.
+    // 各項目は以前の1バイトずつ読む実装(PerByte)と比べる.
+    const Item items[] = {
+        { "ResTexture/TGA(RGBA32)",     "asdx12_bench_rgba32.tga",      kSize,  tga, LoadTGAPerByte, makeRGBA32    },
+        { "ResTexture/TGA(RGB24)",      "asdx12_bench_rgb24.tga",       kSize,  tga, LoadTGAPerByte, makeRGB24     },
+        { "ResTexture/TGA(RLE,RGBA32)", "asdx12_bench_rle_rgba32.tga",  kSize,  tga, LoadTGAPerByte, makeRLERGBA32 },
+        { "ResTexture/TGA(RLE,RGB24)",  "asdx12_bench_rle_rgb24.tga",   kSize,  tga, LoadTGAPerByte, makeRLERGB24  },
+        { "ResTexture/HDR(RLE)",        "asdx12_bench_rle.hdr",         kSize,  hdr, LoadHDRPerByte, makeHDR       },
+        { "ResTexture/TGA(RGBA32,8K)",  "asdx12_bench_8k_rgba32.tga",   kLarge, tga, LoadTGAPerByte, makeRGBA32    },
+        { "ResTexture/HDR(RLE,8K)",     "asdx12_bench_8k_rle.hdr",      kLarge, hdr, LoadHDRPerByte, makeHDR       },
+    };
+
+    for(auto& item : items)
+    {
+        // 書き出したらすぐに解放して, 計測中のメモリを抑える.
+        if (!WriteFile(item.Path, item.Make(item.Size)))
+        { continue; }
+
+        asdx::ResTexture texture;
+        asdx::ResTexture baseline;
+        if (!LoadFile(item.Path, item.Decoder, texture) || !LoadFile(item.Path, item.Baseline, baseline))
+        {
+            fprintf(stderr, "Error : Texture Load Failed. path = %s\n", item.Path);
+            texture .Dispose();
+            baseline.Dispose();
+            remove(item.Path);
+            continue;
+        }
+
+        // 読み方に依らず同じ画素になる.
+        auto same = IsSameTexture(texture, baseline);
+        if (!same)
+        { fprintf(stderr, "Error : Decoded Pixels Mismatch. path = %s\n", item.Path); }
+
+        texture .Dispose();
+        baseline.Dispose();
+
+        // 1操作 = 1画素.
+        const uint64_t kPixels = uint64_t(item.Size) * item.Size;
+
+        char name[64];
+        sprintf(name, "%s/PerByte", item.Name);
+        runner.Run(name, kPixels, [&](uint64_t ops)
+        {
+            for(uint64_t n=0; n<ops; n+=kPixels)
+            {
+                LoadFile(item.Path, item.Baseline, baseline);
+                baseline.Dispose();
+            }
+        });
+
+        runner.Run(item.Name, kPixels, [&](uint64_t ops)
+        {
+            for(uint64_t n=0; n<ops; n+=kPixels)
+            {
+                LoadFile(item.Path, item.Decoder, texture);
+                texture.Dispose();
+            }
+        });
+        runner.SetMetric("same_as_per_byte", same ? 1.0 : 0.0);
+
+        remove(item.Path);
+    }
+}
@@ -0,0 +1,232 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchTokenizer.cpp
+// Desc : Tokenizer Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <random>
+#include <fnd/asdxTokenizer.h>
+#include "asdxBench.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      OBJ形式のテキストを生成します.
+//-----------------------------------------------------------------------------
+std::string MakeObjText(uint32_t vertexCount, uint32_t& lineCount)
+{
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    std::uniform_int_distribution<uint32_t> index(1, vertexCount);
+
+    std::string text;
+    char line[256];
+
+    lineCount = 0;
+    for(auto i=0u; i<vertexCount; ++i)
+    {
+        sprintf(line, "v %.6f %.6f %.6f\n", dist(rng), dist(rng), dist(rng));
+        text += line;
+        sprintf(line, "vn %.4f %.4f %.4f\n", dist(rng) * 0.01f, dist(rng) * 0.01f, dist(rng) * 0.01f);
+        text += line;
+        sprintf(line, "vt %.5f %.5f\n", dist(rng) * 0.005f + 0.5f, dist(rng) * 0.005f + 0.5f);
+        text += line;
+        lineCount += 3;
+    }
+
+    for(auto i=0u; i<vertexCount * 2; ++i)
+    {
+        auto a = index(rng);
+        auto b = index(rng);
+        auto c = index(rng);
+        sprintf(line, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c);
+        text += line;
+        lineCount++;
+    }
+
+    return text;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ParseSum structure
+///////////////////////////////////////////////////////////////////////////////
+struct ParseSum
+{
+    double      Value = 0.0;    //!< 実数の合計.
+    uint64_t    Index = 0;      //!< インデックスの合計.
+};
+
+//-----------------------------------------------------------------------------
+//      Tokenizer で解析します.
+//-----------------------------------------------------------------------------
+ParseSum ParseWithTokenizer(asdx::Tokenizer& tokenizer, std::string& text)
+{
+    ParseSum sum;
+
+    tokenizer.SetBuffer(&text[0], text.size());
+    while(!tokenizer.IsEnd())
+    {
+        if (tokenizer.Compare("v") || tokenizer.Compare("vn"))
+        {
+            sum.Value += tokenizer.NextAsFloat();
+            sum.Value += tokenizer.NextAsFloat();
+            sum.Value += tokenizer.NextAsFloat();
+        }
+        else if (tokenizer.Compare("vt"))
+        {
+            sum.Value += tokenizer.NextAsFloat();
+            sum.Value += tokenizer.NextAsFloat();
+        }
+        else if (tokenizer.Compare("f"))
+        {
+            for(auto i=0; i<3; ++i)
+            {
+                sum.Index += tokenizer.NextAsUint();
+                tokenizer.Next();   // '/'
+                sum.Index += tokenizer.NextAsUint();
+                tokenizer.Next();   // '/'
+                sum.Index += tokenizer.NextAsUint();
+            }
+        }
+
+        tokenizer.Next();
+    }
+
+    return sum;
+}
+
+//-----------------------------------------------------------------------------
+//      ViewTokenizer と FromChars で解析します.
+//-----------------------------------------------------------------------------
+ParseSum ParseWithViewTokenizer(asdx::ViewTokenizer& tokenizer, const std::string& text)
+{
+    ParseSum sum;
+
+    auto nextFloat = [&tokenizer]()
+    { return tokenizer.NextInLine() ? tokenizer.GetAsFloat() : 0.0f; };
+
+    tokenizer.SetBuffer(text.data(), text.size());
+    while(tokenizer.Next())
+    {
+        if (tokenizer.Compare("v") || tokenizer.Compare("vn"))
+        {
+            sum.Value += nextFloat();
+            sum.Value += nextFloat();
+            sum.Value += nextFloat();
+        }
+        else if (tokenizer.Compare("vt"))
+        {
+            sum.Value += nextFloat();
+            sum.Value += nextFloat();
+        }
+        else if (tokenizer.Compare("f"))
+        {
+            while(tokenizer.NextInLine())
+            {
+                auto& token = tokenizer.GetToken();
+                auto  ptr   = token.data();
+                while(ptr < token.end())
+                {
+                    uint32_t value = 0;
+                    auto ret = asdx::FromChars(ptr, token.end(), value);
+                    if (!ret.Success)
+                    { break; }
+
+                    sum.Index += value;
+                    ptr = ret.Ptr + 1;  // '/' を飛ばす.
+                }
+            }
+        }
+
+        tokenizer.SkipLine();
+    }
+
+    return sum;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      トークナイザーのベンチマークを実行します.
+//-----------------------------------------------------------------------------
+void BenchTokenizer(asdx::bench::Runner& runner)
+{
+    uint32_t lineCount = 0;
+    auto text = MakeObjText(runner.IsQuick() ? 1024 : 32 * 1024, lineCount);
+
+    asdx::Tokenizer tokenizer;
+    tokenizer.Init(256);
+    tokenizer.SetSeparator(" \t\r\n");
+    tokenizer.SetCutOff("/");
+
+    asdx::ViewTokenizer viewTokenizer;
+
+    // 計測前に両者が同じ結果になることを確認しておく.
+    {
+        auto a = ParseWithTokenizer(tokenizer, text);
+        auto b = ParseWithViewTokenizer(viewTokenizer, text);
+        if (a.Index != b.Index || fabs(a.Value - b.Value) > 1e-3 * fabs(a.Value))
+        {
+            fprintf(stderr, "Error : Tokenizer Result Not Match. index = %llu / %llu, value = %f / %f\n",
+                static_cast<unsigned long long>(a.Index), static_cast<unsigned long long>(b.Index), a.Value, b.Value);
+        }
+    }
+
+    // 1操作 = 1行.
+    runner.Run("Tokenizer/OBJ(Tokenizer+strtof)", lineCount, [&](uint64_t ops)
+    {
+        for(uint64_t n=0; n<ops; n+=lineCount)
+        { asdx::bench::DoNotOptimize(ParseWithTokenizer(tokenizer, text)); }
+    });
+
+    runner.Run("Tokenizer/OBJ(ViewTokenizer+FromChars)", lineCount, [&](uint64_t ops)
+    {
+        for(uint64_t n=0; n<ops; n+=lineCount)
+        { asdx::bench::DoNotOptimize(ParseWithViewTokenizer(viewTokenizer, text)); }
+    });
+
+    tokenizer.Term();
+
+    // 数値変換だけの比較.
+    std::mt19937 rng(8765);
+    std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+
+    const size_t kCount = 4096;
+    std::string numbers;
+    std::vector<size_t> offsets(kCount);
+    for(size_t i=0; i<kCount; ++i)
+    {
+        char buf[64];
+        sprintf(buf, "%.6f", dist(rng));
+        offsets[i] = numbers.size();
+        numbers += buf;
+        numbers += ' ';
+    }
+
+    runner.Run("Tokenizer/Float(strtof)", kCount * 64, [&](uint64_t ops)
+    {
+        float sum = 0.0f;
+        for(uint64_t n=0; n<ops; ++n)
+        { sum += strtof(numbers.data() + offsets[n % kCount], nullptr); }
+        asdx::bench::DoNotOptimize(sum);
+    });
+
+    runner.Run("Tokenizer/Float(FromChars)", kCount * 64, [&](uint64_t ops)
+    {
+        auto last = numbers.data() + numbers.size();
+        float sum = 0.0f;
+        for(uint64_t n=0; n<ops; ++n)
+        {
+            float value = 0.0f;
+            asdx::FromChars(numbers.data() + offsets[n % kCount], last, value);
+            sum += value;
+        }
+        asdx::bench::DoNotOptimize(sum);
+    });
+}
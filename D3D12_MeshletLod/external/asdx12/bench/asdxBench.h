@@ -0,0 +1,323 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxBench.h
+// Desc : Micro Benchmark Harness.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace asdx {
+namespace bench {
+
+//-----------------------------------------------------------------------------
+//! @brief      最適化で計算が消されないように値を使用済みにします.
+//-----------------------------------------------------------------------------
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+    static const void* volatile s_Sink = nullptr;
+    s_Sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      メモリへの書き込みが消されないようにします.
+//-----------------------------------------------------------------------------
+inline void ClobberMemory()
+{
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Result structure
+///////////////////////////////////////////////////////////////////////////////
+struct Result
+{
+    std::string     Name;           //!< ベンチマーク名.
+    uint64_t        Ops;            //!< 1サンプルあたりの操作数.
+    uint32_t        Samples;        //!< サンプル数.
+    double          MinNs;          //!< 1操作あたりの最小時間[ns].
+    double          MedianNs;       //!< 1操作あたりの中央値[ns].
+    double          MeanNs;         //!< 1操作あたりの平均値[ns].
+    std::vector<std::pair<std::string, double>> Metrics;    //!< 時間以外の計測値(画質など).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Runner class
+///////////////////////////////////////////////////////////////////////////////
+class Runner
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コマンドライン引数を解析します.
+    //!
+    //! @param[in]      suite       スイート名.
+    //! @param[in]      argc        引数の数.
+    //! @param[in]      argv        引数.
+    //! @retval true    解析に成功.
+    //! @retval false   解析に失敗.
+    //-------------------------------------------------------------------------
+    bool Init(const char* suite, int argc, char** argv)
+    {
+        m_Suite = suite;
+
+        for(auto i=1; i<argc; ++i)
+        {
+            auto arg  = argv[i];
+            auto next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+            if (strcmp(arg, "--quick") == 0)
+            { m_Quick = true; }
+            else if (strcmp(arg, "--filter") == 0 && next != nullptr)
+            { m_Filter = next; ++i; }
+            else if (strcmp(arg, "--json") == 0 && next != nullptr)
+            { m_JsonPath = next; ++i; }
+            else if (strcmp(arg, "--csv") == 0 && next != nullptr)
+            { m_CsvPath = next; ++i; }
+            else if (strcmp(arg, "--samples") == 0 && next != nullptr)
+            { m_Samples = std::max(1, atoi(next)); ++i; }
+            else
+            {
+                printf("Usage : %s [--quick] [--filter <text>] [--samples <count>] [--json <path>] [--csv <path>]\n", argv[0]);
+                return false;
+            }
+        }
+
+        if (m_Quick)
+        { m_Samples = 1; }
+
+        printf("%-48s %12s %12s %12s\n", "name", "min[ns]", "median[ns]", "mean[ns]");
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      短縮実行かどうかを取得します.
+    //!
+    //! @note       CTest からの動作確認用で, 操作数を減らして1回だけ計測します.
+    //-------------------------------------------------------------------------
+    bool IsQuick() const
+    { return m_Quick; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ベンチマークを実行します.
+    //!
+    //! @param[in]      name        ベンチマーク名.
+    //! @param[in]      ops         1サンプルあたりの操作数.
+    //! @param[in]      func        計測処理. 引数で渡される操作数を処理してください.
+    //-------------------------------------------------------------------------
+    template<typename Func>
+    void Run(const char* name, uint64_t ops, Func func)
+    {
+        m_LastRun = false;
+        if (!m_Filter.empty() && strstr(name, m_Filter.c_str()) == nullptr)
+        { return; }
+
+        if (m_Quick)
+        { ops = std::max<uint64_t>(1, ops / 64); }
+
+        // キャッシュとページを温めておく.
+        func(ops);
+
+        std::vector<double> times(m_Samples);
+        for(auto& time : times)
+        {
+            auto begin = Clock::now();
+            func(ops);
+            auto end = Clock::now();
+            time = std::chrono::duration<double, std::nano>(end - begin).count() / double(ops);
+        }
+
+        std::sort(times.begin(), times.end());
+
+        double sum = 0.0;
+        for(auto& time : times)
+        { sum += time; }
+
+        Result result;
+        result.Name     = name;
+        result.Ops      = ops;
+        result.Samples  = m_Samples;
+        result.MinNs    = times.front();
+        result.MedianNs = times[times.size() / 2];
+        result.MeanNs   = sum / double(times.size());
+
+        printf("%-48s %12.3f %12.3f %12.3f\n", name, result.MinNs, result.MedianNs, result.MeanNs);
+        fflush(stdout);
+
+        m_Results.push_back(result);
+        m_LastRun = true;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      直前に実行したベンチマークに時間以外の計測値を追加します.
+    //!
+    //! @param[in]      key         名前.
+    //! @param[in]      value       値.
+    //! @note       直前のベンチマークがフィルタで除外された場合は何もしません.
+    //-------------------------------------------------------------------------
+    void SetMetric(const char* key, double value)
+    {
+        if (!m_LastRun)
+        { return; }
+
+        printf("    %-44s %12.3f\n", key, value);
+        m_Results.back().Metrics.emplace_back(key, value);
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      計測結果を出力します.
+    //!
+    //! @retval 0   出力に成功.
+    //! @retval 1   出力に失敗.
+    //-------------------------------------------------------------------------
+    int Finish() const
+    {
+        auto ret = 0;
+
+        if (!m_JsonPath.empty() && !WriteJson(m_JsonPath.c_str()))
+        { ret = 1; }
+
+        if (!m_CsvPath.empty() && !WriteCsv(m_CsvPath.c_str()))
+        { ret = 1; }
+
+        return ret;
+    }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    using Clock = std::chrono::steady_clock;
+
+    std::string             m_Suite;                //!< スイート名.
+    std::string             m_Filter;               //!< 名前で絞り込む文字列.
+    std::string             m_JsonPath;             //!< JSON 出力先.
+    std::string             m_CsvPath;              //!< CSV 出力先.
+    int                     m_Samples   = 9;        //!< サンプル数.
+    bool                    m_Quick     = false;    //!< 短縮実行.
+    bool                    m_LastRun   = false;    //!< 直前のベンチマークを実行したかどうか?
+    std::vector<Result>     m_Results;              //!< 計測結果.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      JSON形式で出力します.
+    //-------------------------------------------------------------------------
+    bool WriteJson(const char* path) const
+    {
+        auto pFile = fopen(path, "w");
+        if (pFile == nullptr)
+        {
+            fprintf(stderr, "Error : File Open Failed. path = %s\n", path);
+            return false;
+        }
+
+        fprintf(pFile, "{\n");
+        fprintf(pFile, "  \"suite\": \"%s\",\n", m_Suite.c_str());
+        fprintf(pFile, "  \"quick\": %s,\n", m_Quick ? "true" : "false");
+        fprintf(pFile, "  \"results\": [\n");
+        for(size_t i=0; i<m_Results.size(); ++i)
+        {
+            auto& r = m_Results[i];
+            fprintf(pFile, "    { \"name\": \"%s\", \"ops\": %llu, \"samples\": %u, \"min_ns\": %.4f, \"median_ns\": %.4f, \"mean_ns\": %.4f",
+                r.Name.c_str(), static_cast<unsigned long long>(r.Ops), r.Samples,
+                r.MinNs, r.MedianNs, r.MeanNs);
+
+            if (!r.Metrics.empty())
+            {
+                fprintf(pFile, ", \"metrics\": {");
+                for(size_t j=0; j<r.Metrics.size(); ++j)
+                {
+                    // JSON は無限大を表せないので null にする.
+                    auto& m = r.Metrics[j];
+                    if (std::isfinite(m.second))
+                    { fprintf(pFile, "%s \"%s\": %.4f", (j > 0) ? "," : "", m.first.c_str(), m.second); }
+                    else
+                    { fprintf(pFile, "%s \"%s\": null", (j > 0) ? "," : "", m.first.c_str()); }
+                }
+                fprintf(pFile, " }");
+            }
+
+            fprintf(pFile, " }%s\n", (i + 1 < m_Results.size()) ? "," : "");
+        }
+        fprintf(pFile, "  ]\n");
+        fprintf(pFile, "}\n");
+
+        fclose(pFile);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      CSV形式で出力します.
+    //-------------------------------------------------------------------------
+    bool WriteCsv(const char* path) const
+    {
+        auto pFile = fopen(path, "w");
+        if (pFile == nullptr)
+        {
+            fprintf(stderr, "Error : File Open Failed. path = %s\n", path);
+            return false;
+        }
+
+        fprintf(pFile, "suite,name,ops,samples,min_ns,median_ns,mean_ns,metrics\n");
+        for(auto& r : m_Results)
+        {
+            fprintf(pFile, "%s,%s,%llu,%u,%.4f,%.4f,%.4f,",
+                m_Suite.c_str(), r.Name.c_str(), static_cast<unsigned long long>(r.Ops), r.Samples,
+                r.MinNs, r.MedianNs, r.MeanNs);
+
+            // 計測値は "名前=値" を ';' で区切って1列にまとめる.
+            for(size_t j=0; j<r.Metrics.size(); ++j)
+            { fprintf(pFile, "%s%s=%.4f", (j > 0) ? ";" : "", r.Metrics[j].first.c_str(), r.Metrics[j].second); }
+
+            fprintf(pFile, "\n");
+        }
+
+        fclose(pFile);
+        return true;
+    }
+};
+
+} // namespace bench
+} // namespace asdx
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+#------------------------------------------------------------------------------
+# File : compare_bench.py
+# Desc : Compare Benchmark Results.
+# Copyright(c) Project Asura. All right reserved.
+#------------------------------------------------------------------------------
+# 使い方:
+#   asdx12_bench --json base.json      (変更前)
+#   asdx12_bench --json head.json      (変更後)
+#   python compare_bench.py base.json head.json --threshold 5
+#
+# 中央値が閾値[%]より遅くなったベンチマークがあれば終了コード 1 を返します.
+# JSON と CSV のどちらの出力でも比較できます.
+# PSNR などの時間以外の計測値は差分を表示するだけで, 終了コードには影響しません.
+import argparse
+import csv
+import json
+import sys
+
+
+def load(path):
+    """ベンチマーク名から中央値[ns]と計測値への辞書を読み込みます."""
+    medians = {}
+    metrics = {}
+    if path.lower().endswith('.csv'):
+        with open(path, newline='') as f:
+            for row in csv.DictReader(f):
+                medians[row['name']] = float(row['median_ns'])
+                values = {}
+                for pair in (row.get('metrics') or '').split(';'):
+                    if '=' in pair:
+                        key, value = pair.split('=', 1)
+                        values[key] = float(value)
+                metrics[row['name']] = values
+    else:
+        with open(path) as f:
+            data = json.load(f)
+        for item in data['results']:
+            medians[item['name']] = float(item['median_ns'])
+            values = {}
+            for key, value in item.get('metrics', {}).items():
+                values[key] = float('inf') if value is None else float(value)
+            metrics[item['name']] = values
+    return medians, metrics
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare benchmark results.')
+    parser.add_argument('base', help='baseline result (.json or .csv)')
+    parser.add_argument('head', help='current result (.json or .csv)')
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='allowed slowdown of the median in percent (default: 5)')
+    parser.add_argument('--filter', default='', help='compare only names containing this text')
+    args = parser.parse_args()
+
+    base, base_metrics = load(args.base)
+    head, head_metrics = load(args.head)
+
+    names = [name for name in base if name in head and args.filter in name]
+    width = max([len(name) for name in set(base) | set(head) if args.filter in name] + [4])
+
+    print('%-*s %12s %12s %9s' % (width, 'name', 'base[ns]', 'head[ns]', 'diff[%]'))
+
+    regressions = []
+    for name in names:
+        b = base[name]
+        h = head[name]
+        diff = (h - b) / b * 100.0 if b > 0.0 else 0.0
+        mark = ''
+        if diff > args.threshold:
+            mark = '  REGRESSION'
+            regressions.append(name)
+        elif diff < -args.threshold:
+            mark = '  improved'
+        print('%-*s %12.3f %12.3f %+9.2f%s' % (width, name, b, h, diff, mark))
+
+        for key in sorted(set(base_metrics[name]) & set(head_metrics[name])):
+            mb = base_metrics[name][key]
+            mh = head_metrics[name][key]
+            print('%-*s %12.3f %12.3f %+9.3f' % (width, '  ' + key, mb, mh, mh - mb))
+
+    for name in sorted(set(base) - set(head)):
+        if args.filter in name:
+            print('%-*s %12.3f %12s %9s  removed' % (width, name, base[name], '-', '-'))
+    for name in sorted(set(head) - set(base)):
+        if args.filter in name:
+            print('%-*s %12s %12.3f %9s  added' % (width, name, '-', head[name], '-'))
+
+    if regressions:
+        print('\n%d regression(s) over %.1f%%:' % (len(regressions), args.threshold))
+        for name in regressions:
+            print('  ' + name)
+        return 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,43 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Benchmark Entry Point.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "asdxBench.h"
+
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+void BenchFnd(asdx::bench::Runner& runner);
+void BenchTokenizer(asdx::bench::Runner& runner);
+void BenchLogger(asdx::bench::Runner& runner);
+void BenchProfiler(asdx::bench::Runner& runner);
+void BenchBlockCompression(asdx::bench::Runner& runner);
+void BenchResModel(asdx::bench::Runner& runner);
+void BenchResTexture(asdx::bench::Runner& runner);
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    asdx::bench::Runner runner;
+    if (!runner.Init("asdx12", argc, argv))
+    { return 1; }
+
+    BenchFnd(runner);
+    BenchTokenizer(runner);
+    BenchLogger(runner);
+    BenchProfiler(runner);
+    BenchBlockCompression(runner);
+    BenchResModel(runner);
+    BenchResTexture(runner);
+
+    return runner.Finish();
+}
@@ -8,6 +8,7 @@
 //-----------------------------------------------------------------------------
 // Includes
 //-----------------------------------------------------------------------------
+#include <cstdint>
 #include <atomic>
 #include <thread>
 #include <list>
@@ -16,6 +17,11 @@
 
 namespace asdx {
 
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+struct FileEventQueue;
+
 ///////////////////////////////////////////////////////////////////////////////
 // ACTION_TYPE enum
 ///////////////////////////////////////////////////////////////////////////////
@@ -76,6 +82,8 @@ public:
         size_t      BufferSize;         //!< obt@TCY.
         uint32_t    WaitTimeMsec;       //!< 1[v̑ҋ@(~bP)
         std::list<IFileUpdateListener*> pListeners; //!< ύXʒm.
+        bool        Recursive    = true;    //!< TufBNgĎ邩ǂ?
+        uint32_t    CoalesceMsec = 100;     //!< t@Cւ̕ύX܂Ƃ߂鎞(~bP).
     };
 
     //=========================================================================
@@ -111,12 +119,22 @@ public:
     //-------------------------------------------------------------------------
     void Term();
 
+    //-------------------------------------------------------------------------
+    //! @brief      ܂Ƃ߂ύXXi[ɒʒm܂.
+    //!
+    //! @return     ʒmCxgԋp܂.
+    //! @note       CXbh疈t[ĂяoĂ.
+    //!             Ō̕ύX CoalesceMsec o߂t@C1ʒm܂.
+    //-------------------------------------------------------------------------
+    uint32_t Dispatch();
+
 private:
     //=========================================================================
     // private variables.
     //=========================================================================
     std::atomic<bool> m_Finish  = {};       //!< ItO.
     std::thread*      m_pThread = nullptr;  //!< ĎXbh.
+    FileEventQueue*   m_pQueue  = nullptr;  //!< ĎXbh󂯎CxgL[.
 
     //=========================================================================
     // private methods.
@@ -10,6 +10,10 @@
 //-----------------------------------------------------------------------------
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
 
 namespace asdx {
 
@@ -37,6 +41,7 @@ inline uint32_t CalcHash(const uint8_t* buffer, uint32_t size)
 //! 
 //! @param[in]      buffer      文字列.
 //! @return     ハッシュ値を返却します.
+//! @note       終端文字まで1回の走査で計算します.
 //-----------------------------------------------------------------------------
 inline uint32_t CalcHash(const char* buffer)
 {
@@ -44,11 +49,460 @@ inline uint32_t CalcHash(const char* buffer)
     const uint32_t kPrime   = 16777619;
 
     auto hash = kOffset;
-    auto size = strlen(buffer);
-    for(auto i=0u; i<size; ++i)
-    { hash = (kPrime * hash) ^ buffer[i]; }
+    for(auto ptr = buffer; *ptr != '\0'; ++ptr)
+    { hash = (kPrime * hash) ^ *ptr; }
 
     return hash;
 }
 
+
+namespace detail {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr uint64_t kHashSecret0 = 0x2d358dccaa6c78a5ull;
+constexpr uint64_t kHashSecret1 = 0x8bb84b93962eacc9ull;
+constexpr uint64_t kHashSecret2 = 0x4b33a62ed433d4a3ull;
+constexpr uint64_t kHashSecret3 = 0x4d5a2da51de1aa47ull;
+
+//-----------------------------------------------------------------------------
+//      64bit x 64bit の乗算結果の下位を a に, 上位を b に格納します.
+//-----------------------------------------------------------------------------
+inline void HashMul(uint64_t& a, uint64_t& b)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    uint64_t hi = 0;
+    a = _umul128(a, b, &hi);
+    b = hi;
+#elif defined(__SIZEOF_INT128__)
+    auto r = static_cast<unsigned __int128>(a) * b;
+    a = uint64_t(r);
+    b = uint64_t(r >> 64);
+#else
+    auto lo = a * b;
+    auto ah = a >> 32; auto al = a & 0xffffffffull;
+    auto bh = b >> 32; auto bl = b & 0xffffffffull;
+    auto m  = ah * bl + ((al * bl) >> 32);
+    a = lo;
+    b = ah * bh + (m >> 32) + ((al * bh + (m & 0xffffffffull)) >> 32);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      64bit x 64bit の乗算結果を下位と上位で XOR します.
+//-----------------------------------------------------------------------------
+inline uint64_t HashMix(uint64_t a, uint64_t b)
+{
+    HashMul(a, b);
+    return a ^ b;
+}
+
+//-----------------------------------------------------------------------------
+//      64bit x 64bit の乗算結果の上位を求めます(コンパイル時評価用).
+//-----------------------------------------------------------------------------
+constexpr uint64_t HashMulHiConst(uint64_t a, uint64_t b)
+{
+    return (a >> 32) * (b >> 32)
+         + (((a >> 32) * (b & 0xffffffffull) + (((a & 0xffffffffull) * (b & 0xffffffffull)) >> 32)) >> 32)
+         + (((a & 0xffffffffull) * (b >> 32)
+           + (((a >> 32) * (b & 0xffffffffull) + (((a & 0xffffffffull) * (b & 0xffffffffull)) >> 32)) & 0xffffffffull)) >> 32);
+}
+
+//-----------------------------------------------------------------------------
+//      64bit x 64bit の乗算結果を下位と上位で XOR します(コンパイル時評価用).
+//-----------------------------------------------------------------------------
+constexpr uint64_t HashMixConst(uint64_t a, uint64_t b)
+{ return (a * b) ^ HashMulHiConst(a, b); }
+
+//-----------------------------------------------------------------------------
+//      リトルエンディアンで 8byte 読み込みます.
+//-----------------------------------------------------------------------------
+inline uint64_t HashRead8(const uint8_t* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+//-----------------------------------------------------------------------------
+//      リトルエンディアンで 4byte 読み込みます.
+//-----------------------------------------------------------------------------
+inline uint64_t HashRead4(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+//-----------------------------------------------------------------------------
+//      リトルエンディアンで 8byte 読み込みます(コンパイル時評価用).
+//-----------------------------------------------------------------------------
+constexpr uint64_t HashRead8Const(const char* p)
+{
+    return  uint64_t(uint8_t(p[0]))        | (uint64_t(uint8_t(p[1])) << 8)
+         | (uint64_t(uint8_t(p[2])) << 16) | (uint64_t(uint8_t(p[3])) << 24)
+         | (uint64_t(uint8_t(p[4])) << 32) | (uint64_t(uint8_t(p[5])) << 40)
+         | (uint64_t(uint8_t(p[6])) << 48) | (uint64_t(uint8_t(p[7])) << 56);
+}
+
+//-----------------------------------------------------------------------------
+//      リトルエンディアンで 4byte 読み込みます(コンパイル時評価用).
+//-----------------------------------------------------------------------------
+constexpr uint64_t HashRead4Const(const char* p)
+{
+    return  uint64_t(uint8_t(p[0]))        | (uint64_t(uint8_t(p[1])) << 8)
+         | (uint64_t(uint8_t(p[2])) << 16) | (uint64_t(uint8_t(p[3])) << 24);
+}
+
+} // namespace detail
+
+
+//-----------------------------------------------------------------------------
+//! @brief      64bitハッシュ値を計算します.
+//!
+//! @param[in]      buffer      バッファ.
+//! @param[in]      size        バッファサイズ.
+//! @param[in]      seed        シード値.
+//! @return     ハッシュ値を返却します.
+//! @note       wyhash 方式で 1回のループで 48byte ずつ処理します.
+//!             実行環境のエンディアンに依存するので, ファイルに保存する値には使用しないでください.
+//-----------------------------------------------------------------------------
+inline uint64_t CalcHash64(const void* buffer, size_t size, uint64_t seed = 0)
+{
+    using namespace detail;
+
+    auto p = static_cast<const uint8_t*>(buffer);
+    seed ^= HashMix(seed ^ kHashSecret0, kHashSecret1);
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (size <= 16)
+    {
+        if (size >= 4)
+        {
+            auto offset = (size >> 3) << 2;
+            a = (HashRead4(p) << 32) | HashRead4(p + offset);
+            b = (HashRead4(p + size - 4) << 32) | HashRead4(p + size - 4 - offset);
+        }
+        else if (size > 0)
+        {
+            a = (uint64_t(p[0]) << 16) | (uint64_t(p[size >> 1]) << 8) | p[size - 1];
+        }
+    }
+    else
+    {
+        auto i = size;
+        if (i >= 48)
+        {
+            auto see1 = seed;
+            auto see2 = seed;
+            do
+            {
+                seed = HashMix(HashRead8(p)      ^ kHashSecret1, HashRead8(p + 8)  ^ seed);
+                see1 = HashMix(HashRead8(p + 16) ^ kHashSecret2, HashRead8(p + 24) ^ see1);
+                see2 = HashMix(HashRead8(p + 32) ^ kHashSecret3, HashRead8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while(i >= 48);
+            seed ^= see1 ^ see2;
+        }
+
+        while(i > 16)
+        {
+            seed = HashMix(HashRead8(p) ^ kHashSecret1, HashRead8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        a = HashRead8(p + i - 16);
+        b = HashRead8(p + i - 8);
+    }
+
+    a ^= kHashSecret1;
+    b ^= seed;
+    HashMul(a, b);
+    return HashMix(a ^ kHashSecret0 ^ size, b ^ kHashSecret1);
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      文字列の64bitハッシュ値を計算します.
+//!
+//! @param[in]      str         文字列.
+//! @return     ハッシュ値を返却します.
+//-----------------------------------------------------------------------------
+inline uint64_t CalcHash64(const char* str)
+{ return CalcHash64(str, strlen(str)); }
+
+//-----------------------------------------------------------------------------
+//! @brief      文字列の64bitハッシュ値をコンパイル時に計算します.
+//!
+//! @param[in]      str         文字列.
+//! @param[in]      size        文字数.
+//! @param[in]      seed        シード値.
+//! @return     CalcHash64() と同じハッシュ値を返却します.
+//! @note       実行時に呼び出すと CalcHash64() より低速です.
+//-----------------------------------------------------------------------------
+constexpr uint64_t CalcConstHash64(const char* str, size_t size, uint64_t seed = 0)
+{
+    using namespace detail;
+
+    seed ^= HashMixConst(seed ^ kHashSecret0, kHashSecret1);
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (size <= 16)
+    {
+        if (size >= 4)
+        {
+            size_t offset = (size >> 3) << 2;
+            a = (HashRead4Const(str) << 32) | HashRead4Const(str + offset);
+            b = (HashRead4Const(str + size - 4) << 32) | HashRead4Const(str + size - 4 - offset);
+        }
+        else if (size > 0)
+        {
+            a = (uint64_t(uint8_t(str[0])) << 16)
+              | (uint64_t(uint8_t(str[size >> 1])) << 8)
+              |  uint64_t(uint8_t(str[size - 1]));
+        }
+    }
+    else
+    {
+        size_t i = size;
+        size_t p = 0;
+        if (i >= 48)
+        {
+            auto see1 = seed;
+            auto see2 = seed;
+            do
+            {
+                seed = HashMixConst(HashRead8Const(str + p)      ^ kHashSecret1, HashRead8Const(str + p + 8)  ^ seed);
+                see1 = HashMixConst(HashRead8Const(str + p + 16) ^ kHashSecret2, HashRead8Const(str + p + 24) ^ see1);
+                see2 = HashMixConst(HashRead8Const(str + p + 32) ^ kHashSecret3, HashRead8Const(str + p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while(i >= 48);
+            seed ^= see1 ^ see2;
+        }
+
+        while(i > 16)
+        {
+            seed = HashMixConst(HashRead8Const(str + p) ^ kHashSecret1, HashRead8Const(str + p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        a = HashRead8Const(str + p + i - 16);
+        b = HashRead8Const(str + p + i - 8);
+    }
+
+    a ^= kHashSecret1;
+    b ^= seed;
+    return HashMixConst((a * b) ^ kHashSecret0 ^ size, HashMulHiConst(a, b) ^ kHashSecret1);
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      文字列の64bitハッシュ値をコンパイル時に計算します.
+//!
+//! @param[in]      str         終端文字付きの文字列.
+//! @return     CalcHash64() と同じハッシュ値を返却します.
+//-----------------------------------------------------------------------------
+constexpr uint64_t CalcConstHash64(const char* str)
+{
+    size_t size = 0;
+    while(str[size] != '\0')
+    { size++; }
+
+    return CalcConstHash64(str, size);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// StringId class
+///////////////////////////////////////////////////////////////////////////////
+class StringId
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    constexpr StringId()
+    : m_Hash(0)
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ハッシュ値を指定して生成します.
+    //!
+    //! @param[in]      hash        CalcHash64() または CalcConstHash64() の値.
+    //-------------------------------------------------------------------------
+    constexpr explicit StringId(uint64_t hash)
+    : m_Hash(hash)
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //! @brief      文字列を登録して生成します.
+    //!
+    //! @param[in]      str         文字列.
+    //! @note       StringTable::Intern() を呼び出します. 衝突した場合は無効なIDになります.
+    //-------------------------------------------------------------------------
+    explicit StringId(const char* str);
+
+    //-------------------------------------------------------------------------
+    //! @brief      ハッシュ値を取得します.
+    //-------------------------------------------------------------------------
+    constexpr uint64_t GetHash() const
+    { return m_Hash; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      有効かどうかチェックします.
+    //-------------------------------------------------------------------------
+    constexpr bool IsValid() const
+    { return m_Hash != 0; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      登録された文字列を取得します.
+    //!
+    //! @return     StringTable に登録されていない場合は nullptr を返却します.
+    //-------------------------------------------------------------------------
+    const char* GetString() const;
+
+    constexpr bool operator == (const StringId& value) const
+    { return m_Hash == value.m_Hash; }
+
+    constexpr bool operator != (const StringId& value) const
+    { return m_Hash != value.m_Hash; }
+
+    constexpr bool operator < (const StringId& value) const
+    { return m_Hash < value.m_Hash; }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    uint64_t    m_Hash;     //!< ハッシュ値.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    /* NOTHING */
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// StringTable class
+///////////////////////////////////////////////////////////////////////////////
+class StringTable
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      唯一のインスタンスを取得します.
+    //-------------------------------------------------------------------------
+    static StringTable& Instance();
+
+    //-------------------------------------------------------------------------
+    //! @brief      文字列を登録します.
+    //!
+    //! @param[in]      str         文字列.
+    //! @param[in]      size        文字数.
+    //! @return     文字列IDを返却します. 登録済みの場合は同じIDを返却します.
+    //!             登録済みの別の文字列とハッシュ値が衝突した場合は無効なIDを返却します.
+    //! @note       スレッドセーフです.
+    //-------------------------------------------------------------------------
+    StringId Intern(const char* str, size_t size);
+
+    //-------------------------------------------------------------------------
+    //! @brief      文字列を登録します.
+    //!
+    //! @param[in]      str         文字列.
+    //! @return     文字列IDを返却します. 登録済みの場合は同じIDを返却します.
+    //!             登録済みの別の文字列とハッシュ値が衝突した場合は無効なIDを返却します.
+    //-------------------------------------------------------------------------
+    StringId Intern(const char* str);
+
+    //-------------------------------------------------------------------------
+    //! @brief      登録された文字列を取得します.
+    //!
+    //! @param[in]      id          文字列ID.
+    //! @return     登録されていない場合は nullptr を返却します.
+    //! @note       返却した文字列は Clear() を呼ぶまで有効です.
+    //-------------------------------------------------------------------------
+    const char* Find(StringId id) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      登録数を取得します.
+    //-------------------------------------------------------------------------
+    size_t GetCount() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      登録された文字列を全て破棄します.
+    //-------------------------------------------------------------------------
+    void Clear();
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    struct Impl;
+    Impl*   m_pImpl;    //!< 実装.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    StringTable();
+    ~StringTable();
+
+    StringTable             (const StringTable&) = delete;
+    StringTable& operator=  (const StringTable&) = delete;
+};
+
 } // namespace asdx
+
+
+namespace std {
+
+///////////////////////////////////////////////////////////////////////////////
+// hash<asdx::StringId> structure
+///////////////////////////////////////////////////////////////////////////////
+template<>
+struct hash<asdx::StringId>
+{
+    size_t operator()(const asdx::StringId& value) const
+    { return size_t(value.GetHash()); }
+};
+
+} // namespace std
+
+
+//-----------------------------------------------------------------------------
+// コンパイル時に文字列IDを生成します.
+//-----------------------------------------------------------------------------
+#ifndef ASDX_STRING_ID
+#define ASDX_STRING_ID( str )       asdx::StringId(asdx::CalcConstHash64( str ))
+#endif//ASDX_STRING_ID
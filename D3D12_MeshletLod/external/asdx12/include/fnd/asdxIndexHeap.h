@@ -19,6 +19,7 @@ namespace asdx {
 // Forward Declarations.
 //-----------------------------------------------------------------------------
 struct IndexHolder;
+class  IndexHeap;
 
 
 ///////////////////////////////////////////////////////////////////////////////
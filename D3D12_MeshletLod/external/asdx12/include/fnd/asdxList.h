@@ -10,6 +10,8 @@
 //-----------------------------------------------------------------------------
 #include <utility> // for std::swap
 #include <cassert>
+#include <cstddef>
+#include <functional> // for std::less
 
 
 namespace asdx {
@@ -9,6 +9,7 @@
 // Includes
 //-------------------------------------------------------------------------------------------------
 #include <cstdint>
+#include <atomic>
 
 
 namespace asdx {
@@ -32,8 +33,46 @@ enum LOG_LEVEL : uint32_t
     LOG_DEBUG,                //!< DEBUGレベル   (青).
     LOG_WARNING,              //!< WARNINGレベル (黄).
     LOG_ERROR,                //!< ERRORレベル   (赤).
+    LOG_LEVEL_COUNT,          //!< ログレベル数.
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// AsyncLogDesc structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct AsyncLogDesc
+{
+    uint32_t        SlotCount       = 4096;     //!< リングバッファのスロット数(2のべき乗に切り上げ, 1スロット256byte).
+    const char*     BinaryLogPath   = nullptr;  //!< バイナリログの出力先です(nullptrの場合は出力しません).
+    bool            EchoConsole     = true;     //!< コンソールとデバッガにも出力するかどうか?
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BinaryLogHeader structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BinaryLogHeader
+{
+    uint8_t         Magic[4];       //!< 'A', 'L', 'O', 'G'.
+    uint32_t        Version;        //!< ファイルバージョン.
+    uint64_t        StartTime;      //!< 記録開始時刻(UNIX時間, マイクロ秒).
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BinaryLogRecord structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BinaryLogRecord
+{
+    uint64_t        Time;           //!< 記録開始からの経過時間(マイクロ秒).
+    uint32_t        ThreadId;       //!< 出力したスレッドのIDです.
+    uint32_t        Length;         //!< 後続する UTF-8 文字列のバイト数(終端文字は含みません).
+    uint8_t         Level;          //!< ログレベル.
+    uint8_t         Reserved[7];    //!< 予約領域.
+};
+
+static_assert(sizeof(BinaryLogHeader) == 16, "BinaryLogHeader Size Not Matched.");
+static_assert(sizeof(BinaryLogRecord) == 24, "BinaryLogRecord Size Not Matched.");
+
+constexpr uint32_t BINARY_LOG_VERSION = 1;
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // ILogger interface
@@ -130,6 +169,49 @@ public:
     //---------------------------------------------------------------------------------------------
     LOG_LEVEL GetFilter() override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      非同期出力を開始します.
+    //!
+    //! @param[in]      desc        構成設定です.
+    //! @retval true    開始に成功.
+    //! @retval false   開始に失敗.
+    //! @note       各スレッドは書式化した文字列をロックフリーのリングバッファに積むだけになり,
+    //!             標準出力・デバッガ・バイナリログへの書き込みはバックグラウンドスレッドで行います.
+    //!             fork() された子プロセスでは同期出力に戻ります.
+    //---------------------------------------------------------------------------------------------
+    bool StartAsync(const AsyncLogDesc& desc = AsyncLogDesc());
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      非同期出力を終了します.
+    //!
+    //! @note       積まれているログを全て書き出してから同期出力に戻ります.
+    //---------------------------------------------------------------------------------------------
+    void StopAsync();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      呼び出し時点までに積まれたログが書き出されるまで待機します.
+    //---------------------------------------------------------------------------------------------
+    void Flush();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      非同期出力中かどうかチェックします.
+    //---------------------------------------------------------------------------------------------
+    bool IsAsync() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レベル毎の1秒当たりの出力数上限を設定します.
+    //!
+    //! @param[in]      level       ログレベルです.
+    //! @param[in]      count       1秒当たりの上限です. 0の場合は制限しません.
+    //! @note       上限を超えたログは破棄し, 次の1秒の最初の出力時に破棄数を通知します.
+    //---------------------------------------------------------------------------------------------
+    void SetRateLimit(LOG_LEVEL level, uint32_t count);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      出力数上限により破棄したログの累計数を取得します.
+    //---------------------------------------------------------------------------------------------
+    uint64_t GetDroppedCount() const;
+
 protected:
     //=============================================================================================
     // protected variables.
@@ -145,13 +227,32 @@ private:
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    static SystemLogger     s_Instance;     //!< シングルトンインスタンスです.
-    LOG_LEVEL               m_Filter;       //!< フィルターです.
+    struct AsyncContext;
+    struct RateCounter
+    {
+        std::atomic<uint32_t>   Limit;      //!< 1秒当たりの上限.
+        std::atomic<uint64_t>   Window;     //!< 計測中の時間窓(秒).
+        std::atomic<uint32_t>   Count;      //!< 時間窓内の出力数.
+        std::atomic<uint32_t>   Dropped;    //!< 時間窓内の破棄数.
+    };
+
+    static SystemLogger         s_Instance;                     //!< シングルトンインスタンスです.
+    LOG_LEVEL                   m_Filter;                       //!< フィルターです.
+    std::atomic<AsyncContext*>  m_pAsync;                       //!< 非同期出力のコンテキストです.
+    std::atomic<uint32_t>       m_Writers;                      //!< 非同期出力に書き込み中のスレッド数です.
+    RateCounter                 m_Rate[LOG_LEVEL_COUNT];        //!< レベル毎の出力数カウンタです.
+    std::atomic<uint64_t>       m_DroppedCount;                 //!< 破棄したログの累計数です.
 
     //=============================================================================================
     // private methods.
     //=============================================================================================
     SystemLogger();
+    ~SystemLogger();
+    bool CheckRateLimit(LOG_LEVEL level);
+    void Dispatch(LOG_LEVEL level, const void* pText, uint32_t size, bool wide);
+    void DetachAsync();
+    static void OnForkPrepare();
+    static void OnForkChild();
     SystemLogger             (const SystemLogger&) = delete;
     SystemLogger& operator = (const SystemLogger&) = delete;
 };
@@ -192,7 +293,7 @@ private:
 #endif//ILOGA
 
 #ifndef ILOGW
-#define ILOGW( fmt, ... )   asdx::SystemLogger::Instance().WriteW( asdx::LOG_INFO, ASDX_WIDE(fmt) ASDX_WIDE("\n"), ##__VA_ARGS__ );
+#define ILOGW( fmt, ... )   asdx::SystemLogger::Instance().WriteW( asdx::LOG_INFO, ASDX_WIDE(fmt) ASDX_WIDE("\n"), ##__VA_ARGS__ )
 #endif//ILOGW
 
 #ifndef WLOGA
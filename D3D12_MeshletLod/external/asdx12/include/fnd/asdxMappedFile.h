@@ -0,0 +1,98 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMappedFile.h
+// Desc : Memory Mapped File.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile class
+///////////////////////////////////////////////////////////////////////////////
+class MappedFile
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    MappedFile();
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~MappedFile();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルを読み取り専用でメモリにマップします.
+    //!
+    //! @param[in]      path        ファイルパス.
+    //! @retval true    マップに成功.
+    //! @retval false   マップに失敗.
+    //! @note       空のファイルはデータが nullptr, サイズが 0 で成功します.
+    //-------------------------------------------------------------------------
+    bool Open(const char* path);
+
+    //-------------------------------------------------------------------------
+    //! @brief      マップを解除してファイルを閉じます.
+    //-------------------------------------------------------------------------
+    void Close();
+
+    //-------------------------------------------------------------------------
+    //! @brief      読み終えた先頭からの範囲を物理メモリから追い出します.
+    //!
+    //! @param[in]      size        先頭からのバイト数.
+    //! @note       マップは有効なままで, 再度アクセスするとファイルから読み直されます.
+    //-------------------------------------------------------------------------
+    void Evict(size_t size);
+
+    //-------------------------------------------------------------------------
+    //! @brief      先頭ポインタを取得します.
+    //-------------------------------------------------------------------------
+    const uint8_t* GetData() const
+    { return m_pData; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルサイズを取得します.
+    //-------------------------------------------------------------------------
+    size_t GetSize() const
+    { return m_Size; }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    void*           m_hFile;        //!< ファイルハンドル.
+    void*           m_hMapping;     //!< マッピングハンドル.
+    const uint8_t*  m_pData;        //!< マップしたデータ.
+    size_t          m_Size;         //!< ファイルサイズ.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    MappedFile              (const MappedFile&) = delete;
+    MappedFile& operator =  (const MappedFile&) = delete;
+};
+
+} // namespace asdx
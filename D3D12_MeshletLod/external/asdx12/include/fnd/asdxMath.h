@@ -363,6 +363,29 @@ template<typename T> inline
 constexpr T Sign( T value ) noexcept
 { return ( value < T(0) ) ? T(-1) : T(1); }
 
+//-----------------------------------------------------------------------------
+//! @brief      値を指定された範囲内で循環させます.
+//!
+//! @param [in]     value   循環させる値.
+//! @param [in]     mini    最小値(範囲に含む).
+//! @param [in]     maxi    最大値(範囲に含まない).
+//! @return     値をminiからmaxiの範囲内に折り返した結果を返却します.
+//-----------------------------------------------------------------------------
+template<typename T> inline
+constexpr T Wrap( T value, const T& mini, const T& maxi ) noexcept
+{
+    const auto range = maxi - mini;
+    if ( !( range > T(0) ) )
+    { return mini; }
+
+    while ( value < mini )
+    { value += range; }
+    while ( value >= maxi )
+    { value -= range; }
+
+    return value;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // Vector2 strucutre
@@ -3974,6 +3997,22 @@ Vector3 ComputeIntersection(const Vector4& plane, const Vector3& orig, const Vec
 void GetCorners(const Vector4* planes, Vector3* corners);
 
 
+///////////////////////////////////////////////////////////////////////////////
+// Int2 structure
+///////////////////////////////////////////////////////////////////////////////
+struct Int2
+{
+    int x = 0;  //!< X成分です.
+    int y = 0;  //!< Y成分です.
+
+    Int2() = default;
+
+    Int2( int nx, int ny )
+    : x( nx )
+    , y( ny )
+    { /* DO_NOTHING */ }
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // Half2 union
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,266 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxProfiler.h
+// Desc : CPU Profiler.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <atomic>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+struct ProfileThread;
+
+///////////////////////////////////////////////////////////////////////////////
+// ProfileDesc structure
+///////////////////////////////////////////////////////////////////////////////
+struct ProfileDesc
+{
+    uint32_t    MaxEventCountPerThread  = 1024 * 1024;  //!< 1スレッドが記録する最大イベント数(超えた分は破棄).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Profiler class
+///////////////////////////////////////////////////////////////////////////////
+class Profiler
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      唯一のインスタンスを取得します.
+    //!
+    //! @note       計測しない場合のコストを抑えるためにインライン展開します.
+    //-------------------------------------------------------------------------
+    static Profiler& Instance()
+    { return s_Instance; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      計測を開始します.
+    //!
+    //! @param[in]      desc        計測設定.
+    //! @note       前回の計測結果は破棄されます.
+    //-------------------------------------------------------------------------
+    void Start(const ProfileDesc& desc = ProfileDesc());
+
+    //-------------------------------------------------------------------------
+    //! @brief      計測を終了します.
+    //-------------------------------------------------------------------------
+    void Stop();
+
+    //-------------------------------------------------------------------------
+    //! @brief      計測中かどうかチェックします.
+    //-------------------------------------------------------------------------
+    bool IsCapturing() const
+    { return m_Capturing.load(std::memory_order_relaxed); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ゾーンを開始します.
+    //!
+    //! @return     開始時刻を返却します.
+    //! @note       ASDX_PROFILE_SCOPE() から呼び出されます.
+    //-------------------------------------------------------------------------
+    uint64_t BeginZone();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ゾーンを終了します.
+    //!
+    //! @param[in]      name        ゾーン名. 書き出しが終わるまで有効な文字列である必要があります.
+    //! @param[in]      begin       BeginZone() の戻り値.
+    //-------------------------------------------------------------------------
+    void EndZone(const char* name, uint64_t begin);
+
+    //-------------------------------------------------------------------------
+    //! @brief      フレームの区切りを記録します.
+    //-------------------------------------------------------------------------
+    void MarkFrame();
+
+    //-------------------------------------------------------------------------
+    //! @brief      呼び出し元スレッドの名前を設定します.
+    //!
+    //! @param[in]      name        スレッド名.
+    //-------------------------------------------------------------------------
+    void SetThreadName(const char* name);
+
+    //-------------------------------------------------------------------------
+    //! @brief      ゾーン名として使える寿命の長い文字列を取得します.
+    //!
+    //! @param[in]      name        文字列.
+    //! @return     同じ内容の文字列には同じポインタを返却します.
+    //! @note       フレーム毎に作り直す文字列をゾーン名にする場合に使用します.
+    //-------------------------------------------------------------------------
+    const char* InternName(const char* name);
+
+    //-------------------------------------------------------------------------
+    //! @brief      Chrome のトレースイベント形式(JSON)で保存します.
+    //!
+    //! @param[in]      path        出力ファイルパス.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //! @note       Stop() の後に呼び出してください. chrome://tracing や Perfetto で表示できます.
+    //-------------------------------------------------------------------------
+    bool SaveChromeTrace(const char* path) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      記録したイベント数を取得します.
+    //-------------------------------------------------------------------------
+    uint64_t GetEventCount() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      上限を超えて破棄したイベント数を取得します.
+    //-------------------------------------------------------------------------
+    uint64_t GetDroppedCount() const;
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    static Profiler             s_Instance;
+    std::atomic<bool>           m_Capturing;        //!< 計測中かどうか?
+    std::atomic<uint32_t>       m_Generation;       //!< 計測回数(スレッドバッファの破棄判定用).
+    std::atomic<uint32_t>       m_FrameIndex;       //!< フレーム番号.
+    std::atomic<ProfileThread*> m_pThreads;         //!< 登録済みスレッドのリスト.
+    std::atomic<uint32_t>       m_ThreadCount;      //!< 登録済みスレッド数.
+    uint32_t                    m_MaxEventCount;    //!< 1スレッドが記録する最大イベント数.
+    uint64_t                    m_StartTick;        //!< 計測開始時のカウンタ値.
+    uint64_t                    m_StopTick;         //!< 計測終了時のカウンタ値.
+    int64_t                     m_StartNanoSec;     //!< 計測開始時刻(ナノ秒).
+    int64_t                     m_StopNanoSec;      //!< 計測終了時刻(ナノ秒).
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    Profiler();
+    ~Profiler();
+
+    Profiler            (const Profiler&) = delete;
+    Profiler& operator= (const Profiler&) = delete;
+
+    ProfileThread* GetThread();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ProfileScope class
+///////////////////////////////////////////////////////////////////////////////
+class ProfileScope
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!
+    //! @param[in]      name        ゾーン名.
+    //-------------------------------------------------------------------------
+    explicit ProfileScope(const char* name)
+    : m_Name (nullptr)
+    , m_Begin(0)
+    {
+        auto& profiler = Profiler::Instance();
+        if (profiler.IsCapturing())
+        {
+            m_Name  = name;
+            m_Begin = profiler.BeginZone();
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~ProfileScope()
+    {
+        if (m_Name != nullptr)
+        { Profiler::Instance().EndZone(m_Name, m_Begin); }
+    }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    const char*     m_Name;     //!< ゾーン名(計測していない場合は nullptr).
+    uint64_t        m_Begin;    //!< 開始時刻.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    ProfileScope            (const ProfileScope&) = delete;
+    ProfileScope& operator= (const ProfileScope&) = delete;
+};
+
+} // namespace asdx
+
+
+#ifndef __ASDX_PROFILE_CONCAT
+#define __ASDX_PROFILE_CONCAT( a, b )       a ## b
+#endif//__ASDX_PROFILE_CONCAT
+
+#ifndef ASDX_PROFILE_CONCAT
+#define ASDX_PROFILE_CONCAT( a, b )         __ASDX_PROFILE_CONCAT( a, b )
+#endif//ASDX_PROFILE_CONCAT
+
+//-----------------------------------------------------------------------------
+// ASDX_ENABLE_PROFILE が定義されている場合のみ計測コードを埋め込みます.
+//-----------------------------------------------------------------------------
+#ifndef ASDX_PROFILE_SCOPE
+  #ifdef ASDX_ENABLE_PROFILE
+    #define ASDX_PROFILE_SCOPE( name )      asdx::ProfileScope ASDX_PROFILE_CONCAT(asdx_profile_scope_, __LINE__)( name )
+  #else
+    #define ASDX_PROFILE_SCOPE( name )      ((void)0)
+  #endif//ASDX_ENABLE_PROFILE
+#endif//ASDX_PROFILE_SCOPE
+
+#ifndef ASDX_PROFILE_FUNC
+  #ifdef ASDX_ENABLE_PROFILE
+    #define ASDX_PROFILE_FUNC()             ASDX_PROFILE_SCOPE( __FUNCTION__ )
+  #else
+    #define ASDX_PROFILE_FUNC()             ((void)0)
+  #endif//ASDX_ENABLE_PROFILE
+#endif//ASDX_PROFILE_FUNC
+
+#ifndef ASDX_PROFILE_FRAME
+  #ifdef ASDX_ENABLE_PROFILE
+    #define ASDX_PROFILE_FRAME()            asdx::Profiler::Instance().MarkFrame()
+  #else
+    #define ASDX_PROFILE_FRAME()            ((void)0)
+  #endif//ASDX_ENABLE_PROFILE
+#endif//ASDX_PROFILE_FRAME
+
+#ifndef ASDX_PROFILE_THREAD
+  #ifdef ASDX_ENABLE_PROFILE
+    #define ASDX_PROFILE_THREAD( name )     asdx::Profiler::Instance().SetThreadName( name )
+  #else
+    #define ASDX_PROFILE_THREAD( name )     ((void)0)
+  #endif//ASDX_ENABLE_PROFILE
+#endif//ASDX_PROFILE_THREAD
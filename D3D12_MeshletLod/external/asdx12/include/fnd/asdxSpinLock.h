@@ -9,6 +9,7 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <atomic>
+#include <immintrin.h>
 
 
 namespace asdx {
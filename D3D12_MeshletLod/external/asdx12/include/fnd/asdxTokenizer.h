@@ -9,6 +9,8 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
 #include <string>
 
 
@@ -82,4 +84,165 @@ private:
     void operator = (const Tokenizer&) = delete;
 };
 
+
+///////////////////////////////////////////////////////////////////////////////
+// FromCharsResult structure
+///////////////////////////////////////////////////////////////////////////////
+struct FromCharsResult
+{
+    const char*     Ptr;        //!< 解析を終えた位置.
+    bool            Success;    //!< 解析に成功したかどうか?
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      文字列を数値に変換します.
+//!
+//! @param[in]      first       先頭位置.
+//! @param[in]      last        終端位置(終端文字は不要です).
+//! @param[out]     value       変換結果. 失敗した場合は変更しません.
+//! @return     std::from_chars() と同様に解析を終えた位置を返却します.
+//! @note       整数は10進数のみ対応します. 実数は仮数が厳密に表現できる範囲を直接計算し,
+//!             それ以外は C ランタイムで変換します.
+//-----------------------------------------------------------------------------
+FromCharsResult FromChars(const char* first, const char* last, float& value);
+FromCharsResult FromChars(const char* first, const char* last, double& value);
+FromCharsResult FromChars(const char* first, const char* last, int32_t& value);
+FromCharsResult FromChars(const char* first, const char* last, uint32_t& value);
+
+///////////////////////////////////////////////////////////////////////////////
+// TokenView class
+///////////////////////////////////////////////////////////////////////////////
+class TokenView
+{
+public:
+    //! @brief      コンストラクタです.
+    TokenView()
+    : m_Ptr (nullptr)
+    , m_Size(0)
+    { /* DO_NOTHING */ }
+
+    //! @brief      引数付きコンストラクタです.
+    TokenView(const char* ptr, size_t size)
+    : m_Ptr (ptr)
+    , m_Size(size)
+    { /* DO_NOTHING */ }
+
+    //! @brief      先頭位置を取得します(終端文字は付きません).
+    const char* data() const { return m_Ptr; }
+
+    //! @brief      終端位置を取得します.
+    const char* end() const { return m_Ptr + m_Size; }
+
+    //! @brief      文字数を取得します.
+    size_t size() const { return m_Size; }
+
+    //! @brief      空かどうかチェックします.
+    bool empty() const { return m_Size == 0; }
+
+    //! @brief      指定された文字列と一致するかチェックします.
+    bool operator == (const char* value) const
+    { return (m_Size == 0 || strncmp(m_Ptr, value, m_Size) == 0) && value[m_Size] == '\0'; }
+
+    //! @brief      指定された文字列と一致しないかチェックします.
+    bool operator != (const char* value) const
+    { return !(*this == value); }
+
+    //! @brief      std::string に変換します.
+    std::string ToString() const
+    { return std::string(m_Ptr, m_Size); }
+
+private:
+    const char*     m_Ptr;      //!< 先頭位置.
+    size_t          m_Size;     //!< 文字数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ViewTokenizer class
+///////////////////////////////////////////////////////////////////////////////
+class ViewTokenizer
+{
+    //=========================================================================
+    // list of friend classes
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods
+    //=========================================================================
+    ViewTokenizer();
+
+    //! @brief      区切り文字を設定します(既定値は空白, タブ, 改行).
+    void        SetSeparator    ( const char* separator );
+
+    //! @brief      単体でトークンとする切り出し文字を設定します.
+    void        SetCutOff       ( const char* cutoff );
+
+    //! @brief      読み取り専用バッファを設定します. バッファはコピーせず, 最初のトークンは Next() で取得します.
+    void        SetBuffer       ( const char* buffer, size_t bufferSize );
+
+    //! @brief      次のトークンに進みます. 改行も区切り文字として扱います.
+    bool        Next            ();
+
+    //! @brief      同じ行の次のトークンに進みます. 行末に達した場合は false を返却します.
+    bool        NextInLine      ();
+
+    //! @brief      行末までを1つのトークンとして取得し, 次の行の先頭まで読み飛ばします.
+    void        SkipLine        ();
+
+    //! @brief      指定した文字列を含むトークンが出てくるまで読み飛ばし, その次のトークンに進みます.
+    void        SkipTo          ( const char* text );
+
+    //! @brief      バッファの終端に達したかどうかチェックします.
+    bool        IsEnd           () const;
+
+    //! @brief      トークンが有効かどうかチェックします.
+    bool        IsValidToken    () const;
+
+    //! @brief      指定された文字列とトークンが一致するかチェックします.
+    bool        Compare         ( const char* token ) const;
+
+    //! @brief      大文字小文字を区別せずに指定された文字列とトークンが一致するかチェックします.
+    bool        CompareAsLower  ( const char* token ) const;
+
+    const TokenView& GetToken   () const;
+    double      GetAsDouble     () const;
+    float       GetAsFloat      () const;
+    int         GetAsInt        () const;
+    bool        GetAsBool       () const;
+    uint32_t    GetAsUint       () const;
+    const TokenView& NextAsToken();
+    double      NextAsDouble    ();
+    float       NextAsFloat     ();
+    int         NextAsInt       ();
+    bool        NextAsBool      ();
+    uint32_t    NextAsUint      ();
+
+    //! @brief      現在の読み取り位置を取得します.
+    const char* GetPtr          () const;
+
+private:
+    //=========================================================================
+    // private variables
+    //=========================================================================
+    const char*     m_pBuffer;          //!< 先頭ポインタ.
+    const char*     m_pPtr;             //!< バッファ位置です.
+    const char*     m_pEnd;             //!< 終端位置です.
+    TokenView       m_Token;            //!< トークン.
+    uint8_t         m_CharClass[256];   //!< 文字種別テーブル.
+
+    //=========================================================================
+    // private methods
+    //=========================================================================
+    ViewTokenizer   (const ViewTokenizer&) = delete;
+    void operator = (const ViewTokenizer&) = delete;
+
+    bool Scan(uint8_t skipMask);
+};
+
 } // namespace asdx
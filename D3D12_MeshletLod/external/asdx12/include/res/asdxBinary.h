@@ -25,13 +25,22 @@ public:
     : m_Offset(0)
     { /* DO_NOTHING */ }
 
-    Offset(int offset)
+    OffsetPtr(int offset)
     : m_Offset(offset)
     { /* DO_NOTHING */ }
 
-    void setOffset(int offset)
+    void SetOffset(int offset)
     { m_Offset = offset; }
 
+    int GetOffset() const
+    { return m_Offset; }
+
+    void SetPtr(const T* ptr)
+    {
+        m_Offset = (ptr == nullptr) ? 0
+            : int(reinterpret_cast<const uint8_t*>(ptr) - reinterpret_cast<const uint8_t*>(this));
+    }
+
     T* get()
     { return (m_Offset == 0) ? nullptr : reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(this) + m_Offset); }
 
@@ -90,7 +99,7 @@ public:
     bool empty() const
     { return m_Size == 0; }
 
-    int size() const
+    uint32_t size() const
     { return m_Size; }
 
     T* data()
@@ -99,27 +108,27 @@ public:
     const T* data() const
     { return m_Data.get(); }
 
-    T& at(int index)
+    T& at(uint32_t index)
     {
-        assert(0 <= index && index < m_Size);
+        assert(index < m_Size);
         return m_Data.get()[index];
     }
 
-    const T& at(int index) const
+    const T& at(uint32_t index) const
     {
-        assert(0 <= index && index < m_Size);
+        assert(index < m_Size);
         return m_Data.get()[index];
     }
 
-    T& operator[](int index)
+    T& operator[](uint32_t index)
     {
-        assert(0 <= index && index < m_Size);
+        assert(index < m_Size);
         return m_Data.get()[index];
     }
 
-    const T& operator[](int index) const
+    const T& operator[](uint32_t index) const
     {
-        assert(0 <= index && index < m_Size);
+        assert(index < m_Size);
         return m_Data.get()[index];
     }
 
@@ -135,14 +144,38 @@ public:
     const T* end() const
     { return &m_Data.get()[m_Size]; }
 
-    void SetSize(int size)
+    void SetSize(uint32_t size)
     { m_Size = size; }
 
     void SetOffset(int offset)
     { m_Data.SetOffset(offset); }
 
+    void SetData(const T* data, uint32_t size)
+    {
+        m_Data.SetPtr(data);
+        m_Size = size;
+    }
+
+    // 参照先が [begin, end) に収まり, T の境界に揃っているかチェックします.
+    bool IsInRange(const void* begin, const void* end) const
+    {
+        if (m_Size == 0)
+        { return true; }
+
+        if (m_Data.GetOffset() == 0)
+        { return false; }
+
+        auto b = reinterpret_cast<uintptr_t>(begin);
+        auto e = reinterpret_cast<uintptr_t>(end);
+        auto p = reinterpret_cast<uintptr_t>(&m_Data) + intptr_t(m_Data.GetOffset());
+
+        return (p % alignof(T)) == 0
+            && b <= p && p <= e
+            && uint64_t(e - p) / sizeof(T) >= uint64_t(m_Size);
+    }
+
 protected:
-    int             m_Size = 0;
+    uint32_t        m_Size = 0;
     OffsetPtr<T>    m_Data;
 };
 
@@ -0,0 +1,169 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxBlockCompression.h
+// Desc : CPU Block Compression Codec.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <res/asdxResTexture.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+struct IThreadPool;
+
+///////////////////////////////////////////////////////////////////////////////
+// BC_FORMAT enum
+///////////////////////////////////////////////////////////////////////////////
+enum BC_FORMAT
+{
+    BC_FORMAT_UNKNOWN = 0,      //!< ブロック圧縮フォーマットではありません.
+    BC_FORMAT_BC1,              //!< BC1 (RGB + 1bit Alpha).
+    BC_FORMAT_BC2,              //!< BC2 (RGB + 4bit Alpha).
+    BC_FORMAT_BC3,              //!< BC3 (RGB + 補間Alpha).
+    BC_FORMAT_BC4_UNORM,        //!< BC4 (R, 符号なし正規化).
+    BC_FORMAT_BC4_SNORM,        //!< BC4 (R, 符号付き正規化).
+    BC_FORMAT_BC5_UNORM,        //!< BC5 (RG, 符号なし正規化).
+    BC_FORMAT_BC5_SNORM,        //!< BC5 (RG, 符号付き正規化).
+    BC_FORMAT_BC6H_UF16,        //!< BC6H (RGB, 符号なし半精度浮動小数).
+    BC_FORMAT_BC6H_SF16,        //!< BC6H (RGB, 符号付き半精度浮動小数).
+    BC_FORMAT_BC7,              //!< BC7 (RGBA).
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      DXGIフォーマットからブロック圧縮フォーマットを取得します.
+//!
+//! @param[in]      dxgiFormat      DXGIフォーマットです.
+//! @return     ブロック圧縮フォーマットを返却します. 該当しない場合は BC_FORMAT_UNKNOWN を返却します.
+//-----------------------------------------------------------------------------
+BC_FORMAT GetBCFormat(uint32_t dxgiFormat);
+
+//-----------------------------------------------------------------------------
+//! @brief      4x4ブロック当たりのバイト数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetBCBlockSize(BC_FORMAT format);
+
+//-----------------------------------------------------------------------------
+//! @brief      展開後の1ピクセル当たりのバイト数を取得します.
+//!
+//! @note       BC6HはRGBA16F, それ以外はRGBA8に展開されます.
+//-----------------------------------------------------------------------------
+uint32_t GetBCDecodedPixelSize(BC_FORMAT format);
+
+//-----------------------------------------------------------------------------
+//! @brief      ブロック圧縮データを展開します.
+//!
+//! @param[in]      format          ブロック圧縮フォーマットです.
+//! @param[in]      width           画像の横幅です.
+//! @param[in]      height          画像の縦幅です.
+//! @param[in]      pSrc            ブロック圧縮データです.
+//! @param[in]      srcPitch        ブロック1行当たりのバイト数です.
+//! @param[out]     pDst            展開先です(RGBA8 または RGBA16F).
+//! @param[in]      dstPitch        展開先の1行当たりのバイト数です.
+//! @param[in]      pThreadPool     スレッドプールです. nullptrの場合は呼び出しスレッドで処理します.
+//! @retval true    展開に成功.
+//! @retval false   展開に失敗.
+//-----------------------------------------------------------------------------
+bool DecodeBC
+(
+    BC_FORMAT       format,
+    uint32_t        width,
+    uint32_t        height,
+    const uint8_t*  pSrc,
+    uint32_t        srcPitch,
+    uint8_t*        pDst,
+    uint32_t        dstPitch,
+    IThreadPool*    pThreadPool = nullptr
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      ブロック圧縮を行います.
+//!
+//! @param[in]      format          ブロック圧縮フォーマットです(BC1～BC5のみ).
+//! @param[in]      width           画像の横幅です.
+//! @param[in]      height          画像の縦幅です.
+//! @param[in]      pSrc            圧縮元データです(RGBA8, SNORMの場合は符号付きRGBA8).
+//! @param[in]      srcPitch        圧縮元の1行当たりのバイト数です.
+//! @param[out]     pDst            ブロック圧縮データの格納先です.
+//! @param[in]      dstPitch        ブロック1行当たりのバイト数です.
+//! @param[in]      pThreadPool     スレッドプールです. nullptrの場合は呼び出しスレッドで処理します.
+//! @retval true    圧縮に成功.
+//! @retval false   圧縮に失敗.
+//-----------------------------------------------------------------------------
+bool EncodeBC
+(
+    BC_FORMAT       format,
+    uint32_t        width,
+    uint32_t        height,
+    const uint8_t*  pSrc,
+    uint32_t        srcPitch,
+    uint8_t*        pDst,
+    uint32_t        dstPitch,
+    IThreadPool*    pThreadPool = nullptr
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      ブロック圧縮テクスチャを展開したリソーステクスチャを生成します.
+//!
+//! @param[in]      src             ブロック圧縮されたリソーステクスチャです.
+//! @param[out]     dst             展開したリソーステクスチャの格納先です.
+//! @param[in]      pThreadPool     スレッドプールです.
+//! @retval true    展開に成功.
+//! @retval false   展開に失敗.
+//-----------------------------------------------------------------------------
+bool DecompressResTexture
+(
+    const ResTexture&   src,
+    ResTexture&         dst,
+    IThreadPool*        pThreadPool = nullptr
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      ブロック圧縮したリソーステクスチャを生成します.
+//!
+//! @param[in]      src             圧縮元のリソーステクスチャです(RGBA8).
+//! @param[in]      dxgiFormat      圧縮先のDXGIフォーマットです(BC1～BC5).
+//! @param[out]     dst             圧縮したリソーステクスチャの格納先です.
+//! @param[in]      pThreadPool     スレッドプールです.
+//! @retval true    圧縮に成功.
+//! @retval false   圧縮に失敗.
+//-----------------------------------------------------------------------------
+bool CompressResTexture
+(
+    const ResTexture&   src,
+    uint32_t            dxgiFormat,
+    ResTexture&         dst,
+    IThreadPool*        pThreadPool = nullptr
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      RGBA8画像同士のPSNRを計算します.
+//!
+//! @param[in]      width           画像の横幅です.
+//! @param[in]      height          画像の縦幅です.
+//! @param[in]      pA              比較する画像です.
+//! @param[in]      pitchA          比較する画像の1行当たりのバイト数です.
+//! @param[in]      pB              比較する画像です.
+//! @param[in]      pitchB          比較する画像の1行当たりのバイト数です.
+//! @param[in]      channelCount    比較するチャンネル数です(1～4).
+//! @return     PSNR[dB]を返却します. 完全一致の場合は無限大を返却します.
+//-----------------------------------------------------------------------------
+double CalcPSNR
+(
+    uint32_t        width,
+    uint32_t        height,
+    const uint8_t*  pA,
+    uint32_t        pitchA,
+    const uint8_t*  pB,
+    uint32_t        pitchB,
+    uint32_t        channelCount = 4
+);
+
+} // namespace asdx
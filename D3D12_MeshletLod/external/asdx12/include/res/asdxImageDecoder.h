@@ -0,0 +1,37 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxImageDecoder.h
+// Desc : TGA / HDR Image Decoder.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <res/asdxResTexture.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//! @brief      Targaファイルからリソーステクスチャを生成します.
+//!
+//! @param[in]      pFile           読み込むファイルです. 呼び出し側で閉じてください.
+//! @param[out]     resTexture      生成したリソーステクスチャです.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//-----------------------------------------------------------------------------
+bool CreateResTextureFromTGAFile(FILE* pFile, ResTexture& resTexture);
+
+//-----------------------------------------------------------------------------
+//! @brief      Radiance HDRファイルからリソーステクスチャを生成します.
+//!
+//! @param[in]      pFile           読み込むファイルです. 呼び出し側で閉じてください.
+//! @param[out]     resTexture      生成したリソーステクスチャです(R32G32B32A32_FLOAT).
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//-----------------------------------------------------------------------------
+bool CreateResTextureFromHDRFile(FILE* pFile, ResTexture& resTexture);
+
+} // namespace asdx
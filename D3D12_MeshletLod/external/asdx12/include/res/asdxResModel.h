@@ -12,6 +12,8 @@
 #include <string>
 #include <vector>
 #include <fnd/asdxMath.h>
+#include <fnd/asdxMappedFile.h>
+#include <res/asdxBinary.h>
 
 
 namespace asdx {
@@ -73,6 +75,54 @@ struct ResLodRange
     uint32_t    Count;      //!< メッシュ数.
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// ResMeshBinary structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMeshBinary
+{
+    BinaryArrary<char>      Name;                                       //!< メッシュ名(終端文字を含む).
+    uint32_t                MaterialId;                                 //!< マテリアルID.
+    uint32_t                BoneInfluenceCount;                         //!< 影響するボーン数.
+    BinaryArrary<Vector3>   Positions;                                  //!< 位置座標.
+    BinaryArrary<Vector3>   Normals;                                    //!< 法線ベクトル.
+    BinaryArrary<Vector3>   Tangents;                                   //!< 接線ベクトル.
+    BinaryArrary<Vector2>   TexCoords[ResMesh::MAX_TEXCOORD_LAYERS];    //!< テクスチャ座標.
+    BinaryArrary<Vector4>   Colors;                                     //!< 頂点カラー.
+    BinaryArrary<uint16_t>  BoneIndices;                                //!< ボーン番号.
+    BinaryArrary<float>     BoneWeights;                                //!< ボーン重み.
+    BinaryArrary<uint32_t>  VertexIndices;                              //!< 頂点番号.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResModelBinary structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResModelBinary : public BinaryHeader
+{
+    static const uint32_t   FILE_VERSION = 1;               //!< ファイルバージョン.
+
+    uint32_t                            FileSize;           //!< ファイルサイズ.
+    BinaryArrary<ResMeshBinary>         Meshes;             //!< メッシュです.
+    BinaryArrary<ResLodRange>           LodRanges;          //!< LOD範囲です.
+    BinaryArrary<BinaryArrary<char>>    Materials;          //!< マテリアル名です(終端文字を含む).
+
+    //-------------------------------------------------------------------------
+    //! @brief      マジックを設定します.
+    //-------------------------------------------------------------------------
+    void SetMagic()
+    {
+        Magic[0] = 'A';
+        Magic[1] = 'M';
+        Magic[2] = 'D';
+        Magic[3] = 'L';
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      マジックが正しいかチェックします.
+    //-------------------------------------------------------------------------
+    bool CheckMagic() const
+    { return BinaryHeader::CheckMagic('A', 'M', 'D', 'L'); }
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // ResModel structure
 ///////////////////////////////////////////////////////////////////////////////
@@ -105,25 +155,119 @@ struct ResModel
         Materials.shrink_to_fit();
     }
 
+    //-------------------------------------------------------------------------
+    //! @brief      バイナリからモデルリソースを生成します.
+    //!
+    //! @param[in]      binary      検証済みのバイナリです.
+    //-------------------------------------------------------------------------
+    void LoadFromBinary(const ResModelBinary& binary);
+
     //-------------------------------------------------------------------------
     //! @brief      ファイルからモデルリソースを生成します
-    //!             読み込み可能なファイルは OBJ です.
+    //!             読み込み可能なファイルは OBJ と AMDL です.
     //! 
     //! @param[in]      filename        ファイル名です.
     //! @retval true    リソース生成に成功.
     //! @retval false   リソース生成に失敗.
+    //! @note       OBJ で法線が指定されていない頂点だけ面から法線を計算します.
     //-------------------------------------------------------------------------
     bool LoadFromFileA(const char* filename);
 
     //-------------------------------------------------------------------------
     //! @brief      ファイルからモデルリソースを生成します.
-    //!             読み込み可能なファイルは OBJ です.
+    //!             読み込み可能なファイルは OBJ と AMDL です.
     //! 
     //! @param[in]      filename        ファイル名です.
     //! @retval true    リソース生成に成功.
     //! @retval false   リソース生成に失敗.
     //-------------------------------------------------------------------------
     bool LoadFromFileW(const wchar_t* filename);
+
+    //-------------------------------------------------------------------------
+    //! @brief      バイナリファイル(AMDL)に保存します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //! @note       保存したファイルは ResModelBinaryFile でマップしてそのまま使えます.
+    //-------------------------------------------------------------------------
+    bool SaveToFileA(const char* filename) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      バイナリファイル(AMDL)に保存します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //-------------------------------------------------------------------------
+    bool SaveToFileW(const wchar_t* filename) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResModelBinaryFile class
+///////////////////////////////////////////////////////////////////////////////
+class ResModelBinaryFile
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    ResModelBinaryFile();
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~ResModelBinaryFile();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルをマップして検証します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    読み込みに成功.
+    //! @retval false   読み込みに失敗.
+    //! @note       全ての参照範囲と頂点番号を1回だけ検証し, 以降はマップしたまま参照します.
+    //-------------------------------------------------------------------------
+    bool Open(const char* filename);
+
+    //-------------------------------------------------------------------------
+    //! @brief      マップを解除します.
+    //-------------------------------------------------------------------------
+    void Close();
+
+    //-------------------------------------------------------------------------
+    //! @brief      モデルを取得します.
+    //!
+    //! @return     開いていない場合は nullptr を返却します.
+    //-------------------------------------------------------------------------
+    const ResModelBinary* GetModel() const
+    { return m_pModel; }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    MappedFile              m_File;     //!< マップしたファイル.
+    const ResModelBinary*   m_pModel;   //!< 検証済みのモデル.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    ResModelBinaryFile              (const ResModelBinaryFile&) = delete;
+    ResModelBinaryFile& operator =  (const ResModelBinaryFile&) = delete;
 };
 
 } // namespace asdx
@@ -107,6 +107,24 @@ struct PassResourceDesc
     uint8_t                 Usage               = PASS_RESOURCE_USAGE_RTV;          //!< 使用用途です.
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// PassGraphStats structure
+///////////////////////////////////////////////////////////////////////////////
+struct PassGraphStats
+{
+    uint32_t    ResourceHitCount        = 0;    //!< リソースキャッシュのヒット数です.
+    uint32_t    ResourceMissCount       = 0;    //!< リソースキャッシュのミス数です.
+    uint32_t    ResourceCreateCount     = 0;    //!< リソース生成数です.
+    uint32_t    ResourceEvictCount      = 0;    //!< リソースキャッシュからの追い出し数です.
+    uint32_t    ResourceResidentCount   = 0;    //!< リソースキャッシュの常駐数です.
+    uint32_t    CompiledPassCount       = 0;    //!< 実行されたパス数です(バリア専用パスを含む).
+    uint32_t    CulledPassCount         = 0;    //!< カリングされたパス数です.
+    bool        CompileCacheHit         = false;//!< コンパイルキャッシュがヒットした場合は true.
+    uint32_t    BarrierCount            = 0;    //!< 発行したバリア数です(分割バリアは開始と終了で2つ).
+    uint32_t    SplitBarrierCount       = 0;    //!< 分割したバリア数です.
+    uint32_t    BarrierBatchCount       = 0;    //!< ResourceBarrier() の呼び出し回数です.
+};
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // IPassGraphBuilder interface
@@ -283,6 +301,13 @@ struct IPassGraph
     //! @return     待機ポイントを返却します.
     //-------------------------------------------------------------------------
     virtual WaitPoint Execute(const WaitPoint& value) = 0;
+
+    //-------------------------------------------------------------------------
+    //! @brief      直前に実行したフレームの統計情報を取得します.
+    //!
+    //! @return     統計情報を返却します.
+    //-------------------------------------------------------------------------
+    virtual PassGraphStats GetStats() const = 0;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -295,6 +320,7 @@ struct PassGraphDesc
     uint8_t         MaxThreadCount;     //!< 最大スレッド数です.
     CommandQueue*   pGraphicsQueue;     //!< グラフィックスキューです.
     CommandQueue*   pComputeQueue;      //!< コンピュートキューです.
+    bool            EnableReorder;      //!< 依存関係の無いパスの並び替えを許可する場合は true.
 };
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,305 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxPassGraphCompiler.h
+// Desc : Pass Graph Compiler.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// RESORUCE_INFO_FLAGS
+///////////////////////////////////////////////////////////////////////////////
+enum RESOURCE_INFO_FLAGS
+{
+    RESOURCE_INFO_FLAG_NONE                 = 0,            // 無し.
+    RESOURCE_INFO_FLAG_STATE_COMMON         = 0x1 << 0,     // 共通ステート.
+    RESOURCE_INFO_FLAG_STATE_READ           = 0x1 << 1,     // 読み取りステート.
+    RESOURCE_INFO_FLAG_STATE_WRITE          = 0x1 << 2,     // 書き込みステート.
+    RESOURCE_INFO_FLAG_BARRIER              = 0x1 << 3,     // パス実行前のバリア有効.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SYNC_FLAGS
+///////////////////////////////////////////////////////////////////////////////
+enum SYNC_FLAGS
+{
+    SYNC_FLAG_NONE = 0,
+    SYNC_FLAG_GRAPHICS_TO_COMPUTE = 1,      // コンピュートキューがグラフィックスキューを待機.
+    SYNC_FLAG_COMPUTE_TO_GRAPHICS = 2,      // グラフィックスキューがコンピュートキューを待機.
+    SYNC_FLAG_COMPUTE_TO_COMPUTE  = 3,      // 同一キューのため待機不要.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PASS_BARRIER_SPLIT enum
+///////////////////////////////////////////////////////////////////////////////
+enum PASS_BARRIER_SPLIT
+{
+    PASS_BARRIER_SPLIT_NONE,        // 分割しないバリア.
+    PASS_BARRIER_SPLIT_BEGIN_ONLY,  // 分割バリアの開始.
+    PASS_BARRIER_SPLIT_END_ONLY,    // 分割バリアの終了.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PassBarrier structure
+///////////////////////////////////////////////////////////////////////////////
+struct PassBarrier
+{
+    uint32_t            Resource;   //!< リソース番号です.
+    RESOURCE_INFO_FLAGS Before;     //!< 遷移前ステートです.
+    RESOURCE_INFO_FLAGS After;      //!< 遷移後ステートです.
+    PASS_BARRIER_SPLIT  Split;      //!< 分割バリアの種別です.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PassStep structure
+///////////////////////////////////////////////////////////////////////////////
+struct PassStep
+{
+    uint32_t    Pass;               //!< 入力パス番号です. バリア専用ステップの場合は PassGraphCompiler::kInvalidIndex です.
+    bool        AsyncCompute;       //!< コンピュートキューで実行する場合は true.
+    uint8_t     SyncFlag;           //!< 実行前に必要なキュー間同期です.
+    uint32_t    PreBarrierOffset;   //!< 実行前に発行するバリアの PassGraphPlan::Barriers での開始位置です.
+    uint32_t    PreBarrierCount;    //!< 実行前に発行するバリア数です.
+    uint32_t    PostBarrierOffset;  //!< 実行後に発行するバリアの PassGraphPlan::Barriers での開始位置です.
+    uint32_t    PostBarrierCount;   //!< 実行後に発行するバリア数です.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PassGraphPlan structure
+///////////////////////////////////////////////////////////////////////////////
+struct PassGraphPlan
+{
+    std::vector<PassStep>               Steps;          //!< 実行ステップ(実行順).
+    std::vector<PassBarrier>            Barriers;       //!< バリアリスト.
+    std::vector<RESOURCE_INFO_FLAGS>    FinalStates;    //!< リソースの最終ステート.
+    std::vector<uint8_t>                FinalCompute;   //!< リソースを最後に使用したのがコンピュートキューかどうか.
+    uint32_t                            CulledCount;    //!< カリングされたパス数.
+    uint32_t                            SplitCount;     //!< 分割したバリア数.
+    uint32_t                            BatchCount;     //!< バリア発行回数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// IPassCommandRecorder interface
+///////////////////////////////////////////////////////////////////////////////
+struct IPassCommandRecorder
+{
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    virtual ~IPassCommandRecorder()
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //! @brief      キュー間同期を記録します.
+    //!
+    //! @param[in]      syncFlag        同期フラグです.
+    //-------------------------------------------------------------------------
+    virtual void Wait(uint8_t syncFlag) = 0;
+
+    //-------------------------------------------------------------------------
+    //! @brief      1回分のバリア発行を記録します.
+    //!
+    //! @param[in]      count       バリア数です.
+    //! @param[in]      pBarriers   バリアです.
+    //-------------------------------------------------------------------------
+    virtual void Barrier(uint32_t count, const PassBarrier* pBarriers) = 0;
+
+    //-------------------------------------------------------------------------
+    //! @brief      パスの実行を記録します.
+    //!
+    //! @param[in]      pass            入力パス番号です. バリア専用ステップの場合は無効値です.
+    //! @param[in]      asyncCompute    コンピュートキューで実行する場合は true.
+    //-------------------------------------------------------------------------
+    virtual void Execute(uint32_t pass, bool asyncCompute) = 0;
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      実行計画をキューへの投入順にレコーダーへ記録します.
+//!
+//! @param[in]      plan        実行計画です.
+//! @param[in]      pRecorder   レコーダーです.
+//-----------------------------------------------------------------------------
+void RecordPlan(const PassGraphPlan& plan, IPassCommandRecorder* pRecorder);
+
+///////////////////////////////////////////////////////////////////////////////
+// PassGraphCompiler class
+///////////////////////////////////////////////////////////////////////////////
+class PassGraphCompiler
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    static constexpr uint32_t kInvalidIndex  = UINT32_MAX;  //!< 無効な番号.
+    static constexpr uint32_t kMaxCacheCount = 8;           //!< コンパイルキャッシュの最大エントリー数.
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    PassGraphCompiler();
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~PassGraphCompiler();
+
+    //-------------------------------------------------------------------------
+    //! @brief      パスの並び替えを有効にするかどうか設定します.
+    //!
+    //! @param[in]      value       依存関係の無いパスを並び替える場合は true.
+    //-------------------------------------------------------------------------
+    void SetReorder(bool value);
+
+    //-------------------------------------------------------------------------
+    //! @brief      グラフの入力を開始します.
+    //-------------------------------------------------------------------------
+    void Begin();
+
+    //-------------------------------------------------------------------------
+    //! @brief      リソースを追加します.
+    //!
+    //! @param[in]      state       フレーム開始時のステートです.
+    //! @param[in]      compute     フレーム開始時にコンピュートキューで使用されていたかどうか.
+    //! @param[in]      imported    インポートリソースかどうか.
+    //! @return     リソース番号を返却します.
+    //-------------------------------------------------------------------------
+    uint32_t AddResource(RESOURCE_INFO_FLAGS state, bool compute, bool imported);
+
+    //-------------------------------------------------------------------------
+    //! @brief      パスを追加します.
+    //!
+    //! @param[in]      tag             タグのハッシュ値です.
+    //! @param[in]      asyncCompute    非同期コンピュートパスかどうか.
+    //! @return     パス番号を返却します.
+    //-------------------------------------------------------------------------
+    uint32_t AddPass(uint32_t tag, bool asyncCompute);
+
+    //-------------------------------------------------------------------------
+    //! @brief      直前に追加したパスにリソースアクセスを追加します.
+    //!
+    //! @param[in]      resource    リソース番号です.
+    //! @param[in]      access      RESOURCE_INFO_FLAG_STATE_READ または RESOURCE_INFO_FLAG_STATE_WRITE.
+    //-------------------------------------------------------------------------
+    void AddAccess(uint32_t resource, RESOURCE_INFO_FLAGS access);
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンパイルします.
+    //!
+    //! @return     実行計画を返却します. 次に Compile() を呼び出すまで有効です.
+    //-------------------------------------------------------------------------
+    const PassGraphPlan& Compile();
+
+    //-------------------------------------------------------------------------
+    //! @brief      直前のコンパイルがキャッシュヒットしたかどうか.
+    //-------------------------------------------------------------------------
+    bool IsCacheHit() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      直前にコンパイルしたグラフのハッシュ値を取得します.
+    //-------------------------------------------------------------------------
+    uint64_t GetHash() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンパイルキャッシュを破棄します.
+    //-------------------------------------------------------------------------
+    void ClearCache();
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Pass structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Pass
+    {
+        uint32_t    Tag;
+        bool        AsyncCompute;
+        uint32_t    AccessOffset;
+        uint32_t    AccessCount;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Access structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Access
+    {
+        uint32_t            Resource;
+        RESOURCE_INFO_FLAGS Flags;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Resource structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Resource
+    {
+        RESOURCE_INFO_FLAGS State;
+        bool                Compute;
+        bool                Imported;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // CacheEntry structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct CacheEntry
+    {
+        uint64_t                Hash     = 0;
+        uint64_t                LastUsed = 0;
+        std::vector<uint32_t>   Key;
+        PassGraphPlan           Plan;
+    };
+
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    std::vector<Pass>       m_Passes;
+    std::vector<Access>     m_Accesses;
+    std::vector<Resource>   m_Resources;
+    std::vector<uint32_t>   m_Key;
+    std::vector<CacheEntry> m_Cache;
+    uint64_t                m_Hash      = 0;
+    uint64_t                m_Counter   = 0;
+    uint32_t                m_Current   = kInvalidIndex;
+    bool                    m_CacheHit  = false;
+    bool                    m_Reorder   = false;
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      キャッシュキーを構築します.
+    //-------------------------------------------------------------------------
+    void BuildKey();
+
+    //-------------------------------------------------------------------------
+    //! @brief      参照されないパスをカリングします.
+    //-------------------------------------------------------------------------
+    void Cull(std::vector<uint8_t>& alive) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      パスの実行順を決定します.
+    //-------------------------------------------------------------------------
+    void Schedule(const std::vector<uint8_t>& alive, std::vector<uint32_t>& order) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      バリアとキュー間同期を解決します.
+    //-------------------------------------------------------------------------
+    void Resolve(const std::vector<uint32_t>& order, PassGraphPlan& plan) const;
+};
+
+} // namespace asdx
@@ -7,15 +7,138 @@
 //-----------------------------------------------------------------------------
 // Includes
 //-----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
 #include <vector>
 #include <string>
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #include <edit/asdxFileWatcher.h>
 #include <fnd/asdxLogger.h>
 
 
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// FileEventQueue structure
+///////////////////////////////////////////////////////////////////////////////
+struct FileEventQueue
+{
+    using Clock = std::chrono::steady_clock;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Entry structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        ACTION_TYPE         Type;       //!< まとめた後の変更種別.
+        uint64_t            Sequence;   //!< 最初に変更を受け取った順番.
+        Clock::time_point   LastTime;   //!< 最後に変更を受け取った時刻.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Event structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Event
+    {
+        ACTION_TYPE         Type;       //!< 変更種別.
+        uint64_t            Sequence;   //!< 最初に変更を受け取った順番.
+        std::string         Path;       //!< 相対パス.
+    };
+
+    std::mutex                          Mutex;              //!< ミューテックス.
+    std::map<std::string, Entry>        Entries;            //!< 通知待ちの変更(相対パスがキー).
+    uint64_t                            Sequence = 0;       //!< 受け取り順の採番.
+    std::string                         DirectoryPath;      //!< 監視対象ディレクトリ.
+    uint32_t                            CoalesceMsec = 0;   //!< 変更をまとめる時間.
+    std::list<IFileUpdateListener*>     pListeners;         //!< 変更通知先.
+
+    //-------------------------------------------------------------------------
+    //! @brief      監視スレッドから変更を追加します.
+    //-------------------------------------------------------------------------
+    void Push(ACTION_TYPE type, const std::string& path)
+    {
+        std::lock_guard<std::mutex> locker(Mutex);
+
+        auto now = Clock::now();
+        auto itr = Entries.find(path);
+        if (itr == Entries.end())
+        {
+            Entry entry = { type, Sequence++, now };
+            Entries.emplace(path, entry);
+            return;
+        }
+
+        auto& entry = itr->second;
+        auto  prev  = entry.Type;
+        auto  added   = (prev == ACTION_ADDED   || prev == ACTION_RENAMED_NEW_NAME);
+        auto  removed = (prev == ACTION_REMOVED || prev == ACTION_RENAMED_OLD_NAME);
+
+        if (added && (type == ACTION_REMOVED || type == ACTION_RENAMED_OLD_NAME))
+        {
+            // 作ってすぐ消えた一時ファイルは通知しない.
+            Entries.erase(itr);
+            return;
+        }
+
+        if (added && type == ACTION_MODIFIED)
+        { /* 追加として通知する */ }
+        else if (removed && type != ACTION_REMOVED && type != ACTION_RENAMED_OLD_NAME)
+        { entry.Type = ACTION_MODIFIED; }   // 消して作り直す保存は変更として通知する.
+        else
+        { entry.Type = type; }
+
+        entry.LastTime = now;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      まとめる時間が経過した変更を取り出します.
+    //-------------------------------------------------------------------------
+    void Pop(std::vector<Event>& result)
+    {
+        {
+            std::lock_guard<std::mutex> locker(Mutex);
+
+            auto now = Clock::now();
+            auto itr = Entries.begin();
+            while(itr != Entries.end())
+            {
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - itr->second.LastTime).count();
+                if (elapsed < int64_t(CoalesceMsec))
+                {
+                    ++itr;
+                    continue;
+                }
+
+                Event event = { itr->second.Type, itr->second.Sequence, itr->first };
+                result.push_back(event);
+                itr = Entries.erase(itr);
+            }
+        }
+
+        std::sort(result.begin(), result.end(),
+            [](const Event& lhs, const Event& rhs)
+            { return lhs.Sequence < rhs.Sequence; });
+    }
+};
+
+} // namespace asdx
+
 namespace {
 
+#ifdef _WIN32
 //-----------------------------------------------------------------------------
 //      マルチバイト文字列に変換します.
 //-----------------------------------------------------------------------------
@@ -40,11 +163,10 @@ struct Worker
     HANDLE                      hEvent          = nullptr;
     HANDLE                      hDir            = nullptr;
     uint32_t                    WaitTimeMsec    = 0;
+    bool                        Recursive       = true;
     std::vector<uint8_t>        Buffer          = {};
-    std::string                 DirectoryPath   = {};
     std::atomic<bool>*          pFinish         = nullptr;
-
-    std::list<asdx::IFileUpdateListener*> pListeners = {};
+    asdx::FileEventQueue*       pQueue          = nullptr;
 
     Worker()
     { /* DO_NOTHING */ }
@@ -52,7 +174,7 @@ struct Worker
     ~Worker()
     { /* DO_NOTHING */ }
 
-    bool Prepare(asdx::FileWatcher::Desc& desc, std::atomic<bool>* pFlags)
+    bool Prepare(asdx::FileWatcher::Desc& desc, std::atomic<bool>* pFlags, asdx::FileEventQueue* pEvents)
     {
         hDir = CreateFileA(
             desc.DirectoryPath,
@@ -80,9 +202,9 @@ struct Worker
         }
 
         pFinish         = pFlags;
-        DirectoryPath   = desc.DirectoryPath;
-        pListeners      = std::move(desc.pListeners);
+        pQueue          = pEvents;
         WaitTimeMsec    = desc.WaitTimeMsec;
+        Recursive       = desc.Recursive;
         Buffer.resize(desc.BufferSize);
 
         return true;
@@ -114,7 +236,7 @@ struct Worker
                 hDir,
                 pBuf,
                 bufSize,
-                TRUE,
+                Recursive ? TRUE : FALSE,
                 filter,
                 nullptr,
                 &olp,
@@ -162,13 +284,8 @@ struct Worker
 
                 for (;;)
                 {
-                    // ファイル名取得.
-                    auto path = ToStringA(pInfos->FileName);
-
-                    // 末尾にカンマが来ることがあるので，それを取り除く.
-                    auto pos = path.find_last_of(',');
-                    if (pos != std::string::npos && pos == path.size() - 1)
-                    { path = path.substr(0, pos); }
+                    // ファイル名取得(終端文字が無いので長さを指定する).
+                    auto path = ToStringA(std::wstring(pInfos->FileName, pInfos->FileNameLength / sizeof(WCHAR)));
 
                     // 強制的に開いて閉じる.
                     // これでたま～にファイルがオープンできない問題を解決できる.
@@ -178,13 +295,7 @@ struct Worker
                         { CloseHandle(handle); }
                     }
 
-                    asdx::FileUpdateEventArgs args;
-                    args.Type           = asdx::ACTION_TYPE(pInfos->Action);
-                    args.DirectoryPath  = DirectoryPath;
-                    args.RelativePath   = path;
-
-                    for(auto& listener : pListeners)
-                    { listener->OnUpdate(args); }
+                    pQueue->Push(asdx::ACTION_TYPE(pInfos->Action), path);
 
                     // 次のエントリがなければ終了.
                     if (pInfos->NextEntryOffset == 0)
@@ -194,6 +305,10 @@ struct Worker
                     pInfos = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(reinterpret_cast<uint8_t*>(pInfos) + pInfos->NextEntryOffset);
                 }
             }
+            else
+            {
+                ELOGA("Warning : FileWatcher Buffer Overflow. Some events are lost.");
+            }
         }
 
         CloseHandle(hEvent);
@@ -202,11 +317,234 @@ struct Worker
         hEvent      = nullptr;
         hDir        = nullptr;
         pFinish     = nullptr;
-        pListeners.clear();
+        pQueue      = nullptr;
+        Buffer.clear();
+        Buffer.shrink_to_fit();
+    }
+};
+#else
+//-----------------------------------------------------------------------------
+//      相対パスを連結します.
+//-----------------------------------------------------------------------------
+std::string JoinPath(const std::string& dir, const char* name)
+{
+    if (dir.empty())
+    { return name; }
+
+    return dir + "/" + name;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Worker structure
+///////////////////////////////////////////////////////////////////////////////
+struct Worker
+{
+    // 監視するイベント.
+    static const uint32_t WATCH_MASK =
+        IN_CREATE       |   // ファイル・ディレクトリの作成.
+        IN_DELETE       |   // ファイル・ディレクトリの削除.
+        IN_MODIFY       |   // 書き込み.
+        IN_CLOSE_WRITE  |   // 書き込みで開いたファイルを閉じた.
+        IN_ATTRIB       |   // 属性の変更.
+        IN_MOVED_FROM   |   // 移動元.
+        IN_MOVED_TO;        // 移動先.
+
+    int                         Fd              = -1;
+    uint32_t                    WaitTimeMsec    = 0;
+    bool                        Recursive       = true;
+    std::vector<uint8_t>        Buffer          = {};
+    std::string                 DirectoryPath   = {};
+    std::atomic<bool>*          pFinish         = nullptr;
+    asdx::FileEventQueue*       pQueue          = nullptr;
+
+    std::unordered_map<int, std::string> Dirs = {};    //!< 監視記述子から相対ディレクトリパスへのテーブル.
+
+    Worker()
+    { /* DO_NOTHING */ }
+
+    ~Worker()
+    { /* DO_NOTHING */ }
+
+    bool Prepare(asdx::FileWatcher::Desc& desc, std::atomic<bool>* pFlags, asdx::FileEventQueue* pEvents)
+    {
+        Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (Fd < 0)
+        {
+            ELOGA("Error : inotify_init1() Failed. errno = %d", errno);
+            return false;
+        }
+
+        pFinish         = pFlags;
+        pQueue          = pEvents;
+        DirectoryPath   = desc.DirectoryPath;
+        WaitTimeMsec    = desc.WaitTimeMsec;
+        Recursive       = desc.Recursive;
+
+        // 最低でも名前の最大長を持つイベント1つを受け取れるようにする.
+        Buffer.resize(std::max(desc.BufferSize, sizeof(inotify_event) + NAME_MAX + 1));
+
+        if (!AddWatch(std::string(), false))
+        {
+            close(Fd);
+            Fd = -1;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool AddWatch(const std::string& relativePath, bool notify)
+    {
+        auto path = relativePath.empty() ? DirectoryPath : DirectoryPath + "/" + relativePath;
+
+        auto wd = inotify_add_watch(Fd, path.c_str(), WATCH_MASK | IN_ONLYDIR);
+        if (wd < 0)
+        {
+            ELOGA("Error : inotify_add_watch() Failed. path = %s, errno = %d", path.c_str(), errno);
+            return false;
+        }
+
+        Dirs[wd] = relativePath;
+
+        if (!Recursive)
+        { return true; }
+
+        auto dir = opendir(path.c_str());
+        if (dir == nullptr)
+        { return true; }
+
+        // 監視を登録する前に作られたものを拾う.
+        while(auto entry = readdir(dir))
+        {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            { continue; }
+
+            auto child = JoinPath(relativePath, entry->d_name);
+
+            auto isDir = (entry->d_type == DT_DIR);
+            if (entry->d_type == DT_UNKNOWN)
+            {
+                struct stat info = {};
+                auto fullPath = DirectoryPath + "/" + child;
+                isDir = (stat(fullPath.c_str(), &info) == 0) && S_ISDIR(info.st_mode);
+            }
+
+            if (notify)
+            { pQueue->Push(asdx::ACTION_ADDED, child); }
+
+            if (isDir)
+            { AddWatch(child, notify); }
+        }
+
+        closedir(dir);
+        return true;
+    }
+
+    void RemoveWatch(const std::string& relativePath)
+    {
+        auto prefix = relativePath + "/";
+
+        auto itr = Dirs.begin();
+        while(itr != Dirs.end())
+        {
+            auto& path = itr->second;
+            if (path == relativePath || path.compare(0, prefix.size(), prefix) == 0)
+            {
+                inotify_rm_watch(Fd, itr->first);
+                itr = Dirs.erase(itr);
+            }
+            else
+            { ++itr; }
+        }
+    }
+
+    void Process(const inotify_event* pEvent)
+    {
+        if (pEvent->mask & IN_Q_OVERFLOW)
+        {
+            ELOGA("Warning : FileWatcher Queue Overflow. Some events are lost.");
+            return;
+        }
+
+        auto itr = Dirs.find(pEvent->wd);
+        if (itr == Dirs.end())
+        { return; }
+
+        // 監視対象自体が削除された.
+        if (pEvent->mask & IN_IGNORED)
+        {
+            Dirs.erase(itr);
+            return;
+        }
+
+        if (pEvent->len == 0)
+        { return; }
+
+        auto path = JoinPath(itr->second, pEvent->name);
+
+        asdx::ACTION_TYPE type;
+        if (pEvent->mask & IN_CREATE)
+        { type = asdx::ACTION_ADDED; }
+        else if (pEvent->mask & IN_DELETE)
+        { type = asdx::ACTION_REMOVED; }
+        else if (pEvent->mask & IN_MOVED_FROM)
+        { type = asdx::ACTION_RENAMED_OLD_NAME; }
+        else if (pEvent->mask & IN_MOVED_TO)
+        { type = asdx::ACTION_RENAMED_NEW_NAME; }
+        else
+        { type = asdx::ACTION_MODIFIED; }
+
+        pQueue->Push(type, path);
+
+        if ((pEvent->mask & IN_ISDIR) && Recursive)
+        {
+            if (pEvent->mask & (IN_CREATE | IN_MOVED_TO))
+            { AddWatch(path, true); }
+            else if (pEvent->mask & IN_MOVED_FROM)
+            { RemoveWatch(path); }
+        }
+    }
+
+    void operator()()
+    {
+        // 終了フラグが立つまでループ.
+        while (!pFinish->load())
+        {
+            pollfd fds = {};
+            fds.fd     = Fd;
+            fds.events = POLLIN;
+
+            auto ret = poll(&fds, 1, int(WaitTimeMsec));
+            if (ret <= 0)
+            { continue; }
+
+            for (;;)
+            {
+                auto size = read(Fd, Buffer.data(), Buffer.size());
+                if (size <= 0)
+                { break; }
+
+                size_t offset = 0;
+                while (offset < size_t(size))
+                {
+                    auto pEvent = reinterpret_cast<const inotify_event*>(Buffer.data() + offset);
+                    Process(pEvent);
+                    offset += sizeof(inotify_event) + pEvent->len;
+                }
+            }
+        }
+
+        close(Fd);
+
+        Fd          = -1;
+        pFinish     = nullptr;
+        pQueue      = nullptr;
+        Dirs.clear();
         Buffer.clear();
         Buffer.shrink_to_fit();
     }
 };
+#endif//_WIN32
 
 } // namespace
 
@@ -239,10 +577,22 @@ bool FileWatcher::Init(Desc& desc)
     // 終了フラグを下す.
     m_Finish = false;
 
+    // イベントキューを生成.
+    m_pQueue = new FileEventQueue();
+    m_pQueue->DirectoryPath = desc.DirectoryPath;
+    m_pQueue->CoalesceMsec  = desc.CoalesceMsec;
+
     // ワーカーを初期化.
     Worker worker;
-    if (!worker.Prepare(desc, &m_Finish))
-    { return false; }
+    if (!worker.Prepare(desc, &m_Finish, m_pQueue))
+    {
+        delete m_pQueue;
+        m_pQueue = nullptr;
+        return false;
+    }
+
+    // 通知はメインスレッドから行うので, リスナーはキューが持つ.
+    m_pQueue->pListeners = std::move(desc.pListeners);
 
     // 監視スレッド起動.
     m_pThread = new std::thread(worker);
@@ -275,6 +625,35 @@ void FileWatcher::Term()
     // スレッド破棄.
     delete m_pThread;
     m_pThread = nullptr;
+
+    // 通知していない変更は破棄する.
+    delete m_pQueue;
+    m_pQueue = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//      まとめた変更をリスナーに通知します.
+//-----------------------------------------------------------------------------
+uint32_t FileWatcher::Dispatch()
+{
+    if (m_pQueue == nullptr)
+    { return 0; }
+
+    std::vector<FileEventQueue::Event> events;
+    m_pQueue->Pop(events);
+
+    for(auto& event : events)
+    {
+        FileUpdateEventArgs args;
+        args.Type           = event.Type;
+        args.DirectoryPath  = m_pQueue->DirectoryPath;
+        args.RelativePath   = event.Path;
+
+        for(auto& listener : m_pQueue->pListeners)
+        { listener->OnUpdate(args); }
+    }
+
+    return uint32_t(events.size());
 }
 
 } // namespace asdx
@@ -1,4 +1,4 @@
-//-----------------------------------------------------------------------------
+﻿//-----------------------------------------------------------------------------
 // File : asdxBit.cpp
 // Desc : Bit Operations.
 // Copyright(c) Project Asura. All right reserved.
@@ -137,18 +137,18 @@ int CountZeroR(uint64_t value) { return std::countr_zero(value); }
 #elif defined(__clang__) || defined(__GNUC__)
 // GCC or clang.
 
-int CountBit(uint8_t  value) { return __builtin_popcount(value); }
+// __builtin_clz / __builtin_ctz は 0 の結果が未定義なので, lzcnt / tzcnt と同じくビット幅を返す.
 int CountBit(uint16_t value) { return __builtin_popcount(value); }
 int CountBit(uint32_t value) { return __builtin_popcount(value); }
 int CountBit(uint64_t value) { return __builtin_popcountll(value); }
 
-int CountZeroL(uint16_t value) { return __builtin_clzs(value); }
-int CountZeroL(uint32_t value) { return __builtin_clz(value); }
-int CountZeroL(uint64_t value) { return __builtin_clzll(value); }
+int CountZeroL(uint16_t value) { return (value != 0) ? __builtin_clz(value) - 16 : 16; }
+int CountZeroL(uint32_t value) { return (value != 0) ? __builtin_clz(value) : 32; }
+int CountZeroL(uint64_t value) { return (value != 0) ? __builtin_clzll(value) : 64; }
 
-int CountZeroR(uint16_t value) { return __builtin_ctzs(value); }
-int CountZeroR(uint32_t value) { return __builtin_ctz(value); }
-int CountZeroR(uint64_t value) { return __builtin_ctzll(value); }
+int CountZeroR(uint16_t value) { return (value != 0) ? __builtin_ctz(value) : 16; }
+int CountZeroR(uint32_t value) { return (value != 0) ? __builtin_ctz(value) : 32; }
+int CountZeroR(uint64_t value) { return (value != 0) ? __builtin_ctzll(value) : 64; }
 
 #elif defined(_MSC_VER)
 // Microsoft Visual Studio.
@@ -0,0 +1,144 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxHash.cpp
+// Desc : Hash Key Module.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <fnd/asdxHash.h>
+#include <fnd/asdxLogger.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// StringId class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      文字列を登録して生成します.
+//-----------------------------------------------------------------------------
+StringId::StringId(const char* str)
+: m_Hash(StringTable::Instance().Intern(str).GetHash())
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      登録された文字列を取得します.
+//-----------------------------------------------------------------------------
+const char* StringId::GetString() const
+{ return StringTable::Instance().Find(*this); }
+
+
+///////////////////////////////////////////////////////////////////////////////
+// StringTable::Impl structure
+///////////////////////////////////////////////////////////////////////////////
+struct StringTable::Impl
+{
+    mutable std::mutex                          Mutex;  //!< ミューテックス.
+    std::unordered_map<uint64_t, std::string>   Table;  //!< ハッシュ値から文字列へのテーブル.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+// StringTable class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+StringTable::StringTable()
+: m_pImpl(new Impl())
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+StringTable::~StringTable()
+{
+    delete m_pImpl;
+    m_pImpl = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//      唯一のインスタンスを取得します.
+//-----------------------------------------------------------------------------
+StringTable& StringTable::Instance()
+{
+    static StringTable s_Instance;
+    return s_Instance;
+}
+
+//-----------------------------------------------------------------------------
+//      文字列を登録します.
+//-----------------------------------------------------------------------------
+StringId StringTable::Intern(const char* str, size_t size)
+{
+    if (str == nullptr)
+    { return StringId(); }
+
+    auto hash = CalcHash64(str, size);
+
+    std::lock_guard<std::mutex> locker(m_pImpl->Mutex);
+    auto itr = m_pImpl->Table.find(hash);
+    if (itr == m_pImpl->Table.end())
+    {
+        m_pImpl->Table.emplace(hash, std::string(str, size));
+    }
+    else if (itr->second.size() != size || memcmp(itr->second.data(), str, size) != 0)
+    {
+        // 別の文字列と同じIDを返すと区別が付かなくなるので無効値を返す.
+        ELOGA("Error : Hash Collision. %s <-> %s", itr->second.c_str(), std::string(str, size).c_str());
+        return StringId();
+    }
+
+    return StringId(hash);
+}
+
+//-----------------------------------------------------------------------------
+//      文字列を登録します.
+//-----------------------------------------------------------------------------
+StringId StringTable::Intern(const char* str)
+{
+    if (str == nullptr)
+    { return StringId(); }
+
+    return Intern(str, strlen(str));
+}
+
+//-----------------------------------------------------------------------------
+//      登録された文字列を取得します.
+//-----------------------------------------------------------------------------
+const char* StringTable::Find(StringId id) const
+{
+    std::lock_guard<std::mutex> locker(m_pImpl->Mutex);
+    auto itr = m_pImpl->Table.find(id.GetHash());
+    if (itr == m_pImpl->Table.end())
+    { return nullptr; }
+
+    return itr->second.c_str();
+}
+
+//-----------------------------------------------------------------------------
+//      登録数を取得します.
+//-----------------------------------------------------------------------------
+size_t StringTable::GetCount() const
+{
+    std::lock_guard<std::mutex> locker(m_pImpl->Mutex);
+    return m_pImpl->Table.size();
+}
+
+//-----------------------------------------------------------------------------
+//      登録された文字列を全て破棄します.
+//-----------------------------------------------------------------------------
+void StringTable::Clear()
+{
+    std::lock_guard<std::mutex> locker(m_pImpl->Mutex);
+    m_pImpl->Table.clear();
+}
+
+} // namespace asdx
@@ -17,6 +17,7 @@
 #include <fnd/asdxList.h>
 #include <fnd/asdxQueue.h>
 #include <fnd/asdxLogger.h>
+#include <fnd/asdxProfiler.h>
 
 
 namespace asdx {
@@ -163,6 +164,8 @@ private:
     //-------------------------------------------------------------------------
     void Worker()
     {
+        ASDX_PROFILE_THREAD("JobWorker");
+
         while(true)
         {
             JobNode* jobNode = nullptr;
@@ -475,7 +478,10 @@ private:
 void JobNode::Run()
 {
     // ジョブを実行.
-    Job.pListener->OnRun(Job.UserId);
+    {
+        ASDX_PROFILE_SCOPE("Job");
+        Job.pListener->OnRun(Job.UserId);
+    }
 
     // 同期ポイントに通知.
     pSyncPoint->IncrementReadyCount();
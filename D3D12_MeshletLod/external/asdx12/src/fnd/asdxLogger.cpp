@@ -9,12 +9,27 @@
 //-----------------------------------------------------------------------------
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
+#include <cwchar>
+#include <new>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <string>
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <pthread.h>
+#endif//_WIN32
 #include <fnd/asdxLogger.h>
 
 
 namespace /* anonymous */ {
 
+#ifdef _WIN32
 ///////////////////////////////////////////////////////////////////////////////
 // ConsoleColor class
 ///////////////////////////////////////////////////////////////////////////////
@@ -92,12 +107,406 @@ private:
     //=========================================================================
     /* NOTHING */
 };
+#else
+///////////////////////////////////////////////////////////////////////////////
+// ConsoleColor class
+///////////////////////////////////////////////////////////////////////////////
+class ConsoleColor
+{
+public:
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!
+    //! @note       Windows以外ではリダイレクト先を汚さないように色を変更しません.
+    //-------------------------------------------------------------------------
+    explicit ConsoleColor(asdx::LOG_LEVEL)
+    { /* DO_NOTHING */ }
+};
+#endif//_WIN32
+
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr uint32_t  kSlotSize           = 256;          // 1スロットのサイズ.
+constexpr uint32_t  kMinSlotCount       = 64;           // 最長のメッセージが収まるスロット数.
+constexpr uint32_t  kMessageLength      = 2048;         // 1メッセージの最大文字数.
+constexpr uint32_t  kFlusherWaitMs      = 5;            // 空の時にフラッシュスレッドが待機する時間.
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RecordHeader structure
+///////////////////////////////////////////////////////////////////////////////
+struct RecordHeader
+{
+    uint64_t    Time;           //!< 記録開始からの経過時間(マイクロ秒).
+    uint32_t    ThreadId;       //!< スレッドID.
+    uint32_t    Size;           //!< 文字列のバイト数.
+    uint16_t    SlotCount;      //!< レコードが占めるスロット数.
+    uint8_t     Level;          //!< ログレベル.
+    uint8_t     Wide;           //!< ワイド文字列かどうか?
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Slot structure
+///////////////////////////////////////////////////////////////////////////////
+struct alignas(64) Slot
+{
+    std::atomic<uint64_t>   Sequence;                           //!< シーケンス番号.
+    uint8_t                 Data[kSlotSize - sizeof(uint64_t)]; //!< データ.
+};
+
+static_assert(sizeof(Slot) == kSlotSize, "Slot Size Not Matched.");
+
+constexpr uint32_t  kFirstPayloadSize   = uint32_t(sizeof(Slot::Data) - sizeof(RecordHeader));
+constexpr uint32_t  kPayloadSize        = uint32_t(sizeof(Slot::Data));
+
+//-----------------------------------------------------------------------------
+//      現在のスレッドIDを取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetCurrentThreadId32()
+{
+    thread_local uint32_t s_Id = 0;
+    if (s_Id == 0)
+    {
+        auto hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+        s_Id = uint32_t(hash ^ (uint64_t(hash) >> 32));
+        if (s_Id == 0)
+        { s_Id = 1; }
+    }
+    return s_Id;
+}
+
+//-----------------------------------------------------------------------------
+//      経過時間をマイクロ秒で取得します.
+//-----------------------------------------------------------------------------
+uint64_t GetTimeMicroSec()
+{
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//-----------------------------------------------------------------------------
+//      ワイド文字列を UTF-8 に変換して追加します.
+//-----------------------------------------------------------------------------
+void AppendUTF8(std::string& dst, const wchar_t* src, size_t count)
+{
+    for(size_t i=0; i<count; ++i)
+    {
+        auto c = uint32_t(src[i]);
+
+        // UTF-16 のサロゲートペア.
+        if (sizeof(wchar_t) == 2 && c >= 0xD800 && c <= 0xDBFF && i + 1 < count)
+        {
+            auto low = uint32_t(src[i + 1]);
+            if (low >= 0xDC00 && low <= 0xDFFF)
+            {
+                c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            }
+        }
+
+        if (c < 0x80)
+        { dst.push_back(char(c)); }
+        else if (c < 0x800)
+        {
+            dst.push_back(char(0xC0 | (c >> 6)));
+            dst.push_back(char(0x80 | (c & 0x3F)));
+        }
+        else if (c < 0x10000)
+        {
+            dst.push_back(char(0xE0 | (c >> 12)));
+            dst.push_back(char(0x80 | ((c >> 6) & 0x3F)));
+            dst.push_back(char(0x80 | (c & 0x3F)));
+        }
+        else
+        {
+            dst.push_back(char(0xF0 | (c >> 18)));
+            dst.push_back(char(0x80 | ((c >> 12) & 0x3F)));
+            dst.push_back(char(0x80 | ((c >> 6) & 0x3F)));
+            dst.push_back(char(0x80 | (c & 0x3F)));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      コンソールとデバッガに出力します.
+//-----------------------------------------------------------------------------
+void OutputConsole(asdx::LOG_LEVEL level, const void* pText, bool wide)
+{
+    ConsoleColor color(level);
+    auto pStream = (level == asdx::LOG_ERROR) ? stderr : stdout;
+    if (wide)
+    {
+        auto msg = static_cast<const wchar_t*>(pText);
+    #ifdef _WIN32
+        fwprintf_s(pStream, L"%s", msg);
+        OutputDebugStringW(msg);
+    #else
+        fwprintf(pStream, L"%ls", msg);
+    #endif//_WIN32
+    }
+    else
+    {
+        auto msg = static_cast<const char*>(pText);
+        fprintf(pStream, "%s", msg);
+    #ifdef _WIN32
+        OutputDebugStringA(msg);
+    #endif//_WIN32
+    }
+}
 
 }// namespace /* anonymous */
 
 
 namespace asdx {
 
+///////////////////////////////////////////////////////////////////////////////
+// SystemLogger::AsyncContext structure
+///////////////////////////////////////////////////////////////////////////////
+struct SystemLogger::AsyncContext
+{
+    Slot*                       pSlots          = nullptr;  //!< スロット配列.
+    uint64_t                    Mask            = 0;        //!< スロット数 - 1.
+    alignas(64) std::atomic<uint64_t>   EnqueuePos;         //!< 次に確保する位置(複数の生産者).
+    alignas(64) std::atomic<uint64_t>   ConsumedPos;        //!< 書き出し済みの位置.
+    uint64_t                    DequeuePos      = 0;        //!< 次に取り出す位置(フラッシュスレッドのみ).
+    uint64_t                    StartTime       = 0;        //!< 記録開始時刻.
+    FILE*                       pBinaryFile     = nullptr;  //!< バイナリログ.
+    bool                        EchoConsole     = true;     //!< コンソールに出力するかどうか?
+    std::atomic<bool>           Running;                    //!< 実行中かどうか?
+    std::atomic<bool>           Sleeping;                   //!< フラッシュスレッドが待機中かどうか?
+    std::mutex                  Mutex;                      //!< 待機用ミューテックス.
+    std::condition_variable     Condition;                  //!< 待機用条件変数.
+    std::thread                 Flusher;                    //!< フラッシュスレッド.
+    std::vector<uint8_t>        Payload;                    //!< 取り出し用バッファ.
+    std::string                 Utf8;                       //!< UTF-8 変換用バッファ.
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    AsyncContext()
+    : EnqueuePos (0)
+    , ConsumedPos(0)
+    , Running    (false)
+    , Sleeping   (false)
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //! @brief      レコードを積みます.
+    //-------------------------------------------------------------------------
+    void Push(LOG_LEVEL level, const void* pText, uint32_t size, bool wide)
+    {
+        auto slotCount = (size <= kFirstPayloadSize)
+            ? 1u
+            : 1u + (size - kFirstPayloadSize + kPayloadSize - 1) / kPayloadSize;
+
+        // 連続する slotCount 個のスロットをまとめて確保する.
+        auto pos = EnqueuePos.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            auto full  = false;
+            auto stale = false;
+            for(auto i=0u; i<slotCount; ++i)
+            {
+                auto seq  = pSlots[(pos + i) & Mask].Sequence.load(std::memory_order_acquire);
+                auto diff = int64_t(seq) - int64_t(pos + i);
+                if (diff < 0)
+                { full = true; break; }
+                if (diff > 0)
+                { stale = true; break; }
+            }
+
+            if (!full && !stale)
+            {
+                if (EnqueuePos.compare_exchange_weak(pos, pos + slotCount, std::memory_order_relaxed))
+                { break; }
+                continue;
+            }
+
+            // 満杯の場合はフラッシュスレッドを起こして空くのを待つ.
+            if (full)
+            {
+                Wake();
+                std::this_thread::yield();
+            }
+            pos = EnqueuePos.load(std::memory_order_relaxed);
+        }
+
+        RecordHeader header = {};
+        header.Time      = GetTimeMicroSec() - StartTime;
+        header.ThreadId  = GetCurrentThreadId32();
+        header.Size      = size;
+        header.SlotCount = uint16_t(slotCount);
+        header.Level     = uint8_t(level);
+        header.Wide      = wide ? 1 : 0;
+
+        auto src    = static_cast<const uint8_t*>(pText);
+        auto pFirst = &pSlots[pos & Mask];
+        memcpy(pFirst->Data, &header, sizeof(header));
+
+        auto copySize = (size < kFirstPayloadSize) ? size : kFirstPayloadSize;
+        memcpy(pFirst->Data + sizeof(header), src, copySize);
+
+        auto offset = copySize;
+        for(auto i=1u; i<slotCount; ++i)
+        {
+            auto& slot = pSlots[(pos + i) & Mask];
+            copySize = (size - offset < kPayloadSize) ? size - offset : kPayloadSize;
+            memcpy(slot.Data, src + offset, copySize);
+            offset += copySize;
+            slot.Sequence.store(pos + i + 1, std::memory_order_release);
+        }
+
+        // 先頭スロットを最後に公開する.
+        pFirst->Sequence.store(pos + 1, std::memory_order_release);
+
+        if (level == LOG_ERROR || Sleeping.load(std::memory_order_relaxed))
+        { Wake(); }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      積まれているレコードを書き出します.
+    //!
+    //! @return     書き出したレコード数を返却します.
+    //-------------------------------------------------------------------------
+    uint32_t Drain()
+    {
+        auto count = 0u;
+        for(;;)
+        {
+            auto& first = pSlots[DequeuePos & Mask];
+            if (first.Sequence.load(std::memory_order_acquire) != DequeuePos + 1)
+            { break; }
+
+            RecordHeader header;
+            memcpy(&header, first.Data, sizeof(header));
+
+            // 終端文字分を余分に確保しておく.
+            Payload.resize(size_t(header.Size) + sizeof(wchar_t));
+            auto copySize = (header.Size < kFirstPayloadSize) ? header.Size : kFirstPayloadSize;
+            memcpy(Payload.data(), first.Data + sizeof(header), copySize);
+
+            auto offset = copySize;
+            for(auto i=1u; i<header.SlotCount; ++i)
+            {
+                auto& slot = pSlots[(DequeuePos + i) & Mask];
+                copySize = (header.Size - offset < kPayloadSize) ? header.Size - offset : kPayloadSize;
+                memcpy(Payload.data() + offset, slot.Data, copySize);
+                offset += copySize;
+            }
+            memset(Payload.data() + header.Size, 0, sizeof(wchar_t));
+
+            // スロットを次の周回用に解放.
+            for(auto i=0u; i<header.SlotCount; ++i)
+            {
+                auto pos = DequeuePos + i;
+                pSlots[pos & Mask].Sequence.store(pos + Mask + 1, std::memory_order_release);
+            }
+            DequeuePos += header.SlotCount;
+
+            Write(header);
+            count++;
+        }
+
+        if (count > 0)
+        {
+            if (EchoConsole)
+            {
+                fflush(stdout);
+                fflush(stderr);
+            }
+            ConsumedPos.store(DequeuePos, std::memory_order_release);
+        }
+
+        return count;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      1レコードを書き出します.
+    //-------------------------------------------------------------------------
+    void Write(const RecordHeader& header)
+    {
+        if (EchoConsole)
+        { OutputConsole(LOG_LEVEL(header.Level), Payload.data(), header.Wide != 0); }
+
+        if (pBinaryFile == nullptr)
+        { return; }
+
+        auto pText = reinterpret_cast<const char*>(Payload.data());
+        auto size  = header.Size;
+        if (header.Wide)
+        {
+            Utf8.clear();
+            AppendUTF8(Utf8, reinterpret_cast<const wchar_t*>(Payload.data()), header.Size / sizeof(wchar_t));
+            pText = Utf8.data();
+            size  = uint32_t(Utf8.size());
+        }
+
+        BinaryLogRecord record = {};
+        record.Time     = header.Time;
+        record.ThreadId = header.ThreadId;
+        record.Level    = header.Level;
+        record.Length   = size;
+        fwrite(&record, sizeof(record), 1, pBinaryFile);
+        fwrite(pText, 1, size, pBinaryFile);
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      フラッシュスレッドを起こします.
+    //-------------------------------------------------------------------------
+    void Wake()
+    {
+        std::lock_guard<std::mutex> locker(Mutex);
+        Condition.notify_one();
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      フラッシュスレッドの処理です.
+    //-------------------------------------------------------------------------
+    void Run()
+    {
+        for(;;)
+        {
+            if (Drain() > 0)
+            { continue; }
+
+            if (!Running.load(std::memory_order_acquire))
+            {
+                // 停止要求前に確保された分を書き出し終えたら終了.
+                if (DequeuePos == EnqueuePos.load(std::memory_order_acquire))
+                { break; }
+
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> locker(Mutex);
+            Sleeping.store(true, std::memory_order_relaxed);
+            Condition.wait_for(locker, std::chrono::milliseconds(kFlusherWaitMs));
+            Sleeping.store(false, std::memory_order_relaxed);
+        }
+
+        if (pBinaryFile != nullptr)
+        { fflush(pBinaryFile); }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      メモリを解放します.
+    //-------------------------------------------------------------------------
+    ~AsyncContext()
+    {
+        if (pBinaryFile != nullptr)
+        {
+            fclose(pBinaryFile);
+            pBinaryFile = nullptr;
+        }
+
+        delete[] pSlots;
+        pSlots = nullptr;
+    }
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // SystemLogger class
 ///////////////////////////////////////////////////////////////////////////////
@@ -107,8 +516,25 @@ SystemLogger SystemLogger::s_Instance;
 //      コンストラクタです
 //-----------------------------------------------------------------------------
 SystemLogger::SystemLogger()
-: m_Filter(LOG_VERBOSE)
-{ /* DO_NOTHING */ }
+: m_Filter      (LOG_VERBOSE)
+, m_pAsync      (nullptr)
+, m_Writers     (0)
+, m_DroppedCount(0)
+{
+    for(auto i=0u; i<LOG_LEVEL_COUNT; ++i)
+    {
+        m_Rate[i].Limit  .store(0);
+        m_Rate[i].Window .store(0);
+        m_Rate[i].Count  .store(0);
+        m_Rate[i].Dropped.store(0);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+SystemLogger::~SystemLogger()
+{ StopAsync(); }
 
 //-----------------------------------------------------------------------------
 //      インスタンスを取得します.
@@ -121,22 +547,20 @@ SystemLogger& SystemLogger::Instance()
 //-----------------------------------------------------------------------------
 void SystemLogger::WriteA(LOG_LEVEL level, const char* format, ... )
 {
-    if ( level >= m_Filter )
+    if ( level >= m_Filter && CheckRateLimit(level) )
     {
-        ConsoleColor color(level);
-        // ログ出力.
-        {
-            char msg[ 2048 ] = "\0";
-            va_list arg;
-
-            va_start( arg, format );
-            vsprintf_s( msg, format, arg );
-            va_end( arg );
-
-            fprintf((level == LOG_ERROR ? stderr : stdout), "%s", msg );
-
-            OutputDebugStringA( msg );
-        }
+        char msg[ kMessageLength ] = "\0";
+        va_list arg;
+
+        va_start( arg, format );
+    #ifdef _WIN32
+        vsprintf_s( msg, format, arg );
+    #else
+        vsnprintf( msg, sizeof(msg), format, arg );
+    #endif//_WIN32
+        va_end( arg );
+
+        Dispatch( level, msg, uint32_t(strlen(msg)), false );
     }
 }
 
@@ -145,22 +569,20 @@ void SystemLogger::WriteA(LOG_LEVEL level, const char* format, ... )
 //-----------------------------------------------------------------------------
 void SystemLogger::WriteW(LOG_LEVEL level, const wchar_t* format, ... )
 {
-    if ( level >= m_Filter )
+    if ( level >= m_Filter && CheckRateLimit(level) )
     {
-        ConsoleColor color(level);
-        // ログ出力.
-        {
-            wchar_t msg[ 2048 ] = L"\0";
-            va_list arg;
-
-            va_start( arg, format );
-            vswprintf_s( msg, format, arg );
-            va_end( arg );
-
-            fwprintf_s((level == LOG_ERROR ? stderr : stdout), L"%s", msg );
-
-            OutputDebugStringW( msg );
-        }
+        wchar_t msg[ kMessageLength ] = L"\0";
+        va_list arg;
+
+        va_start( arg, format );
+    #ifdef _WIN32
+        vswprintf_s( msg, format, arg );
+    #else
+        vswprintf( msg, sizeof(msg) / sizeof(msg[0]), format, arg );
+    #endif//_WIN32
+        va_end( arg );
+
+        Dispatch( level, msg, uint32_t(wcslen(msg) * sizeof(wchar_t)), true );
     }
 }
 
@@ -176,4 +598,223 @@ void SystemLogger::SetFilter( const LOG_LEVEL filter )
 LOG_LEVEL SystemLogger::GetFilter()
 { return m_Filter; }
 
+//-----------------------------------------------------------------------------
+//      非同期出力を開始します.
+//-----------------------------------------------------------------------------
+bool SystemLogger::StartAsync(const AsyncLogDesc& desc)
+{
+    if (m_pAsync.load() != nullptr)
+    { StopAsync(); }
+
+    auto slotCount = uint64_t(kMinSlotCount);
+    while (slotCount < desc.SlotCount)
+    { slotCount <<= 1; }
+
+    auto pContext = new (std::nothrow) AsyncContext();
+    if (pContext == nullptr)
+    { return false; }
+
+    pContext->pSlots = new (std::nothrow) Slot[size_t(slotCount)];
+    if (pContext->pSlots == nullptr)
+    {
+        delete pContext;
+        return false;
+    }
+
+    for(auto i=0u; i<slotCount; ++i)
+    { pContext->pSlots[i].Sequence.store(i, std::memory_order_relaxed); }
+
+    pContext->Mask          = slotCount - 1;
+    pContext->StartTime     = GetTimeMicroSec();
+    pContext->EchoConsole   = desc.EchoConsole;
+
+    if (desc.BinaryLogPath != nullptr)
+    {
+        FILE* pFile = nullptr;
+    #ifdef _WIN32
+        auto err = fopen_s(&pFile, desc.BinaryLogPath, "wb");
+    #else
+        pFile = fopen(desc.BinaryLogPath, "wb");
+        auto err = (pFile == nullptr) ? 1 : 0;
+    #endif//_WIN32
+        if (err != 0 || pFile == nullptr)
+        {
+            delete pContext;
+            ELOGA("Error : File Open Failed. path = %s", desc.BinaryLogPath);
+            return false;
+        }
+
+        BinaryLogHeader header = {};
+        header.Magic[0]  = 'A';
+        header.Magic[1]  = 'L';
+        header.Magic[2]  = 'O';
+        header.Magic[3]  = 'G';
+        header.Version   = BINARY_LOG_VERSION;
+        header.StartTime = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        fwrite(&header, sizeof(header), 1, pFile);
+
+        pContext->pBinaryFile = pFile;
+    }
+
+    pContext->Running.store(true);
+    pContext->Flusher = std::thread([pContext]() { pContext->Run(); });
+
+#ifndef _WIN32
+    static std::once_flag s_AtFork;
+    std::call_once(s_AtFork, []() { pthread_atfork(&SystemLogger::OnForkPrepare, nullptr, &SystemLogger::OnForkChild); });
+#endif//_WIN32
+
+    m_pAsync.store(pContext, std::memory_order_release);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      非同期出力を終了します.
+//-----------------------------------------------------------------------------
+void SystemLogger::StopAsync()
+{
+    auto pContext = m_pAsync.exchange(nullptr);
+    if (pContext == nullptr)
+    { return; }
+
+    // 書き込み中のスレッドが抜けるのを待つ.
+    while (m_Writers.load(std::memory_order_acquire) != 0)
+    { std::this_thread::yield(); }
+
+    pContext->Running.store(false, std::memory_order_release);
+    pContext->Wake();
+    if (pContext->Flusher.joinable())
+    { pContext->Flusher.join(); }
+
+    delete pContext;
+}
+
+//-----------------------------------------------------------------------------
+//      fork() 後の子プロセスで非同期出力を切り離します.
+//-----------------------------------------------------------------------------
+void SystemLogger::DetachAsync()
+{
+    // 子プロセスにはフラッシュスレッドが存在せず, ファイルは親と共有しているので
+    // コンテキストには触れずに手放して同期出力に戻す.
+    m_pAsync.store(nullptr);
+    m_Writers.store(0);
+}
+
+//-----------------------------------------------------------------------------
+//      fork() の直前に積まれているログを書き出します.
+//-----------------------------------------------------------------------------
+void SystemLogger::OnForkPrepare()
+{
+    auto& logger = Instance();
+    logger.Flush();
+
+    // 子プロセスの終了時に親のバッファが二重に書き出されないようにする.
+    auto pContext = logger.m_pAsync.load(std::memory_order_acquire);
+    if (pContext != nullptr && pContext->pBinaryFile != nullptr)
+    { fflush(pContext->pBinaryFile); }
+}
+
+//-----------------------------------------------------------------------------
+//      fork() 後の子プロセスで同期出力に戻します.
+//-----------------------------------------------------------------------------
+void SystemLogger::OnForkChild()
+{ Instance().DetachAsync(); }
+
+//-----------------------------------------------------------------------------
+//      呼び出し時点までに積まれたログが書き出されるまで待機します.
+//-----------------------------------------------------------------------------
+void SystemLogger::Flush()
+{
+    m_Writers.fetch_add(1, std::memory_order_acquire);
+    auto pContext = m_pAsync.load(std::memory_order_acquire);
+    if (pContext != nullptr)
+    {
+        auto target = pContext->EnqueuePos.load(std::memory_order_acquire);
+        while (pContext->ConsumedPos.load(std::memory_order_acquire) < target)
+        {
+            pContext->Wake();
+            std::this_thread::yield();
+        }
+    }
+    m_Writers.fetch_sub(1, std::memory_order_release);
+
+    fflush(stdout);
+    fflush(stderr);
+}
+
+//-----------------------------------------------------------------------------
+//      非同期出力中かどうかチェックします.
+//-----------------------------------------------------------------------------
+bool SystemLogger::IsAsync() const
+{ return m_pAsync.load(std::memory_order_acquire) != nullptr; }
+
+//-----------------------------------------------------------------------------
+//      レベル毎の1秒当たりの出力数上限を設定します.
+//-----------------------------------------------------------------------------
+void SystemLogger::SetRateLimit(LOG_LEVEL level, uint32_t count)
+{
+    if (level >= LOG_LEVEL_COUNT)
+    { return; }
+
+    m_Rate[level].Limit.store(count, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+//      出力数上限により破棄したログの累計数を取得します.
+//-----------------------------------------------------------------------------
+uint64_t SystemLogger::GetDroppedCount() const
+{ return m_DroppedCount.load(std::memory_order_relaxed); }
+
+//-----------------------------------------------------------------------------
+//      出力数上限をチェックします.
+//-----------------------------------------------------------------------------
+bool SystemLogger::CheckRateLimit(LOG_LEVEL level)
+{
+    auto& rate  = m_Rate[level];
+    auto  limit = rate.Limit.load(std::memory_order_relaxed);
+    if (limit == 0)
+    { return true; }
+
+    auto window = GetTimeMicroSec() / 1000000;
+    auto prev   = rate.Window.load(std::memory_order_relaxed);
+    if (prev != window && rate.Window.compare_exchange_strong(prev, window, std::memory_order_relaxed))
+    {
+        // 新しい時間窓の最初の1回で前の窓の破棄数を通知する.
+        rate.Count.store(0, std::memory_order_relaxed);
+        auto dropped = rate.Dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0)
+        {
+            char msg[128];
+            snprintf(msg, sizeof(msg), "[asdx] %u log messages were dropped by rate limit.\n", dropped);
+            Dispatch(level, msg, uint32_t(strlen(msg)), false);
+        }
+    }
+
+    if (rate.Count.fetch_add(1, std::memory_order_relaxed) < limit)
+    { return true; }
+
+    rate.Dropped.fetch_add(1, std::memory_order_relaxed);
+    m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+//      書式化済みの文字列を出力先に振り分けます.
+//-----------------------------------------------------------------------------
+void SystemLogger::Dispatch(LOG_LEVEL level, const void* pText, uint32_t size, bool wide)
+{
+    m_Writers.fetch_add(1, std::memory_order_acquire);
+    auto pContext = m_pAsync.load(std::memory_order_acquire);
+    if (pContext != nullptr)
+    {
+        pContext->Push(level, pText, size, wide);
+        m_Writers.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+    m_Writers.fetch_sub(1, std::memory_order_release);
+
+    OutputConsole(level, pText, wide);
+}
+
 } // namespace asdx
@@ -0,0 +1,164 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMappedFile.cpp
+// Desc : Memory Mapped File.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <fnd/asdxMappedFile.h>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+MappedFile::MappedFile()
+: m_hFile   (nullptr)
+, m_hMapping(nullptr)
+, m_pData   (nullptr)
+, m_Size    (0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{ Close(); }
+
+//-----------------------------------------------------------------------------
+//      ファイルを読み取り専用でメモリにマップします.
+//-----------------------------------------------------------------------------
+bool MappedFile::Open(const char* path)
+{
+    Close();
+
+#ifdef _WIN32
+    auto hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    { return false; }
+
+    m_hFile = hFile;
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(hFile, &size))
+    {
+        Close();
+        return false;
+    }
+
+    m_Size = size_t(size.QuadPart);
+    if (m_Size == 0)
+    { return true; }
+
+    m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_hMapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_pData == nullptr)
+    {
+        Close();
+        return false;
+    }
+#else
+    auto fd = open(path, O_RDONLY);
+    if (fd < 0)
+    { return false; }
+
+    // ファイルディスクリプタは 0 になり得るので +1 して保持する.
+    m_hFile = reinterpret_cast<void*>(intptr_t(fd) + 1);
+
+    struct stat info = {};
+    if (fstat(fd, &info) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    m_Size = size_t(info.st_size);
+    if (m_Size == 0)
+    { return true; }
+
+    auto ptr = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+
+    madvise(ptr, m_Size, MADV_SEQUENTIAL);
+    m_pData = static_cast<const uint8_t*>(ptr);
+#endif
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      マップを解除してファイルを閉じます.
+//-----------------------------------------------------------------------------
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (m_pData != nullptr)
+    { UnmapViewOfFile(m_pData); }
+
+    if (m_hMapping != nullptr)
+    { CloseHandle(m_hMapping); }
+
+    if (m_hFile != nullptr)
+    { CloseHandle(m_hFile); }
+#else
+    if (m_pData != nullptr)
+    { munmap(const_cast<uint8_t*>(m_pData), m_Size); }
+
+    if (m_hFile != nullptr)
+    { close(int(reinterpret_cast<intptr_t>(m_hFile) - 1)); }
+#endif
+
+    m_hFile    = nullptr;
+    m_hMapping = nullptr;
+    m_pData    = nullptr;
+    m_Size     = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      読み終えた先頭からの範囲を物理メモリから追い出します.
+//-----------------------------------------------------------------------------
+void MappedFile::Evict(size_t size)
+{
+    if (m_pData == nullptr)
+    { return; }
+
+    if (size > m_Size)
+    { size = m_Size; }
+
+#ifdef _WIN32
+    // ロックされていない範囲への VirtualUnlock はワーキングセットから取り除く.
+    VirtualUnlock(const_cast<uint8_t*>(m_pData), size);
+#else
+    size &= ~(size_t(sysconf(_SC_PAGESIZE)) - 1);
+    if (size > 0)
+    { madvise(const_cast<uint8_t*>(m_pData), size, MADV_DONTNEED); }
+#endif
+}
+
+} // namespace asdx
@@ -0,0 +1,628 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxProfiler.cpp
+// Desc : CPU Profiler.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <algorithm>
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define ASDX_PROFILE_USE_RDTSC  (1)
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ASDX_PROFILE_USE_RDTSC  (1)
+#endif
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif//_WIN32
+#include <fnd/asdxProfiler.h>
+#include <fnd/asdxLogger.h>
+
+
+namespace /* anonymous */ {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr uint32_t  kEventsPerChunk     = 4096;     // 1チャンクのイベント数.
+constexpr uint32_t  kMaxThreadName      = 64;       // スレッド名の最大文字数.
+
+///////////////////////////////////////////////////////////////////////////////
+// PROFILE_EVENT_TYPE enum
+///////////////////////////////////////////////////////////////////////////////
+enum PROFILE_EVENT_TYPE : uint32_t
+{
+    PROFILE_EVENT_ZONE  = 0,    //!< ゾーン.
+    PROFILE_EVENT_FRAME = 1,    //!< フレームの区切り.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ProfileEvent structure
+///////////////////////////////////////////////////////////////////////////////
+struct ProfileEvent
+{
+    const char*     Name;       //!< ゾーン名.
+    uint64_t        Begin;      //!< 開始時のカウンタ値.
+    uint64_t        End;        //!< 終了時のカウンタ値.
+    uint32_t        Type;       //!< イベントタイプ.
+    uint32_t        Param;      //!< ゾーンの場合はネストの深さ, フレームの場合はフレーム番号.
+};
+
+static_assert(sizeof(ProfileEvent) == 32, "ProfileEvent Size Not Matched.");
+
+///////////////////////////////////////////////////////////////////////////////
+// EventChunk structure
+///////////////////////////////////////////////////////////////////////////////
+struct EventChunk
+{
+    ProfileEvent                Events[kEventsPerChunk];    //!< イベント.
+    std::atomic<uint32_t>       Count;                      //!< 公開済みのイベント数.
+    std::atomic<EventChunk*>    pNext;                      //!< 次のチャンク.
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!
+    //! @note       イベント配列は書き込み時に埋めるのでゼロクリアしません.
+    //-------------------------------------------------------------------------
+    EventChunk()
+    : Count(0)
+    , pNext(nullptr)
+    { /* DO_NOTHING */ }
+};
+
+//-----------------------------------------------------------------------------
+// Global Variables.
+//-----------------------------------------------------------------------------
+std::mutex                      g_NameMutex;    // 文字列テーブル用ミューテックス.
+std::unordered_set<std::string> g_Names;        // 文字列テーブル.
+
+//-----------------------------------------------------------------------------
+//      カウンタ値を取得します.
+//-----------------------------------------------------------------------------
+inline uint64_t GetTick()
+{
+#ifdef ASDX_PROFILE_USE_RDTSC
+    return __rdtsc();
+#else
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      経過時間をナノ秒で取得します.
+//-----------------------------------------------------------------------------
+int64_t GetNanoSec()
+{
+    return int64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//-----------------------------------------------------------------------------
+//      プロセスIDを取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetProcessId32()
+{
+#ifdef _WIN32
+    return uint32_t(_getpid());
+#else
+    return uint32_t(getpid());
+#endif//_WIN32
+}
+
+//-----------------------------------------------------------------------------
+//      JSON文字列として書き出します.
+//-----------------------------------------------------------------------------
+void WriteJsonString(FILE* pFile, const char* value)
+{
+    fputc('"', pFile);
+    for(auto ptr = value; *ptr != '\0'; ++ptr)
+    {
+        auto c = uint8_t(*ptr);
+        switch(c)
+        {
+        case '"':   fputs("\\\"", pFile); break;
+        case '\\':  fputs("\\\\", pFile); break;
+        case '\n':  fputs("\\n",  pFile); break;
+        case '\r':  fputs("\\r",  pFile); break;
+        case '\t':  fputs("\\t",  pFile); break;
+        default:
+            if (c < 0x20)
+            { fprintf(pFile, "\\u%04x", c); }
+            else
+            { fputc(c, pFile); }
+            break;
+        }
+    }
+    fputc('"', pFile);
+}
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// ProfileThread structure
+///////////////////////////////////////////////////////////////////////////////
+struct ProfileThread
+{
+    ProfileThread*          pNext       = nullptr;  //!< 次のスレッド(登録後は不変).
+    uint32_t                Index       = 0;        //!< 書き出し時のスレッド番号.
+    uint32_t                Depth       = 0;        //!< 現在のネストの深さ.
+    uint32_t                EventCount  = 0;        //!< 今回の計測で記録したイベント数.
+    std::atomic<uint32_t>   Generation;             //!< 記録中の計測回数.
+    std::atomic<uint64_t>   Dropped;                //!< 上限を超えて破棄したイベント数.
+    EventChunk*             pHead       = nullptr;  //!< 先頭チャンク(登録後は不変).
+    EventChunk*             pTail       = nullptr;  //!< 書き込み中のチャンク.
+    char                    Name[kMaxThreadName] = {};  //!< スレッド名.
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    ProfileThread()
+    : Generation(0)
+    , Dropped   (0)
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~ProfileThread()
+    {
+        auto chunk = pHead;
+        while(chunk != nullptr)
+        {
+            auto next = chunk->pNext.load(std::memory_order_relaxed);
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      新しい計測のために記録内容を破棄します.
+    //!
+    //! @note       書き込むスレッド自身が呼び出すので, チャンクは再利用します.
+    //-------------------------------------------------------------------------
+    void Reset(uint32_t generation)
+    {
+        for(auto chunk = pHead; chunk != nullptr; chunk = chunk->pNext.load(std::memory_order_relaxed))
+        { chunk->Count.store(0, std::memory_order_relaxed); }
+
+        pTail      = pHead;
+        EventCount = 0;
+        Dropped.store(0, std::memory_order_relaxed);
+        Generation.store(generation, std::memory_order_release);
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      イベントを追加します.
+    //-------------------------------------------------------------------------
+    void Push(const ProfileEvent& value, uint32_t generation, uint32_t maxCount)
+    {
+        if (Generation.load(std::memory_order_relaxed) != generation)
+        { Reset(generation); }
+
+        if (EventCount >= maxCount)
+        {
+            Dropped.store(Dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto chunk = pTail;
+        auto count = chunk->Count.load(std::memory_order_relaxed);
+        if (count == kEventsPerChunk)
+        {
+            // 前回の計測で確保したチャンクがあれば使い回す.
+            auto next = chunk->pNext.load(std::memory_order_relaxed);
+            if (next == nullptr)
+            {
+                next = new (std::nothrow) EventChunk();
+                if (next == nullptr)
+                {
+                    Dropped.store(Dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return;
+                }
+                chunk->pNext.store(next, std::memory_order_release);
+            }
+
+            pTail = chunk = next;
+            count = 0;
+        }
+
+        chunk->Events[count] = value;
+        chunk->Count.store(count + 1, std::memory_order_release);
+        EventCount++;
+    }
+};
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Thread Local Variables.
+//-----------------------------------------------------------------------------
+thread_local ProfileThread* t_pThread = nullptr;
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Profiler class
+///////////////////////////////////////////////////////////////////////////////
+Profiler Profiler::s_Instance;
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+Profiler::Profiler()
+: m_Capturing       (false)
+, m_Generation      (0)
+, m_FrameIndex      (0)
+, m_pThreads        (nullptr)
+, m_ThreadCount     (0)
+, m_MaxEventCount   (0)
+, m_StartTick       (0)
+, m_StopTick        (0)
+, m_StartNanoSec    (0)
+, m_StopNanoSec     (0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+Profiler::~Profiler()
+{
+    m_Capturing.store(false);
+
+    auto thread = m_pThreads.exchange(nullptr);
+    while(thread != nullptr)
+    {
+        auto next = thread->pNext;
+        delete thread;
+        thread = next;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      計測を開始します.
+//-----------------------------------------------------------------------------
+void Profiler::Start(const ProfileDesc& desc)
+{
+    m_Capturing.store(false);
+
+    m_MaxEventCount = desc.MaxEventCountPerThread;
+    m_FrameIndex.store(0);
+
+    // 各スレッドは次の書き込み時に世代の変化に気づいて自分のバッファを破棄する.
+    m_Generation.fetch_add(1);
+
+    m_StartTick    = GetTick();
+    m_StartNanoSec = GetNanoSec();
+    m_StopTick     = 0;
+    m_StopNanoSec  = 0;
+
+    m_Capturing.store(true, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+//      計測を終了します.
+//-----------------------------------------------------------------------------
+void Profiler::Stop()
+{
+    if (!m_Capturing.exchange(false))
+        return;
+
+    m_StopTick    = GetTick();
+    m_StopNanoSec = GetNanoSec();
+}
+
+//-----------------------------------------------------------------------------
+//      ゾーンを開始します.
+//-----------------------------------------------------------------------------
+uint64_t Profiler::BeginZone()
+{
+    auto thread = GetThread();
+    if (thread != nullptr)
+    { thread->Depth++; }
+
+    return GetTick();
+}
+
+//-----------------------------------------------------------------------------
+//      ゾーンを終了します.
+//-----------------------------------------------------------------------------
+void Profiler::EndZone(const char* name, uint64_t begin)
+{
+    auto end = GetTick();
+
+    auto thread = GetThread();
+    if (thread == nullptr)
+        return;
+
+    if (thread->Depth > 0)
+    { thread->Depth--; }
+
+    ProfileEvent value;
+    value.Name  = name;
+    value.Begin = begin;
+    value.End   = end;
+    value.Type  = PROFILE_EVENT_ZONE;
+    value.Param = thread->Depth;
+
+    thread->Push(value, m_Generation.load(std::memory_order_relaxed), m_MaxEventCount);
+}
+
+//-----------------------------------------------------------------------------
+//      フレームの区切りを記録します.
+//-----------------------------------------------------------------------------
+void Profiler::MarkFrame()
+{
+    if (!IsCapturing())
+        return;
+
+    auto thread = GetThread();
+    if (thread == nullptr)
+        return;
+
+    auto tick = GetTick();
+
+    ProfileEvent value;
+    value.Name  = nullptr;
+    value.Begin = tick;
+    value.End   = tick;
+    value.Type  = PROFILE_EVENT_FRAME;
+    value.Param = m_FrameIndex.fetch_add(1, std::memory_order_relaxed);
+
+    thread->Push(value, m_Generation.load(std::memory_order_relaxed), m_MaxEventCount);
+}
+
+//-----------------------------------------------------------------------------
+//      呼び出し元スレッドの名前を設定します.
+//-----------------------------------------------------------------------------
+void Profiler::SetThreadName(const char* name)
+{
+    auto thread = GetThread();
+    if (thread == nullptr || name == nullptr)
+        return;
+
+    auto size = strlen(name);
+    if (size >= kMaxThreadName)
+    { size = kMaxThreadName - 1; }
+
+    memcpy(thread->Name, name, size);
+    thread->Name[size] = '\0';
+}
+
+//-----------------------------------------------------------------------------
+//      ゾーン名として使える寿命の長い文字列を取得します.
+//-----------------------------------------------------------------------------
+const char* Profiler::InternName(const char* name)
+{
+    if (name == nullptr)
+        return nullptr;
+
+    std::lock_guard<std::mutex> locker(g_NameMutex);
+    return g_Names.emplace(name).first->c_str();
+}
+
+//-----------------------------------------------------------------------------
+//      Chrome のトレースイベント形式(JSON)で保存します.
+//-----------------------------------------------------------------------------
+bool Profiler::SaveChromeTrace(const char* path) const
+{
+    if (path == nullptr)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+    FILE* pFile = nullptr;
+#ifdef _WIN32
+    auto err = fopen_s(&pFile, path, "w");
+#else
+    pFile = fopen(path, "w");
+    auto err = (pFile == nullptr) ? 1 : 0;
+#endif//_WIN32
+    if (err != 0 || pFile == nullptr)
+    {
+        ELOGA("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    // 計測中に呼ばれた場合は現在時刻までで換算する.
+    auto stopTick = m_StopTick;
+    auto stopNano = m_StopNanoSec;
+    if (IsCapturing() || stopTick == 0)
+    {
+        stopTick = GetTick();
+        stopNano = GetNanoSec();
+    }
+
+    // カウンタ値からマイクロ秒への換算係数.
+    auto tickToMicroSec = 0.001;
+    if (stopTick > m_StartTick && stopNano > m_StartNanoSec)
+    { tickToMicroSec = double(stopNano - m_StartNanoSec) * 0.001 / double(stopTick - m_StartTick); }
+
+    auto generation = m_Generation.load(std::memory_order_acquire);
+    auto pid        = GetProcessId32();
+
+    // スレッド番号順に並べる.
+    std::vector<const ProfileThread*> threads;
+    for(auto thread = m_pThreads.load(std::memory_order_acquire); thread != nullptr; thread = thread->pNext)
+    {
+        if (thread->Generation.load(std::memory_order_acquire) == generation)
+        { threads.push_back(thread); }
+    }
+    std::sort(threads.begin(), threads.end(),
+        [](const ProfileThread* lhs, const ProfileThread* rhs) { return lhs->Index < rhs->Index; });
+
+    auto toMicroSec = [&](uint64_t tick)
+    { return (tick > m_StartTick) ? double(tick - m_StartTick) * tickToMicroSec : 0.0; };
+
+    uint64_t dropped = 0;
+    auto first = true;
+    auto separator = [&]()
+    {
+        fputs(first ? "\n" : ",\n", pFile);
+        first = false;
+    };
+
+    fputs("{\"traceEvents\":[", pFile);
+
+    for(auto thread : threads)
+    {
+        char name[kMaxThreadName + 16];
+        if (thread->Name[0] != '\0')
+        { snprintf(name, sizeof(name), "%s", thread->Name); }
+        else
+        { snprintf(name, sizeof(name), "Thread %u", thread->Index); }
+
+        separator();
+        fprintf(pFile, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":", pid, thread->Index);
+        WriteJsonString(pFile, name);
+        fputs("}}", pFile);
+
+        separator();
+        fprintf(pFile, "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"sort_index\":%u}}",
+            pid, thread->Index, thread->Index);
+
+        for(auto chunk = thread->pHead; chunk != nullptr; chunk = chunk->pNext.load(std::memory_order_acquire))
+        {
+            auto count = chunk->Count.load(std::memory_order_acquire);
+            for(auto i=0u; i<count; ++i)
+            {
+                const auto& item = chunk->Events[i];
+                auto ts = toMicroSec(item.Begin);
+
+                separator();
+                if (item.Type == PROFILE_EVENT_FRAME)
+                {
+                    fprintf(pFile, "{\"name\":\"Frame %u\",\"cat\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f}",
+                        item.Param, pid, thread->Index, ts);
+                }
+                else
+                {
+                    auto dur = toMicroSec(item.End) - ts;
+                    fputs("{\"name\":", pFile);
+                    WriteJsonString(pFile, (item.Name != nullptr) ? item.Name : "(null)");
+                    fprintf(pFile, ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}",
+                        pid, thread->Index, ts, (dur > 0.0) ? dur : 0.0, item.Param);
+                }
+            }
+
+            // 未使用のチャンクは辿らない.
+            if (count < kEventsPerChunk)
+                break;
+        }
+
+        dropped += thread->Dropped.load(std::memory_order_relaxed);
+    }
+
+    fprintf(pFile, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":%llu}}\n", (unsigned long long)dropped);
+
+    auto valid = (ferror(pFile) == 0);
+    fclose(pFile);
+
+    if (!valid)
+    {
+        ELOGA("Error : File Write Failed. path = %s", path);
+        return false;
+    }
+
+    if (dropped > 0)
+    { WLOGA("Warning : Profile Events Dropped. count = %llu", (unsigned long long)dropped); }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      記録したイベント数を取得します.
+//-----------------------------------------------------------------------------
+uint64_t Profiler::GetEventCount() const
+{
+    auto generation = m_Generation.load(std::memory_order_acquire);
+
+    uint64_t result = 0;
+    for(auto thread = m_pThreads.load(std::memory_order_acquire); thread != nullptr; thread = thread->pNext)
+    {
+        if (thread->Generation.load(std::memory_order_acquire) != generation)
+            continue;
+
+        for(auto chunk = thread->pHead; chunk != nullptr; chunk = chunk->pNext.load(std::memory_order_acquire))
+        {
+            auto count = chunk->Count.load(std::memory_order_acquire);
+            result += count;
+            if (count < kEventsPerChunk)
+                break;
+        }
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      上限を超えて破棄したイベント数を取得します.
+//-----------------------------------------------------------------------------
+uint64_t Profiler::GetDroppedCount() const
+{
+    auto generation = m_Generation.load(std::memory_order_acquire);
+
+    uint64_t result = 0;
+    for(auto thread = m_pThreads.load(std::memory_order_acquire); thread != nullptr; thread = thread->pNext)
+    {
+        if (thread->Generation.load(std::memory_order_acquire) == generation)
+        { result += thread->Dropped.load(std::memory_order_relaxed); }
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      呼び出し元スレッドのバッファを取得します.
+//-----------------------------------------------------------------------------
+ProfileThread* Profiler::GetThread()
+{
+    if (t_pThread != nullptr)
+        return t_pThread;
+
+    // スレッド毎に初回だけ確保して, ロックせずにリストの先頭に繋ぐ.
+    auto thread = new (std::nothrow) ProfileThread();
+    if (thread == nullptr)
+        return nullptr;
+
+    thread->pHead = new (std::nothrow) EventChunk();
+    if (thread->pHead == nullptr)
+    {
+        delete thread;
+        return nullptr;
+    }
+
+    thread->pTail = thread->pHead;
+    thread->Index = m_ThreadCount.fetch_add(1) + 1;
+    thread->Generation.store(m_Generation.load());
+
+    auto head = m_pThreads.load(std::memory_order_relaxed);
+    do
+    {
+        thread->pNext = head;
+    }
+    while(!m_pThreads.compare_exchange_weak(head, thread, std::memory_order_release, std::memory_order_relaxed));
+
+    t_pThread = thread;
+    return thread;
+}
+
+} // namespace asdx
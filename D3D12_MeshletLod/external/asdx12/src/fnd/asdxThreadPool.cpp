@@ -14,6 +14,7 @@
 #include <condition_variable>
 #include <cassert>
 #include <fnd/asdxThreadPool.h>
+#include <fnd/asdxProfiler.h>
 
 
 namespace asdx {
@@ -130,6 +131,8 @@ private:
 
     std::function<void()> m_Worker = [this]()
     {
+        ASDX_PROFILE_THREAD("ThreadPool");
+
         while(true)
         {
             IRunnable* runnable = nullptr;
@@ -147,6 +150,7 @@ private:
                 assert(runnable != nullptr);
             }
 
+            ASDX_PROFILE_SCOPE("ThreadPool::Run");
             runnable->Run();
         }
     };
@@ -9,6 +9,195 @@
 //-----------------------------------------------------------------------------
 #include <fnd/asdxTokenizer.h>
 #include <new>
+#include <cstdlib>
+#include <cctype>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// CHAR_CLASS enum
+///////////////////////////////////////////////////////////////////////////////
+enum CHAR_CLASS : uint8_t
+{
+    CHAR_CLASS_SEPARATOR    = 0x1,  //!< 区切り文字.
+    CHAR_CLASS_CUTOFF       = 0x2,  //!< 切り出し文字.
+    CHAR_CLASS_NEWLINE      = 0x4,  //!< 改行.
+    CHAR_CLASS_END          = 0x8,  //!< 終端文字.
+};
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const char*  kDefaultSeparator   = " \t\r";
+static const size_t kMaxNumberLength    = 128;  // C ランタイムに渡す数値文字列の最大長.
+static const int    kMaxExactExponent   = 22;   // double で 10^n を厳密に表現できる最大指数.
+
+static const double kPow10[kMaxExactExponent + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Decimal structure
+///////////////////////////////////////////////////////////////////////////////
+struct Decimal
+{
+    uint64_t    Mantissa;   //!< 仮数(最大19桁).
+    int32_t     Exponent;   //!< 10進指数.
+    bool        Negative;   //!< 負数かどうか?
+    bool        Exact;      //!< 仮数に切り捨てた桁が無いかどうか?
+    const char* Ptr;        //!< 解析を終えた位置.
+};
+
+//-----------------------------------------------------------------------------
+//      数字かどうかチェックします.
+//-----------------------------------------------------------------------------
+inline bool IsDigit(char c)
+{ return uint8_t(c - '0') < 10; }
+
+//-----------------------------------------------------------------------------
+//      10進数の実数表記を仮数と指数に分解します.
+//-----------------------------------------------------------------------------
+bool ParseDecimal(const char* first, const char* last, Decimal& result)
+{
+    auto p = first;
+
+    result.Mantissa = 0;
+    result.Exponent = 0;
+    result.Negative = false;
+    result.Exact    = true;
+
+    if (p < last && (*p == '-' || *p == '+'))
+    {
+        result.Negative = (*p == '-');
+        p++;
+    }
+
+    auto digits = 0;
+    auto found  = false;
+
+    // 整数部.
+    for(; p < last && IsDigit(*p); ++p)
+    {
+        found = true;
+        if (digits < 19)
+        {
+            result.Mantissa = result.Mantissa * 10 + uint64_t(*p - '0');
+            digits += (result.Mantissa != 0) ? 1 : 0;
+        }
+        else
+        {
+            result.Exponent++;
+            result.Exact &= (*p == '0');
+        }
+    }
+
+    // 小数部.
+    if (p < last && *p == '.')
+    {
+        p++;
+        for(; p < last && IsDigit(*p); ++p)
+        {
+            found = true;
+            if (digits < 19)
+            {
+                result.Mantissa = result.Mantissa * 10 + uint64_t(*p - '0');
+                digits += (result.Mantissa != 0) ? 1 : 0;
+                result.Exponent--;
+            }
+            else
+            {
+                result.Exact &= (*p == '0');
+            }
+        }
+    }
+
+    if (!found)
+    { return false; }
+
+    // 指数部. 数字が続かない場合は 'e' を含めない.
+    if (p < last && (*p == 'e' || *p == 'E'))
+    {
+        auto q   = p + 1;
+        auto neg = false;
+        if (q < last && (*q == '-' || *q == '+'))
+        {
+            neg = (*q == '-');
+            q++;
+        }
+
+        if (q < last && IsDigit(*q))
+        {
+            int32_t value = 0;
+            for(; q < last && IsDigit(*q); ++q)
+            {
+                if (value < 100000)
+                { value = value * 10 + (*q - '0'); }
+            }
+
+            result.Exponent += neg ? -value : value;
+            p = q;
+        }
+    }
+
+    result.Ptr = p;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      仮数と 10^n がどちらも double で厳密に表現できる場合に変換します.
+//-----------------------------------------------------------------------------
+bool ToDoubleExact(const Decimal& decimal, double& value)
+{
+    if (!decimal.Exact
+      || decimal.Mantissa > (1ull << 53)
+      || decimal.Exponent < -kMaxExactExponent
+      || decimal.Exponent >  kMaxExactExponent)
+    { return false; }
+
+    // 1回の乗除算なので正しく丸められる.
+    auto result = double(decimal.Mantissa);
+    result = (decimal.Exponent < 0)
+        ? result / kPow10[-decimal.Exponent]
+        : result * kPow10[ decimal.Exponent];
+
+    value = decimal.Negative ? -result : result;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      C ランタイムで実数に変換します.
+//-----------------------------------------------------------------------------
+template<typename T, typename Func>
+asdx::FromCharsResult FromCharsFallback(const char* first, const char* last, T& value, Func func)
+{
+    char        buffer[kMaxNumberLength];
+    std::string temp;
+
+    auto size = size_t(last - first);
+    const char* str = buffer;
+    if (size < kMaxNumberLength)
+    {
+        memcpy(buffer, first, size);
+        buffer[size] = '\0';
+    }
+    else
+    {
+        temp.assign(first, size);
+        str = temp.c_str();
+    }
+
+    char* end = nullptr;
+    auto result = func(str, &end);
+    if (end == str)
+    { return { first, false }; }
+
+    value = static_cast<T>(result);
+    return { first + (end - str), true };
+}
+
+} // namespace
 
 
 namespace asdx {
@@ -316,4 +505,424 @@ uint32_t Tokenizer::NextAsUint()
     return GetAsUint();
 }
 
+//-----------------------------------------------------------------------------
+//      文字列を float 型に変換します.
+//-----------------------------------------------------------------------------
+FromCharsResult FromChars(const char* first, const char* last, float& value)
+{
+    Decimal decimal;
+    if (!ParseDecimal(first, last, decimal))
+    { return FromCharsFallback(first, last, value, strtof); }
+
+    if (decimal.Mantissa == 0)
+    {
+        value = decimal.Negative ? -0.0f : 0.0f;
+        return { decimal.Ptr, true };
+    }
+
+    // double を経由すると, double の結果が float の丸め境界上に乗った場合だけ二重丸めになる.
+    // 高速パスの範囲は常に float の正規化数なので, 下位 29bit で境界を判定できる.
+    double result;
+    if (ToDoubleExact(decimal, result))
+    {
+        uint64_t bits;
+        memcpy(&bits, &result, sizeof(bits));
+        if ((bits & 0x1fffffffull) != 0x10000000ull)
+        {
+            value = float(result);
+            return { decimal.Ptr, true };
+        }
+    }
+
+    return FromCharsFallback(first, decimal.Ptr, value, strtof);
+}
+
+//-----------------------------------------------------------------------------
+//      文字列を double 型に変換します.
+//-----------------------------------------------------------------------------
+FromCharsResult FromChars(const char* first, const char* last, double& value)
+{
+    Decimal decimal;
+    if (!ParseDecimal(first, last, decimal))
+    { return FromCharsFallback(first, last, value, strtod); }
+
+    if (decimal.Mantissa == 0)
+    {
+        value = decimal.Negative ? -0.0 : 0.0;
+        return { decimal.Ptr, true };
+    }
+
+    if (ToDoubleExact(decimal, value))
+    { return { decimal.Ptr, true }; }
+
+    return FromCharsFallback(first, decimal.Ptr, value, strtod);
+}
+
+//-----------------------------------------------------------------------------
+//      文字列を int32_t 型に変換します.
+//-----------------------------------------------------------------------------
+FromCharsResult FromChars(const char* first, const char* last, int32_t& value)
+{
+    auto p   = first;
+    auto neg = false;
+    if (p < last && (*p == '-' || *p == '+'))
+    {
+        neg = (*p == '-');
+        p++;
+    }
+
+    if (p >= last || !IsDigit(*p))
+    { return { first, false }; }
+
+    const uint64_t limit = neg ? 2147483648ull : 2147483647ull;
+
+    uint64_t result   = 0;
+    auto     overflow = false;
+    for(; p < last && IsDigit(*p); ++p)
+    {
+        result = result * 10 + uint64_t(*p - '0');
+        if (result > limit)
+        {
+            overflow = true;
+            result   = limit;
+        }
+    }
+
+    if (overflow)
+    { return { p, false }; }
+
+    value = neg ? int32_t(-int64_t(result)) : int32_t(result);
+    return { p, true };
+}
+
+//-----------------------------------------------------------------------------
+//      文字列を uint32_t 型に変換します.
+//-----------------------------------------------------------------------------
+FromCharsResult FromChars(const char* first, const char* last, uint32_t& value)
+{
+    auto p = first;
+    if (p < last && *p == '+')
+    { p++; }
+
+    if (p >= last || !IsDigit(*p))
+    { return { first, false }; }
+
+    uint64_t result   = 0;
+    auto     overflow = false;
+    for(; p < last && IsDigit(*p); ++p)
+    {
+        result = result * 10 + uint64_t(*p - '0');
+        if (result > UINT32_MAX)
+        {
+            overflow = true;
+            result   = UINT32_MAX;
+        }
+    }
+
+    if (overflow)
+    { return { p, false }; }
+
+    value = uint32_t(result);
+    return { p, true };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ViewTokenizer class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+ViewTokenizer::ViewTokenizer()
+: m_pBuffer (nullptr)
+, m_pPtr    (nullptr)
+, m_pEnd    (nullptr)
+, m_Token   ()
+{
+    memset(m_CharClass, 0, sizeof(m_CharClass));
+    m_CharClass[uint8_t('\n')] = CHAR_CLASS_NEWLINE;
+    m_CharClass[uint8_t('\0')] = CHAR_CLASS_END;
+    SetSeparator(kDefaultSeparator);
+}
+
+//-----------------------------------------------------------------------------
+//      区切り文字を設定します.
+//-----------------------------------------------------------------------------
+void ViewTokenizer::SetSeparator(const char* separator)
+{
+    for(auto i=0; i<256; ++i)
+    { m_CharClass[i] &= ~CHAR_CLASS_SEPARATOR; }
+
+    // 改行は常に行末として扱うので区切り文字には含めない.
+    for(auto p = separator; *p != '\0'; ++p)
+    {
+        auto c = uint8_t(*p);
+        if (c != '\n')
+        { m_CharClass[c] |= CHAR_CLASS_SEPARATOR; }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      切り出し文字を設定します.
+//-----------------------------------------------------------------------------
+void ViewTokenizer::SetCutOff(const char* cutoff)
+{
+    for(auto i=0; i<256; ++i)
+    { m_CharClass[i] &= ~CHAR_CLASS_CUTOFF; }
+
+    for(auto p = cutoff; *p != '\0'; ++p)
+    {
+        auto c = uint8_t(*p);
+        if (c != '\n')
+        { m_CharClass[c] |= CHAR_CLASS_CUTOFF; }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      バッファを設定します.
+//-----------------------------------------------------------------------------
+void ViewTokenizer::SetBuffer(const char* buffer, size_t bufferSize)
+{
+    m_pBuffer = buffer;
+    m_pPtr    = buffer;
+    m_pEnd    = buffer + bufferSize;
+    m_Token   = TokenView(buffer, 0);
+}
+
+//-----------------------------------------------------------------------------
+//      トークンを切り出します.
+//-----------------------------------------------------------------------------
+bool ViewTokenizer::Scan(uint8_t skipMask)
+{
+    const uint8_t kStopMask = CHAR_CLASS_SEPARATOR | CHAR_CLASS_CUTOFF | CHAR_CLASS_NEWLINE | CHAR_CLASS_END;
+
+    auto p = m_pPtr;
+    while(p < m_pEnd && (m_CharClass[uint8_t(*p)] & skipMask) != 0)
+    { p++; }
+
+    auto head = p;
+    if (p < m_pEnd)
+    {
+        auto type = m_CharClass[uint8_t(*p)];
+        if (type & CHAR_CLASS_CUTOFF)
+        {
+            // 切り出し文字は単体トークンとする.
+            p++;
+        }
+        else if ((type & (CHAR_CLASS_NEWLINE | CHAR_CLASS_END)) == 0)
+        {
+            while(p < m_pEnd && (m_CharClass[uint8_t(*p)] & kStopMask) == 0)
+            { p++; }
+        }
+    }
+
+    m_pPtr  = p;
+    m_Token = TokenView(head, size_t(p - head));
+    return p != head;
+}
+
+//-----------------------------------------------------------------------------
+//      次のトークンを取得します.
+//-----------------------------------------------------------------------------
+bool ViewTokenizer::Next()
+{ return Scan(CHAR_CLASS_SEPARATOR | CHAR_CLASS_NEWLINE); }
+
+//-----------------------------------------------------------------------------
+//      同じ行の次のトークンを取得します.
+//-----------------------------------------------------------------------------
+bool ViewTokenizer::NextInLine()
+{ return Scan(CHAR_CLASS_SEPARATOR); }
+
+//-----------------------------------------------------------------------------
+//      行末までをトークンとして取得し, 次の行の先頭まで読み飛ばします.
+//-----------------------------------------------------------------------------
+void ViewTokenizer::SkipLine()
+{
+    auto p = m_pPtr;
+    while(p < m_pEnd && (m_CharClass[uint8_t(*p)] & CHAR_CLASS_SEPARATOR) != 0)
+    { p++; }
+
+    auto head = p;
+    auto pos  = (p < m_pEnd) ? static_cast<const char*>(memchr(p, '\n', size_t(m_pEnd - p))) : nullptr;
+    auto tail = (pos != nullptr) ? pos : m_pEnd;
+    m_pPtr    = (pos != nullptr) ? pos + 1 : m_pEnd;
+
+    while(tail > head && (m_CharClass[uint8_t(tail[-1])] & CHAR_CLASS_SEPARATOR) != 0)
+    { tail--; }
+
+    m_Token = TokenView(head, size_t(tail - head));
+}
+
+//-----------------------------------------------------------------------------
+//      指定した文字列が出てくるまでトークンを読み飛ばします.
+//-----------------------------------------------------------------------------
+void ViewTokenizer::SkipTo(const char* text)
+{
+    auto size = strlen(text);
+    while(Next())
+    {
+        auto found = false;
+        for(auto p = m_Token.data(); p + size <= m_Token.end(); ++p)
+        {
+            if (memcmp(p, text, size) == 0)
+            {
+                found = true;
+                break;
+            }
+        }
+
+        if (found)
+        {
+            Next();
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      最後かどうかチェックします.
+//-----------------------------------------------------------------------------
+bool ViewTokenizer::IsEnd() const
+{ return (m_pPtr == nullptr || m_pPtr >= m_pEnd || *m_pPtr == '\0'); }
+
+//-----------------------------------------------------------------------------
+//      トークンが有効かどうかチェックします.
+//-----------------------------------------------------------------------------
+bool ViewTokenizer::IsValidToken() const
+{ return !m_Token.empty(); }
+
+//-----------------------------------------------------------------------------
+//      指定された文字列とトークンが一致するかチェックします.
+//-----------------------------------------------------------------------------
+bool ViewTokenizer::Compare(const char* token) const
+{ return m_Token == token; }
+
+//-----------------------------------------------------------------------------
+//      指定された文字列とトークンが一致するかチェックします.
+//-----------------------------------------------------------------------------
+bool ViewTokenizer::CompareAsLower(const char* token) const
+{
+    auto p = m_Token.data();
+    for(size_t i=0; i<m_Token.size(); ++i)
+    {
+        if (token[i] == '\0' || tolower(uint8_t(p[i])) != tolower(uint8_t(token[i])))
+        { return false; }
+    }
+
+    return token[m_Token.size()] == '\0';
+}
+
+//-----------------------------------------------------------------------------
+//      トークンを取得します.
+//-----------------------------------------------------------------------------
+const TokenView& ViewTokenizer::GetToken() const
+{ return m_Token; }
+
+//-----------------------------------------------------------------------------
+//      double型としてトークンを取得します.
+//-----------------------------------------------------------------------------
+double ViewTokenizer::GetAsDouble() const
+{
+    double value = 0.0;
+    FromChars(m_Token.data(), m_Token.end(), value);
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+//      float型としてトークンを取得します.
+//-----------------------------------------------------------------------------
+float ViewTokenizer::GetAsFloat() const
+{
+    float value = 0.0f;
+    FromChars(m_Token.data(), m_Token.end(), value);
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+//      int型としてトークンを取得します.
+//-----------------------------------------------------------------------------
+int ViewTokenizer::GetAsInt() const
+{
+    int32_t value = 0;
+    FromChars(m_Token.data(), m_Token.end(), value);
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+//      bool型としてトークンを取得します.
+//-----------------------------------------------------------------------------
+bool ViewTokenizer::GetAsBool() const
+{ return CompareAsLower("TRUE"); }
+
+//-----------------------------------------------------------------------------
+//      uint32_t型としてトークンを取得します.
+//-----------------------------------------------------------------------------
+uint32_t ViewTokenizer::GetAsUint() const
+{
+    uint32_t value = 0;
+    FromChars(m_Token.data(), m_Token.end(), value);
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+//      次のトークンを取得して返却します.
+//-----------------------------------------------------------------------------
+const TokenView& ViewTokenizer::NextAsToken()
+{
+    Next();
+    return m_Token;
+}
+
+//-----------------------------------------------------------------------------
+//      次のトークンを取得して，double型として返却します.
+//-----------------------------------------------------------------------------
+double ViewTokenizer::NextAsDouble()
+{
+    Next();
+    return GetAsDouble();
+}
+
+//-----------------------------------------------------------------------------
+//      次のトークンを取得して，float型として返却します.
+//-----------------------------------------------------------------------------
+float ViewTokenizer::NextAsFloat()
+{
+    Next();
+    return GetAsFloat();
+}
+
+//-----------------------------------------------------------------------------
+//      次のトークンを取得して，int型として返却します.
+//-----------------------------------------------------------------------------
+int ViewTokenizer::NextAsInt()
+{
+    Next();
+    return GetAsInt();
+}
+
+//-----------------------------------------------------------------------------
+//      次のトークンを取得して, bool型として返却します.
+//-----------------------------------------------------------------------------
+bool ViewTokenizer::NextAsBool()
+{
+    Next();
+    return GetAsBool();
+}
+
+//-----------------------------------------------------------------------------
+//      次のトークンを取得して, uint32_t型として返却します.
+//-----------------------------------------------------------------------------
+uint32_t ViewTokenizer::NextAsUint()
+{
+    Next();
+    return GetAsUint();
+}
+
+//-----------------------------------------------------------------------------
+//      現在のポインタを取得します.
+//-----------------------------------------------------------------------------
+const char* ViewTokenizer::GetPtr() const
+{ return m_pPtr; }
+
 } // namespace asdx
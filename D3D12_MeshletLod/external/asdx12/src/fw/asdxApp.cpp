@@ -12,6 +12,7 @@
 #include <fnd/asdxMacro.h>
 #include <fnd/asdxMath.h>
 #include <fnd/asdxLogger.h>
+#include <fnd/asdxProfiler.h>
 #include <fw/asdxApp.h>
 #include <gfx/asdxCommandQueue.h>
 
@@ -1213,13 +1214,20 @@ void Application::MainLoop()
             frameEventArgs.ElapsedTime     = elapsedTime;
             frameEventArgs.IsStopDraw      = m_IsStopRendering;
 
+            // フレームの区切りを記録.
+            ASDX_PROFILE_FRAME();
+
             // フレーム遷移処理.
-            OnFrameMove( frameEventArgs );
+            {
+                ASDX_PROFILE_SCOPE("OnFrameMove");
+                OnFrameMove( frameEventArgs );
+            }
 
             // 描画停止フラグが立っていない場合.
             if ( !IsStopRendering() )
             {
                 // フレーム描画処理.
+                ASDX_PROFILE_SCOPE("OnFrameRender");
                 OnFrameRender( frameEventArgs );
 
                 // フレームカウントをインクリメント.
@@ -1236,6 +1244,8 @@ void Application::MainLoop()
 //-----------------------------------------------------------------------------
 void Application::Run()
 {
+    ASDX_PROFILE_THREAD("Main");
+
     // アプリケーションの初期化処理.
     if ( InitApp() )
     {
@@ -0,0 +1,1940 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxBlockCompression.cpp
+// Desc : CPU Block Compression Codec.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <cfloat>
+#include <climits>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <new>
+#if !defined(ASDX_BC_DISABLE_SIMD) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#include <emmintrin.h>
+#define ASDX_BC_USE_SSE2    (1)
+#endif
+#include <res/asdxBlockCompression.h>
+#include <fnd/asdxMath.h>
+#include <fnd/asdxThreadPool.h>
+#include <fnd/asdxLogger.h>
+
+
+namespace /* anonymous */ {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+// dxgiformat.h に依存せずにビルドできるようにDXGI_FORMATの値を定義しておく.
+static const uint32_t FORMAT_R16G16B16A16_FLOAT = 10;
+static const uint32_t FORMAT_R8G8B8A8_UNORM     = 28;
+static const uint32_t FORMAT_R8G8B8A8_UNORM_SRGB= 29;
+static const uint32_t FORMAT_R8G8B8A8_SNORM     = 31;
+static const uint32_t FORMAT_BC1_TYPELESS       = 70;
+static const uint32_t FORMAT_BC1_UNORM          = 71;
+static const uint32_t FORMAT_BC1_UNORM_SRGB     = 72;
+static const uint32_t FORMAT_BC2_TYPELESS       = 73;
+static const uint32_t FORMAT_BC2_UNORM          = 74;
+static const uint32_t FORMAT_BC2_UNORM_SRGB     = 75;
+static const uint32_t FORMAT_BC3_TYPELESS       = 76;
+static const uint32_t FORMAT_BC3_UNORM          = 77;
+static const uint32_t FORMAT_BC3_UNORM_SRGB     = 78;
+static const uint32_t FORMAT_BC4_TYPELESS       = 79;
+static const uint32_t FORMAT_BC4_UNORM          = 80;
+static const uint32_t FORMAT_BC4_SNORM          = 81;
+static const uint32_t FORMAT_BC5_TYPELESS       = 82;
+static const uint32_t FORMAT_BC5_UNORM          = 83;
+static const uint32_t FORMAT_BC5_SNORM          = 84;
+static const uint32_t FORMAT_BC6H_TYPELESS      = 94;
+static const uint32_t FORMAT_BC6H_UF16          = 95;
+static const uint32_t FORMAT_BC6H_SF16          = 96;
+static const uint32_t FORMAT_BC7_TYPELESS       = 97;
+static const uint32_t FORMAT_BC7_UNORM          = 98;
+static const uint32_t FORMAT_BC7_UNORM_SRGB     = 99;
+
+static const uint32_t kBlockRowsPerTask = 4;    // 1タスクが処理するブロック行数.
+static const uint16_t kHalfOne          = 0x3C00;
+
+// 2分割パーティション (ビットiがピクセルiのサブセット番号).
+static const uint16_t kPartition2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+// 3分割パーティション.
+static const uint8_t kPartition3[64][16] = {
+    { 0,0,1,1,0,0,1,1,0,2,2,1,2,2,2,2 }, { 0,0,0,1,0,0,1,1,2,2,1,1,2,2,2,1 },
+    { 0,0,0,0,2,0,0,1,2,2,1,1,2,2,1,1 }, { 0,2,2,2,0,0,2,2,0,0,1,1,0,1,1,1 },
+    { 0,0,0,0,0,0,0,0,1,1,2,2,1,1,2,2 }, { 0,0,1,1,0,0,1,1,0,0,2,2,0,0,2,2 },
+    { 0,0,2,2,0,0,2,2,1,1,1,1,1,1,1,1 }, { 0,0,1,1,0,0,1,1,2,2,1,1,2,2,1,1 },
+    { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2 }, { 0,0,0,0,1,1,1,1,1,1,1,1,2,2,2,2 },
+    { 0,0,0,0,1,1,1,1,2,2,2,2,2,2,2,2 }, { 0,0,1,2,0,0,1,2,0,0,1,2,0,0,1,2 },
+    { 0,1,1,2,0,1,1,2,0,1,1,2,0,1,1,2 }, { 0,1,2,2,0,1,2,2,0,1,2,2,0,1,2,2 },
+    { 0,0,1,1,0,1,1,2,1,1,2,2,1,2,2,2 }, { 0,0,1,1,2,0,0,1,2,2,0,0,2,2,2,0 },
+    { 0,0,0,1,0,0,1,1,0,1,1,2,1,1,2,2 }, { 0,1,1,1,0,0,1,1,2,0,0,1,2,2,0,0 },
+    { 0,0,0,0,1,1,2,2,1,1,2,2,1,1,2,2 }, { 0,0,2,2,0,0,2,2,0,0,2,2,1,1,1,1 },
+    { 0,1,1,1,0,1,1,1,0,2,2,2,0,2,2,2 }, { 0,0,0,1,0,0,0,1,2,2,2,1,2,2,2,1 },
+    { 0,0,0,0,0,0,1,1,0,1,2,2,0,1,2,2 }, { 0,0,0,0,1,1,0,0,2,2,1,0,2,2,1,0 },
+    { 0,1,2,2,0,1,2,2,0,0,1,1,0,0,0,0 }, { 0,0,1,2,0,0,1,2,1,1,2,2,2,2,2,2 },
+    { 0,1,1,0,1,2,2,1,1,2,2,1,0,1,1,0 }, { 0,0,0,0,0,1,1,0,1,2,2,1,1,2,2,1 },
+    { 0,0,2,2,1,1,0,2,1,1,0,2,0,0,2,2 }, { 0,1,1,0,0,1,1,0,2,0,0,2,2,2,2,2 },
+    { 0,0,1,1,0,1,2,2,0,1,2,2,0,0,1,1 }, { 0,0,0,0,2,0,0,0,2,2,1,1,2,2,2,1 },
+    { 0,0,0,0,0,0,0,2,1,1,2,2,1,2,2,2 }, { 0,2,2,2,0,0,2,2,0,0,1,2,0,0,1,1 },
+    { 0,0,1,1,0,0,1,2,0,0,2,2,0,2,2,2 }, { 0,1,2,0,0,1,2,0,0,1,2,0,0,1,2,0 },
+    { 0,0,0,0,1,1,1,1,2,2,2,2,0,0,0,0 }, { 0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0 },
+    { 0,1,2,0,2,0,1,2,1,2,0,1,0,1,2,0 }, { 0,0,1,1,2,2,0,0,1,1,2,2,0,0,1,1 },
+    { 0,0,1,1,1,1,2,2,2,2,0,0,0,0,1,1 }, { 0,1,0,1,0,1,0,1,2,2,2,2,2,2,2,2 },
+    { 0,0,0,0,0,0,0,0,2,1,2,1,2,1,2,1 }, { 0,0,2,2,1,1,2,2,0,0,2,2,1,1,2,2 },
+    { 0,0,2,2,0,0,1,1,0,0,2,2,0,0,1,1 }, { 0,2,2,0,1,2,2,1,0,2,2,0,1,2,2,1 },
+    { 0,1,0,1,2,2,2,2,2,2,2,2,0,1,0,1 }, { 0,0,0,0,2,1,2,1,2,1,2,1,2,1,2,1 },
+    { 0,1,0,1,0,1,0,1,0,1,0,1,2,2,2,2 }, { 0,2,2,2,0,1,1,1,0,2,2,2,0,1,1,1 },
+    { 0,0,0,2,1,1,1,2,0,0,0,2,1,1,1,2 }, { 0,0,0,0,2,1,1,2,2,1,1,2,2,1,1,2 },
+    { 0,2,2,2,0,1,1,1,0,1,1,1,0,2,2,2 }, { 0,0,0,2,1,1,1,2,1,1,1,2,0,0,0,2 },
+    { 0,1,1,0,0,1,1,0,0,1,1,0,2,2,2,2 }, { 0,0,0,0,0,0,0,0,2,1,1,2,2,1,1,2 },
+    { 0,1,1,0,0,1,1,0,2,2,2,2,2,2,2,2 }, { 0,0,2,2,0,0,1,1,0,0,1,1,0,0,2,2 },
+    { 0,0,2,2,1,1,2,2,1,1,2,2,0,0,2,2 }, { 0,0,0,0,0,0,0,0,0,0,0,0,2,1,1,2 },
+    { 0,0,0,2,0,0,0,1,0,0,0,2,0,0,0,1 }, { 0,2,2,2,1,2,2,2,0,2,2,2,1,2,2,2 },
+    { 0,1,0,1,2,2,2,2,2,2,2,2,2,2,2,2 }, { 0,1,1,1,2,0,1,1,2,2,0,1,2,2,2,0 },
+};
+
+// 2分割時のサブセット1のアンカーインデックス.
+static const uint8_t kAnchor2[64] = {
+    15,15,15,15,15,15,15,15, 15,15,15,15,15,15,15,15,
+    15, 2, 8, 2, 2, 8, 8,15,  2, 8, 2, 2, 8, 8, 2, 2,
+    15,15, 6, 8, 2, 8,15,15,  2, 8, 2, 2, 2,15,15, 6,
+     6, 2, 6, 8,15,15, 2, 2, 15,15,15,15,15, 2, 2,15,
+};
+
+// 3分割時のサブセット1のアンカーインデックス.
+static const uint8_t kAnchor3a[64] = {
+     3, 3,15,15, 8, 3,15,15,  8, 8, 6, 6, 6, 5, 3, 3,
+     3, 3, 8,15, 3, 3, 6,10,  5, 8, 8, 6, 8, 5,15,15,
+     8,15, 3, 5, 6,10, 8,15, 15, 3,15, 5,15,15,15,15,
+     3,15, 5, 5, 5, 8, 5,10,  5,10, 8,13,15,12, 3, 3,
+};
+
+// 3分割時のサブセット2のアンカーインデックス.
+static const uint8_t kAnchor3b[64] = {
+    15, 8, 8, 3,15,15, 3, 8, 15,15,15,15,15,15,15, 8,
+    15, 8,15, 3,15, 8,15, 8,  3,15, 6,10,15,15,10, 8,
+    15, 3,15,10,10, 8, 9,10,  6,15, 8,15, 3, 6, 6, 8,
+    15, 3,15,15,15,15,15,15, 15,15,15,15, 3,15,15, 8,
+};
+
+// 補間ウェイト.
+static const uint8_t kWeight2[4]  = { 0, 21, 43, 64 };
+static const uint8_t kWeight3[8]  = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const uint8_t kWeight4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+///////////////////////////////////////////////////////////////////////////////
+// BC7ModeInfo structure
+///////////////////////////////////////////////////////////////////////////////
+struct BC7ModeInfo
+{
+    uint8_t SubsetCount;        //!< サブセット数.
+    uint8_t PartitionBits;      //!< パーティションのビット数.
+    uint8_t RotationBits;       //!< ローテーションのビット数.
+    uint8_t IndexModeBits;      //!< インデックス選択のビット数.
+    uint8_t ColorBits;          //!< カラーのビット数.
+    uint8_t AlphaBits;          //!< アルファのビット数.
+    uint8_t EndpointPBits;      //!< エンドポイント毎のPビット有無.
+    uint8_t SharedPBits;        //!< サブセット毎のPビット有無.
+    uint8_t IndexBits;          //!< インデックスのビット数.
+    uint8_t IndexBits2;         //!< 2つめのインデックスのビット数.
+};
+
+static const BC7ModeInfo kBC7Modes[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BC6HModeInfo structure
+///////////////////////////////////////////////////////////////////////////////
+struct BC6HModeInfo
+{
+    bool    Transformed;        //!< 差分エンドポイントかどうか.
+    uint8_t EndpointBits;       //!< ベースエンドポイントのビット数.
+    uint8_t DeltaBits[3];       //!< 差分のビット数(RGB).
+};
+
+static const BC6HModeInfo kBC6HModes[14] = {
+    { true,  10, {  5,  5,  5 } },
+    { true,   7, {  6,  6,  6 } },
+    { true,  11, {  5,  4,  4 } },
+    { true,  11, {  4,  5,  4 } },
+    { true,  11, {  4,  4,  5 } },
+    { true,   9, {  5,  5,  5 } },
+    { true,   8, {  6,  5,  5 } },
+    { true,   8, {  5,  6,  5 } },
+    { true,   8, {  5,  5,  6 } },
+    { false,  6, {  6,  6,  6 } },
+    { false, 10, { 10, 10, 10 } },
+    { true,  11, {  9,  9,  9 } },
+    { true,  12, {  8,  8,  8 } },
+    { true,  16, {  4,  4,  4 } },
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BitReader class
+///////////////////////////////////////////////////////////////////////////////
+class BitReader
+{
+public:
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    explicit BitReader(const uint8_t* pBlock)
+    {
+        memcpy(&m_Lo, pBlock + 0, sizeof(m_Lo));
+        memcpy(&m_Hi, pBlock + 8, sizeof(m_Hi));
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定ビット数を読み取ります(LSBから順).
+    //-------------------------------------------------------------------------
+    uint32_t Read(uint32_t count)
+    {
+        if (count == 0)
+        { return 0; }
+
+        uint64_t value;
+        if (m_Pos >= 64)
+        { value = m_Hi >> (m_Pos - 64); }
+        else if (m_Pos + count <= 64)
+        { value = m_Lo >> m_Pos; }
+        else
+        { value = (m_Lo >> m_Pos) | (m_Hi << (64 - m_Pos)); }
+
+        m_Pos += count;
+        return uint32_t(value & ((uint64_t(1) << count) - 1));
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定ビット数を逆順で読み取ります.
+    //-------------------------------------------------------------------------
+    uint32_t ReadReverse(uint32_t count)
+    {
+        auto value  = Read(count);
+        auto result = 0u;
+        for(auto i=0u; i<count; ++i)
+        { result |= ((value >> i) & 0x1) << (count - 1 - i); }
+        return result;
+    }
+
+private:
+    uint64_t    m_Lo  = 0;
+    uint64_t    m_Hi  = 0;
+    uint32_t    m_Pos = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// TaskCounter class
+///////////////////////////////////////////////////////////////////////////////
+class TaskCounter
+{
+public:
+    //-------------------------------------------------------------------------
+    //! @brief      カウンターを設定します.
+    //-------------------------------------------------------------------------
+    void Reset(uint32_t count)
+    {
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        m_Count = count;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      タスクの完了を通知します.
+    //-------------------------------------------------------------------------
+    void Signal()
+    {
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        m_Count--;
+        if (m_Count == 0)
+        { m_Condition.notify_all(); }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      全タスクの完了を待機します.
+    //-------------------------------------------------------------------------
+    void Wait()
+    {
+        std::unique_lock<std::mutex> locker(m_Mutex);
+        m_Condition.wait(locker, [this]() { return m_Count == 0; });
+    }
+
+private:
+    std::mutex              m_Mutex;
+    std::condition_variable m_Condition;
+    uint32_t                m_Count = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BlockJob structure
+///////////////////////////////////////////////////////////////////////////////
+struct BlockJob
+{
+    asdx::BC_FORMAT Format;
+    uint32_t        Width;
+    uint32_t        Height;
+    const uint8_t*  pSrc;
+    uint32_t        SrcPitch;
+    uint8_t*        pDst;
+    uint32_t        DstPitch;
+    void          (*Process)(const BlockJob& job, uint32_t rowBegin, uint32_t rowEnd);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BlockRowTask class
+///////////////////////////////////////////////////////////////////////////////
+class BlockRowTask : public asdx::IRunnable
+{
+public:
+    const BlockJob* pJob     = nullptr;
+    TaskCounter*    pCounter = nullptr;
+    uint32_t        Begin    = 0;
+    uint32_t        End      = 0;
+
+    //-------------------------------------------------------------------------
+    //! @brief      処理を実行します.
+    //-------------------------------------------------------------------------
+    void Run() override
+    {
+        pJob->Process(*pJob, Begin, End);
+        pCounter->Signal();
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      ブロック行を分割してスレッドプールで処理します.
+//-----------------------------------------------------------------------------
+void DispatchBlockRows(const BlockJob& job, asdx::IThreadPool* pThreadPool)
+{
+    auto blockRows = (job.Height + 3) / 4;
+    auto taskCount = (blockRows + kBlockRowsPerTask - 1) / kBlockRowsPerTask;
+
+    if (pThreadPool == nullptr || taskCount <= 1)
+    {
+        job.Process(job, 0, blockRows);
+        return;
+    }
+
+    std::vector<BlockRowTask> tasks(taskCount);
+    std::vector<asdx::IRunnable*> runnables(taskCount);
+    TaskCounter counter;
+    counter.Reset(taskCount);
+
+    for(auto i=0u; i<taskCount; ++i)
+    {
+        tasks[i].pJob     = &job;
+        tasks[i].pCounter = &counter;
+        tasks[i].Begin    = i * kBlockRowsPerTask;
+        tasks[i].End      = asdx::Min(tasks[i].Begin + kBlockRowsPerTask, blockRows);
+        runnables[i]      = &tasks[i];
+    }
+
+    pThreadPool->Push(taskCount, runnables.data());
+    counter.Wait();
+}
+
+//-----------------------------------------------------------------------------
+//      値を符号拡張します.
+//-----------------------------------------------------------------------------
+inline int32_t SignExtend(int32_t value, uint32_t bits)
+{
+    auto shift = 32 - bits;
+    return int32_t(uint32_t(value) << shift) >> shift;
+}
+
+//-----------------------------------------------------------------------------
+//      RGB565を展開します.
+//-----------------------------------------------------------------------------
+inline void UnpackRGB565(uint16_t value, int32_t* pRGB)
+{
+    auto r = (value >> 11) & 0x1F;
+    auto g = (value >>  5) & 0x3F;
+    auto b = (value >>  0) & 0x1F;
+    pRGB[0] = (r << 3) | (r >> 2);
+    pRGB[1] = (g << 2) | (g >> 4);
+    pRGB[2] = (b << 3) | (b >> 2);
+}
+
+//-----------------------------------------------------------------------------
+//      BC1カラーブロックのパレットを構築します.
+//-----------------------------------------------------------------------------
+void BuildColorPalette(uint16_t c0, uint16_t c1, bool fourColor, int32_t palette[4][4])
+{
+    UnpackRGB565(c0, palette[0]);
+    UnpackRGB565(c1, palette[1]);
+    palette[0][3] = 255;
+    palette[1][3] = 255;
+
+    if (fourColor)
+    {
+        for(auto c=0; c<3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 255;
+    }
+    else
+    {
+        for(auto c=0; c<3; ++c)
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+            palette[3][c] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC1カラーブロックを展開します.
+//-----------------------------------------------------------------------------
+void DecodeColorBlock(const uint8_t* pBlock, bool forceFourColor, uint8_t* pRGBA)
+{
+    uint16_t c0 = uint16_t(pBlock[0] | (pBlock[1] << 8));
+    uint16_t c1 = uint16_t(pBlock[2] | (pBlock[3] << 8));
+    uint32_t indices;
+    memcpy(&indices, pBlock + 4, sizeof(indices));
+
+    int32_t palette[4][4];
+    BuildColorPalette(c0, c1, forceFourColor || (c0 > c1), palette);
+
+    for(auto i=0; i<16; ++i)
+    {
+        auto idx = (indices >> (i * 2)) & 0x3;
+        pRGBA[i * 4 + 0] = uint8_t(palette[idx][0]);
+        pRGBA[i * 4 + 1] = uint8_t(palette[idx][1]);
+        pRGBA[i * 4 + 2] = uint8_t(palette[idx][2]);
+        pRGBA[i * 4 + 3] = uint8_t(palette[idx][3]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC4ブロックのパレットを構築します.
+//-----------------------------------------------------------------------------
+void BuildAlphaPalette(int32_t a0, int32_t a1, bool isSigned, int32_t palette[8])
+{
+    auto div = [](int32_t value, int32_t d)
+    { return (value >= 0) ? (value + d / 2) / d : (value - d / 2) / d; };
+
+    palette[0] = a0;
+    palette[1] = a1;
+
+    if (a0 > a1)
+    {
+        for(auto i=1; i<7; ++i)
+        { palette[i + 1] = div((7 - i) * a0 + i * a1, 7); }
+    }
+    else
+    {
+        for(auto i=1; i<5; ++i)
+        { palette[i + 1] = div((5 - i) * a0 + i * a1, 5); }
+        palette[6] = (isSigned) ? -127 : 0;
+        palette[7] = (isSigned) ?  127 : 255;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC4ブロックを展開します.
+//-----------------------------------------------------------------------------
+void DecodeAlphaBlock(const uint8_t* pBlock, bool isSigned, uint8_t* pDst, uint32_t stride)
+{
+    int32_t a0 = pBlock[0];
+    int32_t a1 = pBlock[1];
+    if (isSigned)
+    {
+        a0 = asdx::Max(int32_t(int8_t(pBlock[0])), -127);
+        a1 = asdx::Max(int32_t(int8_t(pBlock[1])), -127);
+    }
+
+    int32_t palette[8];
+    BuildAlphaPalette(a0, a1, isSigned, palette);
+
+    uint64_t indices = 0;
+    memcpy(&indices, pBlock + 2, 6);
+
+    for(auto i=0u; i<16; ++i)
+    {
+        auto idx = (indices >> (i * 3)) & 0x7;
+        pDst[i * stride] = uint8_t(palette[idx]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC1ブロックを展開します.
+//-----------------------------------------------------------------------------
+void DecodeBC1Block(const uint8_t* pBlock, uint8_t* pRGBA)
+{ DecodeColorBlock(pBlock, false, pRGBA); }
+
+//-----------------------------------------------------------------------------
+//      BC2ブロックを展開します.
+//-----------------------------------------------------------------------------
+void DecodeBC2Block(const uint8_t* pBlock, uint8_t* pRGBA)
+{
+    DecodeColorBlock(pBlock + 8, true, pRGBA);
+    for(auto i=0; i<16; ++i)
+    {
+        auto a = (pBlock[i / 2] >> ((i & 0x1) * 4)) & 0xF;
+        pRGBA[i * 4 + 3] = uint8_t(a * 17);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC3ブロックを展開します.
+//-----------------------------------------------------------------------------
+void DecodeBC3Block(const uint8_t* pBlock, uint8_t* pRGBA)
+{
+    DecodeColorBlock(pBlock + 8, true, pRGBA);
+    DecodeAlphaBlock(pBlock, false, pRGBA + 3, 4);
+}
+
+//-----------------------------------------------------------------------------
+//      BC4ブロックを展開します.
+//-----------------------------------------------------------------------------
+void DecodeBC4Block(const uint8_t* pBlock, bool isSigned, uint8_t* pRGBA)
+{
+    DecodeAlphaBlock(pBlock, isSigned, pRGBA, 4);
+    for(auto i=0; i<16; ++i)
+    {
+        pRGBA[i * 4 + 1] = 0;
+        pRGBA[i * 4 + 2] = 0;
+        pRGBA[i * 4 + 3] = (isSigned) ? 127 : 255;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC5ブロックを展開します.
+//-----------------------------------------------------------------------------
+void DecodeBC5Block(const uint8_t* pBlock, bool isSigned, uint8_t* pRGBA)
+{
+    DecodeAlphaBlock(pBlock + 0, isSigned, pRGBA + 0, 4);
+    DecodeAlphaBlock(pBlock + 8, isSigned, pRGBA + 1, 4);
+    for(auto i=0; i<16; ++i)
+    {
+        pRGBA[i * 4 + 2] = 0;
+        pRGBA[i * 4 + 3] = (isSigned) ? 127 : 255;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC6Hのエンドポイントを逆量子化します.
+//-----------------------------------------------------------------------------
+int32_t UnquantizeBC6H(int32_t value, uint32_t bits, bool isSigned)
+{
+    if (!isSigned)
+    {
+        if (bits >= 15)
+        { return value; }
+        if (value == 0)
+        { return 0; }
+        if (value == (1 << bits) - 1)
+        { return 0xFFFF; }
+        return ((value << 16) + 0x8000) >> bits;
+    }
+
+    if (bits >= 16)
+    { return value; }
+
+    auto sign = false;
+    if (value < 0)
+    {
+        sign  = true;
+        value = -value;
+    }
+
+    int32_t result;
+    if (value == 0)
+    { result = 0; }
+    else if (value >= (1 << (bits - 1)) - 1)
+    { result = 0x7FFF; }
+    else
+    { result = ((value << 15) + 0x4000) >> (bits - 1); }
+
+    return (sign) ? -result : result;
+}
+
+//-----------------------------------------------------------------------------
+//      BC6Hの補間結果を半精度浮動小数のビット列に変換します.
+//-----------------------------------------------------------------------------
+uint16_t FinishUnquantizeBC6H(int32_t value, bool isSigned)
+{
+    if (!isSigned)
+    { return uint16_t((value * 31) >> 6); }
+
+    if (value < 0)
+    { return uint16_t(0x8000 | (((-value) * 31) >> 5)); }
+
+    return uint16_t((value * 31) >> 5);
+}
+
+//-----------------------------------------------------------------------------
+//      BC6Hブロックを展開します.
+//-----------------------------------------------------------------------------
+void DecodeBC6HBlock(const uint8_t* pBlock, bool isSigned, uint16_t* pRGBA)
+{
+    BitReader reader(pBlock);
+
+    int32_t r[4] = {};
+    int32_t g[4] = {};
+    int32_t b[4] = {};
+
+    auto Bit  = [&](int32_t& v, uint32_t shift) { v |= int32_t(reader.Read(1)) << shift; };
+    auto Bits = [&](int32_t& v, uint32_t count) { v |= int32_t(reader.Read(count)); };
+    auto RBits= [&](int32_t& v, uint32_t count, uint32_t shift) { v |= int32_t(reader.ReadReverse(count)) << shift; };
+
+    uint32_t partition = 0;
+    uint32_t mode = reader.Read(2);
+    if (mode > 1)
+    { mode |= reader.Read(3) << 2; }
+
+    switch(mode)
+    {
+    case 0x00:  // 10.555
+        {
+            Bit(g[2], 4); Bit(b[2], 4); Bit(b[3], 4);
+            Bits(r[0], 10); Bits(g[0], 10); Bits(b[0], 10);
+            Bits(r[1], 5); Bit(g[3], 4); Bits(g[2], 4);
+            Bits(g[1], 5); Bit(b[3], 0); Bits(g[3], 4);
+            Bits(b[1], 5); Bit(b[3], 1); Bits(b[2], 4);
+            Bits(r[2], 5); Bit(b[3], 2);
+            Bits(r[3], 5); Bit(b[3], 3);
+            mode = 0;
+        }
+        break;
+
+    case 0x01:  // 7.666
+        {
+            Bit(g[2], 5); Bit(g[3], 4); Bit(g[3], 5);
+            Bits(r[0], 7); Bit(b[3], 0); Bit(b[3], 1); Bit(b[2], 4);
+            Bits(g[0], 7); Bit(b[2], 5); Bit(b[3], 2); Bit(g[2], 4);
+            Bits(b[0], 7); Bit(b[3], 3); Bit(b[3], 5); Bit(b[3], 4);
+            Bits(r[1], 6); Bits(g[2], 4);
+            Bits(g[1], 6); Bits(g[3], 4);
+            Bits(b[1], 6); Bits(b[2], 4);
+            Bits(r[2], 6);
+            Bits(r[3], 6);
+            mode = 1;
+        }
+        break;
+
+    case 0x02:  // 11.555, 11.444, 11.444
+        {
+            Bits(r[0], 10); Bits(g[0], 10); Bits(b[0], 10);
+            Bits(r[1], 5); Bit(r[0], 10); Bits(g[2], 4);
+            Bits(g[1], 4); Bit(g[0], 10); Bit(b[3], 0); Bits(g[3], 4);
+            Bits(b[1], 4); Bit(b[0], 10); Bit(b[3], 1); Bits(b[2], 4);
+            Bits(r[2], 5); Bit(b[3], 2);
+            Bits(r[3], 5); Bit(b[3], 3);
+            mode = 2;
+        }
+        break;
+
+    case 0x06:  // 11.444, 11.555, 11.444
+        {
+            Bits(r[0], 10); Bits(g[0], 10); Bits(b[0], 10);
+            Bits(r[1], 4); Bit(r[0], 10); Bit(g[3], 4); Bits(g[2], 4);
+            Bits(g[1], 5); Bit(g[0], 10); Bits(g[3], 4);
+            Bits(b[1], 4); Bit(b[0], 10); Bit(b[3], 1); Bits(b[2], 4);
+            Bits(r[2], 4); Bit(b[3], 0); Bit(b[3], 2);
+            Bits(r[3], 4); Bit(g[2], 4); Bit(b[3], 3);
+            mode = 3;
+        }
+        break;
+
+    case 0x0A:  // 11.444, 11.444, 11.555
+        {
+            Bits(r[0], 10); Bits(g[0], 10); Bits(b[0], 10);
+            Bits(r[1], 4); Bit(r[0], 10); Bit(b[2], 4); Bits(g[2], 4);
+            Bits(g[1], 4); Bit(g[0], 10); Bit(b[3], 0); Bits(g[3], 4);
+            Bits(b[1], 5); Bit(b[0], 10); Bits(b[2], 4);
+            Bits(r[2], 4); Bit(b[3], 1); Bit(b[3], 2);
+            Bits(r[3], 4); Bit(b[3], 4); Bit(b[3], 3);
+            mode = 4;
+        }
+        break;
+
+    case 0x0E:  // 9.555
+        {
+            Bits(r[0], 9); Bit(b[2], 4);
+            Bits(g[0], 9); Bit(g[2], 4);
+            Bits(b[0], 9); Bit(b[3], 4);
+            Bits(r[1], 5); Bit(g[3], 4); Bits(g[2], 4);
+            Bits(g[1], 5); Bit(b[3], 0); Bits(g[3], 4);
+            Bits(b[1], 5); Bit(b[3], 1); Bits(b[2], 4);
+            Bits(r[2], 5); Bit(b[3], 2);
+            Bits(r[3], 5); Bit(b[3], 3);
+            mode = 5;
+        }
+        break;
+
+    case 0x12:  // 8.666, 8.555, 8.555
+        {
+            Bits(r[0], 8); Bit(g[3], 4); Bit(b[2], 4);
+            Bits(g[0], 8); Bit(b[3], 2); Bit(g[2], 4);
+            Bits(b[0], 8); Bit(b[3], 3); Bit(b[3], 4);
+            Bits(r[1], 6); Bits(g[2], 4);
+            Bits(g[1], 5); Bit(b[3], 0); Bits(g[3], 4);
+            Bits(b[1], 5); Bit(b[3], 1); Bits(b[2], 4);
+            Bits(r[2], 6);
+            Bits(r[3], 6);
+            mode = 6;
+        }
+        break;
+
+    case 0x16:  // 8.555, 8.666, 8.555
+        {
+            Bits(r[0], 8); Bit(b[3], 0); Bit(b[2], 4);
+            Bits(g[0], 8); Bit(g[2], 5); Bit(g[2], 4);
+            Bits(b[0], 8); Bit(g[3], 5); Bit(b[3], 4);
+            Bits(r[1], 5); Bit(g[3], 4); Bits(g[2], 4);
+            Bits(g[1], 6); Bits(g[3], 4);
+            Bits(b[1], 5); Bit(b[3], 1); Bits(b[2], 4);
+            Bits(r[2], 5); Bit(b[3], 2);
+            Bits(r[3], 5); Bit(b[3], 3);
+            mode = 7;
+        }
+        break;
+
+    case 0x1A:  // 8.555, 8.555, 8.666
+        {
+            Bits(r[0], 8); Bit(b[3], 1); Bit(b[2], 4);
+            Bits(g[0], 8); Bit(b[2], 5); Bit(g[2], 4);
+            Bits(b[0], 8); Bit(b[3], 5); Bit(b[3], 4);
+            Bits(r[1], 5); Bit(g[3], 4); Bits(g[2], 4);
+            Bits(g[1], 5); Bit(b[3], 0); Bits(g[3], 4);
+            Bits(b[1], 6); Bits(b[2], 4);
+            Bits(r[2], 5); Bit(b[3], 2);
+            Bits(r[3], 5); Bit(b[3], 3);
+            mode = 8;
+        }
+        break;
+
+    case 0x1E:  // 6.666
+        {
+            Bits(r[0], 6); Bit(g[3], 4); Bit(b[3], 0); Bit(b[3], 1); Bit(b[2], 4);
+            Bits(g[0], 6); Bit(g[2], 5); Bit(b[2], 5); Bit(b[3], 2); Bit(g[2], 4);
+            Bits(b[0], 6); Bit(g[3], 5); Bit(b[3], 3); Bit(b[3], 5); Bit(b[3], 4);
+            Bits(r[1], 6); Bits(g[2], 4);
+            Bits(g[1], 6); Bits(g[3], 4);
+            Bits(b[1], 6); Bits(b[2], 4);
+            Bits(r[2], 6);
+            Bits(r[3], 6);
+            mode = 9;
+        }
+        break;
+
+    case 0x03:  // 10.10
+        {
+            Bits(r[0], 10); Bits(g[0], 10); Bits(b[0], 10);
+            Bits(r[1], 10); Bits(g[1], 10); Bits(b[1], 10);
+            mode = 10;
+        }
+        break;
+
+    case 0x07:  // 11.9
+        {
+            Bits(r[0], 10); Bits(g[0], 10); Bits(b[0], 10);
+            Bits(r[1], 9); Bit(r[0], 10);
+            Bits(g[1], 9); Bit(g[0], 10);
+            Bits(b[1], 9); Bit(b[0], 10);
+            mode = 11;
+        }
+        break;
+
+    case 0x0B:  // 12.8
+        {
+            Bits(r[0], 10); Bits(g[0], 10); Bits(b[0], 10);
+            Bits(r[1], 8); RBits(r[0], 2, 10);
+            Bits(g[1], 8); RBits(g[0], 2, 10);
+            Bits(b[1], 8); RBits(b[0], 2, 10);
+            mode = 12;
+        }
+        break;
+
+    case 0x0F:  // 16.4
+        {
+            Bits(r[0], 10); Bits(g[0], 10); Bits(b[0], 10);
+            Bits(r[1], 4); RBits(r[0], 6, 10);
+            Bits(g[1], 4); RBits(g[0], 6, 10);
+            Bits(b[1], 4); RBits(b[0], 6, 10);
+            mode = 13;
+        }
+        break;
+
+    default:
+        {
+            // 予約モードは黒として扱う.
+            for(auto i=0; i<16; ++i)
+            {
+                pRGBA[i * 4 + 0] = 0;
+                pRGBA[i * 4 + 1] = 0;
+                pRGBA[i * 4 + 2] = 0;
+                pRGBA[i * 4 + 3] = kHalfOne;
+            }
+        }
+        return;
+    }
+
+    const auto& info    = kBC6HModes[mode];
+    auto        regions = (mode < 10) ? 2u : 1u;
+    auto        epCount = regions * 2;
+
+    if (regions == 2)
+    { partition = reader.Read(5); }
+
+    // 符号拡張と差分の復元.
+    int32_t* channels[3] = { r, g, b };
+    for(auto c=0; c<3; ++c)
+    {
+        auto ep = channels[c];
+
+        if (isSigned)
+        { ep[0] = SignExtend(ep[0], info.EndpointBits); }
+
+        if (info.Transformed || isSigned)
+        {
+            for(auto e=1u; e<epCount; ++e)
+            { ep[e] = SignExtend(ep[e], info.DeltaBits[c]); }
+        }
+
+        if (info.Transformed)
+        {
+            auto mask = (1 << info.EndpointBits) - 1;
+            for(auto e=1u; e<epCount; ++e)
+            {
+                ep[e] = (ep[0] + ep[e]) & mask;
+                if (isSigned)
+                { ep[e] = SignExtend(ep[e], info.EndpointBits); }
+            }
+        }
+
+        for(auto e=0u; e<epCount; ++e)
+        { ep[e] = UnquantizeBC6H(ep[e], info.EndpointBits, isSigned); }
+    }
+
+    // インデックスを読み取って補間.
+    auto indexBits = (regions == 2) ? 3u : 4u;
+    auto anchor    = (regions == 2) ? kAnchor2[partition] : 0u;
+    auto weights   = (regions == 2) ? kWeight3 : kWeight4;
+
+    for(auto i=0u; i<16; ++i)
+    {
+        auto bits   = (i == 0 || i == anchor) ? indexBits - 1 : indexBits;
+        auto idx    = reader.Read(bits);
+        auto subset = (regions == 2) ? (kPartition2[partition] >> i) & 0x1 : 0u;
+        auto w      = int32_t(weights[idx]);
+
+        for(auto c=0; c<3; ++c)
+        {
+            auto e0 = channels[c][subset * 2 + 0];
+            auto e1 = channels[c][subset * 2 + 1];
+            auto v  = ((64 - w) * e0 + w * e1 + 32) >> 6;
+            pRGBA[i * 4 + c] = FinishUnquantizeBC6H(v, isSigned);
+        }
+        pRGBA[i * 4 + 3] = kHalfOne;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC7ブロックを展開します.
+//-----------------------------------------------------------------------------
+void DecodeBC7Block(const uint8_t* pBlock, uint8_t* pRGBA)
+{
+    BitReader reader(pBlock);
+
+    auto mode = 0u;
+    while(mode < 8 && reader.Read(1) == 0)
+    { mode++; }
+
+    // 不正なブロックは透明な黒として扱う.
+    if (mode >= 8)
+    {
+        memset(pRGBA, 0, 64);
+        return;
+    }
+
+    const auto& info = kBC7Modes[mode];
+
+    auto partition = reader.Read(info.PartitionBits);
+    auto rotation  = reader.Read(info.RotationBits);
+    auto indexMode = reader.Read(info.IndexModeBits);
+
+    auto epCount = info.SubsetCount * 2u;
+
+    uint32_t endpoints[6][4] = {};
+    for(auto c=0; c<3; ++c)
+    {
+        for(auto e=0u; e<epCount; ++e)
+        { endpoints[e][c] = reader.Read(info.ColorBits); }
+    }
+
+    if (info.AlphaBits > 0)
+    {
+        for(auto e=0u; e<epCount; ++e)
+        { endpoints[e][3] = reader.Read(info.AlphaBits); }
+    }
+
+    auto colorBits = uint32_t(info.ColorBits);
+    auto alphaBits = uint32_t(info.AlphaBits);
+
+    // Pビットを付与.
+    if (info.EndpointPBits || info.SharedPBits)
+    {
+        uint32_t pbits[6] = {};
+        if (info.EndpointPBits)
+        {
+            for(auto e=0u; e<epCount; ++e)
+            { pbits[e] = reader.Read(1); }
+        }
+        else
+        {
+            for(auto s=0u; s<info.SubsetCount; ++s)
+            {
+                auto p = reader.Read(1);
+                pbits[s * 2 + 0] = p;
+                pbits[s * 2 + 1] = p;
+            }
+        }
+
+        for(auto e=0u; e<epCount; ++e)
+        {
+            for(auto c=0; c<4; ++c)
+            { endpoints[e][c] = (endpoints[e][c] << 1) | pbits[e]; }
+        }
+
+        colorBits++;
+        if (alphaBits > 0)
+        { alphaBits++; }
+    }
+
+    // 8bitに展開.
+    for(auto e=0u; e<epCount; ++e)
+    {
+        for(auto c=0; c<3; ++c)
+        {
+            auto v = endpoints[e][c] << (8 - colorBits);
+            endpoints[e][c] = v | (v >> colorBits);
+        }
+
+        if (alphaBits > 0)
+        {
+            auto v = endpoints[e][3] << (8 - alphaBits);
+            endpoints[e][3] = v | (v >> alphaBits);
+        }
+        else
+        { endpoints[e][3] = 255; }
+    }
+
+    // アンカーを決定.
+    uint32_t anchors[3] = { 0, 0, 0 };
+    if (info.SubsetCount == 2)
+    { anchors[1] = kAnchor2[partition]; }
+    else if (info.SubsetCount == 3)
+    {
+        anchors[1] = kAnchor3a[partition];
+        anchors[2] = kAnchor3b[partition];
+    }
+
+    auto IsAnchor = [&](uint32_t i)
+    { return i == anchors[0] || (info.SubsetCount > 1 && i == anchors[1]) || (info.SubsetCount > 2 && i == anchors[2]); };
+
+    uint8_t subsets[16] = {};
+    for(auto i=0u; i<16; ++i)
+    {
+        if (info.SubsetCount == 2)
+        { subsets[i] = uint8_t((kPartition2[partition] >> i) & 0x1); }
+        else if (info.SubsetCount == 3)
+        { subsets[i] = kPartition3[partition][i]; }
+    }
+
+    uint32_t indices[16];
+    for(auto i=0u; i<16; ++i)
+    { indices[i] = reader.Read(IsAnchor(i) ? info.IndexBits - 1 : info.IndexBits); }
+
+    uint32_t indices2[16] = {};
+    if (info.IndexBits2 > 0)
+    {
+        for(auto i=0u; i<16; ++i)
+        { indices2[i] = reader.Read((i == 0) ? info.IndexBits2 - 1 : info.IndexBits2); }
+    }
+
+    auto Weights = [](uint32_t bits)
+    { return (bits == 2) ? kWeight2 : (bits == 3) ? kWeight3 : kWeight4; };
+
+    auto colorWeights = Weights(info.IndexBits);
+    auto alphaWeights = colorWeights;
+    auto colorIndices = indices;
+    auto alphaIndices = indices;
+
+    if (info.IndexBits2 > 0)
+    {
+        alphaWeights = Weights(info.IndexBits2);
+        alphaIndices = indices2;
+        if (indexMode)
+        {
+            std::swap(colorWeights, alphaWeights);
+            std::swap(colorIndices, alphaIndices);
+        }
+    }
+
+    for(auto i=0u; i<16; ++i)
+    {
+        auto s  = subsets[i];
+        auto cw = uint32_t(colorWeights[colorIndices[i]]);
+        auto aw = uint32_t(alphaWeights[alphaIndices[i]]);
+
+        uint32_t pixel[4];
+        for(auto c=0; c<3; ++c)
+        { pixel[c] = ((64 - cw) * endpoints[s * 2 + 0][c] + cw * endpoints[s * 2 + 1][c] + 32) >> 6; }
+        pixel[3] = ((64 - aw) * endpoints[s * 2 + 0][3] + aw * endpoints[s * 2 + 1][3] + 32) >> 6;
+
+        if (rotation > 0)
+        { std::swap(pixel[3], pixel[rotation - 1]); }
+
+        pRGBA[i * 4 + 0] = uint8_t(pixel[0]);
+        pRGBA[i * 4 + 1] = uint8_t(pixel[1]);
+        pRGBA[i * 4 + 2] = uint8_t(pixel[2]);
+        pRGBA[i * 4 + 3] = uint8_t(pixel[3]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      RGB565にパックします.
+//-----------------------------------------------------------------------------
+inline uint16_t PackRGB565(const float* pRGB)
+{
+    auto r = uint32_t(asdx::Clamp(pRGB[0], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+    auto g = uint32_t(asdx::Clamp(pRGB[1], 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f);
+    auto b = uint32_t(asdx::Clamp(pRGB[2], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+    return uint16_t((r << 11) | (g << 5) | b);
+}
+
+#if ASDX_BC_USE_SSE2
+//-----------------------------------------------------------------------------
+//      マスクが立っているレーンだけ値を差し替えます.
+//-----------------------------------------------------------------------------
+inline __m128i SelectIf(__m128i mask, __m128i a, __m128i b)
+{ return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+#endif//ASDX_BC_USE_SSE2
+
+//-----------------------------------------------------------------------------
+//      パレットから最も近い色を選択してインデックスを決定します.
+//-----------------------------------------------------------------------------
+uint32_t SelectColorIndices
+(
+    const uint8_t*  pRGBA,
+    const int32_t   palette[4][4],
+    uint32_t        paletteCount,
+    bool            useTransparent,
+    uint32_t&       error
+)
+{
+    uint32_t best    [16];
+    uint32_t bestDist[16];
+
+#if ASDX_BC_USE_SSE2
+    // 2画素ずつ16bitに広げ, 差の二乗和を _mm_madd_epi16 で求める.
+    const auto zero = _mm_setzero_si128();
+    const auto mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+
+    __m128i pixels[8];
+    for(auto i=0; i<4; ++i)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRGBA + i * 16));
+        pixels[i * 2 + 0] = _mm_and_si128(_mm_unpacklo_epi8(v, zero), mask);
+        pixels[i * 2 + 1] = _mm_and_si128(_mm_unpackhi_epi8(v, zero), mask);
+    }
+
+    __m128i minDist [4];
+    __m128i minIndex[4];
+    for(auto j=0u; j<paletteCount; ++j)
+    {
+        auto r     = int16_t(palette[j][0]);
+        auto g     = int16_t(palette[j][1]);
+        auto b     = int16_t(palette[j][2]);
+        auto color = _mm_set_epi16(0, b, g, r, 0, b, g, r);
+        auto index = _mm_set1_epi32(int32_t(j));
+
+        for(auto k=0; k<4; ++k)
+        {
+            auto d0 = _mm_sub_epi16(pixels[k * 2 + 0], color);
+            auto d1 = _mm_sub_epi16(pixels[k * 2 + 1], color);
+            auto s0 = _mm_castsi128_ps(_mm_madd_epi16(d0, d0));
+            auto s1 = _mm_castsi128_ps(_mm_madd_epi16(d1, d1));
+
+            // 画素毎に (R^2 + G^2) と B^2 を足して4画素分の距離にする.
+            auto dist = _mm_add_epi32(
+                _mm_castps_si128(_mm_shuffle_ps(s0, s1, _MM_SHUFFLE(2, 0, 2, 0))),
+                _mm_castps_si128(_mm_shuffle_ps(s0, s1, _MM_SHUFFLE(3, 1, 3, 1))));
+
+            if (j == 0)
+            {
+                minDist [k] = dist;
+                minIndex[k] = index;
+                continue;
+            }
+
+            // 同じ距離なら先のパレットを残す.
+            auto less = _mm_cmplt_epi32(dist, minDist[k]);
+            minDist [k] = SelectIf(less, dist,  minDist [k]);
+            minIndex[k] = SelectIf(less, index, minIndex[k]);
+        }
+    }
+
+    for(auto k=0; k<4; ++k)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(best     + k * 4), minIndex[k]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bestDist + k * 4), minDist [k]);
+    }
+#else
+    for(auto i=0u; i<16; ++i)
+    {
+        best    [i] = 0;
+        bestDist[i] = UINT32_MAX;
+        for(auto j=0u; j<paletteCount; ++j)
+        {
+            auto dr = int32_t(pRGBA[i * 4 + 0]) - palette[j][0];
+            auto dg = int32_t(pRGBA[i * 4 + 1]) - palette[j][1];
+            auto db = int32_t(pRGBA[i * 4 + 2]) - palette[j][2];
+            auto d  = uint32_t(dr * dr + dg * dg + db * db);
+            if (d < bestDist[i])
+            {
+                bestDist[i] = d;
+                best    [i] = j;
+            }
+        }
+    }
+#endif//ASDX_BC_USE_SSE2
+
+    uint32_t indices = 0;
+    error = 0;
+
+    for(auto i=0u; i<16; ++i)
+    {
+        if (useTransparent && pRGBA[i * 4 + 3] < 128)
+        {
+            indices |= 3u << (i * 2);
+            continue;
+        }
+
+        indices |= best[i] << (i * 2);
+        error   += bestDist[i];
+    }
+
+    return indices;
+}
+
+//-----------------------------------------------------------------------------
+//      BC1カラーブロックを圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeColorBlock(const uint8_t* pRGBA, bool allowTransparent, uint8_t* pBlock)
+{
+    // 透過ピクセルを含むかどうか.
+    auto hasAlpha = false;
+    if (allowTransparent)
+    {
+        for(auto i=0; i<16; ++i)
+        {
+            if (pRGBA[i * 4 + 3] < 128)
+            {
+                hasAlpha = true;
+                break;
+            }
+        }
+    }
+
+    // 平均を求める.
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    auto  count   = 0;
+    for(auto i=0; i<16; ++i)
+    {
+        if (hasAlpha && pRGBA[i * 4 + 3] < 128)
+        { continue; }
+
+        mean[0] += pRGBA[i * 4 + 0];
+        mean[1] += pRGBA[i * 4 + 1];
+        mean[2] += pRGBA[i * 4 + 2];
+        count++;
+    }
+
+    // 全ピクセルが透過.
+    if (count == 0)
+    {
+        memset(pBlock, 0, 4);
+        memset(pBlock + 4, 0xFF, 4);
+        return;
+    }
+
+    for(auto c=0; c<3; ++c)
+    { mean[c] /= float(count); }
+
+    // 共分散行列から主軸を求める.
+    float cov[6] = {};
+    for(auto i=0; i<16; ++i)
+    {
+        if (hasAlpha && pRGBA[i * 4 + 3] < 128)
+        { continue; }
+
+        auto r = pRGBA[i * 4 + 0] - mean[0];
+        auto g = pRGBA[i * 4 + 1] - mean[1];
+        auto b = pRGBA[i * 4 + 2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for(auto iter=0; iter<8; ++iter)
+    {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float m = asdx::Max(fabsf(x), asdx::Max(fabsf(y), fabsf(z)));
+        if (m <= FLT_EPSILON)
+        { break; }
+        axis[0] = x / m;
+        axis[1] = y / m;
+        axis[2] = z / m;
+    }
+
+    // 主軸上の範囲からエンドポイントを決定.
+    auto minT = FLT_MAX;
+    auto maxT = -FLT_MAX;
+    for(auto i=0; i<16; ++i)
+    {
+        if (hasAlpha && pRGBA[i * 4 + 3] < 128)
+        { continue; }
+
+        auto t = (pRGBA[i * 4 + 0] - mean[0]) * axis[0]
+               + (pRGBA[i * 4 + 1] - mean[1]) * axis[1]
+               + (pRGBA[i * 4 + 2] - mean[2]) * axis[2];
+        minT = asdx::Min(minT, t);
+        maxT = asdx::Max(maxT, t);
+    }
+
+    float e0[3], e1[3];
+    for(auto c=0; c<3; ++c)
+    {
+        e0[c] = mean[c] + axis[c] * maxT;
+        e1[c] = mean[c] + axis[c] * minT;
+    }
+
+    auto c0 = PackRGB565(e0);
+    auto c1 = PackRGB565(e1);
+
+    int32_t  palette[4][4];
+    uint32_t indices = 0;
+    uint32_t error   = 0;
+
+    if (hasAlpha)
+    {
+        // 3色 + 透過モード (c0 <= c1).
+        if (c0 > c1)
+        { std::swap(c0, c1); }
+
+        BuildColorPalette(c0, c1, false, palette);
+        indices = SelectColorIndices(pRGBA, palette, 3, true, error);
+    }
+    else
+    {
+        // 4色モード (c0 > c1).
+        if (c0 < c1)
+        { std::swap(c0, c1); }
+
+        BuildColorPalette(c0, c1, true, palette);
+        indices = SelectColorIndices(pRGBA, palette, 4, false, error);
+
+        // 最小二乗法でエンドポイントを改善.
+        static const float kIndexWeight[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        for(auto iter=0; iter<2 && error > 0 && c0 != c1; ++iter)
+        {
+            float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+            float ax[3] = {}, bx[3] = {};
+            for(auto i=0; i<16; ++i)
+            {
+                auto w = kIndexWeight[(indices >> (i * 2)) & 0x3];
+                auto a = 1.0f - w;
+                aa += a * a; bb += w * w; ab += a * w;
+                for(auto c=0; c<3; ++c)
+                {
+                    ax[c] += a * pRGBA[i * 4 + c];
+                    bx[c] += w * pRGBA[i * 4 + c];
+                }
+            }
+
+            auto det = aa * bb - ab * ab;
+            if (fabsf(det) <= FLT_EPSILON)
+            { break; }
+
+            float n0[3], n1[3];
+            for(auto c=0; c<3; ++c)
+            {
+                n0[c] = (ax[c] * bb - bx[c] * ab) / det;
+                n1[c] = (bx[c] * aa - ax[c] * ab) / det;
+            }
+
+            auto t0 = PackRGB565(n0);
+            auto t1 = PackRGB565(n1);
+            if (t0 < t1)
+            { std::swap(t0, t1); }
+            if (t0 == t1)
+            { break; }
+
+            int32_t  newPalette[4][4];
+            uint32_t newError = 0;
+            BuildColorPalette(t0, t1, true, newPalette);
+            auto newIndices = SelectColorIndices(pRGBA, newPalette, 4, false, newError);
+            if (newError >= error)
+            { break; }
+
+            c0      = t0;
+            c1      = t1;
+            indices = newIndices;
+            error   = newError;
+        }
+
+        // 同色の場合は3色モードになるのでインデックスを0に揃える.
+        if (c0 == c1)
+        { indices = 0; }
+    }
+
+    pBlock[0] = uint8_t(c0 & 0xFF);
+    pBlock[1] = uint8_t(c0 >> 8);
+    pBlock[2] = uint8_t(c1 & 0xFF);
+    pBlock[3] = uint8_t(c1 >> 8);
+    memcpy(pBlock + 4, &indices, sizeof(indices));
+}
+
+//-----------------------------------------------------------------------------
+//      BC4ブロックを圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeAlphaBlock(const uint8_t* pSrc, uint32_t stride, bool isSigned, uint8_t* pBlock)
+{
+    int32_t values[16];
+    int32_t minV = INT32_MAX;
+    int32_t maxV = INT32_MIN;
+    for(auto i=0u; i<16; ++i)
+    {
+        values[i] = (isSigned)
+            ? asdx::Max(int32_t(int8_t(pSrc[i * stride])), -127)
+            : int32_t(pSrc[i * stride]);
+        minV = asdx::Min(minV, values[i]);
+        maxV = asdx::Max(maxV, values[i]);
+    }
+
+    // 8値モード (a0 > a1).
+    int32_t palette[8];
+    BuildAlphaPalette(maxV, minV, isSigned, palette);
+
+    uint64_t indices = 0;
+
+#if ASDX_BC_USE_SSE2
+    // 値域は [-127, 255] なので, 16画素を16bitで並べて差の絶対値を比べる.
+    int16_t lanes[16];
+    for(auto i=0u; i<16; ++i)
+    { lanes[i] = int16_t(values[i]); }
+
+    const auto zero = _mm_setzero_si128();
+
+    __m128i pixels[2];
+    pixels[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + 0));
+    pixels[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + 8));
+
+    __m128i minDist [2];
+    __m128i minIndex[2];
+    for(auto j=0; j<8; ++j)
+    {
+        auto value = _mm_set1_epi16(int16_t(palette[j]));
+        auto index = _mm_set1_epi16(int16_t(j));
+
+        for(auto k=0; k<2; ++k)
+        {
+            auto diff = _mm_sub_epi16(pixels[k], value);
+            auto dist = _mm_max_epi16(diff, _mm_sub_epi16(zero, diff));
+
+            if (j == 0)
+            {
+                minDist [k] = dist;
+                minIndex[k] = index;
+                continue;
+            }
+
+            auto less = _mm_cmplt_epi16(dist, minDist[k]);
+            minDist [k] = SelectIf(less, dist,  minDist [k]);
+            minIndex[k] = SelectIf(less, index, minIndex[k]);
+        }
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 0), minIndex[0]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 8), minIndex[1]);
+
+    for(auto i=0u; i<16; ++i)
+    { indices |= uint64_t(lanes[i]) << (i * 3); }
+#else
+    for(auto i=0u; i<16; ++i)
+    {
+        auto best     = 0u;
+        auto bestDist = INT32_MAX;
+        for(auto j=0u; j<8; ++j)
+        {
+            auto d = abs(values[i] - palette[j]);
+            if (d < bestDist)
+            {
+                bestDist = d;
+                best     = j;
+            }
+        }
+        indices |= uint64_t(best) << (i * 3);
+    }
+#endif//ASDX_BC_USE_SSE2
+
+    pBlock[0] = uint8_t(maxV);
+    pBlock[1] = uint8_t(minV);
+    memcpy(pBlock + 2, &indices, 6);
+}
+
+//-----------------------------------------------------------------------------
+//      BC2の明示アルファブロックを圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeExplicitAlphaBlock(const uint8_t* pRGBA, uint8_t* pBlock)
+{
+    memset(pBlock, 0, 8);
+    for(auto i=0; i<16; ++i)
+    {
+        auto a = (pRGBA[i * 4 + 3] * 15 + 127) / 255;
+        pBlock[i / 2] |= uint8_t(a << ((i & 0x1) * 4));
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ブロック行を展開します.
+//-----------------------------------------------------------------------------
+void DecodeBlockRows(const BlockJob& job, uint32_t rowBegin, uint32_t rowEnd)
+{
+    auto blockSize = asdx::GetBCBlockSize(job.Format);
+    auto pixelSize = asdx::GetBCDecodedPixelSize(job.Format);
+    auto blocksX   = (job.Width + 3) / 4;
+
+    uint8_t pixels[16 * 8];
+
+    for(auto by=rowBegin; by<rowEnd; ++by)
+    {
+        auto pBlock = job.pSrc + size_t(by) * job.SrcPitch;
+
+        for(auto bx=0u; bx<blocksX; ++bx, pBlock += blockSize)
+        {
+            switch(job.Format)
+            {
+            case asdx::BC_FORMAT_BC1:       DecodeBC1Block(pBlock, pixels); break;
+            case asdx::BC_FORMAT_BC2:       DecodeBC2Block(pBlock, pixels); break;
+            case asdx::BC_FORMAT_BC3:       DecodeBC3Block(pBlock, pixels); break;
+            case asdx::BC_FORMAT_BC4_UNORM: DecodeBC4Block(pBlock, false, pixels); break;
+            case asdx::BC_FORMAT_BC4_SNORM: DecodeBC4Block(pBlock, true,  pixels); break;
+            case asdx::BC_FORMAT_BC5_UNORM: DecodeBC5Block(pBlock, false, pixels); break;
+            case asdx::BC_FORMAT_BC5_SNORM: DecodeBC5Block(pBlock, true,  pixels); break;
+            case asdx::BC_FORMAT_BC6H_UF16: DecodeBC6HBlock(pBlock, false, reinterpret_cast<uint16_t*>(pixels)); break;
+            case asdx::BC_FORMAT_BC6H_SF16: DecodeBC6HBlock(pBlock, true,  reinterpret_cast<uint16_t*>(pixels)); break;
+            case asdx::BC_FORMAT_BC7:       DecodeBC7Block(pBlock, pixels); break;
+            default:                        memset(pixels, 0, sizeof(pixels)); break;
+            }
+
+            // 画像範囲内のみ書き出す.
+            auto w = asdx::Min(4u, job.Width  - bx * 4);
+            auto h = asdx::Min(4u, job.Height - by * 4);
+            for(auto y=0u; y<h; ++y)
+            {
+                auto pDst = job.pDst + size_t(by * 4 + y) * job.DstPitch + size_t(bx * 4) * pixelSize;
+                memcpy(pDst, pixels + y * 4 * pixelSize, w * pixelSize);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ブロック行を圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBlockRows(const BlockJob& job, uint32_t rowBegin, uint32_t rowEnd)
+{
+    auto blockSize = asdx::GetBCBlockSize(job.Format);
+    auto blocksX   = (job.Width + 3) / 4;
+
+    uint8_t pixels[16 * 4];
+
+    for(auto by=rowBegin; by<rowEnd; ++by)
+    {
+        auto pBlock = job.pDst + size_t(by) * job.DstPitch;
+
+        for(auto bx=0u; bx<blocksX; ++bx, pBlock += blockSize)
+        {
+            // 端のブロックは最終行・最終列を複製して埋める.
+            for(auto y=0u; y<4; ++y)
+            {
+                auto sy   = asdx::Min(by * 4 + y, job.Height - 1);
+                auto pRow = job.pSrc + size_t(sy) * job.SrcPitch;
+                for(auto x=0u; x<4; ++x)
+                {
+                    auto sx = asdx::Min(bx * 4 + x, job.Width - 1);
+                    memcpy(pixels + (y * 4 + x) * 4, pRow + sx * 4, 4);
+                }
+            }
+
+            switch(job.Format)
+            {
+            case asdx::BC_FORMAT_BC1:
+                { EncodeColorBlock(pixels, true, pBlock); }
+                break;
+
+            case asdx::BC_FORMAT_BC2:
+                {
+                    EncodeExplicitAlphaBlock(pixels, pBlock);
+                    EncodeColorBlock(pixels, false, pBlock + 8);
+                }
+                break;
+
+            case asdx::BC_FORMAT_BC3:
+                {
+                    EncodeAlphaBlock(pixels + 3, 4, false, pBlock);
+                    EncodeColorBlock(pixels, false, pBlock + 8);
+                }
+                break;
+
+            case asdx::BC_FORMAT_BC4_UNORM:
+            case asdx::BC_FORMAT_BC4_SNORM:
+                { EncodeAlphaBlock(pixels, 4, job.Format == asdx::BC_FORMAT_BC4_SNORM, pBlock); }
+                break;
+
+            case asdx::BC_FORMAT_BC5_UNORM:
+            case asdx::BC_FORMAT_BC5_SNORM:
+                {
+                    auto isSigned = (job.Format == asdx::BC_FORMAT_BC5_SNORM);
+                    EncodeAlphaBlock(pixels + 0, 4, isSigned, pBlock + 0);
+                    EncodeAlphaBlock(pixels + 1, 4, isSigned, pBlock + 8);
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      展開後のDXGIフォーマットを取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetDecodedFormat(uint32_t dxgiFormat)
+{
+    switch(dxgiFormat)
+    {
+    case FORMAT_BC1_UNORM_SRGB:
+    case FORMAT_BC2_UNORM_SRGB:
+    case FORMAT_BC3_UNORM_SRGB:
+    case FORMAT_BC7_UNORM_SRGB:
+        return FORMAT_R8G8B8A8_UNORM_SRGB;
+
+    case FORMAT_BC4_SNORM:
+    case FORMAT_BC5_SNORM:
+        return FORMAT_R8G8B8A8_SNORM;
+
+    case FORMAT_BC6H_TYPELESS:
+    case FORMAT_BC6H_UF16:
+    case FORMAT_BC6H_SF16:
+        return FORMAT_R16G16B16A16_FLOAT;
+
+    default:
+        return FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      サブリソース配列を確保します.
+//-----------------------------------------------------------------------------
+bool AllocResources(const asdx::ResTexture& src, asdx::ResTexture& dst)
+{
+    auto mipCount = (src.MipMapCount > 0) ? src.MipMapCount : 1;
+
+    dst.Dimension    = src.Dimension;
+    dst.Width        = src.Width;
+    dst.Height       = src.Height;
+    dst.Depth        = src.Depth;
+    dst.MipMapCount  = src.MipMapCount;
+    dst.SurfaceCount = src.SurfaceCount;
+    dst.pResources   = new (std::nothrow) asdx::SubResource[src.SurfaceCount * mipCount];
+
+    return dst.pResources != nullptr;
+}
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      DXGIフォーマットからブロック圧縮フォーマットを取得します.
+//-----------------------------------------------------------------------------
+BC_FORMAT GetBCFormat(uint32_t dxgiFormat)
+{
+    switch(dxgiFormat)
+    {
+    case FORMAT_BC1_TYPELESS:
+    case FORMAT_BC1_UNORM:
+    case FORMAT_BC1_UNORM_SRGB:
+        return BC_FORMAT_BC1;
+
+    case FORMAT_BC2_TYPELESS:
+    case FORMAT_BC2_UNORM:
+    case FORMAT_BC2_UNORM_SRGB:
+        return BC_FORMAT_BC2;
+
+    case FORMAT_BC3_TYPELESS:
+    case FORMAT_BC3_UNORM:
+    case FORMAT_BC3_UNORM_SRGB:
+        return BC_FORMAT_BC3;
+
+    case FORMAT_BC4_TYPELESS:
+    case FORMAT_BC4_UNORM:
+        return BC_FORMAT_BC4_UNORM;
+
+    case FORMAT_BC4_SNORM:
+        return BC_FORMAT_BC4_SNORM;
+
+    case FORMAT_BC5_TYPELESS:
+    case FORMAT_BC5_UNORM:
+        return BC_FORMAT_BC5_UNORM;
+
+    case FORMAT_BC5_SNORM:
+        return BC_FORMAT_BC5_SNORM;
+
+    case FORMAT_BC6H_TYPELESS:
+    case FORMAT_BC6H_UF16:
+        return BC_FORMAT_BC6H_UF16;
+
+    case FORMAT_BC6H_SF16:
+        return BC_FORMAT_BC6H_SF16;
+
+    case FORMAT_BC7_TYPELESS:
+    case FORMAT_BC7_UNORM:
+    case FORMAT_BC7_UNORM_SRGB:
+        return BC_FORMAT_BC7;
+
+    default:
+        return BC_FORMAT_UNKNOWN;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      4x4ブロック当たりのバイト数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetBCBlockSize(BC_FORMAT format)
+{
+    switch(format)
+    {
+    case BC_FORMAT_BC1:
+    case BC_FORMAT_BC4_UNORM:
+    case BC_FORMAT_BC4_SNORM:
+        return 8;
+
+    case BC_FORMAT_UNKNOWN:
+        return 0;
+
+    default:
+        return 16;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      展開後の1ピクセル当たりのバイト数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t GetBCDecodedPixelSize(BC_FORMAT format)
+{
+    switch(format)
+    {
+    case BC_FORMAT_BC6H_UF16:
+    case BC_FORMAT_BC6H_SF16:
+        return 8;
+
+    case BC_FORMAT_UNKNOWN:
+        return 0;
+
+    default:
+        return 4;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ブロック圧縮データを展開します.
+//-----------------------------------------------------------------------------
+bool DecodeBC
+(
+    BC_FORMAT       format,
+    uint32_t        width,
+    uint32_t        height,
+    const uint8_t*  pSrc,
+    uint32_t        srcPitch,
+    uint8_t*        pDst,
+    uint32_t        dstPitch,
+    IThreadPool*    pThreadPool
+)
+{
+    if (format == BC_FORMAT_UNKNOWN || pSrc == nullptr || pDst == nullptr || width == 0 || height == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    BlockJob job = {};
+    job.Format   = format;
+    job.Width    = width;
+    job.Height   = height;
+    job.pSrc     = pSrc;
+    job.SrcPitch = srcPitch;
+    job.pDst     = pDst;
+    job.DstPitch = dstPitch;
+    job.Process  = DecodeBlockRows;
+
+    DispatchBlockRows(job, pThreadPool);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ブロック圧縮を行います.
+//-----------------------------------------------------------------------------
+bool EncodeBC
+(
+    BC_FORMAT       format,
+    uint32_t        width,
+    uint32_t        height,
+    const uint8_t*  pSrc,
+    uint32_t        srcPitch,
+    uint8_t*        pDst,
+    uint32_t        dstPitch,
+    IThreadPool*    pThreadPool
+)
+{
+    if (pSrc == nullptr || pDst == nullptr || width == 0 || height == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    if (format == BC_FORMAT_UNKNOWN
+     || format == BC_FORMAT_BC6H_UF16
+     || format == BC_FORMAT_BC6H_SF16
+     || format == BC_FORMAT_BC7)
+    {
+        ELOG("Error : Unsupported Encode Format. format = %u", uint32_t(format));
+        return false;
+    }
+
+    BlockJob job = {};
+    job.Format   = format;
+    job.Width    = width;
+    job.Height   = height;
+    job.pSrc     = pSrc;
+    job.SrcPitch = srcPitch;
+    job.pDst     = pDst;
+    job.DstPitch = dstPitch;
+    job.Process  = EncodeBlockRows;
+
+    DispatchBlockRows(job, pThreadPool);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ブロック圧縮テクスチャを展開したリソーステクスチャを生成します.
+//-----------------------------------------------------------------------------
+bool DecompressResTexture(const ResTexture& src, ResTexture& dst, IThreadPool* pThreadPool)
+{
+    auto format = GetBCFormat(src.Format);
+    if (format == BC_FORMAT_UNKNOWN)
+    {
+        ELOG("Error : Not Block Compression Format. format = %u", src.Format);
+        return false;
+    }
+
+    if (src.Dimension == TEXTURE_DIMENSION_3D)
+    {
+        ELOG("Error : Volume Texture Not Supported.");
+        return false;
+    }
+
+    if (!AllocResources(src, dst))
+    {
+        ELOG("Error : Out of Memory.");
+        return false;
+    }
+
+    dst.Format = GetDecodedFormat(src.Format);
+
+    auto pixelSize = GetBCDecodedPixelSize(format);
+    auto mipCount  = (src.MipMapCount > 0) ? src.MipMapCount : 1;
+    auto count     = src.SurfaceCount * mipCount;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        const auto& srcRes = src.pResources[i];
+        auto&       dstRes = dst.pResources[i];
+
+        dstRes.Width      = srcRes.Width;
+        dstRes.Height     = srcRes.Height;
+        dstRes.MipIndex   = srcRes.MipIndex;
+        dstRes.Pitch      = srcRes.Width * pixelSize;
+        dstRes.SlicePitch = dstRes.Pitch * srcRes.Height;
+        dstRes.pPixels    = new (std::nothrow) uint8_t[dstRes.SlicePitch];
+        if (dstRes.pPixels == nullptr)
+        {
+            ELOG("Error : Out of Memory.");
+            dst.Dispose();
+            return false;
+        }
+
+        if (!DecodeBC(format, srcRes.Width, srcRes.Height, srcRes.pPixels, srcRes.Pitch, dstRes.pPixels, dstRes.Pitch, pThreadPool))
+        {
+            ELOG("Error : DecodeBC() Failed.");
+            dst.Dispose();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ブロック圧縮したリソーステクスチャを生成します.
+//-----------------------------------------------------------------------------
+bool CompressResTexture(const ResTexture& src, uint32_t dxgiFormat, ResTexture& dst, IThreadPool* pThreadPool)
+{
+    auto format = GetBCFormat(dxgiFormat);
+    if (format == BC_FORMAT_UNKNOWN
+     || format == BC_FORMAT_BC6H_UF16
+     || format == BC_FORMAT_BC6H_SF16
+     || format == BC_FORMAT_BC7)
+    {
+        ELOG("Error : Unsupported Encode Format. format = %u", dxgiFormat);
+        return false;
+    }
+
+    auto isSigned = (format == BC_FORMAT_BC4_SNORM || format == BC_FORMAT_BC5_SNORM);
+    auto validSrc = (isSigned)
+        ? (src.Format == FORMAT_R8G8B8A8_SNORM)
+        : (src.Format == FORMAT_R8G8B8A8_UNORM || src.Format == FORMAT_R8G8B8A8_UNORM_SRGB);
+    if (!validSrc)
+    {
+        ELOG("Error : Source Format Must Be RGBA8. format = %u", src.Format);
+        return false;
+    }
+
+    if (src.Dimension == TEXTURE_DIMENSION_3D)
+    {
+        ELOG("Error : Volume Texture Not Supported.");
+        return false;
+    }
+
+    if (!AllocResources(src, dst))
+    {
+        ELOG("Error : Out of Memory.");
+        return false;
+    }
+
+    dst.Format = dxgiFormat;
+
+    auto blockSize = GetBCBlockSize(format);
+    auto mipCount  = (src.MipMapCount > 0) ? src.MipMapCount : 1;
+    auto count     = src.SurfaceCount * mipCount;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        const auto& srcRes = src.pResources[i];
+        auto&       dstRes = dst.pResources[i];
+
+        auto blocksX = Max(1u, (srcRes.Width  + 3) / 4);
+        auto blocksY = Max(1u, (srcRes.Height + 3) / 4);
+
+        dstRes.Width      = srcRes.Width;
+        dstRes.Height     = srcRes.Height;
+        dstRes.MipIndex   = srcRes.MipIndex;
+        dstRes.Pitch      = blocksX * blockSize;
+        dstRes.SlicePitch = dstRes.Pitch * blocksY;
+        dstRes.pPixels    = new (std::nothrow) uint8_t[dstRes.SlicePitch];
+        if (dstRes.pPixels == nullptr)
+        {
+            ELOG("Error : Out of Memory.");
+            dst.Dispose();
+            return false;
+        }
+
+        if (!EncodeBC(format, srcRes.Width, srcRes.Height, srcRes.pPixels, srcRes.Pitch, dstRes.pPixels, dstRes.Pitch, pThreadPool))
+        {
+            ELOG("Error : EncodeBC() Failed.");
+            dst.Dispose();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      RGBA8画像同士のPSNRを計算します.
+//-----------------------------------------------------------------------------
+double CalcPSNR
+(
+    uint32_t        width,
+    uint32_t        height,
+    const uint8_t*  pA,
+    uint32_t        pitchA,
+    const uint8_t*  pB,
+    uint32_t        pitchB,
+    uint32_t        channelCount
+)
+{
+    if (pA == nullptr || pB == nullptr || width == 0 || height == 0 || channelCount == 0 || channelCount > 4)
+    { return 0.0; }
+
+    uint64_t sum = 0;
+    for(auto y=0u; y<height; ++y)
+    {
+        auto pRowA = pA + size_t(y) * pitchA;
+        auto pRowB = pB + size_t(y) * pitchB;
+        for(auto x=0u; x<width; ++x)
+        {
+            for(auto c=0u; c<channelCount; ++c)
+            {
+                auto d = int32_t(pRowA[x * 4 + c]) - int32_t(pRowB[x * 4 + c]);
+                sum += uint64_t(d * d);
+            }
+        }
+    }
+
+    if (sum == 0)
+    { return std::numeric_limits<double>::infinity(); }
+
+    auto mse = double(sum) / (double(width) * double(height) * double(channelCount));
+    return 10.0 * log10((255.0 * 255.0) / mse);
+}
+
+} // namespace asdx
@@ -0,0 +1,1024 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxImageDecoder.cpp
+// Desc : TGA / HDR Image Decoder.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <array>
+#include <thread>
+#include <vector>
+#include <res/asdxImageDecoder.h>
+#include <fnd/asdxLogger.h>
+#include <fnd/asdxMath.h>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+// dxgiformat.h に依存せずにビルドできるようにDXGI_FORMATの値を定義しておく.
+static const uint32_t FORMAT_UNKNOWN             = 0;
+static const uint32_t FORMAT_R32G32B32A32_FLOAT  = 2;
+static const uint32_t FORMAT_R8G8B8A8_UNORM      = 28;
+static const uint32_t FORMAT_R8_UNORM            = 61;
+static const uint32_t FORMAT_B5G5R5A1_UNORM      = 86;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// TGA_FORMA_TYPE enum
+////////////////////////////////////////////////////////////////////////////////////////////////////
+enum TGA_FORMAT_TYPE
+{
+    TGA_FORMAT_NONE             = 0,        //!< イメージなし.
+    TGA_FORMAT_INDEXCOLOR       = 1,        //!< インデックスカラー(256色).
+    TGA_FORMAT_FULLCOLOR        = 2,        //!< フルカラー
+    TGA_FORMAT_GRAYSCALE        = 3,        //!< 白黒.
+    TGA_FORMAT_RLE_INDEXCOLOR   = 9,        //!< RLE圧縮インデックスカラー.
+    TGA_FORMAT_RLE_FULLCOLOR    = 10,       //!< RLE圧縮フルカラー.
+    TGA_FORMAT_RLE_GRAYSCALE    = 11,       //!< RLE圧縮白黒.
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// TGA_HEADER structure
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma pack( push, 1 )
+struct TGA_HEADER
+{
+    uint8_t  IdFieldLength;      // IDフィードのサイズ(範囲は0～255).
+    uint8_t  HasColorMap;        // カラーマップ有無(0=なし, 1=あり)
+    uint8_t  Format;             // 画像形式.
+    uint16_t ColorMapEntry;      // カラーマップエントリー.
+    uint16_t ColorMapLength;     // カラーマップのエントリーの総数.
+    uint8_t  ColorMapEntrySize;  // カラーマップの1エントリー当たりのビット数.
+    uint16_t OffsetX;            // 画像のX座標.
+    uint16_t OffsetY;            // 画像のY座標.
+    uint16_t Width;              // 画像の横幅.
+    uint16_t Height;             // 画像の縦幅.
+    uint8_t  BitPerPixel;        // ビットの深さ.
+    uint8_t  ImageDescriptor;    // (0~3bit) : 属性, 4bit : 格納方向(0=左から右,1=右から左), 5bit : 格納方向(0=下から上, 1=上から下), 6~7bit : インタリーブ(使用不可).
+};
+#pragma pack( pop )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// TGA_FOOTER structure
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma pack( push, 1 )
+struct TGA_FOOTER
+{
+    uint32_t    OffsetExt;      // 拡張データへのオフセット(byte数) [オフセットはファイルの先頭から].
+    uint32_t    OffsetDev;      // ディベロッパーエリアへのオフセット(byte数)[オフセットはファイルの先頭から].
+    char        Tag[18];        // 'TRUEVISION-XFILE.\0'
+};
+#pragma pack( pop )
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TGA_EXTENSION structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma pack( push, 1 )
+struct TGA_EXTENSION
+{
+    uint16_t    Size;                       //!< サイズ.
+    char        AuthorName[ 41 ];           //!< 著作者名.
+    char        AuthorComment[ 324 ];       //!< 著作者コメント.
+    uint16_t    StampMonth;                 //!< タイムスタンプ　月(1-12).
+    uint16_t    StampDay;                   //!< タイムスタンプ　日(1-31).
+    uint16_t    StampYear;                  //!< タイムスタンプ　年(4桁, 例1989).
+    uint16_t    StampHour;                  //!< タイムスタンプ　時(0-23).
+    uint16_t    StampMinute;                //!< タイムスタンプ　分(0-59).
+    uint16_t    StampSecond;                //!< タイムスタンプ　秒(0-59).
+    char        JobName[ 41 ];              //!< ジョブ名 (最後のバイトはゼロが必須).
+    uint16_t    JobHour;                    //!< ジョブ時間  時(0-65535)
+    uint16_t    JobMinute;                  //!< ジョブ時間　分(0-59)
+    uint16_t    JobSecond;                  //!< ジョブ時間　秒(0-59)
+    char        SoftwareId[ 41 ];           //!< ソフトウェアID (最後のバイトはゼロが必須).
+    uint16_t    VersionNumber;              //!< ソフトウェアバージョン    VersionNumber * 100になる.
+    uint8_t     VersionLetter;              //!< ソフトウェアバージョン
+    uint32_t    KeyColor;                   //!< キーカラー.
+    uint16_t    PixelNumerator;             //!< ピクセル比分子　ピクセル横幅.
+    uint16_t    PixelDenominator;           //!< ピクセル比分母　ピクセル縦幅.
+    uint16_t    GammaNumerator;             //!< ガンマ値分子.
+    uint16_t    GammaDenominator;           //!< ガンマ値分母
+    uint32_t    ColorCorrectionOffset;      //!< 色補正テーブルへのオフセット.
+    uint32_t    StampOffset;                //!< ポステージスタンプ画像へのオフセット.
+    uint32_t    ScanLineOffset;             //!< スキャンラインオフセット.
+    uint8_t     AttributeType;              //!< アルファチャンネルデータのタイプ
+};
+#pragma pack( pop )
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// RGBE structure
+////////////////////////////////////////////////////////////////////////////////////////////
+struct RGBE
+{
+    union
+    {
+        struct
+        {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+            uint8_t e;
+        };
+        uint8_t v[4];
+    };
+};
+
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      ファイルの現在位置から終端までを一括で読み込みします.
+//-------------------------------------------------------------------------------------------------
+bool ReadToEnd( FILE* pFile, std::vector<uint8_t>& buffer )
+{
+    auto curr = ftell( pFile );
+    if ( curr < 0 )
+    { return false; }
+
+    fseek( pFile, 0, SEEK_END );
+    auto end = ftell( pFile );
+    fseek( pFile, curr, SEEK_SET );
+
+    if ( end < curr )
+    { return false; }
+
+    buffer.resize( size_t( end - curr ) );
+    if ( buffer.empty() )
+    { return true; }
+
+    return fread( buffer.data(), sizeof(uint8_t), buffer.size(), pFile ) == buffer.size();
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      インデックスカラーをRGBAに変換します.
+//-------------------------------------------------------------------------------------------------
+void ConvertIndexToRGBA( const uint8_t* pSrc, uint32_t count, const uint8_t* pColorMap, uint8_t* pDst )
+{
+    for( uint32_t i=0; i<count; ++i )
+    {
+        auto color = pSrc[ i ] * 3;
+        pDst[ i * 4 + 0 ] = pColorMap[ color + 2 ];
+        pDst[ i * 4 + 1 ] = pColorMap[ color + 1 ];
+        pDst[ i * 4 + 2 ] = pColorMap[ color + 0 ];
+        pDst[ i * 4 + 3 ] = 255;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      X1R5G5B5をRGBAに変換します.
+//-------------------------------------------------------------------------------------------------
+void ConvertX1R5G5B5ToRGBA( const uint8_t* pSrc, uint32_t count, uint8_t* pDst )
+{
+    for( uint32_t i=0; i<count; ++i )
+    {
+        uint16_t color = uint16_t( pSrc[ i * 2 + 0 ] | ( pSrc[ i * 2 + 1 ] << 8 ) );
+        pDst[ i * 4 + 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
+        pDst[ i * 4 + 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
+        pDst[ i * 4 + 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
+        pDst[ i * 4 + 3 ] = 255;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      BGRをRGBAに変換します.
+//!
+//! @note       ループ内を32bit演算のみにしてコンパイラのSIMD化を効かせます.
+//-------------------------------------------------------------------------------------------------
+void ConvertBGRToRGBA( const uint8_t* pSrc, uint32_t count, uint8_t* pDst )
+{
+    for( uint32_t i=0; i<count; ++i )
+    {
+        uint32_t color = 0xFF000000
+                       | ( uint32_t( pSrc[ i * 3 + 0 ] ) << 16 )
+                       | ( uint32_t( pSrc[ i * 3 + 1 ] ) <<  8 )
+                       | ( uint32_t( pSrc[ i * 3 + 2 ] ) <<  0 );
+        memcpy( pDst + i * 4, &color, sizeof(color) );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      BGRAをRGBAに変換します.
+//!
+//! @note       ループ内を32bit演算のみにしてコンパイラのSIMD化を効かせます.
+//-------------------------------------------------------------------------------------------------
+void ConvertBGRAToRGBA( const uint8_t* pSrc, uint32_t count, uint8_t* pDst )
+{
+    for( uint32_t i=0; i<count; ++i )
+    {
+        uint32_t color;
+        memcpy( &color, pSrc + i * 4, sizeof(color) );
+        color = ( color & 0xFF00FF00 ) | ( ( color >> 16 ) & 0xFF ) | ( ( color & 0xFF ) << 16 );
+        memcpy( pDst + i * 4, &color, sizeof(color) );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      RLE圧縮データを展開します.
+//!
+//! @param[in]      pSrc        圧縮データです.
+//! @param[in]      srcSize     圧縮データのサイズです.
+//! @param[in]      pixelCount  展開するピクセル数です.
+//! @param[out]     pDst        展開先です.
+//! @param[in]      convert     連続するピクセルを変換する関数です.
+//! @retval true    展開に成功.
+//! @retval false   データが不足しています.
+//-------------------------------------------------------------------------------------------------
+template<uint32_t SrcStride, uint32_t DstStride, typename Converter>
+bool DecodeRLE( const uint8_t* pSrc, size_t srcSize, uint32_t pixelCount, uint8_t* pDst, Converter convert )
+{
+    auto pEnd = pSrc + srcSize;
+    uint32_t  idx  = 0;
+
+    while( idx < pixelCount )
+    {
+        if ( pSrc >= pEnd )
+        { return false; }
+
+        auto header = *pSrc++;
+        auto count  = 1u + ( header & 0x7F );
+        if ( count > pixelCount - idx )
+        { count = pixelCount - idx; }
+
+        auto ptr = pDst + idx * DstStride;
+
+        if ( header & 0x80 )
+        {
+            if ( size_t( pEnd - pSrc ) < SrcStride )
+            { return false; }
+
+            // 1ピクセル分だけ変換して複製する.
+            convert( pSrc, 1, ptr );
+            for( uint32_t i=1; i<count; ++i )
+            { memcpy( ptr + i * DstStride, ptr, DstStride ); }
+
+            pSrc += SrcStride;
+        }
+        else
+        {
+            if ( size_t( pEnd - pSrc ) < size_t( count ) * SrcStride )
+            { return false; }
+
+            // 非圧縮パケットはまとめて変換する.
+            convert( pSrc, count, ptr );
+
+            pSrc += count * SrcStride;
+        }
+
+        idx += count;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      無変換でコピーします.
+//-------------------------------------------------------------------------------------------------
+template<uint32_t Stride>
+void CopyPixels( const uint8_t* pSrc, uint32_t count, uint8_t* pDst )
+{ memcpy( pDst, pSrc, count * Stride ); }
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      8Bitインデックスカラー形式を解析します.
+//!
+//! @param[in]      pColorMap       カラーマップです.
+//-------------------------------------------------------------------------------------------------
+bool Parse8Bits( const uint8_t* pSrc, size_t srcSize, uint32_t size, const uint8_t* pColorMap, uint8_t* pPixels )
+{
+    if ( srcSize < size )
+    { return false; }
+
+    ConvertIndexToRGBA( pSrc, size, pColorMap, pPixels );
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      16Bitフルカラー形式を解析します.
+//-------------------------------------------------------------------------------------------------
+bool Parse16Bits( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{
+    if ( srcSize < size_t( size ) * 2 )
+    { return false; }
+
+    ConvertX1R5G5B5ToRGBA( pSrc, size, pPixels );
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      24Bitフルカラー形式を解析します.
+//-------------------------------------------------------------------------------------------------
+bool Parse24Bits( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{
+    if ( srcSize < size_t( size ) * 3 )
+    { return false; }
+
+    ConvertBGRToRGBA( pSrc, size, pPixels );
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      32Bitフルカラー形式を解析します.
+//-------------------------------------------------------------------------------------------------
+bool Parse32Bits( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{
+    if ( srcSize < size_t( size ) * 4 )
+    { return false; }
+
+    ConvertBGRAToRGBA( pSrc, size, pPixels );
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief     8Bitグレースケール形式を解析します.
+//-------------------------------------------------------------------------------------------------
+bool Parse8BitsGrayScale( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{
+    if ( srcSize < size )
+    { return false; }
+
+    CopyPixels<1>( pSrc, size, pPixels );
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      16Bitグレースケール形式を解析します.
+//-------------------------------------------------------------------------------------------------
+bool Parse16BitsGrayScale( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{
+    if ( srcSize < size_t( size ) * 2 )
+    { return false; }
+
+    CopyPixels<2>( pSrc, size, pPixels );
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      8BitRLE圧縮インデックスカラー形式を解析します.
+//!
+//! @param[in]  pColorMap       カラーマップです.
+//-------------------------------------------------------------------------------------------------
+bool Parse8BitsRLE( const uint8_t* pSrc, size_t srcSize, const uint8_t* pColorMap, uint32_t size, uint8_t* pPixels )
+{
+    return DecodeRLE<1, 4>( pSrc, srcSize, size, pPixels,
+        [pColorMap]( const uint8_t* pIn, uint32_t count, uint8_t* pOut )
+        { ConvertIndexToRGBA( pIn, count, pColorMap, pOut ); } );
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      16BitRLE圧縮フルカラー形式を解析します.
+//-------------------------------------------------------------------------------------------------
+bool Parse16BitsRLE( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{ return DecodeRLE<2, 4>( pSrc, srcSize, size, pPixels, ConvertX1R5G5B5ToRGBA ); }
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      24BitRLE圧縮フルカラー形式を解析します.
+//-------------------------------------------------------------------------------------------------
+bool Parse24BitsRLE( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{ return DecodeRLE<3, 4>( pSrc, srcSize, size, pPixels, ConvertBGRToRGBA ); }
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      32BitRLE圧縮フルカラー形式を解析します.
+//-------------------------------------------------------------------------------------------------
+bool Parse32BitsRLE( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{ return DecodeRLE<4, 4>( pSrc, srcSize, size, pPixels, ConvertBGRAToRGBA ); }
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      8BitRLE圧縮グレースケール形式を解析します.
+//-------------------------------------------------------------------------------------------------
+bool Parse8BitsGrayScaleRLE( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{ return DecodeRLE<1, 1>( pSrc, srcSize, size, pPixels, CopyPixels<1> ); }
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      16BitRLE圧縮グレースケール形式を解析します.
+//-------------------------------------------------------------------------------------------------
+bool Parse16BitsGrayScaleRLE( const uint8_t* pSrc, size_t srcSize, uint32_t size, uint8_t* pPixels )
+{ return DecodeRLE<2, 2>( pSrc, srcSize, size, pPixels, CopyPixels<2> ); }
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      範囲を分割して並列に処理します.
+//!
+//! @param[in]      count       処理する要素数です.
+//! @param[in]      grain       1スレッドあたりの最小要素数です.
+//! @param[in]      func        [begin, end) を処理する関数です.
+//-------------------------------------------------------------------------------------------------
+template<typename Func>
+void ParallelFor( uint32_t count, uint32_t grain, Func func )
+{
+    auto threadCount = std::thread::hardware_concurrency();
+    threadCount = asdx::Min( threadCount, ( count + grain - 1 ) / grain );
+
+    if ( threadCount <= 1 )
+    {
+        func( 0, count );
+        return;
+    }
+
+    auto chunk = ( count + threadCount - 1 ) / threadCount;
+
+    std::vector<std::thread> threads;
+    threads.reserve( threadCount - 1 );
+
+    for( auto i=1u; i<threadCount; ++i )
+    {
+        auto begin = i * chunk;
+        auto end   = asdx::Min( begin + chunk, count );
+        if ( begin >= end )
+        { break; }
+
+        threads.emplace_back( func, begin, end );
+    }
+
+    // 先頭のチャンクは呼び出しスレッドで処理する.
+    func( 0, asdx::Min( chunk, count ) );
+
+    for( auto& itr : threads )
+    { itr.join(); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      RGBEの指数部に対応するスケールテーブルを取得します.
+//-------------------------------------------------------------------------------------------------
+const float* GetRGBEScaleTable()
+{
+    static const auto table = []()
+    {
+        std::array<float, 256> result = {};
+        for( auto i=1; i<256; ++i )
+        { result[i] = static_cast<float>( ldexp( 1.0, i - (128+8) ) ); }
+        return result;
+    }();
+
+    return table.data();
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      RGBE形式のスキャンラインをRGBA32F形式に変換します.
+//-------------------------------------------------------------------------------------------------
+void ConvertRGBEToFloat4( const RGBE* pSrc, int32_t count, float* pDst )
+{
+    auto pScale = GetRGBEScaleTable();
+    for( auto i=0; i<count; ++i )
+    {
+        auto f = pScale[ pSrc[i].e ];
+        pDst[ i * 4 + 0 ] = pSrc[i].r * f;
+        pDst[ i * 4 + 1 ] = pSrc[i].g * f;
+        pDst[ i * 4 + 2 ] = pSrc[i].b * f;
+        pDst[ i * 4 + 3 ] = 1.0f;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+//      HDRファイルのヘッダを読み込みします.
+//------------------------------------------------------------------------------------------
+bool ReadHdrHeader( FILE* pFile, int32_t& width, int32_t& height, float& gamma, float& exposure )
+{
+    char buf[ 256 ];
+    fread( buf, sizeof(char), 2, pFile );
+
+    if ( buf[0] != '#' || buf[1] != '?' )
+    { return false; }
+
+    auto valid = false;
+    for( ;; )
+    {
+        if ( fgets( buf, 256, pFile ) == nullptr )
+        { break; }
+
+        if ( buf[0] == '\n' )
+        { break; }
+        else if ( buf[0] == '#' )
+        { continue; }
+        else
+        {
+            auto g = 1.0f;
+            auto e = 1.0f;
+            if ( sscanf( buf, "GAMMA=%f\n", &g ) != 0 ) 
+            { gamma = g; }
+            else if ( sscanf( buf, "EXPOSURE=%f\n", &e ) != 0 )
+            { exposure = e; }
+            else if ( strcmp( buf, "FORMAT=32-bit_rle_rgbe\n" ) == 0 )
+            { valid = true; }
+        }
+    }
+
+    if ( !valid )
+    { return false; }
+
+    if ( fgets( buf, 256, pFile ) != nullptr )
+    {
+        auto w = 0;
+        auto h = 0;
+        if ( sscanf( buf, "-Y %d +X %d\n", &h, &w ) != 0 )
+        {
+            width = w;
+            height = h;
+        }
+        else if ( sscanf( buf, "+X %d -Y %d\n", &w, &h ) != 0 )
+        {
+            width = w;
+            height = h;
+        }
+        else
+        { return false; }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+//      旧形式のカラーを読み取ります.
+//------------------------------------------------------------------------------------------
+bool ReadOldColors( const uint8_t*& pSrc, const uint8_t* pEnd, const RGBE* pHead, RGBE* pLine, int32_t count )
+{
+    auto shift = 0;
+    while( 0 < count )
+    {
+        if ( pEnd - pSrc < 4 )
+            return false;
+
+        pLine[0].r = pSrc[0];
+        pLine[0].g = pSrc[1];
+        pLine[0].b = pSrc[2];
+        pLine[0].e = pSrc[3];
+        pSrc += 4;
+
+        if ( pLine[0].r == 1
+          && pLine[0].g == 1
+          && pLine[0].b == 1 )
+        {
+            // 繰り返す元のピクセルが無い.
+            if ( pLine == pHead )
+                return false;
+
+            for( auto i=pLine[0].e << shift; i > 0 && 0 < count; i-- )
+            {
+                pLine[0].r = pLine[-1].r;
+                pLine[0].g = pLine[-1].g;
+                pLine[0].b = pLine[-1].b;
+                pLine[0].e = pLine[-1].e;
+                pLine++;
+                count--;
+            }
+            shift += 8;
+        }
+        else
+        {
+            pLine++;
+            count--;
+            shift = 0;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+//      カラーを読み取ります.
+//------------------------------------------------------------------------------------------
+bool ReadColor( const uint8_t*& pSrc, const uint8_t* pEnd, const RGBE* pHead, RGBE* pLine, int32_t count )
+{
+    if ( count < 8 || 0x7fff < count )
+    { return ReadOldColors( pSrc, pEnd, pHead, pLine, count ); }
+
+    if ( pEnd - pSrc < 4 )
+        return false;
+
+    // 新形式のRLEでなければ旧形式として読み取る.
+    if ( pSrc[0] != 2 || pSrc[1] != 2 || pSrc[2] & 128 )
+    { return ReadOldColors( pSrc, pEnd, pHead, pLine, count ); }
+
+    if ( ( pSrc[2] << 8 | pSrc[3] ) != count )
+        return false;
+
+    pSrc += 4;
+
+    for( auto i=0; i<4; ++i )
+    {
+        for( auto j=0; j<count; )
+        {
+            if ( pSrc >= pEnd )
+                return false;
+
+            int32_t code = *pSrc++;
+            if ( 128 < code )
+            {
+                code &= 127;
+                if ( pSrc >= pEnd || count - j < code )
+                    return false;
+
+                auto val = *pSrc++;
+                while( code-- )
+                { pLine[j++].v[i] = val; }
+            }
+            else
+            {
+                if ( code == 0 || pEnd - pSrc < code || count - j < code )
+                    return false;
+
+                while( code-- )
+                { pLine[j++].v[i] = *pSrc++; }
+            }
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+//      HDRデータを読み取ります.
+//------------------------------------------------------------------------------------------
+bool ReadHdrData( FILE* pFile, const int32_t width, const int32_t height, float** ppPixels )
+{
+    // 残りのデータをがばっと読み込む.
+    std::vector<uint8_t> buffer;
+    if ( !ReadToEnd( pFile, buffer ) )
+    { return false; }
+
+    auto pLines = new(std::nothrow) RGBE [ width * height ];
+    if ( pLines == nullptr )
+    { return false; }
+
+    // RLEの展開はスキャンライン間で依存があるので逐次処理.
+    const uint8_t* pSrc = buffer.data();
+    const uint8_t* pEnd = pSrc + buffer.size();
+    for( auto y=0; y<height; ++y )
+    {
+        if ( !ReadColor( pSrc, pEnd, pLines, pLines + y * width, width ) )
+        {
+            asdx::SafeDeleteArray( pLines );
+            return false;
+        }
+    }
+
+    auto pixels = new (std::nothrow) float [ width * height * 4 ];
+    if ( pixels == nullptr )
+    {
+        asdx::SafeDeleteArray( pLines );
+        return false;
+    }
+
+    // 浮動小数への変換はスキャンライン単位で並列処理.
+    ParallelFor( uint32_t(height), 64, [&]( uint32_t begin, uint32_t end )
+    {
+        for( auto y=begin; y<end; ++y )
+        { ConvertRGBEToFloat4( pLines + y * width, width, pixels + y * width * 4 ); }
+    });
+
+    asdx::SafeDeleteArray( pLines );
+    (*ppPixels) = pixels;
+
+    return true;
+}
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-------------------------------------------------------------------------------------------------
+//      Targaファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromTGAFile(FILE* pFile, asdx::ResTexture& resTexture)
+{
+    // フッターを読み込み.
+    TGA_FOOTER footer;
+    long offset = sizeof(footer);
+    fseek( pFile, -offset, SEEK_END );
+    fread( &footer, sizeof(footer), 1, pFile );
+
+    // ファイルマジックをチェック.
+    if ( strcmp( footer.Tag, "TRUEVISION-XFILE." ) != 0 )
+    {
+        ELOG( "Error : Invalid File Format." );
+        return false;
+    }
+
+    // 拡張データがある場合は読み込み.
+    if ( footer.OffsetExt != 0 )
+    {
+        TGA_EXTENSION extension;
+
+        fseek( pFile, footer.OffsetExt, SEEK_SET );
+        fread( &extension, sizeof(extension), 1, pFile );
+    }
+
+    // ディベロッパーエリアがある場合.
+    if ( footer.OffsetDev != 0 )
+    {
+        /* NOT IMPLEMENT */
+    }
+
+    // ファイル先頭に戻す.
+    fseek( pFile, 0, SEEK_SET );
+
+    // ヘッダデータを読み込む.
+    TGA_HEADER header;
+    fread( &header, sizeof(header), 1, pFile );
+
+    // フォーマット判定.
+    uint32_t bytePerPixel = 0;
+    switch( header.Format )
+    {
+    // 該当なし.
+    case TGA_FORMAT_NONE:
+        {
+            ELOG( "Error : Invalid Format." );
+            return false;
+        }
+        break;
+
+    // グレースケール
+    case TGA_FORMAT_GRAYSCALE:
+    case TGA_FORMAT_RLE_GRAYSCALE:
+        { 
+            if ( header.BitPerPixel == 8 )
+            { bytePerPixel = 1; }
+            else
+            { bytePerPixel = 2; }
+        }
+        break;
+
+    // カラー.
+    case TGA_FORMAT_INDEXCOLOR:
+    case TGA_FORMAT_FULLCOLOR:
+    case TGA_FORMAT_RLE_INDEXCOLOR:
+    case TGA_FORMAT_RLE_FULLCOLOR:
+        {
+            if ( header.BitPerPixel <= 24 )
+            { bytePerPixel = 3; }
+            else
+            { bytePerPixel = 4; }
+        }
+        break;
+
+    // 上記以外.
+    default:
+        {
+            ELOG( "Error : Unsupported Format." );
+            return false;
+        }
+        break;
+    }
+
+    // IDフィールドサイズ分だけオフセットを移動させる.
+    if (header.IdFieldLength != 0)
+    {
+        fseek(pFile, header.IdFieldLength, SEEK_CUR);
+    }
+
+    // RGBのみはテクスチャがサポートされないので，強制的にRGBAにする.
+    auto bpp = (bytePerPixel == 3) ? 4 : bytePerPixel;
+
+    // ピクセルサイズを決定してメモリを確保.
+    auto size = header.Width * header.Height * bpp;
+    auto pPixels = new (std::nothrow) uint8_t [ size ];
+    if ( pPixels == nullptr )
+    {
+        ELOG( "Error : Out Of Memory." );
+        return false;
+    }
+
+    // カラーマップを持つかチェック.
+    uint8_t* pColorMap = nullptr;
+    if ( header.HasColorMap )
+    {
+        // カラーマップサイズを算出.
+        uint32_t colorMapSize = header.ColorMapEntry * ( header.ColorMapEntrySize >> 3 );
+
+        // メモリを確保.
+        pColorMap = new (std::nothrow) uint8_t [ colorMapSize ];
+        if ( pColorMap == nullptr )
+        {
+            ELOG( "Error : Out Of Memory." );
+            delete[] pPixels;
+            pPixels = nullptr;
+            return false;
+        }
+
+        // がばっと読み込む.
+        fread( pColorMap, sizeof(uint8_t), colorMapSize, pFile );
+    }
+
+    // 幅・高さ・ビットの深さ・ハッシュキーを設定.
+    auto width       = header.Width;
+    auto height      = header.Height;
+    auto format      = static_cast<TGA_FORMAT_TYPE>( header.Format );
+   
+    // ピクセルデータをがばっと読み込む.
+    std::vector<uint8_t> buffer;
+    if ( !ReadToEnd( pFile, buffer ) )
+    {
+        ELOG( "Error : File Read Failed." );
+        SafeDeleteArray( pColorMap );
+        SafeDeleteArray( pPixels );
+        return false;
+    }
+
+    auto pSrc    = buffer.data();
+    auto srcSize = buffer.size();
+    auto count   = uint32_t( width ) * height;
+    auto ret     = false;
+
+    // フォーマットに合わせてピクセルデータを解析する.
+    switch( header.Format )
+    {
+    // パレット.
+    case TGA_FORMAT_INDEXCOLOR:
+        { ret = Parse8Bits( pSrc, srcSize, count, pColorMap, pPixels ); }
+        break;
+
+    // フルカラー.
+    case TGA_FORMAT_FULLCOLOR:
+        {
+            switch( header.BitPerPixel )
+            {
+            case 16:
+                { ret = Parse16Bits( pSrc, srcSize, count, pPixels ); }
+                break;
+
+            case 24:
+                { ret = Parse24Bits( pSrc, srcSize, count, pPixels ); }
+                break;
+
+            case 32:
+                { ret = Parse32Bits( pSrc, srcSize, count, pPixels ); }
+                break;
+            }
+        }
+        break;
+
+    // グレースケール.
+    case TGA_FORMAT_GRAYSCALE:
+        {
+            if ( header.BitPerPixel == 8 )
+            { ret = Parse8BitsGrayScale( pSrc, srcSize, count, pPixels ); }
+            else
+            { ret = Parse16BitsGrayScale( pSrc, srcSize, count, pPixels ); }
+        }
+        break;
+
+    // パレットRLE圧縮.
+    case TGA_FORMAT_RLE_INDEXCOLOR:
+        { ret = Parse8BitsRLE( pSrc, srcSize, pColorMap, count, pPixels ); }
+        break;
+
+    // フルカラーRLE圧縮.
+    case TGA_FORMAT_RLE_FULLCOLOR:
+        {
+            switch( header.BitPerPixel )
+            {
+            case 16:
+                { ret = Parse16BitsRLE( pSrc, srcSize, count, pPixels ); }
+                break;
+
+            case 24:
+                { ret = Parse24BitsRLE( pSrc, srcSize, count, pPixels ); }
+                break;
+
+            case 32:
+                { ret = Parse32BitsRLE( pSrc, srcSize, count, pPixels ); }
+                break;
+            }
+        }
+        break;
+
+    // グレースケールRLE圧縮.
+    case TGA_FORMAT_RLE_GRAYSCALE:
+        {
+            if ( header.BitPerPixel == 8 )
+            { ret = Parse8BitsGrayScaleRLE( pSrc, srcSize, count, pPixels ); }
+            else
+            { ret = Parse16BitsGrayScaleRLE( pSrc, srcSize, count, pPixels ); }
+        }
+        break;
+    }
+
+    // 不要なメモリを解放.
+    SafeDeleteArray( pColorMap );
+
+    // ピクセルデータが不足している場合.
+    if ( !ret )
+    {
+        ELOG( "Error : Invalid Pixel Data." );
+        SafeDeleteArray( pPixels );
+        return false;
+    }
+
+    auto surface = new SubResource();
+    if (surface == nullptr)
+    {
+        ELOG("Error : Out of Memory.");
+        return false;
+    }
+
+    surface->Width      = width;
+    surface->Height     = height;
+    surface->MipIndex   = 0;
+    surface->Pitch      = width * bpp;
+    surface->SlicePitch = width * height * bpp;
+    surface->pPixels    = pPixels;
+
+    resTexture.Dimension    = TEXTURE_DIMENSION_2D;
+    resTexture.Width        = width;
+    resTexture.Height       = height;
+    resTexture.Depth        = 1;
+    resTexture.SurfaceCount = 1;
+    resTexture.MipMapCount  = 1;
+    resTexture.pResources   = surface;
+
+    switch(format)
+    {
+    case TGA_FORMAT_NONE:
+        resTexture.Format = FORMAT_UNKNOWN;
+        break;
+
+    case TGA_FORMAT_FULLCOLOR:
+        resTexture.Format = FORMAT_R8G8B8A8_UNORM;
+        break;
+
+    case TGA_FORMAT_GRAYSCALE:
+        resTexture.Format = FORMAT_R8_UNORM;
+        break;
+
+    case TGA_FORMAT_RLE_FULLCOLOR:
+        resTexture.Format = FORMAT_R8G8B8A8_UNORM;
+        break;
+
+    case TGA_FORMAT_RLE_GRAYSCALE:
+        resTexture.Format = FORMAT_R8_UNORM;
+        break;
+
+    case TGA_FORMAT_INDEXCOLOR:
+    case TGA_FORMAT_RLE_INDEXCOLOR:
+        {
+            switch (bytePerPixel)
+            {
+            case 1:
+                { resTexture.Format = FORMAT_R8_UNORM; }
+                break;
+
+            case 2:
+                { resTexture.Format = FORMAT_B5G5R5A1_UNORM; }
+                break;
+
+            default:
+                {
+                    ELOG("Error : Unknown Format. bytePerPixel = %u", bytePerPixel );
+                    assert(false);
+                    return false;
+                }
+            }
+        }
+        break;
+    }
+
+    // 正常終了.
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+//      HDRファイルからリソーステクスチャを生成します.
+//------------------------------------------------------------------------------------------
+bool CreateResTextureFromHDRFile(FILE* pFile, asdx::ResTexture& resTexture)
+{
+    int32_t width    = 0;
+    int32_t height   = 0;
+    float   gamma    = 1.0f;
+    float   exposure = 1.0f;
+    if ( !ReadHdrHeader(pFile, width, height, gamma, exposure) )
+    {
+        ELOG( "Error : LoadFromHDR() Failed. Header Read Failed." );
+        return false;
+    }
+
+    resTexture.Dimension    = TEXTURE_DIMENSION_2D;
+    resTexture.Width        = uint32_t(width);
+    resTexture.Height       = uint32_t(height);
+    resTexture.Depth        = 0;
+    resTexture.Format       = FORMAT_R32G32B32A32_FLOAT;
+    resTexture.MipMapCount  = 1;
+    resTexture.SurfaceCount = 1;
+    resTexture.pResources   = new SubResource[1];
+
+    resTexture.pResources[0].Width      = uint32_t(width);
+    resTexture.pResources[0].Height     = uint32_t(height);
+    resTexture.pResources[0].Pitch      = width * sizeof(float) * 4;
+    resTexture.pResources[0].SlicePitch = resTexture.pResources[0].Pitch * height;
+
+    if ( !ReadHdrData(pFile, width, height, reinterpret_cast<float**>(&resTexture.pResources[0].pPixels)) )
+    {
+        ELOG( "Error : LoadFromHDR() Failed. Data Read Failed." );
+        resTexture.Dispose();
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace asdx
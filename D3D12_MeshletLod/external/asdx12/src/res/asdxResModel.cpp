@@ -9,41 +9,149 @@
 //-----------------------------------------------------------------------------
 #include <res/asdxResModel.h>
 #include <fnd/asdxLogger.h>
-#include <fnd/asdxMisc.h>
-#include <fstream>
+#include <fnd/asdxTokenizer.h>
+#include <fnd/asdxMappedFile.h>
 #include <algorithm>
-#include <tuple>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
 #include <map>
 
+#ifdef _WIN32
+#include <fnd/asdxMisc.h>
+#endif//_WIN32
+
 
 namespace {
 
 ///////////////////////////////////////////////////////////////////////////////
-// SubsetOBJ structure
+// RunOBJ structure
 ///////////////////////////////////////////////////////////////////////////////
-struct SubsetOBJ 
+struct RunOBJ
 {
-    std::string     MeshName;                   //!< メッシュ名.
+    asdx::TokenView Material;                   //!< usemtl で指定されたマテリアル名.
     uint32_t        MaterialId  = UINT32_MAX;   //!< マテリアルID.
-    uint32_t        IndexStart  = 0;            //!< 開始頂点インデックス.
-    uint32_t        IndexCount  = 0;            //!< 頂点インデックス数.
+    uint32_t        TriangleCount = 0;          //!< 三角形数.
+    uint32_t        MeshIndex   = 0;            //!< 出力先メッシュ番号.
+    uint32_t        VertexStart = 0;            //!< 出力先メッシュ内の開始頂点番号.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
-// IndexOBJ structure
+// CornerOBJ structure
 ///////////////////////////////////////////////////////////////////////////////
-struct IndexOBJ
+struct CornerOBJ
 {
-    uint32_t    P;      //!< 位置.
-    uint32_t    N;      //!< 法線.
-    uint32_t    U;      //!< テクスチャ座標.
+    int32_t     P = 0;      //!< 位置(1始まり, 負数は相対).
+    int32_t     T = 0;      //!< テクスチャ座標(0 は省略).
+    int32_t     N = 0;      //!< 法線(0 は省略).
 };
 
+//-----------------------------------------------------------------------------
+//      ファイルパスからディレクトリパスを取得します.
+//-----------------------------------------------------------------------------
+std::string GetDirectoryPath(const char* filePath)
+{
+    std::string path = filePath;
+    auto idx = path.find_last_of("/\\");
+    if (idx == std::string::npos)
+    { return std::string(); }
+
+    return path.substr(0, idx + 1);
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルパスから小文字の拡張子を取得します.
+//-----------------------------------------------------------------------------
+std::string GetExt(const char* filePath)
+{
+    std::string path = filePath;
+    auto idx = path.find_last_of('.');
+    if (idx == std::string::npos)
+    { return std::string(); }
+
+    auto result = path.substr(idx + 1);
+    for(auto& c : result)
+    { c = char(tolower(static_cast<unsigned char>(c))); }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      ワイド文字列のファイルパスをマルチバイト文字列に変換します.
+//-----------------------------------------------------------------------------
+std::string ToMultiByte(const wchar_t* filePath)
+{
+#ifdef _WIN32
+    return asdx::ToStringA(filePath);
+#else
+    // asdxMisc は Windows 専用なので, ロケールに従って変換する.
+    auto src    = filePath;
+    auto state  = std::mbstate_t();
+    auto length = wcsrtombs(nullptr, &src, 0, &state);
+    if (length == size_t(-1))
+    { return std::string(); }
+
+    std::string result(length, '\0');
+    src   = filePath;
+    state = std::mbstate_t();
+    wcsrtombs(&result[0], &src, length, &state);
+    return result;
+#endif//_WIN32
+}
+
+//-----------------------------------------------------------------------------
+//      面の頂点指定 (v, v/vt, v//vn, v/vt/vn) を解析します.
+//-----------------------------------------------------------------------------
+bool ParseCorner(const asdx::TokenView& token, CornerOBJ& corner)
+{
+    auto end = token.end();
+    corner = CornerOBJ();
+
+    auto ret = asdx::FromChars(token.data(), end, corner.P);
+    if (!ret.Success || corner.P == 0)
+    { return false; }
+
+    if (ret.Ptr < end && *ret.Ptr == '/')
+    {
+        auto ptr = ret.Ptr + 1;
+        if (ptr < end && *ptr != '/')
+        {
+            ret = asdx::FromChars(ptr, end, corner.T);
+            if (!ret.Success)
+            { return false; }
+            ptr = ret.Ptr;
+        }
+
+        if (ptr < end && *ptr == '/')
+        {
+            ret = asdx::FromChars(ptr + 1, end, corner.N);
+            if (!ret.Success)
+            { return false; }
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      OBJ のインデックスを 0 始まりに変換します.
+//-----------------------------------------------------------------------------
+bool ResolveIndex(int32_t index, uint32_t count, uint32_t& result)
+{
+    auto value = (index > 0) ? int64_t(index) - 1 : int64_t(count) + index;
+    if (value < 0 || value >= int64_t(count))
+    { return false; }
+
+    result = uint32_t(value);
+    return true;
+}
 
 //-----------------------------------------------------------------------------
 //      法線ベクトルを計算します.
+//      pMask を指定した場合は, 値が 0 でない頂点の法線だけを書き換えます.
 //-----------------------------------------------------------------------------
-void CalcNormals(asdx::ResMesh& mesh)
+void CalcNormals(asdx::ResMesh& mesh, const uint8_t* pMask = nullptr)
 {
     auto vertexCount = mesh.Positions.size();
     std::vector<asdx::Vector3> normals;
@@ -114,9 +222,12 @@ void CalcNormals(asdx::ResMesh& mesh)
         auto c2 = asdx::Vector3::Dot(normals[i2], fn);
 
         // スムージング処理.
-        mesh.Normals[i0] = (c0 >= cosSmooth) ? normals[i0] : fn;
-        mesh.Normals[i1] = (c1 >= cosSmooth) ? normals[i1] : fn;
-        mesh.Normals[i2] = (c2 >= cosSmooth) ? normals[i2] : fn;
+        if (pMask == nullptr || pMask[i0] != 0)
+        { mesh.Normals[i0] = (c0 >= cosSmooth) ? normals[i0] : fn; }
+        if (pMask == nullptr || pMask[i1] != 0)
+        { mesh.Normals[i1] = (c1 >= cosSmooth) ? normals[i1] : fn; }
+        if (pMask == nullptr || pMask[i2] != 0)
+        { mesh.Normals[i2] = (c2 >= cosSmooth) ? normals[i2] : fn; }
     }
 
     normals.clear();
@@ -202,6 +313,134 @@ void CalcTangents(asdx::ResMesh& resource)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// BinaryWriter class
+///////////////////////////////////////////////////////////////////////////////
+class BinaryWriter
+{
+public:
+    static const size_t ALIGNMENT = 16;     //!< ブロックの配置境界.
+
+    //-------------------------------------------------------------------------
+    //! @brief      ゼロ初期化した領域を確保します.
+    //!
+    //! @return     先頭からのオフセットを返却します. 要素数が 0 の場合は 0 です.
+    //-------------------------------------------------------------------------
+    template<typename T>
+    size_t Reserve(size_t count)
+    {
+        if (count == 0)
+        { return 0; }
+
+        auto offset = (m_Buffer.size() + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        m_Buffer.resize(offset + sizeof(T) * count, 0);
+        return offset;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      データを書き込みます.
+    //!
+    //! @return     先頭からのオフセットを返却します. 要素数が 0 の場合は 0 です.
+    //-------------------------------------------------------------------------
+    template<typename T>
+    size_t Write(const T* data, size_t count)
+    {
+        auto offset = Reserve<T>(count);
+        if (count > 0)
+        { memcpy(m_Buffer.data() + offset, data, sizeof(T) * count); }
+        return offset;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      オフセット位置のデータを取得します.
+    //!
+    //! @note       以降の Reserve() / Write() で無効になります.
+    //-------------------------------------------------------------------------
+    template<typename T>
+    T* At(size_t offset)
+    { return reinterpret_cast<T*>(m_Buffer.data() + offset); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      配列の参照先を設定します.
+    //-------------------------------------------------------------------------
+    template<typename T>
+    void Link(asdx::BinaryArrary<T>& array, size_t offset, size_t count)
+    { array.SetData((count > 0) ? At<T>(offset) : nullptr, uint32_t(count)); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      書き込んだバッファを取得します.
+    //-------------------------------------------------------------------------
+    const std::vector<uint8_t>& GetBuffer() const
+    { return m_Buffer; }
+
+private:
+    std::vector<uint8_t>    m_Buffer;   //!< 書き込みバッファ.
+};
+
+//-----------------------------------------------------------------------------
+//      終端文字を含む文字列が範囲内に収まっているかチェックします.
+//-----------------------------------------------------------------------------
+bool IsValidString(const asdx::BinaryArrary<char>& value, const void* begin, const void* end)
+{
+    return value.IsInRange(begin, end)
+        && value.size() > 0
+        && value[value.size() - 1] == '\0';
+}
+
+//-----------------------------------------------------------------------------
+//      頂点ストリームの要素数が正しいかチェックします.
+//-----------------------------------------------------------------------------
+template<typename T>
+bool IsValidStream(const asdx::BinaryArrary<T>& value, const void* begin, const void* end, uint32_t count)
+{
+    return value.IsInRange(begin, end)
+        && (value.empty() || value.size() == count);
+}
+
+//-----------------------------------------------------------------------------
+//      マップしたメッシュを検証します.
+//-----------------------------------------------------------------------------
+bool IsValidMesh(const asdx::ResMeshBinary& mesh, const void* begin, const void* end)
+{
+    if (!IsValidString(mesh.Name, begin, end))
+    { return false; }
+
+    if (!mesh.Positions.IsInRange(begin, end))
+    { return false; }
+
+    auto vertexCount = mesh.Positions.size();
+    if (!IsValidStream(mesh.Normals,  begin, end, vertexCount)
+     || !IsValidStream(mesh.Tangents, begin, end, vertexCount)
+     || !IsValidStream(mesh.Colors,   begin, end, vertexCount))
+    { return false; }
+
+    for(auto i=0u; i<asdx::ResMesh::MAX_TEXCOORD_LAYERS; ++i)
+    {
+        if (!IsValidStream(mesh.TexCoords[i], begin, end, vertexCount))
+        { return false; }
+    }
+
+    auto boneCount = uint64_t(vertexCount) * mesh.BoneInfluenceCount;
+    if (!mesh.BoneIndices.IsInRange(begin, end)
+     || !mesh.BoneWeights.IsInRange(begin, end)
+     || (!mesh.BoneIndices.empty() && uint64_t(mesh.BoneIndices.size()) != boneCount)
+     || (!mesh.BoneWeights.empty() && uint64_t(mesh.BoneWeights.size()) != boneCount))
+    { return false; }
+
+    if (!mesh.VertexIndices.IsInRange(begin, end))
+    { return false; }
+
+    // 頂点番号はそのまま配列の添え字に使われるので範囲外を許さない.
+    for(auto index : mesh.VertexIndices)
+    {
+        if (index >= vertexCount)
+        { return false; }
+    }
+
+    return true;
+}
+
+
 } // namespace
 
 namespace asdx {
@@ -211,101 +450,25 @@ namespace asdx {
 //-----------------------------------------------------------------------------
 bool LoadFromMTL(const char* path, ResModel& model)
 {
-    std::ifstream stream;
-
-    stream.open(path, std::ios::in);
-
-    if (!stream.is_open())
+    MappedFile file;
+    if (!file.Open(path))
     {
         ELOGA("Error : File Open Failed. path = %s", path);
         return false;
     }
 
-    const uint32_t BUFFER_LENGTH = 2048;
-    char buf[BUFFER_LENGTH] = {};
-    //int32_t index = -1;
+    ViewTokenizer tokenizer;
+    tokenizer.SetBuffer(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
 
-    for(;;)
+    // 現状はマテリアル名のみ使用する.
+    while(tokenizer.Next())
     {
-        stream >> buf;
-
-        if (!stream || stream.eof())
-            break;
-
-        if (0 == strcmp(buf, "newmtl"))
-        {
-            std::string name;
-            stream >> name;
-            model.Materials.push_back(name);
-            //index++;
-        }
-        else if (0 == strcmp(buf, "Ka"))
-        {
-            //stream >> model.Materials[index].Ka.x 
-            //       >> model.Materials[index].Ka.y
-            //       >> model.Materials[index].Ka.z;
-        }
-        else if (0 == strcmp(buf, "Kd"))
-        {
-            //stream >> model.Materials[index].Kd.x
-            //       >> model.Materials[index].Kd.y
-            //       >> model.Materials[index].Kd.z;
-        }
-        else if (0 == strcmp(buf, "Ks"))
-        {
-            //stream >> model.Materials[index].Ks.x
-            //       >> model.Materials[index].Ks.y
-            //       >> model.Materials[index].Ks.z;
-        }
-        else if (0 == strcmp(buf, "Ke"))
-        {
-            //stream >> model.Materials[index].Ke.x
-            //       >> model.Materials[index].Ke.y
-            //       >> model.Materials[index].Ke.z;
-        }
-        else if (0 == strcmp(buf, "d") || 0 == strcmp(buf, "Tr"))
-        {
-            //stream >> model.Materials[index].Tr;
-        }
-        else if (0 == strcmp(buf, "Ns"))
-        {
-            //stream >> model.Materials[index].Ns;
-        }
-        else if (0 == strcmp(buf, "map_Ka"))
-        {
-            //stream >> model.Materials[index].map_Ka;
-        }
-        else if (0 == strcmp(buf, "map_Kd"))
-        {
-            //stream >> model.Materials[index].map_Kd;
-        }
-        else if (0 == strcmp(buf, "map_Ks"))
-        {
-            //stream >> model.Materials[index].map_Ks;
-        }
-        else if (0 == strcmp(buf, "map_Ke"))
-        {
-            //stream >> model.Materials[index].map_Ke;
-        }
-        else if (0 == _stricmp(buf, "map_bump") || 0 == strcmp(buf, "bump"))
-        {
-            //stream >> model.Materials[index].map_bump;
-        }
-        else if (0 == strcmp(buf, "disp"))
-        {
-            //stream >> model.Materials[index].disp;
-        }
-        else if (0 == strcmp(buf, "norm"))
-        {
-            //stream >> model.Materials[index].norm;
-        }
+        if (tokenizer.Compare("newmtl") && tokenizer.NextInLine())
+        { model.Materials.push_back(tokenizer.GetToken().ToString()); }
 
-        stream.ignore(BUFFER_LENGTH, '\n');
+        tokenizer.SkipLine();
     }
 
-    // ファイルを閉じる.
-    stream.close();
-
     // メモリ最適化.
     model.Materials.shrink_to_fit();
 
@@ -316,299 +479,529 @@ bool LoadFromMTL(const char* path, ResModel& model)
 //-----------------------------------------------------------------------------
 //      OBJファイルからモデルをロードします.
 //-----------------------------------------------------------------------------
-bool LoadFromOBJ(std::ifstream& stream, const std::string& directory, ResModel& model)
+bool LoadFromOBJ(const char* path, const std::string& directory, ResModel& model)
 {
-    if (!stream.is_open())
+    MappedFile file;
+    if (!file.Open(path))
     {
-        ELOGA("Error : File Open Failed.");
+        ELOGA("Error : File Open Failed. path = %s", path);
         return false;
     }
 
-    const uint32_t BUFFER_LENGTH = 2048;
-    char buf[BUFFER_LENGTH] = {};
-    std::string group;
+    ViewTokenizer tokenizer;
 
-    uint32_t faceIndex = 0;
-    uint32_t faceCount = 0;
+    uint32_t positionCount = 0;
+    uint32_t texcoordCount = 0;
+    uint32_t normalCount   = 0;
 
-    std::vector<asdx::Vector3>      positions;
-    std::vector<asdx::Vector3>      normals;
-    std::vector<asdx::Vector2>      texcoords;
-    std::vector<IndexOBJ>           indices;
-    std::vector<SubsetOBJ>          subsets;
-    std::map<std::string, uint32_t> materials;
+    // usemtl で区切られた面の並び. 先頭は usemtl より前の面.
+    std::vector<RunOBJ> runs(1);
 
-    for(;;)
+    // 1パス目 : 要素数を数えて, マテリアルを読み込む.
+    tokenizer.SetBuffer(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
+    while(tokenizer.Next())
     {
-        stream >> buf;
-        if (!stream || stream.eof())
-            break;
-
-        if (0 == strcmp(buf, "#"))
+        if (tokenizer.Compare("v"))
         {
-            /* DO_NOTHING */
+            positionCount++;
         }
-        else if (0 == strcmp(buf, "v"))
+        else if (tokenizer.Compare("vt"))
         {
-            asdx::Vector3 v;
-            stream >> v.x >> v.y >> v.z;
-            positions.push_back(v);
+            texcoordCount++;
         }
-        else if (0 == strcmp(buf, "vt"))
+        else if (tokenizer.Compare("vn"))
         {
-            asdx::Vector2 vt;
-            stream >> vt.x >> vt.y;
-            texcoords.push_back(vt);
+            normalCount++;
         }
-        else if (0 == strcmp(buf, "vn"))
+        else if (tokenizer.Compare("f"))
         {
-            asdx::Vector3 vn;
-            stream >> vn.x >> vn.y >> vn.z;
-            normals.push_back(vn);
+            uint32_t cornerCount = 0;
+            while(tokenizer.NextInLine())
+            { cornerCount++; }
+
+            // 多角形は扇状に三角形分割する.
+            if (cornerCount >= 3)
+            { runs.back().TriangleCount += cornerCount - 2; }
         }
-        else if (0 == strcmp(buf, "g"))
+        else if (tokenizer.Compare("usemtl"))
         {
-            stream >> group;
+            RunOBJ run;
+            if (tokenizer.NextInLine())
+            { run.Material = tokenizer.GetToken(); }
+
+            runs.push_back(run);
         }
-        else if (0 == strcmp(buf, "f"))
+        else if (tokenizer.Compare("mtllib"))
         {
-            uint32_t ip, it, in;
-            uint32_t p[4] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
-            uint32_t t[4] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
-            uint32_t n[4] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
+            if (tokenizer.NextInLine())
+            {
+                // directory は区切り文字で終わる. カレントディレクトリの場合は空になる.
+                auto mtlPath = directory + tokenizer.GetToken().ToString();
+                if (!LoadFromMTL(mtlPath.c_str(), model))
+                {
+                    ELOGA("Error : Material Load Failed.");
+                    return false;
+                }
+            }
+        }
 
-            uint32_t count = 0;
-            uint32_t index = 0;
+        tokenizer.SkipLine();
+    }
 
-            faceIndex++;
-            faceCount++;
+    // 1パス目で読み込んだページを追い出して, 出力用の確保と同時に常駐しないようにする.
+    file.Evict(file.GetSize());
 
-            for(auto i=0; i<4; ++i)
-            {
-                count++;
+    // MaterialId検索マップ構築.
+    std::map<std::string, uint32_t> materials;
+    for(size_t i=0; i<model.Materials.size(); ++i)
+    { materials[model.Materials[i]] = uint32_t(i); }
 
-                // 位置座標インデックス.
-                stream >> ip;
-                p[i] = ip - 1;
+    // マテリアル毎に1メッシュとし, マテリアルID順に並べる.
+    std::vector<uint32_t> meshMaterials;
+    for(auto& run : runs)
+    {
+        if (!run.Material.empty())
+        {
+            auto itr = materials.find(run.Material.ToString());
+            if (itr != materials.end())
+            { run.MaterialId = itr->second; }
+        }
 
-                if ('/' == stream.peek())
-                {
-                    stream.ignore();
+        if (run.TriangleCount > 0)
+        { meshMaterials.push_back(run.MaterialId); }
+    }
 
-                    // テクスチャ座標インデックス.
-                    if ('/' != stream.peek())
-                    {
-                        stream >> it;
-                        t[i] = it - 1;
-                    }
+    std::sort(meshMaterials.begin(), meshMaterials.end());
+    meshMaterials.erase(std::unique(meshMaterials.begin(), meshMaterials.end()), meshMaterials.end());
 
-                    // 法線インデックス.
-                    if ('/' == stream.peek())
-                    {
-                        stream.ignore();
+    // 各面の並びの書き込み先を決める.
+    std::vector<uint32_t> vertexCounts(meshMaterials.size(), 0);
+    for(auto& run : runs)
+    {
+        if (run.TriangleCount == 0)
+        { continue; }
 
-                        stream >> in;
-                        n[i] = in - 1;
-                    }
-                }
+        auto index = std::lower_bound(meshMaterials.begin(), meshMaterials.end(), run.MaterialId) - meshMaterials.begin();
+        run.MeshIndex   = uint32_t(index);
+        run.VertexStart = vertexCounts[index];
+        vertexCounts[index] += run.TriangleCount * 3;
+    }
 
-                if (count <= 3)
-                {
-                    IndexOBJ f0 = { p[i], t[i], n[i] };
-                    indices.push_back(f0);
-                }
+    // 数えた要素数で1回だけ確保する.
+    std::vector<asdx::Vector3> positions(positionCount);
+    std::vector<asdx::Vector2> texcoords(texcoordCount);
+    std::vector<asdx::Vector3> normals  (normalCount);
 
-                if ('\n' == stream.peek() || '\r' == stream.peek())
-                    break;
-            }
+    // 法線が指定されなかった頂点の印. 必要になったメッシュだけ確保する.
+    std::vector<std::vector<uint8_t>> missingNormals(meshMaterials.size());
 
-            // 四角形.
-            if (count > 3 && p[3] != UINT32_MAX)
-            {
-                assert(count == 4);
+    auto meshOffset = model.Meshes.size();
+    model.Meshes.resize(meshOffset + meshMaterials.size());
 
-                faceIndex++;
-                faceCount++;
+    for(size_t i=0; i<meshMaterials.size(); ++i)
+    {
+        auto& mesh  = model.Meshes[meshOffset + i];
+        auto  count = vertexCounts[i];
 
-                IndexOBJ f0 = { p[2], t[2], n[2] };
-                IndexOBJ f1 = { p[3], t[3], n[3] };
-                IndexOBJ f2 = { p[0], t[0], n[0] };
+        mesh.Name               = std::string("mesh") + std::to_string(i);
+        mesh.MaterialId         = meshMaterials[i];
+        mesh.BoneInfluenceCount = 0;
 
-                indices.push_back(f0);
-                indices.push_back(f1);
-                indices.push_back(f2);
-            }
-        }
-        else if (0 == strcmp(buf, "mtllib"))
-        {
-            std::string path;
-            stream >> path;
-            if (!path.empty())
-            {
-                path = directory + "/" + path;
+        mesh.Positions    .resize(count);
+        mesh.Normals      .resize(count);
+        mesh.VertexIndices.resize(count);
 
-                if (!LoadFromMTL(path.c_str(), model))
-                {
-                    ELOGA("Error : Material Load Failed.");
-                    return false;
-                }
+        if (texcoordCount > 0)
+        { mesh.TexCoords[0].resize(count); }
 
-                // MaterialId検索マップ構築.
-                for(size_t i=0; i<model.Materials.size(); ++i)
-                { materials[model.Materials[i]] = uint32_t(i); }
-            }
-        }
-        else if (0 == strcmp(buf, "usemtl"))
-        {
-            SubsetOBJ subset = {};
+        // 頂点は面ごとに展開するので連番になる.
+        for(uint32_t j=0; j<count; ++j)
+        { mesh.VertexIndices[j] = j; }
+    }
 
-            std::string materialName;
-            stream >> materialName;
+    auto nextFloat = [&tokenizer]()
+    { return tokenizer.NextInLine() ? tokenizer.GetAsFloat() : 0.0f; };
 
-            auto itr = materials.find(materialName);
-            if (itr != materials.end())
-            { subset.MaterialId = itr->second; }
+    uint32_t positionIndex = 0;
+    uint32_t texcoordIndex = 0;
+    uint32_t normalIndex   = 0;
+    size_t   runIndex      = 0;
 
-            if (group.empty())
-            { group = "group" + std::to_string(subsets.size()); }
+    // 2パス目 : 頂点データを読み込み, 面をメッシュに直接書き込む.
+    const size_t EvictInterval = 16 * 1024 * 1024;
+    size_t       evictOffset   = EvictInterval;
 
-            subset.MeshName   = group;
-            subset.IndexStart = faceIndex * 3;
+    tokenizer.SetBuffer(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
+    while(tokenizer.Next())
+    {
+        auto offset = size_t(tokenizer.GetPtr() - reinterpret_cast<const char*>(file.GetData()));
+        if (offset >= evictOffset)
+        {
+            file.Evict(offset);
+            evictOffset = offset + EvictInterval;
+        }
 
-            auto index = subsets.size() - 1;
-            subsets.push_back(subset);
+        if (tokenizer.Compare("v"))
+        {
+            auto& v = positions[positionIndex++];
+            v.x = nextFloat();
+            v.y = nextFloat();
+            v.z = nextFloat();
+        }
+        else if (tokenizer.Compare("vt"))
+        {
+            auto& vt = texcoords[texcoordIndex++];
+            vt.x = nextFloat();
+            vt.y = nextFloat();
+        }
+        else if (tokenizer.Compare("vn"))
+        {
+            auto& vn = normals[normalIndex++];
+            vn.x = nextFloat();
+            vn.y = nextFloat();
+            vn.z = nextFloat();
+        }
+        else if (tokenizer.Compare("usemtl"))
+        {
+            runIndex++;
+        }
+        else if (tokenizer.Compare("f"))
+        {
+            auto& run  = runs[runIndex];
+            auto& mesh = model.Meshes[meshOffset + run.MeshIndex];
+            auto  hasTexCoord = !mesh.TexCoords[0].empty();
 
-            group.clear();
+            uint32_t cornerCount = 0;
+            uint32_t first[3] = {};
+            uint32_t prev [3] = {};
 
-            if (subsets.size() > 1)
+            while(tokenizer.NextInLine())
             {
-                subsets[index].IndexCount = faceCount * 3;
-                faceCount = 0;
+                // 相対インデックスはこの行までに定義された要素数を基準にする.
+                CornerOBJ corner;
+                uint32_t  index[3] = {};
+                if (!ParseCorner(tokenizer.GetToken(), corner)
+                 || !ResolveIndex(corner.P, positionIndex, index[0])
+                 || (corner.T != 0 && !ResolveIndex(corner.T, texcoordIndex, index[1]))
+                 || (corner.N != 0 && !ResolveIndex(corner.N, normalIndex,   index[2])))
+                {
+                    ELOGA("Error : Invalid Face. path = %s, token = %s", path, tokenizer.GetToken().ToString().c_str());
+                    return false;
+                }
+
+                if (corner.T == 0)
+                { index[1] = UINT32_MAX; }
+
+                if (corner.N == 0)
+                { index[2] = UINT32_MAX; }
+
+                if (cornerCount == 0)
+                {
+                    first[0] = index[0]; first[1] = index[1]; first[2] = index[2];
+                }
+                else if (cornerCount >= 2)
+                {
+                    const uint32_t* triangle[3] = { first, prev, index };
+                    for(auto k=0; k<3; ++k)
+                    {
+                        auto dst = run.VertexStart++;
+                        auto src = triangle[k];
+
+                        mesh.Positions[dst] = positions[src[0]];
+
+                        if (src[2] != UINT32_MAX)
+                        { mesh.Normals[dst] = normals[src[2]]; }
+                        else
+                        {
+                            auto& missing = missingNormals[run.MeshIndex];
+                            if (missing.empty())
+                            { missing.resize(mesh.Positions.size(), 0); }
+                            missing[dst] = 1;
+                        }
+
+                        if (hasTexCoord)
+                        { mesh.TexCoords[0][dst] = (src[1] != UINT32_MAX) ? texcoords[src[1]] : asdx::Vector2(0.0f, 0.0f); }
+                    }
+                }
+
+                prev[0] = index[0]; prev[1] = index[1]; prev[2] = index[2];
+                cornerCount++;
             }
         }
 
-        stream.ignore(BUFFER_LENGTH, '\n');
+        tokenizer.SkipLine();
     }
 
-    if (subsets.size() > 0)
+    // 法線が指定されなかった頂点だけ計算する. ファイルの法線は上書きしない.
+    for(size_t i=0; i<meshMaterials.size(); ++i)
     {
-        auto index = subsets.size();
-        subsets[index - 1].IndexCount = faceCount * 3;
+        if (!missingNormals[i].empty())
+        { CalcNormals(model.Meshes[meshOffset + i], missingNormals[i].data()); }
     }
 
-    stream.close();
-
-    std::stable_sort(subsets.begin(), subsets.end(),
-        [](const SubsetOBJ& lhs, const SubsetOBJ& rhs)
-        {
-            return std::tie(lhs.MaterialId, lhs.IndexStart)
-                 < std::tie(rhs.MaterialId, rhs.IndexStart);
-        });
+    model.Meshes.shrink_to_fit();
 
-    uint32_t matId  = UINT32_MAX;
-    uint32_t vertId = 0;
-    uint32_t meshId = 0;
+    return true;
+}
 
-    asdx::ResMesh dstMesh;
+//-----------------------------------------------------------------------------
+//      バイナリからリソースモデルを生成します.
+//-----------------------------------------------------------------------------
+void ResModel::LoadFromBinary(const ResModelBinary& binary)
+{
+    auto meshOffset = Meshes.size();
+    Meshes.resize(meshOffset + binary.Meshes.size());
 
-    for(size_t i=0; i<subsets.size(); ++i)
+    for(auto i=0u; i<binary.Meshes.size(); ++i)
     {
-        auto& subset = subsets[i];
-
-        if (matId != subset.MaterialId)
-        {
-            if (matId != UINT32_MAX)
-            {
-                if (!normals.empty())
-                { CalcNormals(dstMesh); }
+        auto& src = binary.Meshes[i];
+        auto& dst = Meshes[meshOffset + i];
+
+        dst.Name.assign(src.Name.data(), src.Name.size() - 1);
+        dst.MaterialId         = src.MaterialId;
+        dst.BoneInfluenceCount = src.BoneInfluenceCount;
+
+        dst.Positions    .assign(src.Positions    .begin(), src.Positions    .end());
+        dst.Normals      .assign(src.Normals      .begin(), src.Normals      .end());
+        dst.Tangents     .assign(src.Tangents     .begin(), src.Tangents     .end());
+        for(auto j=0u; j<ResMesh::MAX_TEXCOORD_LAYERS; ++j)
+        { dst.TexCoords[j].assign(src.TexCoords[j].begin(), src.TexCoords[j].end()); }
+        dst.Colors       .assign(src.Colors       .begin(), src.Colors       .end());
+        dst.BoneIndices  .assign(src.BoneIndices  .begin(), src.BoneIndices  .end());
+        dst.BoneWeights  .assign(src.BoneWeights  .begin(), src.BoneWeights  .end());
+        dst.VertexIndices.assign(src.VertexIndices.begin(), src.VertexIndices.end());
+    }
 
-                dstMesh.Positions    .shrink_to_fit();
-                dstMesh.Normals      .shrink_to_fit();
-                dstMesh.TexCoords[0] .shrink_to_fit();
-                dstMesh.VertexIndices.shrink_to_fit();
+    LodRanges.insert(LodRanges.end(), binary.LodRanges.begin(), binary.LodRanges.end());
 
-                model.Meshes.emplace_back(dstMesh);
+    Materials.reserve(Materials.size() + binary.Materials.size());
+    for(auto& material : binary.Materials)
+    { Materials.emplace_back(material.data(), material.size() - 1); }
+}
 
-                dstMesh = asdx::ResMesh();
-                vertId = 0;
-            }
+//-----------------------------------------------------------------------------
+//      ファイルからリソースモデルを生成します.
+//-----------------------------------------------------------------------------
+bool ResModel::LoadFromFileA(const char* filename)
+{
+    auto directory = GetDirectoryPath(filename);
+    auto ext = GetExt(filename);
 
-            dstMesh.Name       = std::string("mesh") + std::to_string(meshId);
-            dstMesh.MaterialId = subset.MaterialId;
+    if (ext == "obj")
+    {
+        return LoadFromOBJ(filename, directory, *this);
+    }
+    else if (ext == "amdl")
+    {
+        ResModelBinaryFile file;
+        if (!file.Open(filename))
+        { return false; }
 
-            meshId++;
-            matId = subset.MaterialId;
-        }
+        LoadFromBinary(*file.GetModel());
+        return true;
+    }
 
-        for(size_t j=0; j<subset.IndexCount; ++j)
-        {
-            auto id = subset.IndexStart + j;
-            auto& index = indices[id];
+    return false;
+}
 
-            dstMesh.Positions[vertId] = positions[index.P];
+//-----------------------------------------------------------------------------
+//      ファイルからリソースモデルを生成します.
+//-----------------------------------------------------------------------------
+bool ResModel::LoadFromFileW(const wchar_t* filename)
+{
+    auto filenameA = ToMultiByte(filename);
+    return LoadFromFileA(filenameA.c_str());
+}
 
-            if (!normals.empty())
-            { dstMesh.Normals[vertId] = normals[index.N]; }
+//-----------------------------------------------------------------------------
+//      バイナリファイル(AMDL)に保存します.
+//-----------------------------------------------------------------------------
+bool ResModel::SaveToFileA(const char* filename) const
+{
+    if (filename == nullptr)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
 
-            if (!texcoords.empty())
-            { dstMesh.TexCoords[0][vertId] = texcoords[index.U]; }
+    BinaryWriter writer;
 
-            dstMesh.VertexIndices.push_back(vertId);
+    auto header    = writer.Reserve<ResModelBinary>(1);
+    auto meshes    = writer.Reserve<ResMeshBinary>(Meshes.size());
+    auto lodRanges = writer.Write(LodRanges.data(), LodRanges.size());
+    auto materials = writer.Reserve<BinaryArrary<char>>(Materials.size());
 
-            vertId++;
-        }
+    for(size_t i=0; i<Meshes.size(); ++i)
+    {
+        auto& src = Meshes[i];
+
+        auto name     = writer.Write(src.Name.c_str(), src.Name.size() + 1);
+        auto position = writer.Write(src.Positions.data(), src.Positions.size());
+        auto normal   = writer.Write(src.Normals  .data(), src.Normals  .size());
+        auto tangent  = writer.Write(src.Tangents .data(), src.Tangents .size());
+
+        size_t texcoord[ResMesh::MAX_TEXCOORD_LAYERS] = {};
+        for(auto j=0u; j<ResMesh::MAX_TEXCOORD_LAYERS; ++j)
+        { texcoord[j] = writer.Write(src.TexCoords[j].data(), src.TexCoords[j].size()); }
+
+        auto color       = writer.Write(src.Colors       .data(), src.Colors       .size());
+        auto boneIndex   = writer.Write(src.BoneIndices  .data(), src.BoneIndices  .size());
+        auto boneWeight  = writer.Write(src.BoneWeights  .data(), src.BoneWeights  .size());
+        auto vertexIndex = writer.Write(src.VertexIndices.data(), src.VertexIndices.size());
+
+        // 書き込みでバッファが再確保されるので, 参照は最後に解決する.
+        auto& dst = writer.At<ResMeshBinary>(meshes)[i];
+        dst.MaterialId         = src.MaterialId;
+        dst.BoneInfluenceCount = src.BoneInfluenceCount;
+
+        writer.Link(dst.Name,      name,     src.Name.size() + 1);
+        writer.Link(dst.Positions, position, src.Positions.size());
+        writer.Link(dst.Normals,   normal,   src.Normals  .size());
+        writer.Link(dst.Tangents,  tangent,  src.Tangents .size());
+        for(auto j=0u; j<ResMesh::MAX_TEXCOORD_LAYERS; ++j)
+        { writer.Link(dst.TexCoords[j], texcoord[j], src.TexCoords[j].size()); }
+        writer.Link(dst.Colors,        color,       src.Colors       .size());
+        writer.Link(dst.BoneIndices,   boneIndex,   src.BoneIndices  .size());
+        writer.Link(dst.BoneWeights,   boneWeight,  src.BoneWeights  .size());
+        writer.Link(dst.VertexIndices, vertexIndex, src.VertexIndices.size());
     }
 
-    if (matId != UINT32_MAX)
+    for(size_t i=0; i<Materials.size(); ++i)
     {
-        if (normals.empty())
-        { CalcNormals(dstMesh); }
+        auto name = writer.Write(Materials[i].c_str(), Materials[i].size() + 1);
+        writer.Link(writer.At<BinaryArrary<char>>(materials)[i], name, Materials[i].size() + 1);
+    }
 
-        dstMesh.Positions    .shrink_to_fit();
-        dstMesh.Normals      .shrink_to_fit();
-        dstMesh.TexCoords[0] .shrink_to_fit();
-        dstMesh.VertexIndices.shrink_to_fit();
+    auto& buffer = writer.GetBuffer();
 
-        model.Meshes.emplace_back(dstMesh);
+    // オフセットは int で保持するので 2GB を超えるファイルは扱えない.
+    if (buffer.size() > size_t(INT32_MAX))
+    {
+        ELOGA("Error : Binary Size Over. size = %zu", buffer.size());
+        return false;
     }
 
-    model.Meshes.shrink_to_fit();
+    auto model = writer.At<ResModelBinary>(header);
+    model->SetMagic();
+    model->Version  = ResModelBinary::FILE_VERSION;
+    model->FileSize = uint32_t(buffer.size());
+    writer.Link(model->Meshes,    meshes,    Meshes   .size());
+    writer.Link(model->LodRanges, lodRanges, LodRanges.size());
+    writer.Link(model->Materials, materials, Materials.size());
+
+    FILE* pFile = nullptr;
+#ifdef _WIN32
+    auto err = fopen_s(&pFile, filename, "wb");
+#else
+    pFile = fopen(filename, "wb");
+    auto err = (pFile == nullptr) ? 1 : 0;
+#endif//_WIN32
+    if (err != 0 || pFile == nullptr)
+    {
+        ELOGA("Error : File Open Failed. path = %s", filename);
+        return false;
+    }
+
+    auto written = fwrite(buffer.data(), 1, buffer.size(), pFile);
+    fclose(pFile);
 
-    positions.clear();
-    normals  .clear();
-    texcoords.clear();
-    indices  .clear();
-    subsets  .clear();
+    if (written != buffer.size())
+    {
+        ELOGA("Error : File Write Failed. path = %s", filename);
+        return false;
+    }
 
     return true;
 }
 
 //-----------------------------------------------------------------------------
-//      ファイルからリソースモデルを生成します.
+//      バイナリファイル(AMDL)に保存します.
 //-----------------------------------------------------------------------------
-bool ResModel::LoadFromFileA(const char* filename)
+bool ResModel::SaveToFileW(const wchar_t* filename) const
+{
+    auto filenameA = ToMultiByte(filename);
+    return SaveToFileA(filenameA.c_str());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ResModelBinaryFile class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+ResModelBinaryFile::ResModelBinaryFile()
+: m_pModel(nullptr)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+ResModelBinaryFile::~ResModelBinaryFile()
+{ Close(); }
+
+//-----------------------------------------------------------------------------
+//      ファイルをマップして検証します.
+//-----------------------------------------------------------------------------
+bool ResModelBinaryFile::Open(const char* filename)
 {
-    std::ifstream stream;
-    stream.open(filename, std::ios::in);
+    Close();
 
-    auto directory = asdx::GetDirectoryPathA(filename);
-    auto ext = asdx::GetExtA(filename);
+    if (!m_File.Open(filename))
+    {
+        ELOGA("Error : File Open Failed. path = %s", filename);
+        return false;
+    }
 
-    if (ext == "obj")
+    auto begin = m_File.GetData();
+    auto end   = begin + m_File.GetSize();
+    auto model = reinterpret_cast<const ResModelBinary*>(begin);
+
+    if (m_File.GetSize() < sizeof(ResModelBinary)
+     || !model->CheckMagic()
+     || !model->CheckVersion(ResModelBinary::FILE_VERSION)
+     || model->FileSize != m_File.GetSize())
     {
-        return LoadFromOBJ(stream, directory, *this);
+        ELOGA("Error : Invalid Header. path = %s", filename);
+        m_File.Close();
+        return false;
     }
 
-    return false;
+    auto valid = model->Meshes   .IsInRange(begin, end)
+              && model->LodRanges.IsInRange(begin, end)
+              && model->Materials.IsInRange(begin, end);
+
+    for(auto i=0u; valid && i<model->Meshes.size(); ++i)
+    { valid = IsValidMesh(model->Meshes[i], begin, end); }
+
+    for(auto i=0u; valid && i<model->LodRanges.size(); ++i)
+    {
+        auto& range = model->LodRanges[i];
+        valid = uint64_t(range.Offset) + range.Count <= uint64_t(model->Meshes.size());
+    }
+
+    for(auto i=0u; valid && i<model->Materials.size(); ++i)
+    { valid = IsValidString(model->Materials[i], begin, end); }
+
+    if (!valid)
+    {
+        ELOGA("Error : Invalid Binary. path = %s", filename);
+        m_File.Close();
+        return false;
+    }
+
+    m_pModel = model;
+    return true;
 }
 
 //-----------------------------------------------------------------------------
-//      ファイルからリソースモデルを生成します.
+//      マップを解除します.
 //-----------------------------------------------------------------------------
-bool ResModel::LoadFromFileW(const wchar_t* filename)
+void ResModelBinaryFile::Close()
 {
-    auto filenameA = asdx::ToStringA(filename);
-    return LoadFromFileA(filenameA.c_str());
+    m_pModel = nullptr;
+    m_File.Close();
 }
 
 } // namespace asdx
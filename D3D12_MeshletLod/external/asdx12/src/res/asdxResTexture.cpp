@@ -15,6 +15,7 @@
 #include <wincodec.h>
 #include <wrl/client.h>
 #include <res/asdxResTexture.h>
+#include <res/asdxImageDecoder.h>
 #include <fnd/asdxLogger.h>
 #include <fnd/asdxMath.h>
 
@@ -130,21 +131,6 @@ enum NATIVE_TEXTURE_FORMAT
     NATIVE_TEXTURE_FORMAT_A32B32G32R32_FLOAT,
 };
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
-// TGA_FORMA_TYPE enum
-////////////////////////////////////////////////////////////////////////////////////////////////////
-enum TGA_FORMAT_TYPE
-{
-    TGA_FORMAT_NONE             = 0,        //!< イメージなし.
-    TGA_FORMAT_INDEXCOLOR       = 1,        //!< インデックスカラー(256色).
-    TGA_FORMAT_FULLCOLOR        = 2,        //!< フルカラー
-    TGA_FORMAT_GRAYSCALE        = 3,        //!< 白黒.
-    TGA_FORMAT_RLE_INDEXCOLOR   = 9,        //!< RLE圧縮インデックスカラー.
-    TGA_FORMAT_RLE_FULLCOLOR    = 10,       //!< RLE圧縮フルカラー.
-    TGA_FORMAT_RLE_GRAYSCALE    = 11,       //!< RLE圧縮白黒.
-};
-
-
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // DDPixelFormat structure
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -222,143 +208,6 @@ struct WICConvert
 
 
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
-// TGA_HEADER structure
-////////////////////////////////////////////////////////////////////////////////////////////////////
-#pragma pack( push, 1 )
-struct TGA_HEADER
-{
-    uint8_t  IdFieldLength;      // IDフィードのサイズ(範囲は0～255).
-    uint8_t  HasColorMap;        // カラーマップ有無(0=なし, 1=あり)
-    uint8_t  Format;             // 画像形式.
-    uint16_t ColorMapEntry;      // カラーマップエントリー.
-    uint16_t ColorMapLength;     // カラーマップのエントリーの総数.
-    uint8_t  ColorMapEntrySize;  // カラーマップの1エントリー当たりのビット数.
-    uint16_t OffsetX;            // 画像のX座標.
-    uint16_t OffsetY;            // 画像のY座標.
-    uint16_t Width;              // 画像の横幅.
-    uint16_t Height;             // 画像の縦幅.
-    uint8_t  BitPerPixel;        // ビットの深さ.
-    uint8_t  ImageDescriptor;    // (0~3bit) : 属性, 4bit : 格納方向(0=左から右,1=右から左), 5bit : 格納方向(0=下から上, 1=上から下), 6~7bit : インタリーブ(使用不可).
-};
-#pragma pack( pop )
-
-////////////////////////////////////////////////////////////////////////////////////////////////////
-// TGA_FOOTER structure
-////////////////////////////////////////////////////////////////////////////////////////////////////
-#pragma pack( push, 1 )
-struct TGA_FOOTER
-{
-    uint32_t    OffsetExt;      // 拡張データへのオフセット(byte数) [オフセットはファイルの先頭から].
-    uint32_t    OffsetDev;      // ディベロッパーエリアへのオフセット(byte数)[オフセットはファイルの先頭から].
-    char        Tag[18];        // 'TRUEVISION-XFILE.\0'
-};
-#pragma pack( pop )
-
-
-///////////////////////////////////////////////////////////////////////////////////////////////////
-// TGA_EXTENSION structure
-///////////////////////////////////////////////////////////////////////////////////////////////////
-#pragma pack( push, 1 )
-struct TGA_EXTENSION
-{
-    uint16_t    Size;                       //!< サイズ.
-    char        AuthorName[ 41 ];           //!< 著作者名.
-    char        AuthorComment[ 324 ];       //!< 著作者コメント.
-    uint16_t    StampMonth;                 //!< タイムスタンプ　月(1-12).
-    uint16_t    StampDay;                   //!< タイムスタンプ　日(1-31).
-    uint16_t    StampYear;                  //!< タイムスタンプ　年(4桁, 例1989).
-    uint16_t    StampHour;                  //!< タイムスタンプ　時(0-23).
-    uint16_t    StampMinute;                //!< タイムスタンプ　分(0-59).
-    uint16_t    StampSecond;                //!< タイムスタンプ　秒(0-59).
-    char        JobName[ 41 ];              //!< ジョブ名 (最後のバイトはゼロが必須).
-    uint16_t    JobHour;                    //!< ジョブ時間  時(0-65535)
-    uint16_t    JobMinute;                  //!< ジョブ時間　分(0-59)
-    uint16_t    JobSecond;                  //!< ジョブ時間　秒(0-59)
-    char        SoftwareId[ 41 ];           //!< ソフトウェアID (最後のバイトはゼロが必須).
-    uint16_t    VersionNumber;              //!< ソフトウェアバージョン    VersionNumber * 100になる.
-    uint8_t     VersionLetter;              //!< ソフトウェアバージョン
-    uint32_t    KeyColor;                   //!< キーカラー.
-    uint16_t    PixelNumerator;             //!< ピクセル比分子　ピクセル横幅.
-    uint16_t    PixelDenominator;           //!< ピクセル比分母　ピクセル縦幅.
-    uint16_t    GammaNumerator;             //!< ガンマ値分子.
-    uint16_t    GammaDenominator;           //!< ガンマ値分母
-    uint32_t    ColorCorrectionOffset;      //!< 色補正テーブルへのオフセット.
-    uint32_t    StampOffset;                //!< ポステージスタンプ画像へのオフセット.
-    uint32_t    ScanLineOffset;             //!< スキャンラインオフセット.
-    uint8_t     AttributeType;              //!< アルファチャンネルデータのタイプ
-};
-#pragma pack( pop )
-
-////////////////////////////////////////////////////////////////////////////////////////////
-// RGBE structure
-////////////////////////////////////////////////////////////////////////////////////////////
-struct RGBE
-{
-    union
-    {
-        struct
-        {
-            uint8_t r;
-            uint8_t g;
-            uint8_t b;
-            uint8_t e;
-        };
-        uint8_t v[4];
-    };
-};
-
-
-//------------------------------------------------------------------------------------------
-//      RGBE形式からVector3形式に変換します.
-//------------------------------------------------------------------------------------------
-inline asdx::Vector3 RGBEToVec3( const RGBE& val )
-{
-    asdx::Vector3 result;
-    if ( val.e )
-    {
-        auto f = ldexp( 1.0, static_cast<int>(val.e - (128+8)) );
-        result.x = static_cast<float>( val.r * f );
-        result.y = static_cast<float>( val.g * f );
-        result.z = static_cast<float>( val.b * f );
-    }
-    else 
-    {
-        result.x = 0.0f;
-        result.y = 0.0f;
-        result.z = 0.0f;
-    }
-    return result;
-}
-
-//------------------------------------------------------------------------------------------
-//      Vector3形式からRGBE形式に変換します.
-//------------------------------------------------------------------------------------------
-inline RGBE Vec3ToRGBE( const asdx::Vector3& val )
-{
-    RGBE result = {};
-    double d = asdx::Max( val.x, asdx::Max( val.y, val.z ) );
-
-    if ( d <= DBL_EPSILON )
-    {
-        result.r = 0;
-        result.g = 0;
-        result.b = 0;
-        result.e = 0;
-        return result;
-    }
-
-    int e;
-    double m = frexp(d, &e); // d = m * 2^e
-    d = m * 256.0 / d;
-
-    result.r = static_cast<uint32_t>(val.x * d);
-    result.g = static_cast<uint32_t>(val.y * d);
-    result.b = static_cast<uint32_t>(val.z * d);
-    result.e = static_cast<uint32_t>(e + 128);
-    return result;
-}
-
 //-------------------------------------------------------------------------------------------------
 // Global Variables.
 //-------------------------------------------------------------------------------------------------
@@ -740,330 +589,6 @@ std::string GetExtA( const char* filePath )
     return std::string();
 }
 
-//-------------------------------------------------------------------------------------------------
-//! @brief      8Bitインデックスカラー形式を解析します.
-//!
-//! @param[in]      pColorMap       カラーマップです.
-//-------------------------------------------------------------------------------------------------
-void Parse8Bits( FILE* pFile, uint32_t size, uint8_t* pColorMap, uint8_t* pPixels )
-{
-    uint8_t color = 0;
-    for( uint32_t i=0; i<size; ++i )
-    {
-        color = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 2 ] = pColorMap[ color * 3 + 0 ];
-        pPixels[ i * 4 + 1 ] = pColorMap[ color * 3 + 1 ];
-        pPixels[ i * 4 + 0 ] = pColorMap[ color * 3 + 2 ];
-        pPixels[ i * 4 + 3 ] = 255;
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      16Bitフルカラー形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse16Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    for( uint32_t i=0; i<size; ++i )
-    {
-        uint16_t color = fgetc( pFile ) + ( fgetc( pFile ) << 8 );
-        pPixels[ i * 4 + 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-        pPixels[ i * 4 + 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-        pPixels[ i * 4 + 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-        pPixels[ i * 4 + 3 ] = 255;
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      24Bitフルカラー形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse24Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    for( uint32_t i=0; i<size; ++i )
-    {
-        pPixels[ i * 4 + 2 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 1 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 3 ] = 255;
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      32Bitフルカラー形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse32Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    for( uint32_t i=0; i<size; ++i )
-    {
-        pPixels[ i * 4 + 2 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 1 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 3 ] = (uint8_t)fgetc( pFile );
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief     8Bitグレースケール形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse8BitsGrayScale( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    for( uint32_t i=0; i<size; ++i )
-    {
-        pPixels[ i ] = (uint8_t)fgetc( pFile );
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      16Bitグレースケール形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse16BitsGrayScale( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    for( uint32_t i=0; i<size; ++i )
-    {
-        pPixels[ i * 2 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 2 + 1 ] = (uint8_t)fgetc( pFile );
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      8BitRLE圧縮インデックスカラー形式を解析します.
-//!
-//! @param[in]  pColorMap       カラーマップです.
-//-------------------------------------------------------------------------------------------------
-void Parse8BitsRLE( FILE* pFile, uint8_t* pColorMap, uint32_t size, uint8_t* pPixels )
-{
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 3.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            color = (uint8_t)fgetc( pFile );
-
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = pColorMap[ color * 3 + 2 ];
-                ptr[ 1 ] = pColorMap[ color * 3 + 1 ];
-                ptr[ 2 ] = pColorMap[ color * 3 + 0 ];
-                ptr[ 3 ] = 255;
-            }
-        }
-        else
-        {
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                color = (uint8_t)fgetc( pFile );
-
-                ptr[ 0 ] = pColorMap[ color * 3 + 2 ];
-                ptr[ 1 ] = pColorMap[ color * 3 + 1 ];
-                ptr[ 2 ] = pColorMap[ color * 3 + 0 ];
-                ptr[ 3 ] = 255;
-            }
-        }
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      16BitRLE圧縮フルカラー形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse16BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    uint32_t count  = 0;
-    uint16_t color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 3.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            color = fgetc( pFile ) + ( fgetc( pFile ) << 8 ); 
-
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-                ptr[ 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-                ptr[ 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-                ptr[ 3 ] = 255;
-            }
-        }
-        else
-        {
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                color = fgetc( pFile ) + ( fgetc( pFile ) << 8 );
-
-                ptr[ 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-                ptr[ 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-                ptr[ 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-                ptr[ 3 ] = 255;
-            }
-        }
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      24BitRLE圧縮フルカラー形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse24BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    uint32_t count    = 0;
-    uint8_t  color[3] = { 0, 0, 0 };
-    uint8_t  header   = 0;
-    uint8_t* ptr      = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 3.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            fread( color, sizeof(uint8_t), 3, pFile );
-
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = color[ 2 ];
-                ptr[ 1 ] = color[ 1 ];
-                ptr[ 2 ] = color[ 0 ];
-                ptr[ 3 ] = 255;
-            }
-        }
-        else
-        {
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 2 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 3 ] = 255;
-            }
-        }
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      32BitRLE圧縮フルカラー形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse32BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    uint32_t count    = 0;
-    uint8_t  color[4] = { 0, 0, 0, 0 };
-    uint8_t  header   = 0;
-    uint8_t* ptr      = pPixels;
-
-    while( ptr < pPixels + size )   // size = width * height * 4.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            fread( color, sizeof(uint8_t), 4, pFile );
-
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = color[ 2 ];
-                ptr[ 1 ] = color[ 1 ];
-                ptr[ 2 ] = color[ 0 ];
-                ptr[ 3 ] = color[ 3 ];
-            }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 2 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 3 ] = (uint8_t)fgetc( pFile );
-            }
-        }
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      8BitRLE圧縮グレースケール形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse8BitsGrayScaleRLE( FILE* pFile, uint32_t size, uint8_t* pPixles )
-{
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixles;
-
-    while( ptr < pPixles + size ) // size = width * height
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            color = (uint8_t)fgetc( pFile );
-
-            for( uint32_t i=0; i<count; ++i, ptr++ )
-            { (*ptr) = color; }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr++ )
-            { (*ptr) = (uint8_t)fgetc( pFile ); }
-        }
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      16BitRLE圧縮グレースケール形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse16BitsGrayScaleRLE( FILE* pFile, uint32_t size, uint8_t* pPixles )
-{
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  alpha  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixles;
-
-    while( ptr < pPixles + size ) // size = width * height * 2
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            color = (uint8_t)fgetc( pFile );
-            alpha = (uint8_t)fgetc( pFile );
-
-            for( uint32_t i=0; i<count; ++i, ptr+=2 )
-            {
-                ptr[ 0 ] = color;
-                ptr[ 1 ] = alpha;
-            }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr+=2 )
-            {
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-            }
-        }
-    }
-}
-
 } // namespace /* anonymous */
 
 
@@ -2324,7 +1849,7 @@ bool CreateResTextureFromDDSFileA(const char* filename, asdx::ResTexture& resTex
 bool CreateResTextureFromDDSFileW(const wchar_t* filename, asdx::ResTexture& resTexture)
 {
     FILE* pFile = nullptr;
-    auto err = _wfopen_s(&pFile, filename, L"rb");
+    auto err = _wfopen_s(&pFile, filename, L"rb" );
     if (err != 0)
     {
         ELOGA("Error : File Open Failed. path = %ls", filename);
@@ -2883,296 +2408,6 @@ bool CreateResTextureFromDDSMemory(const uint8_t* pBinary, uint32_t bufferSize,
     return true;
 }
 
-//-------------------------------------------------------------------------------------------------
-//      Targaファイルからリソーステクスチャを生成します.
-//-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromTGAFile(FILE* pFile, asdx::ResTexture& resTexture)
-{
-    // フッターを読み込み.
-    TGA_FOOTER footer;
-    long offset = sizeof(footer);
-    fseek( pFile, -offset, SEEK_END );
-    fread( &footer, sizeof(footer), 1, pFile );
-
-    // ファイルマジックをチェック.
-    if ( strcmp( footer.Tag, "TRUEVISION-XFILE." ) != 0 )
-    {
-        ELOG( "Error : Invalid File Format." );
-        fclose( pFile );
-        return false;
-    }
-
-    // 拡張データがある場合は読み込み.
-    if ( footer.OffsetExt != 0 )
-    {
-        TGA_EXTENSION extension;
-
-        fseek( pFile, footer.OffsetExt, SEEK_SET );
-        fread( &extension, sizeof(extension), 1, pFile );
-    }
-
-    // ディベロッパーエリアがある場合.
-    if ( footer.OffsetDev != 0 )
-    {
-        /* NOT IMPLEMENT */
-    }
-
-    // ファイル先頭に戻す.
-    fseek( pFile, 0, SEEK_SET );
-
-    // ヘッダデータを読み込む.
-    TGA_HEADER header;
-    fread( &header, sizeof(header), 1, pFile );
-
-    // フォーマット判定.
-    uint32_t bytePerPixel = 0;
-    switch( header.Format )
-    {
-    // 該当なし.
-    case TGA_FORMAT_NONE:
-        {
-            ELOG( "Error : Invalid Format." );
-            fclose( pFile );
-            return false;
-        }
-        break;
-
-    // グレースケール
-    case TGA_FORMAT_GRAYSCALE:
-    case TGA_FORMAT_RLE_GRAYSCALE:
-        { 
-            if ( header.BitPerPixel == 8 )
-            { bytePerPixel = 1; }
-            else
-            { bytePerPixel = 2; }
-        }
-        break;
-
-    // カラー.
-    case TGA_FORMAT_INDEXCOLOR:
-    case TGA_FORMAT_FULLCOLOR:
-    case TGA_FORMAT_RLE_INDEXCOLOR:
-    case TGA_FORMAT_RLE_FULLCOLOR:
-        {
-            if ( header.BitPerPixel <= 24 )
-            { bytePerPixel = 3; }
-            else
-            { bytePerPixel = 4; }
-        }
-        break;
-
-    // 上記以外.
-    default:
-        {
-            ELOG( "Error : Unsupported Format." );
-            fclose( pFile );
-            return false;
-        }
-        break;
-    }
-
-    // IDフィールドサイズ分だけオフセットを移動させる.
-    if (header.IdFieldLength != 0)
-    {
-        fseek(pFile, header.IdFieldLength, SEEK_CUR);
-    }
-
-    // RGBのみはテクスチャがサポートされないので，強制的にRGBAにする.
-    auto bpp = (bytePerPixel == 3) ? 4 : bytePerPixel;
-
-    // ピクセルサイズを決定してメモリを確保.
-    auto size = header.Width * header.Height * bpp;
-    auto pPixels = new (std::nothrow) uint8_t [ size ];
-    if ( pPixels == nullptr )
-    {
-        ELOG( "Error : Out Of Memory." );
-        fclose( pFile );
-        return false;
-    }
-
-    // カラーマップを持つかチェック.
-    uint8_t* pColorMap = nullptr;
-    if ( header.HasColorMap )
-    {
-        // カラーマップサイズを算出.
-        uint32_t colorMapSize = header.ColorMapEntry * ( header.ColorMapEntrySize >> 3 );
-
-        // メモリを確保.
-        pColorMap = new (std::nothrow) uint8_t [ colorMapSize ];
-        if ( pColorMap == nullptr )
-        {
-            ELOG( "Error : Out Of Memory." );
-            delete[] pPixels;
-            pPixels = nullptr;
-            fclose( pFile );
-            return false;
-        }
-
-        // がばっと読み込む.
-        fread( pColorMap, sizeof(uint8_t), colorMapSize, pFile );
-    }
-
-    // 幅・高さ・ビットの深さ・ハッシュキーを設定.
-    auto width       = header.Width;
-    auto height      = header.Height;
-    auto format      = static_cast<TGA_FORMAT_TYPE>( header.Format );
-   
-    // フォーマットに合わせてピクセルデータを解析する.
-    switch( header.Format )
-    {
-    // パレット.
-    case TGA_FORMAT_INDEXCOLOR:
-        { Parse8Bits( pFile, width * height, pColorMap, pPixels ); }
-        break;
-
-    // フルカラー.
-    case TGA_FORMAT_FULLCOLOR:
-        {
-            switch( header.BitPerPixel )
-            {
-            case 16:
-                { Parse16Bits( pFile, width * height, pPixels ); }
-                break;
-
-            case 24:
-                { Parse24Bits( pFile, width * height, pPixels ); }
-                break;
-
-            case 32:
-                { Parse32Bits( pFile, width * height, pPixels ); }
-                break;
-            }
-        }
-        break;
-
-    // グレースケール.
-    case TGA_FORMAT_GRAYSCALE:
-        {
-            if ( header.BitPerPixel == 8 )
-            { Parse8BitsGrayScale( pFile, width * height, pPixels ); }
-            else
-            { Parse16BitsGrayScale( pFile, width * height, pPixels ); }
-        }
-        break;
-
-    // パレットRLE圧縮.
-    case TGA_FORMAT_RLE_INDEXCOLOR:
-        { Parse8BitsRLE( pFile, pColorMap, width * height * 3, pPixels ); }
-        break;
-
-    // フルカラーRLE圧縮.
-    case TGA_FORMAT_RLE_FULLCOLOR:
-        {
-            switch( header.BitPerPixel )
-            {
-            case 16:
-                { Parse16BitsRLE( pFile, width * height * 4, pPixels ); }
-                break;
-
-            case 24:
-                { Parse24BitsRLE( pFile, width * height * 4, pPixels ); }
-                break;
-
-            case 32:
-                { Parse32BitsRLE( pFile, width * height * 4, pPixels ); }
-                break;
-            }
-        }
-        break;
-
-    // グレースケールRLE圧縮.
-    case TGA_FORMAT_RLE_GRAYSCALE:
-        {
-            if ( header.BitPerPixel == 8 )
-            { Parse8BitsGrayScaleRLE( pFile, width * height, pPixels ); }
-            else
-            { Parse16BitsGrayScaleRLE( pFile, width * height * 2, pPixels ); }
-        }
-        break;
-    }
-
-    // 不要なメモリを解放.
-    if (pColorMap != nullptr)
-    {
-        delete[] pColorMap;
-        pColorMap = nullptr;
-    }
-
-    // ファイルを閉じる.
-    fclose( pFile );
-
-    auto surface = new SubResource();
-    if (surface == nullptr)
-    {
-        ELOG("Error : Out of Memory.");
-        return false;
-    }
-
-    surface->Width      = width;
-    surface->Height     = height;
-    surface->MipIndex   = 0;
-    surface->Pitch      = width * bpp;
-    surface->SlicePitch = width * height * bpp;
-    surface->pPixels    = pPixels;
-
-    resTexture.Dimension    = TEXTURE_DIMENSION_2D;
-    resTexture.Width        = width;
-    resTexture.Height       = height;
-    resTexture.Depth        = 1;
-    resTexture.SurfaceCount = 1;
-    resTexture.MipMapCount  = 1;
-    resTexture.pResources   = surface;
-
-    switch(format)
-    {
-    case TGA_FORMAT_NONE:
-        resTexture.Format = DXGI_FORMAT_UNKNOWN;
-        break;
-
-    case TGA_FORMAT_FULLCOLOR:
-        resTexture.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        break;
-
-    case TGA_FORMAT_GRAYSCALE:
-        resTexture.Format = DXGI_FORMAT_R8_UNORM;
-        break;
-
-    case TGA_FORMAT_RLE_FULLCOLOR:
-        resTexture.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        break;
-
-    case TGA_FORMAT_RLE_GRAYSCALE:
-        resTexture.Format = DXGI_FORMAT_R8_UNORM;
-        break;
-
-    case TGA_FORMAT_INDEXCOLOR:
-    case TGA_FORMAT_RLE_INDEXCOLOR:
-        {
-            switch (bytePerPixel)
-            {
-            case 1:
-                { resTexture.Format = DXGI_FORMAT_R8_UNORM; }
-                break;
-
-            case 2:
-                { resTexture.Format = DXGI_FORMAT_B5G5R5A1_UNORM; }
-                break;
-
-            default:
-                {
-                    ELOG("Error : Unknown Format. bytePerPixel = %u", bytePerPixel );
-                    assert(false);
-                    return false;
-                }
-            }
-        }
-        break;
-    }
-
-    // 正常終了.
-    return true;
-}
-
 //-------------------------------------------------------------------------------------------------
 //      Targaファイルからリソーステクスチャを生成します.
 //-------------------------------------------------------------------------------------------------
@@ -3186,7 +2421,10 @@ bool CreateResTextureFromTGAFileA(const char* filename, asdx::ResTexture& resTex
         return false;
     }
 
-    return CreateResTextureFromTGAFile(pFile, resTexture);
+    auto ret = CreateResTextureFromTGAFile(pFile, resTexture);
+    fclose(pFile);
+
+    return ret;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3195,213 +2433,17 @@ bool CreateResTextureFromTGAFileA(const char* filename, asdx::ResTexture& resTex
 bool CreateResTextureFromTGAFileW(const wchar_t* filename, asdx::ResTexture& resTexture)
 {
     FILE* pFile = nullptr;
-    auto err = _wfopen_s(&pFile, filename, L"rb");
+    auto err = _wfopen_s(&pFile, filename, L"rb" );
     if (err != 0)
     {
         ELOGW("Error : File Open Failed. path = %ls", filename);
         return false;
     }
 
-    return CreateResTextureFromTGAFile(pFile, resTexture);
-}
-
-//------------------------------------------------------------------------------------------
-//      HDRファイルのヘッダを読み込みします.
-//------------------------------------------------------------------------------------------
-bool ReadHdrHeader( FILE* pFile, int32_t& width, int32_t& height, float& gamma, float& exposure )
-{
-    char buf[ 256 ];
-    fread( buf, sizeof(char), 2, pFile );
-
-    if ( buf[0] != '#' || buf[1] != '?' )
-    { return false; }
-
-    auto valid = false;
-    for( ;; )
-    {
-        if ( fgets( buf, 256, pFile ) == nullptr )
-        { break; }
-
-        if ( buf[0] == '\n' )
-        { break; }
-        else if ( buf[0] == '#' )
-        { continue; }
-        else
-        {
-            auto g = 1.0f;
-            auto e = 1.0f;
-            if ( sscanf_s( buf, "GAMMA=%f\n", &g ) != 0 ) 
-            { gamma = g; }
-            else if ( sscanf_s( buf, "EXPOSURE=%f\n", &e ) != 0 )
-            { exposure = e; }
-            else if ( strcmp( buf, "FORMAT=32-bit_rle_rgbe\n" ) == 0 )
-            { valid = true; }
-        }
-    }
-
-    if ( !valid )
-    { return false; }
-
-    if ( fgets( buf, 256, pFile ) != nullptr )
-    {
-        auto w = 0;
-        auto h = 0;
-        if ( sscanf_s( buf, "-Y %d +X %d\n", &h, &w ) != 0 )
-        {
-            width = w;
-            height = h;
-        }
-        else if ( sscanf_s( buf, "+X %d -Y %d\n", &w, &h ) != 0 )
-        {
-            width = w;
-            height = h;
-        }
-        else
-        { return false; }
-    }
-
-    return true;
-}
-
-//------------------------------------------------------------------------------------------
-//      旧形式のカラーを読み取ります.
-//------------------------------------------------------------------------------------------
-bool ReadOldColors( FILE* pFile, RGBE* pLine, int32_t count )
-{
-    auto shift = 0;
-    while( 0 < count )
-    {
-        pLine[0].r = getc( pFile );
-        pLine[0].g = getc( pFile );
-        pLine[0].b = getc( pFile );
-        pLine[0].e = getc( pFile );
-
-        if ( feof( pFile ) || ferror( pFile ) )
-            return false;
-
-        if ( pLine[0].r == 1
-          && pLine[0].g == 1
-          && pLine[0].b == 1 )
-        {
-            for( auto i=pLine[0].e << shift; i > 0; i-- )
-            {
-                pLine[0].r = pLine[-1].r;
-                pLine[0].g = pLine[-1].g;
-                pLine[0].b = pLine[-1].b;
-                pLine[0].e = pLine[-1].e;
-                pLine++;
-                count--;
-            }
-            shift += 8;
-        }
-        else
-        {
-            pLine++;
-            count--;
-            shift = 0;
-        }
-    }
-
-    return true;
-}
-
-//------------------------------------------------------------------------------------------
-//      カラーを読み取ります.
-//------------------------------------------------------------------------------------------
-bool ReadColor( FILE* pFile, RGBE* pLine, int32_t count )
-{
-    if ( count < 8 || 0x7fff < count )
-    { return ReadOldColors( pFile, pLine, count ); }
-
-    auto i = getc( pFile );
-    if ( i == EOF )
-        return false;
-
-    if ( i != 2 )
-    {
-        ungetc( i, pFile );
-        return ReadOldColors( pFile, pLine, count );
-    }
-
-    pLine[0].g = getc( pFile );
-    pLine[0].b = getc( pFile );
-
-    if ( ( i = getc( pFile ) ) == EOF )
-        return false;
-
-    if ( pLine[0].g != 2 || pLine[0].b & 128 )
-    {
-        pLine[0].r = 2;
-        pLine[0].e = i;
-        return ReadOldColors( pFile, pLine + 1, count -1 );
-    }
-
-    if ( ( pLine[0].b << 8 | i ) != count )
-        return false;
-
-    for( i=0; i<4; ++i )
-    {
-        for( auto j=0; j<count; )
-        {
-            auto code = getc( pFile );
-            if ( code == EOF )
-                return false;
-
-            if ( 128 < code )
-            {
-                code &= 127;
-                auto val = getc( pFile );
-                while( code-- )
-                { pLine[j++].v[i] = val; }
-            }
-            else
-            {
-                while( code-- )
-                { pLine[j++].v[i] = getc( pFile ); }
-            }
-        }
-    }
-
-    return ( feof( pFile ) ? false : true );
-}
-
-//------------------------------------------------------------------------------------------
-//      HDRデータを読み取ります.
-//------------------------------------------------------------------------------------------
-bool ReadHdrData( FILE* pFile, const int32_t width, const int32_t height, float** ppPixels )
-{
-    auto pLines = new(std::nothrow) RGBE [ width * height ];
-    if ( pLines == nullptr )
-    { return false; }
-
-    auto pixels = new (std::nothrow) float [ width * height * 4 ];
-    if ( pixels == nullptr )
-    { return false; }
-
-    for( auto y=0; y<height; ++y )
-    {
-        if ( !ReadColor( pFile, pLines, width ) )
-        {
-            SafeDeleteArray( pLines );
-            SafeDeleteArray( pixels );
-            return false;
-        }
-
-        for( auto x =0; x < width; x++ )
-        {
-            auto pix = RGBEToVec3( pLines[x] );
-            auto idx = ( x * 4 ) + ( y * width *  4 );
-            pixels[idx + 0] = pix.x;
-            pixels[idx + 1] = pix.y;
-            pixels[idx + 2] = pix.z;
-            pixels[idx + 3] = 1.0f;
-        }
-    }
-
-    SafeDeleteArray( pLines );
-    (*ppPixels) = pixels;
+    auto ret = CreateResTextureFromTGAFile(pFile, resTexture);
+    fclose(pFile);
 
-    return true;
+    return ret;
 }
 
 //------------------------------------------------------------------------------------------
@@ -3418,40 +2460,13 @@ bool CreateResTextureFromHDRFileA( const char* filename, asdx::ResTexture& resTe
         return false;
     }
 
-    int32_t width    = 0;
-    int32_t height   = 0;
-    float   gamma    = 1.0f;
-    float   exposure = 1.0f;
-    if ( !ReadHdrHeader(pFile, width, height, gamma, exposure) )
-    {
-        ELOGA( "Error : LoadFromHDR() Failed. Header Read Failed. filename = %s", filename );
-        fclose(pFile);
-        return false;
-    }
-
-    resTexture.Dimension    = TEXTURE_DIMENSION_2D;
-    resTexture.Width        = uint32_t(width);
-    resTexture.Height       = uint32_t(height);
-    resTexture.Depth        = 0;
-    resTexture.Format       = DXGI_FORMAT_R32G32B32A32_FLOAT;
-    resTexture.MipMapCount  = 1;
-    resTexture.SurfaceCount = 1;
-    resTexture.pResources   = new SubResource[1];
-
-    resTexture.pResources[0].Width      = uint32_t(width);
-    resTexture.pResources[0].Height     = uint32_t(height);
-    resTexture.pResources[0].Pitch      = width * sizeof(float) * 4;
-    resTexture.pResources[0].SlicePitch = resTexture.pResources[0].Pitch * height;
+    auto ret = CreateResTextureFromHDRFile(pFile, resTexture);
+    fclose(pFile);
 
-    if ( !ReadHdrData(pFile, width, height, reinterpret_cast<float**>(&resTexture.pResources[0].pPixels)) )
-    {
-        ELOGA( "Error : LoadFromHDR() Failed. Data Read Failed. filename = %s", filename );
-        fclose(pFile);
-        return false;
-    }
+    if ( !ret )
+    { ELOGA( "Error : LoadFromHDR() Failed. filename = %s", filename ); }
 
-    fclose(pFile);
-    return true;
+    return ret;
 }
 
 //------------------------------------------------------------------------------------------
@@ -3464,44 +2479,17 @@ bool CreateResTextureFromHDRFileW(const wchar_t* filename, asdx::ResTexture& res
     auto err = _wfopen_s(&pFile, filename, L"rb" );
     if ( err != 0 )
     {
-        ELOGW( "Error : LoadFromHDR() Failed. File Open Failed. filename = %s", filename );
+        ELOGW( "Error : LoadFromHDR() Failed. File Open Failed. filename = %ls", filename );
         return false;
     }
 
-    int32_t width    = 0;
-    int32_t height   = 0;
-    float   gamma    = 1.0f;
-    float   exposure = 1.0f;
-    if ( !ReadHdrHeader(pFile, width, height, gamma, exposure) )
-    {
-        ELOGW( "Error : LoadFromHDR() Failed. Header Read Failed. filename = %s", filename );
-        fclose(pFile);
-        return false;
-    }
-
-    resTexture.Dimension    = TEXTURE_DIMENSION_2D;
-    resTexture.Width        = uint32_t(width);
-    resTexture.Height       = uint32_t(height);
-    resTexture.Depth        = 0;
-    resTexture.Format       = DXGI_FORMAT_R32G32B32A32_FLOAT;
-    resTexture.MipMapCount  = 1;
-    resTexture.SurfaceCount = 1;
-    resTexture.pResources   = new SubResource[1];
+    auto ret = CreateResTextureFromHDRFile(pFile, resTexture);
+    fclose(pFile);
 
-    resTexture.pResources[0].Width      = uint32_t(width);
-    resTexture.pResources[0].Height     = uint32_t(height);
-    resTexture.pResources[0].Pitch      = width * sizeof(float) * 4;
-    resTexture.pResources[0].SlicePitch = resTexture.pResources[0].Pitch * height;
+    if ( !ret )
+    { ELOGW( "Error : LoadFromHDR() Failed. filename = %ls", filename ); }
 
-    if ( !ReadHdrData(pFile, width, height, reinterpret_cast<float**>(&resTexture.pResources[0].pPixels)) )
-    {
-        ELOGW( "Error : LoadFromHDR() Failed. Data Read Failed. filename = %s", filename );
-        fclose(pFile);
-        return false;
-    }
-
-    fclose(pFile);
-    return true;
+    return ret;
 }
 
 
@@ -9,16 +9,20 @@
 //-----------------------------------------------------------------------------
 #include <atomic>
 #include <map>
+#include <unordered_map>
+#include <vector>
 #include <fnd/asdxFrameHeap.h>
 #include <fnd/asdxHash.h>
 #include <fnd/asdxList.h>
 #include <fnd/asdxStack.h>
 #include <fnd/asdxThreadPool.h>
 #include <fnd/asdxLogger.h>
+#include <fnd/asdxProfiler.h>
 #include <gfx/asdxCommandList.h>
 #include <gfx/asdxDisposer.h>
 #include <gfx/asdxGraphicsSystem.h>
 #include <rs/asdxPassGraph.h>
+#include <rs/asdxPassGraphCompiler.h>
 
 
 // パスで生成可能な最大リソース数.
@@ -43,29 +47,6 @@ static const auto RES_STATE_READ      = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RE
 static const auto RES_STATE_READ_DSV  = D3D12_RESOURCE_STATE_DEPTH_READ | RES_STATE_READ;
 
 
-///////////////////////////////////////////////////////////////////////////////
-// RESORUCE_INFO_FLAGS
-///////////////////////////////////////////////////////////////////////////////
-enum RESOURCE_INFO_FLAGS
-{
-    RESOURCE_INFO_FLAG_NONE                 = 0,            // 無し.
-    RESOURCE_INFO_FLAG_STATE_COMMON         = 0x1 << 0,     // 共通ステート.
-    RESOURCE_INFO_FLAG_STATE_READ           = 0x1 << 1,     // 読み取りステート.
-    RESOURCE_INFO_FLAG_STATE_WRITE          = 0x1 << 2,     // 書き込みステート.
-    RESOURCE_INFO_FLAG_BARRIER              = 0x1 << 3,     // パス実行前のバリア有効.
-};
-
-///////////////////////////////////////////////////////////////////////////////
-// SYNC_FLAGS
-///////////////////////////////////////////////////////////////////////////////
-enum SYNC_FLAGS
-{
-    SYNC_FLAG_NONE = 0,
-    SYNC_FLAG_GRAPHICS_TO_COMPUTE = 1,
-    SYNC_FLAG_COMPUTE_TO_GRAPHICS = 2,
-    SYNC_FLAG_COMPUTE_TO_COMPUTE  = 3,
-};
-
 //-----------------------------------------------------------------------------
 //      RTV用ステートを取得します.
 //-----------------------------------------------------------------------------
@@ -116,14 +97,31 @@ void CopyString(char* dst, const char* src, size_t maxSize)
     dst[size] = '\0';
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// Transition structure
-///////////////////////////////////////////////////////////////////////////////
-struct Transition
+//-----------------------------------------------------------------------------
+//      リソース構成設定のハッシュキーを計算します.
+//-----------------------------------------------------------------------------
+uint32_t CalcDescHash(const PassResourceDesc& value)
 {
-    RESOURCE_INFO_FLAGS     Before;
-    RESOURCE_INFO_FLAGS     After;
-};
+    // PassResource::Match() で比較するメンバーのみをキーとする.
+    struct Key
+    {
+        uint64_t    Width;
+        uint32_t    Height;
+        uint16_t    DepthOrArraySize;
+        uint16_t    MipLevels;
+        uint32_t    Dimension;
+        uint32_t    Format;
+    } key = {};
+
+    key.Width               = value.Width;
+    key.Height              = value.Height;
+    key.DepthOrArraySize    = value.DepthOrArraySize;
+    key.MipLevels           = value.MipLevels;
+    key.Dimension           = uint32_t(value.Dimension);
+    key.Format              = uint32_t(value.Format);
+
+    return CalcHash(reinterpret_cast<const uint8_t*>(&key), uint32_t(sizeof(key)));
+}
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -142,9 +140,12 @@ public:
     //=========================================================================
     // public variables.
     //=========================================================================
-    RESOURCE_INFO_FLAGS PrevState   = RESOURCE_INFO_FLAG_STATE_COMMON;  //!< 一時ステート
-    bool                PrevCompute = false;
- 
+    RESOURCE_INFO_FLAGS PrevState       = RESOURCE_INFO_FLAG_STATE_COMMON;  //!< 一時ステート
+    bool                PrevCompute     = false;
+    uint32_t            HashKey         = 0;    //!< 構成設定のハッシュキー.
+    uint64_t            LastUsedFrame   = 0;    //!< 最後に使用されたフレーム番号.
+    uint32_t            CompileIndex    = PassGraphCompiler::kInvalidIndex; //!< コンパイル時のリソース番号.
+
     //=========================================================================
     // public methods.
     //=========================================================================
@@ -628,10 +629,11 @@ public:
     //-------------------------------------------------------------------------
     D3D12_RESOURCE_BARRIER CreateBarrier
     (
-        RESOURCE_INFO_FLAGS prev,
-        RESOURCE_INFO_FLAGS next,
-        bool                compute,
-        uint32_t            subResource = 0
+        RESOURCE_INFO_FLAGS             prev,
+        RESOURCE_INFO_FLAGS             next,
+        bool                            compute,
+        D3D12_RESOURCE_BARRIER_FLAGS    flags       = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+        uint32_t                        subResource = 0
     ) const
     {
         D3D12_RESOURCE_BARRIER result = {};
@@ -647,6 +649,7 @@ public:
             result.Transition.StateBefore = before;
             result.Transition.StateAfter  = after;
             result.Transition.Subresource = subResource;
+            result.Flags                  = flags;
 
         }
         else if (m_Desc.Usage & PASS_RESOURCE_USAGE_DSV)
@@ -660,6 +663,7 @@ public:
             result.Transition.StateBefore = before;
             result.Transition.StateAfter  = after;
             result.Transition.Subresource = subResource;
+            result.Flags                  = flags;
         }
         else if (m_Desc.Usage & PASS_RESOURCE_USAGE_UAV)
         {
@@ -681,6 +685,7 @@ public:
                 result.Transition.StateBefore = before;
                 result.Transition.StateAfter  = after;
                 result.Transition.Subresource = subResource;
+                result.Flags                  = flags;
             }
         }
 
@@ -1014,7 +1019,18 @@ public:
     //=========================================================================
     // public variables.
     //=========================================================================
-    /* NOTHING */
+    static constexpr uint64_t kRetainFrameCount = 1;    //!< 追い出し対象外とする経過フレーム数.
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Counter structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Counter
+    {
+        uint32_t    Hit     = 0;    //!< ヒット数.
+        uint32_t    Miss    = 0;    //!< ミス数.
+        uint32_t    Create  = 0;    //!< 生成数.
+        uint32_t    Evict   = 0;    //!< 追い出し数.
+    };
 
     //=========================================================================
     // public methods.
@@ -1040,7 +1056,12 @@ public:
     void Init(uint32_t capacity)
     {
         m_Capacity   = capacity;
+        m_FrameIndex = 1;
+        m_Counter       = Counter();
+        m_PrevCounter   = Counter();
         m_Cache.Clear();
+        m_Buckets.clear();
+        m_Buckets.reserve(capacity);
     }
 
     //-------------------------------------------------------------------------
@@ -1048,27 +1069,36 @@ public:
     //-------------------------------------------------------------------------
     PassResource* GetOrCreate(const PassResourceDesc& value, RenderPass* producer)
     {
+        auto key = CalcDescHash(value);
+
         // LRUキャッシュアルゴリズム.
         PassResource* node;
-        if (Contains(value, &node))
+        if (Contains(key, value, &node))
         {
+            m_Counter.Hit++;
             Remove(node);
             PushBack(node);
         }
-        else if(m_Cache.GetCount() < m_Capacity)
-        {
-            node = CreateResource(value, producer);
-            PushBack(node);
-        }
         else
         {
-            auto head = PopFront();
-            m_Dispoer.Push(head);
+            m_Counter.Miss++;
+
+            // 容量オーバーの場合は最も古いリソースを追い出す.
+            // 直近フレームで使用されたリソースは追い出さずに容量超過を許容し，FrameSync()で縮退させる.
+            if (m_Cache.GetCount() >= m_Capacity)
+            { EvictHead(); }
 
             node = CreateResource(value, producer);
+            if (node == nullptr)
+            { return nullptr; }
+
+            node->HashKey = key;
+            m_Buckets[key].push_back(node);
             PushBack(node);
+            m_Counter.Create++;
         }
 
+        node->LastUsedFrame = m_FrameIndex;
         return node;
     }
 
@@ -1082,15 +1112,18 @@ public:
         while(itr != nullptr)
         {
             auto node = itr;
+            auto hasNext = itr->HasNext();
+            if (hasNext)
+            { itr = itr->List<PassResource>::Node::GetNext(); }
+
             m_Dispoer.Push(node);
 
-            if (!itr->HasNext())
+            if (!hasNext)
             { break; }
-
-            itr = itr->List<PassResource>::Node::GetNext();
         }
 
         m_Cache.Clear();
+        m_Buckets.clear();
 
         // 強制破棄.
         m_Dispoer.Clear();
@@ -1100,7 +1133,32 @@ public:
     //! @brief      フレーム同期を行い，遅延解放を行います.
     //-------------------------------------------------------------------------
     void FrameSync()
-    { m_Dispoer.FrameSync(); }
+    {
+        // 容量超過分を縮退させる.
+        while(m_Cache.GetCount() > m_Capacity)
+        {
+            if (!EvictHead())
+            { break; }
+        }
+
+        m_Dispoer.FrameSync();
+
+        m_PrevCounter = m_Counter;
+        m_Counter     = Counter();
+        m_FrameIndex++;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      直前フレームのカウンターを取得します.
+    //-------------------------------------------------------------------------
+    const Counter& GetCounter() const
+    { return m_PrevCounter; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      常駐リソース数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetResidentCount() const
+    { return uint32_t(m_Cache.GetCount()); }
 
     //-------------------------------------------------------------------------
     //! @brief      リスト先頭ポインタを取得します.
@@ -1119,8 +1177,12 @@ private:
     // private variables.
     //=========================================================================
     Disposer<PassResource>  m_Dispoer;
-    uint32_t                m_Capacity = 0;
+    uint32_t                m_Capacity      = 0;
+    uint64_t                m_FrameIndex    = 1;
     List<PassResource>      m_Cache;
+    Counter                 m_Counter;
+    Counter                 m_PrevCounter;
+    std::unordered_map<uint32_t, std::vector<PassResource*>>    m_Buckets;
 
     //=========================================================================
     // private methods.
@@ -1128,25 +1190,70 @@ private:
 
     //-------------------------------------------------------------------------
     //! @brief      構成設定が合致するリソースが含まれるかチェックします.
+    //!
+    //! @note       今フレームで既に割り当て済みのリソースはエイリアスになるため対象外とします.
     //-------------------------------------------------------------------------
-    bool Contains(const PassResourceDesc& value, PassResource** node)
+    bool Contains(uint32_t key, const PassResourceDesc& value, PassResource** node)
     {
-        auto itr = m_Cache.GetHead();
-        while(itr != nullptr)
+        auto bucket = m_Buckets.find(key);
+        if (bucket == m_Buckets.end())
+        { return false; }
+
+        for(auto& itr : bucket->second)
         {
+            if (itr->LastUsedFrame == m_FrameIndex)
+            { continue; }
+
+            // ハッシュ衝突を考慮して構成設定も比較する.
             if (itr->Match(value))
             {
                 *node = itr;
                 return true;
             }
+        }
 
-            if (!itr->HasNext())
-            { break; }
+        return false;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      最も古いリソースを追い出します.
+    //!
+    //! @retval true    追い出しました.
+    //! @retval false   直近で使用されているため追い出しませんでした.
+    //-------------------------------------------------------------------------
+    bool EvictHead()
+    {
+        auto head = m_Cache.GetHead();
+        if (head == nullptr)
+        { return false; }
+
+        // 先頭が最も古いので，先頭が対象外なら全て対象外.
+        if (head->LastUsedFrame + kRetainFrameCount >= m_FrameIndex)
+        { return false; }
 
-            itr = itr->List<PassResource>::Node::GetNext();
+        auto node = PopFront();
+
+        auto bucket = m_Buckets.find(node->HashKey);
+        if (bucket != m_Buckets.end())
+        {
+            auto& items = bucket->second;
+            for(size_t i=0; i<items.size(); ++i)
+            {
+                if (items[i] == node)
+                {
+                    items[i] = items.back();
+                    items.pop_back();
+                    break;
+                }
+            }
+
+            if (items.empty())
+            { m_Buckets.erase(bucket); }
         }
 
-        return false;
+        m_Dispoer.Push(node);
+        m_Counter.Evict++;
+        return true;
     }
 
     //-------------------------------------------------------------------------
@@ -1179,7 +1286,7 @@ private:
         {
             ELOG("Error : PassResource::Init() Failed.");
             assert(false);
-            resource->Term();
+            resource->Release();
             return nullptr;
         }
 
@@ -1304,13 +1411,13 @@ public:
     {
         PassResource*       Resource        = nullptr;
         uint8_t             Flags           = RESOURCE_INFO_FLAG_NONE;
-        Transition          Barrier         = {};
     };
 
     //=========================================================================
     // public variables.
     //=========================================================================
     char            m_Tag[64]       = {};
+    const char*     m_ProfileName   = nullptr;  //!< プロファイラのゾーン名(計測していない場合は nullptr).
     PassSetup       m_Setup         = nullptr;
     PassExecute     m_Execute       = nullptr;
     uint8_t         m_SyncFlag      = SYNC_FLAG_NONE;
@@ -1319,6 +1426,10 @@ public:
     uint8_t         m_ClearCount    = 0;
     ResourceHolder  m_Holders    [MAX_PASS_RESOURCE_COUNT] = {};
     ClearInfo       m_Clears     [MAX_PASS_RESOURCE_COUNT] = {};
+    const D3D12_RESOURCE_BARRIER*   m_PreBarriers       = nullptr;  //!< 実行前に発行するバリア.
+    uint32_t                        m_PreBarrierCount   = 0;        //!< 実行前に発行するバリア数.
+    const D3D12_RESOURCE_BARRIER*   m_PostBarriers      = nullptr;  //!< 実行後に発行するバリア.
+    uint32_t                        m_PostBarrierCount  = 0;        //!< 実行後に発行するバリア数.
 
     //=========================================================================
     // public methods.
@@ -1355,23 +1466,13 @@ public:
 
     //-------------------------------------------------------------------------
     //! @brief      リソースバリアを設定します.
+    //!
+    //! @note       バリアは PassGraph::Compile() で構築済みなので，まとめて1回で発行します.
     //-------------------------------------------------------------------------
-    void ResourceBarrier(ID3D12GraphicsCommandList6* pCmd)
+    void ResourceBarrier(ID3D12GraphicsCommandList6* pCmd, const D3D12_RESOURCE_BARRIER* pBarriers, uint32_t count)
     {
-        D3D12_RESOURCE_BARRIER barriers[MAX_PASS_RESOURCE_COUNT] = {};
-        auto count = 0u;
-        for(auto i=0u; i<m_ResourceCount; ++i)
-        {
-            if (m_Holders[i].Flags & RESOURCE_INFO_FLAG_BARRIER)
-            {
-                auto transition = m_Holders[i].Barrier;
-                barriers[count] = m_Holders[i].Resource->CreateBarrier(
-                    transition.Before, transition.After, m_AsyncCompute);
-                count++;
-            }
-        }
-
-        pCmd->ResourceBarrier(count, barriers);
+        if (count > 0)
+        { pCmd->ResourceBarrier(count, pBarriers); }
     }
 
     //-------------------------------------------------------------------------
@@ -1400,10 +1501,12 @@ public:
     //-------------------------------------------------------------------------
     void Run() override
     {
+        ASDX_PROFILE_SCOPE((m_ProfileName != nullptr) ? m_ProfileName : "RenderPass");
+
         PassGraphContext context(m_CommandList);
 
         // リソースバリア設定.
-        ResourceBarrier(m_CommandList);
+        ResourceBarrier(m_CommandList, m_PreBarriers, m_PreBarrierCount);
 
         // クリア処理.
         ClearViews(m_CommandList);
@@ -1411,6 +1514,11 @@ public:
         // パスを実行.
         if (m_Execute != nullptr)
         { m_Execute(&context); }
+
+        // 分割バリアの開始と，後続パスから前倒ししたバリアを設定.
+        ResourceBarrier(m_CommandList, m_PostBarriers, m_PostBarrierCount);
+
+        m_CommandList->Close();
     }
 
 private:
@@ -1481,6 +1589,12 @@ public:
     //-------------------------------------------------------------------------
     WaitPoint Execute(const WaitPoint& waitPoint) override;
 
+    //-------------------------------------------------------------------------
+    //! @brief      直前に実行したフレームの統計情報を取得します.
+    //-------------------------------------------------------------------------
+    PassGraphStats GetStats() const override
+    { return m_Stats; }
+
     //-------------------------------------------------------------------------
     //! @brief      ブラックボードを取得します.
     //-------------------------------------------------------------------------
@@ -1524,6 +1638,11 @@ private:
     CommandQueue*           m_GraphicsQueue         = nullptr;
     CommandQueue*           m_ComputeQueue          = nullptr;
     Blackboard              m_Blackboard;
+    PassGraphStats          m_Stats;
+    PassGraphCompiler       m_Compiler;
+    std::vector<RenderPass*>    m_CompilePasses;
+    std::vector<PassResource*>  m_CompileResources;
+    std::vector<D3D12_RESOURCE_BARRIER> m_Barriers;
 
     //=========================================================================
     // private methods.
@@ -1778,6 +1897,10 @@ bool PassGraph::Init(const PassGraphDesc& desc)
     m_GraphicsQueue = desc.pGraphicsQueue;
     m_ComputeQueue  = desc.pComputeQueue;
 
+    m_Compiler.SetReorder(desc.EnableReorder);
+    m_CompilePasses   .reserve(m_MaxPassCount);
+    m_CompileResources.reserve(desc.MaxResourceCount);
+
     return true;
 }
 
@@ -1804,6 +1927,10 @@ bool PassGraph::AddPass(const char* tag, PassSetup setup, PassExecute execute)
     pass->m_Execute = execute;
     CopyString(pass->m_Tag, tag, 63);
 
+    // タグはフレーム毎に破棄されるので, 計測中だけ寿命の長い文字列に変換しておく.
+    auto& profiler = Profiler::Instance();
+    pass->m_ProfileName = profiler.IsCapturing() ? profiler.InternName(pass->m_Tag) : nullptr;
+
     m_PassList.PushBack(pass);
 
     return true;
@@ -1814,6 +1941,8 @@ bool PassGraph::AddPass(const char* tag, PassSetup setup, PassExecute execute)
 //-----------------------------------------------------------------------------
 void PassGraph::Compile()
 {
+    ASDX_PROFILE_SCOPE("PassGraph::Compile");
+
     // 各パスについて処理.
     {
         auto itr = m_PassList.GetHead();
@@ -1829,129 +1958,99 @@ void PassGraph::Compile()
         }
     }
 
-    // 参照カウントゼロのリソースを格納するスタック. 
-    Stack<PassResource> stack;
-
-    // 参照カウントがゼロのリソースを見つける.
+    // パスとリソースアクセスをコンパイラに登録.
+    // リソース番号は初出順に振るので，同じトポロジーなら同じキーになる.
+    m_Compiler.Begin();
+    m_CompilePasses   .clear();
+    m_CompileResources.clear();
     {
-        auto itr = m_Registry.GetHead();
+        auto itr = m_PassList.GetHead();
         while(itr != nullptr)
         {
-            if (itr->GetRefCount() == 0)
+            m_Compiler.AddPass(CalcHash(itr->m_Tag), itr->m_AsyncCompute);
+            m_CompilePasses.push_back(itr);
+
+            for(auto i=0u; i<itr->m_ResourceCount; ++i)
             {
-                // スタックに積む.
-                stack.Push(itr);
+                auto resource = itr->m_Holders[i].Resource;
+                if (resource->CompileIndex == PassGraphCompiler::kInvalidIndex)
+                {
+                    resource->CompileIndex = m_Compiler.AddResource(
+                        resource->PrevState, resource->PrevCompute, resource->IsImport());
+                    m_CompileResources.push_back(resource);
+                }
+
+                m_Compiler.AddAccess(
+                    resource->CompileIndex,
+                    RESOURCE_INFO_FLAGS(itr->m_Holders[i].Flags));
             }
 
             if (!itr->HasNext())
             { break; }
 
-            itr = itr->List<PassResource>::Node::GetNext();
+            itr = itr->GetNext();
         }
     }
 
-    // スタックが空でない場合
-    while(!stack.IsEmpty())
+    // トポロジーが前回と同じならキャッシュ済みの実行計画が返る.
+    auto& plan = m_Compiler.Compile();
+
+    // バリアはリソースの実体に依存するため，キャッシュヒット時も毎フレーム構築する.
+    m_Barriers.resize(plan.Barriers.size());
+    for(auto i=0u; i<plan.Barriers.size(); ++i)
     {
-        // リソースをpopし，生成したproducerの参照カウントを下げる.
-        auto resource = stack.Pop();
-        auto producer = resource->GetProducer();
-        producer->Decrement();
+        auto& barrier = plan.Barriers[i];
 
-        // producerの参照カウントが0の場合.
-        if (producer->GetRefCount() == 0)
-        {
-            // 読み取りするリソースの参照カウントを下げる.
-            for(auto i=0u; i<producer->m_ResourceCount; ++i)
-            {
-                if (producer->m_Holders[i].Flags & RESOURCE_INFO_FLAG_STATE_READ)
-                {
-                    auto readResource = producer->m_Holders[i].Resource;
-                    readResource->Decrement();
+        auto flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+        if (barrier.Split == PASS_BARRIER_SPLIT_BEGIN_ONLY)
+        { flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY; }
+        else if (barrier.Split == PASS_BARRIER_SPLIT_END_ONLY)
+        { flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY; }
 
-                    // 参照カウントがゼロのときにそれらのリソースをスタックに積む.
-                    if (readResource->GetRefCount() == 0)
-                    { stack.Push(readResource); }
-                }
-            }
-        }
+        // バリアはグラフィックスステップにのみ配置される.
+        m_Barriers[i] = m_CompileResources[barrier.Resource]->CreateBarrier(
+            barrier.Before, barrier.After, false, flags);
     }
 
-    // バリアを解決.
+    // 実行順にパスリストを組み直す.
+    m_PassList.Clear();
+    for(auto& step : plan.Steps)
     {
-        auto itr = m_PassList.GetHead();
-        while(itr != nullptr)
+        RenderPass* pass = nullptr;
+        if (step.Pass == PassGraphCompiler::kInvalidIndex)
         {
-            if (itr->GetRefCount() == 0)
-            {
-                auto node = itr;
-                if (!itr->HasNext())
-                { break; }
-
-                itr = itr->GetNext();
-            }
-
-            auto count = itr->m_ResourceCount;
-
-            // バリアだけを張るグラフィックスパスを直前に追加する.
-            if (itr->m_AsyncCompute)
-            {
-                auto pass = FrameAlloc<RenderPass>();
-                pass->m_AsyncCompute    = false;
-                pass->m_ResourceCount   = count;
-                pass->m_SyncFlag        = SYNC_FLAG_GRAPHICS_TO_COMPUTE;
-
-                for(auto i=0u; i<count; ++i)
-                {
-                    auto resource  = itr->m_Holders[i].Resource;
-                    auto prevState = resource->PrevState;
-                    auto nextState = RESOURCE_INFO_FLAGS(itr->m_Holders[i].Flags);
-
-                    pass->m_Holders[i].Flags            = RESOURCE_INFO_FLAG_BARRIER;
-                    pass->m_Holders[i].Resource         = resource;
-                    pass->m_Holders[i].Barrier.Before   = prevState;
-                    pass->m_Holders[i].Barrier.After    = nextState;
-
-                    resource->PrevState     = nextState;
-                    resource->PrevCompute   = false;
-                }
-
-                // コンピュートパスの前に追加.
-                m_PassList.InsertAfter(itr->GetPrev(), pass);
-            }
-
-            for(auto i=0u; i<count; ++i)
-            {
-                auto resource  = itr->m_Holders[i].Resource;
-                auto prevState = resource->PrevState;
-                auto nextState = RESOURCE_INFO_FLAGS(itr->m_Holders[i].Flags);
-
-                // リソースを使っていた前パスがコンピュートなら同期をとる.
-                if (resource->PrevCompute && !itr->m_AsyncCompute)
-                { itr->m_SyncFlag = SYNC_FLAG_COMPUTE_TO_GRAPHICS; }
-                else if (resource->PrevCompute && itr->m_AsyncCompute)
-                { itr->m_SyncFlag = SYNC_FLAG_COMPUTE_TO_COMPUTE; }
-
-                // ステートが違っていたらバリアを張る.
-                if (prevState != nextState)
-                {
-                    itr->m_Holders[i].Flags |= RESOURCE_INFO_FLAG_BARRIER;
-                    itr->m_Holders[i].Barrier.Before = prevState;
-                    itr->m_Holders[i].Barrier.After  = nextState;
+            // バリアだけを張るグラフィックスパス.
+            pass = FrameAlloc<RenderPass>();
+            CopyString(pass->m_Tag, "BarrierOnly", 63);
+        }
+        else
+        { pass = m_CompilePasses[step.Pass]; }
 
-                    // 一時ステート更新.
-                    resource->PrevState   = nextState;
-                    resource->PrevCompute = itr->m_AsyncCompute;
-                }
-            }
+        pass->m_AsyncCompute        = step.AsyncCompute;
+        pass->m_SyncFlag            = step.SyncFlag;
+        pass->m_PreBarriers         = m_Barriers.data() + step.PreBarrierOffset;
+        pass->m_PreBarrierCount     = step.PreBarrierCount;
+        pass->m_PostBarriers        = m_Barriers.data() + step.PostBarrierOffset;
+        pass->m_PostBarrierCount    = step.PostBarrierCount;
 
-            if (!itr->HasNext())
-            { break; }
+        m_PassList.PushBack(pass);
+    }
 
-            // 次のパスへ.
-            itr = itr->GetNext();
-        }
+    // 次フレームの開始ステートを更新.
+    for(auto i=0u; i<m_CompileResources.size(); ++i)
+    {
+        auto resource = m_CompileResources[i];
+        resource->PrevState     = plan.FinalStates[i];
+        resource->PrevCompute   = !!plan.FinalCompute[i];
+        resource->CompileIndex  = PassGraphCompiler::kInvalidIndex;
     }
+
+    m_Stats.CompiledPassCount   = uint32_t(plan.Steps.size());
+    m_Stats.CulledPassCount     = plan.CulledCount;
+    m_Stats.CompileCacheHit     = m_Compiler.IsCacheHit();
+    m_Stats.BarrierCount        = uint32_t(plan.Barriers.size());
+    m_Stats.SplitBarrierCount   = plan.SplitCount;
+    m_Stats.BarrierBatchCount   = plan.BatchCount;
 }
 
 //-----------------------------------------------------------------------------
@@ -1959,6 +2058,8 @@ void PassGraph::Compile()
 //-----------------------------------------------------------------------------
 WaitPoint PassGraph::Execute(const WaitPoint& waitPoint)
 {
+    ASDX_PROFILE_SCOPE("PassGraph::Execute");
+
     // コマンドリストをリセット.
     for(auto i=0u; i<m_MaxPassCount; ++i)
     {
@@ -1970,22 +2071,16 @@ WaitPoint PassGraph::Execute(const WaitPoint& waitPoint)
     auto graphisIndex = 0u;
     auto computeIndex = 0u;
 
+    // カリング済みのパスは Compile() でリストから外れている.
     auto itr = m_PassList.GetHead();
     while(itr != nullptr)
     {
-        // カリング.
-        if (itr->GetRefCount() == 0)
-        {
-            if (!itr->HasNext())
-            { break; }
-
-            itr = itr->GetNext();
-        }
-
         // コマンドリスト割り当て
         ID3D12GraphicsCommandList6* pCmd = nullptr;
         if (!itr->m_AsyncCompute)
         {
+            // バリア専用パスも割り当てるため，パス数に余裕を持たせておくこと.
+            assert(graphisIndex < m_MaxPassCount);
             pCmd = m_GraphicsCommandLists[graphisIndex].GetCommandList();
             graphisIndex++;
         }
@@ -2020,61 +2115,37 @@ WaitPoint PassGraph::Execute(const WaitPoint& waitPoint)
     WaitPoint computeWaitPoint  = {};
 
     // コマンドキューに積む.
-    auto ir = m_PassList.GetHead();
+    itr = m_PassList.GetHead();
     while(itr != nullptr)
     {
         auto pCmd = itr->GetCommandList();
 
-        switch(itr->m_SyncFlag)
+        if (itr->m_AsyncCompute)
         {
-            case SYNC_FLAG_NONE:
+            // グラフィックスキューの完了を待機.
+            if (itr->m_SyncFlag == SYNC_FLAG_GRAPHICS_TO_COMPUTE)
             {
-                // コマンドリスト実行.
-                m_GraphicsQueue->Execute(1, &pCmd);
-            }
-            break;
-
-            case SYNC_FLAG_GRAPHICS_TO_COMPUTE:
-            {
-                if (!graphicsWaitPoint.IsValid())
-                { graphicsWaitPoint = m_GraphicsQueue->Signal(); }
-
-                // グラフィックスキューの完了を待機.
+                graphicsWaitPoint = m_GraphicsQueue->Signal();
                 m_ComputeQueue->Wait(graphicsWaitPoint);
-
-                // コマンドリスト実行.
-                m_ComputeQueue->Execute(1, &pCmd);
-
-                // 待機点を取得.
-                computeWaitPoint = m_ComputeQueue->Signal();
             }
-            break;
-
-            case SYNC_FLAG_COMPUTE_TO_GRAPHICS:
-            {
-                if (!computeWaitPoint.IsValid())
-                { computeWaitPoint = m_ComputeQueue->Signal(); }
 
-                // コンピュートキューの完了を待機.
-                m_GraphicsQueue->Wait(computeWaitPoint);
+            // コマンドリスト実行.
+            m_ComputeQueue->Execute(1, &pCmd);
 
-                // コマンドリスト実行.
-                m_GraphicsQueue->Execute(1, &pCmd);
-            }
-            break;
-
-            case SYNC_FLAG_COMPUTE_TO_COMPUTE:
+            // 待機点を取得.
+            computeWaitPoint = m_ComputeQueue->Signal();
+        }
+        else
+        {
+            // コンピュートキューの完了を待機.
+            if (itr->m_SyncFlag == SYNC_FLAG_COMPUTE_TO_GRAPHICS)
             {
-                // 直前に絶対実行しているので待機点があるはず.
                 assert(computeWaitPoint.IsValid());
-
-                // コンピュートキューの完了を待機.
-                m_ComputeQueue->Wait(computeWaitPoint);
-
-                // コマンドリスト実行.
-                m_ComputeQueue->Execute(1, &pCmd);
+                m_GraphicsQueue->Wait(computeWaitPoint);
             }
-            break;
+
+            // コマンドリスト実行.
+            m_GraphicsQueue->Execute(1, &pCmd);
         }
 
         if (!itr->HasNext())
@@ -2088,6 +2159,17 @@ WaitPoint PassGraph::Execute(const WaitPoint& waitPoint)
     // パスをクリア.
     m_PassList.Clear();
 
+    // リソースキャッシュの遅延解放と統計情報の更新.
+    m_Registry.FrameSync();
+    {
+        auto& counter = m_Registry.GetCounter();
+        m_Stats.ResourceHitCount        = counter.Hit;
+        m_Stats.ResourceMissCount       = counter.Miss;
+        m_Stats.ResourceCreateCount     = counter.Create;
+        m_Stats.ResourceEvictCount      = counter.Evict;
+        m_Stats.ResourceResidentCount   = m_Registry.GetResidentCount();
+    }
+
     // ダブルバッファリング.
     m_BufferIndex = (m_BufferIndex + 1) & 0x1;
 
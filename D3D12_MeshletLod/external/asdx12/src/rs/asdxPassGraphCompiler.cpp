@@ -0,0 +1,676 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxPassGraphCompiler.cpp
+// Desc : Pass Graph Compiler.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstddef>
+#include <cassert>
+#include <fnd/asdxHash.h>
+#include <rs/asdxPassGraphCompiler.h>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// QUEUE_TYPE enum
+///////////////////////////////////////////////////////////////////////////////
+enum QUEUE_TYPE
+{
+    QUEUE_TYPE_NONE,        // 今フレーム未使用.
+    QUEUE_TYPE_GRAPHICS,    // グラフィックスキュー.
+    QUEUE_TYPE_COMPUTE,     // コンピュートキュー.
+};
+
+} // namespace
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// PassGraphCompiler class
+///////////////////////////////////////////////////////////////////////////////
+
+// C++14 では ODR 使用される static constexpr メンバーに定義が必要.
+constexpr uint32_t PassGraphCompiler::kInvalidIndex;
+constexpr uint32_t PassGraphCompiler::kMaxCacheCount;
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+PassGraphCompiler::PassGraphCompiler()
+{
+    // 実行計画への参照を保持させるため，再確保が起きないようにしておく.
+    m_Cache.reserve(kMaxCacheCount);
+}
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+PassGraphCompiler::~PassGraphCompiler()
+{ ClearCache(); }
+
+//-----------------------------------------------------------------------------
+//      パスの並び替えを有効にするかどうか設定します.
+//-----------------------------------------------------------------------------
+void PassGraphCompiler::SetReorder(bool value)
+{ m_Reorder = value; }
+
+//-----------------------------------------------------------------------------
+//      グラフの入力を開始します.
+//-----------------------------------------------------------------------------
+void PassGraphCompiler::Begin()
+{
+    m_Passes   .clear();
+    m_Accesses .clear();
+    m_Resources.clear();
+    m_CacheHit = false;
+}
+
+//-----------------------------------------------------------------------------
+//      リソースを追加します.
+//-----------------------------------------------------------------------------
+uint32_t PassGraphCompiler::AddResource(RESOURCE_INFO_FLAGS state, bool compute, bool imported)
+{
+    Resource resource;
+    resource.State      = state;
+    resource.Compute    = compute;
+    resource.Imported   = imported;
+
+    m_Resources.push_back(resource);
+    return uint32_t(m_Resources.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      パスを追加します.
+//-----------------------------------------------------------------------------
+uint32_t PassGraphCompiler::AddPass(uint32_t tag, bool asyncCompute)
+{
+    Pass pass;
+    pass.Tag            = tag;
+    pass.AsyncCompute   = asyncCompute;
+    pass.AccessOffset   = uint32_t(m_Accesses.size());
+    pass.AccessCount    = 0;
+
+    m_Passes.push_back(pass);
+    return uint32_t(m_Passes.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      直前に追加したパスにリソースアクセスを追加します.
+//-----------------------------------------------------------------------------
+void PassGraphCompiler::AddAccess(uint32_t resource, RESOURCE_INFO_FLAGS access)
+{
+    assert(!m_Passes.empty());
+    assert(resource < m_Resources.size());
+
+    Access value;
+    value.Resource  = resource;
+    value.Flags     = access;
+
+    m_Accesses.push_back(value);
+    m_Passes.back().AccessCount++;
+}
+
+//-----------------------------------------------------------------------------
+//      コンパイルします.
+//-----------------------------------------------------------------------------
+const PassGraphPlan& PassGraphCompiler::Compile()
+{
+    BuildKey();
+    m_Hash = CalcHash64(m_Key.data(), m_Key.size() * sizeof(uint32_t));
+    m_Counter++;
+
+    // トポロジーが一致するキャッシュがあれば再利用.
+    for(auto i=0u; i<m_Cache.size(); ++i)
+    {
+        auto& entry = m_Cache[i];
+        if (entry.Hash != m_Hash)
+        { continue; }
+
+        // ハッシュ衝突を考慮してキー全体を比較する.
+        if (entry.Key != m_Key)
+        { continue; }
+
+        entry.LastUsed = m_Counter;
+        m_Current  = i;
+        m_CacheHit = true;
+        return entry.Plan;
+    }
+
+    // 格納先を決定. 満杯の場合は最も長く使われていないエントリーを再利用.
+    auto index = uint32_t(m_Cache.size());
+    if (m_Cache.size() < kMaxCacheCount)
+    { m_Cache.emplace_back(); }
+    else
+    {
+        index = 0;
+        for(auto i=1u; i<m_Cache.size(); ++i)
+        {
+            if (m_Cache[i].LastUsed < m_Cache[index].LastUsed)
+            { index = i; }
+        }
+    }
+
+    auto& entry = m_Cache[index];
+    entry.Hash      = m_Hash;
+    entry.LastUsed  = m_Counter;
+    entry.Key       = m_Key;
+
+    std::vector<uint8_t>  alive;
+    std::vector<uint32_t> order;
+    Cull(alive);
+    Schedule(alive, order);
+    Resolve(order, entry.Plan);
+    entry.Plan.CulledCount = uint32_t(m_Passes.size() - order.size());
+
+    m_Current  = index;
+    m_CacheHit = false;
+    return entry.Plan;
+}
+
+//-----------------------------------------------------------------------------
+//      直前のコンパイルがキャッシュヒットしたかどうか.
+//-----------------------------------------------------------------------------
+bool PassGraphCompiler::IsCacheHit() const
+{ return m_CacheHit; }
+
+//-----------------------------------------------------------------------------
+//      直前にコンパイルしたグラフのハッシュ値を取得します.
+//-----------------------------------------------------------------------------
+uint64_t PassGraphCompiler::GetHash() const
+{ return m_Hash; }
+
+//-----------------------------------------------------------------------------
+//      コンパイルキャッシュを破棄します.
+//-----------------------------------------------------------------------------
+void PassGraphCompiler::ClearCache()
+{
+    m_Cache.clear();
+    m_Current  = kInvalidIndex;
+    m_CacheHit = false;
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュキーを構築します.
+//-----------------------------------------------------------------------------
+void PassGraphCompiler::BuildKey()
+{
+    // リソース番号は初出順に振られるため，ポインタに依存せずトポロジーを表現できる.
+    // フレーム開始時のステートもバリアの解決結果に影響するためキーに含める.
+    m_Key.clear();
+    m_Key.push_back(m_Reorder ? 1 : 0);
+
+    m_Key.push_back(uint32_t(m_Resources.size()));
+    for(auto& resource : m_Resources)
+    {
+        auto value = uint32_t(resource.State);
+        if (resource.Compute)
+        { value |= 0x100; }
+        if (resource.Imported)
+        { value |= 0x200; }
+
+        m_Key.push_back(value);
+    }
+
+    m_Key.push_back(uint32_t(m_Passes.size()));
+    for(auto& pass : m_Passes)
+    {
+        m_Key.push_back(pass.Tag);
+        m_Key.push_back(pass.AsyncCompute ? 1 : 0);
+        m_Key.push_back(pass.AccessCount);
+
+        for(auto i=0u; i<pass.AccessCount; ++i)
+        {
+            auto& access = m_Accesses[pass.AccessOffset + i];
+            m_Key.push_back(access.Resource);
+            m_Key.push_back(uint32_t(access.Flags));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      参照されないパスをカリングします.
+//-----------------------------------------------------------------------------
+void PassGraphCompiler::Cull(std::vector<uint8_t>& alive) const
+{
+    auto passCount     = uint32_t(m_Passes.size());
+    auto resourceCount = uint32_t(m_Resources.size());
+
+    alive.assign(passCount, 1);
+
+    // パスの参照カウントは書き込み数，リソースの参照カウントは読み取り数.
+    // 書き込みを持たないパスは副作用があるものとみなしてカリングしない.
+    std::vector<uint32_t>               passRef    (passCount, 0);
+    std::vector<uint32_t>               resourceRef(resourceCount, 0);
+    std::vector<std::vector<uint32_t>>  writers    (resourceCount);
+
+    for(auto i=0u; i<passCount; ++i)
+    {
+        auto& pass = m_Passes[i];
+        for(auto j=0u; j<pass.AccessCount; ++j)
+        {
+            auto& access = m_Accesses[pass.AccessOffset + j];
+            if (access.Flags & RESOURCE_INFO_FLAG_STATE_WRITE)
+            {
+                passRef[i]++;
+                writers[access.Resource].push_back(i);
+            }
+            if (access.Flags & RESOURCE_INFO_FLAG_STATE_READ)
+            { resourceRef[access.Resource]++; }
+        }
+    }
+
+    // インポートリソースは外部で使用されるため常に参照されているものとする.
+    for(auto i=0u; i<resourceCount; ++i)
+    {
+        if (m_Resources[i].Imported)
+        { resourceRef[i]++; }
+    }
+
+    // 参照カウントゼロのリソースを格納するスタック.
+    std::vector<uint32_t> stack;
+    stack.reserve(resourceCount);
+    for(auto i=0u; i<resourceCount; ++i)
+    {
+        if (resourceRef[i] == 0)
+        { stack.push_back(i); }
+    }
+
+    while(!stack.empty())
+    {
+        // リソースをpopし，書き込みパスの参照カウントを下げる.
+        auto resource = stack.back();
+        stack.pop_back();
+
+        for(auto writer : writers[resource])
+        {
+            if (!alive[writer])
+            { continue; }
+
+            passRef[writer]--;
+            if (passRef[writer] != 0)
+            { continue; }
+
+            // 書き込みパスが不要になったら，読み取りリソースの参照カウントを下げる.
+            alive[writer] = 0;
+
+            auto& pass = m_Passes[writer];
+            for(auto j=0u; j<pass.AccessCount; ++j)
+            {
+                auto& access = m_Accesses[pass.AccessOffset + j];
+                if (!(access.Flags & RESOURCE_INFO_FLAG_STATE_READ))
+                { continue; }
+
+                resourceRef[access.Resource]--;
+                if (resourceRef[access.Resource] == 0)
+                { stack.push_back(access.Resource); }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      パスの実行順を決定します.
+//-----------------------------------------------------------------------------
+void PassGraphCompiler::Schedule(const std::vector<uint8_t>& alive, std::vector<uint32_t>& order) const
+{
+    auto passCount     = uint32_t(m_Passes.size());
+    auto resourceCount = uint32_t(m_Resources.size());
+
+    order.clear();
+    order.reserve(passCount);
+
+    if (!m_Reorder)
+    {
+        for(auto i=0u; i<passCount; ++i)
+        {
+            if (alive[i])
+            { order.push_back(i); }
+        }
+        return;
+    }
+
+    // 登録順でのリソースアクセスから依存関係(RAW, WAR, WAW)を構築.
+    std::vector<std::vector<uint32_t>>  succ      (passCount);
+    std::vector<uint32_t>               indegree  (passCount, 0);
+    std::vector<uint32_t>               lastWriter(resourceCount, kInvalidIndex);
+    std::vector<std::vector<uint32_t>>  readers   (resourceCount);
+
+    auto addEdge = [&](uint32_t from, uint32_t to)
+    {
+        if (from == to)
+        { return; }
+
+        succ[from].push_back(to);
+        indegree[to]++;
+    };
+
+    for(auto i=0u; i<passCount; ++i)
+    {
+        if (!alive[i])
+        { continue; }
+
+        auto& pass = m_Passes[i];
+        for(auto j=0u; j<pass.AccessCount; ++j)
+        {
+            auto& access = m_Accesses[pass.AccessOffset + j];
+            auto  r      = access.Resource;
+
+            if ((access.Flags & RESOURCE_INFO_FLAG_STATE_READ) && lastWriter[r] != kInvalidIndex)
+            { addEdge(lastWriter[r], i); }
+
+            if (access.Flags & RESOURCE_INFO_FLAG_STATE_WRITE)
+            {
+                if (!readers[r].empty())
+                {
+                    for(auto reader : readers[r])
+                    { addEdge(reader, i); }
+                }
+                else if (lastWriter[r] != kInvalidIndex)
+                { addEdge(lastWriter[r], i); }
+            }
+        }
+
+        for(auto j=0u; j<pass.AccessCount; ++j)
+        {
+            auto& access = m_Accesses[pass.AccessOffset + j];
+            if (access.Flags & RESOURCE_INFO_FLAG_STATE_WRITE)
+            {
+                lastWriter[access.Resource] = i;
+                readers[access.Resource].clear();
+            }
+        }
+
+        for(auto j=0u; j<pass.AccessCount; ++j)
+        {
+            auto& access = m_Accesses[pass.AccessOffset + j];
+            if ((access.Flags & RESOURCE_INFO_FLAG_STATE_READ) && lastWriter[access.Resource] != i)
+            { readers[access.Resource].push_back(i); }
+        }
+    }
+
+    // ステートとキューをシミュレートしながらリストスケジューリング.
+    std::vector<RESOURCE_INFO_FLAGS> state(resourceCount);
+    std::vector<uint8_t>             queue(resourceCount, QUEUE_TYPE_NONE);
+    for(auto i=0u; i<resourceCount; ++i)
+    { state[i] = m_Resources[i].State; }
+
+    std::vector<uint32_t> ready;
+    for(auto i=0u; i<passCount; ++i)
+    {
+        if (alive[i] && indegree[i] == 0)
+        { ready.push_back(i); }
+    }
+
+    while(!ready.empty())
+    {
+        // 優先度.
+        //  0 : 非同期コンピュート (早く発行するほどグラフィックスとオーバーラップできる).
+        //  1 : コンピュートの完了待ちが不要なグラフィックス.
+        //  2 : コンピュートの完了待ちが必要なグラフィックス.
+        // 同じ優先度ならステート遷移が少ないものを選び，遷移をまとめる. 最後は登録順.
+        auto bestIndex = 0u;
+        auto bestClass = UINT32_MAX;
+        auto bestCost  = UINT32_MAX;
+
+        for(auto i=0u; i<ready.size(); ++i)
+        {
+            auto& pass = m_Passes[ready[i]];
+            auto  cost = 0u;
+            auto  sync = false;
+
+            for(auto j=0u; j<pass.AccessCount; ++j)
+            {
+                auto& access = m_Accesses[pass.AccessOffset + j];
+                if (state[access.Resource] != access.Flags)
+                { cost++; }
+                if (!pass.AsyncCompute && queue[access.Resource] == QUEUE_TYPE_COMPUTE)
+                { sync = true; }
+            }
+
+            auto priority = pass.AsyncCompute ? 0u : (sync ? 2u : 1u);
+
+            auto better = (priority < bestClass)
+                       || (priority == bestClass && cost < bestCost)
+                       || (priority == bestClass && cost == bestCost && ready[i] < ready[bestIndex]);
+            if (better)
+            {
+                bestIndex = i;
+                bestClass = priority;
+                bestCost  = cost;
+            }
+        }
+
+        auto index = ready[bestIndex];
+        ready.erase(ready.begin() + bestIndex);
+        order.push_back(index);
+
+        auto& pass = m_Passes[index];
+        for(auto j=0u; j<pass.AccessCount; ++j)
+        {
+            auto& access = m_Accesses[pass.AccessOffset + j];
+            state[access.Resource] = access.Flags;
+            queue[access.Resource] = uint8_t(pass.AsyncCompute ? QUEUE_TYPE_COMPUTE : QUEUE_TYPE_GRAPHICS);
+        }
+
+        for(auto next : succ[index])
+        {
+            indegree[next]--;
+            if (indegree[next] == 0)
+            { ready.push_back(next); }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      バリアとキュー間同期を解決します.
+//-----------------------------------------------------------------------------
+void PassGraphCompiler::Resolve(const std::vector<uint32_t>& order, PassGraphPlan& plan) const
+{
+    auto resourceCount = uint32_t(m_Resources.size());
+
+    std::vector<PassStep>                   steps;
+    std::vector<std::vector<PassBarrier>>   pre;
+    std::vector<std::vector<PassBarrier>>   post;
+
+    steps.reserve(order.size() * 2);
+    pre  .reserve(order.size() * 2);
+    post .reserve(order.size() * 2);
+
+    std::vector<RESOURCE_INFO_FLAGS> state   (resourceCount);
+    std::vector<uint8_t>             queue   (resourceCount, QUEUE_TYPE_NONE);
+    std::vector<uint32_t>            lastStep(resourceCount, kInvalidIndex);
+    for(auto i=0u; i<resourceCount; ++i)
+    { state[i] = m_Resources[i].State; }
+
+    // 直前に別キューで使用されたリソースがあれば同期が必要.
+    auto getSyncFlag = [&](const Pass& pass, bool compute) -> uint8_t
+    {
+        uint8_t result = SYNC_FLAG_NONE;
+        for(auto j=0u; j<pass.AccessCount; ++j)
+        {
+            auto q = queue[m_Accesses[pass.AccessOffset + j].Resource];
+            if (compute)
+            {
+                if (q == QUEUE_TYPE_GRAPHICS)
+                { return SYNC_FLAG_GRAPHICS_TO_COMPUTE; }
+                if (q == QUEUE_TYPE_COMPUTE)
+                { result = SYNC_FLAG_COMPUTE_TO_COMPUTE; }
+            }
+            else if (q == QUEUE_TYPE_COMPUTE)
+            { return SYNC_FLAG_COMPUTE_TO_GRAPHICS; }
+        }
+        return result;
+    };
+
+    auto addStep = [&](uint32_t pass, bool asyncCompute, uint8_t syncFlag) -> uint32_t
+    {
+        PassStep step = {};
+        step.Pass           = pass;
+        step.AsyncCompute   = asyncCompute;
+        step.SyncFlag       = syncFlag;
+
+        steps.push_back(step);
+        pre  .emplace_back();
+        post .emplace_back();
+        return uint32_t(steps.size() - 1);
+    };
+
+    // グラフィックスステップにバリアを追加.
+    // 直前の使用と今回の使用の間に別のステップが挟まる場合は，
+    // 直前の使用直後に BEGIN_ONLY，今回の使用直前に END_ONLY を張って遷移を隠蔽する.
+    auto addBarrier = [&](uint32_t stepIndex, uint32_t resource, RESOURCE_INFO_FLAGS after)
+    {
+        assert(!steps[stepIndex].AsyncCompute);
+
+        PassBarrier barrier = { resource, state[resource], after, PASS_BARRIER_SPLIT_NONE };
+
+        auto last = lastStep[resource];
+        if (last != kInvalidIndex && last + 1 < stepIndex && queue[resource] == QUEUE_TYPE_GRAPHICS)
+        {
+            barrier.Split = PASS_BARRIER_SPLIT_BEGIN_ONLY;
+            post[last].push_back(barrier);
+
+            barrier.Split = PASS_BARRIER_SPLIT_END_ONLY;
+        }
+
+        pre[stepIndex].push_back(barrier);
+        state[resource] = after;
+    };
+
+    for(auto index : order)
+    {
+        auto& pass = m_Passes[index];
+
+        // コンピュートキューでは遷移できないステートがあるため，
+        // バリアだけを張るグラフィックスステップを直前に追加する.
+        if (pass.AsyncCompute)
+        {
+            auto needBarrier = false;
+            for(auto j=0u; j<pass.AccessCount; ++j)
+            {
+                auto& access = m_Accesses[pass.AccessOffset + j];
+                if (state[access.Resource] != access.Flags)
+                { needBarrier = true; }
+            }
+
+            if (needBarrier)
+            {
+                auto stepIndex = addStep(kInvalidIndex, false, getSyncFlag(pass, false));
+                for(auto j=0u; j<pass.AccessCount; ++j)
+                {
+                    auto& access = m_Accesses[pass.AccessOffset + j];
+                    if (state[access.Resource] == access.Flags)
+                    { continue; }
+
+                    addBarrier(stepIndex, access.Resource, access.Flags);
+                    queue   [access.Resource] = QUEUE_TYPE_GRAPHICS;
+                    lastStep[access.Resource] = stepIndex;
+                }
+            }
+        }
+
+        auto stepIndex = addStep(index, pass.AsyncCompute, getSyncFlag(pass, pass.AsyncCompute));
+        for(auto j=0u; j<pass.AccessCount; ++j)
+        {
+            auto& access = m_Accesses[pass.AccessOffset + j];
+
+            // ステートが違っていたらバリアを張る.
+            if (state[access.Resource] != access.Flags)
+            { addBarrier(stepIndex, access.Resource, access.Flags); }
+
+            queue   [access.Resource] = uint8_t(pass.AsyncCompute ? QUEUE_TYPE_COMPUTE : QUEUE_TYPE_GRAPHICS);
+            lastStep[access.Resource] = stepIndex;
+        }
+    }
+
+    // 待機を挟まずに連続するグラフィックスステップは，
+    // 後ろのステップの実行前バリアを前のステップの実行後バリアにまとめて1回で発行する.
+    for(auto i=1u; i<steps.size(); ++i)
+    {
+        if (pre[i].empty())
+        { continue; }
+
+        if (steps[i - 1].AsyncCompute || steps[i].AsyncCompute)
+        { continue; }
+
+        if (steps[i].SyncFlag != SYNC_FLAG_NONE)
+        { continue; }
+
+        post[i - 1].insert(post[i - 1].end(), pre[i].begin(), pre[i].end());
+        pre[i].clear();
+    }
+
+    // 平坦化. 中身が無くなったバリア専用ステップは取り除く.
+    plan.Steps   .clear();
+    plan.Barriers.clear();
+    plan.SplitCount = 0;
+    plan.BatchCount = 0;
+
+    for(auto i=0u; i<steps.size(); ++i)
+    {
+        auto step = steps[i];
+        if (step.Pass == kInvalidIndex && pre[i].empty() && post[i].empty())
+        { continue; }
+
+        step.PreBarrierOffset  = uint32_t(plan.Barriers.size());
+        step.PreBarrierCount   = uint32_t(pre[i].size());
+        plan.Barriers.insert(plan.Barriers.end(), pre[i].begin(), pre[i].end());
+
+        step.PostBarrierOffset = uint32_t(plan.Barriers.size());
+        step.PostBarrierCount  = uint32_t(post[i].size());
+        plan.Barriers.insert(plan.Barriers.end(), post[i].begin(), post[i].end());
+
+        for(auto& barrier : post[i])
+        {
+            if (barrier.Split == PASS_BARRIER_SPLIT_BEGIN_ONLY)
+            { plan.SplitCount++; }
+        }
+
+        if (step.PreBarrierCount > 0)
+        { plan.BatchCount++; }
+        if (step.PostBarrierCount > 0)
+        { plan.BatchCount++; }
+
+        plan.Steps.push_back(step);
+    }
+
+    plan.FinalStates .resize(resourceCount);
+    plan.FinalCompute.resize(resourceCount);
+    for(auto i=0u; i<resourceCount; ++i)
+    {
+        plan.FinalStates [i] = state[i];
+        plan.FinalCompute[i] = (queue[i] == QUEUE_TYPE_NONE)
+            ? uint8_t(m_Resources[i].Compute ? 1 : 0)
+            : uint8_t(queue[i] == QUEUE_TYPE_COMPUTE ? 1 : 0);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      実行計画をキューへの投入順にレコーダーへ記録します.
+//-----------------------------------------------------------------------------
+void RecordPlan(const PassGraphPlan& plan, IPassCommandRecorder* pRecorder)
+{
+    assert(pRecorder != nullptr);
+
+    for(auto& step : plan.Steps)
+    {
+        if (step.SyncFlag == SYNC_FLAG_GRAPHICS_TO_COMPUTE
+         || step.SyncFlag == SYNC_FLAG_COMPUTE_TO_GRAPHICS)
+        { pRecorder->Wait(step.SyncFlag); }
+
+        if (step.PreBarrierCount > 0)
+        { pRecorder->Barrier(step.PreBarrierCount, plan.Barriers.data() + step.PreBarrierOffset); }
+
+        pRecorder->Execute(step.Pass, step.AsyncCompute);
+
+        if (step.PostBarrierCount > 0)
+        { pRecorder->Barrier(step.PostBarrierCount, plan.Barriers.data() + step.PostBarrierOffset); }
+    }
+}
+
+} // namespace asdx
@@ -0,0 +1,518 @@
+﻿//-----------------------------------------------------------------------------
+// File : TestBlockCompression.cpp
+// Desc : BC6H / BC7 Decoder Golden Test.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstring>
+#include <vector>
+#include <res/asdxBlockCompression.h>
+#include <fnd/asdxThreadPool.h>
+#include "asdxTest.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const uint16_t kHalfOne = 0x3C00;
+
+///////////////////////////////////////////////////////////////////////////////
+// BC7Golden structure
+///////////////////////////////////////////////////////////////////////////////
+struct BC7Golden
+{
+    uint8_t     Block[16];      //!< 圧縮ブロック.
+    uint8_t     RGBA[64];       //!< 期待する展開結果.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BC6HGolden structure
+///////////////////////////////////////////////////////////////////////////////
+struct BC6HGolden
+{
+    uint8_t     Block[16];      //!< 圧縮ブロック.
+    uint16_t    Unsigned[48];   //!< UF16 として期待する展開結果.
+    uint16_t    Signed[48];     //!< SF16 として期待する展開結果.
+};
+
+// Pillow の BC7 デコーダで展開した結果 (各モード1ブロック).
+const BC7Golden kBC7Goldens[] = {
+    // Mode 0
+    {
+        { 0xdb, 0xc8, 0x33, 0x54, 0xc7, 0x10, 0xdd, 0x75, 0x80, 0xf3, 0x8b, 0xca, 0x1d, 0xd5, 0x38, 0xe0 },
+        {
+            102, 157, 230, 255, 191, 126,  29, 255,  64, 166, 190, 255,  44, 153, 198, 255,
+             74,  57, 173, 255, 216, 116,  43, 255,  83, 178, 182, 255, 106, 193, 172, 255,
+             98, 140, 220, 255, 179, 131,  22, 255,  44, 153, 198, 255, 145, 218, 156, 255,
+            102, 157, 230, 255, 239, 107,  57, 255, 106, 193, 172, 255,  83, 178, 182, 255
+        },
+    },
+    // Mode 1
+    {
+        { 0x0e, 0x9e, 0x45, 0x41, 0x93, 0xfb, 0xd9, 0xec, 0x2f, 0xbb, 0x8a, 0x82, 0xec, 0x0c, 0x3d, 0xdd },
+        {
+            111, 107, 198, 255, 120,  76, 177, 255,  97, 154, 232, 255,  82, 126, 203, 255,
+            102, 139, 221, 255, 102, 139, 221, 255,  71, 193, 192, 255,  75, 165, 196, 255,
+             93, 170, 242, 255, 120,  76, 177, 255,  78, 152, 199, 255,  66, 219, 187, 255,
+            116,  91, 188, 255,  71, 193, 192, 255,  75, 165, 196, 255,  75, 165, 196, 255
+        },
+    },
+    // Mode 2
+    {
+        { 0xcc, 0x20, 0xe5, 0xa3, 0x1c, 0x13, 0x96, 0xc9, 0xed, 0x38, 0x9b, 0xc0, 0xd1, 0x36, 0xe0, 0x8c },
+        {
+            132,  49,  57, 255, 143,  36,  76, 255,  24,  49,  74, 255,  52, 139,  38, 255,
+            143,  36,  76, 255, 165,   8, 115, 255, 231,  90, 181, 255,  41, 206,   0, 255,
+            231,  90, 181, 255, 231,  90, 181, 255,  57, 107,  57, 255,  46, 174,  19, 255,
+             52, 139,  38, 255,  46, 174,  19, 255,  41, 206,   0, 255,  46, 174,  19, 255
+        },
+    },
+    // Mode 3
+    {
+        { 0x88, 0x10, 0xe1, 0xbc, 0x18, 0xae, 0xe7, 0xaf, 0x7c, 0x00, 0xd2, 0x13, 0x8e, 0x1a, 0xb0, 0x2b },
+        {
+            165, 115,  42, 255, 165, 115,  42, 255, 136, 112,  62, 255, 165, 115,  42, 255,
+            165, 115,  42, 255, 224, 122,   0, 255, 136, 112,  62, 255, 136, 112,  62, 255,
+            136, 112,  62, 255, 195, 119,  20, 255, 165, 115,  42, 255,  99,  43,  79, 255,
+            165, 115,  42, 255, 165, 115,  42, 255, 113, 183, 136, 255, 120, 252, 164, 255
+        },
+    },
+    // Mode 4
+    {
+        { 0xd0, 0x17, 0xa0, 0x95, 0xec, 0x0a, 0x91, 0xd2, 0x08, 0x56, 0x8c, 0xf5, 0xb6, 0x1d, 0xe6, 0x4b },
+        {
+            136, 174, 104,  73, 162, 101,  89,  69,  27, 174, 166,  87, 136, 138, 104,  73,
+              0, 138, 181,  90,  53, 101, 151,  83,  53, 101, 151,  83,  53, 138, 151,  83,
+             53, 174, 151,  83, 109, 138, 119,  76, 189, 174,  74,  66, 109, 174, 119,  76,
+             27,  65, 166,  87,   0, 101, 181,  90, 136, 101, 104,  73, 136, 174, 104,  73
+        },
+    },
+    // Mode 5
+    {
+        { 0x20, 0x90, 0x0e, 0x14, 0xb5, 0xc5, 0x75, 0x84, 0x3a, 0xe7, 0xfc, 0xbf, 0x79, 0x7d, 0x83, 0xd7 },
+        {
+             32, 161, 183,  29,  58,  80, 112, 118,  41, 134, 160, 161,  49, 107, 135,  72,
+             58,  80, 112,  72,  32, 161, 183, 161,  58,  80, 112, 161,  41, 134, 160,  72,
+             49, 107, 135, 161,  58,  80, 112,  29,  58,  80, 112,  29,  58,  80, 112, 118,
+             58,  80, 112, 161,  58,  80, 112,  72,  41, 134, 160,  72,  58,  80, 112, 161
+        },
+    },
+    // Mode 6
+    {
+        { 0xc0, 0xf5, 0x6e, 0x84, 0x32, 0x07, 0xbf, 0xb7, 0xf2, 0x7f, 0x92, 0xad, 0xd3, 0x33, 0x32, 0xbb },
+        {
+            209,  72, 200, 186, 118,  80, 130, 110, 118,  80, 130, 110, 170,  75, 170, 153,
+            201,  72, 194, 180, 157,  76, 160, 143, 132,  79, 141, 121, 150,  77, 155, 137,
+            195,  73, 190, 175, 132,  79, 141, 121, 195,  73, 190, 175, 195,  73, 190, 175,
+            201,  72, 194, 180, 195,  73, 190, 175, 144,  78, 150, 132, 144,  78, 150, 132
+        },
+    },
+    // Mode 7
+    {
+        { 0x80, 0x05, 0x22, 0x86, 0x1e, 0x4e, 0x67, 0xe5, 0x33, 0x09, 0xe4, 0x02, 0x5f, 0x5f, 0xb4, 0x72 },
+        {
+             54, 112, 189,  32,  32, 227, 227,  65, 129, 161, 104,  46, 129, 161, 104,  46,
+             32, 227, 227,  65, 166, 158,  77,  12, 129, 161, 104,  46,  52, 166, 158, 117,
+             43, 171, 208,  49, 129, 161, 104,  46,  89, 163, 131,  83,  89, 163, 131,  83,
+             89, 163, 131,  83, 129, 161, 104,  46, 166, 158,  77,  12,  52, 166, 158, 117
+        },
+    },
+};
+
+// BC6H の仕様書のビット配置表から起こしたデコーダで展開した結果 (各モード1ブロック, RGBのみ).
+const BC6HGolden kBC6HGoldens[] = {
+    // Mode 0x00 (10.555)
+    {
+        { 0xf4, 0xaf, 0x5b, 0x91, 0xaf, 0x37, 0x68, 0x82, 0x66, 0x2d, 0xec, 0xf7, 0x98, 0x74, 0x72, 0x30 },
+        {
+            0x2de0, 0x5445, 0x757b, 0x2d4b, 0x5453, 0x75b2, 0x2d1b, 0x5457, 0x75c3, 0x2d79, 0x53ca, 0x745f,
+            0x2d1b, 0x5457, 0x75c3, 0x2e70, 0x5438, 0x7547, 0x2de0, 0x5445, 0x757b, 0x2d1a, 0x53ae, 0x7538,
+            0x2e10, 0x5441, 0x756a, 0x2d1b, 0x5457, 0x75c3, 0x2dab, 0x544a, 0x758f, 0x2d5a, 0x53c1, 0x74a4,
+            0x2de0, 0x5445, 0x757b, 0x2e70, 0x5438, 0x7547, 0x2d4b, 0x5453, 0x75b2, 0x2cdd, 0x539d, 0x75c3
+        },
+        {
+            0x5bc1, 0xcfb2, 0x8d46, 0x5a96, 0xcf97, 0x8cd9, 0x5a37, 0xcf8f, 0x8cb7, 0x5af2, 0xd0a9, 0x8f80,
+            0x5a37, 0xcf8f, 0x8cb7, 0x5ce1, 0xcfcd, 0x8daf, 0x5bc1, 0xcfb2, 0x8d46, 0x5a35, 0xd0e0, 0x8dce,
+            0x5c21, 0xcfbb, 0x8d69, 0x5a37, 0xcf8f, 0x8cb7, 0x5b56, 0xcfa9, 0x8d1f, 0x5ab5, 0xd0bb, 0x8ef4,
+            0x5bc1, 0xcfb2, 0x8d46, 0x5ce1, 0xcfcd, 0x8daf, 0x5a96, 0xcf97, 0x8cd9, 0x59bb, 0xd103, 0x8cb7
+        },
+    },
+    // Mode 0x01 (7.666)
+    {
+        { 0xcd, 0x8d, 0x41, 0xa6, 0x61, 0x78, 0xd6, 0xcd, 0x51, 0x13, 0x05, 0x3b, 0xe8, 0x3c, 0x0a, 0x83 },
+        {
+            0x6cae, 0x130e, 0x5491, 0x6b0c, 0x0364, 0x50e4, 0x7509, 0x6321, 0x675e, 0x7509, 0x6321, 0x675e,
+            0x6cae, 0x130e, 0x5491, 0x6b0c, 0x0364, 0x50e4, 0x7367, 0x5376, 0x63b0, 0x6ff3, 0x3263, 0x5bec,
+            0x7509, 0x6321, 0x675e, 0x6ff3, 0x3263, 0x5bec, 0x71c4, 0x43cc, 0x6003, 0x5340, 0x55ac, 0x4689,
+            0x6b0c, 0x0364, 0x50e4, 0x6ff3, 0x3263, 0x5bec, 0x53cc, 0x6c04, 0x3f74, 0x5340, 0x55ac, 0x4689
+        },
+        {
+            0xa093, 0x02f7, 0xd0cc, 0xa3d8, 0x06c8, 0xd828, 0x8fdd, 0x9087, 0xab33, 0x8fdd, 0x9087, 0xab33,
+            0xa093, 0x02f7, 0xd0cc, 0xa3d8, 0x06c8, 0xd828, 0x9322, 0x8cb7, 0xb28e, 0x9a09, 0x84a9, 0xc216,
+            0x8fdd, 0x9087, 0xab33, 0x9a09, 0x84a9, 0xc216, 0x9667, 0x88e6, 0xb9e9, 0xd36f, 0x884b, 0xed8e,
+            0xa3d8, 0x06c8, 0xd828, 0x9a09, 0x84a9, 0xc216, 0xd258, 0xa1e8, 0xfbff, 0xd36f, 0x884b, 0xed8e
+        },
+    },
+    // Mode 0x02 (11.555, 11.444, 11.444)
+    {
+        { 0xe2, 0x92, 0x8d, 0x52, 0xb9, 0x22, 0xf3, 0x45, 0xfe, 0x62, 0x0b, 0x7f, 0xc5, 0x89, 0x65, 0x88 },
+        {
+            0x0905, 0x4f0b, 0x0a2d, 0x092c, 0x4f2a, 0x0a43, 0x0936, 0x4f2c, 0x0a6a, 0x0979, 0x4f0b, 0x0a81,
+            0x08a0, 0x4ebd, 0x09f5, 0x0936, 0x4f2c, 0x0a6a, 0x0929, 0x4f33, 0x0a66, 0x08b4, 0x4ecd, 0x0a00,
+            0x0918, 0x4f1b, 0x0a38, 0x0929, 0x4f33, 0x0a66, 0x096c, 0x4f12, 0x0a7c, 0x0905, 0x4f0b, 0x0a2d,
+            0x096c, 0x4f12, 0x0a7c, 0x091c, 0x4f39, 0x0a62, 0x0905, 0x4f0b, 0x0a2d, 0x08db, 0x4eeb, 0x0a16
+        },
+        {
+            0x120a, 0xda07, 0x145a, 0x1258, 0xd9ca, 0x1486, 0x126d, 0xd9c5, 0x14d5, 0x12f3, 0xda08, 0x1502,
+            0x1141, 0xdaa3, 0x13eb, 0x126d, 0xd9c5, 0x14d5, 0x1253, 0xd9b8, 0x14cd, 0x1169, 0xda84, 0x1401,
+            0x1231, 0xd9e8, 0x1471, 0x1253, 0xd9b8, 0x14cd, 0x12d9, 0xd9fa, 0x14f9, 0x120a, 0xda07, 0x145a,
+            0x12d9, 0xd9fa, 0x14f9, 0x1239, 0xd9ab, 0x14c4, 0x120a, 0xda07, 0x145a, 0x11b7, 0xda47, 0x142d
+        },
+    },
+    // Mode 0x06 (11.444, 11.555, 11.444)
+    {
+        { 0xc6, 0x68, 0x60, 0x81, 0xd1, 0x3b, 0xca, 0x59, 0x1b, 0x8c, 0x72, 0x39, 0x27, 0x23, 0x1a, 0x6d },
+        {
+            0x70c4, 0x2aa7, 0x49a7, 0x7067, 0x29bf, 0x49d6, 0x7080, 0x2a67, 0x496d, 0x7069, 0x2a55, 0x4992,
+            0x709d, 0x2a45, 0x49bb, 0x7074, 0x29e0, 0x49cf, 0x70b7, 0x2a87, 0x49ae, 0x708b, 0x2a70, 0x495c,
+            0x709d, 0x2a45, 0x49bb, 0x708e, 0x2a21, 0x49c2, 0x70c4, 0x2aa7, 0x49a7, 0x7081, 0x2a00, 0x49c9,
+            0x70b7, 0x2a87, 0x49ae, 0x70aa, 0x2a66, 0x49b4, 0x709d, 0x2a45, 0x49bb, 0x709d, 0x2a45, 0x49bb
+        },
+        {
+            0x9695, 0x554f, 0xe4cf, 0x974f, 0x537e, 0xe472, 0x971e, 0x54cf, 0xe543, 0x974b, 0x54aa, 0xe4fa,
+            0x96e3, 0x548b, 0xe4a7, 0x9735, 0x53c0, 0xe47f, 0x96af, 0x550e, 0xe4c1, 0x9707, 0x54e1, 0xe566,
+            0x96e3, 0x548b, 0xe4a7, 0x9701, 0x5443, 0xe499, 0x9695, 0x554f, 0xe4cf, 0x971b, 0x5401, 0xe48c,
+            0x96af, 0x550e, 0xe4c1, 0x96c9, 0x54cc, 0xe4b5, 0x96e3, 0x548b, 0xe4a7, 0x96e3, 0x548b, 0xe4a7
+        },
+    },
+    // Mode 0x0A (11.444, 11.444, 11.555)
+    {
+        { 0x2a, 0x25, 0x2a, 0xc8, 0xf9, 0x9c, 0xe2, 0x08, 0xd1, 0xe1, 0xe3, 0x97, 0x0c, 0x9a, 0xb7, 0x65 },
+        {
+            0x5003, 0x431d, 0x0dd5, 0x4ff6, 0x4353, 0x0d0e, 0x4fcf, 0x42f1, 0x0e37, 0x4fcf, 0x42f1, 0x0e37,
+            0x4f9f, 0x42fa, 0x0e49, 0x5001, 0x4326, 0x0db5, 0x4ffc, 0x4337, 0x0d73, 0x4f87, 0x42fe, 0x0e51,
+            0x4fb7, 0x42f6, 0x0e40, 0x4ffc, 0x4337, 0x0d73, 0x4ff6, 0x4353, 0x0d0e, 0x4fcf, 0x42f1, 0x0e37,
+            0x4fcf, 0x42f1, 0x0e37, 0x4fcf, 0x42f1, 0x0e37, 0x5001, 0x4326, 0x0db5, 0x4ffc, 0x4337, 0x0d73
+        },
+        {
+            0xd818, 0xf1e3, 0x1bab, 0xd832, 0xf178, 0x1a1c, 0xd880, 0xf23b, 0x1c6f, 0xd880, 0xf23b, 0x1c6f,
+            0xd8e0, 0xf22a, 0x1c92, 0xd81c, 0xf1d2, 0x1b6a, 0xd825, 0xf1af, 0x1ae7, 0xd910, 0xf221, 0x1ca3,
+            0xd8b0, 0xf232, 0x1c80, 0xd825, 0xf1af, 0x1ae7, 0xd832, 0xf178, 0x1a1c, 0xd880, 0xf23b, 0x1c6f,
+            0xd880, 0xf23b, 0x1c6f, 0xd880, 0xf23b, 0x1c6f, 0xd81c, 0xf1d2, 0x1b6a, 0xd825, 0xf1af, 0x1ae7
+        },
+    },
+    // Mode 0x0E (9.555)
+    {
+        { 0x2e, 0x46, 0x9d, 0xbc, 0x9c, 0x40, 0x9e, 0x61, 0x47, 0x61, 0x57, 0xc0, 0x8e, 0xf8, 0x93, 0x62 },
+        {
+            0x0b8b, 0x4bb0, 0x16fd, 0x09b9, 0x49bb, 0x1768, 0x0cb7, 0x4c2b, 0x15ad, 0x0cb7, 0x4c2b, 0x15ad,
+            0x0a2b, 0x4a35, 0x174e, 0x0c8a, 0x4cb0, 0x14a1, 0x0c9c, 0x4c79, 0x1510, 0x0a2b, 0x4a35, 0x174e,
+            0x0bfd, 0x4c2b, 0x16e3, 0x0c79, 0x4ce5, 0x1439, 0x0c79, 0x4ce5, 0x1439, 0x0b8b, 0x4bb0, 0x16fd,
+            0x0cae, 0x4c45, 0x1578, 0x0c8a, 0x4cb0, 0x14a1, 0x0bfd, 0x4c2b, 0x16e3, 0x0aa8, 0x4abc, 0x1731
+        },
+        {
+            0x1717, 0xe11a, 0x2dfa, 0x1373, 0xe505, 0x2ed1, 0x196e, 0xe026, 0x2b5a, 0x196e, 0xe026, 0x2b5a,
+            0x1456, 0xe411, 0x2e9d, 0x1914, 0xdf1a, 0x2943, 0x1939, 0xdf89, 0x2a20, 0x1456, 0xe411, 0x2e9d,
+            0x17fa, 0xe026, 0x2dc6, 0x18f2, 0xdeb2, 0x2872, 0x18f2, 0xdeb2, 0x2872, 0x1717, 0xe11a, 0x2dfa,
+            0x195c, 0xdff1, 0x2af1, 0x1914, 0xdf1a, 0x2943, 0x17fa, 0xe026, 0x2dc6, 0x1551, 0xe302, 0x2e62
+        },
+    },
+    // Mode 0x12 (8.666, 8.555, 8.555)
+    {
+        { 0xb2, 0x33, 0x0e, 0x93, 0x2d, 0x90, 0xae, 0x9d, 0x51, 0x9f, 0xc7, 0x4b, 0x0a, 0xae, 0xff, 0x86 },
+        {
+            0x4ca1, 0x0cfc, 0x6142, 0x4db0, 0x0a71, 0x6033, 0x4eb6, 0x07fe, 0x5f2e, 0x43a9, 0x0985, 0x6402,
+            0x4cf8, 0x0c2b, 0x60eb, 0x43a9, 0x0985, 0x6402, 0x4229, 0x09b9, 0x65b6, 0x40aa, 0x09ee, 0x676a,
+            0x4528, 0x0951, 0x624e, 0x4852, 0x08e2, 0x5eb5, 0x49d2, 0x08ae, 0x5d01, 0x4eb6, 0x07fe, 0x5f2e,
+            0x4b52, 0x087a, 0x5b4e, 0x4e07, 0x09a0, 0x5fdc, 0x4ca1, 0x0cfc, 0x6142, 0x4db0, 0x0a71, 0x6033
+        },
+        {
+            0xdfb5, 0x19f9, 0xb672, 0xdd97, 0x14e3, 0xb890, 0xdb8c, 0x0ffc, 0xba9c, 0xf1a5, 0x130a, 0xb0f3,
+            0xdf07, 0x1857, 0xb720, 0xf1a5, 0x130a, 0xb0f3, 0xf4a4, 0x1373, 0xad8b, 0xf7a4, 0x13dc, 0xaa24,
+            0xeea6, 0x12a2, 0xb45b, 0xe852, 0x11c5, 0xbb8c, 0xe553, 0x115c, 0xbef4, 0xdb8c, 0x0ffc, 0xba9c,
+            0xe254, 0x10f4, 0xc25c, 0xdce8, 0x1341, 0xb93f, 0xdfb5, 0x19f9, 0xb672, 0xdd97, 0x14e3, 0xb890
+        },
+    },
+    // Mode 0x16 (8.555, 8.666, 8.555)
+    {
+        { 0xb6, 0xb3, 0x96, 0xf7, 0x5b, 0xa4, 0x65, 0x0d, 0x26, 0xe8, 0x41, 0x45, 0x50, 0x4e, 0x72, 0x0f },
+        {
+            0x4c4a, 0x160a, 0x79d2, 0x4f5e, 0x10b7, 0x7823, 0x4dc9, 0x1373, 0x7900, 0x4d09, 0x14be, 0x7969,
+            0x4dc9, 0x1373, 0x7900, 0x4c4a, 0x160a, 0x79d2, 0x4dc9, 0x1373, 0x7900, 0x4d09, 0x14be, 0x7969,
+            0x519e, 0x0cd6, 0x76ea, 0x4f5e, 0x10b7, 0x7823, 0x4f5e, 0x10b7, 0x7823, 0x4f5e, 0x10b7, 0x7823,
+            0x4561, 0x0e08, 0x7a06, 0x448a, 0x0c5a, 0x7a4e, 0x45c9, 0x0ed9, 0x79e3, 0x45fe, 0x0f42, 0x79d2
+        },
+        {
+            0xe064, 0x2c14, 0x8554, 0xda3a, 0x216f, 0x88b0, 0xdd64, 0x26e6, 0x86f6, 0xdee4, 0x297d, 0x8625,
+            0xdd64, 0x26e6, 0x86f6, 0xe064, 0x2c14, 0x8554, 0xdd64, 0x26e6, 0x86f6, 0xdee4, 0x297d, 0x8625,
+            0xd5bc, 0x19ac, 0x8b24, 0xda3a, 0x216f, 0x88b0, 0xda3a, 0x216f, 0x88b0, 0xda3a, 0x216f, 0x88b0,
+            0xee35, 0x1c10, 0x84eb, 0xefe4, 0x18b4, 0x845c, 0xed64, 0x1db2, 0x8531, 0xecfc, 0x1e84, 0x8554
+        },
+    },
+    // Mode 0x1A (8.555, 8.555, 8.666)
+    {
+        { 0x9a, 0xc1, 0xa2, 0x05, 0x72, 0x1a, 0xa0, 0x7c, 0x0a, 0x1f, 0x5c, 0xdf, 0xe6, 0x80, 0xf1, 0x2c },
+        {
+            0x08ea, 0x21aa, 0x3417, 0x0aed, 0x21aa, 0x57e6, 0x0590, 0x231f, 0x7255, 0x0516, 0x239a, 0x7196,
+            0x0be1, 0x21aa, 0x68dc, 0x0be1, 0x21aa, 0x68dc, 0x0684, 0x222b, 0x73d5, 0x070b, 0x21a4, 0x74aa,
+            0x060e, 0x21aa, 0x0136, 0x060e, 0x21aa, 0x0136, 0x070b, 0x21a4, 0x74aa, 0x0684, 0x222b, 0x73d5,
+            0x0cd6, 0x21aa, 0x79d2, 0x09f9, 0x21aa, 0x46f0, 0x060a, 0x22a5, 0x7315, 0x087a, 0x2036, 0x76ea
+        },
+        {
+            0x11d4, 0x4354, 0x80d9, 0x15db, 0x4354, 0x8326, 0x0b20, 0x463f, 0x944c, 0x0a2c, 0x4734, 0x95cc,
+            0x17c3, 0x4354, 0x843d, 0x17c3, 0x4354, 0x843d, 0x0d08, 0x4457, 0x914d, 0x0e17, 0x4348, 0x8fa2,
+            0x0c1c, 0x4354, 0x026c, 0x0c1c, 0x4354, 0x026c, 0x0e17, 0x4348, 0x8fa2, 0x0d08, 0x4457, 0x914d,
+            0x19ac, 0x4354, 0x8554, 0x13f3, 0x4354, 0x820f, 0x0c14, 0x454b, 0x92cc, 0x10f4, 0x406c, 0x8b24
+        },
+    },
+    // Mode 0x1E (6.666)
+    {
+        { 0x1e, 0x5b, 0xf6, 0x96, 0xf2, 0x4f, 0xbf, 0x3b, 0xdf, 0x1c, 0x82, 0x5e, 0xf5, 0x19, 0xa7, 0x70 },
+        {
+            0x2f78, 0x5638, 0x1648, 0x2f78, 0x5638, 0x1648, 0x6463, 0x69b7, 0x538e, 0x7918, 0x7158, 0x6b88,
+            0x617b, 0x5540, 0x6482, 0x6463, 0x69b7, 0x538e, 0x6ebd, 0x6d87, 0x5f8b, 0x7918, 0x7158, 0x6b88,
+            0x673b, 0x5e74, 0x5901, 0x5ec1, 0x50e4, 0x69f5, 0x6cae, 0x672c, 0x4e1b, 0x39d2, 0x5a08, 0x2245,
+            0x69f5, 0x62d0, 0x538e, 0x5c08, 0x4c88, 0x6f68, 0x6cae, 0x672c, 0x4e1b, 0x5ec1, 0x50e4, 0x69f5
+        },
+        {
+            0x5ef0, 0xcf70, 0x2c90, 0x5ef0, 0xcf70, 0x2c90, 0x13bd, 0xa872, 0x8ded, 0x89b0, 0x9930, 0xa4d0,
+            0xb8ea, 0xd160, 0xb2dc, 0x13bd, 0xa872, 0x8ded, 0x0506, 0xa0d1, 0x995e, 0x89b0, 0x9930, 0xa4d0,
+            0xad69, 0xbef8, 0xc9de, 0xbe5d, 0xda18, 0xa7f6, 0xa283, 0xad88, 0xdfaa, 0x5039, 0xc7cf, 0x211e,
+            0xa7f6, 0xb640, 0xd4c4, 0xc3d0, 0xe2d0, 0x9d10, 0xa283, 0xad88, 0xdfaa, 0xbe5d, 0xda18, 0xa7f6
+        },
+    },
+    // Mode 0x03 (10.10)
+    {
+        { 0x63, 0xe6, 0x04, 0xeb, 0xe2, 0x7c, 0xb8, 0x93, 0xa9, 0xe2, 0x31, 0xaf, 0xc1, 0x2a, 0xff, 0x40 },
+        {
+            0x669d, 0x3ce6, 0x3b30, 0x6bc7, 0x3974, 0x5089, 0x6506, 0x3df5, 0x349e, 0x6f28, 0x3734, 0x5e7f,
+            0x6407, 0x3e9e, 0x3083, 0x65d1, 0x3d6d, 0x37e7, 0x6ff3, 0x36ac, 0x61c8, 0x6bc7, 0x3974, 0x5089,
+            0x6407, 0x3e9e, 0x3083, 0x6d5e, 0x3865, 0x571b, 0x6bc7, 0x3974, 0x5089, 0x6506, 0x3df5, 0x349e,
+            0x6ff3, 0x36ac, 0x61c8, 0x6ff3, 0x36ac, 0x61c8, 0x633c, 0x3f26, 0x2d3a, 0x669d, 0x3ce6, 0x3b30
+        },
+        {
+            0xab03, 0xbc81, 0x346f, 0xa0af, 0x2174, 0x85b5, 0xae31, 0xd96a, 0x4654, 0x99ed, 0x5ee4, 0xabba,
+            0xb02e, 0xeb7c, 0x5182, 0xac9a, 0xcaf5, 0x3d62, 0x9857, 0x6d59, 0xb4ad, 0xa0af, 0x2174, 0x85b5,
+            0xb02e, 0xeb7c, 0x5182, 0x9d81, 0x3e5d, 0x979a, 0xa0af, 0x2174, 0x85b5, 0xae31, 0xd96a, 0x4654,
+            0x9857, 0x6d59, 0xb4ad, 0x9857, 0x6d59, 0xb4ad, 0xb1c5, 0xf9f1, 0x5a75, 0xab03, 0xbc81, 0x346f
+        },
+    },
+    // Mode 0x07 (11.9)
+    {
+        { 0x07, 0x9e, 0x24, 0x4a, 0x52, 0xa8, 0xda, 0x9e, 0xd6, 0x0e, 0x29, 0x2f, 0x01, 0x18, 0xc8, 0xff },
+        {
+            0x24b9, 0x4512, 0x0f5f, 0x6c52, 0x4d88, 0x07a0, 0x74d9, 0x4e8a, 0x06b3, 0x0e8f, 0x4273, 0x11c5,
+            0x4f57, 0x4a1b, 0x0ac2, 0x1de7, 0x4443, 0x101c, 0x7baa, 0x4f58, 0x05f6, 0x1de7, 0x4443, 0x101c,
+            0x1561, 0x4341, 0x1108, 0x0e8f, 0x4273, 0x11c5, 0x4886, 0x494d, 0x0b7f, 0x1561, 0x4341, 0x1108,
+            0x4886, 0x494d, 0x0b7f, 0x6581, 0x4cba, 0x085c, 0x7baa, 0x4f58, 0x05f6, 0x7baa, 0x4f58, 0x05f6
+        },
+        {
+            0x170c, 0xedfa, 0x1ebf, 0x036b, 0xdd0d, 0x0f40, 0x0115, 0xdb0a, 0x0d67, 0x1d1f, 0xf338, 0x238a,
+            0x0b5d, 0xe3e7, 0x1585, 0x18eb, 0xef97, 0x2038, 0x80c9, 0xd96d, 0x0bed, 0x18eb, 0xef97, 0x2038,
+            0x1b40, 0xf19b, 0x2210, 0x1d1f, 0xf338, 0x238a, 0x0d3b, 0xe584, 0x16ff, 0x1b40, 0xf19b, 0x2210,
+            0x0d3b, 0xe584, 0x16ff, 0x054a, 0xdeaa, 0x10b9, 0x80c9, 0xd96d, 0x0bed, 0x80c9, 0xd96d, 0x0bed
+        },
+    },
+    // Mode 0x0B (12.8)
+    {
+        { 0xcb, 0x62, 0x9d, 0xf0, 0xb4, 0xb7, 0xed, 0x0a, 0x29, 0x44, 0x26, 0x88, 0xb3, 0xb9, 0xdf, 0x71 },
+        {
+            0x36da, 0x6765, 0x3250, 0x36e3, 0x66fc, 0x323c, 0x36da, 0x6765, 0x3250, 0x36da, 0x6765, 0x3250,
+            0x36ce, 0x67dc, 0x3268, 0x36e3, 0x66fc, 0x323c, 0x36c5, 0x6846, 0x327c, 0x36c5, 0x6846, 0x327c,
+            0x36de, 0x6730, 0x3246, 0x36b5, 0x68f1, 0x329d, 0x36c0, 0x687b, 0x3286, 0x36b5, 0x68f1, 0x329d,
+            0x36a0, 0x69d2, 0x32c8, 0x36ac, 0x695b, 0x32b1, 0x36e9, 0x66ba, 0x3230, 0x36ca, 0x6811, 0x3272
+        },
+        {
+            0x6db4, 0xa944, 0x64a1, 0x6dc7, 0xaa17, 0x6479, 0x6db4, 0xa944, 0x64a1, 0x6db4, 0xa944, 0x64a1,
+            0x6d9d, 0xa855, 0x64d0, 0x6dc7, 0xaa17, 0x6479, 0x6d8a, 0xa782, 0x64f9, 0x6d8a, 0xa782, 0x64f9,
+            0x6dbd, 0xa9ad, 0x648d, 0x6d6b, 0xa62b, 0x653b, 0x6d80, 0xa719, 0x650d, 0x6d6b, 0xa62b, 0x653b,
+            0x6d41, 0xa46b, 0x6591, 0x6d58, 0xa558, 0x6563, 0x6dd3, 0xaa9b, 0x6460, 0x6d94, 0xa7ec, 0x64e4
+        },
+    },
+    // Mode 0x0F (16.4)
+    {
+        { 0x0f, 0xb4, 0xf5, 0x2f, 0x3b, 0xf9, 0x66, 0x1b, 0x05, 0x85, 0xfb, 0x5e, 0xc8, 0xca, 0x36, 0x03 },
+        {
+            0x2599, 0x64b6, 0x5fb5, 0x2599, 0x64b5, 0x5fb5, 0x259a, 0x64b6, 0x5fb6, 0x259b, 0x64b7, 0x5fb6,
+            0x259b, 0x64b8, 0x5fb7, 0x259c, 0x64b9, 0x5fb8, 0x259c, 0x64b9, 0x5fb8, 0x259a, 0x64b6, 0x5fb6,
+            0x259b, 0x64b7, 0x5fb6, 0x259c, 0x64b8, 0x5fb7, 0x259b, 0x64b8, 0x5fb7, 0x259c, 0x64b8, 0x5fb7,
+            0x259a, 0x64b7, 0x5fb6, 0x2599, 0x64b6, 0x5fb5, 0x2599, 0x64b6, 0x5fb5, 0x2599, 0x64b5, 0x5fb5
+        },
+        {
+            0x4b33, 0xae93, 0xb894, 0x4b33, 0xae94, 0xb895, 0x4b34, 0xae92, 0xb893, 0x4b36, 0xae90, 0xb892,
+            0x4b37, 0xae8f, 0xb891, 0x4b39, 0xae8d, 0xb88f, 0x4b39, 0xae8d, 0xb88f, 0x4b34, 0xae92, 0xb893,
+            0x4b36, 0xae90, 0xb892, 0x4b38, 0xae8e, 0xb890, 0x4b37, 0xae8f, 0xb891, 0x4b38, 0xae8e, 0xb890,
+            0x4b35, 0xae91, 0xb893, 0x4b33, 0xae93, 0xb894, 0x4b33, 0xae93, 0xb894, 0x4b33, 0xae94, 0xb895
+        },
+    },
+};
+
+//-----------------------------------------------------------------------------
+//      展開結果を比較します.
+//-----------------------------------------------------------------------------
+template<typename T>
+bool Match(const char* tag, uint32_t index, const T* actual, const T* expected, uint32_t count)
+{
+    for(auto i=0u; i<count; ++i)
+    {
+        if (actual[i] == expected[i])
+        { continue; }
+
+        fprintf(stderr, "%s[%u] : element %u mismatch. expected = 0x%04x, actual = 0x%04x\n",
+            tag, index, i, unsigned(expected[i]), unsigned(actual[i]));
+        return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      1ブロックを展開します.
+//-----------------------------------------------------------------------------
+bool DecodeBlock(asdx::BC_FORMAT format, const uint8_t* pBlock, void* pDst)
+{
+    auto pitch = 4 * asdx::GetBCDecodedPixelSize(format);
+    return asdx::DecodeBC(format, 4, 4, pBlock, asdx::GetBCBlockSize(format), static_cast<uint8_t*>(pDst), pitch);
+}
+
+//-----------------------------------------------------------------------------
+//      BC7の全モードの展開をテストします.
+//-----------------------------------------------------------------------------
+void TestBC7Modes()
+{
+    auto index = 0u;
+    for(auto& golden : kBC7Goldens)
+    {
+        uint8_t rgba[64] = {};
+        ASDX_CHECK(DecodeBlock(asdx::BC_FORMAT_BC7, golden.Block, rgba));
+        ASDX_CHECK(Match("BC7 Mode", index, rgba, golden.RGBA, 64));
+        index++;
+    }
+
+    // モードビットが立っていないブロックは透明な黒になる.
+    const uint8_t kReserved[16] = {};
+    uint8_t rgba[64];
+    memset(rgba, 0xCD, sizeof(rgba));
+    ASDX_CHECK(DecodeBlock(asdx::BC_FORMAT_BC7, kReserved, rgba));
+
+    const uint8_t kBlack[64] = {};
+    ASDX_CHECK(Match("BC7 Reserved", 8, rgba, kBlack, 64));
+}
+
+//-----------------------------------------------------------------------------
+//      BC6Hの全モードの展開をテストします.
+//-----------------------------------------------------------------------------
+void TestBC6HModes()
+{
+    auto index = 0u;
+    for(auto& golden : kBC6HGoldens)
+    {
+        const asdx::BC_FORMAT kFormats[2] = { asdx::BC_FORMAT_BC6H_UF16, asdx::BC_FORMAT_BC6H_SF16 };
+        const uint16_t*       kExpected[2] = { golden.Unsigned, golden.Signed };
+        const char*           kTags[2] = { "BC6H UF16 Mode", "BC6H SF16 Mode" };
+
+        for(auto k=0; k<2; ++k)
+        {
+            uint16_t rgba[64] = {};
+            ASDX_CHECK(DecodeBlock(kFormats[k], golden.Block, rgba));
+
+            uint16_t rgb  [48];
+            uint16_t alpha[16];
+            for(auto i=0; i<16; ++i)
+            {
+                rgb[i * 3 + 0] = rgba[i * 4 + 0];
+                rgb[i * 3 + 1] = rgba[i * 4 + 1];
+                rgb[i * 3 + 2] = rgba[i * 4 + 2];
+                alpha[i]       = rgba[i * 4 + 3];
+            }
+
+            const uint16_t kOnes[16] = {
+                kHalfOne, kHalfOne, kHalfOne, kHalfOne, kHalfOne, kHalfOne, kHalfOne, kHalfOne,
+                kHalfOne, kHalfOne, kHalfOne, kHalfOne, kHalfOne, kHalfOne, kHalfOne, kHalfOne,
+            };
+            ASDX_CHECK(Match(kTags[k], index, rgb, kExpected[k], 48));
+            ASDX_CHECK(Match(kTags[k], index, alpha, kOnes, 16));
+        }
+        index++;
+    }
+
+    // 予約モード (0x13) は不透明な黒になる.
+    uint8_t reserved[16] = {};
+    reserved[0] = 0x13;
+
+    for(auto format : { asdx::BC_FORMAT_BC6H_UF16, asdx::BC_FORMAT_BC6H_SF16 })
+    {
+        uint16_t rgba[64];
+        memset(rgba, 0xCD, sizeof(rgba));
+        ASDX_CHECK(DecodeBlock(format, reserved, rgba));
+
+        for(auto i=0; i<16; ++i)
+        {
+            ASDX_CHECK(rgba[i * 4 + 0] == 0);
+            ASDX_CHECK(rgba[i * 4 + 1] == 0);
+            ASDX_CHECK(rgba[i * 4 + 2] == 0);
+            ASDX_CHECK(rgba[i * 4 + 3] == kHalfOne);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      複数ブロックの画像を端数付きで展開できるかテストします.
+//-----------------------------------------------------------------------------
+void TestDecodeImage()
+{
+    // 8個のBC7ブロックを 4x2 ブロックに並べ, 右端と下端を切り落とした 14x7 に展開する.
+    const uint32_t kBlocksX  = 4;
+    const uint32_t kWidth    = 14;
+    const uint32_t kHeight   = 7;
+    const uint32_t kSrcPitch = kBlocksX * 16;
+    const uint32_t kDstPitch = kWidth * 4;
+
+    std::vector<uint8_t> blocks(kSrcPitch * 2);
+    for(auto i=0u; i<8; ++i)
+    { memcpy(&blocks[i * 16], kBC7Goldens[i].Block, 16); }
+
+    asdx::IThreadPool* pThreadPool = nullptr;
+    ASDX_CHECK(asdx::CreateThreadPool(2, &pThreadPool));
+
+    for(auto pool : { static_cast<asdx::IThreadPool*>(nullptr), pThreadPool })
+    {
+        std::vector<uint8_t> image(kDstPitch * kHeight, 0xCD);
+        ASDX_CHECK(asdx::DecodeBC(asdx::BC_FORMAT_BC7, kWidth, kHeight, blocks.data(), kSrcPitch, image.data(), kDstPitch, pool));
+
+        auto mismatch = 0u;
+        for(auto y=0u; y<kHeight; ++y)
+        {
+            for(auto x=0u; x<kWidth; ++x)
+            {
+                auto& golden = kBC7Goldens[(y / 4) * kBlocksX + (x / 4)];
+                auto  offset = ((y % 4) * 4 + (x % 4)) * 4;
+                if (memcmp(&image[y * kDstPitch + x * 4], golden.RGBA + offset, 4) != 0)
+                { mismatch++; }
+            }
+        }
+        ASDX_CHECK(mismatch == 0);
+    }
+
+    if (pThreadPool != nullptr)
+    { pThreadPool->Release(); }
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+    TestBC7Modes();
+    TestBC6HModes();
+    TestDecodeImage();
+
+    return asdx::test::Finish("TestBlockCompression");
+}
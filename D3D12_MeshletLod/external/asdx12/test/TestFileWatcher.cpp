@@ -0,0 +1,313 @@
+﻿//-----------------------------------------------------------------------------
+// File : TestFileWatcher.cpp
+// Desc : FileWatcher Test (inotify).
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <edit/asdxFileWatcher.h>
+#include "asdxTest.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const uint32_t kCoalesceMsec = 100;     // 変更をまとめる時間.
+const uint32_t kTimeoutMsec  = 3000;    // 通知を待つ最大時間.
+
+///////////////////////////////////////////////////////////////////////////////
+// Listener class
+///////////////////////////////////////////////////////////////////////////////
+class Listener : public asdx::IFileUpdateListener
+{
+public:
+    std::vector<asdx::FileUpdateEventArgs> Events;
+
+    void OnUpdate(const asdx::FileUpdateEventArgs& args) override
+    { Events.push_back(args); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定パスの通知を検索します.
+    //-------------------------------------------------------------------------
+    const asdx::FileUpdateEventArgs* Find(const char* path) const
+    {
+        for(auto& event : Events)
+        {
+            if (event.RelativePath == path)
+            { return &event; }
+        }
+        return nullptr;
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      指定時間待機します.
+//-----------------------------------------------------------------------------
+void SleepMsec(uint32_t msec)
+{ std::this_thread::sleep_for(std::chrono::milliseconds(msec)); }
+
+//-----------------------------------------------------------------------------
+//      ファイルに少しずつ書き込みます.
+//-----------------------------------------------------------------------------
+void WriteChunks(const std::string& path, int count)
+{
+    auto pFile = fopen(path.c_str(), "w");
+    if (pFile == nullptr)
+    {
+        fprintf(stderr, "Error : File Open Failed. path = %s\n", path.c_str());
+        return;
+    }
+
+    for(auto i=0; i<count; ++i)
+    {
+        fputs("float4 main() : SV_TARGET { return 1; }\n", pFile);
+        fflush(pFile);
+        SleepMsec(2);
+    }
+
+    fclose(pFile);
+}
+
+//-----------------------------------------------------------------------------
+//      ディレクトリを中身ごと削除します.
+//-----------------------------------------------------------------------------
+void RemoveTree(const std::string& path)
+{
+    auto dir = opendir(path.c_str());
+    if (dir != nullptr)
+    {
+        while(auto entry = readdir(dir))
+        {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            { continue; }
+
+            auto child = path + "/" + entry->d_name;
+
+            struct stat info = {};
+            if (lstat(child.c_str(), &info) == 0 && S_ISDIR(info.st_mode))
+            { RemoveTree(child); }
+            else
+            { unlink(child.c_str()); }
+        }
+        closedir(dir);
+    }
+
+    rmdir(path.c_str());
+}
+
+//-----------------------------------------------------------------------------
+//      一時ディレクトリを作成します.
+//-----------------------------------------------------------------------------
+std::string MakeTempDirectory()
+{
+    auto base = getenv("TMPDIR");
+    std::string path = (base != nullptr && base[0] != '\0') ? base : "/tmp";
+    path += "/asdx12_watchXXXXXX";
+
+    std::vector<char> buf(path.begin(), path.end());
+    buf.push_back('\0');
+
+    if (mkdtemp(buf.data()) == nullptr)
+    { return std::string(); }
+
+    return buf.data();
+}
+
+//-----------------------------------------------------------------------------
+//      通知が届くまで待ってから, まとめる時間内の残りも受け取ります.
+//-----------------------------------------------------------------------------
+void WaitEvents(asdx::FileWatcher& watcher, Listener& listener)
+{
+    listener.Events.clear();
+
+    auto start = std::chrono::steady_clock::now();
+    while(listener.Events.empty())
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        if (elapsed > kTimeoutMsec)
+        { break; }
+
+        SleepMsec(10);
+        watcher.Dispatch();
+    }
+
+    SleepMsec(kCoalesceMsec * 3);
+    watcher.Dispatch();
+}
+
+//-----------------------------------------------------------------------------
+//      何も通知されないことを確認するために待機します.
+//-----------------------------------------------------------------------------
+void WaitSilence(asdx::FileWatcher& watcher, Listener& listener)
+{
+    listener.Events.clear();
+    SleepMsec(kCoalesceMsec * 3);
+    watcher.Dispatch();
+}
+
+//-----------------------------------------------------------------------------
+//      通知内容を表示します.
+//-----------------------------------------------------------------------------
+void Dump(const char* tag, const Listener& listener)
+{
+    printf("%s :\n", tag);
+    for(auto& event : listener.Events)
+    { printf("    type = %d, path = %s\n", int(event.Type), event.RelativePath.c_str()); }
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+    auto root    = MakeTempDirectory();
+    auto outside = MakeTempDirectory();
+    if (root.empty() || outside.empty())
+    {
+        fprintf(stderr, "Error : mkdtemp() Failed.\n");
+        return 1;
+    }
+
+    mkdir((root + "/sub").c_str(), 0755);
+    WriteChunks(root + "/a.hlsl", 1);
+
+    Listener listener;
+
+    asdx::FileWatcher watcher;
+    asdx::FileWatcher::Desc desc = {};
+    desc.DirectoryPath  = root.c_str();
+    desc.BufferSize     = 4096;
+    desc.WaitTimeMsec   = 10;
+    desc.Recursive      = true;
+    desc.CoalesceMsec   = kCoalesceMsec;
+    desc.pListeners.push_back(&listener);
+
+    ASDX_CHECK(watcher.Init(desc));
+
+    // 連続した書き込みは CoalesceMsec 経過後に1回だけ通知される.
+    {
+        WriteChunks(root + "/a.hlsl", 20);
+        ASDX_CHECK(watcher.Dispatch() == 0);
+
+        WaitEvents(watcher, listener);
+        Dump("coalesce", listener);
+        ASDX_CHECK(listener.Events.size() == 1);
+        ASDX_CHECK(listener.Find("a.hlsl") != nullptr && listener.Find("a.hlsl")->Type == asdx::ACTION_MODIFIED);
+        ASDX_CHECK(listener.Events.empty() || listener.Events[0].DirectoryPath == root);
+    }
+
+    // 一時ファイルに書いてリネームする保存は, 一時ファイルを通知せずに新しい名前だけを通知する.
+    {
+        WriteChunks(root + "/a.hlsl.tmp", 3);
+        rename((root + "/a.hlsl.tmp").c_str(), (root + "/a.hlsl").c_str());
+
+        WaitEvents(watcher, listener);
+        Dump("write-to-tmp + rename", listener);
+        ASDX_CHECK(listener.Events.size() == 1);
+        ASDX_CHECK(listener.Find("a.hlsl.tmp") == nullptr);
+        ASDX_CHECK(listener.Find("a.hlsl") != nullptr && listener.Find("a.hlsl")->Type == asdx::ACTION_RENAMED_NEW_NAME);
+    }
+
+    // 消して作り直す保存は変更として通知される.
+    {
+        unlink((root + "/a.hlsl").c_str());
+        WriteChunks(root + "/a.hlsl", 2);
+
+        WaitEvents(watcher, listener);
+        Dump("delete + re-create", listener);
+        ASDX_CHECK(listener.Events.size() == 1);
+        ASDX_CHECK(listener.Find("a.hlsl") != nullptr && listener.Find("a.hlsl")->Type == asdx::ACTION_MODIFIED);
+    }
+
+    // 監視開始後に作られた入れ子のディレクトリも監視対象に加わる.
+    {
+        mkdir((root + "/sub/new").c_str(), 0755);
+        mkdir((root + "/sub/new/deep").c_str(), 0755);
+        WriteChunks(root + "/sub/new/deep/c.hlsl", 3);
+
+        WaitEvents(watcher, listener);
+        Dump("nested directory", listener);
+        ASDX_CHECK(listener.Find("sub/new")             != nullptr);
+        ASDX_CHECK(listener.Find("sub/new/deep")        != nullptr);
+        ASDX_CHECK(listener.Find("sub/new/deep/c.hlsl") != nullptr);
+
+        // 追加済みのディレクトリ内の変更も拾える.
+        WriteChunks(root + "/sub/new/deep/c.hlsl", 1);
+
+        WaitEvents(watcher, listener);
+        Dump("nested directory (modify)", listener);
+        ASDX_CHECK(listener.Events.size() == 1);
+        ASDX_CHECK(listener.Find("sub/new/deep/c.hlsl") != nullptr && listener.Find("sub/new/deep/c.hlsl")->Type == asdx::ACTION_MODIFIED);
+    }
+
+    // 監視対象の外へ移動したディレクトリは, 子も含めて監視から外れる.
+    {
+        rename((root + "/sub/new").c_str(), (outside + "/new").c_str());
+
+        WaitEvents(watcher, listener);
+        Dump("move out (RemoveWatch)", listener);
+        ASDX_CHECK(listener.Events.size() == 1);
+        ASDX_CHECK(listener.Find("sub/new") != nullptr && listener.Find("sub/new")->Type == asdx::ACTION_RENAMED_OLD_NAME);
+
+        WriteChunks(outside + "/new/deep/c.hlsl", 2);
+        WriteChunks(outside + "/new/d.hlsl", 2);
+
+        WaitSilence(watcher, listener);
+        Dump("move out (after)", listener);
+        ASDX_CHECK(listener.Events.empty());
+
+        // 戻すと再び監視される.
+        rename((outside + "/new").c_str(), (root + "/moved").c_str());
+
+        WaitEvents(watcher, listener);
+        Dump("move in", listener);
+        ASDX_CHECK(listener.Find("moved") != nullptr && listener.Find("moved")->Type == asdx::ACTION_RENAMED_NEW_NAME);
+        ASDX_CHECK(listener.Find("moved/deep/c.hlsl") != nullptr);
+
+        WriteChunks(root + "/moved/deep/c.hlsl", 1);
+
+        WaitEvents(watcher, listener);
+        Dump("move in (modify)", listener);
+        ASDX_CHECK(listener.Events.size() == 1);
+        ASDX_CHECK(listener.Find("moved/deep/c.hlsl") != nullptr);
+    }
+
+    // 作ってすぐ消えた一時ファイルは通知しない.
+    {
+        WriteChunks(root + "/4913", 1);
+        unlink((root + "/4913").c_str());
+
+        WaitSilence(watcher, listener);
+        Dump("transient file", listener);
+        ASDX_CHECK(listener.Events.empty());
+    }
+
+    // 終了後は通知待ちの変更も破棄される.
+    {
+        WriteChunks(root + "/a.hlsl", 1);
+        watcher.Term();
+        ASDX_CHECK(watcher.Dispatch() == 0);
+    }
+
+    RemoveTree(root);
+    RemoveTree(outside);
+
+    return asdx::test::Finish("TestFileWatcher");
+}
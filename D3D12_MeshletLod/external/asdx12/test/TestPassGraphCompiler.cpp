@@ -0,0 +1,390 @@
+﻿//-----------------------------------------------------------------------------
+// File : TestPassGraphCompiler.cpp
+// Desc : PassGraphCompiler Test.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <string>
+#include <rs/asdxPassGraphCompiler.h>
+#include "asdxTest.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const auto kCommon = asdx::RESOURCE_INFO_FLAG_STATE_COMMON;
+const auto kRead   = asdx::RESOURCE_INFO_FLAG_STATE_READ;
+const auto kWrite  = asdx::RESOURCE_INFO_FLAG_STATE_WRITE;
+
+//-----------------------------------------------------------------------------
+//      ステートを文字に変換します.
+//-----------------------------------------------------------------------------
+char ToChar(asdx::RESOURCE_INFO_FLAGS state)
+{
+    switch(state)
+    {
+    case asdx::RESOURCE_INFO_FLAG_STATE_COMMON: return 'C';
+    case asdx::RESOURCE_INFO_FLAG_STATE_READ:   return 'R';
+    case asdx::RESOURCE_INFO_FLAG_STATE_WRITE:  return 'W';
+    default:                                    return '?';
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Recorder class
+///////////////////////////////////////////////////////////////////////////////
+class Recorder : public asdx::IPassCommandRecorder
+{
+public:
+    //! 記録したコマンド列です.
+    //!   W<n>              : キュー間同期.
+    //!   B{<r>:<s>><s>}    : バリア (BEGIN_ONLY は /b, END_ONLY は /e が付く).
+    //!   G<n>, C<n>, G-    : グラフィックス, コンピュートでのパス実行, バリア専用ステップ.
+    std::string Log;
+
+    void Wait(uint8_t syncFlag) override
+    { Append("W" + std::to_string(syncFlag)); }
+
+    void Barrier(uint32_t count, const asdx::PassBarrier* pBarriers) override
+    {
+        std::string text = "B{";
+        for(auto i=0u; i<count; ++i)
+        {
+            auto& barrier = pBarriers[i];
+            if (i > 0)
+            { text += ","; }
+
+            text += std::to_string(barrier.Resource) + ":" + ToChar(barrier.Before) + ">" + ToChar(barrier.After);
+
+            if (barrier.Split == asdx::PASS_BARRIER_SPLIT_BEGIN_ONLY)
+            { text += "/b"; }
+            else if (barrier.Split == asdx::PASS_BARRIER_SPLIT_END_ONLY)
+            { text += "/e"; }
+        }
+        text += "}";
+        Append(text);
+    }
+
+    void Execute(uint32_t pass, bool asyncCompute) override
+    {
+        std::string text = asyncCompute ? "C" : "G";
+        text += (pass == asdx::PassGraphCompiler::kInvalidIndex) ? std::string("-") : std::to_string(pass);
+        Append(text);
+    }
+
+private:
+    void Append(const std::string& text)
+    {
+        if (!Log.empty())
+        { Log += " "; }
+        Log += text;
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      実行計画を記録した文字列を取得します.
+//-----------------------------------------------------------------------------
+std::string Record(const asdx::PassGraphPlan& plan)
+{
+    Recorder recorder;
+    asdx::RecordPlan(plan, &recorder);
+    return recorder.Log;
+}
+
+//-----------------------------------------------------------------------------
+//      記録結果を比較します.
+//-----------------------------------------------------------------------------
+bool Match(const char* tag, const std::string& actual, const char* expected)
+{
+    if (actual == expected)
+    { return true; }
+
+    fprintf(stderr, "%s :\n    expected = %s\n    actual   = %s\n", tag, expected, actual.c_str());
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+//      参照されないパスのカリングをテストします.
+//-----------------------------------------------------------------------------
+void TestCulling()
+{
+    asdx::PassGraphCompiler compiler;
+    compiler.Begin();
+
+    auto backBuffer = compiler.AddResource(kWrite, false, true);
+    auto unused     = compiler.AddResource(kCommon, false, false);
+    auto chainA     = compiler.AddResource(kCommon, false, false);
+    auto chainB     = compiler.AddResource(kCommon, false, false);
+    auto color      = compiler.AddResource(kCommon, false, false);
+
+    // 0 : 誰も読まない一時リソースへの書き込みだけなのでカリングされる.
+    compiler.AddPass(0, false);
+    compiler.AddAccess(unused, kWrite);
+
+    // 1, 2 : 最終的に読まれない連鎖なので両方カリングされる.
+    compiler.AddPass(1, false);
+    compiler.AddAccess(chainA, kWrite);
+    compiler.AddPass(2, false);
+    compiler.AddAccess(chainA, kRead);
+    compiler.AddAccess(chainB, kWrite);
+
+    // 3 : 4 が読むので残る.
+    compiler.AddPass(3, false);
+    compiler.AddAccess(color, kWrite);
+
+    // 4 : インポートリソースへの書き込みなので残る.
+    compiler.AddPass(4, false);
+    compiler.AddAccess(color, kRead);
+    compiler.AddAccess(backBuffer, kWrite);
+
+    // 5 : 書き込みを持たないパスは副作用があるとみなして残る.
+    compiler.AddPass(5, false);
+    compiler.AddAccess(color, kRead);
+
+    auto& plan = compiler.Compile();
+    ASDX_CHECK(plan.CulledCount == 3);
+    ASDX_CHECK(Match("culling", Record(plan), "B{4:C>W} G3 B{4:W>R} G4 G5"));
+}
+
+//-----------------------------------------------------------------------------
+//      依存関係の無いパスの並び替えをテストします.
+//-----------------------------------------------------------------------------
+void TestReorder()
+{
+    asdx::PassGraphCompiler compiler;
+
+    auto build = [&]()
+    {
+        compiler.Begin();
+
+        auto gbuffer = compiler.AddResource(kWrite, false, true);
+        auto light   = compiler.AddResource(kWrite, true,  true);
+        auto shadow  = compiler.AddResource(kWrite, false, true);
+
+        compiler.AddPass(0, false);
+        compiler.AddAccess(gbuffer, kWrite);
+
+        // 1 : 他のパスと依存の無い非同期コンピュートは先頭へ移動する.
+        compiler.AddPass(1, true);
+        compiler.AddAccess(light, kWrite);
+
+        // 2 : 0 の後でなければならない.
+        compiler.AddPass(2, false);
+        compiler.AddAccess(gbuffer, kRead);
+        compiler.AddAccess(shadow,  kWrite);
+    };
+
+    // 0 と 2 の間にコンピュートが挟まるので, 遷移は分割バリアになる.
+    build();
+    ASDX_CHECK(Match("reorder off", Record(compiler.Compile()), "G0 B{0:W>R/b} C1 B{0:W>R/e} G2"));
+
+    compiler.SetReorder(true);
+    build();
+    ASDX_CHECK(Match("reorder on", Record(compiler.Compile()), "C1 G0 B{0:W>R} G2"));
+
+    // 並び替えの設定はキャッシュキーに含まれる.
+    ASDX_CHECK(!compiler.IsCacheHit());
+}
+
+//-----------------------------------------------------------------------------
+//      キュー間同期をテストします.
+//-----------------------------------------------------------------------------
+void TestCrossQueueWait()
+{
+    asdx::PassGraphCompiler compiler;
+    compiler.Begin();
+
+    auto depth  = compiler.AddResource(kWrite, false, false);
+    auto ao     = compiler.AddResource(kWrite, true,  false);
+    auto output = compiler.AddResource(kWrite, false, true);
+
+    compiler.AddPass(0, false);
+    compiler.AddAccess(depth, kWrite);
+
+    // 1 : グラフィックスの結果を読むのでコンピュートキューが待機する.
+    //     ステート遷移はグラフィックスキューで行い, 0 の実行後バリアにまとめる.
+    compiler.AddPass(1, true);
+    compiler.AddAccess(depth, kRead);
+    compiler.AddAccess(ao,    kWrite);
+
+    // 2 : コンピュートの結果を読むのでグラフィックスキューが待機する.
+    compiler.AddPass(2, false);
+    compiler.AddAccess(ao,     kRead);
+    compiler.AddAccess(output, kWrite);
+
+    auto& plan = compiler.Compile();
+    ASDX_CHECK(plan.Steps.size() == 3);
+    ASDX_CHECK(plan.Steps.size() == 3 && plan.Steps[1].SyncFlag == asdx::SYNC_FLAG_GRAPHICS_TO_COMPUTE);
+    ASDX_CHECK(plan.Steps.size() == 3 && plan.Steps[2].SyncFlag == asdx::SYNC_FLAG_COMPUTE_TO_GRAPHICS);
+    ASDX_CHECK(Match("cross queue", Record(plan), "G0 B{0:W>R} W1 C1 W2 B{1:W>R} G2"));
+
+    // 最後に使用したキューとステートが次フレームへ引き継がれる.
+    ASDX_CHECK(plan.FinalCompute[ao] == 0);
+    ASDX_CHECK(plan.FinalStates[ao] == kRead);
+}
+
+//-----------------------------------------------------------------------------
+//      コンパイルキャッシュをテストします.
+//-----------------------------------------------------------------------------
+void TestCache()
+{
+    asdx::PassGraphCompiler compiler;
+
+    auto build = [&](asdx::RESOURCE_INFO_FLAGS access)
+    {
+        compiler.Begin();
+
+        auto color  = compiler.AddResource(kCommon, false, false);
+        auto output = compiler.AddResource(kWrite,  false, true);
+
+        compiler.AddPass(10, false);
+        compiler.AddAccess(color, kWrite);
+
+        compiler.AddPass(11, false);
+        compiler.AddAccess(color,  access);
+        compiler.AddAccess(output, kWrite);
+    };
+
+    build(kRead);
+    auto  expected = Record(compiler.Compile());
+    auto  hash     = compiler.GetHash();
+    ASDX_CHECK(!compiler.IsCacheHit());
+    ASDX_CHECK(Match("cache first", expected, "B{0:C>W} G0 B{0:W>R} G1"));
+
+    // 同じグラフはキャッシュから同じ計画が返る.
+    build(kRead);
+    auto& hit = compiler.Compile();
+    ASDX_CHECK(compiler.IsCacheHit());
+    ASDX_CHECK(compiler.GetHash() == hash);
+    ASDX_CHECK(Match("cache hit", Record(hit), expected.c_str()));
+
+    // アクセスが変わればキャッシュミス. 読まれなくなった 0 はカリングされる.
+    build(kWrite);
+    auto& miss = compiler.Compile();
+    ASDX_CHECK(!compiler.IsCacheHit());
+    ASDX_CHECK(compiler.GetHash() != hash);
+    ASDX_CHECK(miss.CulledCount == 1);
+    ASDX_CHECK(Match("cache miss", Record(miss), "B{0:C>W} G1"));
+
+    // 元のグラフは追い出されていない.
+    build(kRead);
+    compiler.Compile();
+    ASDX_CHECK(compiler.IsCacheHit());
+
+    // 破棄後はミスになる.
+    compiler.ClearCache();
+    build(kRead);
+    ASDX_CHECK(Match("cache clear", Record(compiler.Compile()), expected.c_str()));
+    ASDX_CHECK(!compiler.IsCacheHit());
+}
+
+//-----------------------------------------------------------------------------
+//      分割バリアとバリアのまとめ方をテストします.
+//-----------------------------------------------------------------------------
+void TestSplitBarrier()
+{
+    // 0 で書いて 3 で読む. 間の 1, 2 の実行中に遷移させる.
+    {
+        asdx::PassGraphCompiler compiler;
+        compiler.Begin();
+
+        auto shadow = compiler.AddResource(kCommon, false, false);
+        auto a      = compiler.AddResource(kWrite,  false, true);
+        auto b      = compiler.AddResource(kWrite,  false, true);
+        auto output = compiler.AddResource(kWrite,  false, true);
+
+        compiler.AddPass(0, false);
+        compiler.AddAccess(shadow, kWrite);
+        compiler.AddPass(1, false);
+        compiler.AddAccess(a, kWrite);
+        compiler.AddPass(2, false);
+        compiler.AddAccess(b, kWrite);
+        compiler.AddPass(3, false);
+        compiler.AddAccess(shadow, kRead);
+        compiler.AddAccess(output, kWrite);
+
+        auto& plan = compiler.Compile();
+        ASDX_CHECK(plan.SplitCount == 1);
+        ASDX_CHECK(plan.BatchCount == 3);
+        ASDX_CHECK(plan.Steps.size() == 4);
+
+        // BEGIN_ONLY は 0 の実行後, END_ONLY は 3 の実行前ではなく 2 の実行後にまとめられる.
+        if (plan.Steps.size() == 4)
+        {
+            auto& begin = plan.Steps[0];
+            auto& end   = plan.Steps[2];
+            ASDX_CHECK(begin.PostBarrierCount == 1);
+            ASDX_CHECK(begin.PostBarrierCount == 1 && plan.Barriers[begin.PostBarrierOffset].Split == asdx::PASS_BARRIER_SPLIT_BEGIN_ONLY);
+            ASDX_CHECK(end.PostBarrierCount == 1);
+            ASDX_CHECK(end.PostBarrierCount == 1 && plan.Barriers[end.PostBarrierOffset].Split == asdx::PASS_BARRIER_SPLIT_END_ONLY);
+            ASDX_CHECK(plan.Steps[3].PreBarrierCount == 0);
+        }
+
+        ASDX_CHECK(Match("split 0->3", Record(plan), "B{0:C>W} G0 B{0:W>R/b} G1 G2 B{0:W>R/e} G3"));
+    }
+
+    // コンピュートの前に入るバリア専用ステップは, 直前のグラフィックスの実行後バリアにまとめられて消える.
+    {
+        asdx::PassGraphCompiler compiler;
+        compiler.Begin();
+
+        auto depth  = compiler.AddResource(kCommon, false, false);
+        auto output = compiler.AddResource(kWrite,  true,  true);
+
+        compiler.AddPass(0, false);
+        compiler.AddAccess(depth, kWrite);
+        compiler.AddPass(1, true);
+        compiler.AddAccess(depth,  kRead);
+        compiler.AddAccess(output, kWrite);
+
+        auto& plan = compiler.Compile();
+        ASDX_CHECK(plan.Steps.size() == 2);
+        ASDX_CHECK(plan.SplitCount == 0);
+        ASDX_CHECK(plan.BatchCount == 2);
+        for(auto& step : plan.Steps)
+        { ASDX_CHECK(step.Pass != asdx::PassGraphCompiler::kInvalidIndex); }
+
+        ASDX_CHECK(Match("merge barrier-only step", Record(plan), "B{0:C>W} G0 B{0:W>R} W1 C1"));
+    }
+
+    // 直前がコンピュートの場合はまとめる先が無いので, バリア専用ステップが残る.
+    {
+        asdx::PassGraphCompiler compiler;
+        compiler.Begin();
+
+        auto buffer = compiler.AddResource(kWrite, true, false);
+        auto output = compiler.AddResource(kWrite, true, true);
+
+        compiler.AddPass(0, true);
+        compiler.AddAccess(buffer, kWrite);
+        compiler.AddPass(1, true);
+        compiler.AddAccess(buffer, kRead);
+        compiler.AddAccess(output, kWrite);
+
+        auto& plan = compiler.Compile();
+        ASDX_CHECK(plan.Steps.size() == 3);
+        ASDX_CHECK(Match("keep barrier-only step", Record(plan), "C0 W2 B{0:W>R} G- W1 C1"));
+    }
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+    TestCulling();
+    TestReorder();
+    TestCrossQueueWait();
+    TestCache();
+    TestSplitBarrier();
+
+    return asdx::test::Finish("TestPassGraphCompiler");
+}
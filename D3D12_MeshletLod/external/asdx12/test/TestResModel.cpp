@@ -0,0 +1,479 @@
+﻿//-----------------------------------------------------------------------------
+// File : TestResModel.cpp
+// Desc : ResModel OBJ Loader Test.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <res/asdxResModel.h>
+#include "asdxTest.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const char* kObjPath = "asdx12_test_res_model.obj";
+const char* kMtlPath = "asdx12_test_res_model.mtl";
+const char* kBinPath = "asdx12_test_res_model.amdl";
+
+// マテリアルの並びは MTL の newmtl 順.
+const char kMtl[] =
+    "newmtl red\n"
+    "newmtl blue\n";
+
+// 1. usemtl より前の四角形(法線あり).
+// 2. 負数のインデックスで参照する三角形(法線なし).
+// 3. 2番目の頂点だけ法線が無い三角形.
+// 4. 既に使ったマテリアルへ戻る四角形.
+const char kObj[] =
+    "mtllib asdx12_test_res_model.mtl\n"
+    "o first\n"
+    "v 0 0 0\n"
+    "v 1 0 0\n"
+    "v 1 1 0\n"
+    "v 0 1 0\n"
+    "vt 0 0\n"
+    "vt 1 0\n"
+    "vt 1 1\n"
+    "vn 0 1 0\n"
+    "f 1//1 2//1 3//1 4//1\n"
+    "o second\n"
+    "usemtl blue\n"
+    "v 0 0 1\n"
+    "v 1 0 1\n"
+    "v 1 1 1\n"
+    "f -3 -2 -1\n"
+    "usemtl red\n"
+    "f 1/1/1 2/2 3/3/1\n"
+    "usemtl blue\n"
+    "f 5/1 6/2 7/3 -7/3\n";
+
+//-----------------------------------------------------------------------------
+//      ファイルに書き出します.
+//-----------------------------------------------------------------------------
+bool WriteText(const char* path, const char* text)
+{
+    auto pFile = fopen(path, "wb");
+    if (pFile == nullptr)
+    { return false; }
+
+    auto size = strlen(text);
+    auto ret  = fwrite(text, 1, size, pFile) == size;
+    fclose(pFile);
+    return ret;
+}
+
+//-----------------------------------------------------------------------------
+//      ベクトルが一致するかチェックします.
+//-----------------------------------------------------------------------------
+bool IsNear(const asdx::Vector3& value, float x, float y, float z)
+{
+    const auto kEpsilon = 1e-5f;
+    return fabsf(value.x - x) < kEpsilon
+        && fabsf(value.y - y) < kEpsilon
+        && fabsf(value.z - z) < kEpsilon;
+}
+
+//-----------------------------------------------------------------------------
+//      ベクトルが一致するかチェックします.
+//-----------------------------------------------------------------------------
+bool IsNear(const asdx::Vector2& value, float x, float y)
+{
+    const auto kEpsilon = 1e-5f;
+    return fabsf(value.x - x) < kEpsilon
+        && fabsf(value.y - y) < kEpsilon;
+}
+
+//-----------------------------------------------------------------------------
+//      バイト列をファイルに書き出します.
+//-----------------------------------------------------------------------------
+bool WriteBytes(const char* path, const std::vector<uint8_t>& data, size_t size)
+{
+    auto pFile = fopen(path, "wb");
+    if (pFile == nullptr)
+    { return false; }
+
+    auto ret = fwrite(data.data(), 1, size, pFile) == size;
+    fclose(pFile);
+    return ret;
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルを全て読み込みます.
+//-----------------------------------------------------------------------------
+std::vector<uint8_t> ReadBytes(const char* path)
+{
+    std::vector<uint8_t> result;
+
+    auto pFile = fopen(path, "rb");
+    if (pFile == nullptr)
+    { return result; }
+
+    fseek(pFile, 0, SEEK_END);
+    result.resize(size_t(ftell(pFile)));
+    fseek(pFile, 0, SEEK_SET);
+
+    if (fread(result.data(), 1, result.size(), pFile) != result.size())
+    { result.clear(); }
+
+    fclose(pFile);
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      配列とマップした配列が一致するかチェックします.
+//-----------------------------------------------------------------------------
+template<typename T>
+bool IsSame(const std::vector<T>& lhs, const asdx::BinaryArrary<T>& rhs)
+{
+    return lhs.size() == rhs.size()
+        && (lhs.empty() || memcmp(lhs.data(), rhs.data(), sizeof(T) * lhs.size()) == 0);
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュが一致するかチェックします.
+//-----------------------------------------------------------------------------
+bool IsSame(const asdx::ResMesh& lhs, const asdx::ResMeshBinary& rhs)
+{
+    if (lhs.Name.size() + 1 != rhs.Name.size()
+     || memcmp(lhs.Name.c_str(), rhs.Name.data(), rhs.Name.size()) != 0)
+    { return false; }
+
+    for(auto i=0u; i<asdx::ResMesh::MAX_TEXCOORD_LAYERS; ++i)
+    {
+        if (!IsSame(lhs.TexCoords[i], rhs.TexCoords[i]))
+        { return false; }
+    }
+
+    return lhs.MaterialId         == rhs.MaterialId
+        && lhs.BoneInfluenceCount == rhs.BoneInfluenceCount
+        && IsSame(lhs.Positions,     rhs.Positions)
+        && IsSame(lhs.Normals,       rhs.Normals)
+        && IsSame(lhs.Tangents,      rhs.Tangents)
+        && IsSame(lhs.Colors,        rhs.Colors)
+        && IsSame(lhs.BoneIndices,   rhs.BoneIndices)
+        && IsSame(lhs.BoneWeights,   rhs.BoneWeights)
+        && IsSame(lhs.VertexIndices, rhs.VertexIndices);
+}
+
+//-----------------------------------------------------------------------------
+//      ファイル先頭からのオフセットを求めます.
+//-----------------------------------------------------------------------------
+size_t GetOffset(const asdx::ResModelBinary* pModel, const void* ptr)
+{ return size_t(reinterpret_cast<const uint8_t*>(ptr) - reinterpret_cast<const uint8_t*>(pModel)); }
+
+//-----------------------------------------------------------------------------
+//      32bit値を書き換えます.
+//-----------------------------------------------------------------------------
+void Patch(std::vector<uint8_t>& data, size_t offset, uint32_t value)
+{ memcpy(&data[offset], &value, sizeof(value)); }
+
+//-----------------------------------------------------------------------------
+//      OBJ の面の書き方の違いを読み込めるかテストします.
+//-----------------------------------------------------------------------------
+void TestLoadOBJ()
+{
+    ASDX_CHECK(WriteText(kMtlPath, kMtl));
+    ASDX_CHECK(WriteText(kObjPath, kObj));
+
+    asdx::ResModel model;
+    ASDX_CHECK(model.LoadFromFileA(kObjPath));
+
+    // マテリアル毎に1メッシュ. マテリアル無しは最後に並ぶ.
+    ASDX_CHECK(model.Materials.size() == 2);
+    ASDX_CHECK(model.Meshes.size() == 3);
+    if (model.Materials.size() != 2 || model.Meshes.size() != 3)
+    {
+        remove(kObjPath);
+        remove(kMtlPath);
+        return;
+    }
+
+    ASDX_CHECK(model.Materials[0] == "red");
+    ASDX_CHECK(model.Materials[1] == "blue");
+
+    auto& red  = model.Meshes[0];
+    auto& blue = model.Meshes[1];
+    auto& none = model.Meshes[2];
+
+    ASDX_CHECK(red .MaterialId == 0);
+    ASDX_CHECK(blue.MaterialId == 1);
+    ASDX_CHECK(none.MaterialId == UINT32_MAX);
+
+    // 四角形は扇状に2つの三角形になる.
+    ASDX_CHECK(none.Positions.size() == 6);
+    ASDX_CHECK(none.VertexIndices.size() == 6);
+    if (none.Positions.size() == 6)
+    {
+        ASDX_CHECK(IsNear(none.Positions[0], 0.0f, 0.0f, 0.0f));
+        ASDX_CHECK(IsNear(none.Positions[1], 1.0f, 0.0f, 0.0f));
+        ASDX_CHECK(IsNear(none.Positions[2], 1.0f, 1.0f, 0.0f));
+        ASDX_CHECK(IsNear(none.Positions[3], 0.0f, 0.0f, 0.0f));
+        ASDX_CHECK(IsNear(none.Positions[4], 1.0f, 1.0f, 0.0f));
+        ASDX_CHECK(IsNear(none.Positions[5], 0.0f, 1.0f, 0.0f));
+
+        // ファイルの法線は面の向きと違っても書き換えない.
+        for(auto& normal : none.Normals)
+        { ASDX_CHECK(IsNear(normal, 0.0f, 1.0f, 0.0f)); }
+    }
+
+    // 赤 : 2番目の頂点だけ面から法線を計算する.
+    ASDX_CHECK(red.Positions.size() == 3);
+    ASDX_CHECK(red.TexCoords[0].size() == 3);
+    if (red.Positions.size() == 3 && red.TexCoords[0].size() == 3)
+    {
+        ASDX_CHECK(IsNear(red.Normals[0], 0.0f, 1.0f, 0.0f));
+        ASDX_CHECK(IsNear(red.Normals[1], 0.0f, 0.0f, 1.0f));
+        ASDX_CHECK(IsNear(red.Normals[2], 0.0f, 1.0f, 0.0f));
+
+        ASDX_CHECK(IsNear(red.TexCoords[0][0], 0.0f, 0.0f));
+        ASDX_CHECK(IsNear(red.TexCoords[0][1], 1.0f, 0.0f));
+        ASDX_CHECK(IsNear(red.TexCoords[0][2], 1.0f, 1.0f));
+    }
+
+    // 青 : 負数のインデックスの三角形と, 後から戻ってきた四角形が1つにまとまる.
+    ASDX_CHECK(blue.Positions.size() == 9);
+    if (blue.Positions.size() == 9)
+    {
+        ASDX_CHECK(IsNear(blue.Positions[0], 0.0f, 0.0f, 1.0f));
+        ASDX_CHECK(IsNear(blue.Positions[1], 1.0f, 0.0f, 1.0f));
+        ASDX_CHECK(IsNear(blue.Positions[2], 1.0f, 1.0f, 1.0f));
+
+        // -7 は7番目までに定義された頂点の先頭, つまり 1 番目.
+        ASDX_CHECK(IsNear(blue.Positions[8], 0.0f, 0.0f, 0.0f));
+        ASDX_CHECK(IsNear(blue.TexCoords[0][8], 1.0f, 1.0f));
+
+        // 法線が無いので全て面から計算する.
+        for(auto i=0; i<3; ++i)
+        { ASDX_CHECK(IsNear(blue.Normals[i], 0.0f, 0.0f, 1.0f)); }
+    }
+
+    remove(kObjPath);
+    remove(kMtlPath);
+}
+
+//-----------------------------------------------------------------------------
+//      範囲外のインデックスを拒否するかテストします.
+//-----------------------------------------------------------------------------
+void TestInvalidIndex()
+{
+    const char* kCases[] = {
+        "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 4\n",     // 範囲外.
+        "v 0 0 0\nv 1 0 0\nv 1 1 0\nf -4 -2 -1\n",  // 負数で範囲外.
+        "v 0 0 0\nv 1 0 0\nf 1 2 3\nv 1 1 0\n",     // 後から定義される頂点.
+        "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1/1 2 3\n",   // vt が無い.
+    };
+
+    for(auto text : kCases)
+    {
+        ASDX_CHECK(WriteText(kObjPath, text));
+
+        asdx::ResModel model;
+        ASDX_CHECK(!model.LoadFromFileA(kObjPath));
+    }
+
+    remove(kObjPath);
+}
+
+//-----------------------------------------------------------------------------
+//      OBJ から保存した AMDL をマップして同じ内容になるかテストします.
+//-----------------------------------------------------------------------------
+void TestBinaryRoundTrip()
+{
+    ASDX_CHECK(WriteText(kMtlPath, kMtl));
+    ASDX_CHECK(WriteText(kObjPath, kObj));
+
+    asdx::ResModel model;
+    ASDX_CHECK(model.LoadFromFileA(kObjPath));
+
+    // OBJ では LOD も頂点カラーも作られないので, 手で足して保存対象に含める.
+    model.LodRanges.push_back({ 0, 2 });
+    model.LodRanges.push_back({ 2, 1 });
+    if (!model.Meshes.empty())
+    {
+        auto& mesh = model.Meshes[0];
+        mesh.Colors.resize(mesh.Positions.size(), asdx::Vector4(0.25f, 0.5f, 0.75f, 1.0f));
+    }
+
+    ASDX_CHECK(model.SaveToFileA(kBinPath));
+
+    asdx::ResModelBinaryFile file;
+    ASDX_CHECK(file.Open(kBinPath));
+
+    auto pBinary = file.GetModel();
+    ASDX_CHECK(pBinary != nullptr);
+    if (pBinary != nullptr)
+    {
+        ASDX_CHECK(pBinary->Meshes   .size() == model.Meshes   .size());
+        ASDX_CHECK(pBinary->LodRanges.size() == model.LodRanges.size());
+        ASDX_CHECK(pBinary->Materials.size() == model.Materials.size());
+
+        for(auto i=0u; i<pBinary->Meshes.size() && i<model.Meshes.size(); ++i)
+        { ASDX_CHECK(IsSame(model.Meshes[i], pBinary->Meshes[i])); }
+
+        for(auto i=0u; i<pBinary->LodRanges.size() && i<model.LodRanges.size(); ++i)
+        {
+            ASDX_CHECK(pBinary->LodRanges[i].Offset == model.LodRanges[i].Offset);
+            ASDX_CHECK(pBinary->LodRanges[i].Count  == model.LodRanges[i].Count);
+        }
+
+        for(auto i=0u; i<pBinary->Materials.size() && i<model.Materials.size(); ++i)
+        { ASDX_CHECK(strcmp(pBinary->Materials[i].data(), model.Materials[i].c_str()) == 0); }
+    }
+    file.Close();
+
+    // ResModel への読み込みでも同じ内容になる.
+    asdx::ResModel loaded;
+    ASDX_CHECK(loaded.LoadFromFileA(kBinPath));
+    ASDX_CHECK(loaded.Materials == model.Materials);
+    ASDX_CHECK(loaded.Meshes.size() == model.Meshes.size());
+    for(auto i=0u; i<loaded.Meshes.size() && i<model.Meshes.size(); ++i)
+    {
+        auto& lhs = loaded.Meshes[i];
+        auto& rhs = model .Meshes[i];
+        ASDX_CHECK(lhs.Name == rhs.Name);
+        ASDX_CHECK(lhs.MaterialId == rhs.MaterialId);
+        ASDX_CHECK(lhs.VertexIndices == rhs.VertexIndices);
+        ASDX_CHECK(lhs.Positions.size() == rhs.Positions.size()
+                && memcmp(lhs.Positions.data(), rhs.Positions.data(), sizeof(asdx::Vector3) * lhs.Positions.size()) == 0);
+        ASDX_CHECK(lhs.Colors.size() == rhs.Colors.size());
+    }
+
+    remove(kObjPath);
+    remove(kMtlPath);
+}
+
+//-----------------------------------------------------------------------------
+//      途中で切れたファイルや壊れたファイルを拒否するかテストします.
+//-----------------------------------------------------------------------------
+void TestBinaryCorruption()
+{
+    // TestBinaryRoundTrip() で保存したファイルを元にする.
+    auto original = ReadBytes(kBinPath);
+    ASDX_CHECK(!original.empty());
+    if (original.empty())
+    { return; }
+
+    // 書き換える位置を正しいファイルから求めておく.
+    size_t fileSizeOffset  = 0;
+    size_t versionOffset   = 0;
+    size_t positionsOffset = 0;
+    size_t indexOffset     = 0;
+    size_t nameOffset      = 0;
+    size_t lodOffset       = 0;
+    uint32_t meshCount     = 0;
+    {
+        asdx::ResModelBinaryFile file;
+        ASDX_CHECK(file.Open(kBinPath));
+
+        auto pModel = file.GetModel();
+        if (pModel == nullptr || pModel->Meshes.empty() || pModel->LodRanges.empty())
+        {
+            ASDX_CHECK(false);
+            return;
+        }
+
+        auto& mesh = pModel->Meshes[0];
+        fileSizeOffset  = GetOffset(pModel, &pModel->FileSize);
+        versionOffset   = GetOffset(pModel, &pModel->Version);
+        positionsOffset = GetOffset(pModel, &mesh.Positions);
+        indexOffset     = GetOffset(pModel, mesh.VertexIndices.data());
+        nameOffset      = GetOffset(pModel, mesh.Name.data() + mesh.Name.size() - 1);
+        lodOffset       = GetOffset(pModel, &pModel->LodRanges[0].Count);
+        meshCount       = pModel->Meshes.size();
+    }
+
+    // 途中で切れたファイル. FileSize も合わせて書き換え, 範囲チェックだけで弾けるか確かめる.
+    for(size_t size=0; size<original.size(); size += (size < 64) ? 1 : 13)
+    {
+        auto data = original;
+        if (size >= fileSizeOffset + sizeof(uint32_t))
+        { Patch(data, fileSizeOffset, uint32_t(size)); }
+
+        ASDX_CHECK(WriteBytes(kBinPath, data, size));
+
+        asdx::ResModelBinaryFile file;
+        ASDX_CHECK(!file.Open(kBinPath));
+    }
+
+    struct Corruption
+    {
+        const char* Name;
+        size_t      Offset;
+        uint32_t    Value;
+    };
+
+    const Corruption kCases[] = {
+        { "Magic",          0,                          0x4c444d42 },   // 'BMDL'.
+        { "Version",        versionOffset,              asdx::ResModelBinary::FILE_VERSION + 1 },
+        { "FileSize",       fileSizeOffset,             uint32_t(original.size() + 4) },
+        { "StreamSize",     positionsOffset,            0x10000000 },
+        { "StreamOffset",   positionsOffset + 4,        0x7ffffff0 },
+        { "StreamAlign",    positionsOffset + 4,        1 },
+        { "VertexIndex",    indexOffset,                0xffffffff },
+        { "NameTerminator", nameOffset,                 'x' },
+        { "LodRange",       lodOffset,                  meshCount + 1 },
+    };
+
+    for(auto& item : kCases)
+    {
+        auto data = original;
+        if (item.Offset == nameOffset)
+        { data[item.Offset] = uint8_t(item.Value); }
+        else
+        { Patch(data, item.Offset, item.Value); }
+
+        ASDX_CHECK(WriteBytes(kBinPath, data, data.size()));
+
+        asdx::ResModelBinaryFile file;
+        auto ret = file.Open(kBinPath);
+        if (ret)
+        { fprintf(stderr, "Corruption Not Detected. case = %s\n", item.Name); }
+        ASDX_CHECK(!ret);
+    }
+
+    // 乱数でバイトを書き換えても, 検証を通ったファイルは範囲外を参照しない.
+    std::mt19937 rng(4321);
+    for(auto i=0; i<256; ++i)
+    {
+        auto data = original;
+        for(auto j=0; j<4; ++j)
+        { data[rng() % data.size()] = uint8_t(rng()); }
+
+        ASDX_CHECK(WriteBytes(kBinPath, data, data.size()));
+
+        asdx::ResModelBinaryFile file;
+        if (file.Open(kBinPath))
+        {
+            asdx::ResModel model;
+            model.LoadFromBinary(*file.GetModel());
+        }
+    }
+
+    remove(kBinPath);
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+    TestLoadOBJ();
+    TestInvalidIndex();
+    TestBinaryRoundTrip();
+    TestBinaryCorruption();
+
+    return asdx::test::Finish("TestResModel");
+}
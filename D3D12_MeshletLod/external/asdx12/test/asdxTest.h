@@ -0,0 +1,55 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxTest.h
+// Desc : Minimal Test Helper.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+
+
+namespace asdx {
+namespace test {
+
+//-----------------------------------------------------------------------------
+//! @brief      失敗したチェックの数を取得します.
+//-----------------------------------------------------------------------------
+inline int& GetFailureCount()
+{
+    static int s_Count = 0;
+    return s_Count;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      結果を表示して終了コードを返却します.
+//-----------------------------------------------------------------------------
+inline int Finish(const char* name)
+{
+    auto count = GetFailureCount();
+    if (count > 0)
+    {
+        fprintf(stderr, "%s : %d check(s) failed.\n", name, count);
+        return 1;
+    }
+
+    printf("%s : all checks passed.\n", name);
+    return 0;
+}
+
+} // namespace test
+} // namespace asdx
+
+//-----------------------------------------------------------------------------
+//! @brief      条件が成り立たない場合に失敗として記録します.
+//-----------------------------------------------------------------------------
+#define ASDX_CHECK(cond)                                                        \
+    do {                                                                        \
+        if (!(cond))                                                            \
+        {                                                                       \
+            fprintf(stderr, "%s(%d) : Check Failed. %s\n", __FILE__, __LINE__, #cond); \
+            asdx::test::GetFailureCount()++;                                    \
+        }                                                                       \
+    } while(0)
@@ -0,0 +1,212 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Binary Log Viewer.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cinttypes>
+#include <ctime>
+#include <vector>
+#include <map>
+#include <Compat.h>
+#include <fnd/asdxLogger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const char* kLevelNames[asdx::LOG_LEVEL_COUNT] = {
+    "VERBOSE",
+    "INFO",
+    "DEBUG",
+    "WARNING",
+    "ERROR",
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ViewOption structure
+///////////////////////////////////////////////////////////////////////////////
+struct ViewOption
+{
+    const char*     Path        = nullptr;          //!< 入力ファイル.
+    uint32_t        MinLevel    = asdx::LOG_VERBOSE;//!< 表示する最小レベル.
+    uint32_t        ThreadId    = 0;                //!< 表示するスレッドID(0の場合は全て).
+    bool            StatsOnly   = false;            //!< 統計のみ表示するかどうか?
+    bool            Raw         = false;            //!< 本文のみ表示するかどうか?
+};
+
+//-----------------------------------------------------------------------------
+//      使い方を表示します.
+//-----------------------------------------------------------------------------
+void PrintUsage()
+{
+    printf("Usage : LogViewer [options] <log.alog>\n");
+    printf("  -l <level>        minimum level (verbose, info, debug, warning, error)\n");
+    printf("  -t <thread id>    show only the given thread id (hex)\n");
+    printf("  -s                print per-level and per-thread statistics only\n");
+    printf("  -r                print message text only\n");
+}
+
+//-----------------------------------------------------------------------------
+//      ログレベルを解析します.
+//-----------------------------------------------------------------------------
+bool ParseLevel(const char* name, uint32_t& level)
+{
+    static const char* kOptions[asdx::LOG_LEVEL_COUNT] = {
+        "verbose", "info", "debug", "warning", "error"
+    };
+
+    for(auto i=0u; i<asdx::LOG_LEVEL_COUNT; ++i)
+    {
+        if (strcmp(name, kOptions[i]) == 0)
+        {
+            level = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+//      コマンドライン引数を解析します.
+//-----------------------------------------------------------------------------
+bool ParseArgs(int argc, char** argv, ViewOption& option)
+{
+    for(auto i=1; i<argc; ++i)
+    {
+        auto arg = argv[i];
+        auto hasValue = (i + 1 < argc);
+
+        if (strcmp(arg, "-l") == 0 && hasValue)
+        {
+            if (!ParseLevel(argv[++i], option.MinLevel))
+                return false;
+        }
+        else if (strcmp(arg, "-t") == 0 && hasValue)
+        { option.ThreadId = uint32_t(strtoul(argv[++i], nullptr, 16)); }
+        else if (strcmp(arg, "-s") == 0)
+        { option.StatsOnly = true; }
+        else if (strcmp(arg, "-r") == 0)
+        { option.Raw = true; }
+        else if (arg[0] == '-' || option.Path != nullptr)
+        { return false; }
+        else
+        { option.Path = arg; }
+    }
+
+    return option.Path != nullptr;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    ViewOption option;
+    if (!ParseArgs(argc, argv, option))
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    FILE* fp = nullptr;
+    if (fopen_s(&fp, option.Path, "rb") != 0)
+    {
+        ELOGA("Error : File Open Failed. path = %s", option.Path);
+        return -1;
+    }
+
+    asdx::BinaryLogHeader header = {};
+    if (fread(&header, sizeof(header), 1, fp) != 1
+     || memcmp(header.Magic, "ALOG", 4) != 0)
+    {
+        ELOGA("Error : Invalid File. path = %s", option.Path);
+        fclose(fp);
+        return -1;
+    }
+
+    if (header.Version != asdx::BINARY_LOG_VERSION)
+    {
+        ELOGA("Error : Unsupported Version. version = %u", header.Version);
+        fclose(fp);
+        return -1;
+    }
+
+    if (!option.StatsOnly && !option.Raw)
+    {
+        auto startTime = time_t(header.StartTime / 1000000);
+        char text[64] = {};
+        strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", localtime(&startTime));
+        printf("# started at %s\n", text);
+    }
+
+    uint64_t levelCount[asdx::LOG_LEVEL_COUNT] = {};
+    uint64_t levelBytes[asdx::LOG_LEVEL_COUNT] = {};
+    std::map<uint32_t, uint64_t> threadCount;
+    uint64_t lastTime = 0;
+
+    std::vector<char> text;
+    asdx::BinaryLogRecord record;
+    while (fread(&record, sizeof(record), 1, fp) == 1)
+    {
+        text.resize(size_t(record.Length) + 1);
+        if (record.Length > 0 && fread(text.data(), 1, record.Length, fp) != record.Length)
+        {
+            ELOGA("Error : Truncated Record. time = %" PRIu64, record.Time);
+            break;
+        }
+        text[record.Length] = '\0';
+
+        auto level = (record.Level < asdx::LOG_LEVEL_COUNT) ? record.Level : uint32_t(asdx::LOG_ERROR);
+        levelCount[level]++;
+        levelBytes[level] += record.Length;
+        threadCount[record.ThreadId]++;
+        lastTime = record.Time;
+
+        if (option.StatsOnly || level < option.MinLevel)
+            continue;
+
+        if (option.ThreadId != 0 && record.ThreadId != option.ThreadId)
+            continue;
+
+        if (option.Raw)
+        { fputs(text.data(), stdout); }
+        else
+        {
+            printf("[%10.6f] [%-7s] [%08x] %s",
+                double(record.Time) * 1e-6, kLevelNames[level], record.ThreadId, text.data());
+        }
+    }
+
+    fclose(fp);
+
+    if (option.StatsOnly)
+    {
+        uint64_t total = 0;
+        for(auto i=0u; i<asdx::LOG_LEVEL_COUNT; ++i)
+        {
+            printf("%-7s : %10" PRIu64 " records, %12" PRIu64 " bytes\n", kLevelNames[i], levelCount[i], levelBytes[i]);
+            total += levelCount[i];
+        }
+
+        printf("threads : %zu\n", threadCount.size());
+        for(auto& itr : threadCount)
+        { printf("  %08x : %" PRIu64 " records\n", itr.first, itr.second); }
+
+        printf("total   : %" PRIu64 " records in %.3f s\n", total, double(lastTime) * 1e-6);
+    }
+
+    return 0;
+}
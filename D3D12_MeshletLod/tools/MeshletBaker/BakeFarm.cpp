@@ -0,0 +1,644 @@
+﻿//-----------------------------------------------------------------------------
+// File : BakeFarm.cpp
+// Desc : Headless Meshlet Bake Farm.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <cinttypes>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+#include <algorithm>
+#include <Compat.h>
+#include <Meshlet.h>
+#include <fnd/asdxLogger.h>
+#include <fnd/asdxProfiler.h>
+#include "BakeFarm.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif//_WIN32
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t kBakeVersion  = 1;    // 出力内容が変わる変更を入れたら上げること.
+static const uint64_t kFnvOffset    = 14695981039346656037ull;
+static const uint64_t kFnvPrime     = 1099511628211ull;
+
+///////////////////////////////////////////////////////////////////////////////
+// SharedState structure
+///////////////////////////////////////////////////////////////////////////////
+struct SharedState
+{
+    std::atomic<uint32_t>   NextJob;        // 次に取り出すジョブ番号.
+    std::atomic<uint32_t>   DoneCount;      // 完了したジョブ数.
+    uint32_t                JobCount;       // ジョブ数.
+    uint32_t                Reserved;
+};
+
+// 結果配列は SharedState の直後に置く.
+static const size_t kResultOffset = (sizeof(SharedState) + 63) & ~size_t(63);
+
+//-----------------------------------------------------------------------------
+//      現在時刻をミリ秒単位で取得します.
+//-----------------------------------------------------------------------------
+double GetTimeMs()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration<double, std::milli>(now).count();
+}
+
+//-----------------------------------------------------------------------------
+//      ジョブ共有領域を確保します.
+//-----------------------------------------------------------------------------
+void* AllocShared(size_t size)
+{
+#ifdef _WIN32
+    return new(std::nothrow) uint8_t[size];
+#else
+    // fork() した子プロセスからも見えるように共有マッピングで確保する.
+    auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    return (ptr != MAP_FAILED) ? ptr : nullptr;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      ジョブ共有領域を解放します.
+//-----------------------------------------------------------------------------
+void FreeShared(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+        return;
+
+#ifdef _WIN32
+    (void)size;
+    delete[] static_cast<uint8_t*>(ptr);
+#else
+    munmap(ptr, size);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      ディレクトリを作成します.
+//-----------------------------------------------------------------------------
+void MakeDirectory(const std::string& path)
+{
+#ifdef _WIN32
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルサイズを取得します. 存在しない場合は false を返却します.
+//-----------------------------------------------------------------------------
+bool GetFileSize(const std::string& path, uint64_t& size)
+{
+    FILE* fp = nullptr;
+    if (fopen_s(&fp, path.c_str(), "rb") != 0)
+        return false;
+
+#ifdef _WIN32
+    _fseeki64(fp, 0, SEEK_END);
+    size = uint64_t(_ftelli64(fp));
+#else
+    fseeko(fp, 0, SEEK_END);
+    size = uint64_t(ftello(fp));
+#endif
+
+    fclose(fp);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ハッシュ値に値を加えます.
+//-----------------------------------------------------------------------------
+inline void AddHash(uint64_t& hash, const void* data, size_t size)
+{
+    auto ptr = static_cast<const uint8_t*>(data);
+    for(size_t i=0; i<size; ++i)
+    { hash = (hash ^ ptr[i]) * kFnvPrime; }
+}
+
+//-----------------------------------------------------------------------------
+//      入力ファイルとオプションからハッシュ値を計算します.
+//-----------------------------------------------------------------------------
+bool CalcBakeHash(const std::string& path, const BakeOption& option, uint64_t& hash)
+{
+    FILE* fp = nullptr;
+    if (fopen_s(&fp, path.c_str(), "rb") != 0)
+        return false;
+
+    hash = kFnvOffset;
+    AddHash(hash, &kBakeVersion, sizeof(kBakeVersion));
+
+    auto mode = uint32_t(option.GroupingMode);
+    AddHash(hash, &mode, sizeof(mode));
+
+    uint8_t buffer[64 * 1024];
+    for(;;)
+    {
+        auto size = fread(buffer, 1, sizeof(buffer), fp);
+        if (size == 0)
+            break;
+
+        AddHash(hash, buffer, size);
+    }
+
+    fclose(fp);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      前回のベイク情報を読み込みます. ハッシュ値が一致しない場合は false を返却します.
+//-----------------------------------------------------------------------------
+bool ReadBakeInfo(const std::string& path, uint64_t hash, BakeJobResult& result)
+{
+    FILE* fp = nullptr;
+    if (fopen_s(&fp, path.c_str(), "r") != 0)
+        return false;
+
+    uint32_t version   = 0;
+    uint64_t prevHash  = 0;
+    uint32_t values[4] = {};
+    auto count = fscanf(fp, "%u %" SCNx64 " %u %u %u %u",
+        &version, &prevHash, &values[0], &values[1], &values[2], &values[3]);
+    fclose(fp);
+
+    if (count != 6 || version != kBakeVersion || prevHash != hash)
+        return false;
+
+    result.TriangleCount    = values[0];
+    result.MeshletCount     = values[1];
+    result.LodMeshletCount  = values[2];
+    result.LodLevelCount    = values[3];
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ベイク情報を書き込みます.
+//-----------------------------------------------------------------------------
+bool WriteBakeInfo(const std::string& path, const BakeJobResult& result)
+{
+    FILE* fp = nullptr;
+    if (fopen_s(&fp, path.c_str(), "w") != 0)
+        return false;
+
+    fprintf(fp, "%u %016" PRIx64 " %u %u %u %u\n",
+        kBakeVersion,
+        result.Hash,
+        result.TriangleCount,
+        result.MeshletCount,
+        result.LodMeshletCount,
+        result.LodLevelCount);
+    fclose(fp);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルパスから拡張子を除いたファイル名を取得します.
+//-----------------------------------------------------------------------------
+std::string GetStem(const std::string& path)
+{
+    auto begin = path.find_last_of("/\\");
+    begin = (begin == std::string::npos) ? 0 : begin + 1;
+
+    auto end = path.find_last_of('.');
+    if (end == std::string::npos || end < begin)
+    { end = path.size(); }
+
+    return path.substr(begin, end - begin);
+}
+
+//-----------------------------------------------------------------------------
+//      1つの入力ファイルをベイクします.
+//-----------------------------------------------------------------------------
+bool BakeOne(const BakeOption& option, const std::string& input, uint32_t workerId, BakeJobResult& result)
+{
+    ASDX_PROFILE_SCOPE("BakeOne");
+
+    auto start = GetTimeMs();
+
+    result.State    = BAKE_STATE_RUNNING;
+    result.WorkerId = workerId;
+
+    if (!CalcBakeHash(input, option, result.Hash))
+    {
+        ELOGA("Error : File Open Failed. path = %s", input.c_str());
+        result.State = BAKE_STATE_FAILED;
+        return false;
+    }
+
+    auto meshletPath = GetBakeOutputPath(option, input, ".meshlets");
+    auto lodPath     = GetBakeOutputPath(option, input, ".lodmeshlets");
+    auto infoPath    = GetBakeOutputPath(option, input, ".bakeinfo");
+    auto cachePath   = GetBakeOutputPath(option, input, ".lodcache");
+
+    // 入力が変わっていなければ前回の出力をそのまま使う.
+    if (!option.Force
+      && ReadBakeInfo(infoPath, result.Hash, result)
+      && GetFileSize(meshletPath, result.MeshletFileSize)
+      && GetFileSize(lodPath,     result.LodFileSize))
+    {
+        result.State     = BAKE_STATE_CACHED;
+        result.TotalTime = GetTimeMs() - start;
+        return true;
+    }
+
+    // メッシュレット生成.
+    ResMeshlets meshlets;
+    {
+        ASDX_PROFILE_SCOPE("CreateMeshlets");
+        auto begin = GetTimeMs();
+        if (!CreateMeshlets(input.c_str(), meshlets))
+        {
+            ELOGA("Error : CreateMeshlets() Failed. path = %s", input.c_str());
+            result.State = BAKE_STATE_FAILED;
+            return false;
+        }
+
+        if (!SaveResMeshlets(meshletPath.c_str(), meshlets))
+        {
+            ELOGA("Error : SaveResMeshlets() Failed. path = %s", meshletPath.c_str());
+            result.State = BAKE_STATE_FAILED;
+            return false;
+        }
+        result.MeshletTime = GetTimeMs() - begin;
+    }
+
+    // LOD生成.
+    ResLodMeshlets lodMeshlets;
+    {
+        ASDX_PROFILE_SCOPE("CreateLodMeshlets");
+        auto begin = GetTimeMs();
+
+        LodBakeCache  cache  = {};
+        LodBakeCache* pCache = nullptr;
+        if (option.Incremental)
+        {
+            // キャッシュが無い・壊れている場合は全て再計算する.
+            uint64_t size = 0;
+            if (GetFileSize(cachePath, size))
+            { LoadLodBakeCache(cachePath.c_str(), cache); }
+            pCache = &cache;
+        }
+
+        if (!CreateLodMeshlets(meshlets, lodMeshlets, option.GroupingMode, pCache))
+        {
+            ELOGA("Error : CreateLodMeshlets() Failed. path = %s", input.c_str());
+            result.State = BAKE_STATE_FAILED;
+            return false;
+        }
+
+        if (pCache != nullptr && !SaveLodBakeCache(cachePath.c_str(), cache))
+        { ELOGA("Error : SaveLodBakeCache() Failed. path = %s", cachePath.c_str()); }
+
+        result.LodTime = GetTimeMs() - begin;
+    }
+
+    // 圧縮して保存.
+    {
+        ASDX_PROFILE_SCOPE("SaveLodMeshlets");
+        auto begin = GetTimeMs();
+        if (!SaveLodMeshlets(lodPath.c_str(), lodMeshlets))
+        {
+            ELOGA("Error : SaveLodMeshlets() Failed. path = %s", lodPath.c_str());
+            result.State = BAKE_STATE_FAILED;
+            return false;
+        }
+        result.CompressTime = GetTimeMs() - begin;
+    }
+
+    result.TriangleCount    = uint32_t(meshlets.Primitives.size());
+    result.MeshletCount     = uint32_t(meshlets.Meshlets.size());
+    result.LodMeshletCount  = uint32_t(lodMeshlets.Meshlets.size());
+    result.LodLevelCount    = lodMeshlets.MaxLodLevel;
+
+    GetFileSize(meshletPath, result.MeshletFileSize);
+    GetFileSize(lodPath,     result.LodFileSize);
+
+    // 途中で失敗した出力をキャッシュとみなさないように，ベイク情報は最後に書き込む.
+    if (!WriteBakeInfo(infoPath, result))
+    { ELOGA("Error : WriteBakeInfo() Failed. path = %s", infoPath.c_str()); }
+
+    result.State     = BAKE_STATE_BAKED;
+    result.TotalTime = GetTimeMs() - start;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      進捗を出力します.
+//-----------------------------------------------------------------------------
+void PrintProgress(uint32_t done, uint32_t total, const std::string& input, const BakeJobResult& result)
+{
+    const char* state = "failed";
+    if (result.State == BAKE_STATE_BAKED)  { state = "baked"; }
+    if (result.State == BAKE_STATE_CACHED) { state = "cached"; }
+
+    // 複数プロセスから出力されるので，1行を1回で書き込む.
+    char line[1024];
+    snprintf(line, sizeof(line),
+        "[%3u/%3u] %-6s %-32s meshlet %9.1f ms  lod %9.1f ms  compress %8.1f ms  total %9.1f ms  (worker %u)\n",
+        done, total, state, GetStem(input).c_str(),
+        result.MeshletTime, result.LodTime, result.CompressTime, result.TotalTime, result.WorkerId);
+    fputs(line, stdout);
+    fflush(stdout);
+}
+
+//-----------------------------------------------------------------------------
+//      ジョブキューが空になるまでベイクします.
+//-----------------------------------------------------------------------------
+void RunWorkerThread(const BakeOption& option, SharedState* pState, BakeJobResult* pResults, uint32_t workerId)
+{
+    ASDX_PROFILE_THREAD("BakeWorker");
+
+    for(;;)
+    {
+        auto index = pState->NextJob.fetch_add(1);
+        if (index >= pState->JobCount)
+            break;
+
+        auto& result = pResults[index];
+        BakeOne(option, option.Inputs[index], workerId, result);
+
+        auto done = pState->DoneCount.fetch_add(1) + 1;
+        PrintProgress(done, pState->JobCount, option.Inputs[index], result);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ワーカープロセスの処理を行います.
+//-----------------------------------------------------------------------------
+void RunWorkerProcess(const BakeOption& option, uint32_t threadCount, SharedState* pState, BakeJobResult* pResults, uint32_t workerId)
+{
+    std::vector<std::thread> threads;
+    for(auto i=1u; i<threadCount; ++i)
+    { threads.emplace_back(RunWorkerThread, std::cref(option), pState, pResults, workerId); }
+
+    RunWorkerThread(option, pState, pResults, workerId);
+
+    for(auto& thread : threads)
+    { thread.join(); }
+}
+
+//-----------------------------------------------------------------------------
+//      ワーカープロセスのトレース出力先を取得します.
+//-----------------------------------------------------------------------------
+std::string GetWorkerTracePath(const std::string& path, uint32_t workerId)
+{
+    // trace.json -> trace.1.json
+    auto dot   = path.find_last_of('.');
+    auto slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    { dot = path.size(); }
+
+    return path.substr(0, dot) + "." + std::to_string(workerId) + path.substr(dot);
+}
+
+//-----------------------------------------------------------------------------
+//      JSON文字列としてエスケープします.
+//-----------------------------------------------------------------------------
+std::string EscapeJson(const std::string& value)
+{
+    std::string result;
+    result.reserve(value.size());
+    for(auto c : value)
+    {
+        switch(c)
+        {
+        case '\"': result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n";  break;
+        case '\r': result += "\\r";  break;
+        case '\t': result += "\\t";  break;
+        default:
+            if (uint8_t(c) < 0x20)
+            {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", uint32_t(uint8_t(c)));
+                result += buf;
+            }
+            else
+            { result += c; }
+            break;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      出力ファイルパスを取得します.
+//-----------------------------------------------------------------------------
+std::string GetBakeOutputPath(const BakeOption& option, const std::string& input, const char* ext)
+{
+    auto dir = option.OutputDir.empty() ? std::string(".") : option.OutputDir;
+    return dir + "/" + GetStem(input) + ext;
+}
+
+//-----------------------------------------------------------------------------
+//      ベイクを実行します.
+//-----------------------------------------------------------------------------
+bool RunBakeFarm(const BakeOption& option, std::vector<BakeJobResult>& results)
+{
+    results.clear();
+    if (option.Inputs.empty())
+        return true;
+
+    // 出力先が衝突しないかチェック.
+    {
+        std::vector<std::string> stems;
+        for(const auto& input : option.Inputs)
+        { stems.emplace_back(GetStem(input)); }
+        std::sort(stems.begin(), stems.end());
+
+        auto itr = std::adjacent_find(stems.begin(), stems.end());
+        if (itr != stems.end())
+        {
+            ELOGA("Error : Duplicated Output Name. name = %s", itr->c_str());
+            return false;
+        }
+    }
+
+    MakeDirectory(option.OutputDir);
+
+    auto jobCount    = uint32_t(option.Inputs.size());
+    auto threadCount = std::max(option.ThreadCount, 1u);
+    auto procCount   = std::min(std::max(option.ProcessCount, 1u), jobCount);
+
+#ifdef _WIN32
+    // TODO : CreateProcess() と名前付き共有メモリによるマルチプロセス化.
+    if (procCount > 1)
+    {
+        WLOGA("Warning : Multi-Process Bake Is Not Supported On Windows. Use %u threads instead.", threadCount * procCount);
+        threadCount *= procCount;
+        procCount    = 1;
+    }
+#endif
+
+    // ジョブキューと結果を共有領域に置く.
+    auto sharedSize = kResultOffset + sizeof(BakeJobResult) * jobCount;
+    auto pShared    = static_cast<uint8_t*>(AllocShared(sharedSize));
+    if (pShared == nullptr)
+    {
+        ELOGA("Error : Out Of Memory.");
+        return false;
+    }
+    memset(pShared, 0, sharedSize);
+
+    auto pState   = new(pShared) SharedState();
+    auto pResults = reinterpret_cast<BakeJobResult*>(pShared + kResultOffset);
+    pState->NextJob  .store(0);
+    pState->DoneCount.store(0);
+    pState->JobCount = jobCount;
+
+#ifdef _WIN32
+    RunWorkerProcess(option, threadCount, pState, pResults, 0);
+#else
+    // 子プロセスにバッファの内容が複製されないようにする.
+    fflush(stdout);
+    fflush(stderr);
+
+    std::vector<pid_t> children;
+    for(auto i=1u; i<procCount; ++i)
+    {
+        auto pid = fork();
+        if (pid == 0)
+        {
+            // 親プロセスから複製された計測結果は捨てて, プロセス毎に別ファイルへ書き出す.
+            auto& profiler = asdx::Profiler::Instance();
+            if (!option.TracePath.empty())
+            {
+                profiler.Start();
+                ASDX_PROFILE_THREAD("Main");
+            }
+
+            RunWorkerProcess(option, threadCount, pState, pResults, i);
+
+            if (!option.TracePath.empty())
+            {
+                profiler.Stop();
+                profiler.SaveChromeTrace(GetWorkerTracePath(option.TracePath, i).c_str());
+            }
+
+            fflush(stdout);
+            fflush(stderr);
+            _exit(0);
+        }
+        else if (pid < 0)
+        {
+            ELOGA("Error : fork() Failed. Continue with %u processes.", i);
+            break;
+        }
+
+        children.push_back(pid);
+    }
+
+    RunWorkerProcess(option, threadCount, pState, pResults, 0);
+
+    for(auto pid : children)
+    {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        { ELOGA("Error : Worker Process Terminated Abnormally. pid = %d", int(pid)); }
+    }
+#endif
+
+    results.assign(pResults, pResults + jobCount);
+
+    pState->~SharedState();
+    FreeShared(pShared, sharedSize);
+
+    // 異常終了したワーカーが処理中だったものは失敗扱い.
+    auto succeeded = true;
+    for(auto& result : results)
+    {
+        if (result.State == BAKE_STATE_PENDING || result.State == BAKE_STATE_RUNNING)
+        { result.State = BAKE_STATE_FAILED; }
+
+        if (result.State == BAKE_STATE_FAILED)
+        { succeeded = false; }
+    }
+
+    return succeeded;
+}
+
+//-----------------------------------------------------------------------------
+//      ベイク結果のマニフェストをJSON形式で出力します.
+//-----------------------------------------------------------------------------
+bool WriteBakeManifest
+(
+    const char*                         path,
+    const BakeOption&                   option,
+    const std::vector<BakeJobResult>&   results,
+    double                              wallTime
+)
+{
+    FILE* fp = nullptr;
+    if (fopen_s(&fp, path, "w") != 0)
+    {
+        ELOGA("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"version\": %u,\n", kBakeVersion);
+    fprintf(fp, "  \"grouping\": \"%s\",\n", (option.GroupingMode == LOD_GROUPING_CROSS_SUBSET) ? "cross_subset" : "per_subset");
+    fprintf(fp, "  \"processes\": %u,\n", option.ProcessCount);
+    fprintf(fp, "  \"threads\": %u,\n", option.ThreadCount);
+    fprintf(fp, "  \"wall_time_ms\": %.3f,\n", wallTime);
+    fprintf(fp, "  \"jobs\": [\n");
+
+    for(size_t i=0; i<results.size(); ++i)
+    {
+        const auto& input  = option.Inputs[i];
+        const auto& result = results[i];
+
+        const char* state = "failed";
+        if (result.State == BAKE_STATE_BAKED)  { state = "baked"; }
+        if (result.State == BAKE_STATE_CACHED) { state = "cached"; }
+
+        fprintf(fp, "    {\n");
+        fprintf(fp, "      \"input\": \"%s\",\n", EscapeJson(input).c_str());
+        fprintf(fp, "      \"hash\": \"%016" PRIx64 "\",\n", result.Hash);
+        fprintf(fp, "      \"status\": \"%s\",\n", state);
+        fprintf(fp, "      \"worker\": %u,\n", result.WorkerId);
+        fprintf(fp, "      \"outputs\": {\n");
+        fprintf(fp, "        \"meshlets\": \"%s\",\n", EscapeJson(GetBakeOutputPath(option, input, ".meshlets")).c_str());
+        fprintf(fp, "        \"lod_meshlets\": \"%s\"\n", EscapeJson(GetBakeOutputPath(option, input, ".lodmeshlets")).c_str());
+        fprintf(fp, "      },\n");
+        fprintf(fp, "      \"sizes\": { \"meshlets\": %" PRIu64 ", \"lod_meshlets\": %" PRIu64 " },\n", result.MeshletFileSize, result.LodFileSize);
+        fprintf(fp, "      \"triangles\": %u,\n", result.TriangleCount);
+        fprintf(fp, "      \"meshlets\": %u,\n", result.MeshletCount);
+        fprintf(fp, "      \"lod_meshlets\": %u,\n", result.LodMeshletCount);
+        fprintf(fp, "      \"lod_levels\": %u,\n", result.LodLevelCount);
+        fprintf(fp, "      \"times_ms\": { \"meshlet\": %.3f, \"lod\": %.3f, \"compress\": %.3f, \"total\": %.3f }\n",
+            result.MeshletTime, result.LodTime, result.CompressTime, result.TotalTime);
+        fprintf(fp, "    }%s\n", (i + 1 < results.size()) ? "," : "");
+    }
+
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+    fclose(fp);
+
+    return true;
+}
@@ -0,0 +1,101 @@
+﻿//-----------------------------------------------------------------------------
+// File : BakeFarm.h
+// Desc : Headless Meshlet Bake Farm.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <LodGenerator.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BAKE_STATE enum
+///////////////////////////////////////////////////////////////////////////////
+enum BAKE_STATE : uint32_t
+{
+    BAKE_STATE_PENDING = 0,     //!< 未処理.
+    BAKE_STATE_RUNNING,         //!< 処理中.
+    BAKE_STATE_BAKED,           //!< ベイク完了.
+    BAKE_STATE_CACHED,          //!< キャッシュ済みの出力を再利用.
+    BAKE_STATE_FAILED,          //!< 失敗.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BakeOption structure
+///////////////////////////////////////////////////////////////////////////////
+struct BakeOption
+{
+    std::vector<std::string>    Inputs;                                 //!< 入力OBJファイル.
+    std::string                 OutputDir       = ".";                  //!< 出力ディレクトリ.
+    std::string                 ManifestPath;                           //!< マニフェストの出力先(空の場合は出力ディレクトリ直下).
+    uint32_t                    ThreadCount     = 1;                    //!< プロセス当たりのワーカースレッド数.
+    uint32_t                    ProcessCount    = 1;                    //!< ワーカープロセス数.
+    LOD_GROUPING_MODE           GroupingMode    = LOD_GROUPING_PER_SUBSET;  //!< LODのグループ化モード.
+    bool                        Incremental     = false;                //!< グループ単位のベイクキャッシュを使うかどうか.
+    bool                        Force           = false;                //!< 出力キャッシュを無視するかどうか.
+    std::string                 TracePath;                              //!< Chrome トレースの出力先(空の場合は計測しません).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BakeJobResult structure
+///////////////////////////////////////////////////////////////////////////////
+struct BakeJobResult
+{
+    BAKE_STATE  State;              //!< 状態.
+    uint32_t    WorkerId;           //!< 処理したワーカープロセス番号.
+    uint64_t    Hash;               //!< 入力とオプションのハッシュ値.
+    uint32_t    TriangleCount;      //!< 入力三角形数.
+    uint32_t    MeshletCount;       //!< 入力メッシュレット数.
+    uint32_t    LodMeshletCount;    //!< 全LODのメッシュレット数.
+    uint32_t    LodLevelCount;      //!< LOD数.
+    uint64_t    MeshletFileSize;    //!< メッシュレットファイルのサイズ.
+    uint64_t    LodFileSize;        //!< 圧縮済みLODメッシュレットファイルのサイズ.
+    double      MeshletTime;        //!< メッシュレット生成時間[ms].
+    double      LodTime;            //!< LOD生成時間[ms].
+    double      CompressTime;       //!< 圧縮保存時間[ms].
+    double      TotalTime;          //!< 合計時間[ms].
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      ベイクを実行します.
+//!
+//! @param[in]      option      ベイクオプションです.
+//! @param[out]     results     入力ファイル毎の結果です.
+//! @retval true    全ての入力のベイクに成功.
+//! @retval false   いずれかの入力のベイクに失敗.
+//! @note       ジョブキューは共有メモリに置かれ，全プロセス・全スレッドが先頭から順に取り出します.
+//-----------------------------------------------------------------------------
+bool RunBakeFarm(const BakeOption& option, std::vector<BakeJobResult>& results);
+
+//-----------------------------------------------------------------------------
+//! @brief      ベイク結果のマニフェストをJSON形式で出力します.
+//!
+//! @param[in]      path        出力ファイルパスです.
+//! @param[in]      option      ベイクオプションです.
+//! @param[in]      results     ベイク結果です.
+//! @param[in]      wallTime    全体の経過時間[ms]です.
+//! @retval true    出力に成功.
+//! @retval false   出力に失敗.
+//-----------------------------------------------------------------------------
+bool WriteBakeManifest
+(
+    const char*                         path,
+    const BakeOption&                   option,
+    const std::vector<BakeJobResult>&   results,
+    double                              wallTime
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      出力ファイルパスを取得します.
+//!
+//! @param[in]      option      ベイクオプションです.
+//! @param[in]      input       入力ファイルパスです.
+//! @param[in]      ext         拡張子です(ドットを含む).
+//-----------------------------------------------------------------------------
+std::string GetBakeOutputPath(const BakeOption& option, const std::string& input, const char* ext);
@@ -0,0 +1,229 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchLodSelect.cpp
+// Desc : LOD Selection Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <string>
+#include <Compat.h>
+#include <LodGenerator.h>
+#include <fnd/asdxLogger.h>
+#include "asdxBench.h"
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// TiledScene structure
+///////////////////////////////////////////////////////////////////////////////
+struct TiledScene
+{
+    uint32_t                    TileCount;      //!< 1辺あたりのタイル数.
+    std::vector<LodSelectParam> Params;         //!< タイル毎の選択パラメータ.
+};
+
+//-----------------------------------------------------------------------------
+//      起伏のあるグリッドメッシュをOBJ形式で書き出します.
+//-----------------------------------------------------------------------------
+bool WriteTileOBJ(const char* path, uint32_t size)
+{
+    FILE* fp = nullptr;
+    if (fopen_s(&fp, path, "w") != 0)
+    {
+        fprintf(stderr, "Error : File Open Failed. path = %s\n", path);
+        return false;
+    }
+
+    auto inv = 1.0f / float(size);
+    for(auto y=0u; y<=size; ++y)
+    {
+        for(auto x=0u; x<=size; ++x)
+        {
+            auto fx = float(x) * inv * 6.2831853f;
+            auto fy = float(y) * inv * 6.2831853f;
+
+            // タイルの端で高さと法線が一致するように1周期の波にする.
+            auto z  = 0.05f * sinf(fx) * sinf(fy);
+            auto dx = 0.05f * 6.2831853f * cosf(fx) * sinf(fy);
+            auto dy = 0.05f * 6.2831853f * sinf(fx) * cosf(fy);
+            auto len = sqrtf(dx * dx + dy * dy + 1.0f);
+
+            fprintf(fp, "v %f %f %f\n", float(x) * inv, float(y) * inv, z);
+            fprintf(fp, "vt %f %f\n", float(x) * inv, float(y) * inv);
+            fprintf(fp, "vn %f %f %f\n", -dx / len, -dy / len, 1.0f / len);
+        }
+    }
+
+    for(auto y=0u; y<size; ++y)
+    {
+        for(auto x=0u; x<size; ++x)
+        {
+            auto a = y * (size + 1) + x + 1;
+            auto b = a + 1;
+            auto c = a + size + 1;
+            auto d = c + 1;
+            fprintf(fp, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, d, d, d);
+            fprintf(fp, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, d, d, d, c, c, c);
+        }
+    }
+
+    fclose(fp);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      タイル1枚分のLODメッシュレットを生成します.
+//-----------------------------------------------------------------------------
+bool CreateTile(uint32_t size, ResLodMeshlets& lodMesh)
+{
+    const char* kPath = "bench_lod_tile.obj";
+    if (!WriteTileOBJ(kPath, size))
+    { return false; }
+
+    ResMeshlets meshlets;
+    auto ret = CreateMeshlets(kPath, meshlets)
+            && CreateLodMeshlets(meshlets, lodMesh, LOD_GROUPING_CROSS_SUBSET);
+    remove(kPath);
+    return ret;
+}
+
+//-----------------------------------------------------------------------------
+//      タイルを敷き詰めたシーンを地面すれすれのカメラから見る設定を作ります.
+//-----------------------------------------------------------------------------
+TiledScene CreateScene(uint32_t tileCount, float errorThreshold)
+{
+    const float kHeight = 1080.0f;
+    const float kFovY   = 1.0471976f;   // 60度.
+
+    auto extent = float(tileCount);
+    auto view   = asdx::Matrix::CreateLookAt(
+        asdx::Vector3(0.5f, 0.5f, 0.1f),
+        asdx::Vector3(extent * 0.5f, extent * 0.5f, 0.0f),
+        asdx::Vector3(0.0f, 0.0f, 1.0f));
+
+    TiledScene scene;
+    scene.TileCount = tileCount;
+    scene.Params.resize(tileCount * tileCount);
+
+    for(auto y=0u; y<tileCount; ++y)
+    {
+        for(auto x=0u; x<tileCount; ++x)
+        {
+            auto& param = scene.Params[y * tileCount + x];
+            param.LocalToView    = asdx::Matrix::CreateTranslation(float(x), float(y), 0.0f) * view;
+            param.ScreenScaleY   = kHeight * 0.5f / tanf(kFovY * 0.5f);
+            param.ErrorThreshold = errorThreshold;
+        }
+    }
+
+    return scene;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SceneStats structure
+///////////////////////////////////////////////////////////////////////////////
+struct SceneStats
+{
+    uint64_t    VisitedNodes        = 0;    //!< 訪問したBVHノード数.
+    uint64_t    TestedMeshlets      = 0;    //!< LOD判定を行ったメッシュレット数.
+    uint64_t    SelectedMeshlets    = 0;    //!< 選択されたメッシュレット数.
+};
+
+//-----------------------------------------------------------------------------
+//      シーン全体のLODカットを選択します.
+//-----------------------------------------------------------------------------
+template<typename Select>
+SceneStats SelectScene
+(
+    const ResLodMeshlets&               lodMesh,
+    const TiledScene&                   scene,
+    Select                              select,
+    std::vector<std::vector<uint32_t>>& results
+)
+{
+    SceneStats total;
+    results.resize(scene.Params.size());
+
+    for(size_t i=0; i<scene.Params.size(); ++i)
+    {
+        LodSelectStats stats = {};
+        select(lodMesh, scene.Params[i], results[i], &stats);
+
+        total.VisitedNodes     += stats.VisitedNodes;
+        total.TestedMeshlets   += stats.TestedMeshlets;
+        total.SelectedMeshlets += stats.SelectedMeshlets;
+    }
+
+    return total;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    asdx::bench::Runner runner;
+    if (!runner.Init("MeshletLod", argc, argv))
+    { return 1; }
+
+    // ベイク中のログは計測結果に混ざるので出さない.
+    asdx::SystemLogger::Instance().SetFilter(asdx::LOG_ERROR);
+
+    ResLodMeshlets tile;
+    if (!CreateTile(runner.IsQuick() ? 96 : 192, tile))
+    {
+        fprintf(stderr, "Error : CreateTile() Failed.\n");
+        return 1;
+    }
+
+    auto ret = 0;
+
+    // 1操作 = タイル1枚分の選択.
+    const uint32_t kTileCounts[] = { 4, 16, 32 };
+    for(auto tileCount : kTileCounts)
+    {
+        auto scene = CreateScene(tileCount, 1.0f);
+        auto count = uint64_t(scene.Params.size());
+
+        // 計測前に両者が同じカットを選ぶことを確認しておく.
+        std::vector<std::vector<uint32_t>> bvhResult;
+        std::vector<std::vector<uint32_t>> flatResult;
+        auto bvh  = SelectScene(tile, scene, SelectLodMeshlets,     bvhResult);
+        auto flat = SelectScene(tile, scene, SelectLodMeshletsFlat, flatResult);
+        if (bvhResult != flatResult)
+        {
+            fprintf(stderr, "Error : LOD Selection Not Match. tiles = %u x %u\n", tileCount, tileCount);
+            ret = 1;
+        }
+
+        char name[64];
+        sprintf(name, "LodSelect/Flat(Tiles=%ux%u)", tileCount, tileCount);
+        runner.Run(name, count * 16, [&](uint64_t ops)
+        {
+            for(uint64_t n=0; n<ops; n+=count)
+            { asdx::bench::DoNotOptimize(SelectScene(tile, scene, SelectLodMeshletsFlat, flatResult)); }
+        });
+        runner.SetMetric("tested_meshlets_per_tile", double(flat.TestedMeshlets)   / double(count));
+        runner.SetMetric("selected_per_tile",        double(flat.SelectedMeshlets) / double(count));
+
+        sprintf(name, "LodSelect/Bvh(Tiles=%ux%u)", tileCount, tileCount);
+        runner.Run(name, count * 16, [&](uint64_t ops)
+        {
+            for(uint64_t n=0; n<ops; n+=count)
+            { asdx::bench::DoNotOptimize(SelectScene(tile, scene, SelectLodMeshlets, bvhResult)); }
+        });
+        runner.SetMetric("visited_nodes_per_tile",   double(bvh.VisitedNodes)     / double(count));
+        runner.SetMetric("tested_meshlets_per_tile", double(bvh.TestedMeshlets)   / double(count));
+        runner.SetMetric("selected_per_tile",        double(bvh.SelectedMeshlets) / double(count));
+    }
+
+    auto finish = runner.Finish();
+    return (ret != 0) ? ret : finish;
+}
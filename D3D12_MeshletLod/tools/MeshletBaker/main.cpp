@@ -0,0 +1,218 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Main Entry Point.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <Compat.h>
+#include <fnd/asdxLogger.h>
+#include <fnd/asdxProfiler.h>
+#include "BakeFarm.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      使い方を表示します.
+//-----------------------------------------------------------------------------
+void PrintUsage()
+{
+    printf("Usage : MeshletBaker [options] <input.obj | @list.txt> ...\n");
+    printf("  -o <dir>          output directory (default: .)\n");
+    printf("  -m <path>         manifest path (default: <dir>/manifest.json)\n");
+    printf("  -j <count>        worker threads per process (0: hardware concurrency)\n");
+    printf("  -p <count>        worker processes\n");
+    printf("  --cross           group LOD clusters across materials\n");
+    printf("  --incremental     reuse unchanged LOD groups from <name>.lodcache\n");
+    printf("  --force           ignore up-to-date outputs\n");
+    printf("  -v                verbose log\n");
+    printf("  --binlog <path>   also write a binary log (see tools/LogViewer)\n");
+    printf("  --trace <path>    write a Chrome trace (worker processes write <stem>.<id>.json)\n");
+}
+
+//-----------------------------------------------------------------------------
+//      リストファイルから入力ファイルを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadInputList(const char* path, std::vector<std::string>& inputs)
+{
+    FILE* fp = nullptr;
+    if (fopen_s(&fp, path, "r") != 0)
+    {
+        ELOGA("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    char line[4096];
+    while(fgets(line, sizeof(line), fp) != nullptr)
+    {
+        // 前後の空白を取り除く.
+        auto begin = line;
+        while(*begin == ' ' || *begin == '\t')
+        { begin++; }
+
+        auto end = begin + strlen(begin);
+        while(end > begin && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t'))
+        { end--; }
+
+        // 空行とコメントはスキップ.
+        if (end == begin || *begin == '#')
+            continue;
+
+        inputs.emplace_back(begin, end);
+    }
+
+    fclose(fp);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      コマンドライン引数を解析します.
+//-----------------------------------------------------------------------------
+bool ParseArgs(int argc, char** argv, BakeOption& option, bool& verbose, const char*& binLogPath)
+{
+    for(auto i=1; i<argc; ++i)
+    {
+        auto arg = argv[i];
+        auto hasValue = (i + 1 < argc);
+
+        if (strcmp(arg, "-o") == 0 && hasValue)
+        { option.OutputDir = argv[++i]; }
+        else if (strcmp(arg, "-m") == 0 && hasValue)
+        { option.ManifestPath = argv[++i]; }
+        else if (strcmp(arg, "-j") == 0 && hasValue)
+        { option.ThreadCount = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (strcmp(arg, "-p") == 0 && hasValue)
+        { option.ProcessCount = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (strcmp(arg, "--cross") == 0)
+        { option.GroupingMode = LOD_GROUPING_CROSS_SUBSET; }
+        else if (strcmp(arg, "--incremental") == 0)
+        { option.Incremental = true; }
+        else if (strcmp(arg, "--force") == 0)
+        { option.Force = true; }
+        else if (strcmp(arg, "-v") == 0)
+        { verbose = true; }
+        else if (strcmp(arg, "--binlog") == 0 && hasValue)
+        { binLogPath = argv[++i]; }
+        else if (strcmp(arg, "--trace") == 0 && hasValue)
+        { option.TracePath = argv[++i]; }
+        else if (arg[0] == '@')
+        {
+            if (!LoadInputList(arg + 1, option.Inputs))
+                return false;
+        }
+        else if (arg[0] == '-')
+        {
+            ELOGA("Error : Unknown Option. option = %s", arg);
+            return false;
+        }
+        else
+        { option.Inputs.emplace_back(arg); }
+    }
+
+    if (option.ThreadCount == 0)
+    { option.ThreadCount = std::max(std::thread::hardware_concurrency(), 1u); }
+
+    if (option.ProcessCount == 0)
+    { option.ProcessCount = 1; }
+
+    if (option.ManifestPath.empty())
+    { option.ManifestPath = option.OutputDir + "/manifest.json"; }
+
+    return !option.Inputs.empty();
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    BakeOption option;
+    auto verbose = false;
+    const char* binLogPath = nullptr;
+    if (!ParseArgs(argc, argv, option, verbose, binLogPath))
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    // メッシュレット生成時の統計ログは -v 指定時のみ出力する.
+    if (!verbose)
+    { asdx::SystemLogger::Instance().SetFilter(asdx::LOG_WARNING); }
+
+    // ワーカースレッドが標準出力のロックで詰まらないように非同期で出力する.
+    asdx::AsyncLogDesc logDesc;
+    logDesc.BinaryLogPath = binLogPath;
+    if (!asdx::SystemLogger::Instance().StartAsync(logDesc) && binLogPath != nullptr)
+    { return -1; }
+
+    auto& profiler = asdx::Profiler::Instance();
+    if (!option.TracePath.empty())
+    {
+        profiler.Start();
+        ASDX_PROFILE_THREAD("Main");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<BakeJobResult> results;
+    auto succeeded = RunBakeFarm(option, results);
+
+    auto wallTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (!results.empty() && !WriteBakeManifest(option.ManifestPath.c_str(), option, results, wallTime))
+    { succeeded = false; }
+
+    if (!option.TracePath.empty())
+    {
+        profiler.Stop();
+        if (!profiler.SaveChromeTrace(option.TracePath.c_str()))
+        { succeeded = false; }
+    }
+
+    // 集計結果がログに紛れないように書き出しを済ませておく.
+    asdx::SystemLogger::Instance().StopAsync();
+
+    // 集計.
+    uint32_t baked  = 0;
+    uint32_t cached = 0;
+    uint32_t failed = 0;
+    double meshletTime  = 0.0;
+    double lodTime      = 0.0;
+    double compressTime = 0.0;
+    double totalTime    = 0.0;
+    for(const auto& result : results)
+    {
+        if (result.State == BAKE_STATE_BAKED)  { baked++; }
+        else if (result.State == BAKE_STATE_CACHED) { cached++; }
+        else { failed++; }
+
+        meshletTime  += result.MeshletTime;
+        lodTime      += result.LodTime;
+        compressTime += result.CompressTime;
+        totalTime    += result.TotalTime;
+    }
+
+    printf("----\n");
+    printf("baked %u, cached %u, failed %u  (processes %u x threads %u)\n",
+        baked, cached, failed, option.ProcessCount, option.ThreadCount);
+    printf("stage : meshlet %.1f ms, lod %.1f ms, compress %.1f ms\n", meshletTime, lodTime, compressTime);
+    printf("wall  : %.1f ms (job total %.1f ms, speedup x%.2f)\n",
+        wallTime, totalTime, (wallTime > 0.0) ? totalTime / wallTime : 0.0);
+    printf("manifest : %s\n", option.ManifestPath.c_str());
+    if (!option.TracePath.empty())
+    { printf("trace    : %s\n", option.TracePath.c_str()); }
+
+    return succeeded ? 0 : 1;
+}
@@ -0,0 +1,376 @@
+﻿//-----------------------------------------------------------------------------
+// File : TestLodBakeCache.cpp
+// Desc : Incremental LOD Rebake Test.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <Compat.h>
+#include <LodGenerator.h>
+#include "asdxTest.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      タイル毎にマテリアルを割り当てたMTLファイルを書き出します.
+//-----------------------------------------------------------------------------
+bool WriteGridMTL(const char* path, uint32_t tileCount)
+{
+    FILE* fp = nullptr;
+    if (fopen_s(&fp, path, "w") != 0)
+    {
+        fprintf(stderr, "Error : File Open Failed. path = %s\n", path);
+        return false;
+    }
+
+    for(auto i=0u; i<tileCount; ++i)
+    { fprintf(fp, "newmtl Tile%u\nKd 1.0 1.0 1.0\n", i); }
+
+    fclose(fp);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      高さ場のグリッドメッシュをOBJ形式で書き出します.
+//-----------------------------------------------------------------------------
+bool WriteGridOBJ(const char* path, const char* mtlName, uint32_t size, uint32_t tiles, float editOffset)
+{
+    FILE* fp = nullptr;
+    if (fopen_s(&fp, path, "w") != 0)
+    {
+        fprintf(stderr, "Error : File Open Failed. path = %s\n", path);
+        return false;
+    }
+
+    fprintf(fp, "mtllib %s\n", mtlName);
+
+    auto inv = 1.0f / float(size);
+    for(auto y=0u; y<=size; ++y)
+    {
+        for(auto x=0u; x<=size; ++x)
+        {
+            auto z  = 0.05f * sinf(float(x) * 0.3f) * cosf(float(y) * 0.2f);
+            auto dx = 0.015f * cosf(float(x) * 0.3f) * cosf(float(y) * 0.2f) * float(size);
+            auto dy = -0.01f * sinf(float(x) * 0.3f) * sinf(float(y) * 0.2f) * float(size);
+
+            // 編集範囲 (左下の角) だけ頂点を盛り上げる.
+            // 角は先頭のタイルにあるので, メッシュレットと頂点番号の並びが後続のタイルまで変わる.
+            if (x < size / 5 && y < size / 5)
+            { z += editOffset * sinf(float(x) * 0.7f) * sinf(float(y) * 0.7f); }
+
+            fprintf(fp, "v %f %f %f\n", float(x) * inv, float(y) * inv, z);
+            fprintf(fp, "vt %f %f\n", float(x) * inv, float(y) * inv);
+
+            // 法線が無いと面法線で頂点が分割されて接続性が失われるので, 高さ場の法線を与える.
+            auto len = sqrtf(dx * dx + dy * dy + 1.0f);
+            fprintf(fp, "vn %f %f %f\n", -dx / len, -dy / len, 1.0f / len);
+        }
+    }
+
+    // タイル毎にサブセットを分ける.
+    auto tileSize = size / tiles;
+    for(auto ty=0u; ty<tiles; ++ty)
+    {
+        for(auto tx=0u; tx<tiles; ++tx)
+        {
+            fprintf(fp, "usemtl Tile%u\n", ty * tiles + tx);
+
+            for(auto y=ty * tileSize; y<(ty + 1) * tileSize; ++y)
+            {
+                for(auto x=tx * tileSize; x<(tx + 1) * tileSize; ++x)
+                {
+                    auto a = y * (size + 1) + x + 1;
+                    auto b = a + 1;
+                    auto c = a + size + 1;
+                    auto d = c + 1;
+                    fprintf(fp, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, d, d, d);
+                    fprintf(fp, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, d, d, d, c, c, c);
+                }
+            }
+        }
+    }
+
+    fclose(fp);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュレットを生成します.
+//-----------------------------------------------------------------------------
+bool CreateGridMeshlets(const std::string& dir, const char* name, float editOffset, ResMeshlets& meshlets)
+{
+    const uint32_t kGridSize  = 192;
+    const uint32_t kGridTiles = 2;
+
+    auto mtlName = std::string(name) + ".mtl";
+    auto mtlPath = dir + "/" + mtlName;
+    auto path    = dir + "/" + name;
+    if (!WriteGridMTL(mtlPath.c_str(), kGridTiles * kGridTiles)
+     || !WriteGridOBJ(path.c_str(), mtlName.c_str(), kGridSize, kGridTiles, editOffset))
+    { return false; }
+
+    auto ret = CreateMeshlets(path.c_str(), meshlets);
+    remove(path.c_str());
+    remove(mtlPath.c_str());
+    return ret;
+}
+
+//-----------------------------------------------------------------------------
+//      配列の中身が一致するかどうか.
+//-----------------------------------------------------------------------------
+template<typename T>
+bool IsSame(const std::vector<T>& lhs, const std::vector<T>& rhs)
+{
+    if (lhs.size() != rhs.size())
+    { return false; }
+
+    return lhs.empty() || memcmp(lhs.data(), rhs.data(), sizeof(T) * lhs.size()) == 0;
+}
+
+//-----------------------------------------------------------------------------
+//      値が一致するかどうか.
+//-----------------------------------------------------------------------------
+template<typename T>
+bool IsSame(const T& lhs, const T& rhs)
+{ return memcmp(&lhs, &rhs, sizeof(T)) == 0; }
+
+//-----------------------------------------------------------------------------
+//      ベイク結果が一致するかどうか.
+//-----------------------------------------------------------------------------
+bool IsSame(const ResLodMeshlets& lhs, const ResLodMeshlets& rhs)
+{
+    if (lhs.Meshlets.size() != rhs.Meshlets.size())
+    { return false; }
+
+    for(size_t i=0; i<lhs.Meshlets.size(); ++i)
+    {
+        auto& a = lhs.Meshlets[i];
+        auto& b = rhs.Meshlets[i];
+        auto same = IsSame(a.NormalCone,     b.NormalCone)
+                 && IsSame(a.BoundingSphere, b.BoundingSphere)
+                 && a.MaterialId == b.MaterialId
+                 && a.Lod        == b.Lod
+                 && IsSame(a.ParentError,    b.ParentError)
+                 && IsSame(a.GroupError,     b.GroupError)
+                 && IsSame(a.ParentBounds,   b.ParentBounds)
+                 && IsSame(a.GroupBounds,    b.GroupBounds)
+                 && IsSame(a.Primitives,     b.Primitives)
+                 && IsSame(a.VertIndices,    b.VertIndices);
+        if (!same)
+        { return false; }
+    }
+
+    return IsSame(lhs.Positions,         rhs.Positions)
+        && IsSame(lhs.Normals,           rhs.Normals)
+        && IsSame(lhs.Tangents,          rhs.Tangents)
+        && IsSame(lhs.TexCoords,         rhs.TexCoords)
+        && IsSame(lhs.Subsets,           rhs.Subsets)
+        && IsSame(lhs.LodRanges,         rhs.LodRanges)
+        && IsSame(lhs.BvhNodes,          rhs.BvhNodes)
+        && IsSame(lhs.BvhMeshletIndices, rhs.BvhMeshletIndices)
+        && IsSame(lhs.BoundingSphere,    rhs.BoundingSphere)
+        && lhs.MaxLodLevel == rhs.MaxLodLevel;
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュ付きでベイクします.
+//-----------------------------------------------------------------------------
+bool Bake(const ResMeshlets& meshlets, LOD_GROUPING_MODE mode, LodBakeCache& cache, ResLodMeshlets& result)
+{
+    // 出力は追記されるので毎回空にしておく.
+    result = ResLodMeshlets();
+    return CreateLodMeshlets(meshlets, result, mode, &cache);
+}
+
+//-----------------------------------------------------------------------------
+//      2つのキャッシュに共通するエントリー数を数えます.
+//-----------------------------------------------------------------------------
+uint32_t CountShared(const LodBakeCache& lhs, const LodBakeCache& rhs)
+{
+    uint32_t count = 0;
+    for(auto& pair : lhs.Entries)
+    {
+        if (rhs.Entries.find(pair.first) != rhs.Entries.end())
+        { count++; }
+    }
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+//      部分編集後の再ベイクをテストします.
+//-----------------------------------------------------------------------------
+void TestRebake(const std::string& dir, LOD_GROUPING_MODE mode)
+{
+    printf("mode = %s\n", (mode == LOD_GROUPING_PER_SUBSET) ? "per subset" : "cross subset");
+
+    ResMeshlets original;
+    ResMeshlets edited;
+    ASDX_CHECK(CreateGridMeshlets(dir, "original.obj", 0.0f, original));
+    ASDX_CHECK(CreateGridMeshlets(dir, "edited.obj",   0.02f, edited));
+
+    // キャッシュを使わないベイクが基準.
+    ResLodMeshlets coldOriginal;
+    ResLodMeshlets coldEdited;
+    ASDX_CHECK(CreateLodMeshlets(original, coldOriginal, mode, nullptr));
+    ASDX_CHECK(CreateLodMeshlets(edited,   coldEdited,   mode, nullptr));
+
+    // 空のキャッシュで全グループを計算する.
+    LodBakeCache   cache = {};
+    ResLodMeshlets baked;
+    ASDX_CHECK(Bake(original, mode, cache, baked));
+    ASDX_CHECK(IsSame(baked, coldOriginal));
+    ASDX_CHECK(cache.MissCount > 0);
+
+    auto groupCount = cache.HitCount + cache.MissCount;
+    printf("    first  : hit = %u, miss = %u\n", cache.HitCount, cache.MissCount);
+
+    // 同じ入力なら全グループを再利用する.
+    ASDX_CHECK(Bake(original, mode, cache, baked));
+    printf("    same   : hit = %u, miss = %u\n", cache.HitCount, cache.MissCount);
+    ASDX_CHECK(IsSame(baked, coldOriginal));
+    ASDX_CHECK(cache.MissCount == 0);
+    ASDX_CHECK(cache.HitCount  == groupCount);
+
+    // 編集後のメッシュ単体で取れるグループの集合.
+    LodBakeCache editedOnly = {};
+    ASDX_CHECK(Bake(edited, mode, editedOnly, baked));
+    ASDX_CHECK(IsSame(baked, coldEdited));
+
+    // 再利用数 = 編集後のメッシュ内での重複 + 編集前と入力が一致するグループ数.
+    auto expectedHit = editedOnly.HitCount + CountShared(editedOnly, cache);
+
+    auto previous = cache;
+    ASDX_CHECK(Bake(edited, mode, cache, baked));
+    printf("    edited : hit = %u, miss = %u (expected hit = %u)\n", cache.HitCount, cache.MissCount, expectedHit);
+    ASDX_CHECK(IsSame(baked, coldEdited));
+    ASDX_CHECK(cache.HitCount  == expectedHit);
+    ASDX_CHECK(cache.HitCount + cache.MissCount == editedOnly.HitCount + editedOnly.MissCount);
+
+    // 編集したグループは再計算される.
+    ASDX_CHECK(cache.MissCount > 0);
+
+    // 角だけの編集なので, 頂点番号が振り直されても編集範囲に掛からないグループは再利用される.
+    ASDX_CHECK(cache.HitCount > 0);
+
+    // 参照されなかったグループはキャッシュから取り除かれる.
+    ASDX_CHECK(cache.Entries.size() == editedOnly.Entries.size());
+    ASDX_CHECK(CountShared(cache, previous) == CountShared(editedOnly, previous));
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュファイルの保存と読み込みをテストします.
+//-----------------------------------------------------------------------------
+void TestSaveLoad(const std::string& dir)
+{
+    ResMeshlets meshlets;
+    ASDX_CHECK(CreateGridMeshlets(dir, "saveload.obj", 0.0f, meshlets));
+
+    ResLodMeshlets cold;
+    ASDX_CHECK(CreateLodMeshlets(meshlets, cold, LOD_GROUPING_PER_SUBSET, nullptr));
+
+    LodBakeCache   cache = {};
+    ResLodMeshlets baked;
+    ASDX_CHECK(Bake(meshlets, LOD_GROUPING_PER_SUBSET, cache, baked));
+    auto firstHit   = cache.HitCount;
+    auto firstMiss  = cache.MissCount;
+    auto groupCount = firstHit + firstMiss;
+
+    auto path = dir + "/test.lodcache";
+    ASDX_CHECK(SaveLodBakeCache(path.c_str(), cache));
+
+    // 読み込んだキャッシュだけで全グループを再利用できる.
+    {
+        LodBakeCache loaded = {};
+        ASDX_CHECK(LoadLodBakeCache(path.c_str(), loaded));
+        ASDX_CHECK(loaded.Entries.size() == cache.Entries.size());
+
+        ASDX_CHECK(Bake(meshlets, LOD_GROUPING_PER_SUBSET, loaded, baked));
+        printf("loaded : hit = %u, miss = %u\n", loaded.HitCount, loaded.MissCount);
+        ASDX_CHECK(loaded.MissCount == 0);
+        ASDX_CHECK(loaded.HitCount  == groupCount);
+        ASDX_CHECK(IsSame(baked, cold));
+    }
+
+    // ファイルを読み直す.
+    std::vector<uint8_t> binary;
+    {
+        FILE* fp = nullptr;
+        ASDX_CHECK(fopen_s(&fp, path.c_str(), "rb") == 0);
+        if (fp != nullptr)
+        {
+            uint8_t buf[4096];
+            size_t  size = 0;
+            while((size = fread(buf, 1, sizeof(buf), fp)) > 0)
+            { binary.insert(binary.end(), buf, buf + size); }
+            fclose(fp);
+        }
+    }
+
+    auto writeBinary = [&](const std::vector<uint8_t>& data)
+    {
+        FILE* fp = nullptr;
+        if (fopen_s(&fp, path.c_str(), "wb") != 0)
+        { return false; }
+        fwrite(data.data(), 1, data.size(), fp);
+        fclose(fp);
+        return true;
+    };
+
+    // バージョン違いは読み込まない. ヘッダは Magic[4], Version の順.
+    {
+        auto data = binary;
+        uint32_t version = 0;
+        memcpy(&version, data.data() + 4, sizeof(version));
+        version++;
+        memcpy(data.data() + 4, &version, sizeof(version));
+        ASDX_CHECK(writeBinary(data));
+
+        LodBakeCache loaded = {};
+        loaded.Entries = cache.Entries;
+        ASDX_CHECK(!LoadLodBakeCache(path.c_str(), loaded));
+        ASDX_CHECK(loaded.Entries.empty());
+
+        // 読み込みに失敗しても空のキャッシュとしてベイクできる.
+        ASDX_CHECK(Bake(meshlets, LOD_GROUPING_PER_SUBSET, loaded, baked));
+        ASDX_CHECK(loaded.HitCount  == firstHit);
+        ASDX_CHECK(loaded.MissCount == firstMiss);
+        ASDX_CHECK(IsSame(baked, cold));
+    }
+
+    // 途中で切れたファイルは読み込まない.
+    {
+        auto data = binary;
+        data.resize(data.size() / 2);
+        ASDX_CHECK(writeBinary(data));
+
+        LodBakeCache loaded = {};
+        ASDX_CHECK(!LoadLodBakeCache(path.c_str(), loaded));
+        ASDX_CHECK(loaded.Entries.empty());
+    }
+
+    remove(path.c_str());
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    // 作業ディレクトリ.
+    std::string dir = (argc > 1) ? argv[1] : ".";
+
+    TestRebake(dir, LOD_GROUPING_PER_SUBSET);
+    TestRebake(dir, LOD_GROUPING_CROSS_SUBSET);
+    TestSaveLoad(dir);
+
+    return asdx::test::Finish("TestLodBakeCache");
+}
@@ -0,0 +1,51 @@
+﻿//-----------------------------------------------------------------------------
+// File : Compat.h
+// Desc : Compatibility Helpers For Non-Windows Build.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+#include <cerrno>
+#include <limits>
+
+
+#ifndef _WIN32
+
+#ifndef _countof
+#define _countof(x)     (sizeof(x) / sizeof(x[0]))
+#endif//_countof
+
+//-----------------------------------------------------------------------------
+//! @brief      ファイルを開きます.
+//!
+//! @note       MSVC の fopen_s() 相当です.
+//-----------------------------------------------------------------------------
+inline int fopen_s(FILE** ppFile, const char* path, const char* mode)
+{
+    if (ppFile == nullptr)
+    { return EINVAL; }
+
+    *ppFile = fopen(path, mode);
+    return (*ppFile != nullptr) ? 0 : errno;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      文字列をコピーします.
+//!
+//! @note       MSVC の strcpy_s() 相当です. 溢れる場合は切り詰めます.
+//-----------------------------------------------------------------------------
+template<size_t N>
+inline int strcpy_s(char (&dst)[N], const char* src)
+{
+    strncpy(dst, src, N - 1);
+    dst[N - 1] = '\0';
+    return 0;
+}
+
+#endif//_WIN32
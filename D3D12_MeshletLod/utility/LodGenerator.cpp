@@ -9,10 +9,16 @@
 //-----------------------------------------------------------------------------
 // Includes
 //-----------------------------------------------------------------------------
+#include <cmath>
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
 #include <functional>
 #include <algorithm>
+#include <mutex>
 #include <unordered_map>
 
+#include <Compat.h>
 #include <LodGenerator.h>
 #include <meshoptimizer.h>
 
@@ -30,10 +36,19 @@ namespace {
 //-----------------------------------------------------------------------------
 // Constant Values.
 //-----------------------------------------------------------------------------
-static const int      kMinGroups    = 64;    // 最小グループ数.
-static const uint32_t kMaxLodLevels = 256;   // 最大LOD数.
+static const int      kMinGroups        = 64;    // 最小グループ数.
+static const uint32_t kMaxLodLevels     = 256;   // 最大LOD数.
+static const uint32_t kBvhWidth         = 8;     // BVHノードの最大子ノード数.
+static const uint32_t kBvhLeafMeshlets  = 32;    // BVH葉ノードの最大メッシュレット数.
+static const uint32_t kLodMeshletsVersion  = 1;  // LODメッシュレットファイルのバージョン.
+static const uint32_t kLodBakeCacheVersion = 2;  // ベイクキャッシュのバージョン(削減・分割処理を変更したら上げること).
+static const uint64_t kFnvOffset        = 14695981039346656037ull;  // FNV-1a オフセット基底.
+static const uint64_t kFnvPrime         = 1099511628211ull;         // FNV-1a 素数.
 
 
+// METISは乱数状態をグローバルに持つので，複数スレッドから同時に呼び出さないようにする.
+std::mutex  g_MetisMutex;
+
 using Edge = std::pair<uint32_t, uint32_t>; // エッジデータ - (頂点0 - 頂点1).
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -43,8 +58,9 @@ struct EdgeHash
 {
     size_t operator() (const Edge& value) const
     {
-        const auto hasher = std::hash<uint32_t>{};
-        return hasher(value.first) ^ hasher(value.second);
+        // 排他的論理和では (a, b) と (a^k, b^k) が衝突するため，64bitに詰めてからハッシュ化する.
+        const auto key = (uint64_t(value.first) << 32) | uint64_t(value.second);
+        return std::hash<uint64_t>{}(key);
     }
 };
 
@@ -62,6 +78,7 @@ struct MeshletGroup
 struct MergeInfo
 {
     std::vector<uint32_t>   Indices;
+    std::vector<uint32_t>   MaterialIds;    // 三角形毎のマテリアルID.
     float                   Error;
     bool                    IsMerged;
     asdx::Vector4           BoundingSphere;
@@ -75,6 +92,7 @@ struct MergeVertex
     asdx::Vector3 Pos;
     asdx::Vector3 Normal;
     asdx::Vector2 TexCoord;
+    uint32_t      MaterialId;   // マテリアルが異なる頂点は重複削除しない(シームとして扱われる).
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -89,6 +107,117 @@ struct SubsetMeshlets
 using EdgeToMeshletMap  = std::unordered_map<Edge,   std::vector<size_t>, EdgeHash>; // エッジからメッシュレットへの辞書.
 using MeshletToEdgeMap  = std::unordered_map<size_t, std::vector<Edge>>;             // メッシュレットからエッジへの辞書.
 using VertexAdjacentMap = std::unordered_map<uint32_t, std::vector<uint32_t>>;       // 頂点番号から隣接頂点番号への辞書.
+using LodCacheMap       = std::unordered_map<uint64_t, LodCacheEntry>;                // ハッシュ値からベイク結果への辞書.
+
+///////////////////////////////////////////////////////////////////////////////
+// LodBakeCacheHeader structure
+///////////////////////////////////////////////////////////////////////////////
+struct LodBakeCacheHeader
+{
+    char        Magic[4];
+    uint32_t    Version;
+    uint64_t    EntryCount;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LodCacheEntryHeader structure
+///////////////////////////////////////////////////////////////////////////////
+struct LodCacheEntryHeader
+{
+    uint64_t        Hash;
+    asdx::Vector4   BoundingSphere;
+    float           Error;
+    uint32_t        IsMerged;
+    uint32_t        MeshletCount;
+    uint32_t        Reserved;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LodCacheMeshletHeader structure
+///////////////////////////////////////////////////////////////////////////////
+struct LodCacheMeshletHeader
+{
+    uint8_t4        NormalCone;
+    asdx::Vector4   BoundingSphere;
+    uint32_t        MaterialId;
+    uint32_t        Lod;
+    float           ParentError;
+    float           GroupError;
+    asdx::Vector4   ParentBounds;
+    asdx::Vector4   GroupBounds;
+    uint32_t        PrimitiveCount;
+    uint32_t        VertexCount;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResLodMeshletsHeader structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResLodMeshletsHeader
+{
+    char            Magic[4];
+    uint32_t        Version;
+    uint64_t        PositionCount;
+    uint64_t        NormalCount;
+    uint64_t        TangentCount;
+    uint64_t        TexCoordCount;
+    uint64_t        MeshletCount;
+    uint64_t        VertIndexCount;
+    uint64_t        PrimitiveCount;
+    uint64_t        SubsetCount;
+    uint64_t        LodRangeCount;
+    uint64_t        BvhNodeCount;
+    uint64_t        BvhMeshletIndexCount;
+    asdx::Vector4   BoundingSphere;
+    uint32_t        MaxLodLevel;
+    uint32_t        Reserved;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LodMeshletRecord structure
+///////////////////////////////////////////////////////////////////////////////
+struct LodMeshletRecord
+{
+    uint8_t4        NormalCone;
+    asdx::Vector4   BoundingSphere;
+    uint32_t        MaterialId;
+    uint32_t        Lod;
+    float           ParentError;
+    float           GroupError;
+    asdx::Vector4   ParentBounds;
+    asdx::Vector4   GroupBounds;
+    uint32_t        VertIndexOffset;
+    uint32_t        VertIndexCount;
+    uint32_t        PrimitiveOffset;
+    uint32_t        PrimitiveCount;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GroupHasher structure
+///////////////////////////////////////////////////////////////////////////////
+struct GroupHasher
+{
+    uint64_t    Value = kFnvOffset;
+
+    void Add(const void* data, size_t size)
+    {
+        auto ptr = static_cast<const uint8_t*>(data);
+        for(size_t i=0; i<size; ++i)
+        { Value = (Value ^ ptr[i]) * kFnvPrime; }
+    }
+
+    template<typename T>
+    void Add(const T& value)
+    { Add(&value, sizeof(value)); }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GroupVertexTable structure
+///////////////////////////////////////////////////////////////////////////////
+struct GroupVertexTable
+{
+    std::vector<uint32_t>                   VertIds;    // ローカル番号 ---> 頂点番号.
+    std::unordered_map<uint32_t, uint32_t>  LocalIds;   // 頂点番号 ---> ローカル番号.
+};
 
 //-----------------------------------------------------------------------------
 //      末尾に連結します.
@@ -390,10 +519,85 @@ void BuildVertexConectivity
     }
 }
 
+//-----------------------------------------------------------------------------
+//      溶接済み頂点番号で共有エッジを求め，メッシュレットの隣接グラフを構築します.
+//-----------------------------------------------------------------------------
+template<typename Index>
+bool BuildWeldedAdjacency
+(
+    const std::vector<LodMeshletInfo>&  meshlets,
+    const std::vector<uint32_t>&        weldRemap,
+    std::vector<Index>&                 xAdjacency,
+    std::vector<Index>&                 edgeAdjacency,
+    std::vector<Index>&                 edgeWeights
+)
+{
+    EdgeToMeshletMap edge2Meshlet;
+
+    for(size_t mId = 0; mId < meshlets.size(); ++mId)
+    {
+        const auto& meshlet = meshlets[mId];
+        for(const auto& prim : meshlet.Primitives)
+        {
+            for(size_t j=0; j<3; ++j)
+            {
+                auto v0 = weldRemap[meshlet.VertIndices[prim.v[j]]];
+                auto v1 = weldRemap[meshlet.VertIndices[prim.v[(j + 1) % 3]]];
+                if (v0 == v1)
+                    continue;
+
+                auto& list = edge2Meshlet[Edge(std::min(v0, v1), std::max(v0, v1))];
+                if (list.empty() || list.back() != mId)
+                { list.push_back(mId); }
+            }
+        }
+    }
+
+    // 共有エッジ数を重みとして隣接メッシュレットを登録.
+    std::vector<std::unordered_map<size_t, Index>> adjacency(meshlets.size());
+    for(const auto& pair : edge2Meshlet)
+    {
+        const auto& list = pair.second;
+        for(size_t i=0; i<list.size(); ++i)
+        {
+            for(size_t j=i+1; j<list.size(); ++j)
+            {
+                adjacency[list[i]][list[j]]++;
+                adjacency[list[j]][list[i]]++;
+            }
+        }
+    }
+
+    auto connected = false;
+    xAdjacency.reserve(meshlets.size() + 1);
+    for(size_t i=0; i<meshlets.size(); ++i)
+    {
+        xAdjacency.push_back(Index(edgeAdjacency.size()));
+
+        // 結果が辞書の走査順に依存しないように並べる.
+        std::vector<std::pair<size_t, Index>> sorted(adjacency[i].begin(), adjacency[i].end());
+        std::sort(sorted.begin(), sorted.end());
+
+        for(const auto& item : sorted)
+        {
+            edgeAdjacency.push_back(Index(item.first));
+            edgeWeights  .push_back(item.second);
+            connected = true;
+        }
+    }
+    xAdjacency.push_back(Index(edgeAdjacency.size()));
+
+    return connected;
+}
+
 //-----------------------------------------------------------------------------
 //      接続性に基づいて，メッシュレットをグループ化します.
 //-----------------------------------------------------------------------------
-std::vector<MeshletGroup> GroupMeshlets(const std::vector<LodMeshletInfo>& meshlets)
+std::vector<MeshletGroup> GroupMeshlets
+(
+    const std::vector<LodMeshletInfo>&  meshlets,
+    const std::vector<uint32_t>*        pWeldRemap = nullptr
+)
 {
     using namespace metis;
 
@@ -412,20 +616,6 @@ std::vector<MeshletGroup> GroupMeshlets(const std::vector<LodMeshletInfo>& meshl
         return std::vector<MeshletGroup>{ group };
     }
 
-    // 接続性を構築.
-    BuildMeshletConectivity(meshlets, e2m, m2e);
-
-    // 接続性が無い場合は，1つのグループとして返す.
-    if (e2m.empty())
-    {
-        MeshletGroup group;
-        group.MeshletIds.resize(meshletCount);
-        for(auto i=0u; i<meshletCount; ++i)
-        { group.MeshletIds[i] = i; }
-
-        return std::vector<MeshletGroup>{ group };
-    }
-
     idx_t count = idx_t(meshletCount);
 
     // idx_t はMETISで定義されている.
@@ -435,52 +625,83 @@ std::vector<MeshletGroup> GroupMeshlets(const std::vector<LodMeshletInfo>& meshl
     std::vector<idx_t>   edgeWeights;
 
     partition .resize (count);
-    xAdjacency.reserve(count + 1);
 
-    for(size_t i=0; i<meshletCount; ++i)
+    // マテリアルを跨ぐ場合は，位置座標で溶接した頂点番号で接続性を構築.
+    if (pWeldRemap != nullptr)
     {
-        auto offsetEdgeAdjacency = idx_t(edgeAdjacency.size());
-        for(const auto& edge : m2e[i])
+        if (!BuildWeldedAdjacency(meshlets, *pWeldRemap, xAdjacency, edgeAdjacency, edgeWeights))
         {
-            // 境界エッジからメッシュレットを探す.
-            auto itr = e2m.find(edge);
-            if (itr == e2m.end())
-                continue;
+            MeshletGroup group;
+            group.MeshletIds.resize(meshletCount);
+            for(auto i=0u; i<meshletCount; ++i)
+            { group.MeshletIds[i] = i; }
+
+            return std::vector<MeshletGroup>{ group };
+        }
+    }
+    else
+    {
+        // 接続性を構築.
+        BuildMeshletConectivity(meshlets, e2m, m2e);
 
-            // 接続されているメッシュレットについて処理.
-            const auto& connections = itr->second;
-            for(const auto& connectedMeshlet : connections)
+        // 接続性が無い場合は，1つのグループとして返す.
+        if (e2m.empty())
+        {
+            MeshletGroup group;
+            group.MeshletIds.resize(meshletCount);
+            for(auto i=0u; i<meshletCount; ++i)
+            { group.MeshletIds[i] = i; }
+
+            return std::vector<MeshletGroup>{ group };
+        }
+
+        xAdjacency.reserve(count + 1);
+
+        for(size_t i=0; i<meshletCount; ++i)
+        {
+            auto offsetEdgeAdjacency = idx_t(edgeAdjacency.size());
+            for(const auto& edge : m2e[i])
             {
-                // 自分自身ならスキップ.
-                if (connectedMeshlet == i)
+                // 境界エッジからメッシュレットを探す.
+                auto itr = e2m.find(edge);
+                if (itr == e2m.end())
                     continue;
 
-                // 隣接エッジリストに登録されているかチェック.
-                auto edgeItr = std::find(
-                    edgeAdjacency.begin() + offsetEdgeAdjacency,
-                    edgeAdjacency.end(),
-                    connectedMeshlet);
-
-                // 未登録.
-                if (edgeItr == edgeAdjacency.end())
-                {
-                    edgeAdjacency.emplace_back(idx_t(connectedMeshlet));
-                    edgeWeights  .emplace_back(1);
-                }
-                // 登録済み.
-                else
+                // 接続されているメッシュレットについて処理.
+                const auto& connections = itr->second;
+                for(const auto& connectedMeshlet : connections)
                 {
-                    auto d = std::distance(edgeAdjacency.begin(), edgeItr);
-                    assert(d >= 0);
-                    edgeWeights[d]++;
+                    // 自分自身ならスキップ.
+                    if (connectedMeshlet == i)
+                        continue;
+
+                    // 隣接エッジリストに登録されているかチェック.
+                    auto edgeItr = std::find(
+                        edgeAdjacency.begin() + offsetEdgeAdjacency,
+                        edgeAdjacency.end(),
+                        connectedMeshlet);
+
+                    // 未登録.
+                    if (edgeItr == edgeAdjacency.end())
+                    {
+                        edgeAdjacency.emplace_back(idx_t(connectedMeshlet));
+                        edgeWeights  .emplace_back(1);
+                    }
+                    // 登録済み.
+                    else
+                    {
+                        auto d = std::distance(edgeAdjacency.begin(), edgeItr);
+                        assert(d >= 0);
+                        edgeWeights[d]++;
+                    }
                 }
             }
-        }
 
-        // メッシュレット開始番号を登録.
-        xAdjacency.push_back(offsetEdgeAdjacency);
+            // メッシュレット開始番号を登録.
+            xAdjacency.push_back(offsetEdgeAdjacency);
+        }
+        xAdjacency.push_back(idx_t(edgeAdjacency.size()));
     }
-    xAdjacency.push_back(idx_t(edgeAdjacency.size()));
 
     idx_t constrainCount = 1;
     idx_t partsCount     = count / kMinGroups;
@@ -495,6 +716,7 @@ std::vector<MeshletGroup> GroupMeshlets(const std::vector<LodMeshletInfo>& meshl
     idx_t edgeCut; // final cost of the cut found by METIS.
 
     // METISを使ってグループ分けする.
+    std::unique_lock<std::mutex> locker(g_MetisMutex);
     auto ret = METIS_PartGraphKway(
         &count,
         &constrainCount,
@@ -509,6 +731,7 @@ std::vector<MeshletGroup> GroupMeshlets(const std::vector<LodMeshletInfo>& meshl
         options,
         &edgeCut,
         partition.data());
+    locker.unlock();
 
     // グループ番号を記録する.
     std::vector<MeshletGroup> groups(partsCount);
@@ -567,9 +790,10 @@ MergeInfo SimplifyGroup
                 auto index  = uint32_t(mergedIdx.size());
 
                 MergeVertex vtx = {};
-                vtx.Pos      = positions[vertId];
-                vtx.Normal   = normals[vertId];
-                vtx.TexCoord = texcoords[vertId];
+                vtx.Pos        = positions[vertId];
+                vtx.Normal     = normals[vertId];
+                vtx.TexCoord   = texcoords[vertId];
+                vtx.MaterialId = meshlet.MaterialId;
 
                 mergedIdx.emplace_back(index);
                 mergedPos.emplace_back(vtx);
@@ -664,6 +888,11 @@ MergeInfo SimplifyGroup
         // バウンディングスフィアを求める.
         result.BoundingSphere = ComputeBoundingSphere(indices, mergedPos);
 
+        // 三角形のマテリアルIDを記録. 頂点はマテリアル毎に分かれているので先頭の頂点で決まる.
+        result.MaterialIds.reserve(indices.size() / 3);
+        for(size_t j=0; j<indices.size(); j+=3)
+        { result.MaterialIds.emplace_back(mergedPos[indices[j]].MaterialId); }
+
         mergedPos.clear();
         mergedPos.shrink_to_fit();
 
@@ -694,6 +923,11 @@ MergeInfo SimplifyGroup
             result.Indices.emplace_back(vertId);
         }
 
+        // 三角形のマテリアルIDを記録.
+        result.MaterialIds.reserve(mergedIdx.size() / 3);
+        for(size_t j=0; j<mergedIdx.size(); j+=3)
+        { result.MaterialIds.emplace_back(mergedPos[mergedIdx[j]].MaterialId); }
+
         // マージせず.
         result.IsMerged = false;
 
@@ -812,121 +1046,790 @@ std::vector<LodMeshletInfo> BuildMeshlets
     return result;
 }
 
-} // namespace
-
-
 //-----------------------------------------------------------------------------
-//      LODメッシュレットを生成します.
+//      ポリゴン削減されたメッシュをマテリアル毎に分けてメッシュレットを生成します.
 //-----------------------------------------------------------------------------
-bool CreateLodMeshlets(const ResMeshlets& meshlets, ResLodMeshlets& lodMesh)
+std::vector<LodMeshletInfo> BuildMeshletsPerMaterial
+(
+    const MergeInfo&                    mergeInfo,
+    const std::vector<asdx::Vector3>&   positions,
+    uint32_t                            lodIndex,
+    float                               parentError
+)
 {
-    // サブセットごとにLODメッシュレットに変換.
-    std::vector<SubsetMeshlets> subsets;
-    Conversion(meshlets, subsets);
+    // マテリアル毎に三角形を振り分ける(出現順を維持).
+    std::vector<uint32_t>  materialIds;
+    std::vector<MergeInfo> parts;
+    for(size_t i=0; i<mergeInfo.MaterialIds.size(); ++i)
+    {
+        auto materialId = mergeInfo.MaterialIds[i];
+        auto itr = std::find(materialIds.begin(), materialIds.end(), materialId);
+        auto idx = size_t(std::distance(materialIds.begin(), itr));
+        if (itr == materialIds.end())
+        {
+            materialIds.push_back(materialId);
 
-    // サブセットのメモリを確保.
-    lodMesh.Subsets.resize(subsets.size());
+            MergeInfo part = {};
+            part.Error          = mergeInfo.Error;
+            part.IsMerged       = mergeInfo.IsMerged;
+            part.BoundingSphere = mergeInfo.BoundingSphere;
+            parts.emplace_back(std::move(part));
+        }
 
-    uint32_t maxLodLevel = 0;
+        auto& indices = parts[idx].Indices;
+        indices.push_back(mergeInfo.Indices[i * 3 + 0]);
+        indices.push_back(mergeInfo.Indices[i * 3 + 1]);
+        indices.push_back(mergeInfo.Indices[i * 3 + 2]);
+    }
 
-    // マテリアルごとに処理.
-    for(size_t i=0; i<subsets.size(); ++i)
+    // グループ誤差とバウンディングスフィアは全マテリアルで共通にする.
+    std::vector<LodMeshletInfo> result;
+    for(size_t i=0; i<parts.size(); ++i)
     {
-        // 入力データ.
-        std::vector<LodMeshletInfo> input = std::move(subsets[i].Meshlets);
+        auto meshlets = BuildMeshlets(parts[i], positions, lodIndex, materialIds[i], parentError);
+        add_range(result, meshlets);
+    }
 
-        // LOD範囲.
-        ResLodRange range = {};
-        range.Offset = uint32_t(lodMesh.Meshlets.size());
-        range.Count  = uint32_t(input.size());
+    return result;
+}
 
-        // マテリアルごとの全LODを含むメッシュレット総数のカウンター.
-        uint32_t totalMeshletCount = uint32_t(input.size());
-        
-        lodMesh.Subsets[i].MaterialId       = subsets[i].MaterialId;
-        lodMesh.Subsets[i].MeshletOffset    = range.Offset;
-        lodMesh.Subsets[i].LodRangeOffset   = uint32_t(lodMesh.LodRanges.size());
-        lodMesh.LodRanges.emplace_back(range);
+//-----------------------------------------------------------------------------
+//      グループ入力のハッシュ値を計算します.
+//-----------------------------------------------------------------------------
+uint64_t CalcGroupHash
+(
+    const MeshletGroup&                 group,
+    const std::vector<LodMeshletInfo>&  input,
+    const ResMeshlets&                  meshlets,
+    uint32_t                            lodIndex,
+    LOD_GROUPING_MODE                   mode,
+    uint32_t                            materialId,
+    float                               parentError,
+    GroupVertexTable&                   table
+)
+{
+    GroupHasher hasher;
+    hasher.Add(kLodBakeCacheVersion);
+    hasher.Add(uint32_t(mode));
+    hasher.Add(lodIndex);
+    hasher.Add(materialId);
+    hasher.Add(parentError);
+    hasher.Add(uint32_t(group.MeshletIds.size()));
+
+    table.VertIds.clear();
+    table.LocalIds.clear();
+
+    // メッシュレット番号はレベル毎に振り直されるので，中身だけを見る.
+    for(auto id : group.MeshletIds)
+    {
+        const auto& meshlet = input[id];
+        hasher.Add(meshlet.MaterialId);
+        hasher.Add(uint32_t(meshlet.Primitives.size()));
+        hasher.Add(meshlet.Primitives.data(), meshlet.Primitives.size() * sizeof(meshlet.Primitives[0]));
+        hasher.Add(uint32_t(meshlet.VertIndices.size()));
+
+        // 頂点番号は離れた場所の編集でも振り直されるので，グループ内の出現順で付けたローカル番号と頂点属性を見る.
+        for(auto vertId : meshlet.VertIndices)
+        {
+            auto ret = table.LocalIds.try_emplace(vertId, uint32_t(table.VertIds.size()));
+            hasher.Add(ret.first->second);
 
-        // メッシュレットを追加.
-        add_range(lodMesh.Meshlets, input);
+            if (!ret.second)
+            { continue; }
 
-        // LODレベル.
-        uint32_t lodIndex = 1;
+            table.VertIds.push_back(vertId);
+            hasher.Add(meshlets.Positions[vertId]);
+            hasher.Add(meshlets.Normals  [vertId]);
+            hasher.Add(meshlets.TexCoords[vertId]);
+        }
+    }
 
-        // 指定数に達するまでループ.
-        while(input.size() > 1 && lodIndex < (kMaxLodLevels - 1))
-        {
-            // 接続性に基づいてメッシュレットをグループ化.
-            auto groups = GroupMeshlets(input);
+    return hasher.Value;
+}
 
-            bool isMerged = false;
-            std::vector<LodMeshletInfo> simplifies;
-            for(const auto& group : groups)
-            {
-                // グループ化したものを1つのメッシュにマージして，ポリゴン削減する.
-                auto mergedInfo = SimplifyGroup(group, input, meshlets.Positions, meshlets.Normals, meshlets.TexCoords, meshlets.VertexIndices, lodIndex);
+//-----------------------------------------------------------------------------
+//      ベイク結果の頂点番号をグループ内のローカル番号に変換します.
+//-----------------------------------------------------------------------------
+void ToLocalVertIndices(const GroupVertexTable& table, LodCacheEntry& entry)
+{
+    // 削減後の頂点はグループの入力頂点から選ばれるので，必ず辞書にある.
+    for(auto& meshlet : entry.Meshlets)
+    {
+        for(auto& vertId : meshlet.VertIndices)
+        { vertId = table.LocalIds.at(vertId); }
+    }
+}
 
-                // マージされていなければ以降の処理はスキップ.
-                if (!mergedInfo.IsMerged)
-                    continue;
+//-----------------------------------------------------------------------------
+//      キャッシュのローカル番号を今回の頂点番号に変換します.
+//-----------------------------------------------------------------------------
+void ToGlobalVertIndices(const GroupVertexTable& table, LodCacheEntry& entry)
+{
+    for(auto& meshlet : entry.Meshlets)
+    {
+        for(auto& localId : meshlet.VertIndices)
+        {
+            assert(localId < table.VertIds.size());
+            localId = table.VertIds[localId];
+        }
+    }
+}
 
-                float parentError = 0;
-                for(auto id : group.MeshletIds)
-                {
-                    const auto& meshlet = input[id];
-                    parentError = asdx::Max(parentError, meshlet.GroupError);
-                }
+//-----------------------------------------------------------------------------
+//      グループをポリゴン削減し，メッシュレットを生成します. 入力が一致するキャッシュがあれば再利用します.
+//-----------------------------------------------------------------------------
+void BakeGroup
+(
+    const MeshletGroup&                 group,
+    const std::vector<LodMeshletInfo>&  input,
+    const ResMeshlets&                  meshlets,
+    uint32_t                            lodIndex,
+    LOD_GROUPING_MODE                   mode,
+    uint32_t                            materialId,
+    float                               parentError,
+    LodCacheMap&                        prevEntries,
+    LodBakeCache*                       pCache,
+    LodCacheEntry&                      result
+)
+{
+    uint64_t         hash = 0;
+    GroupVertexTable table;
+    if (pCache != nullptr)
+    {
+        hash = CalcGroupHash(group, input, meshlets, lodIndex, mode, materialId, parentError, table);
 
-                // ポリゴン削減されたメッシュを，新しくメッシュレットに分割.
-                auto newOnes = BuildMeshlets(mergedInfo, meshlets.Positions, lodIndex, subsets[i].MaterialId, parentError);
+        // 今回のベイクで既に処理済み.
+        auto itr = pCache->Entries.find(hash);
+        if (itr != pCache->Entries.end())
+        {
+            result = itr->second;
+            ToGlobalVertIndices(table, result);
+            pCache->HitCount++;
+            return;
+        }
 
-                const auto groupError = mergedInfo.Error + parentError;
-                for(auto& id : group.MeshletIds)
-                {
-                    // 1つ前のLOD(=入力データinput)が今新しく作ったメッシュレットの親になる.
-                    const auto offset = lodMesh.LodRanges.back().Offset;
-                    auto& parent = lodMesh.Meshlets[offset + id];
-                    parent.ParentError  = groupError;
-                    parent.ParentBounds = mergedInfo.BoundingSphere;
-                }
+        // 前回のベイク結果を引き継ぐ.
+        itr = prevEntries.find(hash);
+        if (itr != prevEntries.end())
+        {
+            result = itr->second;
+            ToGlobalVertIndices(table, result);
+            pCache->Entries.emplace(hash, std::move(itr->second));
+            prevEntries.erase(itr);
+            pCache->HitCount++;
+            return;
+        }
+    }
 
-                // 新しいメッシュレットを追加.
-                add_range(simplifies, newOnes);
+    // グループ化したものを1つのメッシュにマージして，ポリゴン削減する.
+    auto mergedInfo = SimplifyGroup(group, input, meshlets.Positions, meshlets.Normals, meshlets.TexCoords, meshlets.VertexIndices, lodIndex);
 
-                // マージした.
-                isMerged = true;
-            }
+    result.Error          = mergedInfo.Error;
+    result.BoundingSphere = mergedInfo.BoundingSphere;
+    result.IsMerged       = mergedInfo.IsMerged ? 1 : 0;
+    result.Meshlets.clear();
 
-            // 1回もマージされなければおしまい.
-            if (!isMerged)
-                break;
+    // ポリゴン削減されたメッシュを，新しくメッシュレットに分割.
+    if (mergedInfo.IsMerged)
+    {
+        result.Meshlets = (mode == LOD_GROUPING_CROSS_SUBSET)
+            ? BuildMeshletsPerMaterial(mergedInfo, meshlets.Positions, lodIndex, parentError)
+            : BuildMeshlets(mergedInfo, meshlets.Positions, lodIndex, materialId, parentError);
+    }
 
-            // 新しいメッシュレットに差し替える.
-            input = std::move(simplifies);
+    // キャッシュにはローカル番号で格納する.
+    if (pCache != nullptr)
+    {
+        auto entry = result;
+        ToLocalVertIndices(table, entry);
+        pCache->Entries.emplace(hash, std::move(entry));
+        pCache->MissCount++;
+    }
+}
 
-            // LOD範囲を設定.
-            range.Offset = uint32_t(lodMesh.Meshlets.size());
-            range.Count  = uint32_t(input.size());
-            lodMesh.LodRanges.emplace_back(range);
+///////////////////////////////////////////////////////////////////////////////
+// BvhBuildNode structure
+///////////////////////////////////////////////////////////////////////////////
+struct BvhBuildNode
+{
+    ResLodBvhNode           Node;       // 出力ノード.
+    asdx::Vector3           Center;     // 分割用の代表点.
+    std::vector<uint32_t>   Children;   // 子ノード(葉の場合はメッシュレット番号).
+};
 
-            totalMeshletCount += range.Count;
+//-----------------------------------------------------------------------------
+//      空のスフィアを取得します.
+//-----------------------------------------------------------------------------
+inline asdx::Vector4 EmptySphere()
+{ return asdx::Vector4(0.0f, 0.0f, 0.0f, -1.0f); }
 
-            // LODレベルをカウントアップ.
-            lodIndex++;
+//-----------------------------------------------------------------------------
+//      2つのスフィアを包含するスフィアを求めます.
+//-----------------------------------------------------------------------------
+asdx::Vector4 MergeSphere(const asdx::Vector4& a, const asdx::Vector4& b)
+{
+    if (a.w < 0.0f) { return b; }
+    if (b.w < 0.0f) { return a; }
 
-            add_range(lodMesh.Meshlets, input);
-        }
+    const auto ca = asdx::Vector3(a.x, a.y, a.z);
+    const auto cb = asdx::Vector3(b.x, b.y, b.z);
+    const auto d  = (cb - ca).Length();
 
-        // 総数を記録.
-        lodMesh.Subsets[i].MeshletCount  = totalMeshletCount;
-        lodMesh.Subsets[i].LodRangeCount = lodIndex;
+    if (d + b.w <= a.w) { return a; }
+    if (d + a.w <= b.w) { return b; }
 
-        maxLodLevel = asdx::Max(maxLodLevel, lodIndex);
-    }
+    const auto r = (d + a.w + b.w) * 0.5f;
+    const auto c = ca + (cb - ca) * ((r - a.w) / d);
+    return asdx::Vector4(c, r);
+}
 
-    lodMesh.Positions       = meshlets.Positions;
-    lodMesh.Normals         = meshlets.Normals;
+//-----------------------------------------------------------------------------
+//      ノードに子の情報を統合します.
+//-----------------------------------------------------------------------------
+void MergeNode(ResLodBvhNode& dst, const ResLodBvhNode& src)
+{
+    dst.GroupBounds    = MergeSphere(dst.GroupBounds, src.GroupBounds);
+    dst.MinGroupError  = asdx::Min(dst.MinGroupError,  src.MinGroupError);
+    dst.MaxParentError = asdx::Max(dst.MaxParentError, src.MaxParentError);
+
+    // 無限大の誤差は常に訪問対象になるのでバウンディングスフィアには含めない.
+    if (!std::isinf(src.MaxParentError))
+    { dst.ParentBounds = MergeSphere(dst.ParentBounds, src.ParentBounds); }
+}
+
+//-----------------------------------------------------------------------------
+//      空のノードを生成します.
+//-----------------------------------------------------------------------------
+ResLodBvhNode EmptyNode()
+{
+    ResLodBvhNode result = {};
+    result.GroupBounds    = EmptySphere();
+    result.ParentBounds   = EmptySphere();
+    result.MinGroupError  = std::numeric_limits<float>::infinity();
+    result.MaxParentError = 0.0f;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      代表点の広がりが最大となる軸で範囲を2分割します.
+//-----------------------------------------------------------------------------
+template<typename GetCenter>
+size_t SplitMedian(std::vector<uint32_t>& items, size_t begin, size_t end, size_t mid, GetCenter getCenter)
+{
+    auto mini = asdx::Vector3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    auto maxi = asdx::Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for(auto i=begin; i<end; ++i)
+    {
+        const auto& c = getCenter(items[i]);
+        mini = asdx::Vector3::Min(mini, c);
+        maxi = asdx::Vector3::Max(maxi, c);
+    }
+
+    const auto extent = maxi - mini;
+    int axis = 0;
+    if (extent.y > extent.x && extent.y >= extent.z) { axis = 1; }
+    else if (extent.z > extent.x && extent.z > extent.y) { axis = 2; }
+
+    std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+        [&](uint32_t lhs, uint32_t rhs) {
+            const auto& a = getCenter(lhs);
+            const auto& b = getCenter(rhs);
+            return (axis == 0) ? a.x < b.x : (axis == 1) ? a.y < b.y : a.z < b.z;
+        });
+
+    return mid;
+}
+
+//-----------------------------------------------------------------------------
+//      範囲を空間的に指定数まで分割します.
+//-----------------------------------------------------------------------------
+template<typename GetCenter>
+void SplitRange
+(
+    std::vector<uint32_t>&                  items,
+    size_t                                  begin,
+    size_t                                  end,
+    uint32_t                                parts,
+    GetCenter                               getCenter,
+    std::vector<std::pair<size_t, size_t>>& ranges
+)
+{
+    const auto count = end - begin;
+    if (parts <= 1 || count <= 1)
+    {
+        ranges.emplace_back(begin, end);
+        return;
+    }
+
+    const auto half = parts / 2;
+    const auto mid  = SplitMedian(items, begin, end, begin + count * half / parts, getCenter);
+    SplitRange(items, begin, mid, half,         getCenter, ranges);
+    SplitRange(items, mid,   end, parts - half, getCenter, ranges);
+}
+
+//-----------------------------------------------------------------------------
+//      葉ノードを生成します.
+//-----------------------------------------------------------------------------
+uint32_t CreateBvhLeaf
+(
+    const std::vector<LodMeshletInfo>&  meshlets,
+    const uint32_t*                     pIndices,
+    size_t                              count,
+    std::vector<BvhBuildNode>&          nodes
+)
+{
+    BvhBuildNode leaf;
+    leaf.Node        = EmptyNode();
+    leaf.Node.IsLeaf = 1;
+    leaf.Center      = asdx::Vector3(0.0f, 0.0f, 0.0f);
+    leaf.Children.assign(pIndices, pIndices + count);
+
+    for(size_t i=0; i<count; ++i)
+    {
+        const auto& meshlet = meshlets[pIndices[i]];
+
+        ResLodBvhNode node = {};
+        node.GroupBounds    = meshlet.GroupBounds;
+        node.ParentBounds   = meshlet.ParentBounds;
+        node.MinGroupError  = meshlet.GroupError;
+        node.MaxParentError = meshlet.ParentError;
+        MergeNode(leaf.Node, node);
+
+        leaf.Center += asdx::Vector3(meshlet.BoundingSphere.x, meshlet.BoundingSphere.y, meshlet.BoundingSphere.z);
+    }
+    leaf.Center /= float(count);
+
+    nodes.emplace_back(std::move(leaf));
+    return uint32_t(nodes.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      指定ノード群を子に持つ部分木を構築します.
+//-----------------------------------------------------------------------------
+uint32_t BuildBvhSubtree(std::vector<uint32_t>& items, size_t begin, size_t end, std::vector<BvhBuildNode>& nodes)
+{
+    const auto count = end - begin;
+    if (count == 1)
+    { return items[begin]; }
+
+    std::vector<uint32_t> children;
+    if (count <= kBvhWidth)
+    {
+        children.assign(items.begin() + begin, items.begin() + end);
+    }
+    else
+    {
+        auto getCenter = [&](uint32_t index) -> const asdx::Vector3& { return nodes[index].Center; };
+
+        std::vector<std::pair<size_t, size_t>> ranges;
+        SplitRange(items, begin, end, kBvhWidth, getCenter, ranges);
+
+        for(const auto& range : ranges)
+        { children.push_back(BuildBvhSubtree(items, range.first, range.second, nodes)); }
+    }
+
+    BvhBuildNode node;
+    node.Node   = EmptyNode();
+    node.Center = asdx::Vector3(0.0f, 0.0f, 0.0f);
+    for(auto child : children)
+    {
+        MergeNode(node.Node, nodes[child].Node);
+        node.Center += nodes[child].Center;
+    }
+    node.Center  /= float(children.size());
+    node.Children = std::move(children);
+
+    nodes.emplace_back(std::move(node));
+    return uint32_t(nodes.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      誤差をスクリーン上に投影します.
+//-----------------------------------------------------------------------------
+inline float ProjectError(float distanceSq, float error, float screenScaleY)
+{
+    if (std::isinf(error))
+        return error;
+
+    const auto d2 = distanceSq - error * error;
+    if (d2 <= 0.0f)
+        return std::numeric_limits<float>::infinity();
+
+    return screenScaleY * error / sqrtf(d2);
+}
+
+//-----------------------------------------------------------------------------
+//      変換行列の最大スケールを求めます.
+//-----------------------------------------------------------------------------
+float GetMaxScale(const asdx::Matrix& transform)
+{
+    const auto xAxis = asdx::Vector3(transform._11, transform._12, transform._13);
+    const auto yAxis = asdx::Vector3(transform._21, transform._22, transform._23);
+    const auto zAxis = asdx::Vector3(transform._31, transform._32, transform._33);
+    return sqrtf(asdx::Max(xAxis.LengthSq(), asdx::Max(yAxis.LengthSq(), zAxis.LengthSq())));
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュレットがLODカットに含まれるかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsVisibleLod(const LodMeshletInfo& meshlet, const LodSelectParam& param)
+{
+    // MEMO : AutoLodMeshletAS.hlsl の IsVisibleLod() と同じ判定.
+    const auto group  = asdx::Vector3::Transform(asdx::Vector3(meshlet.GroupBounds.x,  meshlet.GroupBounds.y,  meshlet.GroupBounds.z),  param.LocalToView);
+    const auto parent = asdx::Vector3::Transform(asdx::Vector3(meshlet.ParentBounds.x, meshlet.ParentBounds.y, meshlet.ParentBounds.z), param.LocalToView);
+
+    const auto groupError  = ProjectError(group .LengthSq(), asdx::Max(meshlet.GroupError,  1e-9f), param.ScreenScaleY);
+    const auto parentError = ProjectError(parent.LengthSq(), asdx::Max(meshlet.ParentError, 1e-9f), param.ScreenScaleY);
+
+    return groupError <= param.ErrorThreshold && param.ErrorThreshold < parentError;
+}
+
+//-----------------------------------------------------------------------------
+//      ノード以下にLODカットに含まれるメッシュレットが存在しうるかチェックします.
+//-----------------------------------------------------------------------------
+bool IsVisibleLod(const ResLodBvhNode& node, const LodSelectParam& param, float scale)
+{
+    // 子孫の親誤差の投影値の上限. スフィア上の最も近い点で評価する.
+    if (!std::isinf(node.MaxParentError))
+    {
+        const auto center = asdx::Vector3::Transform(asdx::Vector3(node.ParentBounds.x, node.ParentBounds.y, node.ParentBounds.z), param.LocalToView);
+        const auto d      = asdx::Max(center.Length() - node.ParentBounds.w * scale, 0.0f);
+        const auto error  = ProjectError(d * d, asdx::Max(node.MaxParentError, 1e-9f), param.ScreenScaleY);
+
+        // 親の誤差が許容範囲であれば，子孫はすべて親側で描画される.
+        if (error <= param.ErrorThreshold)
+            return false;
+    }
+
+    // 子孫のグループ誤差の投影値の下限. スフィア上の最も遠い点で評価する.
+    {
+        const auto center = asdx::Vector3::Transform(asdx::Vector3(node.GroupBounds.x, node.GroupBounds.y, node.GroupBounds.z), param.LocalToView);
+        const auto d      = center.Length() + node.GroupBounds.w * scale;
+        const auto error  = param.ScreenScaleY * asdx::Max(node.MinGroupError, 1e-9f) / asdx::Max(d, 1e-9f);
+
+        // 最も粗くない子孫でも誤差が大きすぎれば，子孫はすべて子側で描画される.
+        if (error > param.ErrorThreshold)
+            return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      サブセット毎にLODメッシュレットを生成します.
+//-----------------------------------------------------------------------------
+uint32_t CreatePerSubsetLods
+(
+    const ResMeshlets&  meshlets,
+    ResLodMeshlets&     lodMesh,
+    LodCacheMap&        prevEntries,
+    LodBakeCache*       pCache
+)
+{
+    // サブセットごとにLODメッシュレットに変換.
+    std::vector<SubsetMeshlets> subsets;
+    Conversion(meshlets, subsets);
+
+    // サブセットのメモリを確保.
+    lodMesh.Subsets.resize(subsets.size());
+
+    uint32_t maxLodLevel = 0;
+
+    // マテリアルごとに処理.
+    for(size_t i=0; i<subsets.size(); ++i)
+    {
+        // 入力データ.
+        std::vector<LodMeshletInfo> input = std::move(subsets[i].Meshlets);
+
+        // LOD範囲.
+        ResLodRange range = {};
+        range.Offset = uint32_t(lodMesh.Meshlets.size());
+        range.Count  = uint32_t(input.size());
+
+        // マテリアルごとの全LODを含むメッシュレット総数のカウンター.
+        uint32_t totalMeshletCount = uint32_t(input.size());
+        
+        lodMesh.Subsets[i].MaterialId       = subsets[i].MaterialId;
+        lodMesh.Subsets[i].MeshletOffset    = range.Offset;
+        lodMesh.Subsets[i].LodRangeOffset   = uint32_t(lodMesh.LodRanges.size());
+        lodMesh.LodRanges.emplace_back(range);
+
+        // メッシュレットを追加.
+        add_range(lodMesh.Meshlets, input);
+
+        // LODレベル.
+        uint32_t lodIndex = 1;
+
+        // 指定数に達するまでループ.
+        while(input.size() > 1 && lodIndex < (kMaxLodLevels - 1))
+        {
+            // 接続性に基づいてメッシュレットをグループ化.
+            auto groups = GroupMeshlets(input);
+
+            bool isMerged = false;
+            std::vector<LodMeshletInfo> simplifies;
+            for(const auto& group : groups)
+            {
+                float parentError = 0;
+                for(auto id : group.MeshletIds)
+                {
+                    const auto& meshlet = input[id];
+                    parentError = asdx::Max(parentError, meshlet.GroupError);
+                }
+
+                // ポリゴン削減して，新しくメッシュレットに分割.
+                LodCacheEntry baked;
+                BakeGroup(group, input, meshlets, lodIndex, LOD_GROUPING_PER_SUBSET, subsets[i].MaterialId, parentError, prevEntries, pCache, baked);
+
+                // マージされていなければ以降の処理はスキップ.
+                if (!baked.IsMerged)
+                    continue;
+
+                const auto groupError = baked.Error + parentError;
+                for(auto& id : group.MeshletIds)
+                {
+                    // 1つ前のLOD(=入力データinput)が今新しく作ったメッシュレットの親になる.
+                    const auto offset = lodMesh.LodRanges.back().Offset;
+                    auto& parent = lodMesh.Meshlets[offset + id];
+                    parent.ParentError  = groupError;
+                    parent.ParentBounds = baked.BoundingSphere;
+                }
+
+                // 新しいメッシュレットを追加.
+                add_range(simplifies, baked.Meshlets);
+
+                // マージした.
+                isMerged = true;
+            }
+
+            // 1回もマージされなければおしまい.
+            if (!isMerged)
+                break;
+
+            // 新しいメッシュレットに差し替える.
+            input = std::move(simplifies);
+
+            // LOD範囲を設定.
+            range.Offset = uint32_t(lodMesh.Meshlets.size());
+            range.Count  = uint32_t(input.size());
+            lodMesh.LodRanges.emplace_back(range);
+
+            totalMeshletCount += range.Count;
+
+            // LODレベルをカウントアップ.
+            lodIndex++;
+
+            add_range(lodMesh.Meshlets, input);
+        }
+
+        // 総数を記録.
+        lodMesh.Subsets[i].MeshletCount  = totalMeshletCount;
+        lodMesh.Subsets[i].LodRangeCount = lodIndex;
+
+        maxLodLevel = asdx::Max(maxLodLevel, lodIndex);
+    }
+
+    return maxLodLevel;
+}
+
+//-----------------------------------------------------------------------------
+//      マテリアル境界を跨いでLODメッシュレットを生成します.
+//-----------------------------------------------------------------------------
+uint32_t CreateCrossSubsetLods
+(
+    const ResMeshlets&  meshlets,
+    ResLodMeshlets&     lodMesh,
+    LodCacheMap&        prevEntries,
+    LodBakeCache*       pCache
+)
+{
+    // 全サブセットをまとめて変換.
+    std::vector<LodMeshletInfo> input;
+    Conversion(meshlets, input);
+
+    // 位置座標のみで頂点を溶接して，マテリアル境界を跨いだ接続性を求める.
+    std::vector<uint32_t> weldRemap(meshlets.Positions.size());
+    meshopt_generateVertexRemap(
+        weldRemap.data(), nullptr, meshlets.Positions.size(),
+        meshlets.Positions.data(), meshlets.Positions.size(), sizeof(asdx::Vector3));
+
+    // LODレベル毎のメッシュレット.
+    std::vector<std::vector<LodMeshletInfo>> levels;
+    levels.emplace_back(input);
+
+    // LODレベル.
+    uint32_t lodIndex = 1;
+
+    // 指定数に達するまでループ.
+    while(input.size() > 1 && lodIndex < (kMaxLodLevels - 1))
+    {
+        // 接続性に基づいてメッシュレットをグループ化.
+        auto groups = GroupMeshlets(input, &weldRemap);
+
+        bool isMerged = false;
+        std::vector<LodMeshletInfo> simplifies;
+        for(const auto& group : groups)
+        {
+            float parentError = 0;
+            for(auto id : group.MeshletIds)
+            {
+                const auto& meshlet = input[id];
+                parentError = asdx::Max(parentError, meshlet.GroupError);
+            }
+
+            // ポリゴン削減して，マテリアル毎に新しくメッシュレットに分割.
+            LodCacheEntry baked;
+            BakeGroup(group, input, meshlets, lodIndex, LOD_GROUPING_CROSS_SUBSET, 0, parentError, prevEntries, pCache, baked);
+
+            // マージされていなければ以降の処理はスキップ.
+            if (!baked.IsMerged)
+                continue;
+
+            const auto groupError = baked.Error + parentError;
+            for(auto& id : group.MeshletIds)
+            {
+                auto& parent = levels.back()[id];
+                parent.ParentError  = groupError;
+                parent.ParentBounds = baked.BoundingSphere;
+            }
+
+            // 新しいメッシュレットを追加.
+            add_range(simplifies, baked.Meshlets);
+
+            // マージした.
+            isMerged = true;
+        }
+
+        // 1回もマージされなければおしまい.
+        if (!isMerged)
+            break;
+
+        // 新しいメッシュレットに差し替える.
+        input = std::move(simplifies);
+        levels.emplace_back(input);
+
+        // LODレベルをカウントアップ.
+        lodIndex++;
+    }
+
+    // マテリアル毎に並べ直す. 親子関係はメッシュレット自身が持っているので順序を変えても問題ない.
+    std::vector<uint32_t> materialIds;
+    for(const auto& subset : meshlets.Subsets)
+    {
+        if (std::find(materialIds.begin(), materialIds.end(), subset.MaterialId) == materialIds.end())
+        { materialIds.push_back(subset.MaterialId); }
+    }
+
+    lodMesh.Subsets.resize(materialIds.size());
+
+    for(size_t i=0; i<materialIds.size(); ++i)
+    {
+        auto& subset = lodMesh.Subsets[i];
+        subset.MaterialId       = materialIds[i];
+        subset.MeshletOffset    = uint32_t(lodMesh.Meshlets.size());
+        subset.LodRangeOffset   = uint32_t(lodMesh.LodRanges.size());
+        subset.LodRangeCount    = uint32_t(levels.size());
+
+        for(auto& level : levels)
+        {
+            ResLodRange range = {};
+            range.Offset = uint32_t(lodMesh.Meshlets.size());
+
+            for(auto& meshlet : level)
+            {
+                if (meshlet.MaterialId == materialIds[i])
+                { lodMesh.Meshlets.emplace_back(std::move(meshlet)); }
+            }
+
+            range.Count = uint32_t(lodMesh.Meshlets.size()) - range.Offset;
+            lodMesh.LodRanges.emplace_back(range);
+        }
+
+        subset.MeshletCount = uint32_t(lodMesh.Meshlets.size()) - subset.MeshletOffset;
+    }
+
+    return lodIndex;
+}
+
+//-----------------------------------------------------------------------------
+//      配列を圧縮して書き込みます.
+//-----------------------------------------------------------------------------
+template<typename T>
+bool WriteEncodedStream(FILE* fp, const std::vector<T>& values)
+{
+    // meshopt_encodeVertexBuffer() の制約.
+    static_assert(sizeof(T) % 4 == 0 && sizeof(T) <= 256, "Invalid Element Size.");
+
+    uint64_t size = 0;
+    if (values.empty())
+    {
+        fwrite(&size, sizeof(size), 1, fp);
+        return true;
+    }
+
+    std::vector<uint8_t> buffer(meshopt_encodeVertexBufferBound(values.size(), sizeof(T)));
+    size = meshopt_encodeVertexBuffer(buffer.data(), buffer.size(), values.data(), values.size(), sizeof(T));
+    if (size == 0)
+        return false;
+
+    fwrite(&size, sizeof(size), 1, fp);
+    fwrite(buffer.data(), 1, size_t(size), fp);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      圧縮された配列を読み込みます. 要素数は事前に設定しておきます.
+//-----------------------------------------------------------------------------
+template<typename T>
+bool ReadEncodedStream(FILE* fp, std::vector<T>& values)
+{
+    uint64_t size = 0;
+    if (fread(&size, sizeof(size), 1, fp) != 1)
+        return false;
+
+    if (values.empty())
+        return (size == 0);
+
+    std::vector<uint8_t> buffer(static_cast<size_t>(size));
+    if (fread(buffer.data(), 1, buffer.size(), fp) != buffer.size())
+        return false;
+
+    return meshopt_decodeVertexBuffer(values.data(), values.size(), sizeof(T), buffer.data(), buffer.size()) == 0;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      LODメッシュレットを生成します.
+//-----------------------------------------------------------------------------
+bool CreateLodMeshlets
+(
+    const ResMeshlets&  meshlets,
+    ResLodMeshlets&     lodMesh,
+    LOD_GROUPING_MODE   mode,
+    LodBakeCache*       pCache
+)
+{
+    // 前回の結果を退避し，今回参照したものだけをキャッシュに残す.
+    LodCacheMap prevEntries;
+    if (pCache != nullptr)
+    {
+        prevEntries = std::move(pCache->Entries);
+        pCache->Entries.clear();
+        pCache->HitCount  = 0;
+        pCache->MissCount = 0;
+    }
+
+    uint32_t maxLodLevel = (mode == LOD_GROUPING_CROSS_SUBSET)
+        ? CreateCrossSubsetLods(meshlets, lodMesh, prevEntries, pCache)
+        : CreatePerSubsetLods(meshlets, lodMesh, prevEntries, pCache);
+
+    if (pCache != nullptr)
+    { ILOGA("Info : LOD Bake Cache : %u hits, %u misses.", pCache->HitCount, pCache->MissCount); }
+
+    lodMesh.Positions       = meshlets.Positions;
+    lodMesh.Normals         = meshlets.Normals;
     lodMesh.Tangents        = meshlets.Tangents;
     lodMesh.TexCoords       = meshlets.TexCoords;
     lodMesh.BoundingSphere  = meshlets.BoundingSphere;
@@ -934,6 +1837,570 @@ bool CreateLodMeshlets(const ResMeshlets& meshlets, ResLodMeshlets& lodMesh)
 
     lodMesh.LodRanges.shrink_to_fit();
 
+    // LOD選択用のBVHを構築.
+    if (!BuildLodBvh(lodMesh))
+    {
+        ELOGA("Error : BuildLodBvh() Failed.");
+        return false;
+    }
+
+    // LODレベル毎の三角形数を出力.
+    {
+        std::vector<uint32_t> counts;
+        GetLodTriangleCounts(lodMesh, counts);
+        for(size_t i=0; i<counts.size(); ++i)
+        { ILOGA("Info : LOD %zu : %u triangles.", i, counts[i]); }
+    }
+
     // 正常終了.
     return true;
 }
+
+//-----------------------------------------------------------------------------
+//      LODレベル毎の三角形数を取得します.
+//-----------------------------------------------------------------------------
+void GetLodTriangleCounts(const ResLodMeshlets& lodMesh, std::vector<uint32_t>& counts)
+{
+    counts.clear();
+    counts.resize(lodMesh.MaxLodLevel, 0);
+
+    for(const auto& meshlet : lodMesh.Meshlets)
+    {
+        if (meshlet.Lod >= counts.size())
+        { counts.resize(meshlet.Lod + 1, 0); }
+
+        counts[meshlet.Lod] += uint32_t(meshlet.Primitives.size());
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ベイクキャッシュを保存します.
+//-----------------------------------------------------------------------------
+bool SaveLodBakeCache(const char* path, const LodBakeCache& cache)
+{
+    FILE* fp = nullptr;
+    auto err = fopen_s(&fp, path, "wb");
+    if (err != 0)
+    {
+        ELOGA("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    LodBakeCacheHeader header = {};
+    strcpy_s(header.Magic, "LDC");
+    header.Version    = kLodBakeCacheVersion;
+    header.EntryCount = cache.Entries.size();
+    fwrite(&header, sizeof(header), 1, fp);
+
+    for(const auto& pair : cache.Entries)
+    {
+        const auto& entry = pair.second;
+
+        LodCacheEntryHeader entryHeader = {};
+        entryHeader.Hash            = pair.first;
+        entryHeader.BoundingSphere  = entry.BoundingSphere;
+        entryHeader.Error           = entry.Error;
+        entryHeader.IsMerged        = entry.IsMerged;
+        entryHeader.MeshletCount    = uint32_t(entry.Meshlets.size());
+        fwrite(&entryHeader, sizeof(entryHeader), 1, fp);
+
+        for(const auto& meshlet : entry.Meshlets)
+        {
+            LodCacheMeshletHeader meshletHeader = {};
+            meshletHeader.NormalCone        = meshlet.NormalCone;
+            meshletHeader.BoundingSphere    = meshlet.BoundingSphere;
+            meshletHeader.MaterialId        = meshlet.MaterialId;
+            meshletHeader.Lod               = meshlet.Lod;
+            meshletHeader.ParentError       = meshlet.ParentError;
+            meshletHeader.GroupError        = meshlet.GroupError;
+            meshletHeader.ParentBounds      = meshlet.ParentBounds;
+            meshletHeader.GroupBounds       = meshlet.GroupBounds;
+            meshletHeader.PrimitiveCount    = uint32_t(meshlet.Primitives .size());
+            meshletHeader.VertexCount       = uint32_t(meshlet.VertIndices.size());
+            fwrite(&meshletHeader, sizeof(meshletHeader), 1, fp);
+
+            if (!meshlet.Primitives .empty()) { fwrite(meshlet.Primitives .data(), sizeof(meshlet.Primitives [0]), meshlet.Primitives .size(), fp); }
+            if (!meshlet.VertIndices.empty()) { fwrite(meshlet.VertIndices.data(), sizeof(meshlet.VertIndices[0]), meshlet.VertIndices.size(), fp); }
+        }
+    }
+
+    fclose(fp);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ベイクキャッシュを読み込みします.
+//-----------------------------------------------------------------------------
+bool LoadLodBakeCache(const char* path, LodBakeCache& cache)
+{
+    cache.Entries.clear();
+    cache.HitCount  = 0;
+    cache.MissCount = 0;
+
+    FILE* fp = nullptr;
+    auto err = fopen_s(&fp, path, "rb");
+    if (err != 0)
+    {
+        ELOGA("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    LodBakeCacheHeader header = {};
+    if (fread(&header, sizeof(header), 1, fp) != 1 || strcmp(header.Magic, "LDC") != 0)
+    {
+        fclose(fp);
+        ELOGA("Error : Invalid File. path = %s", path);
+        return false;
+    }
+
+    // 削減処理が変わっている可能性があるので，バージョン違いは使わない.
+    if (header.Version != kLodBakeCacheVersion)
+    {
+        fclose(fp);
+        ELOGA("Error : Invalid Version. File Version = %u, Current Version = %u", header.Version, kLodBakeCacheVersion);
+        return false;
+    }
+
+    cache.Entries.reserve(size_t(header.EntryCount));
+
+    for(uint64_t i=0; i<header.EntryCount; ++i)
+    {
+        LodCacheEntryHeader entryHeader = {};
+        if (fread(&entryHeader, sizeof(entryHeader), 1, fp) != 1)
+        {
+            fclose(fp);
+            cache.Entries.clear();
+            ELOGA("Error : Unexpected End Of File. path = %s", path);
+            return false;
+        }
+
+        LodCacheEntry entry;
+        entry.BoundingSphere = entryHeader.BoundingSphere;
+        entry.Error          = entryHeader.Error;
+        entry.IsMerged       = entryHeader.IsMerged;
+        entry.Meshlets.resize(entryHeader.MeshletCount);
+
+        for(auto& meshlet : entry.Meshlets)
+        {
+            LodCacheMeshletHeader meshletHeader = {};
+            auto valid = (fread(&meshletHeader, sizeof(meshletHeader), 1, fp) == 1);
+            if (valid)
+            {
+                meshlet.NormalCone      = meshletHeader.NormalCone;
+                meshlet.BoundingSphere  = meshletHeader.BoundingSphere;
+                meshlet.MaterialId      = meshletHeader.MaterialId;
+                meshlet.Lod             = meshletHeader.Lod;
+                meshlet.ParentError     = meshletHeader.ParentError;
+                meshlet.GroupError      = meshletHeader.GroupError;
+                meshlet.ParentBounds    = meshletHeader.ParentBounds;
+                meshlet.GroupBounds     = meshletHeader.GroupBounds;
+
+                meshlet.Primitives .resize(meshletHeader.PrimitiveCount);
+                meshlet.VertIndices.resize(meshletHeader.VertexCount);
+
+                if (!meshlet.Primitives .empty()) { valid &= (fread(meshlet.Primitives .data(), sizeof(meshlet.Primitives [0]), meshlet.Primitives .size(), fp) == meshlet.Primitives .size()); }
+                if (!meshlet.VertIndices.empty()) { valid &= (fread(meshlet.VertIndices.data(), sizeof(meshlet.VertIndices[0]), meshlet.VertIndices.size(), fp) == meshlet.VertIndices.size()); }
+            }
+
+            if (!valid)
+            {
+                fclose(fp);
+                cache.Entries.clear();
+                ELOGA("Error : Unexpected End Of File. path = %s", path);
+                return false;
+            }
+        }
+
+        cache.Entries.emplace(entryHeader.Hash, std::move(entry));
+    }
+
+    fclose(fp);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      LODメッシュレットを保存します.
+//-----------------------------------------------------------------------------
+bool SaveLodMeshlets(const char* path, const ResLodMeshlets& lodMesh)
+{
+    // メッシュレットを固定長レコードと可変長配列に分ける.
+    std::vector<LodMeshletRecord>   records(lodMesh.Meshlets.size());
+    std::vector<uint32_t>           vertIndices;
+    std::vector<uint32_t>           primitives;     // 8bit x 3 を 32bit に詰める.
+
+    for(size_t i=0; i<lodMesh.Meshlets.size(); ++i)
+    {
+        const auto& src = lodMesh.Meshlets[i];
+        auto& dst = records[i];
+
+        dst.NormalCone      = src.NormalCone;
+        dst.BoundingSphere  = src.BoundingSphere;
+        dst.MaterialId      = src.MaterialId;
+        dst.Lod             = src.Lod;
+        dst.ParentError     = src.ParentError;
+        dst.GroupError      = src.GroupError;
+        dst.ParentBounds    = src.ParentBounds;
+        dst.GroupBounds     = src.GroupBounds;
+        dst.VertIndexOffset = uint32_t(vertIndices.size());
+        dst.VertIndexCount  = uint32_t(src.VertIndices.size());
+        dst.PrimitiveOffset = uint32_t(primitives.size());
+        dst.PrimitiveCount  = uint32_t(src.Primitives.size());
+
+        vertIndices.insert(vertIndices.end(), src.VertIndices.begin(), src.VertIndices.end());
+        for(const auto& prim : src.Primitives)
+        { primitives.push_back(uint32_t(prim.x) | (uint32_t(prim.y) << 8) | (uint32_t(prim.z) << 16)); }
+    }
+
+    ResLodMeshletsHeader header = {};
+    strcpy_s(header.Magic, "LDM");
+    header.Version              = kLodMeshletsVersion;
+    header.PositionCount        = lodMesh.Positions.size();
+    header.NormalCount          = lodMesh.Normals  .size();
+    header.TangentCount         = lodMesh.Tangents .size();
+    header.TexCoordCount        = lodMesh.TexCoords.size();
+    header.MeshletCount         = records    .size();
+    header.VertIndexCount       = vertIndices.size();
+    header.PrimitiveCount       = primitives .size();
+    header.SubsetCount          = lodMesh.Subsets  .size();
+    header.LodRangeCount        = lodMesh.LodRanges.size();
+    header.BvhNodeCount         = lodMesh.BvhNodes .size();
+    header.BvhMeshletIndexCount = lodMesh.BvhMeshletIndices.size();
+    header.BoundingSphere       = lodMesh.BoundingSphere;
+    header.MaxLodLevel          = lodMesh.MaxLodLevel;
+
+    FILE* fp = nullptr;
+    auto err = fopen_s(&fp, path, "wb");
+    if (err != 0)
+    {
+        ELOGA("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    fwrite(&header, sizeof(header), 1, fp);
+
+    auto ret = WriteEncodedStream(fp, lodMesh.Positions)
+            && WriteEncodedStream(fp, lodMesh.Normals)
+            && WriteEncodedStream(fp, lodMesh.Tangents)
+            && WriteEncodedStream(fp, lodMesh.TexCoords)
+            && WriteEncodedStream(fp, records)
+            && WriteEncodedStream(fp, vertIndices)
+            && WriteEncodedStream(fp, primitives)
+            && WriteEncodedStream(fp, lodMesh.Subsets)
+            && WriteEncodedStream(fp, lodMesh.LodRanges)
+            && WriteEncodedStream(fp, lodMesh.BvhNodes)
+            && WriteEncodedStream(fp, lodMesh.BvhMeshletIndices);
+
+    fclose(fp);
+
+    if (!ret)
+    {
+        ELOGA("Error : Encode Failed. path = %s", path);
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      LODメッシュレットを読み込みします.
+//-----------------------------------------------------------------------------
+bool LoadLodMeshlets(const char* path, ResLodMeshlets& lodMesh)
+{
+    FILE* fp = nullptr;
+    auto err = fopen_s(&fp, path, "rb");
+    if (err != 0)
+    {
+        ELOGA("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    ResLodMeshletsHeader header = {};
+    if (fread(&header, sizeof(header), 1, fp) != 1 || strcmp(header.Magic, "LDM") != 0)
+    {
+        fclose(fp);
+        ELOGA("Error : Invalid File. path = %s", path);
+        return false;
+    }
+
+    if (header.Version != kLodMeshletsVersion)
+    {
+        fclose(fp);
+        ELOGA("Error : Invalid Version. File Version = %u, Current Version = %u", header.Version, kLodMeshletsVersion);
+        return false;
+    }
+
+    std::vector<LodMeshletRecord>   records    (size_t(header.MeshletCount));
+    std::vector<uint32_t>           vertIndices(size_t(header.VertIndexCount));
+    std::vector<uint32_t>           primitives (size_t(header.PrimitiveCount));
+
+    lodMesh.Positions        .resize(size_t(header.PositionCount));
+    lodMesh.Normals          .resize(size_t(header.NormalCount));
+    lodMesh.Tangents         .resize(size_t(header.TangentCount));
+    lodMesh.TexCoords        .resize(size_t(header.TexCoordCount));
+    lodMesh.Subsets          .resize(size_t(header.SubsetCount));
+    lodMesh.LodRanges        .resize(size_t(header.LodRangeCount));
+    lodMesh.BvhNodes         .resize(size_t(header.BvhNodeCount));
+    lodMesh.BvhMeshletIndices.resize(size_t(header.BvhMeshletIndexCount));
+    lodMesh.BoundingSphere = header.BoundingSphere;
+    lodMesh.MaxLodLevel    = header.MaxLodLevel;
+
+    auto ret = ReadEncodedStream(fp, lodMesh.Positions)
+            && ReadEncodedStream(fp, lodMesh.Normals)
+            && ReadEncodedStream(fp, lodMesh.Tangents)
+            && ReadEncodedStream(fp, lodMesh.TexCoords)
+            && ReadEncodedStream(fp, records)
+            && ReadEncodedStream(fp, vertIndices)
+            && ReadEncodedStream(fp, primitives)
+            && ReadEncodedStream(fp, lodMesh.Subsets)
+            && ReadEncodedStream(fp, lodMesh.LodRanges)
+            && ReadEncodedStream(fp, lodMesh.BvhNodes)
+            && ReadEncodedStream(fp, lodMesh.BvhMeshletIndices);
+
+    fclose(fp);
+
+    if (!ret)
+    {
+        ELOGA("Error : Decode Failed. path = %s", path);
+        return false;
+    }
+
+    // メッシュレットを復元.
+    lodMesh.Meshlets.resize(records.size());
+    for(size_t i=0; i<records.size(); ++i)
+    {
+        const auto& src = records[i];
+        auto& dst = lodMesh.Meshlets[i];
+
+        if (uint64_t(src.VertIndexOffset) + src.VertIndexCount > vertIndices.size()
+         || uint64_t(src.PrimitiveOffset) + src.PrimitiveCount > primitives .size())
+        {
+            ELOGA("Error : Invalid Meshlet. path = %s, index = %zu", path, i);
+            return false;
+        }
+
+        dst.NormalCone      = src.NormalCone;
+        dst.BoundingSphere  = src.BoundingSphere;
+        dst.MaterialId      = src.MaterialId;
+        dst.Lod             = src.Lod;
+        dst.ParentError     = src.ParentError;
+        dst.GroupError      = src.GroupError;
+        dst.ParentBounds    = src.ParentBounds;
+        dst.GroupBounds     = src.GroupBounds;
+
+        dst.VertIndices.assign(
+            vertIndices.begin() + src.VertIndexOffset,
+            vertIndices.begin() + src.VertIndexOffset + src.VertIndexCount);
+
+        dst.Primitives.resize(src.PrimitiveCount);
+        for(auto j=0u; j<src.PrimitiveCount; ++j)
+        {
+            auto packed = primitives[src.PrimitiveOffset + j];
+            dst.Primitives[j].x = uint8_t( packed        & 0xff);
+            dst.Primitives[j].y = uint8_t((packed >>  8) & 0xff);
+            dst.Primitives[j].z = uint8_t((packed >> 16) & 0xff);
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      LOD選択用のBVHを構築します.
+//-----------------------------------------------------------------------------
+bool BuildLodBvh(ResLodMeshlets& lodMesh)
+{
+    lodMesh.BvhNodes.clear();
+    lodMesh.BvhMeshletIndices.clear();
+
+    if (lodMesh.Meshlets.empty())
+        return false;
+
+    // 同一LODレベル・同一グループのメッシュレットを束ねる.
+    // グループは BuildMeshlets() で同じ GroupBounds/GroupError を与えられている.
+    std::vector<std::vector<std::vector<uint32_t>>> levels;
+    {
+        std::vector<std::unordered_map<size_t, std::vector<uint32_t>>> groups;
+        for(size_t i=0; i<lodMesh.Meshlets.size(); ++i)
+        {
+            const auto& meshlet = lodMesh.Meshlets[i];
+            if (groups.size() <= meshlet.Lod)
+            { groups.resize(meshlet.Lod + 1); }
+
+            const auto hasher = std::hash<float>{};
+            auto key = hasher(meshlet.GroupBounds.x);
+            key = key * 31 + hasher(meshlet.GroupBounds.y);
+            key = key * 31 + hasher(meshlet.GroupBounds.z);
+            key = key * 31 + hasher(meshlet.GroupBounds.w);
+            key = key * 31 + hasher(meshlet.GroupError);
+
+            groups[meshlet.Lod][key].push_back(uint32_t(i));
+        }
+
+        levels.resize(groups.size());
+        for(size_t i=0; i<groups.size(); ++i)
+        {
+            for(auto& pair : groups[i])
+            { levels[i].emplace_back(std::move(pair.second)); }
+
+            // 走査順に依存しないように先頭のメッシュレット番号で並べる.
+            std::sort(levels[i].begin(), levels[i].end(),
+                [](const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs) { return lhs[0] < rhs[0]; });
+        }
+    }
+
+    std::vector<BvhBuildNode> nodes;
+    std::vector<uint32_t>     levelRoots;
+
+    auto getMeshletCenter = [&](uint32_t index)
+    {
+        const auto& s = lodMesh.Meshlets[index].BoundingSphere;
+        return asdx::Vector3(s.x, s.y, s.z);
+    };
+
+    // LODレベル毎に部分木を構築. 異なるレベルを混ぜると誤差範囲が広がり枝刈りが効かなくなる.
+    for(auto& level : levels)
+    {
+        if (level.empty())
+            continue;
+
+        std::vector<uint32_t> leaves;
+        for(auto& group : level)
+        {
+            // 大きすぎるグループは空間的に分割する.
+            auto parts = uint32_t((group.size() + kBvhLeafMeshlets - 1) / kBvhLeafMeshlets);
+
+            std::vector<std::pair<size_t, size_t>> ranges;
+            SplitRange(group, 0, group.size(), parts, getMeshletCenter, ranges);
+
+            for(const auto& range : ranges)
+            { leaves.push_back(CreateBvhLeaf(lodMesh.Meshlets, group.data() + range.first, range.second - range.first, nodes)); }
+        }
+
+        levelRoots.push_back(BuildBvhSubtree(leaves, 0, leaves.size(), nodes));
+    }
+
+    auto root = BuildBvhSubtree(levelRoots, 0, levelRoots.size(), nodes);
+
+    // 子ノードが連続するように幅優先で並べ直す.
+    lodMesh.BvhNodes.reserve(nodes.size());
+    lodMesh.BvhMeshletIndices.reserve(lodMesh.Meshlets.size());
+
+    std::vector<uint32_t> order;
+    order.reserve(nodes.size());
+    order.push_back(root);
+    lodMesh.BvhNodes.push_back(nodes[root].Node);
+
+    for(size_t i=0; i<order.size(); ++i)
+    {
+        const auto& src = nodes[order[i]];
+        auto&       dst = lodMesh.BvhNodes[i];
+
+        if (src.Node.IsLeaf)
+        {
+            dst.ChildOffset = uint32_t(lodMesh.BvhMeshletIndices.size());
+            dst.ChildCount  = uint32_t(src.Children.size());
+            lodMesh.BvhMeshletIndices.insert(lodMesh.BvhMeshletIndices.end(), src.Children.begin(), src.Children.end());
+            continue;
+        }
+
+        dst.ChildOffset = uint32_t(lodMesh.BvhNodes.size());
+        dst.ChildCount  = uint32_t(src.Children.size());
+        for(auto child : src.Children)
+        {
+            order.push_back(child);
+            lodMesh.BvhNodes.push_back(nodes[child].Node);
+        }
+    }
+
+    lodMesh.BvhNodes.shrink_to_fit();
+    lodMesh.BvhMeshletIndices.shrink_to_fit();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      BVHを辿ってLODカットとなるメッシュレットを選択します.
+//-----------------------------------------------------------------------------
+void SelectLodMeshlets
+(
+    const ResLodMeshlets&   lodMesh,
+    const LodSelectParam&   param,
+    std::vector<uint32_t>&  result,
+    LodSelectStats*         pStats
+)
+{
+    LodSelectStats stats = {};
+    result.clear();
+
+    if (lodMesh.BvhNodes.empty())
+    {
+        SelectLodMeshletsFlat(lodMesh, param, result, pStats);
+        return;
+    }
+
+    const auto scale = GetMaxScale(param.LocalToView);
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+
+    while(!stack.empty())
+    {
+        const auto& node = lodMesh.BvhNodes[stack.back()];
+        stack.pop_back();
+        stats.VisitedNodes++;
+
+        if (!IsVisibleLod(node, param, scale))
+            continue;
+
+        if (node.IsLeaf)
+        {
+            for(auto i=0u; i<node.ChildCount; ++i)
+            {
+                auto meshletId = lodMesh.BvhMeshletIndices[node.ChildOffset + i];
+                stats.TestedMeshlets++;
+                if (IsVisibleLod(lodMesh.Meshlets[meshletId], param))
+                { result.push_back(meshletId); }
+            }
+            continue;
+        }
+
+        for(auto i=0u; i<node.ChildCount; ++i)
+        { stack.push_back(node.ChildOffset + i); }
+    }
+
+    // 走査順に依存しないように並べる.
+    std::sort(result.begin(), result.end());
+
+    stats.SelectedMeshlets = uint32_t(result.size());
+    if (pStats != nullptr)
+    { *pStats = stats; }
+}
+
+//-----------------------------------------------------------------------------
+//      全メッシュレットを走査してLODカットとなるメッシュレットを選択します.
+//-----------------------------------------------------------------------------
+void SelectLodMeshletsFlat
+(
+    const ResLodMeshlets&   lodMesh,
+    const LodSelectParam&   param,
+    std::vector<uint32_t>&  result,
+    LodSelectStats*         pStats
+)
+{
+    LodSelectStats stats = {};
+    result.clear();
+
+    for(size_t i=0; i<lodMesh.Meshlets.size(); ++i)
+    {
+        stats.TestedMeshlets++;
+        if (IsVisibleLod(lodMesh.Meshlets[i], param))
+        { result.push_back(uint32_t(i)); }
+    }
+
+    stats.SelectedMeshlets = uint32_t(result.size());
+    if (pStats != nullptr)
+    { *pStats = stats; }
+}
@@ -9,6 +9,7 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <cstdint>
+#include <unordered_map>
 #include <Meshlet.h>
 
 
@@ -52,6 +53,20 @@ struct ResLodSubset
     uint32_t    LodRangeCount;  //!< LOD範囲の数(=LOD数).
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// ResLodBvhNode structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResLodBvhNode
+{
+    asdx::Vector4   GroupBounds;    //!< 子孫グループのバウンディングスフィアを包含するスフィア.
+    asdx::Vector4   ParentBounds;   //!< 子孫の親バウンディングスフィアを包含するスフィア.
+    float           MinGroupError;  //!< 子孫グループの誤差尺度の最小値.
+    float           MaxParentError; //!< 子孫の親の誤差尺度の最大値.
+    uint32_t        ChildOffset;    //!< 子ノードへのオフセット(葉の場合はメッシュレット番号リストへのオフセット).
+    uint32_t        ChildCount;     //!< 子ノード数(葉の場合はメッシュレット数).
+    uint32_t        IsLeaf;         //!< 葉ノードであれば1.
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // ResLodMeshlet structure
 ///////////////////////////////////////////////////////////////////////////////
@@ -64,20 +79,163 @@ struct ResLodMeshlets
     std::vector<LodMeshletInfo>     Meshlets;           //!< メッシュレット.
     std::vector<ResLodSubset>       Subsets;            //!< サブセット.
     std::vector<ResLodRange>        LodRanges;          //!< LOD範囲.
+    std::vector<ResLodBvhNode>      BvhNodes;           //!< LOD選択用BVHノード(先頭がルート).
+    std::vector<uint32_t>           BvhMeshletIndices;  //!< BVHの葉ノードが参照するメッシュレット番号.
     asdx::Vector4                   BoundingSphere;     //!< バウンディングスフィア.
     uint32_t                        MaxLodLevel;        //!< 最大LODレベル.
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// LOD_GROUPING_MODE enum
+///////////////////////////////////////////////////////////////////////////////
+enum LOD_GROUPING_MODE
+{
+    LOD_GROUPING_PER_SUBSET = 0,    //!< サブセット(マテリアル)毎にグループ化とポリゴン削減を行います.
+    LOD_GROUPING_CROSS_SUBSET,      //!< マテリアル境界を跨いでグループ化とポリゴン削減を行います.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LodCacheEntry structure
+///////////////////////////////////////////////////////////////////////////////
+struct LodCacheEntry
+{
+    float                       Error;          //!< ポリゴン削減による誤差尺度.
+    asdx::Vector4               BoundingSphere; //!< グループのバウンディングスフィア.
+    uint32_t                    IsMerged;       //!< ポリゴン削減されていれば1.
+    std::vector<LodMeshletInfo> Meshlets;       //!< 生成されたメッシュレット(VertIndices はグループ内のローカル番号).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LodBakeCache structure
+///////////////////////////////////////////////////////////////////////////////
+struct LodBakeCache
+{
+    std::unordered_map<uint64_t, LodCacheEntry> Entries;    //!< グループ入力のハッシュ値からベイク結果への辞書.
+    uint32_t                                    HitCount;   //!< 直前のベイクでキャッシュを再利用したグループ数.
+    uint32_t                                    MissCount;  //!< 直前のベイクで再計算したグループ数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LodSelectParam structure
+///////////////////////////////////////////////////////////////////////////////
+struct LodSelectParam
+{
+    asdx::Matrix    LocalToView;        //!< ローカル空間からビュー空間への変換行列.
+    float           ScreenScaleY;       //!< height * 0.5f * (1.0f / tan(fov * 0.5f)).
+    float           ErrorThreshold;     //!< 許容するピクセル誤差.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LodSelectStats structure
+///////////////////////////////////////////////////////////////////////////////
+struct LodSelectStats
+{
+    uint32_t    VisitedNodes;       //!< 訪問したBVHノード数.
+    uint32_t    TestedMeshlets;     //!< LOD判定を行ったメッシュレット数.
+    uint32_t    SelectedMeshlets;   //!< 選択されたメッシュレット数.
+};
 
 //-----------------------------------------------------------------------------
 //! @brief      LODメッシュレットを生成します.
+//!
+//! @param[in]      meshlets        入力メッシュレットです.
+//! @param[out]     lodMeshlets     LODメッシュレットの格納先です.
+//! @param[in]      mode            グループ化モードです.
+//! @param[in,out]  pCache          ベイクキャッシュです(nullptr可).
+//! @note       LOD_GROUPING_CROSS_SUBSET では三角形毎のマテリアルIDを維持したままマテリアル境界を跨いで削減し，
+//!             結果をマテリアル毎のメッシュレットに分割し直します.
+//! @note       pCache を指定した場合は，入力のハッシュ値が一致するグループの結果を再利用します.
+//!             ベイク後のキャッシュには今回参照したグループのみが残ります.
+//-----------------------------------------------------------------------------
+bool CreateLodMeshlets
+(
+    const ResMeshlets&  meshlets,
+    ResLodMeshlets&     lodMeshlets,
+    LOD_GROUPING_MODE   mode   = LOD_GROUPING_PER_SUBSET,
+    LodBakeCache*       pCache = nullptr
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      ベイクキャッシュを保存します.
+//!
+//! @param[in]      path        ファイルパス.
+//! @param[in]      cache       保存するキャッシュ.
+//! @retval true    保存に成功.
+//! @retval false   保存に失敗.
+//-----------------------------------------------------------------------------
+bool SaveLodBakeCache(const char* path, const LodBakeCache& cache);
+
+//-----------------------------------------------------------------------------
+//! @brief      ベイクキャッシュを読み込みします.
+//!
+//! @param[in]      path        ファイルパス.
+//! @param[out]     cache       読み込み先キャッシュ.
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
+//-----------------------------------------------------------------------------
+bool LoadLodBakeCache(const char* path, LodBakeCache& cache);
+
+//-----------------------------------------------------------------------------
+//! @brief      LODレベル毎の三角形数を取得します.
 //-----------------------------------------------------------------------------
-bool CreateLodMeshlets(const ResMeshlets& meshlets, ResLodMeshlets& lodMeshlets);
+void GetLodTriangleCounts(const ResLodMeshlets& lodMeshlets, std::vector<uint32_t>& counts);
+
+//-----------------------------------------------------------------------------
+//! @brief      LOD選択用のBVHを構築します.
+//!
+//! @note       CreateLodMeshlets() から呼び出されます.
+//-----------------------------------------------------------------------------
+bool BuildLodBvh(ResLodMeshlets& lodMeshlets);
+
+//-----------------------------------------------------------------------------
+//! @brief      BVHを辿ってLODカットとなるメッシュレットを選択します.
+//!
+//! @param[in]      lodMeshlets     LODメッシュレットです.
+//! @param[in]      param           選択パラメータです.
+//! @param[out]     result          選択されたメッシュレット番号の格納先です.
+//! @param[out]     pStats          統計情報の格納先です(nullptr可).
+//-----------------------------------------------------------------------------
+void SelectLodMeshlets
+(
+    const ResLodMeshlets&   lodMeshlets,
+    const LodSelectParam&   param,
+    std::vector<uint32_t>&  result,
+    LodSelectStats*         pStats = nullptr
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      全メッシュレットを走査してLODカットとなるメッシュレットを選択します.
+//!
+//! @note       SelectLodMeshlets() と同じ結果を返す比較用の実装です.
+//-----------------------------------------------------------------------------
+void SelectLodMeshletsFlat
+(
+    const ResLodMeshlets&   lodMeshlets,
+    const LodSelectParam&   param,
+    std::vector<uint32_t>&  result,
+    LodSelectStats*         pStats = nullptr
+);
 
 //-----------------------------------------------------------------------------
 //! @brief      LODメッシュレットを保存します.
+//!
+//! @param[in]      path            ファイルパス.
+//! @param[in]      lodMeshlets     保存するLODメッシュレット.
+//! @retval true    保存に成功.
+//! @retval false   保存に失敗.
+//! @note       各配列は meshopt_encodeVertexBuffer() で圧縮して保存します.
+//-----------------------------------------------------------------------------
+bool SaveLodMeshlets(const char* path, const ResLodMeshlets& lodMeshlets);
+
+//-----------------------------------------------------------------------------
+//! @brief      LODメッシュレットを読み込みします.
+//!
+//! @param[in]      path            ファイルパス.
+//! @param[out]     lodMeshlets     読み込み先LODメッシュレット.
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
 //-----------------------------------------------------------------------------
-//bool SaveLodMeshlets(const char* path, const ResLodMeshlets& lodMeshlets);
+bool LoadLodMeshlets(const char* path, ResLodMeshlets& lodMeshlets);
 
 
 
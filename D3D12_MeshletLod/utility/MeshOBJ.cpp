@@ -13,8 +13,8 @@
 #include <vector>
 #include <algorithm>
 #include <tuple>
+#include "Compat.h"
 #include "MeshOBJ.h"
-#include <fnd/asdxMisc.h>
 #include <fnd/asdxLogger.h>
 #include <meshoptimizer.h>
 
@@ -56,6 +56,20 @@ void Clear(std::vector<T>& val)
     val.shrink_to_fit();
 }
 
+//-----------------------------------------------------------------------------
+//      ファイルパスからディレクトリ名を取得します.
+//-----------------------------------------------------------------------------
+std::string ExtractDirectoryPath(const char* filePath)
+{
+    // MEMO : asdx::GetDirectoryPathA() 相当. ヘッドレスビルドで asdxMisc.cpp に依存しないようにする.
+    std::string path = filePath;
+    auto idx = path.find_last_of("/\\");
+    if (idx != std::string::npos)
+    { return path.substr(0, idx + 1); }
+
+    return std::string();
+}
+
 } // namespace
 
 
@@ -133,7 +147,7 @@ bool MeshOBJ::LoadOBJFile(const char* path)
     std::vector<asdx::Vector2> texcoords;
 
     // ロードディレクトリを取得.
-    m_Directory = asdx::GetDirectoryPathA(path);
+    m_Directory = ExtractDirectoryPath(path);
 
     //　ファイルを開く
     file.open(path, std::ios::in);
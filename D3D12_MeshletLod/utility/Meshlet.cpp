@@ -8,6 +8,9 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <cstdio>
+#include <cfloat>
+#include <algorithm>
+#include "Compat.h"
 #include "Meshlet.h"
 #include "MeshOBJ.h"
 #include <meshoptimizer.h>
@@ -40,6 +43,148 @@ struct ResMeshletsHeader
     asdx::Vector4   BoundingSphere;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// CacheSimulator structure
+///////////////////////////////////////////////////////////////////////////////
+struct CacheSimulator
+{
+    uint32_t                LineSize    = 64;
+    uint32_t                Ways        = 4;
+    uint32_t                SetCount    = 1;
+    std::vector<uint64_t>   Tags;           // セット毎に Ways 個. 先頭ほど最近使われたもの.
+    uint64_t                AccessCount = 0;
+    uint64_t                MissCount   = 0;
+
+    void Init(uint32_t cacheSize, uint32_t lineSize, uint32_t ways)
+    {
+        LineSize    = lineSize;
+        Ways        = ways;
+        SetCount    = std::max(cacheSize / (lineSize * ways), 1u);
+        AccessCount = 0;
+        MissCount   = 0;
+        Tags.assign(size_t(SetCount) * Ways, UINT64_MAX);
+    }
+
+    void Access(uint64_t address, uint32_t size)
+    {
+        auto first = address / LineSize;
+        auto last  = (address + size - 1) / LineSize;
+        for(auto line = first; line <= last; ++line)
+        { Touch(line); }
+    }
+
+    void Touch(uint64_t line)
+    {
+        AccessCount++;
+
+        auto tags = &Tags[size_t(line % SetCount) * Ways];
+
+        auto hit = Ways;
+        for(auto i=0u; i<Ways; ++i)
+        {
+            if (tags[i] == line)
+            {
+                hit = i;
+                break;
+            }
+        }
+
+        // ミスした場合は最も古いものを追い出す.
+        if (hit == Ways)
+        {
+            MissCount++;
+            hit = Ways - 1;
+        }
+
+        for(auto i=hit; i>0; --i)
+        { tags[i] = tags[i - 1]; }
+        tags[0] = line;
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      10bitの値を3bit間隔に展開します.
+//-----------------------------------------------------------------------------
+inline uint32_t Part1By2(uint32_t value)
+{
+    value &= 0x000003ff;
+    value = (value ^ (value << 16)) & 0xff0000ff;
+    value = (value ^ (value <<  8)) & 0x0300f00f;
+    value = (value ^ (value <<  4)) & 0x030c30c3;
+    value = (value ^ (value <<  2)) & 0x09249249;
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+//      3次元のモートン符号を求めます.
+//-----------------------------------------------------------------------------
+inline uint32_t EncodeMorton(uint32_t x, uint32_t y, uint32_t z)
+{ return (Part1By2(x) << 2) | (Part1By2(y) << 1) | Part1By2(z); }
+
+//-----------------------------------------------------------------------------
+//      3次元のヒルベルト符号を求めます.
+//-----------------------------------------------------------------------------
+uint32_t EncodeHilbert(uint32_t x, uint32_t y, uint32_t z)
+{
+    // MEMO : J. Skilling, "Programming the Hilbert curve" (2004) の AxesToTranspose.
+    const uint32_t kBits = 10;
+    uint32_t X[3] = { x, y, z };
+
+    for(uint32_t Q = 1u << (kBits - 1); Q > 1; Q >>= 1)
+    {
+        auto P = Q - 1;
+        for(auto i=0; i<3; ++i)
+        {
+            if (X[i] & Q)
+            { X[0] ^= P; }
+            else
+            {
+                auto t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+
+    // グレイ符号化.
+    X[1] ^= X[0];
+    X[2] ^= X[1];
+
+    uint32_t t = 0;
+    for(uint32_t Q = 1u << (kBits - 1); Q > 1; Q >>= 1)
+    {
+        if (X[2] & Q)
+        { t ^= Q - 1; }
+    }
+
+    for(auto i=0; i<3; ++i)
+    { X[i] ^= t; }
+
+    // 転置形式から1つの値にまとめる.
+    uint32_t result = 0;
+    for(auto b=int(kBits) - 1; b >= 0; --b)
+    {
+        for(auto i=0; i<3; ++i)
+        { result = (result << 1) | ((X[i] >> b) & 0x1); }
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      頂点バッファをリマップします.
+//-----------------------------------------------------------------------------
+template<typename T>
+void RemapStream(std::vector<T>& stream, const std::vector<uint32_t>& remap, size_t vertexCount)
+{
+    if (stream.empty())
+        return;
+
+    std::vector<T> temp(vertexCount);
+    meshopt_remapVertexBuffer(temp.data(), stream.data(), stream.size(), sizeof(T), remap.data());
+    stream = std::move(temp);
+}
+
 } // namespace
 
 
@@ -171,6 +316,20 @@ bool CreateMeshlets(const char* path, ResMeshlets& result)
     result.Meshlets     .shrink_to_fit();
     result.Subsets      .shrink_to_fit();
 
+    // メッシュレットと頂点データの並びを最適化.
+    {
+        auto before = AnalyzeVertexFetch(result);
+
+        if (!OptimizeMeshlets(result))
+        {
+            ELOGA("Error : OptimizeMeshlets() Failed.");
+            return false;
+        }
+
+        auto after = AnalyzeVertexFetch(result);
+        ILOGA("Info : Vertex Fetch Overfetch %.3f -> %.3f", before.Overfetch, after.Overfetch);
+    }
+
     {
         auto bounds = meshopt_computeSphereBounds(
             &result.Positions[0].x,
@@ -189,6 +348,210 @@ bool CreateMeshlets(const char* path, ResMeshlets& result)
     return true;
 }
 
+//-----------------------------------------------------------------------------
+//      メッシュレットと頂点データの並びを最適化します.
+//-----------------------------------------------------------------------------
+bool OptimizeMeshlets(ResMeshlets& meshlets, MESHLET_ORDER order)
+{
+    const auto vertexCount = meshlets.Positions.size();
+    if ((!meshlets.Normals  .empty() && meshlets.Normals  .size() != vertexCount)
+     || (!meshlets.Tangents .empty() && meshlets.Tangents .size() != vertexCount)
+     || (!meshlets.TexCoords.empty() && meshlets.TexCoords.size() != vertexCount))
+    {
+        ELOGA("Error : Vertex Stream Count Not Matched.");
+        return false;
+    }
+
+    // サブセット内のメッシュレットを，バウンディングスフィア中心の空間充填曲線順に並べ替える.
+    if (order != MESHLET_ORDER_NONE)
+    {
+        std::vector<MeshletInfo>    dstMeshlets;
+        std::vector<uint8_t3>       dstPrimitives;
+        std::vector<uint32_t>       dstVertexIndices;
+
+        dstMeshlets     .reserve(meshlets.Meshlets     .size());
+        dstPrimitives   .reserve(meshlets.Primitives   .size());
+        dstVertexIndices.reserve(meshlets.VertexIndices.size());
+
+        std::vector<std::pair<uint32_t, uint32_t>> keys; // (符号, メッシュレット番号).
+
+        for(const auto& subset : meshlets.Subsets)
+        {
+            if (subset.MeshletOffset + subset.MeshletCount > meshlets.Meshlets.size())
+            {
+                ELOGA("Error : Invalid Subset.");
+                return false;
+            }
+
+            // 中心座標の範囲を求める.
+            asdx::Vector3 mini( FLT_MAX,  FLT_MAX,  FLT_MAX);
+            asdx::Vector3 maxi(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            for(auto i=0u; i<subset.MeshletCount; ++i)
+            {
+                const auto& bs = meshlets.Meshlets[subset.MeshletOffset + i].BoundingSphere;
+                mini.x = asdx::Min(mini.x, bs.x); maxi.x = asdx::Max(maxi.x, bs.x);
+                mini.y = asdx::Min(mini.y, bs.y); maxi.y = asdx::Max(maxi.y, bs.y);
+                mini.z = asdx::Min(mini.z, bs.z); maxi.z = asdx::Max(maxi.z, bs.z);
+            }
+
+            // 10bitに量子化して符号を求める.
+            const float kMaxCoord = 1023.0f;
+            asdx::Vector3 scale(
+                (maxi.x > mini.x) ? kMaxCoord / (maxi.x - mini.x) : 0.0f,
+                (maxi.y > mini.y) ? kMaxCoord / (maxi.y - mini.y) : 0.0f,
+                (maxi.z > mini.z) ? kMaxCoord / (maxi.z - mini.z) : 0.0f);
+
+            keys.clear();
+            for(auto i=0u; i<subset.MeshletCount; ++i)
+            {
+                auto idx = uint32_t(subset.MeshletOffset + i);
+                const auto& bs = meshlets.Meshlets[idx].BoundingSphere;
+
+                auto x = uint32_t(asdx::Clamp((bs.x - mini.x) * scale.x, 0.0f, kMaxCoord) + 0.5f);
+                auto y = uint32_t(asdx::Clamp((bs.y - mini.y) * scale.y, 0.0f, kMaxCoord) + 0.5f);
+                auto z = uint32_t(asdx::Clamp((bs.z - mini.z) * scale.z, 0.0f, kMaxCoord) + 0.5f);
+
+                auto key = (order == MESHLET_ORDER_HILBERT) ? EncodeHilbert(x, y, z) : EncodeMorton(x, y, z);
+                keys.emplace_back(key, idx);
+            }
+
+            // 符号が同じ場合は元の順序を保つ.
+            std::sort(keys.begin(), keys.end());
+
+            for(const auto& item : keys)
+            {
+                auto meshlet = meshlets.Meshlets[item.second];
+
+                auto primOffset = uint32_t(dstPrimitives   .size());
+                auto vertOffset = uint32_t(dstVertexIndices.size());
+
+                dstPrimitives.insert(dstPrimitives.end(),
+                    meshlets.Primitives.begin() + meshlet.PrimitiveOffset,
+                    meshlets.Primitives.begin() + meshlet.PrimitiveOffset + meshlet.PrimitiveCount);
+
+                dstVertexIndices.insert(dstVertexIndices.end(),
+                    meshlets.VertexIndices.begin() + meshlet.VertexOffset,
+                    meshlets.VertexIndices.begin() + meshlet.VertexOffset + meshlet.VertexCount);
+
+                meshlet.PrimitiveOffset = primOffset;
+                meshlet.VertexOffset    = vertOffset;
+                dstMeshlets.emplace_back(meshlet);
+            }
+        }
+
+        if (dstMeshlets.size() != meshlets.Meshlets.size())
+        {
+            ELOGA("Error : Subsets Do Not Cover All Meshlets.");
+            return false;
+        }
+
+        meshlets.Meshlets      = std::move(dstMeshlets);
+        meshlets.Primitives    = std::move(dstPrimitives);
+        meshlets.VertexIndices = std::move(dstVertexIndices);
+    }
+
+    // 頂点データをメッシュレットから初めて参照される順に並べ替える.
+    // MEMO : meshopt_optimizeVertexFetchRemap() は三角形リストを前提としているため，メッシュレットの頂点リストは自前で処理する.
+    if (vertexCount > 0)
+    {
+        std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+        uint32_t uniqueCount = 0;
+        for(const auto& index : meshlets.VertexIndices)
+        {
+            if (remap[index] == UINT32_MAX)
+            { remap[index] = uniqueCount++; }
+        }
+
+        RemapStream(meshlets.Positions, remap, uniqueCount);
+        RemapStream(meshlets.Normals,   remap, uniqueCount);
+        RemapStream(meshlets.Tangents,  remap, uniqueCount);
+        RemapStream(meshlets.TexCoords, remap, uniqueCount);
+
+        for(auto& index : meshlets.VertexIndices)
+        { index = remap[index]; }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュレット順に頂点を読み込んだ際のキャッシュ効率を見積もります.
+//-----------------------------------------------------------------------------
+VertexFetchStats AnalyzeVertexFetch
+(
+    const ResMeshlets&  meshlets,
+    uint32_t            cacheSize,
+    uint32_t            lineSize,
+    uint32_t            ways
+)
+{
+    VertexFetchStats result = {};
+    if (lineSize == 0 || ways == 0 || meshlets.Positions.empty())
+        return result;
+
+    // 頂点属性ごとに別バッファとして配置する.
+    struct Stream
+    {
+        uint64_t    Base;
+        uint32_t    Stride;
+    };
+    const uint64_t kBufferAlignment = 65536;
+
+    Stream   streams[4] = {};
+    uint32_t streamCount = 0;
+    uint64_t address     = 0;
+    auto addStream = [&](size_t count, uint32_t stride)
+    {
+        if (count == 0)
+            return;
+
+        streams[streamCount].Base   = address;
+        streams[streamCount].Stride = stride;
+        streamCount++;
+
+        address += (uint64_t(count) * stride + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+    };
+    addStream(meshlets.Positions.size(), sizeof(asdx::Vector3));
+    addStream(meshlets.Normals  .size(), sizeof(asdx::Vector3));
+    addStream(meshlets.Tangents .size(), sizeof(asdx::Vector3));
+    addStream(meshlets.TexCoords.size(), sizeof(asdx::Vector2));
+
+    CacheSimulator cache;
+    cache.Init(cacheSize, lineSize, ways);
+
+    std::vector<bool> referenced(meshlets.Positions.size(), false);
+    uint64_t referencedCount = 0;
+
+    for(const auto& meshlet : meshlets.Meshlets)
+    {
+        for(auto i=0u; i<meshlet.VertexCount; ++i)
+        {
+            auto vertId = meshlets.VertexIndices[meshlet.VertexOffset + i];
+            if (!referenced[vertId])
+            {
+                referenced[vertId] = true;
+                referencedCount++;
+            }
+
+            for(auto j=0u; j<streamCount; ++j)
+            { cache.Access(streams[j].Base + uint64_t(vertId) * streams[j].Stride, streams[j].Stride); }
+        }
+    }
+
+    uint64_t vertexSize = 0;
+    for(auto j=0u; j<streamCount; ++j)
+    { vertexSize += streams[j].Stride; }
+
+    result.AccessCount  = cache.AccessCount;
+    result.MissCount    = cache.MissCount;
+    result.BytesFetched = cache.MissCount * lineSize;
+    result.Overfetch    = (referencedCount > 0)
+        ? float(double(result.BytesFetched) / double(referencedCount * vertexSize))
+        : 0.0f;
+
+    return result;
+}
+
 //-----------------------------------------------------------------------------
 //      頂点シェーダ用の頂点インデックスを求めます.
 //-----------------------------------------------------------------------------
@@ -103,6 +103,27 @@ struct ResMeshlets
     asdx::Vector4                   BoundingSphere;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// MESHLET_ORDER enum
+///////////////////////////////////////////////////////////////////////////////
+enum MESHLET_ORDER
+{
+    MESHLET_ORDER_NONE = 0,     //!< 並べ替えを行いません.
+    MESHLET_ORDER_MORTON,       //!< バウンディングスフィア中心のモートン順に並べ替えます.
+    MESHLET_ORDER_HILBERT,      //!< バウンディングスフィア中心のヒルベルト順に並べ替えます.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// VertexFetchStats structure
+///////////////////////////////////////////////////////////////////////////////
+struct VertexFetchStats
+{
+    uint64_t    AccessCount;    //!< キャッシュライン参照回数.
+    uint64_t    MissCount;      //!< キャッシュミス回数.
+    uint64_t    BytesFetched;   //!< メモリから読み込んだバイト数.
+    float       Overfetch;      //!< 読み込んだバイト数 / 頂点バッファサイズ (最良値は1.0).
+};
+
 //-----------------------------------------------------------------------------
 //! @brief      プリミティブインデックスに変換します.
 //-----------------------------------------------------------------------------
@@ -137,6 +158,36 @@ inline uint8_t3 FromPrimitiveIndex(const PrimitiveIndex& value)
 //-----------------------------------------------------------------------------
 bool CreateMeshlets(const char* path, ResMeshlets& result);
 
+//-----------------------------------------------------------------------------
+//! @brief      メッシュレットと頂点データの並びを最適化します.
+//!
+//! @param[in,out]  meshlets    最適化するメッシュレット.
+//! @param[in]      order       サブセット内のメッシュレットの並び順.
+//! @retval true    最適化に成功.
+//! @retval false   最適化に失敗.
+//! @note       メッシュレットを空間充填曲線順に並べ替えた後，頂点データを初回参照順に並べ替えます.
+//!             どのメッシュレットからも参照されない頂点は削除されます.
+//-----------------------------------------------------------------------------
+bool OptimizeMeshlets(ResMeshlets& meshlets, MESHLET_ORDER order = MESHLET_ORDER_HILBERT);
+
+//-----------------------------------------------------------------------------
+//! @brief      メッシュレット順に頂点を読み込んだ際のキャッシュ効率を見積もります.
+//!
+//! @param[in]      meshlets    解析するメッシュレット.
+//! @param[in]      cacheSize   キャッシュサイズ(バイト).
+//! @param[in]      lineSize    キャッシュラインサイズ(バイト).
+//! @param[in]      ways        連想度.
+//! @return     統計情報を返却します.
+//! @note       頂点属性ごとに別バッファとして，LRUのセットアソシアティブキャッシュを模擬します.
+//-----------------------------------------------------------------------------
+VertexFetchStats AnalyzeVertexFetch
+(
+    const ResMeshlets&  meshlets,
+    uint32_t            cacheSize = 16 * 1024,
+    uint32_t            lineSize  = 64,
+    uint32_t            ways      = 4
+);
+
 //-----------------------------------------------------------------------------
 //! @brief      頂点シェーダ用の頂点インデックスを生成します.
 //! 
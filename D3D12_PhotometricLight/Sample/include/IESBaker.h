@@ -0,0 +1,120 @@
+﻿//-----------------------------------------------------------------------------
+// File : IESBaker.h
+// Desc : IES Candela Texture Baker.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <IESLamp.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// IES_ATLAS_MODE enum
+///////////////////////////////////////////////////////////////////////////////
+enum IES_ATLAS_MODE : uint32_t
+{
+    IES_ATLAS_1D = 0,   //!< 1プロファイルを1行に格納します(水平角方向は平均化).
+    IES_ATLAS_2D,       //!< 1プロファイルを正方形タイルに格納します.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// IESAtlasEntry structure
+///////////////////////////////////////////////////////////////////////////////
+struct IESAtlasEntry
+{
+    float       Lumen;      //!< 光束.
+    uint32_t    OffsetX;    //!< アトラス内の横方向オフセット[texel].
+    uint32_t    OffsetY;    //!< アトラス内の縦方向オフセット[texel].
+    uint32_t    Width;      //!< 横幅[texel].
+    uint32_t    Height;     //!< 縦幅[texel].
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// IESAtlas structure
+///////////////////////////////////////////////////////////////////////////////
+struct IESAtlas
+{
+    IES_ATLAS_MODE              Mode;       //!< 格納モード.
+    uint32_t                    Width;      //!< テクスチャ横幅.
+    uint32_t                    Height;     //!< テクスチャ縦幅.
+    std::vector<IESAtlasEntry>  Entries;    //!< プロファイル毎の格納情報.
+    std::vector<std::string>    Names;      //!< プロファイル名(Entriesと同数, 空でも可).
+    std::vector<float>          Texels;     //!< 正規化済みカンデラ値(R32_FLOAT).
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      カンデラテクスチャのサイズを求めます.
+//!
+//! @param[in]      lamp        光源データです.
+//! @return     128以上の2のべき乗を返却します. サポート範囲外の場合は 0 を返却します.
+//-----------------------------------------------------------------------------
+uint32_t GetIESTextureSize(const Lamp& lamp);
+
+//-----------------------------------------------------------------------------
+//! @brief      補間したカンデラ値を取得します.
+//!
+//! @param[in]      lamp        光源データです.
+//! @param[in]      angleV      垂直角[deg]です.
+//! @param[in]      angleH      水平角[deg]です.
+//! @return     バイリニア補間したカンデラ値を返却します.
+//-----------------------------------------------------------------------------
+float SampleIESCandela(const Lamp& lamp, float angleV, float angleH);
+
+//-----------------------------------------------------------------------------
+//! @brief      平均カンデラ値で正規化したカンデラテクスチャを生成します.
+//!
+//! @param[in]      lamp            光源データです.
+//! @param[in]      width           横幅です(垂直角方向, cosθ で等分割).
+//! @param[in]      height          縦幅です(水平角方向).
+//! @param[out]     pDst            出力先です.
+//! @param[in]      dstPitch        出力先の1行当たりの要素数です.
+//! @param[in]      threadCount     ワーカースレッド数です. 0の場合はハードウェアスレッド数を使います.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//! @note       角度から補間位置へのテーブルを行・列毎に1度だけ作るので，テクセル毎の処理は積和のみになります.
+//-----------------------------------------------------------------------------
+bool BakeIESCandela
+(
+    const Lamp& lamp,
+    uint32_t    width,
+    uint32_t    height,
+    float*      pDst,
+    size_t      dstPitch,
+    uint32_t    threadCount = 0
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      複数のプロファイルを1枚のテクスチャにまとめます.
+//!
+//! @param[in]      lamps           光源データです.
+//! @param[in]      mode            格納モードです.
+//! @param[in]      tileSize        1プロファイル当たりの横幅です. 0の場合は全プロファイルの GetIESTextureSize() の最大値を使います.
+//! @param[out]     atlas           アトラスの格納先です.
+//! @param[in]      threadCount     ワーカースレッド数です. 0の場合はハードウェアスレッド数を使います.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//-----------------------------------------------------------------------------
+bool BuildIESAtlas
+(
+    const std::vector<Lamp>&    lamps,
+    IES_ATLAS_MODE              mode,
+    uint32_t                    tileSize,
+    IESAtlas&                   atlas,
+    uint32_t                    threadCount = 0
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      アトラスをバイナリファイルに保存します.
+//-----------------------------------------------------------------------------
+bool SaveIESAtlas(const char* path, const IESAtlas& atlas);
+
+//-----------------------------------------------------------------------------
+//! @brief      バイナリファイルからアトラスを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadIESAtlas(const char* path, IESAtlas& atlas);
@@ -0,0 +1,136 @@
+﻿//-----------------------------------------------------------------------------
+// File : IESLamp.h
+// Desc : IES Lamp Data.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr int IES_PHOTOMETRIC_TYPE_C = 1;   // C-Plane
+constexpr int IES_PHOTOMETRIC_TYPE_B = 2;   // B-Plane
+constexpr int IES_PHOTOMETRIC_TYPE_A = 3;   // A-Plane
+
+constexpr int IES_UNIT_FEET  = 1;           // フィート単位[ft]
+constexpr int IES_UNIT_METER = 2;           // メートル単位[m]
+
+
+///////////////////////////////////////////////////////////////////////////////
+// IES_FORMAT enum
+///////////////////////////////////////////////////////////////////////////////
+enum IES_FORMAT : uint32_t
+{
+    IES_FORMAT_LM_63_1986 = 0,      //!< ヘッダ行無し.
+    IES_FORMAT_LM_63_1991,          //!< IESNA91
+    IES_FORMAT_LM_63_1995,          //!< IESNA:LM-63-1995
+    IES_FORMAT_LM_63_2002,          //!< IESNA:LM-63-2002
+    IES_FORMAT_LM_63_2019,          //!< IES:LM-63-2019
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// IES_PARSE_ERROR enum
+///////////////////////////////////////////////////////////////////////////////
+enum IES_PARSE_ERROR : uint32_t
+{
+    IES_PARSE_OK = 0,               //!< 成功.
+    IES_PARSE_FILE_OPEN_FAILED,     //!< ファイルが開けない.
+    IES_PARSE_TILT_NOT_FOUND,       //!< TILT= 行が見つからない.
+    IES_PARSE_UNEXPECTED_EOF,       //!< データが足りない.
+    IES_PARSE_INVALID_NUMBER,       //!< 数値として解釈できない.
+    IES_PARSE_INVALID_TILT,         //!< TILT=INCLUDE のデータが不正.
+    IES_PARSE_INVALID_HEADER,       //!< 光源数・角度数などが不正.
+    IES_PARSE_INVALID_ANGLE,        //!< 角度が範囲外または昇順でない.
+    IES_PARSE_UNSUPPORTED,          //!< C-Plane以外のフォトメトリックタイプ.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// IESParseResult structure
+///////////////////////////////////////////////////////////////////////////////
+struct IESParseResult
+{
+    IES_PARSE_ERROR     Error   = IES_PARSE_OK;     //!< エラーコード.
+    uint32_t            Line    = 0;                //!< エラーが発生した行番号(1始まり).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Lamp structure
+///////////////////////////////////////////////////////////////////////////////
+struct Lamp
+{
+    IES_FORMAT          Format;         //!< ファイルフォーマット.
+    int                 LampCount;      //!< ランプ数.
+    float               Lumen;          //!< 光束
+    float               Multiplier;     //!< 乗算係数.
+    int                 PhotometricType;//!< フォトメトリックタイプ(1:C-Plane, 2:B-Plane, 3:A-Plane).
+    int                 UnitType;       //!< 単位(1:フィート, 2:メートル).
+    float               ShapeWidth;     //!< 形状横幅.
+    float               ShapeLength;    //!< 形状奥行き.
+    float               ShapeHeight;    //!< 形状高さ.
+    float               BallastFactor;  //!< 安定器光出力係数.
+    float               InputWatts;     //!< 入力ワット数.
+    int                 TiltGeometry;   //!< ランプと器具の配置(1～3, TILT=NONEの場合は0).
+    std::vector<float>  TiltAngle;      //!< チルト角.
+    std::vector<float>  TiltFactor;     //!< チルト角毎の光束係数.
+    std::vector<float>  AngleV;         //!< 垂直角.
+    std::vector<float>  AngleH;         //!< 水平角.
+    std::vector<float>  Candera;        //!< カンデラ値.
+    float               AveCandera;     //!< カンデラの平均値.
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      メモリ上のIESプロファイルを解析します.
+//!
+//! @param[in]      pBuffer     IESファイルの内容です(null終端不要).
+//! @param[in]      size        バッファサイズです.
+//! @param[out]     lamp        光源データの格納先です.
+//! @param[out]     pResult     エラー情報の格納先です. 不要な場合は nullptr.
+//! @retval true    解析に成功.
+//! @retval false   解析に失敗.
+//! @note       LM-63-1986/1991/1995/2002/2019 と TILT=INCLUDE に対応します.
+//!             値は行をまたいで折り返されていても構いません.
+//!             トークン分割はバッファを直接参照し，角度・カンデラの配列は1度だけ確保します.
+//-----------------------------------------------------------------------------
+bool ParseIESProfile(const char* pBuffer, size_t size, Lamp& lamp, IESParseResult* pResult = nullptr);
+
+//-----------------------------------------------------------------------------
+//! @brief      IESプロファイルをロードします.
+//!
+//! @param[in]      path        ファイルパスです.
+//! @param[out]     lamp        光源データの格納先です.
+//! @param[out]     pResult     エラー情報の格納先です. 不要な場合は nullptr.
+//! @retval true    ロードに成功.
+//! @retval false   ロードに失敗.
+//! @note       ファイルはメモリマップして解析します.
+//-----------------------------------------------------------------------------
+bool LoadIESProfile(const char* path, Lamp& lamp, IESParseResult* pResult = nullptr);
+
+//-----------------------------------------------------------------------------
+//! @brief      複数のIESプロファイルを並列にロードします.
+//!
+//! @param[in]      paths           ファイルパスです.
+//! @param[out]     lamps           光源データの格納先です(paths と同じ順番).
+//! @param[out]     results         ファイル毎のエラー情報です(paths と同じ順番).
+//! @param[in]      threadCount     ワーカースレッド数です. 0の場合はハードウェアスレッド数を使います.
+//! @return     ロードに成功したファイル数を返却します.
+//-----------------------------------------------------------------------------
+uint32_t LoadIESProfiles
+(
+    const std::vector<std::string>& paths,
+    std::vector<Lamp>&              lamps,
+    std::vector<IESParseResult>&    results,
+    uint32_t                        threadCount = 0
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      エラーコードを文字列に変換します.
+//-----------------------------------------------------------------------------
+const char* ToString(IES_PARSE_ERROR error);
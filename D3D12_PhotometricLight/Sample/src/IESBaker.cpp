@@ -0,0 +1,557 @@
+﻿//-----------------------------------------------------------------------------
+// File : IESBaker.cpp
+// Desc : IES Candela Texture Baker.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <IESBaker.h>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <Logger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr uint32_t  kMinTextureExp      = 7;        // 128px.
+constexpr uint32_t  kMaxTextureExp      = 14;       // D3D12_MAX_TEXTURE_DIMENSION_2_TO_EXP.
+constexpr uint32_t  kMaxTextureSize     = 1u << kMaxTextureExp;
+constexpr uint32_t  kAtlasVersion       = 1;
+constexpr float     kPi                 = 3.1415926535897932384626433832795f;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SampleTable structure
+///////////////////////////////////////////////////////////////////////////////
+struct SampleTable
+{
+    std::vector<uint32_t>   Index0;     //!< 左側のインデックス.
+    std::vector<uint32_t>   Index1;     //!< 右側のインデックス.
+    std::vector<float>      Weight0;    //!< 左側の重み(範囲外は0).
+    std::vector<float>      Weight1;    //!< 右側の重み(範囲外は0).
+
+    void Resize(uint32_t count)
+    {
+        Index0 .resize(count);
+        Index1 .resize(count);
+        Weight0.resize(count);
+        Weight1.resize(count);
+    }
+
+    void Set(uint32_t i, float pos, uint32_t count)
+    {
+        // 範囲外は重み0とする.
+        if (pos < 0.0f)
+        {
+            Index0 [i] = 0;
+            Index1 [i] = 0;
+            Weight0[i] = 0.0f;
+            Weight1[i] = 0.0f;
+            return;
+        }
+
+        auto x0 = uint32_t(floor(pos));
+        auto t  = pos - float(x0);
+
+        Index0 [i] = x0 % count;
+        Index1 [i] = (x0 + 1) % count;
+        Weight0[i] = 1.0f - t;
+        Weight1[i] = t;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResIESAtlasHeader structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResIESAtlasHeader
+{
+    char        Magic[4];
+    uint32_t    Version;
+    uint32_t    Mode;
+    uint32_t    Width;
+    uint32_t    Height;
+    uint32_t    EntryCount;
+};
+
+//-----------------------------------------------------------------------------
+//      インデックスを浮動小数で求めます.
+//-----------------------------------------------------------------------------
+float GetPos(float value, const std::vector<float>& container)
+{
+    if (container.size() == 1)
+    { return container.front(); }
+
+    if (value < container.front())
+    { return -1.0f; }
+
+    if (value > container.back())
+    { return -1.0f; }
+
+    size_t lhs = 0;
+    size_t rhs = container.size() - 1;
+
+    // 2分探索.
+    while (lhs < rhs)
+    {
+        auto pivot = (lhs + rhs + 1) / 2;
+        auto temp = container[pivot];
+
+        if (value >= temp)
+        { lhs = pivot; }
+        else
+        { rhs = pivot - 1; }
+    }
+
+    auto t = 0.0f;
+    if (lhs + 1 < container.size())
+    {
+        auto left  = container[lhs + 0];
+        auto right = container[lhs + 1];
+        auto delta = right - left;
+
+        if (delta > 1e-5f)
+        { t = (value - left) / delta; }
+    }
+
+    return float(lhs) + t;
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャ座標から水平角を求めます.
+//-----------------------------------------------------------------------------
+float GetAngleH(uint32_t j, float invH, float lastH)
+{
+    // Φは[0, 2π]の範囲. 最終角より先は折り返す.
+    if (lastH <= 0.0f)
+    { return 0.0f; }
+
+    auto angleH = j * invH * 360.0f;
+    angleH = fmod(angleH, 2.0f * lastH);
+    if (angleH > lastH)
+    { angleH = lastH * 2.0f - angleH; }
+
+    return angleH;
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャ座標から垂直角を求めます.
+//-----------------------------------------------------------------------------
+float GetAngleV(uint32_t i, float invW)
+{
+    // θは[0, π]の範囲.
+    auto rad = i * invW * 2.0f - 1.0f;
+    return acos(rad) * (180.0f / kPi);
+}
+
+//-----------------------------------------------------------------------------
+//      並列に処理を行います.
+//-----------------------------------------------------------------------------
+template<typename Func>
+void ParallelFor(uint32_t count, uint32_t threadCount, Func func)
+{
+    if (threadCount == 0)
+    { threadCount = std::max(std::thread::hardware_concurrency(), 1u); }
+    threadCount = std::min(threadCount, count);
+
+    if (threadCount <= 1)
+    {
+        for(auto i=0u; i<count; ++i)
+        { func(i); }
+        return;
+    }
+
+    std::atomic<uint32_t> next(0);
+    auto worker = [&]()
+    {
+        for(;;)
+        {
+            auto i = next.fetch_add(1);
+            if (i >= count)
+                break;
+
+            func(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for(auto i=1u; i<threadCount; ++i)
+    { threads.emplace_back(worker); }
+
+    worker();
+
+    for(auto& thread : threads)
+    { thread.join(); }
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      カンデラテクスチャのサイズを求めます.
+//-----------------------------------------------------------------------------
+uint32_t GetIESTextureSize(const Lamp& lamp)
+{
+    auto size = uint32_t(1u << kMinTextureExp);
+    size = std::max(size, uint32_t(lamp.AngleV.size()));
+    size = std::max(size, uint32_t(lamp.AngleH.size()));
+
+    // 128pxから2次元テクスチャ最大値までの範囲で近いべき乗を求める.
+    for(auto i=kMinTextureExp; i<=kMaxTextureExp; ++i)
+    {
+        auto lhs = 1u << (i - 1);
+        auto rhs = 1u << i;
+
+        // 範囲内に収まっているかチェック.
+        if (lhs < size && size <= rhs)
+        { return rhs; }
+    }
+
+    // サポート範囲外.
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+//      補間したカンデラ値を取得します.
+//-----------------------------------------------------------------------------
+float SampleIESCandela(const Lamp& lamp, float angleV, float angleH)
+{
+    // 最大範囲でチェック.
+    assert(0 <= angleV && angleV <= 180.0f);
+    assert(0 <= angleH && angleH <= 360.0f);
+
+    // インデックスを浮動小数で取得.
+    auto s = GetPos(angleV, lamp.AngleV);
+    auto t = GetPos(angleH, lamp.AngleH);
+
+    if (s < 0.0f || t < 0.0f)
+    { return 0.0f; }
+
+    auto w = uint32_t(lamp.AngleV.size());
+    auto h = uint32_t(lamp.AngleH.size());
+
+    SampleTable tableV;
+    SampleTable tableH;
+    tableV.Resize(1);
+    tableH.Resize(1);
+    tableV.Set(0, s, w);
+    tableH.Set(0, t, h);
+
+    auto row0 = &lamp.Candera[size_t(w) * tableH.Index0[0]];
+    auto row1 = &lamp.Candera[size_t(w) * tableH.Index1[0]];
+
+    // バイリニアサンプリング.
+    return tableV.Weight0[0] * (tableH.Weight0[0] * row0[tableV.Index0[0]] + tableH.Weight1[0] * row1[tableV.Index0[0]])
+         + tableV.Weight1[0] * (tableH.Weight0[0] * row0[tableV.Index1[0]] + tableH.Weight1[0] * row1[tableV.Index1[0]]);
+}
+
+//-----------------------------------------------------------------------------
+//      平均カンデラ値で正規化したカンデラテクスチャを生成します.
+//-----------------------------------------------------------------------------
+bool BakeIESCandela
+(
+    const Lamp& lamp,
+    uint32_t    width,
+    uint32_t    height,
+    float*      pDst,
+    size_t      dstPitch,
+    uint32_t    threadCount
+)
+{
+    auto countV = uint32_t(lamp.AngleV.size());
+    auto countH = uint32_t(lamp.AngleH.size());
+
+    if (width == 0 || height == 0 || pDst == nullptr || dstPitch < width
+     || countV == 0 || countH == 0 || lamp.Candera.size() != size_t(countV) * countH)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto invW = 1.0f / float(width);
+    auto invH = 1.0f / float(height);
+    auto invA = (lamp.AveCandera > 0.0f) ? 1.0f / lamp.AveCandera : 0.0f;
+
+    // 列(垂直角)と行(水平角)の補間位置は他方に依存しないので，先に求めておく.
+    SampleTable tableV;
+    tableV.Resize(width);
+    for(auto i=0u; i<width; ++i)
+    { tableV.Set(i, GetPos(GetAngleV(i, invW), lamp.AngleV), countV); }
+
+    SampleTable tableH;
+    tableH.Resize(height);
+    auto lastH = lamp.AngleH.back();
+    for(auto j=0u; j<height; ++j)
+    { tableH.Set(j, GetPos(GetAngleH(j, invH, lastH), lamp.AngleH), countH); }
+
+    auto pIndex0  = tableV.Index0 .data();
+    auto pIndex1  = tableV.Index1 .data();
+    auto pWeight0 = tableV.Weight0.data();
+    auto pWeight1 = tableV.Weight1.data();
+
+    // 行単位で並列化.
+    ParallelFor(height, threadCount, [&](uint32_t j)
+    {
+        auto row0 = &lamp.Candera[size_t(countV) * tableH.Index0[j]];
+        auto row1 = &lamp.Candera[size_t(countV) * tableH.Index1[j]];
+        auto wh0  = invA * tableH.Weight0[j];
+        auto wh1  = invA * tableH.Weight1[j];
+        auto dst  = pDst + dstPitch * j;
+
+        // 分岐無しの積和のみにして，自動ベクトル化が効くようにする.
+        for(auto i=0u; i<width; ++i)
+        {
+            auto x0 = pIndex0[i];
+            auto x1 = pIndex1[i];
+            dst[i] = pWeight0[i] * (wh0 * row0[x0] + wh1 * row1[x0])
+                   + pWeight1[i] * (wh0 * row0[x1] + wh1 * row1[x1]);
+        }
+    });
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      複数のプロファイルを1枚のテクスチャにまとめます.
+//-----------------------------------------------------------------------------
+bool BuildIESAtlas
+(
+    const std::vector<Lamp>&    lamps,
+    IES_ATLAS_MODE              mode,
+    uint32_t                    tileSize,
+    IESAtlas&                   atlas,
+    uint32_t                    threadCount
+)
+{
+    if (lamps.empty())
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto count = uint32_t(lamps.size());
+
+    if (tileSize == 0)
+    {
+        for(const auto& lamp : lamps)
+        {
+            auto size = GetIESTextureSize(lamp);
+            if (size == 0)
+            {
+                ELOG("Error : Out of support.");
+                return false;
+            }
+            tileSize = std::max(tileSize, size);
+        }
+    }
+
+    // レイアウトを決める.
+    auto columns    = 1u;
+    auto tileHeight = 1u;
+    if (mode == IES_ATLAS_2D)
+    {
+        columns    = uint32_t(ceil(sqrt(double(count))));
+        tileHeight = tileSize;
+    }
+    auto rows = (count + columns - 1) / columns;
+
+    atlas.Mode   = mode;
+    atlas.Width  = tileSize * columns;
+    atlas.Height = tileHeight * rows;
+
+    if (atlas.Width > kMaxTextureSize || atlas.Height > kMaxTextureSize)
+    {
+        ELOG("Error : Atlas Size Over. width = %u, height = %u", atlas.Width, atlas.Height);
+        return false;
+    }
+
+    atlas.Entries.resize(count);
+    atlas.Names  .resize(count);
+    atlas.Texels .assign(size_t(atlas.Width) * atlas.Height, 0.0f);
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto& entry = atlas.Entries[i];
+        entry.Lumen   = lamps[i].Lumen;
+        entry.OffsetX = (i % columns) * tileSize;
+        entry.OffsetY = (i / columns) * tileHeight;
+        entry.Width   = tileSize;
+        entry.Height  = tileHeight;
+    }
+
+    // プロファイル単位で並列化する.
+    std::atomic<bool> succeeded(true);
+    ParallelFor(count, threadCount, [&](uint32_t index)
+    {
+        const auto& entry = atlas.Entries[index];
+        auto pDst = atlas.Texels.data() + size_t(atlas.Width) * entry.OffsetY + entry.OffsetX;
+
+        if (mode == IES_ATLAS_2D)
+        {
+            if (!BakeIESCandela(lamps[index], tileSize, tileSize, pDst, atlas.Width, 1))
+            { succeeded = false; }
+            return;
+        }
+
+        // 1Dの場合は水平角方向に平均化する.
+        std::vector<float> temp(size_t(tileSize) * tileSize);
+        if (!BakeIESCandela(lamps[index], tileSize, tileSize, temp.data(), tileSize, 1))
+        {
+            succeeded = false;
+            return;
+        }
+
+        auto invCount = 1.0f / float(tileSize);
+        for(auto j=0u; j<tileSize; ++j)
+        {
+            auto src = temp.data() + size_t(tileSize) * j;
+            for(auto i=0u; i<tileSize; ++i)
+            { pDst[i] += src[i] * invCount; }
+        }
+    });
+
+    return succeeded;
+}
+
+//-----------------------------------------------------------------------------
+//      アトラスをバイナリファイルに保存します.
+//-----------------------------------------------------------------------------
+bool SaveIESAtlas(const char* path, const IESAtlas& atlas)
+{
+    if (path == nullptr
+     || atlas.Texels.size() != size_t(atlas.Width) * atlas.Height
+     || (!atlas.Names.empty() && atlas.Names.size() != atlas.Entries.size()))
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    FILE* pFile = nullptr;
+    auto err = fopen_s(&pFile, path, "wb");
+    if (err != 0)
+    {
+        ELOG("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    ResIESAtlasHeader header = {};
+    header.Magic[0]   = 'I';
+    header.Magic[1]   = 'E';
+    header.Magic[2]   = 'A';
+    header.Magic[3]   = '\0';
+    header.Version    = kAtlasVersion;
+    header.Mode       = atlas.Mode;
+    header.Width      = atlas.Width;
+    header.Height     = atlas.Height;
+    header.EntryCount = uint32_t(atlas.Entries.size());
+
+    fwrite(&header, sizeof(header), 1, pFile);
+    fwrite(atlas.Entries.data(), sizeof(IESAtlasEntry), atlas.Entries.size(), pFile);
+
+    for(size_t i=0; i<atlas.Entries.size(); ++i)
+    {
+        auto length = atlas.Names.empty() ? 0u : uint32_t(atlas.Names[i].size());
+        fwrite(&length, sizeof(length), 1, pFile);
+        if (length > 0)
+        { fwrite(atlas.Names[i].data(), 1, length, pFile); }
+    }
+
+    fwrite(atlas.Texels.data(), sizeof(float), atlas.Texels.size(), pFile);
+
+    auto ret = (ferror(pFile) == 0);
+    fclose(pFile);
+
+    if (!ret)
+    {
+        ELOG("Error : File Write Failed. path = %s", path);
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      バイナリファイルからアトラスを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadIESAtlas(const char* path, IESAtlas& atlas)
+{
+    if (path == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    FILE* pFile = nullptr;
+    auto err = fopen_s(&pFile, path, "rb");
+    if (err != 0)
+    {
+        ELOG("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    ResIESAtlasHeader header = {};
+    if (fread(&header, sizeof(header), 1, pFile) != 1
+     || memcmp(header.Magic, "IEA", 4) != 0
+     || header.Version != kAtlasVersion
+     || header.Width  == 0 || header.Width  > kMaxTextureSize
+     || header.Height == 0 || header.Height > kMaxTextureSize)
+    {
+        ELOG("Error : Invalid File. path = %s", path);
+        fclose(pFile);
+        return false;
+    }
+
+    atlas.Mode   = IES_ATLAS_MODE(header.Mode);
+    atlas.Width  = header.Width;
+    atlas.Height = header.Height;
+    atlas.Entries.resize(header.EntryCount);
+    atlas.Names  .resize(header.EntryCount);
+    atlas.Texels .resize(size_t(header.Width) * header.Height);
+
+    auto ret = fread(atlas.Entries.data(), sizeof(IESAtlasEntry), atlas.Entries.size(), pFile) == atlas.Entries.size();
+
+    for(size_t i=0; ret && i<atlas.Entries.size(); ++i)
+    {
+        const auto& entry = atlas.Entries[i];
+        if (uint64_t(entry.OffsetX) + entry.Width  > atlas.Width
+         || uint64_t(entry.OffsetY) + entry.Height > atlas.Height)
+        {
+            ret = false;
+            break;
+        }
+
+        uint32_t length = 0;
+        if (fread(&length, sizeof(length), 1, pFile) != 1 || length > 4096)
+        {
+            ret = false;
+            break;
+        }
+
+        atlas.Names[i].resize(length);
+        if (length > 0 && fread(&atlas.Names[i][0], 1, length, pFile) != length)
+        { ret = false; }
+    }
+
+    if (ret)
+    { ret = fread(atlas.Texels.data(), sizeof(float), atlas.Texels.size(), pFile) == atlas.Texels.size(); }
+
+    fclose(pFile);
+
+    if (!ret)
+    {
+        ELOG("Error : Invalid File. path = %s", path);
+        return false;
+    }
+
+    return true;
+}
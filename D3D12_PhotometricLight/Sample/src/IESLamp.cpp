@@ -0,0 +1,578 @@
+﻿//-----------------------------------------------------------------------------
+// File : IESLamp.cpp
+// Desc : IES Lamp Data.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <IESLamp.h>
+#include <cmath>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <Logger.h>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif//NOMINMAX
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif//_WIN32
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+constexpr int       kMaxAngleCount      = 1 << 16;      // 1軸当たりの最大角度数.
+constexpr size_t    kMaxCandelaCount    = 1 << 24;      // 最大カンデラ値数.
+constexpr int       kMaxTiltCount       = 1 << 12;      // 最大チルト角数.
+
+
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile class
+///////////////////////////////////////////////////////////////////////////////
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    ~MappedFile()
+    { Unmap(); }
+
+    bool Map(const char* path)
+    {
+        Unmap();
+
+    #ifdef _WIN32
+        m_hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        { return false; }
+
+        LARGE_INTEGER size = {};
+        if (!GetFileSizeEx(m_hFile, &size))
+        { return false; }
+
+        m_Size = size_t(size.QuadPart);
+        if (m_Size == 0)
+        { return true; }
+
+        m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_hMapping == nullptr)
+        { return false; }
+
+        m_pData = static_cast<const char*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+        return m_pData != nullptr;
+    #else
+        m_File = open(path, O_RDONLY);
+        if (m_File < 0)
+        { return false; }
+
+        struct stat info = {};
+        if (fstat(m_File, &info) != 0)
+        { return false; }
+
+        m_Size = size_t(info.st_size);
+        if (m_Size == 0)
+        { return true; }
+
+        auto ptr = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+        if (ptr == MAP_FAILED)
+        { return false; }
+
+        m_pData = static_cast<const char*>(ptr);
+        return true;
+    #endif
+    }
+
+    void Unmap()
+    {
+    #ifdef _WIN32
+        if (m_pData != nullptr)
+        { UnmapViewOfFile(m_pData); }
+
+        if (m_hMapping != nullptr)
+        { CloseHandle(m_hMapping); }
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        { CloseHandle(m_hFile); }
+
+        m_hMapping = nullptr;
+        m_hFile    = INVALID_HANDLE_VALUE;
+    #else
+        if (m_pData != nullptr)
+        { munmap(const_cast<char*>(m_pData), m_Size); }
+
+        if (m_File >= 0)
+        { close(m_File); }
+
+        m_File = -1;
+    #endif
+
+        m_pData = nullptr;
+        m_Size  = 0;
+    }
+
+    const char* GetData() const
+    { return m_pData; }
+
+    size_t GetSize() const
+    { return m_Size; }
+
+private:
+#ifdef _WIN32
+    HANDLE      m_hFile     = INVALID_HANDLE_VALUE;
+    HANDLE      m_hMapping  = nullptr;
+#else
+    int         m_File      = -1;
+#endif
+    const char* m_pData     = nullptr;
+    size_t      m_Size      = 0;
+
+    MappedFile              (const MappedFile&) = delete;
+    MappedFile& operator =  (const MappedFile&) = delete;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Tokenizer class
+///////////////////////////////////////////////////////////////////////////////
+class Tokenizer
+{
+public:
+    Tokenizer(const char* pBuffer, size_t size)
+    : m_pCur(pBuffer)
+    , m_pEnd(pBuffer + size)
+    , m_Line(1)
+    {
+        // BOMを読み飛ばす.
+        if (size >= 3 && memcmp(pBuffer, "\xEF\xBB\xBF", 3) == 0)
+        { m_pCur += 3; }
+    }
+
+    //-------------------------------------------------------------------------
+    //      行末までを取り出します(前後の空白は除く).
+    //-------------------------------------------------------------------------
+    bool NextLine(const char*& pLine, size_t& length)
+    {
+        if (m_pCur >= m_pEnd)
+        { return false; }
+
+        auto begin = m_pCur;
+        while(m_pCur < m_pEnd && *m_pCur != '\n')
+        { m_pCur++; }
+
+        auto end = m_pCur;
+        if (m_pCur < m_pEnd)
+        {
+            m_pCur++;
+            m_Line++;
+        }
+
+        while(begin < end && IsBlank(*begin))
+        { begin++; }
+        while(end > begin && IsBlank(end[-1]))
+        { end--; }
+
+        pLine  = begin;
+        length = size_t(end - begin);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //      次のトークンを取り出します. 改行をまたぎます.
+    //-------------------------------------------------------------------------
+    bool NextToken(const char*& pToken, size_t& length)
+    {
+        while(m_pCur < m_pEnd && IsSeparator(*m_pCur))
+        {
+            if (*m_pCur == '\n')
+            { m_Line++; }
+            m_pCur++;
+        }
+
+        if (m_pCur >= m_pEnd)
+        { return false; }
+
+        auto begin = m_pCur;
+        while(m_pCur < m_pEnd && !IsSeparator(*m_pCur))
+        { m_pCur++; }
+
+        pToken = begin;
+        length = size_t(m_pCur - begin);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //      浮動小数を取り出します.
+    //-------------------------------------------------------------------------
+    IES_PARSE_ERROR NextFloat(float& value)
+    {
+        const char* pToken = nullptr;
+        size_t      length = 0;
+        if (!NextToken(pToken, length))
+        { return IES_PARSE_UNEXPECTED_EOF; }
+
+        auto end = pToken + length;
+        if (*pToken == '+')
+        { pToken++; }
+
+        auto ret = std::from_chars(pToken, end, value);
+        if (ret.ec != std::errc() || ret.ptr != end || !std::isfinite(value))
+        { return IES_PARSE_INVALID_NUMBER; }
+
+        return IES_PARSE_OK;
+    }
+
+    //-------------------------------------------------------------------------
+    //      整数を取り出します("1.0" のような表記も許容します).
+    //-------------------------------------------------------------------------
+    IES_PARSE_ERROR NextInt(int& value)
+    {
+        auto temp = 0.0f;
+        auto err  = NextFloat(temp);
+        if (err != IES_PARSE_OK)
+        { return err; }
+
+        if (temp != std::floor(temp) || std::fabs(temp) > float(1 << 30))
+        { return IES_PARSE_INVALID_NUMBER; }
+
+        value = int(temp);
+        return IES_PARSE_OK;
+    }
+
+    //-------------------------------------------------------------------------
+    //      浮動小数の配列を取り出します.
+    //-------------------------------------------------------------------------
+    IES_PARSE_ERROR NextFloats(size_t count, std::vector<float>& values)
+    {
+        // 1値につき数字と区切りで最低2バイト要る. 残りに収まらない個数は確保せず，
+        // 読み進めて通常と同じエラーと行番号を返す.
+        if (count > (size_t(m_pEnd - m_pCur) + 1) / 2)
+        {
+            values.clear();
+
+            auto temp = 0.0f;
+            for(;;)
+            {
+                auto err = NextFloat(temp);
+                if (err != IES_PARSE_OK)
+                { return err; }
+            }
+        }
+
+        values.resize(count);
+        for(size_t i=0; i<count; ++i)
+        {
+            auto err = NextFloat(values[i]);
+            if (err != IES_PARSE_OK)
+            { return err; }
+        }
+
+        return IES_PARSE_OK;
+    }
+
+    //-------------------------------------------------------------------------
+    //      現在の行番号を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetLine() const
+    { return m_Line; }
+
+private:
+    const char* m_pCur;
+    const char* m_pEnd;
+    uint32_t    m_Line;
+
+    static bool IsBlank(char c)
+    { return c == ' ' || c == '\t' || c == '\r'; }
+
+    static bool IsSeparator(char c)
+    { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ','; }
+};
+
+//-----------------------------------------------------------------------------
+//      文字列が指定文字列で始まるかどうかチェックします.
+//-----------------------------------------------------------------------------
+inline bool StartsWith(const char* pText, size_t length, const char* pPrefix)
+{
+    auto count = strlen(pPrefix);
+    return length >= count && memcmp(pText, pPrefix, count) == 0;
+}
+
+//-----------------------------------------------------------------------------
+//      角度が範囲内かつ昇順になっているかチェックします.
+//-----------------------------------------------------------------------------
+bool IsValidAngles(const std::vector<float>& angles, float minValue, float maxValue)
+{
+    for(size_t i=0; i<angles.size(); ++i)
+    {
+        if (angles[i] < minValue || angles[i] > maxValue)
+        { return false; }
+
+        if (i > 0 && angles[i] < angles[i - 1])
+        { return false; }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      IESプロファイルを解析します.
+//-----------------------------------------------------------------------------
+IES_PARSE_ERROR Parse(Tokenizer& tokenizer, Lamp& lamp)
+{
+    const char* pLine  = nullptr;
+    size_t      length = 0;
+
+    // フォーマット判定. LM-63-1986 はヘッダ行が無いので，1行目から TILT= を探す.
+    if (!tokenizer.NextLine(pLine, length))
+    { return IES_PARSE_TILT_NOT_FOUND; }
+
+    lamp.Format = IES_FORMAT_LM_63_1986;
+    if      (StartsWith(pLine, length, "IESNA:LM-63-1995")) { lamp.Format = IES_FORMAT_LM_63_1995; }
+    else if (StartsWith(pLine, length, "IESNA:LM-63-2002")) { lamp.Format = IES_FORMAT_LM_63_2002; }
+    else if (StartsWith(pLine, length, "IES:LM-63-2019"))   { lamp.Format = IES_FORMAT_LM_63_2019; }
+    else if (StartsWith(pLine, length, "IESNA91"))          { lamp.Format = IES_FORMAT_LM_63_1991; }
+
+    // キーワード行([TEST]等)を読み飛ばす.
+    while(!StartsWith(pLine, length, "TILT="))
+    {
+        if (!tokenizer.NextLine(pLine, length))
+        { return IES_PARSE_TILT_NOT_FOUND; }
+    }
+
+    // チルト情報.
+    lamp.TiltGeometry = 0;
+    lamp.TiltAngle .clear();
+    lamp.TiltFactor.clear();
+
+    auto pTilt   = pLine + 5;
+    auto tiltLen = length - 5;
+    if (StartsWith(pTilt, tiltLen, "INCLUDE"))
+    {
+        // 不正な値を読んだ直前で止めて，その行番号を返す.
+        if (tokenizer.NextInt(lamp.TiltGeometry) != IES_PARSE_OK
+         || lamp.TiltGeometry < 1 || lamp.TiltGeometry > 3)
+        { return IES_PARSE_INVALID_TILT; }
+
+        auto count = 0;
+        if (tokenizer.NextInt(count) != IES_PARSE_OK
+         || count < 1 || count > kMaxTiltCount)
+        { return IES_PARSE_INVALID_TILT; }
+
+        if (tokenizer.NextFloats(count, lamp.TiltAngle) != IES_PARSE_OK
+         || !IsValidAngles(lamp.TiltAngle, 0.0f, 180.0f))
+        { return IES_PARSE_INVALID_TILT; }
+
+        if (tokenizer.NextFloats(count, lamp.TiltFactor) != IES_PARSE_OK)
+        { return IES_PARSE_INVALID_TILT; }
+    }
+    else if (!StartsWith(pTilt, tiltLen, "NONE"))
+    {
+        // 外部チルトファイルは未対応. チルト無しとして扱う.
+        DLOG("Info : External TILT file is ignored.");
+    }
+
+    // 光源情報. 値は行をまたいでいても良い.
+    auto lampCount   = 0;
+    auto lumens      = 0.0f;
+    auto angleCountV = 0;
+    auto angleCountH = 0;
+    auto futureUse   = 0.0f;
+
+    // 最初に失敗した位置の行番号を返すため，以降の読み取りは行わない.
+    // 個数などの検証も読んだ直後に行い，不正な値がある行で止める.
+    auto err = IES_PARSE_OK;
+    auto readInt   = [&](int&   value) { if (err == IES_PARSE_OK) { err = tokenizer.NextInt  (value); } };
+    auto readFloat = [&](float& value) { if (err == IES_PARSE_OK) { err = tokenizer.NextFloat(value); } };
+    auto validate  = [&](bool valid, IES_PARSE_ERROR code) { if (err == IES_PARSE_OK && !valid) { err = code; } };
+
+    readInt  (lampCount);               // 光源数.
+    validate (lampCount >= 1, IES_PARSE_INVALID_HEADER);
+    readFloat(lumens);                  // ランプ当たりの光束.
+    readFloat(lamp.Multiplier);         // 光度の乗算係数.
+    readInt  (angleCountV);             // 垂直角の数.
+    validate (angleCountV >= 1 && angleCountV <= kMaxAngleCount, IES_PARSE_INVALID_HEADER);
+    readInt  (angleCountH);             // 水平角の数.
+    validate (angleCountH >= 1 && angleCountH <= kMaxAngleCount, IES_PARSE_INVALID_HEADER);
+    validate (size_t(angleCountV) * size_t(angleCountH) <= kMaxCandelaCount, IES_PARSE_INVALID_HEADER);
+    readInt  (lamp.PhotometricType);    // 測定座標系.
+    validate (lamp.PhotometricType >= IES_PHOTOMETRIC_TYPE_C
+           && lamp.PhotometricType <= IES_PHOTOMETRIC_TYPE_A, IES_PARSE_INVALID_HEADER);
+    validate (lamp.PhotometricType == IES_PHOTOMETRIC_TYPE_C, IES_PARSE_UNSUPPORTED);   // このサンプルではC-Planeのみ対応.
+    readInt  (lamp.UnitType);           // 器具形状の単位.
+    readFloat(lamp.ShapeWidth);         // 器具の幅.
+    readFloat(lamp.ShapeLength);        // 器具の長さ.
+    readFloat(lamp.ShapeHeight);        // 器具の高さ.
+    readFloat(lamp.BallastFactor);      // 安定器光出力係数.
+    readFloat(futureUse);               // 予約領域.
+    readFloat(lamp.InputWatts);         // 定格消費電力.
+    if (err != IES_PARSE_OK)
+    { return err; }
+
+    lamp.LampCount = lampCount;
+    lamp.Lumen     = (lumens > 0.0f) ? lumens * float(lampCount) : lumens; // -1は絶対測光.
+
+    // 角度目盛.
+    err = tokenizer.NextFloats(angleCountV, lamp.AngleV);
+    if (err != IES_PARSE_OK)
+    { return err; }
+
+    if (!IsValidAngles(lamp.AngleV, 0.0f, 180.0f))
+    { return IES_PARSE_INVALID_ANGLE; }
+
+    err = tokenizer.NextFloats(angleCountH, lamp.AngleH);
+    if (err != IES_PARSE_OK)
+    { return err; }
+
+    if (!IsValidAngles(lamp.AngleH, 0.0f, 360.0f))
+    { return IES_PARSE_INVALID_ANGLE; }
+
+    // 光度のデータ.
+    err = tokenizer.NextFloats(size_t(angleCountV) * angleCountH, lamp.Candera);
+    if (err != IES_PARSE_OK)
+    { return err; }
+
+    // 乗算係数を掛けて有限でなくなった値も不正な数値とする.
+    auto sum = 0.0;
+    for(auto& candera : lamp.Candera)
+    {
+        candera *= lamp.Multiplier;
+        if (!std::isfinite(candera))
+        { return IES_PARSE_INVALID_NUMBER; }
+
+        sum += candera;
+    }
+    lamp.AveCandera = float(sum / double(lamp.Candera.size()));
+
+    return IES_PARSE_OK;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メモリ上のIESプロファイルを解析します.
+//-----------------------------------------------------------------------------
+bool ParseIESProfile(const char* pBuffer, size_t size, Lamp& lamp, IESParseResult* pResult)
+{
+    Tokenizer tokenizer(pBuffer, (pBuffer != nullptr) ? size : 0);
+    auto err = Parse(tokenizer, lamp);
+
+    if (pResult != nullptr)
+    {
+        pResult->Error = err;
+        pResult->Line  = (err != IES_PARSE_OK) ? tokenizer.GetLine() : 0;
+    }
+
+    return err == IES_PARSE_OK;
+}
+
+//-----------------------------------------------------------------------------
+//      IESプロファイルをロードします.
+//-----------------------------------------------------------------------------
+bool LoadIESProfile(const char* path, Lamp& lamp, IESParseResult* pResult)
+{
+    MappedFile file;
+    if (path == nullptr || !file.Map(path))
+    {
+        if (pResult != nullptr)
+        {
+            pResult->Error = IES_PARSE_FILE_OPEN_FAILED;
+            pResult->Line  = 0;
+        }
+
+        ELOG("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    IESParseResult result;
+    if (!ParseIESProfile(file.GetData(), file.GetSize(), lamp, &result))
+    {
+        ELOG("Error : Invalid IES Profile. path = %s, line = %u, error = %s", path, result.Line, ToString(result.Error));
+    }
+
+    if (pResult != nullptr)
+    { *pResult = result; }
+
+    return result.Error == IES_PARSE_OK;
+}
+
+//-----------------------------------------------------------------------------
+//      複数のIESプロファイルを並列にロードします.
+//-----------------------------------------------------------------------------
+uint32_t LoadIESProfiles
+(
+    const std::vector<std::string>& paths,
+    std::vector<Lamp>&              lamps,
+    std::vector<IESParseResult>&    results,
+    uint32_t                        threadCount
+)
+{
+    auto count = uint32_t(paths.size());
+
+    // 結果は入力と同じ並びで連続領域に格納する.
+    lamps  .clear();
+    results.clear();
+    lamps  .resize(count);
+    results.resize(count);
+
+    if (threadCount == 0)
+    { threadCount = std::max(std::thread::hardware_concurrency(), 1u); }
+    threadCount = std::min(threadCount, count);
+
+    std::atomic<uint32_t> next(0);
+    std::atomic<uint32_t> succeeded(0);
+    auto worker = [&]()
+    {
+        for(;;)
+        {
+            auto i = next.fetch_add(1);
+            if (i >= count)
+            { break; }
+
+            if (LoadIESProfile(paths[i].c_str(), lamps[i], &results[i]))
+            { succeeded++; }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(auto i=1u; i<threadCount; ++i)
+    { threads.emplace_back(worker); }
+
+    worker();
+
+    for(auto& thread : threads)
+    { thread.join(); }
+
+    return succeeded;
+}
+
+//-----------------------------------------------------------------------------
+//      エラーコードを文字列に変換します.
+//-----------------------------------------------------------------------------
+const char* ToString(IES_PARSE_ERROR error)
+{
+    switch(error)
+    {
+    case IES_PARSE_OK:                  return "OK";
+    case IES_PARSE_FILE_OPEN_FAILED:    return "File Open Failed";
+    case IES_PARSE_TILT_NOT_FOUND:      return "TILT Not Found";
+    case IES_PARSE_UNEXPECTED_EOF:      return "Unexpected EOF";
+    case IES_PARSE_INVALID_NUMBER:      return "Invalid Number";
+    case IES_PARSE_INVALID_TILT:        return "Invalid TILT";
+    case IES_PARSE_INVALID_HEADER:      return "Invalid Header";
+    case IES_PARSE_INVALID_ANGLE:       return "Invalid Angle";
+    case IES_PARSE_UNSUPPORTED:         return "Out of support";
+    default:                            return "Unknown";
+    }
+}
@@ -8,285 +8,9 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <IESProfile.h>
+#include <IESBaker.h>
 #include <vector>
-#include <fstream>
 #include <Logger.h>
-#include <DirectXMath.h>
-
-
-namespace {
-
-//-----------------------------------------------------------------------------
-// Constant Values.
-//-----------------------------------------------------------------------------
-constexpr int TypeC = 1;        // C-Plane
-constexpr int TypeB = 2;        // B-Plane
-constexpr int TypeA = 3;        // A-Plane
-
-constexpr int UnitFeet  = 1;    // フィート単位[ft]
-constexpr int UnitMeter = 2;    // メートル単位[m]
-
-
-///////////////////////////////////////////////////////////////////////////////
-// Lamp structure
-///////////////////////////////////////////////////////////////////////////////
-struct Lamp
-{
-    float               Lumen;          //!< 光束
-    float               Multiplier;     //!< 乗算係数.
-    int                 PhotometricType;//!< フォトメトリックタイプ(1:C-Plane, 2:B-Plane, 3:A-Plane).
-    int                 UnitType;       //!< 単位(1:フィート, 2:メートル).
-    float               ShapeWidth;     //!< 形状横幅.
-    float               ShapeLength;    //!< 形状奥行き.
-    float               ShapeHeight;    //!< 形状高さ.
-    float               BallastFactor;  //!< 安定器光出力係数.
-    float               InputWatts;     //!< 入力ワット数.
-    std::vector<float>  AngleV;         //!< 垂直角.
-    std::vector<float>  AngleH;         //!< 水平角.
-    std::vector<float>  Candera;        //!< カンデラ値.
-    float               AveCandera;     //!< カンデラの平均値.
-};
-
-//-----------------------------------------------------------------------------
-//      線形補間を行います.
-//-----------------------------------------------------------------------------
-inline float Lerp(float a, float b, float t)
-{ return a + (b - a) * t; }
-
-//-----------------------------------------------------------------------------
-//      インデックスを浮動小数で求めます.
-//-----------------------------------------------------------------------------
-float GetPos(float value, const std::vector<float>& container)
-{
-    if (container.size() == 1)
-    { return container.front(); }
-
-    if (value < container.front())
-    { return -1.0f; }
-
-    if (value > container.back())
-    { return -1.0f; }
-
-    size_t lhs = 0;
-    size_t rhs = container.size() - 1;
-
-    // 2分探索.
-    while (lhs < rhs)
-    {
-        auto pivot = (lhs + rhs + 1) / 2;
-        auto temp = container[pivot];
-
-        if (value >= temp)
-        { lhs = pivot; }
-        else
-        { rhs = pivot - 1; }
-    }
-
-    auto t = 0.0f;
-    if (lhs + 1 < container.size())
-    {
-        auto left  = container[lhs + 0];
-        auto right = container[lhs + 1];
-        auto delta = right - left;
-
-        if (delta > 1e-5f)
-        { t = (value - left) / delta; }
-    }
-
-    return float(lhs) + t;
-}
-
-//-----------------------------------------------------------------------------
-//      IESプロファイルをロードします.
-//-----------------------------------------------------------------------------
-bool LoadIESProfile(const char* path, Lamp& lamp)
-{
-    std::ifstream stream;
-
-    stream.open( path, std::ios::in );
-
-    if (!stream.is_open())
-    {
-        ELOG("Error : File Open Failed. path = %s", path);
-        return false;
-    }
-
-    const std::streamsize BufferSize = 2048;
-    char buf[BufferSize] = {};
-
-    stream >> buf;
-
-    // 判定文字列になっているかどうか確認.
-    if (0 != strcmp(buf, "IESNA:LM-63-2002") &&
-        0 != strcmp(buf, "IESNA:LM-63-1995"))
-    {
-        ELOG("Error : Invalid IES Profile.");
-        stream.close();
-        return false;
-    }
-
-
-    for(;;)
-    {
-        if (!stream)
-        { break; }
-
-        if (stream.eof())
-        { break; }
-
-        stream >> buf;
-
-        // チルト角情報が出てきたら解析する.
-        if (0 == strcmp(buf, "TILT=NONE"))
-        {
-            // TILEで始まる行を読み飛ばす.
-            stream.ignore( BufferSize, '\n' );
-            
-            // 光源数を取得.
-            int lampCount = 0;
-            stream >> lampCount;
-
-            // このサンプルでは１つの光源のみ対応.
-            if (lampCount != 1)
-            {
-                ELOG("Error : Lamp count is %d.", lampCount);
-                stream.close();
-                return false;
-            }
-
-            int angleCountV = 0;
-            int angleCountH = 0;
-            int futureUse   = 0;
-
-            stream >> lamp.Lumen;       // 光度値
-            stream >> lamp.Multiplier;  // 光度の種類.
-            stream >> angleCountV;      // 垂直角の数.
-            stream >> angleCountH;      // 水平角の数.
-
-            // メモリを予約.
-            lamp.AngleV .reserve(angleCountV);
-            lamp.AngleH .reserve(angleCountH);
-            lamp.Candera.reserve(angleCountV * angleCountH);
-
-            stream >> lamp.PhotometricType;     // 測定座標系.
-            if (lamp.PhotometricType != TypeC)
-            {
-                ELOG("Error : Out of support.");
-                stream.close();
-                return false;
-            }
-
-            stream >> lamp.UnitType;            // 器具形状の単位.
-            stream >> lamp.ShapeWidth;          // 器具の幅.
-            stream >> lamp.ShapeLength;         // 器具の長さ.
-            stream >> lamp.ShapeHeight;         // 器具の高さ.
-            stream >> lamp.BallastFactor;       // 安定器光出力係数.
-            stream >> futureUse;                // 予約領域.
-            stream >> lamp.InputWatts;          // 定格消費電力.
-
-            // 改行まで読み飛ばす.
-            stream.ignore( BufferSize, '\n' );
-
-            float value = 0.0f;
-
-            // 垂直角の角度目盛.
-            for(auto i=0; i<angleCountV; ++i)
-            {
-                stream >> value;
-                lamp.AngleV.push_back(value);
-            }
-
-            // 水平角の角度目盛.
-            for(auto i=0; i<angleCountH; ++i)
-            {
-                stream >> value;
-                lamp.AngleH.push_back(value);
-            }
-
-            // 平均値を初期化.
-            lamp.AveCandera = 0.0f;
-            auto count = 0;
-
-            // 光度のデータ.
-            for(auto i=0; i<angleCountH; ++i)
-            {
-                for(auto j=0; j<angleCountV; ++j)
-                {
-                    stream >> value;
-                    auto candera = value * lamp.Multiplier;
-                    lamp.Candera.push_back(candera);
-                    lamp.AveCandera += candera;
-                    count++;
-                }
-            }
-
-            lamp.AveCandera /= float(count);
-        }
-
-        // 改行まで読み飛ばす.
-        stream.ignore( BufferSize, '\n' );
-    }
-
-    // ストリームを閉じる.
-    stream.close();
-
-    // 正常終了.
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-//      カンデラ値を取得します.
-//-----------------------------------------------------------------------------
-float GetCandera(int x, int y, const Lamp& lamp)
-{
-    auto w = int(lamp.AngleV.size());
-    auto h = int(lamp.AngleH.size());
-
-    x %= w;
-    y %= h;
-
-    auto idx = w * y + x;
-    assert(idx < lamp.Candera.size());
-
-    return lamp.Candera[idx];
-}
-
-//-----------------------------------------------------------------------------
-//      バイリニアサンプリングします.
-//-----------------------------------------------------------------------------
-float BilinearSample(float x, float y, const Lamp& lamp)
-{
-    auto x0 = int(floor(x));
-    auto y0 = int(floor(y));
-
-    auto x1 = x0 + 1;
-    auto y1 = y0 + 1;
-
-    return (x1 - x) * ( (y1 - y) * GetCandera(x0, y0, lamp) + (y - y0) * GetCandera(x0, y1, lamp) )
-         + (x - x0) * ( (y1 - y) * GetCandera(x1, y0, lamp) + (y - y0) * GetCandera(x1, y1, lamp) );
-}
-
-//-----------------------------------------------------------------------------
-//      補間したカンデラ値を取得します.
-//-----------------------------------------------------------------------------
-float Interpolate(float angleV, float angleH, const Lamp& lamp)
-{
-    // 最大範囲でチェック.
-    assert(0 <= angleV && angleV <= 180.0f);
-    assert(0 <= angleH && angleH <= 360.0f);
-
-    // インデックスを浮動小数で取得.
-    auto s = GetPos(angleV, lamp.AngleV);
-    auto t = GetPos(angleH, lamp.AngleH);
-
-    if (s < 0.0f || t < 0.0f)
-    { return 0.0f; }
-
-    // バイリニアサンプリング.
-    return BilinearSample(s, t, lamp);
-}
-
-} // namespace 
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -332,29 +56,11 @@ bool IESProfile::Init
         return false;
     }
 
-    auto size = 128;
-    size = DirectX::XMMax(size, int(lamp.AngleV.size()));
-    size = DirectX::XMMax(size, int(lamp.AngleH.size()));
-
-    auto find = false;
-
     // 128pxから2次元テクスチャ最大値までの範囲で近いべき乗を求める.
-    for (int i=7; i<=D3D12_MAX_TEXTURE_DIMENSION_2_TO_EXP; ++i)
-    {
-        auto lhs = exp2(i - 1);
-        auto rhs = exp2(i);
-
-        // 範囲内に収まっているかチェック.
-        if (lhs < size && size <= rhs)
-        {
-            size = int(rhs);
-            find = true;
-            break;
-        }
-    }
+    auto size = GetIESTextureSize(lamp);
 
     // サポート範囲外のサイズはエラーとする.
-    if (!find)
+    if (size == 0)
     {
         ELOG("Error : Out of support.");
         return false;
@@ -363,41 +69,14 @@ bool IESProfile::Init
     auto w = size;
     auto h = size;
 
-    m_Candera.clear();
+    m_Candera.resize(size_t(w) * h);
     m_Candera.shrink_to_fit();
-    m_Candera.reserve(w * h);
-
-    auto invW = 1.0f / float(w);
-    auto invH = 1.0f / float(h);
-    auto invA = 1.0f / lamp.AveCandera;
 
-    auto lastH = lamp.AngleH.back();
-    auto lastV = int(lamp.AngleV.back());
-
-    for(auto j=0; j<h; ++j)
+    // カンデラ値をテクスチャに焼き込む.
+    if (!BakeIESCandela(lamp, w, h, m_Candera.data(), w))
     {
-        // Φは[0, 2π]の範囲.
-        auto angleH = 0.0f;
-
-        if (lastH > 0.0f)
-        {
-            angleH = j * invH * 360.0f;
-            angleH = fmod(angleH, 2.0f * lastH);
-            if (angleH > lastH)
-            { angleH = lastH * 2.0f - angleH; }
-        }
-
-        for(auto i=0; i<w; ++i)
-        {
-            // θは[0, π]の範囲.
-            auto rad = i * invW * 2.0f - 1.0f;
-            auto angleV = DirectX::XMConvertToDegrees(acos((rad)));
-
-            auto cd = invA * Interpolate(angleV, angleH, lamp);
-
-            // データ格納.
-            m_Candera.push_back(cd);
-        }
+        ELOG("Error : BakeIESCandela() Failed.");
+        return false;
     }
 
     m_Lumen = lamp.Lumen;
@@ -0,0 +1,319 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchIESLoad.cpp
+// Desc : IES Profile Bulk Load Benchmarks.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include <IESLamp.h>
+#include <Logger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const float kPi = 3.14159265358979f;
+
+///////////////////////////////////////////////////////////////////////////////
+// BenchContext structure
+///////////////////////////////////////////////////////////////////////////////
+struct BenchContext
+{
+    uint32_t    Samples = 3;        //!< サンプル数.
+    bool        Quick   = false;    //!< 短縮実行.
+    int         Result  = 0;        //!< 終了コード.
+};
+
+//-----------------------------------------------------------------------------
+//      処理時間の中央値をミリ秒で計測します.
+//-----------------------------------------------------------------------------
+double MeasureMs(uint32_t samples, const std::function<bool()>& func)
+{
+    // 1回目はファイルキャッシュを温めるだけ.
+    if (!func())
+    { return -1.0; }
+
+    std::vector<double> times(samples);
+    for(auto& time : times)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+//-----------------------------------------------------------------------------
+//      計測結果を表示します.
+//-----------------------------------------------------------------------------
+void Report(BenchContext& context, const char* name, double files, double bytes, const std::function<bool()>& func)
+{
+    auto ms = MeasureMs(context.Samples, func);
+    if (ms < 0.0)
+    {
+        ELOG("Error : %s Failed.", name);
+        context.Result = 1;
+        return;
+    }
+
+    printf("%-36s %10.3f ms %10.1f files/s %8.1f MB/s\n",
+        name, ms, files / (ms * 1e-3), bytes / (ms * 1e3));
+    fflush(stdout);
+}
+
+//-----------------------------------------------------------------------------
+//      検証に失敗したら終了コードを設定します.
+//-----------------------------------------------------------------------------
+void Check(BenchContext& context, bool condition, const char* message)
+{
+    if (condition)
+    { return; }
+
+    ELOG("Error : %s", message);
+    context.Result = 1;
+}
+
+//-----------------------------------------------------------------------------
+//      配光データを生成して書き出します.
+//-----------------------------------------------------------------------------
+bool WriteProfile(const std::string& path, uint32_t index, int countV, int countH)
+{
+    auto pFile = fopen(path.c_str(), "wb");
+    if (pFile == nullptr)
+    {
+        ELOG("Error : File Open Failed. path = %s", path.c_str());
+        return false;
+    }
+
+    fprintf(pFile, "IESNA:LM-63-2002\n");
+    fprintf(pFile, "[TEST] BENCH-%05u\n", index);
+    fprintf(pFile, "[MANUFAC] PHOTOMETRIC LIGHT SAMPLE\n");
+    fprintf(pFile, "TILT=NONE\n");
+    fprintf(pFile, "1 %u 1 %d %d 1 2 0.3 0.3 0.1\n", 1000 + index, countV, countH);
+    fprintf(pFile, "1.0 1.0 40\n");
+
+    // 実在のファイルと同じく1行10値で折り返す.
+    auto writeValues = [&](int count, const std::function<float(int)>& func)
+    {
+        for(auto i=0; i<count; ++i)
+        { fprintf(pFile, "%.2f%c", func(i), (i % 10 == 9 || i + 1 == count) ? '\n' : ' '); }
+    };
+
+    writeValues(countV, [&](int i) { return 180.0f * float(i) / float(countV - 1); });
+    writeValues(countH, [&](int i) { return 360.0f * float(i) / float(countH - 1); });
+
+    // 水平角毎に向きの変わる非対称な配光.
+    auto sharpness = 1.0f + float(index % 7);
+    writeValues(countV * countH, [&](int i)
+    {
+        auto theta = kPi * float(i % countV) / float(countV - 1);
+        auto phi   = 2.0f * kPi * float(i / countV) / float(countH - 1);
+        auto lobe  = std::max(0.0f, cosf(theta)) * (0.75f + 0.25f * cosf(phi));
+        return 1500.0f * powf(lobe, sharpness) + 20.0f;
+    });
+
+    fclose(pFile);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ifstream で1値ずつ読み込みます(以前の LoadIESProfile の読み方).
+//-----------------------------------------------------------------------------
+bool LoadIESProfileStream(const char* path, Lamp& lamp)
+{
+    std::ifstream stream(path, std::ios::in);
+    if (!stream.is_open())
+    { return false; }
+
+    const std::streamsize BufferSize = 2048;
+    char buf[BufferSize] = {};
+
+    stream >> buf;
+    if (0 != strcmp(buf, "IESNA:LM-63-2002") && 0 != strcmp(buf, "IESNA:LM-63-1995"))
+    { return false; }
+
+    // TILT=NONE まで読み飛ばす.
+    while(stream >> buf)
+    {
+        if (0 == strcmp(buf, "TILT=NONE"))
+        { break; }
+    }
+
+    // 以前は予約領域を int で読んでいたが, "1.0" で読み取りが止まらないよう float にする.
+    int   angleCountV = 0;
+    int   angleCountH = 0;
+    float futureUse   = 0.0f;
+
+    stream >> lamp.LampCount;
+    stream >> lamp.Lumen;
+    stream >> lamp.Multiplier;
+    stream >> angleCountV;
+    stream >> angleCountH;
+    stream >> lamp.PhotometricType;
+    stream >> lamp.UnitType;
+    stream >> lamp.ShapeWidth;
+    stream >> lamp.ShapeLength;
+    stream >> lamp.ShapeHeight;
+    stream >> lamp.BallastFactor;
+    stream >> futureUse;
+    stream >> lamp.InputWatts;
+
+    lamp.AngleV .clear();
+    lamp.AngleH .clear();
+    lamp.Candera.clear();
+    lamp.AngleV .reserve(angleCountV);
+    lamp.AngleH .reserve(angleCountH);
+    lamp.Candera.reserve(size_t(angleCountV) * angleCountH);
+
+    float value = 0.0f;
+    for(auto i=0; i<angleCountV; ++i)
+    {
+        stream >> value;
+        lamp.AngleV.push_back(value);
+    }
+
+    for(auto i=0; i<angleCountH; ++i)
+    {
+        stream >> value;
+        lamp.AngleH.push_back(value);
+    }
+
+    auto sum = 0.0;
+    for(auto i=0; i<angleCountV * angleCountH; ++i)
+    {
+        stream >> value;
+        lamp.Candera.push_back(value * lamp.Multiplier);
+        sum += lamp.Candera.back();
+    }
+    lamp.AveCandera = float(sum / double(lamp.Candera.size()));
+
+    return !stream.fail();
+}
+
+//-----------------------------------------------------------------------------
+//      2つの光源データが一致するかチェックします.
+//-----------------------------------------------------------------------------
+bool IsSameLamp(const Lamp& lhs, const Lamp& rhs)
+{
+    return lhs.AngleV     == rhs.AngleV
+        && lhs.AngleH     == rhs.AngleH
+        && lhs.Candera    == rhs.Candera
+        && lhs.InputWatts == rhs.InputWatts;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    BenchContext context;
+    for(auto i=1; i<argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+        { context.Quick = true; context.Samples = 1; }
+        else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+        { context.Samples = std::max(1, atoi(argv[++i])); }
+        else
+        {
+            printf("Usage : %s [--quick] [--samples <count>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // 実在の高解像度な配光データ(水平 5 度刻み, 垂直 1 度刻み)と同じ大きさで, 大量のファイルを読む.
+    const uint32_t fileCount = context.Quick ? 16 : 3000;
+    const int      countV    = context.Quick ? 37 : 181;
+    const int      countH    = context.Quick ? 13 : 73;
+
+    const std::filesystem::path kDir = "bench_ies";
+    std::filesystem::create_directories(kDir);
+
+    std::vector<std::string> paths;
+    double bytes = 0.0;
+    for(auto i=0u; i<fileCount; ++i)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "lamp_%05u.ies", i);
+        paths.push_back((kDir / name).string());
+
+        if (!WriteProfile(paths.back(), i, countV, countH))
+        {
+            Check(context, false, "WriteProfile() Failed.");
+            break;
+        }
+        bytes += double(std::filesystem::file_size(paths.back()));
+    }
+
+    printf("input : %u files, %d x %d, %.1f MB\n", fileCount, countV, countH, bytes * 1e-6);
+
+    auto files = double(fileCount);
+
+    // 以前の ifstream による読み込み.
+    std::vector<Lamp> baseline(fileCount);
+    Report(context, "ifstream(Threads=1)", files, bytes, [&]()
+    {
+        for(auto i=0u; i<fileCount; ++i)
+        {
+            if (!LoadIESProfileStream(paths[i].c_str(), baseline[i]))
+            { return false; }
+        }
+        return true;
+    });
+
+    // 1ファイルずつのロード.
+    std::vector<Lamp> sequential(fileCount);
+    Report(context, "LoadIESProfile(Threads=1)", files, bytes, [&]()
+    {
+        for(auto i=0u; i<fileCount; ++i)
+        {
+            if (!LoadIESProfile(paths[i].c_str(), sequential[i]))
+            { return false; }
+        }
+        return true;
+    });
+
+    // 一括ロード.
+    std::vector<Lamp>           lamps;
+    std::vector<IESParseResult> results;
+    Report(context, "LoadIESProfiles(Threads=1)", files, bytes, [&]()
+    { return LoadIESProfiles(paths, lamps, results, 1) == fileCount; });
+
+    std::vector<Lamp> single = lamps;
+    Report(context, "LoadIESProfiles(Threads=All)", files, bytes, [&]()
+    { return LoadIESProfiles(paths, lamps, results, 0) == fileCount; });
+
+    // 読み方やスレッド数に依らず同じ値になる.
+    auto allSame = lamps.size() == fileCount && single.size() == fileCount;
+    for(auto i=0u; i<fileCount && allSame; ++i)
+    {
+        allSame = results[i].Error == IES_PARSE_OK
+               && lamps[i].Candera.size() == size_t(countV) * countH
+               && IsSameLamp(lamps[i], single[i])
+               && IsSameLamp(lamps[i], sequential[i])
+               && IsSameLamp(lamps[i], baseline[i]);
+    }
+    Check(context, allSame, "Loaded Lamps Mismatch.");
+
+    std::filesystem::remove_all(kDir);
+    return context.Result;
+}
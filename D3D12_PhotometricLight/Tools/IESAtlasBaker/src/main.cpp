@@ -0,0 +1,178 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : IES Atlas Baker Main Entry Point.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <IESLamp.h>
+#include <IESBaker.h>
+#include <Logger.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      使い方を表示します.
+//-----------------------------------------------------------------------------
+void PrintUsage()
+{
+    printf("Usage : IESAtlasBaker [options] <input dir> <output file>\n");
+    printf("  -1d           pack each profile into one row (horizontal angles averaged)\n");
+    printf("  -size <N>     tile width in texels (default: largest profile size)\n");
+    printf("  -j <N>        worker threads (default: hardware concurrency)\n");
+}
+
+//-----------------------------------------------------------------------------
+//      拡張子が .ies かどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsIESFile(const std::filesystem::path& path)
+{
+    auto ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return char(tolower(c)); });
+    return ext == ".ies";
+}
+
+//-----------------------------------------------------------------------------
+//      経過時間をミリ秒で取得します.
+//-----------------------------------------------------------------------------
+double GetElapsedMs(const std::chrono::steady_clock::time_point& start)
+{ return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); }
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    auto mode        = IES_ATLAS_2D;
+    auto tileSize    = 0u;
+    auto threadCount = 0u;
+
+    std::vector<const char*> args;
+    for(auto i=1; i<argc; ++i)
+    {
+        if (strcmp(argv[i], "-1d") == 0)
+        { mode = IES_ATLAS_1D; }
+        else if (strcmp(argv[i], "-size") == 0 && i + 1 < argc)
+        { tileSize = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        { threadCount = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (argv[i][0] == '-')
+        {
+            PrintUsage();
+            return -1;
+        }
+        else
+        { args.push_back(argv[i]); }
+    }
+
+    if (args.size() != 2)
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    // 入力ファイルを列挙. 出力が実行毎に変わらないように名前順に並べる.
+    std::vector<std::filesystem::path> paths;
+    {
+        std::error_code err;
+        for(const auto& entry : std::filesystem::directory_iterator(args[0], err))
+        {
+            if (entry.is_regular_file() && IsIESFile(entry.path()))
+            { paths.push_back(entry.path()); }
+        }
+
+        if (err)
+        {
+            ELOG("Error : Directory Open Failed. path = %s", args[0]);
+            return -1;
+        }
+
+        std::sort(paths.begin(), paths.end());
+    }
+
+    if (paths.empty())
+    {
+        ELOG("Error : IES File Not Found. path = %s", args[0]);
+        return -1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // 並列に読み込み. 読めなかったファイルはスキップする.
+    std::vector<Lamp>        lamps;
+    std::vector<std::string> names;
+    {
+        std::vector<std::string> files;
+        files.reserve(paths.size());
+        for(const auto& path : paths)
+        { files.push_back(path.string()); }
+
+        std::vector<Lamp>           loaded;
+        std::vector<IESParseResult> results;
+        LoadIESProfiles(files, loaded, results, threadCount);
+
+        lamps.reserve(loaded.size());
+        names.reserve(loaded.size());
+        for(size_t i=0; i<loaded.size(); ++i)
+        {
+            if (results[i].Error != IES_PARSE_OK)
+                continue;
+
+            lamps.push_back(std::move(loaded[i]));
+            names.push_back(paths[i].stem().string());
+        }
+    }
+
+    auto loadTime = GetElapsedMs(start);
+
+    if (lamps.empty())
+    {
+        ELOG("Error : No Valid IES Profile.");
+        return -1;
+    }
+
+    // アトラス生成.
+    start = std::chrono::steady_clock::now();
+
+    IESAtlas atlas = {};
+    if (!BuildIESAtlas(lamps, mode, tileSize, atlas, threadCount))
+    {
+        ELOG("Error : BuildIESAtlas() Failed.");
+        return -1;
+    }
+    atlas.Names = std::move(names);
+
+    auto bakeTime = GetElapsedMs(start);
+
+    if (!SaveIESAtlas(args[1], atlas))
+    {
+        ELOG("Error : SaveIESAtlas() Failed. path = %s", args[1]);
+        return -1;
+    }
+
+    printf("profiles : %zu / %zu\n", lamps.size(), paths.size());
+    printf("atlas    : %u x %u (%s, tile %u)\n",
+        atlas.Width, atlas.Height,
+        (mode == IES_ATLAS_1D) ? "1D" : "2D",
+        atlas.Entries.front().Width);
+    printf("load     : %.2f ms\n", loadTime);
+    printf("bake     : %.2f ms\n", bakeTime);
+    printf("output   : %s\n", args[1]);
+
+    return 0;
+}
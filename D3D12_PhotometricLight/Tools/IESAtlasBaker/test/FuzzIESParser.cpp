@@ -0,0 +1,606 @@
+﻿//-----------------------------------------------------------------------------
+// File : FuzzIESParser.cpp
+// Desc : IES Parser Mutation Fuzzer.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <new>
+#include <atomic>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include <IESLamp.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Global Variables.
+//-----------------------------------------------------------------------------
+thread_local bool       g_TrackAllocation = false;  // 確保サイズを記録するかどうか?
+std::atomic<size_t>     g_MaxAllocation(0);         // 記録中の最大確保サイズ.
+
+///////////////////////////////////////////////////////////////////////////////
+// TestContext structure
+///////////////////////////////////////////////////////////////////////////////
+struct TestContext
+{
+    int     Failed  = 0;    //!< 失敗数.
+    int     Passed  = 0;    //!< 成功数.
+};
+
+//-----------------------------------------------------------------------------
+//      検証結果を記録します.
+//-----------------------------------------------------------------------------
+void Check(TestContext& context, bool condition, const char* name, const char* message)
+{
+    if (condition)
+    {
+        context.Passed++;
+        return;
+    }
+
+    printf("[FAILED] %s : %s\n", name, message);
+    context.Failed++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Random class
+///////////////////////////////////////////////////////////////////////////////
+class Random
+{
+public:
+    explicit Random(uint64_t seed)
+    : m_State(seed ^ 0x9E3779B97F4A7C15ull)
+    {
+        if (m_State == 0)
+        { m_State = 1; }
+    }
+
+    uint32_t Next()
+    {
+        // xorshift64*
+        m_State ^= m_State >> 12;
+        m_State ^= m_State << 25;
+        m_State ^= m_State >> 27;
+        return uint32_t((m_State * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+
+    uint32_t Next(uint32_t range)
+    { return (range > 0) ? Next() % range : 0; }
+
+private:
+    uint64_t    m_State;
+};
+
+//-----------------------------------------------------------------------------
+//      確保サイズを記録しながら解析します.
+//-----------------------------------------------------------------------------
+bool Parse(const std::string& text, Lamp& lamp, IESParseResult& result, size_t& maxAllocation)
+{
+    // null 終端の無いぴったりのサイズでヒープに置き, 読み過ぎをサニタイザで検出できるようにする.
+    std::unique_ptr<char[]> buffer(new char[std::max<size_t>(text.size(), 1)]);
+    memcpy(buffer.get(), text.data(), text.size());
+
+    g_MaxAllocation   = 0;
+    g_TrackAllocation = true;
+    auto ret = ParseIESProfile(buffer.get(), text.size(), lamp, &result);
+    g_TrackAllocation = false;
+
+    maxAllocation = g_MaxAllocation;
+    return ret;
+}
+
+//-----------------------------------------------------------------------------
+//      行数を数えます.
+//-----------------------------------------------------------------------------
+uint32_t CountLines(const std::string& text)
+{ return 1 + uint32_t(std::count(text.begin(), text.end(), '\n')); }
+
+//-----------------------------------------------------------------------------
+//      角度が範囲内かつ昇順になっているかチェックします.
+//-----------------------------------------------------------------------------
+bool IsAscending(const std::vector<float>& angles, float maxValue)
+{
+    for(size_t i=0; i<angles.size(); ++i)
+    {
+        if (!(angles[i] >= 0.0f && angles[i] <= maxValue))
+        { return false; }
+
+        if (i > 0 && angles[i] < angles[i - 1])
+        { return false; }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      全ての値が有限かチェックします.
+//-----------------------------------------------------------------------------
+bool IsFinite(const std::vector<float>& values)
+{
+    for(auto& value : values)
+    {
+        if (!std::isfinite(value))
+        { return false; }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      解析結果が入力に対して矛盾していないかチェックします.
+//-----------------------------------------------------------------------------
+const char* Validate(const std::string& text, bool ret, const Lamp& lamp, const IESParseResult& result, size_t maxAllocation)
+{
+    // 配列は残りのバイト数に収まる個数までしか確保しない.
+    if (maxAllocation > text.size() * 2 + 16)
+    { return "allocation exceeds input size"; }
+
+    if (ret != (result.Error == IES_PARSE_OK))
+    { return "return value and error code disagree"; }
+
+    if (!ret)
+    {
+        if (result.Error == IES_PARSE_FILE_OPEN_FAILED || result.Error > IES_PARSE_UNSUPPORTED)
+        { return "unexpected error code"; }
+
+        if (result.Line < 1 || result.Line > CountLines(text))
+        { return "error line out of range"; }
+
+        return nullptr;
+    }
+
+    if (result.Line != 0)
+    { return "line set on success"; }
+
+    if (lamp.Format > IES_FORMAT_LM_63_2019 || lamp.LampCount < 1 || lamp.PhotometricType != IES_PHOTOMETRIC_TYPE_C)
+    { return "invalid header accepted"; }
+
+    if (lamp.AngleV.empty() || lamp.AngleH.empty()
+     || lamp.Candera.size() != lamp.AngleV.size() * lamp.AngleH.size())
+    { return "candela count mismatch"; }
+
+    if (lamp.TiltAngle.size() != lamp.TiltFactor.size()
+     || (lamp.TiltGeometry == 0) != lamp.TiltAngle.empty())
+    { return "tilt count mismatch"; }
+
+    if (!IsAscending(lamp.AngleV, 180.0f) || !IsAscending(lamp.AngleH, 360.0f) || !IsAscending(lamp.TiltAngle, 180.0f))
+    { return "invalid angles accepted"; }
+
+    if (!IsFinite(lamp.Candera) || !IsFinite(lamp.TiltFactor) || !std::isfinite(lamp.AveCandera))
+    { return "non-finite value accepted"; }
+
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//      再現用に入力を書き出します.
+//-----------------------------------------------------------------------------
+void Dump(const std::string& text, const char* name)
+{
+    auto path = std::string("fuzz_failure_") + name + ".ies";
+    auto pFile = fopen(path.c_str(), "wb");
+    if (pFile == nullptr)
+    { return; }
+
+    fwrite(text.data(), 1, text.size(), pFile);
+    fclose(pFile);
+    printf("    input : %s\n", path.c_str());
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルを読み込みます.
+//-----------------------------------------------------------------------------
+bool ReadFile(const std::filesystem::path& path, std::string& text)
+{
+    auto pFile = fopen(path.string().c_str(), "rb");
+    if (pFile == nullptr)
+    { return false; }
+
+    char buffer[4096];
+    size_t size = 0;
+    text.clear();
+    while((size = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+    { text.append(buffer, size); }
+
+    fclose(pFile);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      指定行を置き換えます. pText が nullptr の場合は行を削除します.
+//-----------------------------------------------------------------------------
+std::string ReplaceLine(const char* pBase, uint32_t line, const char* pText)
+{
+    std::string result;
+    auto current = 1u;
+    for(auto p = pBase; *p != '\0'; )
+    {
+        auto end = strchr(p, '\n');
+        auto length = (end != nullptr) ? size_t(end - p) + 1 : strlen(p);
+
+        if (current != line)
+        { result.append(p, length); }
+        else if (pText != nullptr)
+        {
+            result += pText;
+            result += '\n';
+        }
+
+        p += length;
+        current++;
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+
+// 行番号を数えやすいように1行に1項目ずつ並べた LM-63-2002.
+const char kBase[] =
+    "IESNA:LM-63-2002\n"                    //  1
+    "[TEST] PL-0001\n"                      //  2
+    "[MANUFAC] PHOTOMETRIC LIGHT SAMPLE\n"  //  3
+    "TILT=INCLUDE\n"                        //  4
+    "1\n"                                   //  5 ランプと器具の配置.
+    "7\n"                                   //  6 チルト角の数.
+    "0 15 30 45 60 75 90\n"                 //  7 チルト角.
+    "1.0 0.98 0.95 0.9 0.84 0.77 0.7\n"     //  8 光束係数.
+    "1 1000 1 5 3 1 2 0.3 0.3 0.1\n"        //  9 光源数～器具の高さ.
+    "1.0 1.0 40\n"                          // 10 安定器光出力係数～消費電力.
+    "0 22.5 45 67.5 90\n"                   // 11 垂直角.
+    "0 45 90\n"                             // 12 水平角.
+    "100 90 70 40 10\n"                     // 13 光度.
+    "100 88 66 38 9\n"                      // 14
+    "100 85 60 35 8\n";                     // 15
+
+///////////////////////////////////////////////////////////////////////////////
+// ErrorCase structure
+///////////////////////////////////////////////////////////////////////////////
+struct ErrorCase
+{
+    const char*     Name;       //!< ケース名.
+    uint32_t        Line;       //!< 置き換える行(0 の場合はそのまま).
+    const char*     pText;      //!< 置き換える内容(nullptr の場合は行を削除).
+    IES_PARSE_ERROR Error;      //!< 期待するエラーコード.
+    uint32_t        ErrorLine;  //!< 期待するエラー行.
+};
+
+// ファイル末尾に達した場合は, 最後の改行の次の行を返す.
+const ErrorCase kErrorCases[] = {
+    { "Valid",                  0,  nullptr,                                IES_PARSE_OK,               0  },
+    { "TiltNotFound",           4,  nullptr,                                IES_PARSE_TILT_NOT_FOUND,   15 },
+    { "TiltGeometry",           5,  "4",                                    IES_PARSE_INVALID_TILT,     5  },
+    { "TiltCountZero",          6,  "0",                                    IES_PARSE_INVALID_TILT,     6  },
+    { "TiltCountHuge",          6,  "4097",                                 IES_PARSE_INVALID_TILT,     6  },
+    { "TiltAngleOrder",         7,  "0 15 30 20 60 75 90",                  IES_PARSE_INVALID_TILT,     7  },
+    { "TiltAngleRange",         7,  "0 15 30 45 60 75 190",                 IES_PARSE_INVALID_TILT,     7  },
+    { "TiltFactorNumber",       8,  "1.0 0.98 0.95 x 0.84 0.77 0.7",        IES_PARSE_INVALID_TILT,     8  },
+    { "BadNumber",              9,  "1 1000 1 5 3 1 2 0.3 abc 0.1",         IES_PARSE_INVALID_NUMBER,   9  },
+    { "NaN",                    9,  "1 nan 1 5 3 1 2 0.3 0.3 0.1",          IES_PARSE_INVALID_NUMBER,   9  },
+    { "Overflow",               10, "1.0 1.0 1e39",                         IES_PARSE_INVALID_NUMBER,   10 },
+    { "FractionalCount",        9,  "1 1000 1 5.5 3 1 2 0.3 0.3 0.1",       IES_PARSE_INVALID_NUMBER,   9  },
+    { "LampCountZero",          9,  "0 1000 1 5 3 1 2 0.3 0.3 0.1",         IES_PARSE_INVALID_HEADER,   9  },
+    { "AngleCountZero",         9,  "1 1000 1 0 3 1 2 0.3 0.3 0.1",         IES_PARSE_INVALID_HEADER,   9  },
+    { "AngleCountHuge",         9,  "1 1000 1 65537 3 1 2 0.3 0.3 0.1",     IES_PARSE_INVALID_HEADER,   9  },
+    { "CandelaCountHuge",       9,  "1 1000 1 65536 65536 1 2 0.3 0.3 0.1", IES_PARSE_INVALID_HEADER,   9  },
+    { "PhotometricTypeB",       9,  "1 1000 1 5 3 2 2 0.3 0.3 0.1",         IES_PARSE_UNSUPPORTED,      9  },
+    { "PhotometricTypeInvalid", 9,  "1 1000 1 5 3 4 2 0.3 0.3 0.1",         IES_PARSE_INVALID_HEADER,   9  },
+    { "AngleVRange",            11, "0 22.5 45 67.5 190",                   IES_PARSE_INVALID_ANGLE,    11 },
+    { "AngleHOrder",            12, "0 90 45",                              IES_PARSE_INVALID_ANGLE,    12 },
+    { "CandelaEOF",             15, nullptr,                                IES_PARSE_UNEXPECTED_EOF,   15 },
+    { "CountBeyondEOF",         9,  "1 1000 1 5 60000 1 2 0.3 0.3 0.1",     IES_PARSE_UNEXPECTED_EOF,   16 },
+    { "CandelaNumber",          14, "100 88 -- 38 9",                       IES_PARSE_INVALID_NUMBER,   14 },
+    { "ScaledOverflow",         9,  "1 1000 1e37 5 3 1 2 0.3 0.3 0.1",      IES_PARSE_INVALID_NUMBER,   15 },
+};
+
+//-----------------------------------------------------------------------------
+//      エラーコードと行番号を確認します.
+//-----------------------------------------------------------------------------
+void TestErrorCases(TestContext& context)
+{
+    for(const auto& item : kErrorCases)
+    {
+        auto text = (item.Line > 0) ? ReplaceLine(kBase, item.Line, item.pText) : std::string(kBase);
+
+        Lamp lamp;
+        IESParseResult result;
+        size_t maxAllocation = 0;
+        auto ret = Parse(text, lamp, result, maxAllocation);
+
+        char message[256];
+        snprintf(message, sizeof(message), "expected %s at line %u, got %s at line %u",
+            ToString(item.Error), item.ErrorLine, ToString(result.Error), result.Line);
+        Check(context, result.Error == item.Error && result.Line == item.ErrorLine, item.Name, message);
+
+        auto error = Validate(text, ret, lamp, result, maxAllocation);
+        Check(context, error == nullptr, item.Name, (error != nullptr) ? error : "");
+    }
+
+    // 空のバッファ.
+    {
+        Lamp lamp;
+        IESParseResult result;
+        ParseIESProfile(nullptr, 0, lamp, &result);
+        Check(context, result.Error == IES_PARSE_TILT_NOT_FOUND && result.Line == 1, "Empty", "expected TILT Not Found at line 1");
+    }
+
+    // 正常系の値.
+    {
+        Lamp lamp;
+        IESParseResult result;
+        ParseIESProfile(kBase, strlen(kBase), lamp, &result);
+        Check(context, lamp.Format == IES_FORMAT_LM_63_2002 && lamp.TiltGeometry == 1
+            && lamp.TiltAngle.size() == 7 && lamp.TiltFactor[6] == 0.7f
+            && lamp.AngleV.size() == 5 && lamp.AngleH.size() == 3
+            && lamp.Candera.size() == 15 && lamp.Candera[14] == 8.0f
+            && lamp.InputWatts == 40.0f, "ValidValues", "parsed values mismatch");
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ファイル経由のエラーを確認します.
+//-----------------------------------------------------------------------------
+void TestLoad(TestContext& context, const std::filesystem::path& workDir)
+{
+    Lamp lamp;
+    IESParseResult result;
+
+    auto missing = (workDir / "fuzz_missing.ies").string();
+    LoadIESProfile(missing.c_str(), lamp, &result);
+    Check(context, result.Error == IES_PARSE_FILE_OPEN_FAILED && result.Line == 0, "LoadMissing", "expected File Open Failed");
+
+    // 0バイトのファイルはマップせずに解析する.
+    auto empty = (workDir / "fuzz_empty.ies").string();
+    auto pFile = fopen(empty.c_str(), "wb");
+    if (pFile != nullptr)
+    { fclose(pFile); }
+
+    LoadIESProfile(empty.c_str(), lamp, &result);
+    Check(context, result.Error == IES_PARSE_TILT_NOT_FOUND && result.Line == 1, "LoadEmpty", "expected TILT Not Found at line 1");
+    remove(empty.c_str());
+}
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const char kInterestingChars[] = " \t\r\n,+-.e0159";
+
+const char* kInterestingTokens[] = {
+    " 0 ", " -1 ", " 1.5 ", " + ", " - ", " . ", " e5 ",
+    " 4096 ", " 4097 ", " 65536 ", " 16777217 ", " 2147483648 ",
+    " 1e38 ", " 3.4e39 ", " 1e-46 ", " nan ", " inf ", " -inf ",
+    "\n", "\r\n", ",,", "\nTILT=INCLUDE\n", "\nTILT=NONE\n", "\xEF\xBB\xBF",
+};
+
+//-----------------------------------------------------------------------------
+//      入力を1回変異させます.
+//-----------------------------------------------------------------------------
+void Mutate(Random& random, std::string& text)
+{
+    auto size = uint32_t(text.size());
+    auto pos  = random.Next(size + 1);
+
+    switch(random.Next(7))
+    {
+    // 1ビット反転.
+    case 0:
+        if (size > 0)
+        { text[pos % size] ^= char(1 << random.Next(8)); }
+        break;
+
+    // 区切りや数値に使われる文字で上書き.
+    case 1:
+        if (size > 0)
+        { text[pos % size] = kInterestingChars[random.Next(sizeof(kInterestingChars) - 1)]; }
+        break;
+
+    // 範囲の削除.
+    case 2:
+        text.erase(pos, 1 + random.Next(16));
+        break;
+
+    // 範囲の複製.
+    case 3:
+        if (size > 0)
+        {
+            auto src = random.Next(size);
+            auto len = std::min(1 + random.Next(32), size - src);
+            text.insert(pos, text.substr(src, len));
+        }
+        break;
+
+    // 切り詰め.
+    case 4:
+        text.resize(pos);
+        break;
+
+    // 境界値などの挿入.
+    case 5:
+        text.insert(pos, kInterestingTokens[random.Next(uint32_t(std::size(kInterestingTokens)))]);
+        break;
+
+    // トークンを境界値で置き換え.
+    case 6:
+        {
+            auto isSeparator = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ','; };
+
+            auto begin = std::min<size_t>(pos, text.size());
+            while(begin > 0 && !isSeparator(text[begin - 1]))
+            { begin--; }
+
+            auto end = begin;
+            while(end < text.size() && !isSeparator(text[end]))
+            { end++; }
+
+            // 先頭の18個は " 値 " の形なので前後の空白を除いて使う.
+            std::string token = kInterestingTokens[random.Next(18)];
+            text.replace(begin, end - begin, token.substr(1, token.size() - 2));
+        }
+        break;
+    }
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      確保サイズを記録する operator new です.
+//-----------------------------------------------------------------------------
+void* operator new(size_t size)
+{
+    if (g_TrackAllocation)
+    {
+        auto current = g_MaxAllocation.load();
+        while(size > current && !g_MaxAllocation.compare_exchange_weak(current, size))
+        { /* DO_NOTHING */ }
+    }
+
+    auto ptr = malloc(std::max<size_t>(size, 1));
+    if (ptr == nullptr)
+    { throw std::bad_alloc(); }
+
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{ return operator new(size); }
+
+void operator delete(void* ptr) noexcept
+{ free(ptr); }
+
+void operator delete[](void* ptr) noexcept
+{ free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept
+{ free(ptr); }
+
+void operator delete[](void* ptr, size_t) noexcept
+{ free(ptr); }
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    uint32_t iterations = 100000;
+    uint64_t seed       = 1;
+
+    std::vector<std::filesystem::path> paths;
+    for(auto i=1; i<argc; ++i)
+    {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        { iterations = uint32_t(strtoul(argv[++i], nullptr, 10)); }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        { seed = strtoull(argv[++i], nullptr, 10); }
+        else if (argv[i][0] != '-')
+        { paths.push_back(argv[i]); }
+        else
+        {
+            printf("Usage : %s [--iterations <count>] [--seed <value>] <corpus file or directory>...\n", argv[0]);
+            return 1;
+        }
+    }
+
+    TestContext context;
+    TestErrorCases(context);
+    TestLoad(context, std::filesystem::temp_directory_path());
+
+    // コーパスを集める. ディレクトリは名前順に並べて実行毎の順番を揃える.
+    std::vector<std::filesystem::path> files;
+    for(auto& path : paths)
+    {
+        if (std::filesystem::is_directory(path))
+        {
+            std::vector<std::filesystem::path> entries;
+            for(auto& entry : std::filesystem::directory_iterator(path))
+            {
+                if (entry.is_regular_file())
+                { entries.push_back(entry.path()); }
+            }
+            std::sort(entries.begin(), entries.end());
+            files.insert(files.end(), entries.begin(), entries.end());
+        }
+        else
+        { files.push_back(path); }
+    }
+
+    std::vector<std::string> corpus;
+    for(auto& path : files)
+    {
+        std::string text;
+        if (!ReadFile(path, text))
+        {
+            Check(context, false, path.string().c_str(), "file open failed");
+            continue;
+        }
+
+        // 種となるファイルは正しく読めること.
+        Lamp lamp;
+        IESParseResult result;
+        size_t maxAllocation = 0;
+        auto ret = Parse(text, lamp, result, maxAllocation);
+        auto error = ret ? Validate(text, ret, lamp, result, maxAllocation) : ToString(result.Error);
+        Check(context, error == nullptr, path.string().c_str(), (error != nullptr) ? error : "");
+
+        corpus.push_back(text);
+    }
+
+    printf("corpus : %zu files, %u iterations, seed %llu\n", corpus.size(), iterations, static_cast<unsigned long long>(seed));
+
+    // 変異させた入力で, クラッシュせず矛盾の無い結果を返すことを確認する.
+    uint32_t histogram[IES_PARSE_UNSUPPORTED + 1] = {};
+    uint32_t mutationFailed = 0;
+
+    Random random(seed);
+    for(auto i=0u; i<iterations && !corpus.empty(); ++i)
+    {
+        auto text  = corpus[random.Next(uint32_t(corpus.size()))];
+        auto count = 1 + random.Next(4);
+        for(auto j=0u; j<count; ++j)
+        { Mutate(random, text); }
+
+        Lamp lamp;
+        IESParseResult result;
+        size_t maxAllocation = 0;
+        auto ret = Parse(text, lamp, result, maxAllocation);
+
+        if (result.Error <= IES_PARSE_UNSUPPORTED)
+        { histogram[result.Error]++; }
+
+        auto error = Validate(text, ret, lamp, result, maxAllocation);
+        if (error != nullptr)
+        {
+            // 同じ原因で大量に出力しないよう, 最初の数件だけ書き出す.
+            if (mutationFailed < 8)
+            {
+                char name[32];
+                snprintf(name, sizeof(name), "%u", i);
+                printf("[FAILED] Mutation %u : %s (error = %s, line = %u)\n", i, error, ToString(result.Error), result.Line);
+                Dump(text, name);
+            }
+            mutationFailed++;
+        }
+    }
+
+    for(auto i=0u; i<=IES_PARSE_UNSUPPORTED; ++i)
+    { printf("    %-20s %8u\n", ToString(IES_PARSE_ERROR(i)), histogram[i]); }
+
+    Check(context, mutationFailed == 0, "Mutation", "inconsistent result");
+
+    printf("%d passed, %d failed\n", context.Passed, context.Failed);
+    return (context.Failed == 0) ? 0 : 1;
+}
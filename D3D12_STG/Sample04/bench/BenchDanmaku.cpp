@@ -0,0 +1,276 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchDanmaku.cpp
+// Desc : Danmaku VM Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <Danmaku.h>
+#include <Bullet.h>
+#include <SpriteData.h>
+#include <Simulation.h>
+#include "BenchSTG.h"
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const uint32_t kMaxBulletCount = 65536;
+
+// 60 ティック毎に1発だけ狙い撃つ. ほとんどのティックは wait だけを実行する.
+const char* kSwarmSource = R"(
+    sprite      LASER_BLUE08
+    scale       0.5
+    speed       3
+loop:
+    aim
+    nway        1, 0
+    wait        60
+    jump        loop
+)";
+
+// 6 ティック毎に 8 方向へ発射する渦巻弾.
+const char* kSpiralSource = R"(
+    sprite      LASER_RED08
+    scale       0.5
+    speed       4
+loop:
+    ring        8
+    turn        7
+    wait        6
+    jump        loop
+)";
+
+// repeat / next を含む 5-way 弾.
+const char* kDirSource = R"(
+    sprite      LASER_BLUE08   ; 青
+    scale       0.5
+    speed       5
+    angle       90
+loop:
+    repeat      3
+    nway        5, 60
+    wait        20
+    next
+    wait        60
+    jump        loop
+)";
+
+///////////////////////////////////////////////////////////////////////////////
+// UpdateCase structure
+///////////////////////////////////////////////////////////////////////////////
+struct UpdateCase
+{
+    const char*     Name;           //!< ベンチマーク名.
+    const char*     Source;         //!< 発弾プログラム.
+    uint32_t        EmitterCount;   //!< 発射体数.
+    uint32_t        Interval;       //!< 発射間隔[tick].
+    uint32_t        BulletPerShot;  //!< 1回の発射で生成する弾数.
+};
+
+//-----------------------------------------------------------------------------
+//      シンボルを定義したアセンブラを準備します.
+//-----------------------------------------------------------------------------
+void SetupAssembler(DanmakuAssembler& assembler)
+{
+    assembler.DefineSymbol("LASER_RED08",   LASER_RED08);
+    assembler.DefineSymbol("LASER_BLUE08",  LASER_BLUE08);
+    assembler.DefineSymbol("LASER_GREEN08", LASER_GREEN08);
+}
+
+//-----------------------------------------------------------------------------
+//      不正なプログラムが拒否されることを確認します.
+//-----------------------------------------------------------------------------
+void CheckRejects(BenchContext& context, const DanmakuAssembler& assembler)
+{
+    struct Invalid
+    {
+        const char* Name;
+        const char* Source;
+    };
+    const Invalid kInvalids[] = {
+        { "unknown_op",       "    fire 3\n" },
+        { "undefined_label",  "    jump nowhere\n" },
+        { "undefined_symbol", "    sprite LASER_PURPLE99\n" },
+        { "missing_operand",  "    nway 3\n" },
+        { "next_only",        "    next\n" },
+        { "open_repeat",      "    repeat 2\n    wait 1\n" },
+        { "deep_repeat",      "    repeat 2\n    repeat 2\n    repeat 2\n    repeat 2\n    repeat 2\n"
+                              "    wait 1\n    next\n    next\n    next\n    next\n    next\n" },
+    };
+
+    // エラーログが大量に出るので, 件数だけ表示する.
+    auto rejected = 0u;
+    for(const auto& item : kInvalids)
+    {
+        DanmakuProgram program;
+        if (!assembler.Assemble(item.Name, item.Source, program))
+        { rejected++; }
+        else
+        { ELOGA("Error : Invalid Program Accepted. name = %s", item.Name); }
+    }
+
+    printf("    rejected %u / %u invalid programs\n", rejected, uint32_t(_countof(kInvalids)));
+    Check(context, rejected == _countof(kInvalids), "DanmakuAssembler Accepted Invalid Program.");
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      弾幕VMのベンチマークを実行します.
+//-----------------------------------------------------------------------------
+void BenchDanmaku(BenchContext& context)
+{
+    DanmakuAssembler assembler;
+    SetupAssembler(assembler);
+
+    // テキストからのアセンブル.
+    {
+        const char* kSources[] = { kSwarmSource, kSpiralSource, kDirSource };
+        const uint32_t count = context.Quick ? 256 : 4096;
+
+        Report(context, "Danmaku/Assemble", double(count) * _countof(kSources), "program", [&]()
+        {
+            for(auto i=0u; i<count; ++i)
+            {
+                for(auto source : kSources)
+                {
+                    DanmakuProgram program;
+                    if (!assembler.Assemble("bench", source, program))
+                    { return false; }
+                }
+            }
+            return true;
+        });
+
+        if (IsEnabled(context, "Danmaku/Assemble"))
+        { CheckRejects(context, assembler); }
+    }
+
+    // VM 単体の実行. 弾は生成するだけで移動させない.
+    const UpdateCase kCases[] = {
+        { "Danmaku/Update(Swarm,Emitters=1600)",  kSwarmSource,  1600, 60, 1 },
+        { "Danmaku/Update(Spiral,Emitters=64)",   kSpiralSource, 64,   6,  8 },
+    };
+
+    const uint32_t tickCount = context.Quick ? 120 : 600;
+
+    for(const auto& item : kCases)
+    {
+        if (!IsEnabled(context, item.Name))
+        { continue; }
+
+        DanmakuProgram program;
+        if (!assembler.Assemble(item.Name, item.Source, program))
+        {
+            Check(context, false, "DanmakuAssembler::Assemble() Failed.");
+            continue;
+        }
+
+        DanmakuVM vm;
+        auto id = vm.AddProgram(program);
+        Check(context, id != DANMAKU_INVALID_PROGRAM, "DanmakuVM::AddProgram() Failed.");
+
+        // 画面上部に横一列で並べる.
+        for(auto i=0u; i<item.EmitterCount; ++i)
+        {
+            auto x = 1920.0f * (float(i) + 0.5f) / float(item.EmitterCount);
+            Check(context, vm.Alloc(id, x, 64.0f).IsValid(), "DanmakuVM::Alloc() Failed.");
+        }
+
+        asdx::Vector2 target(960.0f, 960.0f);
+        BulletManager bullets;
+
+        auto ms = Report(context, item.Name, double(tickCount) * item.EmitterCount, "emitter", [&]()
+        {
+            if (!bullets.Init(kMaxBulletCount))
+            { return false; }
+
+            for(auto i=0u; i<tickCount; ++i)
+            { vm.Update(target, bullets); }
+
+            return true;
+        });
+        if (ms < 0.0)
+        { continue; }
+
+        // 全発射体が wait 0 から始まるので, 発射回数はティック数から決まる.
+        auto shots    = (tickCount + item.Interval - 1) / item.Interval;
+        auto expected = std::min(kMaxBulletCount, shots * item.BulletPerShot * item.EmitterCount);
+        printf("    %u bullets per %u ticks\n", bullets.GetUsedCount(), tickCount);
+        Check(context, bullets.GetUsedCount() == expected, "DanmakuVM::Update() Bullet Count Mismatch.");
+
+        bullets.Term();
+    }
+
+    // 同じステージで DanmakuVM と IBehavior の発弾を比べる.
+    struct PathCase
+    {
+        const char*     Name;
+        uint32_t        Stage;
+        uint32_t        MaxEnemyCount;
+    };
+    const PathCase kPaths[] = {
+        { "Danmaku/Stress",     SIM_STAGE_STRESS, 512  },
+        { "Danmaku/Swarm",      SIM_STAGE_SWARM,  4096 },
+    };
+
+    // swarm は 1200 ティック付近で弾数が上限(8192)に達して比較にならないので, その手前で止める.
+    const uint32_t stageTicks = context.Quick ? 600 : 900;
+
+    for(const auto& path : kPaths)
+    {
+        uint32_t peakBullets[2] = {};
+
+        for(auto p=0; p<2; ++p)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "%s(%s)", path.Name, (p == 0) ? "VM" : "Behavior");
+
+            SimDesc desc;
+            desc.Stage          = path.Stage;
+            desc.MaxEnemyCount  = path.MaxEnemyCount;
+            desc.Invincible     = true;
+            desc.UseDanmaku     = (p == 0);
+
+            SimTimings timings;
+            auto ms = Report(context, name, double(stageTicks), "tick", [&]()
+            {
+                Simulation simulation;
+                if (!simulation.Init(desc))
+                { return false; }
+
+                simulation.SetProfile(true);
+                peakBullets[p] = 0;
+                for(auto i=0u; i<stageTicks; ++i)
+                {
+                    simulation.Step(GenerateInput(i));
+                    peakBullets[p] = std::max(peakBullets[p], GetEnemyBulletMgr().GetUsedCount());
+                }
+
+                timings = simulation.GetTimings();
+                simulation.Term();
+                return true;
+            });
+            if (ms < 0.0)
+            { continue; }
+
+            auto enemyNs = timings.Nanoseconds[SIM_SYSTEM_ENEMY] + timings.Nanoseconds[SIM_SYSTEM_DANMAKU];
+            printf("    enemy + danmaku %.3f us/tick, peak bullets %u\n",
+                double(enemyNs) * 1e-3 / double(stageTicks), peakBullets[p]);
+        }
+
+        // 狙う位置と発射順が異なるので完全には一致しないが, 弾数はほぼ同じになる.
+        if (peakBullets[0] > 0 && peakBullets[1] > 0)
+        {
+            auto diff = fabs(double(peakBullets[0]) - double(peakBullets[1])) / double(peakBullets[1]);
+            Check(context, diff < 0.01, "DanmakuVM And IBehavior Bullet Count Differ.");
+        }
+    }
+}
@@ -0,0 +1,225 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchHitTest.cpp
+// Desc : Batched Hit Test Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <Entity.h>
+#include <SpriteData.h>
+#include "BenchSTG.h"
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// Random class
+///////////////////////////////////////////////////////////////////////////////
+class Random
+{
+public:
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    explicit Random(uint32_t seed)
+    : m_State(seed)
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //! @brief      [0, 1) の乱数を取得します.
+    //-------------------------------------------------------------------------
+    float GetAsFloat()
+    {
+        m_State ^= m_State << 13;
+        m_State ^= m_State >> 17;
+        m_State ^= m_State << 5;
+        return float(m_State >> 8) * (1.0f / 16777216.0f);
+    }
+
+private:
+    uint32_t    m_State;    //!< xorshift32 の状態.
+};
+
+//-----------------------------------------------------------------------------
+//      スプライト種別と位置から当たり判定用の状態を作ります.
+//-----------------------------------------------------------------------------
+EntityState MakeState(uint16_t kind, float x, float y, float scale)
+{
+    // Entity::GetState() と同じ式.
+    const auto& box = GetHitBox(kind);
+
+    EntityState result;
+    result.X      = x + box.SpriteHalfW * scale;
+    result.Y      = y + box.SpriteHalfH * scale;
+    result.HalfW  = box.HalfW * scale;
+    result.HalfH  = box.HalfH * scale;
+    result.Radius = box.Radius * scale;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      弾を模した状態を生成します.
+//-----------------------------------------------------------------------------
+void CreateStates(uint32_t count, const EntityState& target, std::vector<EntityState>& states)
+{
+    // カプセル(レーザー)と矩形が混ざるようにする.
+    const uint16_t kKinds[] = { LASER_RED08, LASER_BLUE08, LASER_GREEN08, ENEMY_RED1 };
+
+    Random random(count * 2654435761u + 1);
+    states.resize(count);
+    for(auto i=0u; i<count; ++i)
+    {
+        // 付近に置く要素にも全種別が現れるように, 4要素ごとに種別を変える.
+        auto kind = kKinds[(i >> 2) % _countof(kKinds)];
+
+        // 1/4 はターゲット付近に置いて, 交差する場合としない場合の両方を含める.
+        float x, y;
+        if ((i & 3) == 0)
+        {
+            x = target.X + (random.GetAsFloat() - 0.5f) * 64.0f;
+            y = target.Y + (random.GetAsFloat() - 0.5f) * 64.0f;
+        }
+        else
+        {
+            x = random.GetAsFloat() * 1920.0f;
+            y = random.GetAsFloat() * 1080.0f;
+        }
+
+        states[i] = MakeState(kind, x, y, 0.5f);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      IsHitState() で1つずつ判定します.
+//-----------------------------------------------------------------------------
+uint32_t HitTestScalar(const EntityState& target, const std::vector<EntityState>& states, std::vector<uint64_t>& mask)
+{
+    std::fill(mask.begin(), mask.end(), 0ull);
+
+    uint32_t hits = 0;
+    for(size_t i=0; i<states.size(); ++i)
+    {
+        if (IsHitState(target, states[i]))
+        {
+            mask[i >> 6] |= 1ull << (i & 63);
+            hits++;
+        }
+    }
+    return hits;
+}
+
+//-----------------------------------------------------------------------------
+//      境界付近の判定結果を確認します.
+//-----------------------------------------------------------------------------
+bool CheckEdgeCases()
+{
+    // 半径 4 の円と, 半幅 2 の矩形.
+    EntityState circle = { 100.0f, 100.0f, 0.0f, 0.0f, 4.0f };
+    EntityState box    = { 0.0f,   100.0f, 2.0f, 2.0f, 0.0f };
+
+    struct Case
+    {
+        float   X;
+        float   Y;
+        bool    Expected;
+    };
+    const Case kCases[] = {
+        { 100.0f, 100.0f, true  },      // 中心が一致.
+        { 105.9f, 100.0f, true  },      // 横方向に距離 3.9.
+        { 106.1f, 100.0f, false },      // 横方向に距離 4.1.
+        { 104.0f, 104.0f, true  },      // 角までの距離 sqrt(8).
+        { 105.0f, 105.0f, false },      // 角までの距離 sqrt(18).
+        { 500.0f, 500.0f, false },
+    };
+
+    // 端数の要素(スカラー経路)と4要素単位(SSE2経路)の両方に同じ状態を並べる.
+    std::vector<EntityState> states;
+    for(auto repeat=0; repeat<2; ++repeat)
+    {
+        for(const auto& item : kCases)
+        {
+            box.X = item.X;
+            box.Y = item.Y;
+            states.push_back(box);
+        }
+    }
+
+    std::vector<uint64_t> mask(GetHitMaskWordCount(states.size()));
+    HitTest(circle, states, mask);
+
+    for(size_t i=0; i<states.size(); ++i)
+    {
+        auto hit = ((mask[i >> 6] >> (i & 63)) & 1) != 0;
+        if (hit != kCases[i % _countof(kCases)].Expected)
+        { return false; }
+    }
+
+    return true;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      当たり判定のベンチマークを実行します.
+//-----------------------------------------------------------------------------
+void BenchHitTest(BenchContext& context)
+{
+    if (IsEnabled(context, "HitTest"))
+    { Check(context, CheckEdgeCases(), "HitTest() Edge Case Mismatch."); }
+
+    // プレイヤー機体の判定(小さな円)を画面下中央に置く.
+    const auto target = MakeState(PLAYER_SHIP1_BLUE, 944.0f, 900.0f, 1.0f);
+
+    // 4の倍数でない要素数も含めて, 端数処理の経路も通す.
+    const uint32_t kCounts[] = { 61, 1024, 8191 };
+    const uint32_t repeat    = context.Quick ? 16 : 1024;
+
+    for(auto count : kCounts)
+    {
+        std::vector<EntityState> states;
+        CreateStates(count, target, states);
+
+        std::vector<uint64_t> expected(GetHitMaskWordCount(count));
+        std::vector<uint64_t> actual  (GetHitMaskWordCount(count));
+
+        char name[64];
+        auto ops  = double(count) * repeat;
+        auto hits = 0u;
+
+        snprintf(name, sizeof(name), "HitTest/Scalar(N=%u)", count);
+        Report(context, name, ops, "state", [&]()
+        {
+            for(auto i=0u; i<repeat; ++i)
+            {
+                hits = HitTestScalar(target, states, expected);
+                DoNotOptimize(hits);
+            }
+            return true;
+        });
+
+        snprintf(name, sizeof(name), "HitTest/Batched(N=%u)", count);
+        Report(context, name, ops, "state", [&]()
+        {
+            for(auto i=0u; i<repeat; ++i)
+            {
+                hits = HitTest(target, states, actual);
+                DoNotOptimize(hits);
+            }
+            return true;
+        });
+
+        if (!IsEnabled(context, name))
+        { continue; }
+
+        // フィルタで片方だけ除外された場合に備えて, 判定結果は計測とは別に求める.
+        auto scalarHits  = HitTestScalar(target, states, expected);
+        auto batchedHits = HitTest(target, states, actual);
+        printf("    %u hits\n", batchedHits);
+
+        Check(context, scalarHits > 0, "HitTest Benchmark Has No Hits.");
+        Check(context, scalarHits == batchedHits && expected == actual, "HitTest() Result Mismatch.");
+    }
+}
@@ -0,0 +1,158 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchSTG.h
+// Desc : STG Simulation Benchmark Utility.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <fnd/asdxLogger.h>
+#include <SimInput.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BenchContext structure
+///////////////////////////////////////////////////////////////////////////////
+struct BenchContext
+{
+    uint32_t        Samples = 5;        //!< サンプル数.
+    bool            Quick   = false;    //!< 短縮実行.
+    const char*     Filter  = nullptr;  //!< 名前で絞り込む文字列.
+    int             Result  = 0;        //!< 終了コード.
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      ベンチマークを実行するかどうかを判定します.
+//!
+//! @param[in]      context     ベンチマークコンテキスト.
+//! @param[in]      name        ベンチマーク名.
+//! @retval true    実行する.
+//! @retval false   フィルタで除外された.
+//-----------------------------------------------------------------------------
+inline bool IsEnabled(const BenchContext& context, const char* name)
+{ return context.Filter == nullptr || strstr(name, context.Filter) != nullptr; }
+
+//-----------------------------------------------------------------------------
+//! @brief      最適化で計算が消されないように値を使用済みにします.
+//-----------------------------------------------------------------------------
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+    static const void* volatile s_Sink = nullptr;
+    s_Sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      処理時間の中央値をミリ秒で計測します.
+//!
+//! @param[in]      samples     サンプル数.
+//! @param[in]      func        計測処理. 失敗した場合は false を返却してください.
+//! @return     中央値を返却します. 処理に失敗した場合は負値を返却します.
+//! @note       1回目は温めるだけで計測しません.
+//-----------------------------------------------------------------------------
+inline double MeasureMs(uint32_t samples, const std::function<bool()>& func)
+{
+    if (!func())
+    { return -1.0; }
+
+    std::vector<double> times(samples);
+    for(auto& time : times)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!func())
+        { return -1.0; }
+        time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      計測して結果を表示します.
+//!
+//! @param[in,out]  context     ベンチマークコンテキスト.
+//! @param[in]      name        ベンチマーク名.
+//! @param[in]      ops         1回の処理に含まれる操作数.
+//! @param[in]      unit        操作の単位名.
+//! @param[in]      func        計測処理.
+//! @return     中央値[ms]を返却します. 除外または失敗した場合は負値を返却します.
+//-----------------------------------------------------------------------------
+inline double Report
+(
+    BenchContext&                   context,
+    const char*                     name,
+    double                          ops,
+    const char*                     unit,
+    const std::function<bool()>&    func
+)
+{
+    if (!IsEnabled(context, name))
+    { return -1.0; }
+
+    auto ms = MeasureMs(context.Samples, func);
+    if (ms < 0.0)
+    {
+        ELOGA("Error : %s Failed.", name);
+        context.Result = 1;
+        return ms;
+    }
+
+    printf("%-44s %10.3f ms %12.3f ns/%s\n", name, ms, ms * 1e6 / std::max(ops, 1.0), unit);
+    fflush(stdout);
+    return ms;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      検証に失敗したら終了コードを設定します.
+//!
+//! @param[in,out]  context     ベンチマークコンテキスト.
+//! @param[in]      condition   検証結果.
+//! @param[in]      message     失敗時のメッセージ.
+//-----------------------------------------------------------------------------
+inline void Check(BenchContext& context, bool condition, const char* message)
+{
+    if (condition)
+    { return; }
+
+    ELOGA("Error : %s", message);
+    context.Result = 1;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      自動操作の入力を生成します.
+//!
+//! @param[in]      tick        ティック数.
+//! @return     SimRunner と同じく, 左右に往復しながら撃ち続ける入力を返却します.
+//-----------------------------------------------------------------------------
+inline SimInput GenerateInput(uint32_t tick)
+{
+    auto x = sinf(float(tick) * 0.02f);
+    auto y = 0.25f * sinf(float(tick) * 0.005f);
+    return MakeSimInput(x, y, SIM_BUTTON_SHOT);
+}
+
+//-----------------------------------------------------------------------------
+// Benchmarks.
+//-----------------------------------------------------------------------------
+void BenchSimulation(BenchContext& context);
+void BenchDanmaku(BenchContext& context);
+void BenchHitTest(BenchContext& context);
@@ -0,0 +1,196 @@
+﻿//-----------------------------------------------------------------------------
+// File : BenchSimulation.cpp
+// Desc : Fixed Step Simulation Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <Simulation.h>
+#include <Replay.h>
+#include <Enemy.h>
+#include <Bullet.h>
+#include "BenchSTG.h"
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// SimCase structure
+///////////////////////////////////////////////////////////////////////////////
+struct SimCase
+{
+    const char*     Name;           //!< ベンチマーク名.
+    uint32_t        Stage;          //!< ステージ番号.
+    uint32_t        MaxEnemyCount;  //!< 最大敵数.
+    bool            Invincible;     //!< 被弾を無効にするかどうか.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SimResult structure
+///////////////////////////////////////////////////////////////////////////////
+struct SimResult
+{
+    SimTimings      Timings;            //!< システムごとの処理時間.
+    uint64_t        FinalHash   = 0;    //!< 最終ティックの状態ハッシュ.
+    uint32_t        PeakEnemies = 0;    //!< 最大敵数.
+    uint32_t        PeakBullets = 0;    //!< 最大エネミー弾数.
+};
+
+//-----------------------------------------------------------------------------
+//      初期化から指定ティック数までシミュレーションを実行します.
+//-----------------------------------------------------------------------------
+bool RunSimulation(const SimDesc& desc, uint32_t tickCount, bool profile, SimResult& result)
+{
+    Simulation simulation;
+    if (!simulation.Init(desc))
+    { return false; }
+
+    simulation.SetProfile(profile);
+
+    result = SimResult();
+    for(auto i=0u; i<tickCount; ++i)
+    {
+        simulation.Step(GenerateInput(i));
+        result.PeakEnemies = std::max(result.PeakEnemies, GetEnemyMgr().GetUsedCount());
+        result.PeakBullets = std::max(result.PeakBullets, GetEnemyBulletMgr().GetUsedCount());
+    }
+
+    result.FinalHash = simulation.CalcHash();
+    result.Timings   = simulation.GetTimings();
+
+    simulation.Term();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      リプレイを保存して読み込み, 同じ状態ハッシュになることを確認します.
+//-----------------------------------------------------------------------------
+bool CheckReplay(const SimDesc& desc, uint32_t tickCount)
+{
+    const char* kPath = "bench_sim.stgr";
+
+    Replay record;
+    record.Reset(desc);
+    {
+        Simulation simulation;
+        if (!simulation.Init(desc))
+        { return false; }
+
+        for(auto i=0u; i<tickCount; ++i)
+        {
+            auto input = GenerateInput(i);
+            simulation.Step(input);
+            record.Add(input, simulation.CalcHash());
+        }
+        simulation.Term();
+    }
+
+    if (!record.Save(kPath))
+    { return false; }
+
+    Replay replay;
+    auto loaded = replay.Load(kPath);
+    remove(kPath);
+
+    if (!loaded || replay.GetTickCount() != tickCount)
+    { return false; }
+
+    Simulation simulation;
+    if (!simulation.Init(replay.GetDesc()))
+    { return false; }
+
+    auto matched = true;
+    for(auto i=0u; i<tickCount && matched; ++i)
+    {
+        simulation.Step(replay.GetInput(i));
+        matched = (simulation.CalcHash() == replay.GetHash(i));
+    }
+    simulation.Term();
+
+    return matched;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      固定ステップシミュレーションのベンチマークを実行します.
+//-----------------------------------------------------------------------------
+void BenchSimulation(BenchContext& context)
+{
+    const SimCase kCases[] = {
+        { "Simulation/Default",                 SIM_STAGE_DEFAULT, 512,  false },
+        { "Simulation/Stress",                  SIM_STAGE_STRESS,  512,  false },
+        { "Simulation/Stress(Invincible)",      SIM_STAGE_STRESS,  512,  true  },
+        { "Simulation/Swarm(Invincible)",       SIM_STAGE_SWARM,   4096, true  },
+    };
+
+    // 短縮実行でも弾と敵が十分に増えるところまでは進める.
+    const uint32_t tickCount = context.Quick ? 600 : 3600;
+
+    for(const auto& item : kCases)
+    {
+        if (!IsEnabled(context, item.Name))
+        { continue; }
+
+        SimDesc desc;
+        desc.Stage          = item.Stage;
+        desc.MaxEnemyCount  = item.MaxEnemyCount;
+        desc.Invincible     = item.Invincible;
+
+        // 計測の度に初期化し直すので, 全サンプルが同じ状態ハッシュで終わるはず.
+        SimResult first;
+        SimResult result;
+        auto hasFirst = false;
+        auto stable   = true;
+
+        auto ms = Report(context, item.Name, double(tickCount), "tick", [&]()
+        {
+            if (!RunSimulation(desc, tickCount, false, result))
+            { return false; }
+
+            if (!hasFirst)
+            { first = result; hasFirst = true; }
+            else
+            { stable &= (result.FinalHash == first.FinalHash); }
+
+            return true;
+        });
+        if (ms < 0.0)
+        { continue; }
+
+        Check(context, stable, "Simulation Result Is Not Deterministic.");
+
+        // システムごとの内訳は計測用の1回だけで求める.
+        SimResult profiled;
+        if (!RunSimulation(desc, tickCount, true, profiled))
+        {
+            Check(context, false, "Simulation::Init() Failed.");
+            continue;
+        }
+        Check(context, profiled.FinalHash == first.FinalHash, "Profiling Changed Simulation Result.");
+
+        printf("    %.0f ticks/s, peak enemies %u, peak bullets %u, hash %016llx\n",
+            double(tickCount) * 1000.0 / ms,
+            profiled.PeakEnemies,
+            profiled.PeakBullets,
+            (unsigned long long)profiled.FinalHash);
+
+        for(auto i=0u; i<SIM_SYSTEM_COUNT; ++i)
+        {
+            printf("    %-8s %10.3f us/tick\n",
+                GetSimSystemName(SIM_SYSTEM(i)),
+                double(profiled.Timings.Nanoseconds[i]) * 1e-3 / double(tickCount));
+        }
+    }
+
+    // 記録したリプレイを再生して, ティックごとの状態ハッシュが一致することを確認する.
+    if (IsEnabled(context, "Simulation/Replay"))
+    {
+        SimDesc desc;
+        desc.Stage = SIM_STAGE_STRESS;
+        Check(context, CheckReplay(desc, context.Quick ? 300 : 1200), "Replay Hash Mismatch.");
+    }
+}
@@ -0,0 +1,40 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : STG Simulation Benchmarks.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdlib>
+#include "BenchSTG.h"
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    BenchContext context;
+    for(auto i=1; i<argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+        { context.Quick = true; context.Samples = 1; }
+        else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+        { context.Samples = uint32_t(std::max(1, atoi(argv[++i]))); }
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        { context.Filter = argv[++i]; }
+        else
+        {
+            printf("Usage : %s [--quick] [--samples <count>] [--filter <text>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    BenchSimulation(context);
+    BenchDanmaku(context);
+    BenchHitTest(context);
+
+    return context.Result;
+}
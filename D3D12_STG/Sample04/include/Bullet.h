@@ -9,6 +9,7 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include "Entity.h"
+#include <vector>
 #include <fnd/asdxList.h>
 
 
@@ -110,6 +111,12 @@ public:
     //-------------------------------------------------------------------------
     void Update();
 
+    //-------------------------------------------------------------------------
+    //! @brief      有効フラグを立てます.
+    //-------------------------------------------------------------------------
+    void SetEnable()
+    { m_Enable = true; }
+
     //-------------------------------------------------------------------------
     //! @brief      有効フラグを落とします.
     //-------------------------------------------------------------------------
@@ -218,13 +225,6 @@ public:
     //-------------------------------------------------------------------------
     void Update(uint32_t w, uint32_t h);
 
-    //-------------------------------------------------------------------------
-    //! @brief      スプライトを描画します.
-    //! 
-    //! @param[in]      renderer    スプライトレンダラー.
-    //-------------------------------------------------------------------------
-    void Draw(asdx::SpriteRenderer& renderer);
-
     //-------------------------------------------------------------------------
     //! @brief      交差判定を行います.
     //! 
@@ -246,6 +246,26 @@ public:
         { action(itr); }
     }
 
+    //-------------------------------------------------------------------------
+    //! @brief      指定されたアクションを全要素に対して実行します.
+    //! 
+    //! @param[in]      action      アクション.
+    //-------------------------------------------------------------------------
+    template<typename Action>
+    void ForEach(Action action) const
+    {
+        for(auto& itr : m_UsedList)
+        { action(itr); }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      使用中の弾数を取得します.
+    //! 
+    //! @return     使用中の弾数を返却します.
+    //-------------------------------------------------------------------------
+    uint32_t GetUsedCount() const
+    { return m_UsedCount; }
+
 private:
     //=========================================================================
     // private variables.
@@ -256,10 +276,19 @@ private:
     asdx::List<Bullet>  m_FreeList;             //!< 未使用リスト.
     asdx::List<Bullet>  m_UsedList;             //!< 使用中リスト.
 
+    std::vector<EntityState>    m_HitStates;    //!< 交差判定用の状態 (使用中リスト順).
+    std::vector<uint64_t>       m_HitMask;      //!< 交差判定結果.
+
     //=========================================================================
     // private methods.
     //=========================================================================
-    /* NOTHING */
+
+    //-------------------------------------------------------------------------
+    //! @brief      マスクで指定された弾を未使用リストに戻します.
+    //!
+    //! @param[in]      mask        使用中リスト順のビットマスク.
+    //-------------------------------------------------------------------------
+    void FreeMasked(std::span<const uint64_t> mask);
 };
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,281 @@
+﻿//-----------------------------------------------------------------------------
+// File : Danmaku.h
+// Desc : Danmaku Pattern Virtual Machine.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fnd/asdxMath.h>
+
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class BulletManager;
+
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static constexpr uint32_t DANMAKU_INVALID_PROGRAM   = UINT32_MAX;   //!< 無効なプログラム番号.
+static constexpr uint32_t DANMAKU_MAX_LOOP_DEPTH    = 4;            //!< repeat の最大ネスト数.
+static constexpr uint32_t DANMAKU_MAX_STEP_PER_TICK = 64;           //!< 1ティックで実行する最大命令数.
+
+///////////////////////////////////////////////////////////////////////////////
+// DANMAKU_OP enum
+///////////////////////////////////////////////////////////////////////////////
+enum DANMAKU_OP : uint8_t
+{
+    DANMAKU_OP_END = 0,         //!< 終了.                          end
+    DANMAKU_OP_WAIT,            //!< Int ティック待機.               wait <ticks>
+    DANMAKU_OP_JUMP,            //!< Int 番目の命令へ移動.           jump <label>
+    DANMAKU_OP_REPEAT,          //!< Slot のカウンタに Int を設定.    repeat <count>
+    DANMAKU_OP_NEXT,            //!< Slot のカウンタを減らし, 残っていれば Int へ移動. next
+    DANMAKU_OP_SPRITE,          //!< 弾のスプライト種別を設定.        sprite <kind>
+    DANMAKU_OP_SCALE,           //!< 弾の描画スケールを設定.          scale <sx> [sy]
+    DANMAKU_OP_ANGLE,           //!< 発射角度を設定.                  angle <deg>
+    DANMAKU_OP_TURN,            //!< 発射角度に加算.                  turn <deg>
+    DANMAKU_OP_AIM,             //!< 発射角度を目標方向に設定.        aim [offset]
+    DANMAKU_OP_SPEED,           //!< 弾の速さを設定.                  speed <value>
+    DANMAKU_OP_SPEED_RATE,      //!< 弾の速さ加算値を設定.            speedrate <value>
+    DANMAKU_OP_ANGLE_RATE,      //!< 弾の角度加算値を設定.            anglerate <value>
+    DANMAKU_OP_NWAY,            //!< 発射角度を中心に扇状に発射.      nway <count> <range>
+    DANMAKU_OP_RING,            //!< 発射角度から全方位に発射.        ring <count>
+    DANMAKU_OP_COUNT,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// DanmakuInst structure
+///////////////////////////////////////////////////////////////////////////////
+struct DanmakuInst
+{
+    uint8_t     Op      = DANMAKU_OP_END;   //!< 命令 (DANMAKU_OP).
+    uint8_t     Slot    = 0;                //!< ループカウンタ番号.
+    uint16_t    Int     = 0;                //!< 整数オペランド (ティック数, 個数, 分岐先, スプライト種別).
+    float       X       = 0.0f;             //!< 実数オペランド0.
+    float       Y       = 0.0f;             //!< 実数オペランド1.
+};
+static_assert(sizeof(DanmakuInst) == 12, "DanmakuInst Size Not Matched.");
+
+///////////////////////////////////////////////////////////////////////////////
+// DanmakuProgram structure
+///////////////////////////////////////////////////////////////////////////////
+struct DanmakuProgram
+{
+    std::string                 Name;   //!< プログラム名.
+    std::vector<DanmakuInst>    Code;   //!< 命令列.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// DanmakuHandle structure
+///////////////////////////////////////////////////////////////////////////////
+struct DanmakuHandle
+{
+    uint32_t    Program = DANMAKU_INVALID_PROGRAM;  //!< プログラム番号.
+    uint32_t    Slot    = 0;                        //!< 発射体番号.
+
+    //-------------------------------------------------------------------------
+    //! @brief      有効なハンドルかどうかチェックします.
+    //-------------------------------------------------------------------------
+    bool IsValid() const
+    { return Program != DANMAKU_INVALID_PROGRAM; }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+// DanmakuAssembler class
+///////////////////////////////////////////////////////////////////////////////
+class DanmakuAssembler
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      整数オペランドとして使用できるシンボルを定義します.
+    //!
+    //! @param[in]      name        シンボル名.
+    //! @param[in]      value       値.
+    //-------------------------------------------------------------------------
+    void DefineSymbol(const char* name, int value);
+
+    //-------------------------------------------------------------------------
+    //! @brief      定義済みシンボルをクリアします.
+    //-------------------------------------------------------------------------
+    void ClearSymbols();
+
+    //-------------------------------------------------------------------------
+    //! @brief      テキストをアセンブルします.
+    //!
+    //! @param[in]      name        プログラム名 (エラー表示用).
+    //! @param[in]      source      ソーステキスト.
+    //! @param[out]     program     アセンブル結果.
+    //! @retval true    アセンブルに成功.
+    //! @retval false   アセンブルに失敗.
+    //! @note       1行1命令で, ';' 以降はコメントです. "label:" で分岐先を定義します.
+    //!             repeat / next は静的にネストを解決し, ループカウンタ番号を割り当てます.
+    //!             末尾には end が自動的に追加されます.
+    //-------------------------------------------------------------------------
+    bool Assemble(const char* name, const char* source, DanmakuProgram& program) const;
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    std::unordered_map<std::string, int>    m_Symbols;  //!< シンボルテーブル.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    /* NOTHING */
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+// DanmakuVM class
+///////////////////////////////////////////////////////////////////////////////
+class DanmakuVM
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    DanmakuVM();
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~DanmakuVM();
+
+    //-------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //-------------------------------------------------------------------------
+    void Term();
+
+    //-------------------------------------------------------------------------
+    //! @brief      プログラムを登録します.
+    //!
+    //! @param[in]      program     登録するプログラム.
+    //! @return     プログラム番号を返却します. 不正なプログラムの場合は DANMAKU_INVALID_PROGRAM を返却します.
+    //-------------------------------------------------------------------------
+    uint32_t AddProgram(const DanmakuProgram& program);
+
+    //-------------------------------------------------------------------------
+    //! @brief      発射体を生成します.
+    //!
+    //! @param[in]      program     プログラム番号.
+    //! @param[in]      x           位置X成分.
+    //! @param[in]      y           位置Y成分.
+    //! @return     発射体のハンドルを返却します. 失敗した場合は無効なハンドルを返却します.
+    //-------------------------------------------------------------------------
+    DanmakuHandle Alloc(uint32_t program, float x, float y);
+
+    //-------------------------------------------------------------------------
+    //! @brief      発射体を破棄します.
+    //!
+    //! @param[in]      handle      破棄する発射体のハンドル.
+    //-------------------------------------------------------------------------
+    void Free(const DanmakuHandle& handle);
+
+    //-------------------------------------------------------------------------
+    //! @brief      発射体の位置を設定します.
+    //!
+    //! @param[in]      handle      発射体のハンドル.
+    //! @param[in]      x           位置X成分.
+    //! @param[in]      y           位置Y成分.
+    //-------------------------------------------------------------------------
+    void SetPos(const DanmakuHandle& handle, float x, float y);
+
+    //-------------------------------------------------------------------------
+    //! @brief      全発射体を1ティック分実行します.
+    //!
+    //! @param[in]      target      aim 命令の目標位置.
+    //! @param[in]      bullets     弾の生成先.
+    //-------------------------------------------------------------------------
+    void Update(const asdx::Vector2& target, BulletManager& bullets);
+
+    //-------------------------------------------------------------------------
+    //! @brief      登録されているプログラム数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetProgramCount() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      生存している発射体の数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetActiveCount() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Batch structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Batch
+    {
+        std::vector<DanmakuInst>    Code;                               //!< 命令列.
+        std::vector<uint8_t>        Active;                             //!< 生存フラグ.
+        std::vector<uint16_t>       Pc;                                 //!< プログラムカウンタ.
+        std::vector<uint16_t>       Wait;                               //!< 残り待機ティック数.
+        std::vector<uint16_t>       Loop[DANMAKU_MAX_LOOP_DEPTH];       //!< ループカウンタ.
+        std::vector<uint16_t>       Sprite;                             //!< 弾のスプライト種別.
+        std::vector<float>          PosX;                               //!< 位置X成分.
+        std::vector<float>          PosY;                               //!< 位置Y成分.
+        std::vector<float>          ScaleX;                             //!< 弾の描画スケールX.
+        std::vector<float>          ScaleY;                             //!< 弾の描画スケールY.
+        std::vector<float>          Angle;                              //!< 発射角度.
+        std::vector<float>          Speed;                              //!< 弾の速さ.
+        std::vector<float>          SpeedRate;                          //!< 弾の速さ加算値.
+        std::vector<float>          AngleRate;                          //!< 弾の角度加算値.
+        std::vector<uint32_t>       FreeSlots;                          //!< 未使用の発射体番号.
+        uint32_t                    ActiveCount = 0;                    //!< 生存数.
+    };
+
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    std::vector<Batch>  m_Batches;      //!< プログラムごとの発射体.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      1プログラム分の発射体を実行します.
+    //-------------------------------------------------------------------------
+    static void Execute(Batch& batch, const asdx::Vector2& target, BulletManager& bullets);
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      弾幕VMを取得します.
+//-----------------------------------------------------------------------------
+DanmakuVM& GetDanmakuVM();
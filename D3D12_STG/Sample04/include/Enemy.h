@@ -9,7 +9,9 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include "Entity.h"
+#include "Danmaku.h"
 #include <unordered_map>
+#include <vector>
 #include <fnd/asdxList.h>
 
 
@@ -77,6 +79,7 @@ public:
     //! @param[in]      y                   位置Y成分.
     //! @param[in]      shotBehavior        発弾挙動です.
     //! @param[in]      moveBehavior        移動挙動です.
+    //! @param[in]      shotProgram         発弾プログラム番号です.
     //-------------------------------------------------------------------------
     void Setup(
         uint16_t            kind,
@@ -85,7 +88,13 @@ public:
         float               sx,
         float               sy,
         IBehavior*          pShotBehavior,
-        IBehavior*          pMoveBehavior);
+        IBehavior*          pMoveBehavior,
+        uint32_t            shotProgram);
+
+    //-------------------------------------------------------------------------
+    //! @brief      発弾プログラムの発射体を破棄します.
+    //-------------------------------------------------------------------------
+    void Release();
 
     //-------------------------------------------------------------------------
     //! @brief      更新処理を行います.
@@ -121,6 +130,7 @@ private:
     int             m_Timer         = 0;
     IBehavior*      m_pShotBehavior = nullptr;
     IBehavior*      m_pMoveBehavior = nullptr;
+    DanmakuHandle   m_Emitter       = {};
 
     //=========================================================================
     // private methods.
@@ -148,6 +158,7 @@ public:
         uint16_t    SpriteKind    = 0;         //!< スプライト種別.
         IBehavior*  pShotBehavior = nullptr;   //!< 発弾挙動.
         IBehavior*  pMoveBehavior = nullptr;   //!< 移動挙動.
+        uint32_t    ShotProgram   = DANMAKU_INVALID_PROGRAM;   //!< 発弾プログラム (GetDanmakuVM() の番号).
     };
 
     //=========================================================================
@@ -221,11 +232,6 @@ public:
     //-------------------------------------------------------------------------
     void Update(uint32_t w, uint32_t h);
 
-    //-------------------------------------------------------------------------
-    //! @brief      スプライトを描画します.
-    //-------------------------------------------------------------------------
-    void Draw(asdx::SpriteRenderer& renderer);
-
     //-------------------------------------------------------------------------
     //! @brief      交差判定を行います.
     //! 
@@ -275,6 +281,18 @@ public:
         { action(itr); }
     }
 
+    //-------------------------------------------------------------------------
+    //! @brief      指定されたアクションを全要素に対して実行します.
+    //! 
+    //! @param[in]      action      アクション.
+    //-------------------------------------------------------------------------
+    template<typename Action>
+    void ForEach(Action action) const
+    {
+        for(auto& itr : m_UsedList)
+        { action(itr); }
+    }
+
 private:
     //=========================================================================
     // private variables.
@@ -287,10 +305,20 @@ private:
 
     std::unordered_map<uint32_t, SpawnParam> m_Types;   //!< 敵タイプリスト.
 
+    std::vector<EntityState>    m_HitStates;    //!< 交差判定用の状態 (使用中リスト順).
+    std::vector<uint64_t>       m_HitMask;      //!< 交差判定結果.
+    std::vector<uint64_t>       m_DeadMask;     //!< 撃破された敵.
+
     //=========================================================================
     // private methods.
     //=========================================================================
-    /* NOTHING */
+
+    //-------------------------------------------------------------------------
+    //! @brief      マスクで指定された敵を未使用リストに戻します.
+    //!
+    //! @param[in]      mask        使用中リスト順のビットマスク.
+    //-------------------------------------------------------------------------
+    void FreeMasked(std::span<const uint64_t> mask);
 };
 
 //-----------------------------------------------------------------------------
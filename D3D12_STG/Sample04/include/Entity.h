@@ -9,11 +9,20 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <fnd/asdxMath.h>
+#include <span>
 
-//-----------------------------------------------------------------------------
-// Forward Decalarations.
-//-----------------------------------------------------------------------------
-namespace asdx { class SpriteRenderer; }
+
+///////////////////////////////////////////////////////////////////////////////
+// EntityState structure
+///////////////////////////////////////////////////////////////////////////////
+struct EntityState
+{
+    float   X;          //!< 判定形状の中心X成分.
+    float   Y;          //!< 判定形状の中心Y成分.
+    float   HalfW;      //!< 芯の矩形の横幅の半分 (スケール適用済み).
+    float   HalfH;      //!< 芯の矩形の縦幅の半分 (スケール適用済み).
+    float   Radius;     //!< 芯の矩形を膨らませる半径 (スケール適用済み).
+};
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -268,13 +277,6 @@ public:
     //-------------------------------------------------------------------------
     float GetScaleY() const;
 
-    //-------------------------------------------------------------------------
-    //! @brief      スプライトを描画します.
-    //! 
-    //! @param[in]      renderer    スプライトレンダラー.
-    //-------------------------------------------------------------------------
-    void Draw(asdx::SpriteRenderer& renderer);
-
     //-------------------------------------------------------------------------
     //! @brief      交差判定を行います.
     //! 
@@ -289,9 +291,17 @@ public:
     //! @brief      交差判定を行います
     //! 
     //! @param[in]      target      対象エンティティ.
+    //! @note       GetHitBox() の判定形状で判定します.
     //-------------------------------------------------------------------------
     bool IsHit(const Entity& target) const;
 
+    //-------------------------------------------------------------------------
+    //! @brief      当たり判定用の状態を取得します.
+    //! 
+    //! @return     GetHitBox() の判定形状に位置とスケールを適用した状態を返却します.
+    //-------------------------------------------------------------------------
+    EntityState GetState() const;
+
     //-------------------------------------------------------------------------
     //! @brief      スクリーン外であるかどうか判定します.
     //! 
@@ -320,3 +330,61 @@ private:
     //=========================================================================
     /* NOTHING */
 };
+
+//-----------------------------------------------------------------------------
+//! @brief      当たり判定用の状態同士の交差判定を行います.
+//! 
+//! @param[in]      a       判定する状態.
+//! @param[in]      b       判定する状態.
+//! @retval true    交差あり.
+//! @retval false   交差なし.
+//! @note       芯の矩形同士の距離が半径の和未満なら交差とします.
+//!             半径が共に0の場合は, 従来通り矩形が重なっている場合のみ交差とします.
+//-----------------------------------------------------------------------------
+inline bool IsHitState(const EntityState& a, const EntityState& b)
+{
+    auto ex = fabsf(a.X - b.X) - (a.HalfW + b.HalfW);
+    auto ey = fabsf(a.Y - b.Y) - (a.HalfH + b.HalfH);
+    auto rs = a.Radius + b.Radius;
+    auto cx = (ex > 0.0f) ? ex : 0.0f;
+    auto cy = (ey > 0.0f) ? ey : 0.0f;
+    return ((ex < 0.0f) & (ey < 0.0f)) | ((cx * cx + cy * cy) < (rs * rs));
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      判定結果のビットマスクに必要な要素数を取得します.
+//! 
+//! @param[in]      count       判定する状態の数.
+//-----------------------------------------------------------------------------
+inline size_t GetHitMaskWordCount(size_t count)
+{ return (count + 63) / 64; }
+
+//-----------------------------------------------------------------------------
+//! @brief      判定結果のビットマスクを参照します.
+//! 
+//! @param[in]      mask        HitTest() の判定結果.
+//! @param[in]      index       状態の番号.
+//-----------------------------------------------------------------------------
+inline bool IsHitMaskSet(std::span<const uint64_t> mask, size_t index)
+{ return (mask[index >> 6] & (1ull << (index & 63))) != 0; }
+
+//-----------------------------------------------------------------------------
+//! @brief      1つの状態と複数の状態の交差判定をまとめて行います.
+//! 
+//! @param[in]      target      判定する状態.
+//! @param[in]      states      判定対象の状態.
+//! @param[out]     mask        交差した状態のビットを立てたマスク (GetHitMaskWordCount() 個以上).
+//! @return     交差した状態の数を返却します.
+//! @note       SSE2 が使える場合は4要素ずつ判定します.
+//-----------------------------------------------------------------------------
+uint32_t HitTest(const EntityState& target, std::span<const EntityState> states, std::span<uint64_t> mask);
+
+//-----------------------------------------------------------------------------
+//! @brief      1つのエンティティと複数の状態の交差判定をまとめて行います.
+//! 
+//! @param[in]      target      判定するエンティティ.
+//! @param[in]      states      判定対象の状態.
+//! @param[out]     mask        交差した状態のビットを立てたマスク (GetHitMaskWordCount() 個以上).
+//! @return     交差した状態の数を返却します.
+//-----------------------------------------------------------------------------
+uint32_t HitTest(const Entity& target, std::span<const EntityState> states, std::span<uint64_t> mask);
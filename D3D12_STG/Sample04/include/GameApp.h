@@ -16,9 +16,10 @@
 #include <gfx/asdxTextureManager.h>
 #include <gfx/asdxTarget.h>
 #include <gfx/asdxFont.h>
+#include <fnd/asdxHid.h>
 #include "SpriteData.h"
-#include "Entity.h"
-#include "Player.h"
+#include "Simulation.h"
+#include "Replay.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -66,8 +67,10 @@ private:
     int                     m_OffsetBG1 = 0;
     int                     m_OffsetBG2 = 0;
     asdx::Font              m_Font;
-    Entity                  m_Enemy;
-    uint32_t                m_SpawnType = 0;
+    asdx::GamePad           m_Pad;
+    Simulation              m_Simulation;
+    Replay                  m_Replay;
+    double                  m_TickTime  = 0.0;
 
     //=========================================================================
     // private methods.
@@ -9,7 +9,7 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include "Entity.h"
-#include <fnd/asdxHid.h>
+#include "SimInput.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -59,17 +59,18 @@ public:
     //-------------------------------------------------------------------------
     //! @brief      更新処理を行います.
     //! 
+    //! @param[in]      input       1ティック分の入力.
     //! @param[in]      w           画面の横幅.
     //! @param[in]      h           画面の縦幅.
     //-------------------------------------------------------------------------
-    void Update(uint32_t w, uint32_t h);
+    void Update(const SimInput& input, uint32_t w, uint32_t h);
 
     //-------------------------------------------------------------------------
-    //! @brief      ゲームパッドを取得します.
+    //! @brief      プレイヤー番号を取得します.
     //! 
-    //! @return     ゲームパッドを返却します.
+    //! @return     プレイヤー番号を返却します.
     //-------------------------------------------------------------------------
-    const asdx::GamePad& GetPad() const;
+    uint32_t GetPlayerIndex() const;
 
     //-------------------------------------------------------------------------
     //! @brief      パッド操作をロックします.
@@ -122,7 +123,7 @@ private:
     //=========================================================================
     // private variables.
     //=========================================================================
-    asdx::GamePad   m_Pad;                  //!< ゲームパッド.
+    uint32_t        m_Index     = 0;        //!< プレイヤー番号.
     uint8_t         m_Life      = 0;        //!< 残機数.
     float           m_MoveSpeed = 1.0f;     //!< 移動スピード.
     bool            m_PadLock   = false;    //!< パッド操作ロック.
@@ -0,0 +1,127 @@
+﻿//-----------------------------------------------------------------------------
+// File : Replay.h
+// Desc : Input Replay.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include "Simulation.h"
+
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static constexpr uint32_t REPLAY_VERSION = 2;   //!< リプレイファイルバージョン.
+
+///////////////////////////////////////////////////////////////////////////////
+// ReplayHeader structure
+///////////////////////////////////////////////////////////////////////////////
+struct ReplayHeader
+{
+    uint8_t     Magic[4];               //!< マジック ('S', 'T', 'G', 'R').
+    uint32_t    Version;                //!< ファイルバージョン.
+    uint32_t    Width;                  //!< 画面の横幅.
+    uint32_t    Height;                 //!< 画面の縦幅.
+    uint32_t    Stage;                  //!< ステージ番号.
+    uint32_t    MaxEnemyCount;          //!< 最大敵数.
+    uint32_t    MaxPlayerBulletCount;   //!< プレイヤー用最大弾数.
+    uint32_t    MaxEnemyBulletCount;    //!< エネミー用最大弾数.
+    uint32_t    Invincible;             //!< プレイヤーの被弾無効フラグ.
+    uint32_t    UseDanmaku;             //!< 発弾プログラム使用フラグ.
+    uint32_t    TickCount;              //!< 記録ティック数.
+};
+static_assert(sizeof(ReplayHeader) == 44, "ReplayHeader Size Not Matched.");
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Replay class
+///////////////////////////////////////////////////////////////////////////////
+class Replay
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      記録内容を破棄して, 構成設定を設定します.
+    //!
+    //! @param[in]      desc        記録するシミュレーションの構成設定.
+    //-------------------------------------------------------------------------
+    void Reset(const SimDesc& desc);
+
+    //-------------------------------------------------------------------------
+    //! @brief      1ティック分の入力と, 更新後の状態ハッシュを追加します.
+    //!
+    //! @param[in]      input       入力.
+    //! @param[in]      hash        Simulation::Step() 後の Simulation::CalcHash() の値.
+    //-------------------------------------------------------------------------
+    void Add(const SimInput& input, uint64_t hash);
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルに保存します.
+    //!
+    //! @param[in]      path        出力ファイルパス.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //! @note       ReplayHeader, SimInput[TickCount], uint64_t[TickCount] の順に書き出します.
+    //-------------------------------------------------------------------------
+    bool Save(const char* path) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルから読み込みます.
+    //!
+    //! @param[in]      path        入力ファイルパス.
+    //! @retval true    読み込みに成功.
+    //! @retval false   読み込みに失敗.
+    //-------------------------------------------------------------------------
+    bool Load(const char* path);
+
+    //-------------------------------------------------------------------------
+    //! @brief      構成設定を取得します.
+    //-------------------------------------------------------------------------
+    const SimDesc& GetDesc() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      記録ティック数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetTickCount() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定ティックの入力を取得します.
+    //-------------------------------------------------------------------------
+    const SimInput& GetInput(uint32_t tick) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定ティックの状態ハッシュを取得します.
+    //-------------------------------------------------------------------------
+    uint64_t GetHash(uint32_t tick) const;
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    SimDesc                 m_Desc;     //!< 構成設定.
+    std::vector<SimInput>   m_Inputs;   //!< ティックごとの入力.
+    std::vector<uint64_t>   m_Hashes;   //!< ティックごとの状態ハッシュ.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    /* NOTHING */
+};
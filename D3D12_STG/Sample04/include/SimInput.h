@@ -0,0 +1,74 @@
+﻿//-----------------------------------------------------------------------------
+// File : SimInput.h
+// Desc : Simulation Input.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SIM_BUTTON enum
+///////////////////////////////////////////////////////////////////////////////
+enum SIM_BUTTON : uint16_t
+{
+    SIM_BUTTON_SHOT = 0x1,      //!< ショット.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SimInput structure
+///////////////////////////////////////////////////////////////////////////////
+struct SimInput
+{
+    int16_t     StickX      = 0;    //!< 左スティックX成分 ([-32767, 32767]).
+    int16_t     StickY      = 0;    //!< 左スティックY成分 ([-32767, 32767], 上方向が正).
+    uint16_t    Buttons     = 0;    //!< 押下中のボタン (SIM_BUTTON の論理和).
+    uint16_t    Reserved    = 0;    //!< 予約領域.
+
+    //-------------------------------------------------------------------------
+    //! @brief      左スティックX成分を [-1, 1] で取得します.
+    //-------------------------------------------------------------------------
+    float GetStickX() const
+    { return float(StickX) / 32767.0f; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      左スティックY成分を [-1, 1] で取得します.
+    //-------------------------------------------------------------------------
+    float GetStickY() const
+    { return float(StickY) / 32767.0f; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ボタンが押下されているかチェックします.
+    //-------------------------------------------------------------------------
+    bool IsDown(SIM_BUTTON button) const
+    { return (Buttons & button) != 0; }
+};
+static_assert(sizeof(SimInput) == 8, "SimInput Size Not Matched.");
+
+//-----------------------------------------------------------------------------
+//! @brief      入力値を量子化してシミュレーション入力を生成します.
+//!
+//! @param[in]      stickX      左スティックX成分 ([-1, 1]).
+//! @param[in]      stickY      左スティックY成分 ([-1, 1]).
+//! @param[in]      buttons     押下中のボタン (SIM_BUTTON の論理和).
+//! @return     シミュレーション入力を返却します.
+//! @note       リプレイと実プレイで同じ値を扱うため, シミュレーションには量子化後の値のみを渡します.
+//-----------------------------------------------------------------------------
+inline SimInput MakeSimInput(float stickX, float stickY, uint16_t buttons)
+{
+    auto quantize = [](float value)
+    {
+        value = (value < -1.0f) ? -1.0f : (value > 1.0f) ? 1.0f : value;
+        return int16_t(value * 32767.0f);
+    };
+
+    SimInput result;
+    result.StickX  = quantize(stickX);
+    result.StickY  = quantize(stickY);
+    result.Buttons = buttons;
+    return result;
+}
@@ -0,0 +1,201 @@
+﻿//-----------------------------------------------------------------------------
+// File : Simulation.h
+// Desc : Game Simulation.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include "SimInput.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SIM_STAGE enum
+///////////////////////////////////////////////////////////////////////////////
+enum SIM_STAGE : uint32_t
+{
+    SIM_STAGE_DEFAULT = 0,      //!< 追跡移動する敵が1体だけ出現するステージ.
+    SIM_STAGE_STRESS,           //!< 発弾する敵が周期的に出現する負荷計測用ステージ.
+    SIM_STAGE_SWARM,            //!< 低頻度で発弾する敵が数千体同時に存在する負荷計測用ステージ.
+    SIM_STAGE_COUNT,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SIM_SYSTEM enum
+///////////////////////////////////////////////////////////////////////////////
+enum SIM_SYSTEM : uint32_t
+{
+    SIM_SYSTEM_SPAWN = 0,       //!< 敵生成.
+    SIM_SYSTEM_HIT,             //!< 衝突判定.
+    SIM_SYSTEM_BULLET,          //!< 弾更新.
+    SIM_SYSTEM_ENEMY,           //!< 敵更新.
+    SIM_SYSTEM_DANMAKU,         //!< 発弾プログラム実行.
+    SIM_SYSTEM_PLAYER,          //!< プレイヤー更新.
+    SIM_SYSTEM_COUNT,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// StageEvent structure
+///////////////////////////////////////////////////////////////////////////////
+struct StageEvent
+{
+    uint32_t    Tick;       //!< 初回の生成ティック.
+    uint32_t    Interval;   //!< 生成間隔 (0の場合は1回のみ).
+    uint32_t    Type;       //!< 敵タイプ.
+    float       X;          //!< 生成位置X成分 (画面の横幅に対する比率).
+    float       Y;          //!< 生成位置Y成分 (画面の縦幅に対する比率).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SimDesc structure
+///////////////////////////////////////////////////////////////////////////////
+struct SimDesc
+{
+    uint32_t    Width                   = 1920;                 //!< 画面の横幅.
+    uint32_t    Height                  = 1080;                 //!< 画面の縦幅.
+    uint32_t    Stage                   = SIM_STAGE_DEFAULT;    //!< ステージ番号.
+    uint32_t    MaxEnemyCount           = 512;                  //!< 最大敵数.
+    uint32_t    MaxPlayerBulletCount    = 256;                  //!< プレイヤー用最大弾数.
+    uint32_t    MaxEnemyBulletCount     = 8192;                 //!< エネミー用最大弾数.
+    bool        Invincible              = false;                //!< プレイヤーの被弾を無効にする場合は true.
+    bool        UseDanmaku              = true;                 //!< 発弾を DanmakuVM で行う場合は true (false の場合は IBehavior).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SimTimings structure
+///////////////////////////////////////////////////////////////////////////////
+struct SimTimings
+{
+    uint64_t    Nanoseconds[SIM_SYSTEM_COUNT] = {};     //!< システムごとの累積処理時間(ナノ秒).
+    uint64_t    TickCount                     = 0;      //!< 計測したティック数.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Simulation class
+///////////////////////////////////////////////////////////////////////////////
+class Simulation
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    static constexpr uint32_t   kTickRate = 60;                     //!< 1秒当たりのティック数.
+    static constexpr double     kTickTime = 1.0 / double(kTickRate); //!< 1ティック当たりの時間(秒).
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    Simulation();
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~Simulation();
+
+    //-------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      desc        構成設定.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //! @note       プレイヤー, 敵マネージャ, 弾マネージャはグローバルなものを使用するため,
+    //!             同時に初期化できるシミュレーションは1つだけです.
+    //-------------------------------------------------------------------------
+    bool Init(const SimDesc& desc);
+
+    //-------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //-------------------------------------------------------------------------
+    void Term();
+
+    //-------------------------------------------------------------------------
+    //! @brief      1ティック分シミュレーションを進めます.
+    //!
+    //! @param[in]      input       このティックの入力.
+    //! @note       経過時間に依存しないため, 同じ入力列からは常に同じ結果が得られます.
+    //-------------------------------------------------------------------------
+    void Step(const SimInput& input);
+
+    //-------------------------------------------------------------------------
+    //! @brief      シミュレーション状態のハッシュ値を計算します.
+    //!
+    //! @return     プレイヤー, 敵, 弾の状態から求めたハッシュ値を返却します.
+    //-------------------------------------------------------------------------
+    uint64_t CalcHash() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      経過ティック数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetTick() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      構成設定を取得します.
+    //-------------------------------------------------------------------------
+    const SimDesc& GetDesc() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      システムごとの処理時間計測を設定します.
+    //!
+    //! @param[in]      value       計測する場合は true を指定.
+    //-------------------------------------------------------------------------
+    void SetProfile(bool value);
+
+    //-------------------------------------------------------------------------
+    //! @brief      システムごとの処理時間を取得します.
+    //-------------------------------------------------------------------------
+    const SimTimings& GetTimings() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      システムごとの処理時間をリセットします.
+    //-------------------------------------------------------------------------
+    void ResetTimings();
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    SimDesc             m_Desc          = {};       //!< 構成設定.
+    const StageEvent*   m_pEvents       = nullptr;  //!< ステージイベント.
+    uint32_t            m_EventCount    = 0;        //!< ステージイベント数.
+    uint32_t            m_Tick          = 0;        //!< 経過ティック数.
+    bool                m_Profile       = false;    //!< 処理時間計測フラグ.
+    SimTimings          m_Timings       = {};       //!< 処理時間.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      現在のティックで生成する敵を生成します.
+    //-------------------------------------------------------------------------
+    void SpawnEnemies();
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      システム名を取得します.
+//!
+//! @param[in]      system      システム種別.
+//! @return     システム名を返却します.
+//-----------------------------------------------------------------------------
+const char* GetSimSystemName(SIM_SYSTEM system);
+
+//-----------------------------------------------------------------------------
+//! @brief      ステージ名を取得します.
+//!
+//! @param[in]      stage       ステージ番号.
+//! @return     ステージ名を返却します. 不正な番号の場合は nullptr を返却します.
+//-----------------------------------------------------------------------------
+const char* GetSimStageName(uint32_t stage);
@@ -355,6 +355,18 @@ enum SpriteKind
     WING_YELLOW5,
     WING_YELLOW6,
     WING_YELLOW7,
+
+    SPRITE_KIND_COUNT,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// HIT_SHAPE enum
+///////////////////////////////////////////////////////////////////////////////
+enum HIT_SHAPE : uint32_t
+{
+    HIT_SHAPE_BOX = 0,      //!< 矩形.
+    HIT_SHAPE_CIRCLE,       //!< 円.
+    HIT_SHAPE_CAPSULE,      //!< 軸平行なカプセル.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -370,6 +382,20 @@ struct SpriteData
     asdx::Vector2   uv1;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// HitBox structure
+///////////////////////////////////////////////////////////////////////////////
+struct HitBox
+{
+    float       SpriteHalfW;    //!< スプライトの横幅の半分.
+    float       SpriteHalfH;    //!< スプライトの縦幅の半分.
+    float       HalfW;          //!< 判定の芯となる矩形の横幅の半分 (スプライト中心基準).
+    float       HalfH;          //!< 判定の芯となる矩形の縦幅の半分 (スプライト中心基準).
+    float       Radius;         //!< 芯の矩形を膨らませる半径.
+    HIT_SHAPE   Shape;          //!< 判定形状.
+};
+static_assert(sizeof(HitBox) == 24, "HitBox Size Not Matched.");
+
 //-----------------------------------------------------------------------------
 //! @brief      スプライトデータを取得します.
 //! 
@@ -377,3 +403,12 @@ struct SpriteData
 //-----------------------------------------------------------------------------
 const SpriteData& GetSpriteData(SpriteKind kind);
 
+//-----------------------------------------------------------------------------
+//! @brief      当たり判定形状を取得します.
+//! 
+//! @param[in]      kind        スプライト種別.
+//! @note       矩形は Radius = 0, 円は HalfW = HalfH = 0, カプセルは短軸側の半幅 = 0 として,
+//!             全ての形状を "矩形を半径 Radius で膨らませた形状" として表します.
+//-----------------------------------------------------------------------------
+const HitBox& GetHitBox(uint16_t kind);
+
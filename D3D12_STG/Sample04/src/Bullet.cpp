@@ -103,6 +103,9 @@ bool BulletManager::Init(uint32_t count)
     m_MaxCount = count;
     m_UsedCount = 0;
 
+    m_HitStates.reserve(count);
+    m_HitMask  .reserve(GetHitMaskWordCount(count));
+
     for(auto i=0u; i<count; ++i)
     { m_FreeList.push_back(&m_Bullets[i]); }
 
@@ -116,6 +119,8 @@ void BulletManager::Term()
 {
     m_FreeList.clear();
     m_UsedList.clear();
+    m_HitStates.clear();
+    m_HitMask.clear();
     m_MaxCount  = 0;
     m_UsedCount = 0;
 
@@ -155,10 +160,14 @@ bool BulletManager::Spwan
     itr->SetAngleRate(angleRate);
     itr->SetSpeed(speed);
     itr->SetSpeedRate(speedRate);
+    itr->SetEnable();
 
     m_UsedList.push_back(itr);
     m_UsedCount++;
 
+    // 交差判定用の状態は使用中リストと同じ順序で保持する.
+    m_HitStates.push_back(itr->GetState());
+
     return true;
 }
 
@@ -170,12 +179,14 @@ void BulletManager::Update(uint32_t w, uint32_t h)
     for(auto& itr : m_UsedList)
     { itr.Update(); }
 
-    // 画面外に出たものは未使用リストに戻す.
+    // 画面外に出たものと無効化されたものは未使用リストに戻す.
+    // 生き残った弾の交差判定用の状態は同じ走査で更新しておく.
+    m_HitStates.clear();
     {
         auto itr = m_UsedList.begin();
         while(itr != m_UsedList.end())
         {
-            if (itr->IsOutOfScreen(w, h) || itr->IsEnable())
+            if (itr->IsOutOfScreen(w, h) || !itr->IsEnable())
             {
                 auto item = &(*itr);
                 itr = m_UsedList.erase(itr);
@@ -184,6 +195,7 @@ void BulletManager::Update(uint32_t w, uint32_t h)
             }
             else
             {
+                m_HitStates.push_back(itr->GetState());
                 itr++;
             }
         }
@@ -191,43 +203,47 @@ void BulletManager::Update(uint32_t w, uint32_t h)
 }
 
 //-----------------------------------------------------------------------------
-//      スプライトを描画します.
+//      交差判定を行います.
 //-----------------------------------------------------------------------------
-void BulletManager::Draw(asdx::SpriteRenderer& renderer)
+bool BulletManager::IsHit(const Entity& entity)
 {
-    for(auto& itr : m_UsedList)
-    {
-        if (!itr.IsEnable())
-            itr.Draw(renderer);
-    }
+    if (m_UsedCount == 0)
+        return false;
+
+    m_HitMask.resize(GetHitMaskWordCount(m_HitStates.size()));
+    if (HitTest(entity, m_HitStates, m_HitMask) == 0)
+        return false;
+
+    FreeMasked(m_HitMask);
+    return true;
 }
 
 //-----------------------------------------------------------------------------
-//      交差判定を行います.
+//      マスクで指定された弾を未使用リストに戻します.
 //-----------------------------------------------------------------------------
-bool BulletManager::IsHit(const Entity& entity)
+void BulletManager::FreeMasked(std::span<const uint64_t> mask)
 {
-    bool hit = false;
-
+    size_t index = 0;
+    size_t alive = 0;
     auto itr = m_UsedList.begin();
     while(itr != m_UsedList.end())
     {
-        if (itr->IsHit(entity))
+        if (IsHitMaskSet(mask, index))
         {
             auto item = &(*itr);
             itr = m_UsedList.erase(itr);
             m_FreeList.push_back(item);
             m_UsedCount--;
-
-            hit = true;
         }
         else
         {
+            m_HitStates[alive++] = m_HitStates[index];
             itr++;
         }
+        index++;
     }
 
-    return hit;
+    m_HitStates.resize(alive);
 }
 
 
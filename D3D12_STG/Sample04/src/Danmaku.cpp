@@ -0,0 +1,376 @@
+﻿//-----------------------------------------------------------------------------
+// File : Danmaku.cpp
+// Desc : Danmaku Pattern Virtual Machine.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "Danmaku.h"
+#include "Bullet.h"
+#include <fnd/asdxLogger.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// DanmakuVM class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+DanmakuVM::DanmakuVM()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+DanmakuVM::~DanmakuVM()
+{ Term(); }
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void DanmakuVM::Term()
+{ m_Batches.clear(); }
+
+//-----------------------------------------------------------------------------
+//      プログラムを登録します.
+//-----------------------------------------------------------------------------
+uint32_t DanmakuVM::AddProgram(const DanmakuProgram& program)
+{
+    auto size = program.Code.size();
+    if (size == 0 || size > UINT16_MAX)
+    {
+        ELOGA("Error : Invalid Code Size. name = %s, size = %zu", program.Name.c_str(), size);
+        return DANMAKU_INVALID_PROGRAM;
+    }
+
+    // 実行時にチェックしなくて済むように, 登録時に命令を検証しておく.
+    for(size_t i=0; i<size; ++i)
+    {
+        const auto& inst = program.Code[i];
+        if (inst.Op >= DANMAKU_OP_COUNT || inst.Slot >= DANMAKU_MAX_LOOP_DEPTH)
+        {
+            ELOGA("Error : Invalid Instruction. name = %s, index = %zu", program.Name.c_str(), i);
+            return DANMAKU_INVALID_PROGRAM;
+        }
+
+        auto branch = (inst.Op == DANMAKU_OP_JUMP || inst.Op == DANMAKU_OP_NEXT);
+        if (branch && inst.Int >= size)
+        {
+            ELOGA("Error : Invalid Branch Target. name = %s, index = %zu", program.Name.c_str(), i);
+            return DANMAKU_INVALID_PROGRAM;
+        }
+    }
+
+    Batch batch;
+    batch.Code = program.Code;
+    m_Batches.emplace_back(std::move(batch));
+
+    return uint32_t(m_Batches.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      発射体を生成します.
+//-----------------------------------------------------------------------------
+DanmakuHandle DanmakuVM::Alloc(uint32_t program, float x, float y)
+{
+    DanmakuHandle handle;
+    if (program >= m_Batches.size())
+    { return handle; }
+
+    auto& batch = m_Batches[program];
+
+    uint32_t slot;
+    if (!batch.FreeSlots.empty())
+    {
+        slot = batch.FreeSlots.back();
+        batch.FreeSlots.pop_back();
+    }
+    else
+    {
+        slot = uint32_t(batch.Active.size());
+        auto count = size_t(slot) + 1;
+
+        batch.Active   .resize(count);
+        batch.Pc       .resize(count);
+        batch.Wait     .resize(count);
+        batch.Sprite   .resize(count);
+        batch.PosX     .resize(count);
+        batch.PosY     .resize(count);
+        batch.ScaleX   .resize(count);
+        batch.ScaleY   .resize(count);
+        batch.Angle    .resize(count);
+        batch.Speed    .resize(count);
+        batch.SpeedRate.resize(count);
+        batch.AngleRate.resize(count);
+        for(auto i=0u; i<DANMAKU_MAX_LOOP_DEPTH; ++i)
+        { batch.Loop[i].resize(count); }
+    }
+
+    batch.Active   [slot] = 1;
+    batch.Pc       [slot] = 0;
+    batch.Wait     [slot] = 0;
+    batch.Sprite   [slot] = 0;
+    batch.PosX     [slot] = x;
+    batch.PosY     [slot] = y;
+    batch.ScaleX   [slot] = 1.0f;
+    batch.ScaleY   [slot] = 1.0f;
+    batch.Angle    [slot] = 0.0f;
+    batch.Speed    [slot] = 1.0f;
+    batch.SpeedRate[slot] = 0.0f;
+    batch.AngleRate[slot] = 0.0f;
+    for(auto i=0u; i<DANMAKU_MAX_LOOP_DEPTH; ++i)
+    { batch.Loop[i][slot] = 0; }
+
+    batch.ActiveCount++;
+
+    handle.Program = program;
+    handle.Slot    = slot;
+    return handle;
+}
+
+//-----------------------------------------------------------------------------
+//      発射体を破棄します.
+//-----------------------------------------------------------------------------
+void DanmakuVM::Free(const DanmakuHandle& handle)
+{
+    if (handle.Program >= m_Batches.size())
+    { return; }
+
+    auto& batch = m_Batches[handle.Program];
+    if (handle.Slot >= batch.Active.size() || batch.Active[handle.Slot] == 0)
+    { return; }
+
+    batch.Active[handle.Slot] = 0;
+    batch.FreeSlots.push_back(handle.Slot);
+    batch.ActiveCount--;
+}
+
+//-----------------------------------------------------------------------------
+//      発射体の位置を設定します.
+//-----------------------------------------------------------------------------
+void DanmakuVM::SetPos(const DanmakuHandle& handle, float x, float y)
+{
+    if (handle.Program >= m_Batches.size())
+    { return; }
+
+    auto& batch = m_Batches[handle.Program];
+    if (handle.Slot >= batch.Active.size())
+    { return; }
+
+    batch.PosX[handle.Slot] = x;
+    batch.PosY[handle.Slot] = y;
+}
+
+//-----------------------------------------------------------------------------
+//      全発射体を1ティック分実行します.
+//-----------------------------------------------------------------------------
+void DanmakuVM::Update(const asdx::Vector2& target, BulletManager& bullets)
+{
+    for(auto& batch : m_Batches)
+    {
+        if (batch.ActiveCount == 0)
+            continue;
+
+        Execute(batch, target, bullets);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      1プログラム分の発射体を実行します.
+//-----------------------------------------------------------------------------
+void DanmakuVM::Execute(Batch& batch, const asdx::Vector2& target, BulletManager& bullets)
+{
+    const auto* pCode = batch.Code.data();
+
+    auto count      = uint32_t(batch.Active.size());
+    auto pActive    = batch.Active.data();
+    auto pPc        = batch.Pc.data();
+    auto pWait      = batch.Wait.data();
+    auto pSprite    = batch.Sprite.data();
+    auto pPosX      = batch.PosX.data();
+    auto pPosY      = batch.PosY.data();
+    auto pScaleX    = batch.ScaleX.data();
+    auto pScaleY    = batch.ScaleY.data();
+    auto pAngle     = batch.Angle.data();
+    auto pSpeed     = batch.Speed.data();
+    auto pSpeedRate = batch.SpeedRate.data();
+    auto pAngleRate = batch.AngleRate.data();
+
+    for(auto i=0u; i<count; ++i)
+    {
+        if (pActive[i] == 0)
+            continue;
+
+        // 待機中は命令を実行しない.
+        if (pWait[i] != 0 && --pWait[i] != 0)
+            continue;
+
+        auto pc    = pPc[i];
+        auto angle = pAngle[i];
+        auto yield = false;
+
+        // 無限ループでも止まるように, 1ティックの実行命令数を制限する.
+        for(auto executed=0u; executed<DANMAKU_MAX_STEP_PER_TICK && !yield; ++executed)
+        {
+            const auto& inst = pCode[pc];
+            switch(inst.Op)
+            {
+            case DANMAKU_OP_END:
+                yield = true;
+                break;
+
+            case DANMAKU_OP_WAIT:
+                pWait[i] = inst.Int;
+                pc++;
+                yield = true;
+                break;
+
+            case DANMAKU_OP_JUMP:
+                pc = inst.Int;
+                break;
+
+            case DANMAKU_OP_REPEAT:
+                batch.Loop[inst.Slot][i] = inst.Int;
+                pc++;
+                break;
+
+            case DANMAKU_OP_NEXT:
+                {
+                    auto& counter = batch.Loop[inst.Slot][i];
+                    if (counter > 1)
+                    {
+                        counter--;
+                        pc = inst.Int;
+                    }
+                    else
+                    {
+                        counter = 0;
+                        pc++;
+                    }
+                }
+                break;
+
+            case DANMAKU_OP_SPRITE:
+                pSprite[i] = inst.Int;
+                pc++;
+                break;
+
+            case DANMAKU_OP_SCALE:
+                pScaleX[i] = inst.X;
+                pScaleY[i] = inst.Y;
+                pc++;
+                break;
+
+            case DANMAKU_OP_ANGLE:
+                angle = inst.X;
+                pc++;
+                break;
+
+            case DANMAKU_OP_TURN:
+                angle = asdx::Wrap(angle + inst.X, -360.0f, 360.0f);
+                pc++;
+                break;
+
+            case DANMAKU_OP_AIM:
+                angle = asdx::ToDegree(atan2f(target.y - pPosY[i], target.x - pPosX[i])) + inst.X;
+                pc++;
+                break;
+
+            case DANMAKU_OP_SPEED:
+                pSpeed[i] = inst.X;
+                pc++;
+                break;
+
+            case DANMAKU_OP_SPEED_RATE:
+                pSpeedRate[i] = inst.X;
+                pc++;
+                break;
+
+            case DANMAKU_OP_ANGLE_RATE:
+                pAngleRate[i] = inst.X;
+                pc++;
+                break;
+
+            case DANMAKU_OP_NWAY:
+                {
+                    auto n = inst.Int;
+                    for(auto k=0u; k<n; ++k)
+                    {
+                        auto a = (n == 1) ? angle : angle + inst.X * (float(k) / float(n - 1) - 0.5f);
+                        bullets.Spwan(
+                            pSprite[i],
+                            pPosX[i], pPosY[i],
+                            pScaleX[i], pScaleY[i],
+                            a,
+                            pAngleRate[i],
+                            pSpeed[i],
+                            pSpeedRate[i]);
+                    }
+                    pc++;
+                }
+                break;
+
+            case DANMAKU_OP_RING:
+                {
+                    auto n    = inst.Int;
+                    auto step = 360.0f / float(n);
+                    for(auto k=0u; k<n; ++k)
+                    {
+                        bullets.Spwan(
+                            pSprite[i],
+                            pPosX[i], pPosY[i],
+                            pScaleX[i], pScaleY[i],
+                            angle + step * k,
+                            pAngleRate[i],
+                            pSpeed[i],
+                            pSpeedRate[i]);
+                    }
+                    pc++;
+                }
+                break;
+
+            default:
+                yield = true;
+                break;
+            }
+        }
+
+        pPc[i]    = pc;
+        pAngle[i] = angle;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      登録されているプログラム数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t DanmakuVM::GetProgramCount() const
+{ return uint32_t(m_Batches.size()); }
+
+//-----------------------------------------------------------------------------
+//      生存している発射体の数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t DanmakuVM::GetActiveCount() const
+{
+    uint32_t result = 0;
+    for(const auto& batch : m_Batches)
+    { result += batch.ActiveCount; }
+    return result;
+}
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Global Variables.
+//-----------------------------------------------------------------------------
+static DanmakuVM g_DanmakuVM;
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+//      弾幕VMを取得します.
+//-----------------------------------------------------------------------------
+DanmakuVM& GetDanmakuVM()
+{ return g_DanmakuVM; }
@@ -0,0 +1,321 @@
+﻿//-----------------------------------------------------------------------------
+// File : DanmakuAssembler.cpp
+// Desc : Danmaku Pattern Assembler.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "Danmaku.h"
+#include <fnd/asdxLogger.h>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// OpInfo structure
+///////////////////////////////////////////////////////////////////////////////
+struct OpInfo
+{
+    const char*     Name;   //!< ニーモニック.
+    DANMAKU_OP      Op;     //!< 命令.
+    const char*     Args;   //!< オペランド ('i':整数, 'f':実数, 'F':省略可能な実数, 'L':ラベル).
+    uint32_t        MinInt; //!< 整数オペランドの最小値.
+};
+
+// 命令テーブル.
+const OpInfo kOpInfos[] = {
+    { "end",        DANMAKU_OP_END,         "",     0 },
+    { "wait",       DANMAKU_OP_WAIT,        "i",    1 },
+    { "jump",       DANMAKU_OP_JUMP,        "L",    0 },
+    { "repeat",     DANMAKU_OP_REPEAT,      "i",    1 },
+    { "next",       DANMAKU_OP_NEXT,        "",     0 },
+    { "sprite",     DANMAKU_OP_SPRITE,      "i",    0 },
+    { "scale",      DANMAKU_OP_SCALE,       "fF",   0 },
+    { "angle",      DANMAKU_OP_ANGLE,       "f",    0 },
+    { "turn",       DANMAKU_OP_TURN,        "f",    0 },
+    { "aim",        DANMAKU_OP_AIM,         "F",    0 },
+    { "speed",      DANMAKU_OP_SPEED,       "f",    0 },
+    { "speedrate",  DANMAKU_OP_SPEED_RATE,  "f",    0 },
+    { "anglerate",  DANMAKU_OP_ANGLE_RATE,  "f",    0 },
+    { "nway",       DANMAKU_OP_NWAY,        "if",   1 },
+    { "ring",       DANMAKU_OP_RING,        "i",    1 },
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Fixup structure
+///////////////////////////////////////////////////////////////////////////////
+struct Fixup
+{
+    uint32_t        Index;  //!< 分岐先を書き換える命令番号.
+    std::string     Label;  //!< 分岐先ラベル.
+    uint32_t        Line;   //!< 行番号.
+};
+
+//-----------------------------------------------------------------------------
+//      ニーモニックから命令情報を検索します.
+//-----------------------------------------------------------------------------
+const OpInfo* FindOpInfo(const std::string& name)
+{
+    for(const auto& info : kOpInfos)
+    {
+        if (name == info.Name)
+            return &info;
+    }
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//      1行をトークンに分割します.
+//-----------------------------------------------------------------------------
+void Tokenize(const char* begin, const char* end, std::vector<std::string>& tokens)
+{
+    tokens.clear();
+
+    auto ptr = begin;
+    while(ptr < end)
+    {
+        // コメント以降は無視.
+        if (*ptr == ';' || *ptr == '#')
+            break;
+
+        if (*ptr == ' ' || *ptr == '\t' || *ptr == ',' || *ptr == '\r')
+        {
+            ptr++;
+            continue;
+        }
+
+        auto head = ptr;
+        while(ptr < end && *ptr != ' ' && *ptr != '\t' && *ptr != ',' && *ptr != '\r' && *ptr != ';' && *ptr != '#')
+        { ptr++; }
+
+        tokens.emplace_back(head, ptr);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      実数を解析します.
+//-----------------------------------------------------------------------------
+bool ParseFloat(const std::string& token, float& value)
+{
+    char* end = nullptr;
+    value = strtof(token.c_str(), &end);
+    return end != token.c_str() && *end == '\0';
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// DanmakuAssembler class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      シンボルを定義します.
+//-----------------------------------------------------------------------------
+void DanmakuAssembler::DefineSymbol(const char* name, int value)
+{ m_Symbols[name] = value; }
+
+//-----------------------------------------------------------------------------
+//      定義済みシンボルをクリアします.
+//-----------------------------------------------------------------------------
+void DanmakuAssembler::ClearSymbols()
+{ m_Symbols.clear(); }
+
+//-----------------------------------------------------------------------------
+//      テキストをアセンブルします.
+//-----------------------------------------------------------------------------
+bool DanmakuAssembler::Assemble(const char* name, const char* source, DanmakuProgram& program) const
+{
+    if (name == nullptr || source == nullptr)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+    std::vector<DanmakuInst>                    code;
+    std::vector<std::string>                    tokens;
+    std::vector<Fixup>                          fixups;
+    std::vector<uint32_t>                       loops;      // 対応する next を待っている repeat の命令番号.
+    std::unordered_map<std::string, uint32_t>   labels;
+
+    // 整数オペランドを解析する.
+    auto parseInt = [&](const std::string& token, uint32_t minValue, uint16_t& value)
+    {
+        long result = 0;
+        auto itr = m_Symbols.find(token);
+        if (itr != m_Symbols.end())
+        {
+            result = itr->second;
+        }
+        else
+        {
+            char* end = nullptr;
+            result = strtol(token.c_str(), &end, 0);
+            if (end == token.c_str() || *end != '\0')
+                return false;
+        }
+
+        if (result < long(minValue) || result > UINT16_MAX)
+            return false;
+
+        value = uint16_t(result);
+        return true;
+    };
+
+    uint32_t line = 0;
+    auto ptr = source;
+    while(*ptr != '\0')
+    {
+        auto head = ptr;
+        while(*ptr != '\0' && *ptr != '\n')
+        { ptr++; }
+
+        line++;
+        Tokenize(head, ptr, tokens);
+
+        if (*ptr == '\n')
+        { ptr++; }
+
+        size_t index = 0;
+
+        // ラベル定義.
+        while(index < tokens.size() && tokens[index].size() > 1 && tokens[index].back() == ':')
+        {
+            auto label = tokens[index].substr(0, tokens[index].size() - 1);
+            if (labels.find(label) != labels.end())
+            {
+                ELOGA("Error : %s(%u) : Label Redefinition. label = %s", name, line, label.c_str());
+                return false;
+            }
+
+            labels[label] = uint32_t(code.size());
+            index++;
+        }
+
+        if (index >= tokens.size())
+            continue;
+
+        auto info = FindOpInfo(tokens[index]);
+        if (info == nullptr)
+        {
+            ELOGA("Error : %s(%u) : Unknown Instruction. token = %s", name, line, tokens[index].c_str());
+            return false;
+        }
+        index++;
+
+        // オペランド数をチェック.
+        auto maxArgs = strlen(info->Args);
+        auto minArgs = maxArgs;
+        while(minArgs > 0 && info->Args[minArgs - 1] == 'F')
+        { minArgs--; }
+
+        auto argCount = tokens.size() - index;
+        if (argCount < minArgs || argCount > maxArgs)
+        {
+            ELOGA("Error : %s(%u) : Invalid Operand Count. instruction = %s", name, line, info->Name);
+            return false;
+        }
+
+        DanmakuInst inst;
+        inst.Op = info->Op;
+
+        // 実数オペランドは X, Y の順に格納する.
+        uint32_t floatCount = 0;
+
+        for(size_t i=0; i<argCount; ++i)
+        {
+            const auto& token = tokens[index + i];
+            auto valid = true;
+
+            switch(info->Args[i])
+            {
+            case 'i':
+                valid = parseInt(token, info->MinInt, inst.Int);
+                break;
+
+            case 'f':
+            case 'F':
+                valid = ParseFloat(token, (floatCount++ == 0) ? inst.X : inst.Y);
+                break;
+
+            case 'L':
+                fixups.push_back({ uint32_t(code.size()), token, line });
+                break;
+            }
+
+            if (!valid)
+            {
+                ELOGA("Error : %s(%u) : Invalid Operand. token = %s", name, line, token.c_str());
+                return false;
+            }
+        }
+
+        // scale の Y 成分を省略した場合は X 成分と同じにする.
+        if (info->Op == DANMAKU_OP_SCALE && argCount == 1)
+        { inst.Y = inst.X; }
+
+        // repeat / next の対応付け.
+        if (info->Op == DANMAKU_OP_REPEAT)
+        {
+            if (loops.size() >= DANMAKU_MAX_LOOP_DEPTH)
+            {
+                ELOGA("Error : %s(%u) : Loop Nesting Too Deep. max = %u", name, line, DANMAKU_MAX_LOOP_DEPTH);
+                return false;
+            }
+
+            inst.Slot = uint8_t(loops.size());
+            loops.push_back(uint32_t(code.size()));
+        }
+        else if (info->Op == DANMAKU_OP_NEXT)
+        {
+            if (loops.empty())
+            {
+                ELOGA("Error : %s(%u) : 'next' Without 'repeat'.", name, line);
+                return false;
+            }
+
+            inst.Slot = uint8_t(loops.size() - 1);
+            inst.Int  = uint16_t(loops.back() + 1);
+            loops.pop_back();
+        }
+
+        if (code.size() + 1 >= UINT16_MAX)
+        {
+            ELOGA("Error : %s(%u) : Program Too Large.", name, line);
+            return false;
+        }
+
+        code.push_back(inst);
+    }
+
+    if (!loops.empty())
+    {
+        ELOGA("Error : %s : 'repeat' Without 'next'.", name);
+        return false;
+    }
+
+    // 末尾に終了命令を追加.
+    code.push_back(DanmakuInst());
+
+    // 分岐先を解決.
+    for(const auto& fixup : fixups)
+    {
+        auto itr = labels.find(fixup.Label);
+        if (itr == labels.end())
+        {
+            ELOGA("Error : %s(%u) : Undefined Label. label = %s", name, fixup.Line, fixup.Label.c_str());
+            return false;
+        }
+
+        code[fixup.Index].Int = uint16_t(itr->second);
+    }
+
+    program.Name = name;
+    program.Code = std::move(code);
+
+    return true;
+}
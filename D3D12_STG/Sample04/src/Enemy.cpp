@@ -10,6 +10,8 @@
 #include "Enemy.h"
 #include "Bullet.h"
 #include <fnd/asdxLogger.h>
+#include <bit>
+#include <limits>
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -39,7 +41,8 @@ void Enemy::Setup
     float               sx,
     float               sy,
     IBehavior*          pShotBehavior,
-    IBehavior*          pMoveBehavior
+    IBehavior*          pMoveBehavior,
+    uint32_t            shotProgram
 )
 {
     SetKind(kind);
@@ -47,6 +50,26 @@ void Enemy::Setup
     SetScale(sx, sy);
     m_pShotBehavior = pShotBehavior;
     m_pMoveBehavior = pMoveBehavior;
+
+    // 再利用時に前回の状態が残らないようにする.
+    m_Param = asdx::Vector4(0.0f, 0.0f, 0.0f, 0.0f);
+    m_Timer = 0;
+
+    Release();
+    if (shotProgram != DANMAKU_INVALID_PROGRAM)
+    { m_Emitter = GetDanmakuVM().Alloc(shotProgram, x, y); }
+}
+
+//-----------------------------------------------------------------------------
+//      発弾プログラムの発射体を破棄します.
+//-----------------------------------------------------------------------------
+void Enemy::Release()
+{
+    if (!m_Emitter.IsValid())
+        return;
+
+    GetDanmakuVM().Free(m_Emitter);
+    m_Emitter = DanmakuHandle();
 }
 
 //-----------------------------------------------------------------------------
@@ -80,6 +103,13 @@ void Enemy::Update()
     if (m_pShotBehavior != nullptr)
     { m_pShotBehavior->OnTick(*this); }
 
+    // 発弾プログラムは DanmakuVM::Update() でまとめて実行するので, 位置だけ渡しておく.
+    if (m_Emitter.IsValid())
+    {
+        auto pos = GetCenter();
+        GetDanmakuVM().SetPos(m_Emitter, pos.x, pos.y);
+    }
+
     m_Timer++;
 }
 
@@ -117,6 +147,9 @@ bool EnemyManager::Init(uint32_t count)
     m_MaxCount = count;
     m_UsedCount = 0;
 
+    m_HitStates.reserve(count);
+    m_HitMask  .reserve(GetHitMaskWordCount(count));
+
     for(auto i=0u; i<count; ++i)
     { m_FreeList.push_back(&m_Enemies[i]); }
 
@@ -128,8 +161,14 @@ bool EnemyManager::Init(uint32_t count)
 //-----------------------------------------------------------------------------
 void EnemyManager::Term()
 {
+    for(auto& itr : m_UsedList)
+    { itr.Release(); }
+
     m_FreeList.clear();
     m_UsedList.clear();
+    m_HitStates.clear();
+    m_HitMask.clear();
+    m_DeadMask.clear();
     m_MaxCount  = 0;
     m_UsedCount = 0;
 
@@ -182,11 +221,15 @@ bool EnemyManager::Spwan(uint32_t type, float x, float y, float sx, float sy)
         sx,
         sy,
         item->second.pShotBehavior,
-        item->second.pMoveBehavior);
+        item->second.pMoveBehavior,
+        item->second.ShotProgram);
 
     m_UsedList.push_back(itr);
     m_UsedCount++;
 
+    // 交差判定用の状態は使用中リストと同じ順序で保持する.
+    m_HitStates.push_back(itr->GetState());
+
     return true;
 }
 
@@ -199,6 +242,8 @@ void EnemyManager::Update(uint32_t w, uint32_t h)
     { itr.Update(); }
 
     // 画面外に出たものは未使用リストに戻す.
+    // 生き残った敵の交差判定用の状態は同じ走査で更新しておく.
+    m_HitStates.clear();
     {
         auto itr = m_UsedList.begin();
         while(itr != m_UsedList.end())
@@ -206,53 +251,34 @@ void EnemyManager::Update(uint32_t w, uint32_t h)
             if (itr->IsOutOfScreen(w, h))
             {
                 auto item = &(*itr);
+                item->Release();
                 itr = m_UsedList.erase(itr);
                 m_FreeList.push_back(item);
                 m_UsedCount--;
             }
             else
             {
+                m_HitStates.push_back(itr->GetState());
                 itr++;
             }
         }
     }
 }
 
-//-----------------------------------------------------------------------------
-//      スプライトを描画します.
-//-----------------------------------------------------------------------------
-void EnemyManager::Draw(asdx::SpriteRenderer& renderer)
-{
-    for(auto& itr : m_UsedList)
-    { itr.Draw(renderer); }
-}
-
 //-----------------------------------------------------------------------------
 //      交差判定を行います.
 //-----------------------------------------------------------------------------
 bool EnemyManager::IsHit(const Entity& entity)
 {
-    bool hit = false;
-
-    auto itr = m_UsedList.begin();
-    while(itr != m_UsedList.end())
-    {
-        if (itr->IsHit(entity))
-        {
-            auto item = &(*itr);
-            itr = m_UsedList.erase(itr);
-            m_FreeList.push_back(item);
-            m_UsedCount--;
+    if (m_UsedCount == 0)
+        return false;
 
-            hit = true;
-        }
-        else
-        {
-            itr++;
-        }
-    }
+    m_HitMask.resize(GetHitMaskWordCount(m_HitStates.size()));
+    if (HitTest(entity, m_HitStates, m_HitMask) == 0)
+        return false;
 
-    return hit;
+    FreeMasked(m_HitMask);
+    return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -260,28 +286,69 @@ bool EnemyManager::IsHit(const Entity& entity)
 //-----------------------------------------------------------------------------
 void EnemyManager::CheckHit(BulletManager& bulletManager)
 {
+    if (m_UsedCount == 0)
+        return;
+
+    m_HitMask.resize(GetHitMaskWordCount(m_HitStates.size()));
+    m_DeadMask.assign(m_HitMask.size(), 0);
+
+    auto dead = false;
     auto action = [&](Bullet& bullet)
     {
-        auto itr = m_UsedList.begin();
-        while(itr != m_UsedList.end())
+        if (HitTest(bullet, m_HitStates, m_HitMask) == 0)
+            return;
+
+        // 撃破した敵は以降の弾と交差しないように無限遠に飛ばしておく.
+        for(size_t i=0; i<m_HitMask.size(); ++i)
         {
-            if (itr->IsHit(bullet))
-            {
-                auto item = &(*itr);
-                itr = m_UsedList.erase(itr);
-                m_FreeList.push_back(item);
-                m_UsedCount--;
+            auto bits = m_HitMask[i];
+            m_DeadMask[i] |= bits;
 
-                bullet.SetDisable();
-            }
-            else
+            while(bits != 0)
             {
-                itr++;
+                auto index = i * 64 + size_t(std::countr_zero(bits));
+                m_HitStates[index].X = std::numeric_limits<float>::infinity();
+                bits &= bits - 1;
             }
         }
+
+        bullet.SetDisable();
+        dead = true;
     };
 
     bulletManager.ForEach(action);
+
+    if (dead)
+    { FreeMasked(m_DeadMask); }
+}
+
+//-----------------------------------------------------------------------------
+//      マスクで指定された敵を未使用リストに戻します.
+//-----------------------------------------------------------------------------
+void EnemyManager::FreeMasked(std::span<const uint64_t> mask)
+{
+    size_t index = 0;
+    size_t alive = 0;
+    auto itr = m_UsedList.begin();
+    while(itr != m_UsedList.end())
+    {
+        if (IsHitMaskSet(mask, index))
+        {
+            auto item = &(*itr);
+            item->Release();
+            itr = m_UsedList.erase(itr);
+            m_FreeList.push_back(item);
+            m_UsedCount--;
+        }
+        else
+        {
+            m_HitStates[alive++] = m_HitStates[index];
+            itr++;
+        }
+        index++;
+    }
+
+    m_HitStates.resize(alive);
 }
 
 //-----------------------------------------------------------------------------
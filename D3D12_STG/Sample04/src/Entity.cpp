@@ -9,7 +9,16 @@
 //-----------------------------------------------------------------------------
 #include "Entity.h"
 #include "SpriteData.h"
-#include <gfx/asdxSprite.h>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define STG_HIT_TEST_SSE2   1
+#else
+#define STG_HIT_TEST_SSE2   0
+#endif
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -234,10 +243,10 @@ float Entity::GetPosY() const
 //-----------------------------------------------------------------------------
 asdx::Vector2 Entity::GetCenter() const
 {
-    const auto& data = GetSpriteData(SpriteKind(m_Kind));
+    const auto& box = GetHitBox(m_Kind);
     asdx::Vector2 result;
-    result.x = m_Pos.x + (data.W * 0.5f) * m_Scale.x;
-    result.y = m_Pos.y + (data.H * 0.5f) * m_Scale.y;
+    result.x = m_Pos.x + box.SpriteHalfW * m_Scale.x;
+    result.y = m_Pos.y + box.SpriteHalfH * m_Scale.y;
     return result;
 }
 
@@ -245,19 +254,13 @@ asdx::Vector2 Entity::GetCenter() const
 //      中心座標のX成分を取得します.
 //-----------------------------------------------------------------------------
 float Entity::GetCenterX() const
-{
-    const auto& data = GetSpriteData(SpriteKind(m_Kind));
-    return m_Pos.x + (data.W * 0.5f) * m_Scale.x;
-}
+{ return m_Pos.x + GetHitBox(m_Kind).SpriteHalfW * m_Scale.x; }
 
 //-----------------------------------------------------------------------------
 //      中心座標のY成分を取得します.
 //-----------------------------------------------------------------------------
 float Entity::GetCenterY() const
-{
-    const auto& data = GetSpriteData(SpriteKind(m_Kind));
-    return m_Pos.y + (data.H * 0.5f) * m_Scale.y;
-}
+{ return m_Pos.y + GetHitBox(m_Kind).SpriteHalfH * m_Scale.y; }
 
 //-----------------------------------------------------------------------------
 //      スプライトサイズを取得します.
@@ -295,21 +298,6 @@ float Entity::GetScaleX() const
 float Entity::GetScaleY() const
 { return m_Scale.y; }
 
-//-----------------------------------------------------------------------------
-//      スプライトを描画します.
-//-----------------------------------------------------------------------------
-void Entity::Draw(asdx::SpriteRenderer& renderer)
-{
-    const auto& data = GetSpriteData(SpriteKind(m_Kind));
-    renderer.Add(
-        int(m_Pos.x),
-        int(m_Pos.y),
-        int(data.W * m_Scale.x),
-        int(data.H * m_Scale.y),
-        data.uv0,
-        data.uv1);
-}
-
 //-----------------------------------------------------------------------------
 //      交差判定を行います.
 //-----------------------------------------------------------------------------
@@ -324,7 +312,23 @@ bool Entity::IsHit(const asdx::Vector2& pos, const asdx::Int2& size) const
 //      交差判定を行います.
 //-----------------------------------------------------------------------------
 bool Entity::IsHit(const Entity& target) const
-{ return IsHit(target.GetPos(), target.GetSize()); }
+{ return IsHitState(GetState(), target.GetState()); }
+
+//-----------------------------------------------------------------------------
+//      当たり判定用の状態を取得します.
+//-----------------------------------------------------------------------------
+EntityState Entity::GetState() const
+{
+    const auto& box = GetHitBox(m_Kind);
+
+    EntityState result;
+    result.X      = m_Pos.x + box.SpriteHalfW * m_Scale.x;
+    result.Y      = m_Pos.y + box.SpriteHalfH * m_Scale.y;
+    result.HalfW  = box.HalfW * m_Scale.x;
+    result.HalfH  = box.HalfH * m_Scale.y;
+    result.Radius = box.Radius * std::min(m_Scale.x, m_Scale.y);
+    return result;
+}
 
 //-----------------------------------------------------------------------------
 //      画面外かどうか判定します.
@@ -341,3 +345,82 @@ bool Entity::IsOutOfScreen(uint32_t w, uint32_t h)
 //-----------------------------------------------------------------------------
 float Entity::ToAngle(const asdx::Vector2& targetPos)
 { return asdx::ToDegree(atan2f(targetPos.y - m_Pos.y, targetPos.x - m_Pos.x)); }
+
+//-----------------------------------------------------------------------------
+//      1つの状態と複数の状態の交差判定をまとめて行います.
+//-----------------------------------------------------------------------------
+uint32_t HitTest(const EntityState& target, std::span<const EntityState> states, std::span<uint64_t> mask)
+{
+    auto count = states.size();
+    auto words = GetHitMaskWordCount(count);
+    assert(mask.size() >= words);
+    std::fill(mask.begin(), mask.begin() + words, 0ull);
+
+    uint32_t hits = 0;
+    size_t   i    = 0;
+
+#if STG_HIT_TEST_SSE2
+    const auto tx      = _mm_set1_ps(target.X);
+    const auto ty      = _mm_set1_ps(target.Y);
+    const auto thw     = _mm_set1_ps(target.HalfW);
+    const auto thh     = _mm_set1_ps(target.HalfH);
+    const auto tr      = _mm_set1_ps(target.Radius);
+    const auto zero    = _mm_setzero_ps();
+    const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    // 4要素ずつ転置して判定し, 64要素分溜まったらマスクに書き出す.
+    uint64_t word = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        const auto* p = states.data() + i;
+
+        auto x  = _mm_loadu_ps(&p[0].X);
+        auto y  = _mm_loadu_ps(&p[1].X);
+        auto hw = _mm_loadu_ps(&p[2].X);
+        auto hh = _mm_loadu_ps(&p[3].X);
+        _MM_TRANSPOSE4_PS(x, y, hw, hh);
+        auto r = _mm_setr_ps(p[0].Radius, p[1].Radius, p[2].Radius, p[3].Radius);
+
+        auto ex = _mm_sub_ps(_mm_and_ps(_mm_sub_ps(x, tx), absMask), _mm_add_ps(hw, thw));
+        auto ey = _mm_sub_ps(_mm_and_ps(_mm_sub_ps(y, ty), absMask), _mm_add_ps(hh, thh));
+        auto rs = _mm_add_ps(r, tr);
+        auto cx = _mm_max_ps(ex, zero);
+        auto cy = _mm_max_ps(ey, zero);
+        auto d2 = _mm_add_ps(_mm_mul_ps(cx, cx), _mm_mul_ps(cy, cy));
+
+        auto overlap = _mm_and_ps(_mm_cmplt_ps(ex, zero), _mm_cmplt_ps(ey, zero));
+        auto reach   = _mm_cmplt_ps(d2, _mm_mul_ps(rs, rs));
+        auto bits    = uint64_t(_mm_movemask_ps(_mm_or_ps(overlap, reach)));
+
+        word |= bits << (i & 63);
+
+        if ((i & 63) == 60)
+        {
+            mask[i >> 6] = word;
+            hits += uint32_t(std::popcount(word));
+            word = 0;
+        }
+    }
+
+    if (word != 0)
+    {
+        mask[i >> 6] = word;
+        hits += uint32_t(std::popcount(word));
+    }
+#endif
+
+    for(; i<count; ++i)
+    {
+        auto bit = uint64_t(IsHitState(target, states[i]) ? 1 : 0);
+        mask[i >> 6] |= bit << (i & 63);
+        hits += uint32_t(bit);
+    }
+
+    return hits;
+}
+
+//-----------------------------------------------------------------------------
+//      1つのエンティティと複数の状態の交差判定をまとめて行います.
+//-----------------------------------------------------------------------------
+uint32_t HitTest(const Entity& target, std::span<const EntityState> states, std::span<uint64_t> mask)
+{ return HitTest(target.GetState(), states, mask); }
@@ -12,9 +12,9 @@
 #include <fnd/asdxPath.h>
 #include <fnd/asdxMisc.h>
 #include <fnd/asdxFileIO.h>
+#include "Player.h"
 #include "Bullet.h"
 #include "Enemy.h"
-#include "MoveBehavior.h"
 
 #if ASDX_DEBUG
 #include <edit/asdxGuiMgr.h>
@@ -40,10 +40,28 @@ asdx::TextureHolder LoadTexture(const char* path)
     return asdx::TextureManager::Instance().GetOrCreate(findPath.string().c_str());
 }
 
-// 移動挙動.
-OneWayMoveBehavior  g_OneWayMoveBehavior;
-WaveMoveBehavior    g_WaveMoveBehavior;
-AimingMoveBehavior  g_AimingMoveBahavior;
+//-----------------------------------------------------------------------------
+//      エンティティを描画します.
+//-----------------------------------------------------------------------------
+void DrawEntity(asdx::SpriteRenderer& renderer, const Entity& entity)
+{
+    const auto& data  = GetSpriteData(SpriteKind(entity.GetKind()));
+    const auto& pos   = entity.GetPos();
+    const auto& scale = entity.GetScale();
+    renderer.Add(
+        int(pos.x),
+        int(pos.y),
+        int(data.W * scale.x),
+        int(data.H * scale.y),
+        data.uv0,
+        data.uv1);
+}
+
+// 1フレームで処理する最大ティック数.
+constexpr uint32_t kMaxTickPerFrame = 4;
+
+// リプレイの保存先.
+constexpr const char* kReplayPath = "replay.stgr";
 
 } // namespace
 
@@ -191,86 +209,25 @@ bool GameApp::OnInit()
         }
     }
 
-    // プレイヤー用弾マネージャの初期化.
-    if (!GetPlayerBulletMgr().Init(256))
+    // シミュレーション初期化.
     {
-        ELOGA("Error : Player Bullet Manager Initialize Failed.");
-        return false;
-    }
-
-    // プレイヤー用弾マネージャの初期アk処理.
-    if (!GetEnemyBulletMgr().Init(8192))
-    {
-        ELOGA("Error : Enemy Bullet Manager Initialize Failed.");
-        return false;
-    }
-
-    // プレイヤー初期化.
-    {
-        auto& player = GetPlayer();
-        player.Init(m_Width * 0.5f, float(m_Height), 1.0f, 1.0f, true);
-        player.SetPadLock(false);
-    }
-
-    auto& enemyMgr = GetEnemyMgr();
-    // エネミーマネージャ初期化.
-    if (!enemyMgr.Init(512))
-    {
-        ELOGA("Error : Enemy Manager Initialize Failed.");
-        return false;
-    }
-
-    // 直線移動.
-    {
-        OneWayMoveBehavior::Param param = {};
-        param.Velocity = asdx::Vector2(0.0f, 2.0f);
-
-        g_OneWayMoveBehavior.SetParam(param);
-
-        EnemyManager::SpawnParam spawnParam = {};
-        spawnParam.SpriteKind    = ENEMY_BLACK1;
-        spawnParam.pMoveBehavior = &g_OneWayMoveBehavior;
-
-        enemyMgr.AddType(0, spawnParam);
-    }
+        SimDesc desc;
+        desc.Width  = m_Width;
+        desc.Height = m_Height;
+        desc.Stage  = SIM_STAGE_DEFAULT;
 
-    // 波状移動.
-    {
-        WaveMoveBehavior::Param param = {};
-        param.Speed         = 1.0f;
-        param.Amplitude     = 200.0f;
-        param.AngleScale    = 2.0f;
-        param.AngleOffset   = 0.0f;
-
-        g_WaveMoveBehavior.SetParam(param);
-
-        EnemyManager::SpawnParam spawnParam = {};
-        spawnParam.SpriteKind    = ENEMY_BLACK1;
-        spawnParam.pMoveBehavior = &g_WaveMoveBehavior;
-
-        enemyMgr.AddType(1, spawnParam);
-    }
-
-    // 追跡移動.
-    {
-        AimingMoveBehavior::Param param = {};
-        param.Interval  = 90;
-        param.Speed     = 3.0f;
-
-        g_AimingMoveBahavior.SetParam(param);
-
-        EnemyManager::SpawnParam spawnParam = {};
-        spawnParam.SpriteKind    = ENEMY_BLACK1;
-        spawnParam.pMoveBehavior = &g_AimingMoveBahavior;
+        if (!m_Simulation.Init(desc))
+        {
+            ELOGA("Error : Simulation::Init() Failed.");
+            return false;
+        }
 
-        enemyMgr.AddType(2, spawnParam);
+        m_Replay.Reset(desc);
+        m_TickTime = 0.0;
     }
 
-    // 敵生成.
-    {
-        m_SpawnType = 2;
-        enemyMgr.Spwan(m_SpawnType, m_Width * 0.5f, 0.0f);
-    }
+    // ゲームパッド初期化.
+    m_Pad.SetPlayerIndex(0);
 
     // コマンドの記録を終了.
     pCmd->Close();
@@ -310,8 +267,7 @@ void GameApp::OnTerm()
 
     asdx::TextureManager::Instance().Term();
 
-    GetPlayerBulletMgr().Term();
-    GetEnemyBulletMgr ().Term();
+    m_Simulation.Term();
 
     m_Font.Term();
 
@@ -339,26 +295,41 @@ void GameApp::OnFrameMove(const base::FrameEventArgs& args)
     m_SpriteRenderer.Reset();
     m_SpriteRenderer.SetScreenSize(m_Width, m_Height);
 
-    auto& player       = GetPlayer();
-    auto& enemyMgr     = GetEnemyMgr();
-    auto& enemyBullet  = GetEnemyBulletMgr();
-    auto& playerBullet = GetPlayerBulletMgr();
+    // パッド更新.
+    m_Pad.UpdateState();
 
-    auto isGameOver = player.IsGameOver();
+    // 入力はティック単位で量子化してからシミュレーションに渡す.
+    auto input = MakeSimInput(
+        m_Pad.GetNormalizedThumbLX(),
+        m_Pad.GetNormalizedThumbLY(),
+        uint16_t(m_Pad.IsDown(asdx::PAD_B) ? SIM_BUTTON_SHOT : 0));
 
-    if (!isGameOver)
+    // 固定時間ステップでシミュレーションを進める.
     {
-        // プレイヤー弾と敵リストの衝突判定.
-        enemyMgr.CheckHit(playerBullet);
+        m_TickTime += double(args.ElapsedTimeSec);
 
-        // プレイヤーダメージ判定.
-        auto playerHit = enemyBullet.IsHit(player) || enemyMgr.IsHit(player);
-        if (playerHit)
+        auto tickCount = 0u;
+        while(m_TickTime >= Simulation::kTickTime && tickCount < kMaxTickPerFrame)
         {
-            player.SetDamage(true);
+            m_Simulation.Step(input);
+            m_Replay.Add(input, m_Simulation.CalcHash());
+
+            m_TickTime -= Simulation::kTickTime;
+            tickCount++;
         }
+
+        // 処理落ちした分は追いかけない.
+        if (tickCount == kMaxTickPerFrame)
+        { m_TickTime = 0.0; }
     }
 
+    const auto& player       = GetPlayer();
+    const auto& enemyMgr     = GetEnemyMgr();
+    const auto& enemyBullet  = GetEnemyBulletMgr();
+    const auto& playerBullet = GetPlayerBulletMgr();
+
+    auto isGameOver = player.IsGameOver();
+
 
     // スクロールスピード設定.
     const auto kMoveSpeedBG0   = 350.0f;
@@ -392,19 +363,21 @@ void GameApp::OnFrameMove(const base::FrameEventArgs& args)
     // スプライトチップ設定.
     m_SpriteRenderer.SetTexture(m_SpriteChip.GetHandleGPU(), m_LinearClamp.GetHandleGPU());
 
-    // 弾制御.
-    enemyBullet .Update(m_Width, m_Height);
-    playerBullet.Update(m_Width, m_Height);
-    enemyBullet .Draw(m_SpriteRenderer);
-    playerBullet.Draw(m_SpriteRenderer);
+    // 弾描画.
+    auto drawBullet = [&](const Bullet& bullet)
+    {
+        if (bullet.IsEnable())
+        { DrawEntity(m_SpriteRenderer, bullet); }
+    };
+    enemyBullet .ForEach(drawBullet);
+    playerBullet.ForEach(drawBullet);
 
-    // 敵制御.
-    enemyMgr.Update(m_Width, m_Height);
-    enemyMgr.Draw(m_SpriteRenderer);
+    // 敵描画.
+    enemyMgr.ForEach([&](const Enemy& enemy)
+    { DrawEntity(m_SpriteRenderer, enemy); });
 
-    // プレイヤー制御.
-    player.Update(m_Width, m_Height);
-    player.Draw(m_SpriteRenderer);
+    // プレイヤー描画.
+    DrawEntity(m_SpriteRenderer, player);
 
     if (isGameOver)
     {
@@ -521,6 +494,13 @@ void GameApp::OnResize(const base::ResizeEventArgs& args)
 //-----------------------------------------------------------------------------
 void GameApp::OnKey(const base::KeyEventArgs& args)
 {
+    // F9キーでここまでのプレイをリプレイとして保存.
+    if (args.IsKeyDown && args.KeyCode == VK_F9)
+    {
+        if (m_Replay.Save(kReplayPath))
+        { ILOGA("Info : Replay Saved. path = %s, ticks = %u", kReplayPath, m_Replay.GetTickCount()); }
+    }
+
     #if ASDX_ENABLE_IMGUI
     {
         // ImGuiのキー処理.
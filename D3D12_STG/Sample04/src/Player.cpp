@@ -22,7 +22,6 @@ constexpr float     kDefaultMoveSpeed = 5.0f;     //!< プレイヤー移動速
 constexpr float     kShotSpeed        = 25.0f;    //!< 弾の速さ.
 constexpr uint32_t  kMaxPlayerCount   = 3;        //!< 最大プレイヤー数.
 
-constexpr asdx::PAD_BUTTON kShotButton = asdx::PAD_B;
 SpriteKind kPlayerShip[kMaxPlayerCount] = {
     PLAYER_SHIP2_BLUE,
     PLAYER_SHIP2_GREEN,
@@ -59,9 +58,9 @@ Player::~Player()
 //-----------------------------------------------------------------------------
 void Player::Init(float px, float py, float sx, float sy, bool center)
 {
-    m_Pad.SetPlayerIndex(0);
+    m_Index = 0;
 
-    SetKind(kPlayerShip[0]);
+    SetKind(kPlayerShip[m_Index]);
 
     if (center)
     { SetCenter(px, py); }
@@ -73,6 +72,7 @@ void Player::Init(float px, float py, float sx, float sy, bool center)
     m_Life      = kDefaultLife;
     m_MoveSpeed = kDefaultMoveSpeed;
     m_PadLock   = true;
+    m_Damage    = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -87,29 +87,26 @@ void Player::Term()
 //-----------------------------------------------------------------------------
 //      更新処理を行います.
 //-----------------------------------------------------------------------------
-void Player::Update(uint32_t w, uint32_t h)
+void Player::Update(const SimInput& input, uint32_t w, uint32_t h)
 {
     // プレイヤー番号取得.
-    auto idx = m_Pad.GetPlayerIndex();
+    auto idx = m_Index;
     assert(idx < kMaxPlayerCount);
 
     asdx::Vector2 pos = GetPos();
     const auto& shipData = GetSpriteData(kPlayerShip[idx]);
     auto center = asdx::Vector2(pos.x + shipData.W * 0.5f, pos.y + shipData.H * 0.5f);
 
-    // パッド更新.
-    m_Pad.UpdateState();
-
     if (!m_PadLock && m_Life > 0)
     {
         // パッド操作による移動.
-        pos.x += m_MoveSpeed * m_Pad.GetNormalizedThumbLX();
-        pos.y -= m_MoveSpeed * m_Pad.GetNormalizedThumbLY();
+        pos.x += m_MoveSpeed * input.GetStickX();
+        pos.y -= m_MoveSpeed * input.GetStickY();
 
         // 中心位置更新.
         center = asdx::Vector2(pos.x + shipData.W * 0.5f, pos.y + shipData.H * 0.5f);
 
-        if (m_Pad.IsDown(kShotButton))
+        if (input.IsDown(SIM_BUTTON_SHOT))
         {
             auto x = center.x;
             auto y = center.y;
@@ -140,10 +137,10 @@ void Player::Update(uint32_t w, uint32_t h)
 }
 
 //-----------------------------------------------------------------------------
-//      ゲームパッドを取得します.
+//      プレイヤー番号を取得します.
 //-----------------------------------------------------------------------------
-const asdx::GamePad& Player::GetPad() const
-{ return m_Pad; }
+uint32_t Player::GetPlayerIndex() const
+{ return m_Index; }
 
 //-----------------------------------------------------------------------------
 //      パッド操作をロックします.
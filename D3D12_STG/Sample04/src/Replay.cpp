@@ -0,0 +1,198 @@
+﻿//-----------------------------------------------------------------------------
+// File : Replay.cpp
+// Desc : Input Replay.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "Replay.h"
+#include <fnd/asdxLogger.h>
+#include <cstdio>
+#include <cassert>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Replay class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      記録内容を破棄して, 構成設定を設定します.
+//-----------------------------------------------------------------------------
+void Replay::Reset(const SimDesc& desc)
+{
+    m_Desc = desc;
+    m_Inputs.clear();
+    m_Hashes.clear();
+}
+
+//-----------------------------------------------------------------------------
+//      1ティック分の入力と状態ハッシュを追加します.
+//-----------------------------------------------------------------------------
+void Replay::Add(const SimInput& input, uint64_t hash)
+{
+    m_Inputs.push_back(input);
+    m_Hashes.push_back(hash);
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルに保存します.
+//-----------------------------------------------------------------------------
+bool Replay::Save(const char* path) const
+{
+    FILE* pFile = nullptr;
+#ifdef _WIN32
+    auto err = fopen_s(&pFile, path, "wb");
+#else
+    pFile = fopen(path, "wb");
+    auto err = (pFile == nullptr) ? 1 : 0;
+#endif//_WIN32
+    if (err != 0 || pFile == nullptr)
+    {
+        ELOGA("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    ReplayHeader header = {};
+    header.Magic[0]             = 'S';
+    header.Magic[1]             = 'T';
+    header.Magic[2]             = 'G';
+    header.Magic[3]             = 'R';
+    header.Version              = REPLAY_VERSION;
+    header.Width                = m_Desc.Width;
+    header.Height               = m_Desc.Height;
+    header.Stage                = m_Desc.Stage;
+    header.MaxEnemyCount        = m_Desc.MaxEnemyCount;
+    header.MaxPlayerBulletCount = m_Desc.MaxPlayerBulletCount;
+    header.MaxEnemyBulletCount  = m_Desc.MaxEnemyBulletCount;
+    header.Invincible           = m_Desc.Invincible ? 1 : 0;
+    header.UseDanmaku           = m_Desc.UseDanmaku ? 1 : 0;
+    header.TickCount            = uint32_t(m_Inputs.size());
+
+    auto count = size_t(header.TickCount);
+    auto valid = fwrite(&header, sizeof(header), 1, pFile) == 1;
+    if (valid && count > 0)
+    {
+        valid = fwrite(m_Inputs.data(), sizeof(SimInput), count, pFile) == count
+             && fwrite(m_Hashes.data(), sizeof(uint64_t), count, pFile) == count;
+    }
+
+    fclose(pFile);
+
+    if (!valid)
+    {
+        ELOGA("Error : File Write Failed. path = %s", path);
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルから読み込みます.
+//-----------------------------------------------------------------------------
+bool Replay::Load(const char* path)
+{
+    FILE* pFile = nullptr;
+#ifdef _WIN32
+    auto err = fopen_s(&pFile, path, "rb");
+#else
+    pFile = fopen(path, "rb");
+    auto err = (pFile == nullptr) ? 1 : 0;
+#endif//_WIN32
+    if (err != 0 || pFile == nullptr)
+    {
+        ELOGA("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    ReplayHeader header = {};
+    if (fread(&header, sizeof(header), 1, pFile) != 1)
+    {
+        ELOGA("Error : Invalid File. path = %s", path);
+        fclose(pFile);
+        return false;
+    }
+
+    if (header.Magic[0] != 'S' || header.Magic[1] != 'T' || header.Magic[2] != 'G' || header.Magic[3] != 'R')
+    {
+        ELOGA("Error : Invalid Magic. path = %s", path);
+        fclose(pFile);
+        return false;
+    }
+
+    if (header.Version != REPLAY_VERSION)
+    {
+        ELOGA("Error : Unsupported Version. path = %s, version = %u", path, header.Version);
+        fclose(pFile);
+        return false;
+    }
+
+    if (header.Stage >= SIM_STAGE_COUNT)
+    {
+        ELOGA("Error : Invalid Stage. path = %s, stage = %u", path, header.Stage);
+        fclose(pFile);
+        return false;
+    }
+
+    auto count = size_t(header.TickCount);
+    std::vector<SimInput> inputs(count);
+    std::vector<uint64_t> hashes(count);
+    if (count > 0)
+    {
+        if (fread(inputs.data(), sizeof(SimInput), count, pFile) != count
+         || fread(hashes.data(), sizeof(uint64_t), count, pFile) != count)
+        {
+            ELOGA("Error : Unexpected End Of File. path = %s", path);
+            fclose(pFile);
+            return false;
+        }
+    }
+
+    fclose(pFile);
+
+    m_Desc.Width                = header.Width;
+    m_Desc.Height               = header.Height;
+    m_Desc.Stage                = header.Stage;
+    m_Desc.MaxEnemyCount        = header.MaxEnemyCount;
+    m_Desc.MaxPlayerBulletCount = header.MaxPlayerBulletCount;
+    m_Desc.MaxEnemyBulletCount  = header.MaxEnemyBulletCount;
+    m_Desc.Invincible           = (header.Invincible != 0);
+    m_Desc.UseDanmaku           = (header.UseDanmaku != 0);
+
+    m_Inputs = std::move(inputs);
+    m_Hashes = std::move(hashes);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      構成設定を取得します.
+//-----------------------------------------------------------------------------
+const SimDesc& Replay::GetDesc() const
+{ return m_Desc; }
+
+//-----------------------------------------------------------------------------
+//      記録ティック数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t Replay::GetTickCount() const
+{ return uint32_t(m_Inputs.size()); }
+
+//-----------------------------------------------------------------------------
+//      指定ティックの入力を取得します.
+//-----------------------------------------------------------------------------
+const SimInput& Replay::GetInput(uint32_t tick) const
+{
+    assert(tick < m_Inputs.size());
+    return m_Inputs[tick];
+}
+
+//-----------------------------------------------------------------------------
+//      指定ティックの状態ハッシュを取得します.
+//-----------------------------------------------------------------------------
+uint64_t Replay::GetHash(uint32_t tick) const
+{
+    assert(tick < m_Hashes.size());
+    return m_Hashes[tick];
+}
@@ -0,0 +1,696 @@
+﻿//-----------------------------------------------------------------------------
+// File : Simulation.cpp
+// Desc : Game Simulation.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "Simulation.h"
+#include "SpriteData.h"
+#include "Player.h"
+#include "Enemy.h"
+#include "Bullet.h"
+#include "MoveBehavior.h"
+#include "ShotBehavior.h"
+#include "Danmaku.h"
+#include <fnd/asdxLogger.h>
+#include <chrono>
+#include <cstring>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constants.
+//-----------------------------------------------------------------------------
+constexpr uint64_t kHashOffset = 0xcbf29ce484222325ull;  //!< FNV-1a オフセット基底.
+constexpr uint64_t kHashPrime  = 0x00000100000001b3ull;  //!< FNV-1a 素数.
+
+// 敵タイプ.
+enum ENEMY_TYPE : uint32_t
+{
+    ENEMY_TYPE_ONE_WAY = 0,     //!< 直線移動.
+    ENEMY_TYPE_WAVE,            //!< 波状移動.
+    ENEMY_TYPE_AIMING,          //!< 追跡移動.
+    ENEMY_TYPE_SPIRAL_SHOT,     //!< 低速直線移動 + 渦巻弾.
+    ENEMY_TYPE_DIR_SHOT,        //!< 波状移動 + 方向弾.
+    ENEMY_TYPE_AIMING_SHOT,     //!< 直線移動 + 狙い撃ち.
+    ENEMY_TYPE_SWARM_SHOT,      //!< 低速直線移動 + 低頻度の狙い撃ち.
+};
+
+// 追跡移動する敵が1体だけ出現するステージ.
+const StageEvent kDefaultStage[] = {
+    { 0, 0, ENEMY_TYPE_AIMING, 0.5f, 0.0f },
+};
+
+// 発弾する敵が周期的に出現するステージ.
+const StageEvent kStressStage[] = {
+    {  0, 120, ENEMY_TYPE_SPIRAL_SHOT, 0.25f, 0.0f },
+    { 60, 120, ENEMY_TYPE_SPIRAL_SHOT, 0.75f, 0.0f },
+    { 30,  90, ENEMY_TYPE_DIR_SHOT,    0.5f,  0.0f },
+    {  0,  45, ENEMY_TYPE_AIMING_SHOT, 0.1f,  0.0f },
+    { 20,  45, ENEMY_TYPE_AIMING_SHOT, 0.9f,  0.0f },
+    {  0, 300, ENEMY_TYPE_AIMING,      0.5f,  0.0f },
+};
+
+// ステージテーブル.
+struct StageInfo
+{
+    const char*         Name;
+    const StageEvent*   pEvents;
+    uint32_t            EventCount;
+};
+
+// 低頻度で発弾する敵が大量に出現するステージ.
+const StageEvent kSwarmStage[] = {
+    { 0, 8, ENEMY_TYPE_SWARM_SHOT, 0.03125f, 0.0f },
+    { 1, 8, ENEMY_TYPE_SWARM_SHOT, 0.09375f, 0.0f },
+    { 2, 8, ENEMY_TYPE_SWARM_SHOT, 0.15625f, 0.0f },
+    { 3, 8, ENEMY_TYPE_SWARM_SHOT, 0.21875f, 0.0f },
+    { 4, 8, ENEMY_TYPE_SWARM_SHOT, 0.28125f, 0.0f },
+    { 5, 8, ENEMY_TYPE_SWARM_SHOT, 0.34375f, 0.0f },
+    { 6, 8, ENEMY_TYPE_SWARM_SHOT, 0.40625f, 0.0f },
+    { 7, 8, ENEMY_TYPE_SWARM_SHOT, 0.46875f, 0.0f },
+    { 0, 8, ENEMY_TYPE_SWARM_SHOT, 0.53125f, 0.0f },
+    { 1, 8, ENEMY_TYPE_SWARM_SHOT, 0.59375f, 0.0f },
+    { 2, 8, ENEMY_TYPE_SWARM_SHOT, 0.65625f, 0.0f },
+    { 3, 8, ENEMY_TYPE_SWARM_SHOT, 0.71875f, 0.0f },
+    { 4, 8, ENEMY_TYPE_SWARM_SHOT, 0.78125f, 0.0f },
+    { 5, 8, ENEMY_TYPE_SWARM_SHOT, 0.84375f, 0.0f },
+    { 6, 8, ENEMY_TYPE_SWARM_SHOT, 0.90625f, 0.0f },
+    { 7, 8, ENEMY_TYPE_SWARM_SHOT, 0.96875f, 0.0f },
+};
+
+const StageInfo kStages[SIM_STAGE_COUNT] = {
+    { "default", kDefaultStage, uint32_t(_countof(kDefaultStage)) },
+    { "stress",  kStressStage,  uint32_t(_countof(kStressStage))  },
+    { "swarm",   kSwarmStage,   uint32_t(_countof(kSwarmStage))   },
+};
+
+// 渦巻弾 (SpiralShotBehavior 相当).
+const char* kSpiralShotSource = R"(
+    sprite      LASER_RED08
+    scale       0.5
+    speed       4
+loop:
+    ring        8
+    turn        7
+    wait        6
+    jump        loop
+)";
+
+// 方向弾 (DirShotBehavior 相当).
+const char* kDirShotSource = R"(
+    sprite      LASER_BLUE08
+    scale       0.5
+    speed       5
+    angle       90
+loop:
+    repeat      3
+    nway        5, 60
+    wait        20
+    next
+    wait        60
+    jump        loop
+)";
+
+// 狙い撃ち (AimingDirShotBehavior 相当).
+const char* kAimingShotSource = R"(
+    sprite      LASER_GREEN08
+    scale       0.5
+    speed       6
+loop:
+    aim
+    nway        3, 30
+    wait        30
+    jump        loop
+)";
+
+// 低頻度の狙い撃ち.
+const char* kSwarmShotSource = R"(
+    sprite      LASER_BLUE08
+    scale       0.5
+    speed       3
+loop:
+    aim
+    nway        1, 0
+    wait        60
+    jump        loop
+)";
+
+// システム名.
+const char* kSystemNames[SIM_SYSTEM_COUNT] = {
+    "spawn",
+    "hit",
+    "bullet",
+    "enemy",
+    "danmaku",
+    "player",
+};
+
+// 移動挙動.
+OneWayMoveBehavior      g_OneWayMoveBehavior;
+OneWayMoveBehavior      g_SlowMoveBehavior;
+WaveMoveBehavior        g_WaveMoveBehavior;
+AimingMoveBehavior      g_AimingMoveBahavior;
+
+// 発弾挙動.
+SpiralShotBehavior      g_SpiralShotBehavior;
+DirShotBehavior         g_DirShotBehavior;
+AimingDirShotBehavior   g_AimingDirShotBehavior;
+AimingDirShotBehavior   g_SwarmShotBehavior;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ScopedTimer class
+///////////////////////////////////////////////////////////////////////////////
+class ScopedTimer
+{
+public:
+    ScopedTimer(bool enable, uint64_t& target)
+    : m_Enable(enable)
+    , m_Target(target)
+    {
+        if (m_Enable)
+        { m_Start = std::chrono::steady_clock::now(); }
+    }
+
+    ~ScopedTimer()
+    {
+        if (m_Enable)
+        {
+            auto elapsed = std::chrono::steady_clock::now() - m_Start;
+            m_Target += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+
+private:
+    bool                                    m_Enable;
+    uint64_t&                               m_Target;
+    std::chrono::steady_clock::time_point   m_Start;
+};
+
+//-----------------------------------------------------------------------------
+//      32bit値をハッシュに加えます.
+//-----------------------------------------------------------------------------
+inline void HashU32(uint64_t& hash, uint32_t value)
+{
+    hash ^= value;
+    hash *= kHashPrime;
+}
+
+//-----------------------------------------------------------------------------
+//      浮動小数をビット列としてハッシュに加えます.
+//-----------------------------------------------------------------------------
+inline void HashF32(uint64_t& hash, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    HashU32(hash, bits);
+}
+
+//-----------------------------------------------------------------------------
+//      エンティティの状態をハッシュに加えます.
+//-----------------------------------------------------------------------------
+inline void HashEntity(uint64_t& hash, const Entity& entity)
+{
+    HashU32(hash, entity.GetKind());
+    HashF32(hash, entity.GetPosX());
+    HashF32(hash, entity.GetPosY());
+    HashF32(hash, entity.GetScaleX());
+    HashF32(hash, entity.GetScaleY());
+}
+
+//-----------------------------------------------------------------------------
+//      弾の状態をハッシュに加えます.
+//-----------------------------------------------------------------------------
+void HashBullets(uint64_t& hash, const BulletManager& manager)
+{
+    HashU32(hash, manager.GetUsedCount());
+    manager.ForEach([&](const Bullet& bullet)
+    {
+        HashEntity(hash, bullet);
+        HashF32(hash, bullet.GetAngle());
+        HashF32(hash, bullet.GetAngleRate());
+        HashF32(hash, bullet.GetSpeed());
+        HashF32(hash, bullet.GetSpeedRate());
+        HashU32(hash, bullet.IsEnable() ? 1 : 0);
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      発弾プログラムをアセンブルして登録します.
+//-----------------------------------------------------------------------------
+uint32_t AddShotProgram(const DanmakuAssembler& assembler, const char* name, const char* source)
+{
+    DanmakuProgram program;
+    if (!assembler.Assemble(name, source, program))
+    {
+        ELOGA("Error : DanmakuAssembler::Assemble() Failed. name = %s", name);
+        return DANMAKU_INVALID_PROGRAM;
+    }
+
+    return GetDanmakuVM().AddProgram(program);
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Simulation class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+Simulation::Simulation()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+Simulation::~Simulation()
+{ Term(); }
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool Simulation::Init(const SimDesc& desc)
+{
+    Term();
+
+    if (desc.Stage >= SIM_STAGE_COUNT)
+    {
+        ELOGA("Error : Invalid Stage. stage = %u", desc.Stage);
+        return false;
+    }
+
+    // プレイヤー用弾マネージャの初期化.
+    if (!GetPlayerBulletMgr().Init(desc.MaxPlayerBulletCount))
+    {
+        ELOGA("Error : Player Bullet Manager Initialize Failed.");
+        return false;
+    }
+
+    // エネミー用弾マネージャの初期化.
+    if (!GetEnemyBulletMgr().Init(desc.MaxEnemyBulletCount))
+    {
+        ELOGA("Error : Enemy Bullet Manager Initialize Failed.");
+        return false;
+    }
+
+    // プレイヤー初期化.
+    {
+        auto& player = GetPlayer();
+        player.Init(desc.Width * 0.5f, float(desc.Height), 1.0f, 1.0f, true);
+        player.SetPadLock(false);
+    }
+
+    auto& enemyMgr = GetEnemyMgr();
+    // エネミーマネージャ初期化.
+    if (!enemyMgr.Init(desc.MaxEnemyCount))
+    {
+        ELOGA("Error : Enemy Manager Initialize Failed.");
+        return false;
+    }
+
+    // 直線移動.
+    {
+        OneWayMoveBehavior::Param param = {};
+        param.Velocity = asdx::Vector2(0.0f, 2.0f);
+
+        g_OneWayMoveBehavior.SetParam(param);
+
+        EnemyManager::SpawnParam spawnParam = {};
+        spawnParam.SpriteKind    = ENEMY_BLACK1;
+        spawnParam.pMoveBehavior = &g_OneWayMoveBehavior;
+
+        enemyMgr.AddType(ENEMY_TYPE_ONE_WAY, spawnParam);
+    }
+
+    // 波状移動.
+    {
+        WaveMoveBehavior::Param param = {};
+        param.Speed         = 1.0f;
+        param.Amplitude     = 200.0f;
+        param.AngleScale    = 2.0f;
+        param.AngleOffset   = 0.0f;
+
+        g_WaveMoveBehavior.SetParam(param);
+
+        EnemyManager::SpawnParam spawnParam = {};
+        spawnParam.SpriteKind    = ENEMY_BLACK1;
+        spawnParam.pMoveBehavior = &g_WaveMoveBehavior;
+
+        enemyMgr.AddType(ENEMY_TYPE_WAVE, spawnParam);
+    }
+
+    // 追跡移動.
+    {
+        AimingMoveBehavior::Param param = {};
+        param.Interval  = 90;
+        param.Speed     = 3.0f;
+
+        g_AimingMoveBahavior.SetParam(param);
+
+        EnemyManager::SpawnParam spawnParam = {};
+        spawnParam.SpriteKind    = ENEMY_BLACK1;
+        spawnParam.pMoveBehavior = &g_AimingMoveBahavior;
+
+        enemyMgr.AddType(ENEMY_TYPE_AIMING, spawnParam);
+    }
+
+    // 発弾プログラムの登録.
+    uint32_t spiralShotProgram = DANMAKU_INVALID_PROGRAM;
+    uint32_t dirShotProgram    = DANMAKU_INVALID_PROGRAM;
+    uint32_t aimingShotProgram = DANMAKU_INVALID_PROGRAM;
+    uint32_t swarmShotProgram  = DANMAKU_INVALID_PROGRAM;
+    GetDanmakuVM().Term();
+    if (desc.UseDanmaku)
+    {
+        DanmakuAssembler assembler;
+        assembler.DefineSymbol("LASER_RED08",   LASER_RED08);
+        assembler.DefineSymbol("LASER_BLUE08",  LASER_BLUE08);
+        assembler.DefineSymbol("LASER_GREEN08", LASER_GREEN08);
+
+        spiralShotProgram = AddShotProgram(assembler, "spiral_shot", kSpiralShotSource);
+        dirShotProgram    = AddShotProgram(assembler, "dir_shot",    kDirShotSource);
+        aimingShotProgram = AddShotProgram(assembler, "aiming_shot", kAimingShotSource);
+        swarmShotProgram  = AddShotProgram(assembler, "swarm_shot",  kSwarmShotSource);
+
+        if (spiralShotProgram == DANMAKU_INVALID_PROGRAM
+         || dirShotProgram    == DANMAKU_INVALID_PROGRAM
+         || aimingShotProgram == DANMAKU_INVALID_PROGRAM
+         || swarmShotProgram  == DANMAKU_INVALID_PROGRAM)
+        {
+            ELOGA("Error : Shot Program Register Failed.");
+            return false;
+        }
+    }
+
+    // 低速直線移動 + 渦巻弾.
+    {
+        OneWayMoveBehavior::Param moveParam = {};
+        moveParam.Velocity = asdx::Vector2(0.0f, 1.0f);
+
+        g_SlowMoveBehavior.SetParam(moveParam);
+
+        SpiralShotBehavior::Param shotParam = {};
+        shotParam.SpriteKind    = LASER_RED08;
+        shotParam.Scale         = asdx::Vector2(0.5f, 0.5f);
+        shotParam.AngleRate     = 7.0f;
+        shotParam.Speed         = 4.0f;
+        shotParam.Count         = 8;
+        shotParam.Interval      = 6;
+        shotParam.ShotTime      = 600;
+        shotParam.WaitTime      = 0;
+
+        g_SpiralShotBehavior.SetParam(shotParam);
+
+        EnemyManager::SpawnParam spawnParam = {};
+        spawnParam.SpriteKind    = ENEMY_RED1;
+        spawnParam.pShotBehavior = desc.UseDanmaku ? nullptr : &g_SpiralShotBehavior;
+        spawnParam.pMoveBehavior = &g_SlowMoveBehavior;
+        spawnParam.ShotProgram   = spiralShotProgram;
+
+        enemyMgr.AddType(ENEMY_TYPE_SPIRAL_SHOT, spawnParam);
+    }
+
+    // 波状移動 + 方向弾.
+    {
+        DirShotBehavior::Param shotParam = {};
+        shotParam.SpriteKind    = LASER_BLUE08;
+        shotParam.Scale         = asdx::Vector2(0.5f, 0.5f);
+        shotParam.Angle         = 90.0f;
+        shotParam.AngleRange    = 60.0f;
+        shotParam.Speed         = 5.0f;
+        shotParam.Count         = 5;
+        shotParam.Interval      = 20;
+        shotParam.ShotTime      = 60;
+        shotParam.WaitTime      = 60;
+
+        g_DirShotBehavior.SetParam(shotParam);
+
+        EnemyManager::SpawnParam spawnParam = {};
+        spawnParam.SpriteKind    = ENEMY_BLUE2;
+        spawnParam.pShotBehavior = desc.UseDanmaku ? nullptr : &g_DirShotBehavior;
+        spawnParam.pMoveBehavior = &g_WaveMoveBehavior;
+        spawnParam.ShotProgram   = dirShotProgram;
+
+        enemyMgr.AddType(ENEMY_TYPE_DIR_SHOT, spawnParam);
+    }
+
+    // 直線移動 + 狙い撃ち.
+    {
+        AimingDirShotBehavior::Param shotParam = {};
+        shotParam.SpriteKind    = LASER_GREEN08;
+        shotParam.Scale         = asdx::Vector2(0.5f, 0.5f);
+        shotParam.AngleRange    = 30.0f;
+        shotParam.Speed         = 6.0f;
+        shotParam.Count         = 3;
+        shotParam.Interval      = 30;
+        shotParam.ShotTime      = 30;
+        shotParam.WaitTime      = 0;
+
+        g_AimingDirShotBehavior.SetParam(shotParam);
+
+        EnemyManager::SpawnParam spawnParam = {};
+        spawnParam.SpriteKind    = ENEMY_GREEN3;
+        spawnParam.pShotBehavior = desc.UseDanmaku ? nullptr : &g_AimingDirShotBehavior;
+        spawnParam.pMoveBehavior = &g_OneWayMoveBehavior;
+        spawnParam.ShotProgram   = aimingShotProgram;
+
+        enemyMgr.AddType(ENEMY_TYPE_AIMING_SHOT, spawnParam);
+    }
+
+    // 低速直線移動 + 低頻度の狙い撃ち.
+    {
+        AimingDirShotBehavior::Param shotParam = {};
+        shotParam.SpriteKind    = LASER_BLUE08;
+        shotParam.Scale         = asdx::Vector2(0.5f, 0.5f);
+        shotParam.Speed         = 3.0f;
+        shotParam.Count         = 1;
+        shotParam.Interval      = 60;
+        shotParam.ShotTime      = 60;
+        shotParam.WaitTime      = 0;
+
+        g_SwarmShotBehavior.SetParam(shotParam);
+
+        EnemyManager::SpawnParam spawnParam = {};
+        spawnParam.SpriteKind    = ENEMY_BLUE1;
+        spawnParam.pShotBehavior = desc.UseDanmaku ? nullptr : &g_SwarmShotBehavior;
+        spawnParam.pMoveBehavior = &g_SlowMoveBehavior;
+        spawnParam.ShotProgram   = swarmShotProgram;
+
+        enemyMgr.AddType(ENEMY_TYPE_SWARM_SHOT, spawnParam);
+    }
+
+    m_Desc       = desc;
+    m_pEvents    = kStages[desc.Stage].pEvents;
+    m_EventCount = kStages[desc.Stage].EventCount;
+    m_Tick       = 0;
+
+    ResetTimings();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void Simulation::Term()
+{
+    if (m_pEvents == nullptr)
+        return;
+
+    GetPlayer().Term();
+    GetEnemyMgr().Term();
+    GetDanmakuVM().Term();
+    GetPlayerBulletMgr().Term();
+    GetEnemyBulletMgr ().Term();
+
+    m_pEvents    = nullptr;
+    m_EventCount = 0;
+    m_Tick       = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      1ティック分シミュレーションを進めます.
+//-----------------------------------------------------------------------------
+void Simulation::Step(const SimInput& input)
+{
+    auto& player       = GetPlayer();
+    auto& enemyMgr     = GetEnemyMgr();
+    auto& enemyBullet  = GetEnemyBulletMgr();
+    auto& playerBullet = GetPlayerBulletMgr();
+
+    auto w = m_Desc.Width;
+    auto h = m_Desc.Height;
+
+    // 敵生成.
+    {
+        ScopedTimer timer(m_Profile, m_Timings.Nanoseconds[SIM_SYSTEM_SPAWN]);
+        SpawnEnemies();
+    }
+
+    if (!player.IsGameOver())
+    {
+        ScopedTimer timer(m_Profile, m_Timings.Nanoseconds[SIM_SYSTEM_HIT]);
+
+        // プレイヤー弾と敵リストの衝突判定.
+        enemyMgr.CheckHit(playerBullet);
+
+        // プレイヤーダメージ判定.
+        auto playerHit = enemyBullet.IsHit(player) || enemyMgr.IsHit(player);
+        if (playerHit && !m_Desc.Invincible)
+        {
+            player.SetDamage(true);
+        }
+    }
+
+    // 弾制御.
+    {
+        ScopedTimer timer(m_Profile, m_Timings.Nanoseconds[SIM_SYSTEM_BULLET]);
+        enemyBullet .Update(w, h);
+        playerBullet.Update(w, h);
+    }
+
+    // 敵制御.
+    {
+        ScopedTimer timer(m_Profile, m_Timings.Nanoseconds[SIM_SYSTEM_ENEMY]);
+        enemyMgr.Update(w, h);
+    }
+
+    // 発弾プログラム実行.
+    {
+        ScopedTimer timer(m_Profile, m_Timings.Nanoseconds[SIM_SYSTEM_DANMAKU]);
+        GetDanmakuVM().Update(player.GetCenter(), enemyBullet);
+    }
+
+    // プレイヤー制御.
+    {
+        ScopedTimer timer(m_Profile, m_Timings.Nanoseconds[SIM_SYSTEM_PLAYER]);
+        player.Update(input, w, h);
+    }
+
+    if (m_Profile)
+    { m_Timings.TickCount++; }
+
+    m_Tick++;
+}
+
+//-----------------------------------------------------------------------------
+//      現在のティックで生成する敵を生成します.
+//-----------------------------------------------------------------------------
+void Simulation::SpawnEnemies()
+{
+    auto& enemyMgr = GetEnemyMgr();
+
+    for(auto i=0u; i<m_EventCount; ++i)
+    {
+        const auto& evt = m_pEvents[i];
+        if (m_Tick < evt.Tick)
+            continue;
+
+        auto elapsed = m_Tick - evt.Tick;
+        auto spawn   = (evt.Interval == 0) ? (elapsed == 0) : ((elapsed % evt.Interval) == 0);
+        if (!spawn)
+            continue;
+
+        enemyMgr.Spwan(evt.Type, evt.X * float(m_Desc.Width), evt.Y * float(m_Desc.Height));
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      シミュレーション状態のハッシュ値を計算します.
+//-----------------------------------------------------------------------------
+uint64_t Simulation::CalcHash() const
+{
+    auto hash = kHashOffset;
+
+    HashU32(hash, m_Tick);
+
+    // プレイヤー.
+    {
+        const auto& player = GetPlayer();
+        HashEntity(hash, player);
+        HashU32(hash, player.GetLife());
+        HashU32(hash, player.IsDamage() ? 1 : 0);
+    }
+
+    // 敵.
+    {
+        const auto& enemyMgr = GetEnemyMgr();
+        HashU32(hash, enemyMgr.GetUsedCount());
+        enemyMgr.ForEach([&](const Enemy& enemy)
+        {
+            const auto& param = enemy.GetParam();
+            HashEntity(hash, enemy);
+            HashF32(hash, param.x);
+            HashF32(hash, param.y);
+            HashF32(hash, param.z);
+            HashF32(hash, param.w);
+            HashU32(hash, uint32_t(enemy.GetTimer()));
+        });
+    }
+
+    // 弾.
+    HashBullets(hash, GetPlayerBulletMgr());
+    HashBullets(hash, GetEnemyBulletMgr());
+
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+//      経過ティック数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t Simulation::GetTick() const
+{ return m_Tick; }
+
+//-----------------------------------------------------------------------------
+//      構成設定を取得します.
+//-----------------------------------------------------------------------------
+const SimDesc& Simulation::GetDesc() const
+{ return m_Desc; }
+
+//-----------------------------------------------------------------------------
+//      システムごとの処理時間計測を設定します.
+//-----------------------------------------------------------------------------
+void Simulation::SetProfile(bool value)
+{ m_Profile = value; }
+
+//-----------------------------------------------------------------------------
+//      システムごとの処理時間を取得します.
+//-----------------------------------------------------------------------------
+const SimTimings& Simulation::GetTimings() const
+{ return m_Timings; }
+
+//-----------------------------------------------------------------------------
+//      システムごとの処理時間をリセットします.
+//-----------------------------------------------------------------------------
+void Simulation::ResetTimings()
+{ m_Timings = SimTimings(); }
+
+//-----------------------------------------------------------------------------
+//      システム名を取得します.
+//-----------------------------------------------------------------------------
+const char* GetSimSystemName(SIM_SYSTEM system)
+{
+    if (system >= SIM_SYSTEM_COUNT)
+        return "unknown";
+
+    return kSystemNames[system];
+}
+
+//-----------------------------------------------------------------------------
+//      ステージ名を取得します.
+//-----------------------------------------------------------------------------
+const char* GetSimStageName(uint32_t stage)
+{
+    if (stage >= SIM_STAGE_COUNT)
+        return nullptr;
+
+    return kStages[stage].Name;
+}
@@ -8,6 +8,7 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include "SpriteData.h"
+#include <cassert>
 
 
 namespace {
@@ -367,6 +368,74 @@ static const SpriteData kSpriteData[] = {
 #undef UV
 #undef SPRITE_ENTRY
 
+static_assert(_countof(kSpriteData) == SPRITE_KIND_COUNT, "Sprite Data Count Not Matched.");
+
+// 弾の判定は見た目より一回り小さくする.
+constexpr float kBulletHitScale = 0.8f;
+
+// プレイヤーの判定円の半径 (スプライトの短辺に対する比率).
+constexpr float kPlayerHitRatio = 0.15f;
+
+//-----------------------------------------------------------------------------
+//      当たり判定形状を生成します.
+//-----------------------------------------------------------------------------
+HitBox MakeHitBox(uint32_t kind)
+{
+    const auto& data = kSpriteData[kind];
+
+    HitBox result = {};
+    result.SpriteHalfW = float(data.W) * 0.5f;
+    result.SpriteHalfH = float(data.H) * 0.5f;
+    result.HalfW       = result.SpriteHalfW;
+    result.HalfH       = result.SpriteHalfH;
+    result.Radius      = 0.0f;
+    result.Shape       = HIT_SHAPE_BOX;
+
+    auto minHalf = (data.W < data.H) ? result.SpriteHalfW : result.SpriteHalfH;
+    auto maxHalf = (data.W < data.H) ? result.SpriteHalfH : result.SpriteHalfW;
+
+    // 自機は中心の小さな円だけを判定にする.
+    if (PLAYER_SHIP1_BLUE <= kind && kind <= PLAYER_SHIP3_DAMAGE3)
+    {
+        result.HalfW  = 0.0f;
+        result.HalfH  = 0.0f;
+        result.Radius = minHalf * 2.0f * kPlayerHitRatio;
+        result.Shape  = HIT_SHAPE_CIRCLE;
+    }
+    // 弾は長辺方向のカプセルにする.
+    else if ((BEAM0 <= kind && kind <= BEAM_LONG2) || (LASER_BLUE01 <= kind && kind <= LASER_RED16))
+    {
+        auto radius = minHalf * kBulletHitScale;
+        auto length = maxHalf * kBulletHitScale - radius;
+        if (length < 0.0f)
+        { length = 0.0f; }
+
+        result.HalfW  = (data.W < data.H) ? 0.0f   : length;
+        result.HalfH  = (data.W < data.H) ? length : 0.0f;
+        result.Radius = radius;
+        result.Shape  = HIT_SHAPE_CAPSULE;
+    }
+
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// HitBoxTable structure
+///////////////////////////////////////////////////////////////////////////////
+struct HitBoxTable
+{
+    HitBox  Items[SPRITE_KIND_COUNT];
+
+    HitBoxTable()
+    {
+        for(auto i=0u; i<SPRITE_KIND_COUNT; ++i)
+        { Items[i] = MakeHitBox(i); }
+    }
+};
+
+// 判定のたびに初期化済みかを確認しなくて済むように, 名前空間スコープで生成しておく.
+static const HitBoxTable g_HitBoxTable;
+
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -375,3 +444,11 @@ static const SpriteData kSpriteData[] = {
 const SpriteData& GetSpriteData(SpriteKind kind)
 { return kSpriteData[kind]; }
 
+//-----------------------------------------------------------------------------
+//      当たり判定形状を取得します.
+//-----------------------------------------------------------------------------
+const HitBox& GetHitBox(uint16_t kind)
+{
+    assert(kind < SPRITE_KIND_COUNT);
+    return g_HitBoxTable.Items[kind];
+}
@@ -0,0 +1,322 @@
+﻿//-----------------------------------------------------------------------------
+// File : main.cpp
+// Desc : Headless Simulation Runner.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <fnd/asdxLogger.h>
+#include <Simulation.h>
+#include <Replay.h>
+#include <Player.h>
+#include <Enemy.h>
+#include <Bullet.h>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// RunResult structure
+///////////////////////////////////////////////////////////////////////////////
+struct RunResult
+{
+    std::vector<uint64_t>   Hashes;                 //!< ティックごとの状態ハッシュ.
+    std::vector<SimInput>   Inputs;                 //!< ティックごとの入力.
+    SimTimings              Timings;                //!< システムごとの処理時間.
+    double                  StepMs          = 0.0;  //!< Simulation::Step() の処理時間.
+    double                  HashMs          = 0.0;  //!< Simulation::CalcHash() の処理時間.
+    uint32_t                PeakEnemies     = 0;    //!< 最大敵数.
+    uint32_t                PeakBullets     = 0;    //!< 最大エネミー弾数.
+};
+
+//-----------------------------------------------------------------------------
+//      使い方を表示します.
+//-----------------------------------------------------------------------------
+void PrintUsage()
+{
+    printf("Usage : SimRunner [options]\n");
+    printf("  -n <N>            ticks to run (default: 3600, replay length when -play)\n");
+    printf("  -stage <name>     stage : default, stress, swarm (default: stress)\n");
+    printf("  -size <W> <H>     screen size (default: 1920 1080)\n");
+    printf("  -invincible       ignore player damage\n");
+    printf("  -enemies <N>      max enemy count (default: 512, 4096 for swarm)\n");
+    printf("  -behavior         shoot with IBehavior instead of DanmakuVM\n");
+    printf("  -play <path>      play a recorded replay and check its per tick hash\n");
+    printf("  -record <path>    save the generated input as a replay\n");
+    printf("  -verify           run twice and compare per tick hash\n");
+}
+
+//-----------------------------------------------------------------------------
+//      ステージ名を解析します.
+//-----------------------------------------------------------------------------
+bool ParseStage(const char* name, uint32_t& stage)
+{
+    for(auto i=0u; i<SIM_STAGE_COUNT; ++i)
+    {
+        if (strcmp(name, GetSimStageName(i)) == 0)
+        {
+            stage = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+//      自動操作の入力を生成します.
+//-----------------------------------------------------------------------------
+SimInput GenerateInput(uint32_t tick)
+{
+    // 左右に往復しながら撃ち続ける.
+    auto x = sinf(float(tick) * 0.02f);
+    auto y = 0.25f * sinf(float(tick) * 0.005f);
+    return MakeSimInput(x, y, SIM_BUTTON_SHOT);
+}
+
+//-----------------------------------------------------------------------------
+//      シミュレーションを実行します.
+//-----------------------------------------------------------------------------
+bool Run(const SimDesc& desc, uint32_t tickCount, const Replay* pReplay, RunResult& result)
+{
+    Simulation simulation;
+    if (!simulation.Init(desc))
+    {
+        ELOGA("Error : Simulation::Init() Failed.");
+        return false;
+    }
+
+    simulation.SetProfile(true);
+
+    result.Hashes.resize(tickCount);
+    result.Inputs.resize(tickCount);
+
+    const auto& enemyMgr    = GetEnemyMgr();
+    const auto& enemyBullet = GetEnemyBulletMgr();
+
+    using Clock = std::chrono::steady_clock;
+    Clock::duration stepTime = {};
+    Clock::duration hashTime = {};
+
+    for(auto i=0u; i<tickCount; ++i)
+    {
+        auto input = (pReplay != nullptr) ? pReplay->GetInput(i) : GenerateInput(i);
+
+        auto t0 = Clock::now();
+        simulation.Step(input);
+        auto t1 = Clock::now();
+        result.Hashes[i] = simulation.CalcHash();
+        auto t2 = Clock::now();
+
+        stepTime += t1 - t0;
+        hashTime += t2 - t1;
+
+        result.Inputs[i] = input;
+
+        result.PeakEnemies = std::max(result.PeakEnemies, enemyMgr.GetUsedCount());
+        result.PeakBullets = std::max(result.PeakBullets, enemyBullet.GetUsedCount());
+    }
+
+    result.StepMs  = std::chrono::duration<double, std::milli>(stepTime).count();
+    result.HashMs  = std::chrono::duration<double, std::milli>(hashTime).count();
+    result.Timings = simulation.GetTimings();
+
+    printf("final    : tick %u, life %u, enemies %u, bullets %u/%u, hash %016llx\n",
+        simulation.GetTick(),
+        uint32_t(GetPlayer().GetLife()),
+        enemyMgr.GetUsedCount(),
+        GetPlayerBulletMgr().GetUsedCount(),
+        enemyBullet.GetUsedCount(),
+        (unsigned long long)(tickCount > 0 ? result.Hashes.back() : 0));
+
+    simulation.Term();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ティックごとの状態ハッシュを比較します.
+//-----------------------------------------------------------------------------
+bool VerifyHashes(const std::vector<uint64_t>& expected, const std::vector<uint64_t>& actual)
+{
+    auto count = uint32_t(std::min(expected.size(), actual.size()));
+    for(auto i=0u; i<count; ++i)
+    {
+        if (actual[i] != expected[i])
+        {
+            printf("verify   : FAILED at tick %u (expected %016llx, actual %016llx)\n",
+                i, (unsigned long long)expected[i], (unsigned long long)actual[i]);
+            return false;
+        }
+    }
+
+    printf("verify   : OK (%u ticks)\n", count);
+    return true;
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    SimDesc desc;
+    desc.Stage = SIM_STAGE_STRESS;
+
+    auto tickCount  = 3600u;
+    auto hasCount   = false;
+    auto hasEnemies = false;
+    auto verify     = false;
+
+    const char* playPath   = nullptr;
+    const char* recordPath = nullptr;
+
+    for(auto i=1; i<argc; ++i)
+    {
+        auto valid = true;
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        { tickCount = uint32_t(strtoul(argv[++i], nullptr, 10)); hasCount = true; }
+        else if (strcmp(argv[i], "-stage") == 0 && i + 1 < argc)
+        { valid = ParseStage(argv[++i], desc.Stage); }
+        else if (strcmp(argv[i], "-size") == 0 && i + 2 < argc)
+        {
+            desc.Width  = uint32_t(strtoul(argv[++i], nullptr, 10));
+            desc.Height = uint32_t(strtoul(argv[++i], nullptr, 10));
+            valid = (desc.Width > 0 && desc.Height > 0);
+        }
+        else if (strcmp(argv[i], "-invincible") == 0)
+        { desc.Invincible = true; }
+        else if (strcmp(argv[i], "-enemies") == 0 && i + 1 < argc)
+        {
+            desc.MaxEnemyCount = uint32_t(strtoul(argv[++i], nullptr, 10));
+            hasEnemies = true;
+            valid = (desc.MaxEnemyCount > 0);
+        }
+        else if (strcmp(argv[i], "-behavior") == 0)
+        { desc.UseDanmaku = false; }
+        else if (strcmp(argv[i], "-play") == 0 && i + 1 < argc)
+        { playPath = argv[++i]; }
+        else if (strcmp(argv[i], "-record") == 0 && i + 1 < argc)
+        { recordPath = argv[++i]; }
+        else if (strcmp(argv[i], "-verify") == 0)
+        { verify = true; }
+        else
+        { valid = false; }
+
+        if (!valid)
+        {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    // 数千体が同時に存在するので, 指定が無ければ上限を引き上げる.
+    if (desc.Stage == SIM_STAGE_SWARM && !hasEnemies)
+    { desc.MaxEnemyCount = 4096; }
+
+    // リプレイ読み込み.
+    Replay replay;
+    if (playPath != nullptr)
+    {
+        if (!replay.Load(playPath))
+        {
+            ELOGA("Error : Replay::Load() Failed. path = %s", playPath);
+            return -1;
+        }
+
+        desc = replay.GetDesc();
+
+        if (!hasCount || tickCount > replay.GetTickCount())
+        { tickCount = replay.GetTickCount(); }
+    }
+
+    printf("stage    : %s (%u x %u, %s%s)\n",
+        GetSimStageName(desc.Stage),
+        desc.Width,
+        desc.Height,
+        desc.UseDanmaku ? "danmaku" : "behavior",
+        desc.Invincible ? ", invincible" : "");
+
+    RunResult result;
+    if (!Run(desc, tickCount, (playPath != nullptr) ? &replay : nullptr, result))
+    { return -1; }
+
+    // 計測結果.
+    {
+        auto ticksPerSec = (result.StepMs > 0.0) ? double(tickCount) * 1000.0 / result.StepMs : 0.0;
+        printf("ticks    : %u (%.2f ms, %.0f ticks/s, %.2f us/tick)\n",
+            tickCount, result.StepMs, ticksPerSec, (tickCount > 0) ? result.StepMs * 1000.0 / tickCount : 0.0);
+        printf("hash     : %.2f ms (%.2f us/tick)\n",
+            result.HashMs, (tickCount > 0) ? result.HashMs * 1000.0 / tickCount : 0.0);
+        printf("peak     : enemies %u, bullets %u\n", result.PeakEnemies, result.PeakBullets);
+
+        uint64_t systemTotal = 0;
+        for(auto i=0u; i<SIM_SYSTEM_COUNT; ++i)
+        { systemTotal += result.Timings.Nanoseconds[i]; }
+
+        for(auto i=0u; i<SIM_SYSTEM_COUNT; ++i)
+        {
+            auto ns = result.Timings.Nanoseconds[i];
+            printf("  %-7s: %9.3f ms (%5.1f%%, %.3f us/tick)\n",
+                GetSimSystemName(SIM_SYSTEM(i)),
+                double(ns) * 1e-6,
+                (systemTotal > 0) ? 100.0 * double(ns) / double(systemTotal) : 0.0,
+                (tickCount > 0) ? double(ns) * 1e-3 / tickCount : 0.0);
+        }
+    }
+
+    auto succeeded = true;
+
+    // リプレイに記録されたハッシュと比較.
+    if (playPath != nullptr)
+    {
+        std::vector<uint64_t> expected(tickCount);
+        for(auto i=0u; i<tickCount; ++i)
+        { expected[i] = replay.GetHash(i); }
+
+        succeeded &= VerifyHashes(expected, result.Hashes);
+    }
+
+    // 同じ入力で再実行して比較.
+    if (verify)
+    {
+        Replay input;
+        input.Reset(desc);
+        for(auto i=0u; i<tickCount; ++i)
+        { input.Add(result.Inputs[i], result.Hashes[i]); }
+
+        RunResult second;
+        if (!Run(desc, tickCount, &input, second))
+        { return -1; }
+
+        succeeded &= VerifyHashes(result.Hashes, second.Hashes);
+    }
+
+    // リプレイ保存.
+    if (recordPath != nullptr)
+    {
+        Replay record;
+        record.Reset(desc);
+        for(auto i=0u; i<tickCount; ++i)
+        { record.Add(result.Inputs[i], result.Hashes[i]); }
+
+        if (!record.Save(recordPath))
+        {
+            ELOGA("Error : Replay::Save() Failed. path = %s", recordPath);
+            return -1;
+        }
+
+        printf("record   : %s\n", recordPath);
+    }
+
+    return succeeded ? 0 : 1;
+}